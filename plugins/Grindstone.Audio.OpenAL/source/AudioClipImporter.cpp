@@ -81,12 +81,7 @@ static bool LoadAudioClip(Grindstone::Audio::AudioClipAsset& audioClipAsset) {
 }
 
 void* AudioClipImporter::LoadAsset(Uuid uuid) {
-	auto assetIterator = assets.emplace(
-		uuid,
-		AudioClipAsset(uuid)
-	);
-
-	Grindstone::Audio::AudioClipAsset& audioClipAsset = assetIterator.first->second;
+	Grindstone::Audio::AudioClipAsset& audioClipAsset = assets.Emplace(uuid, AudioClipAsset(uuid));
 	audioClipAsset.assetLoadStatus = AssetLoadStatus::Loading;
 	if (LoadAudioClip(audioClipAsset)) {
 		return nullptr;
@@ -96,15 +91,15 @@ void* AudioClipImporter::LoadAsset(Uuid uuid) {
 }
 
 void AudioClipImporter::QueueReloadAsset(Uuid uuid) {
-	auto audioClipInMap = assets.find(uuid);
-	if (audioClipInMap == assets.end()) {
+	Grindstone::Audio::AudioClipAsset* audioClipAssetPtr = assets.Find(uuid);
+	if (audioClipAssetPtr == nullptr) {
 		return;
 	}
 
-	Grindstone::Audio::AudioClipAsset& audioClipAsset = audioClipInMap->second;
+	Grindstone::Audio::AudioClipAsset& audioClipAsset = *audioClipAssetPtr;
 
 	if (audioClipAsset.buffer != 0) {
-		alDeleteBuffers(1, &audioClipInMap->second.buffer);
+		alDeleteBuffers(1, &audioClipAsset.buffer);
 	}
 
 	audioClipAsset.assetLoadStatus = AssetLoadStatus::Loading;
@@ -112,11 +107,11 @@ void AudioClipImporter::QueueReloadAsset(Uuid uuid) {
 }
 
 AudioClipImporter::~AudioClipImporter() {
-	for (auto& asset : assets) {
-		if (asset.second.buffer != 0) {
-			alDeleteBuffers(1, &asset.second.buffer);
+	for (AudioClipAsset& asset : assets) {
+		if (asset.buffer != 0) {
+			alDeleteBuffers(1, &asset.buffer);
 		}
 	}
 
-	assets.clear();
+	assets.Clear();
 }
@@ -33,6 +33,7 @@ E(depthWrite)\
 E(depthTest)\
 E(depthClamp)\
 E(depthCompareOp)\
+E(instancing)\
 E(blendPreset)\
 E(blendColor)\
 E(blendAlpha)\
@@ -42,6 +42,8 @@ struct ParseTree {
 		std::optional<bool> isDepthWriteEnabled;
 		std::optional<bool> isDepthBiasEnabled;
 		std::optional<bool> isDepthClampEnabled;
+		// Whether draws can be merged into instanced draws, which read their transforms from an instance buffer.
+		std::optional<bool> isInstancingEnabled;
 
 		std::optional<float> depthBiasConstantFactor;
 		std::optional<float> depthBiasSlopeFactor;
@@ -57,6 +57,7 @@ E(DepthWriteKey)\
 E(DepthTestKey)\
 E(DepthClampKey)\
 E(DepthCompareOpKey)\
+E(InstancingKey)\
 E(BlendColorKey)\
 E(BlendAlphaKey)\
 E(StageValue)\
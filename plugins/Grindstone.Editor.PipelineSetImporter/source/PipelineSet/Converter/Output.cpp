@@ -457,6 +457,7 @@ static void ExtractGraphicsPipelineSet(
 			flags |= pass.renderState.isDepthWriteEnabled.value() ? 0b1000 : 0;
 			flags |= pass.renderState.isStencilEnabled.value() ? 0b10000 : 0;
 			flags |= pass.renderState.shouldCopyFirstAttachment ? 0b100000 : 0;
+			flags |= pass.renderState.isInstancingEnabled.value() ? 0b1000000 : 0;
 
 			passPipelineHeader.depthBiasClamp = pass.renderState.depthBiasClamp.value();
 			passPipelineHeader.depthBiasConstantFactor = pass.renderState.depthBiasConstantFactor.value();
@@ -300,6 +300,16 @@ static bool ParseProperty(ParseContext& context, ParseTree::RenderState& renderS
 			}
 		}
 
+		return true;
+	case Token::InstancingKey:
+		++context.tokenIterator;
+		if (ExpectColon(context, "Expected a colon after 'instancing'")) {
+			bool outBool;
+			if (ExpectBoolean(context, outBool, "Expected a boolean after 'instancing:'")) {
+				renderState.isInstancingEnabled = outBool;
+			}
+		}
+
 		return true;
 
 	case Token::DepthCompareOpKey:
@@ -290,6 +290,8 @@ static TokenData ParseKeywordToken(ScanContext& scanContext, Keyword keyword, co
 		return TokenData(Token::DepthClampKey, path, line, column);
 	case Keyword::depthCompareOp:
 		return TokenData(Token::DepthCompareOpKey, path, line, column);
+	case Keyword::instancing:
+		return TokenData(Token::InstancingKey, path, line, column);
 	case Keyword::blendColor:
 		return TokenData(Token::BlendColorKey, path, line, column);
 	case Keyword::blendAlpha:
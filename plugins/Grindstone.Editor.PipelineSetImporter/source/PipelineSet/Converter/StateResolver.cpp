@@ -47,6 +47,7 @@ static void ApplyRenderState(const ParseTree::RenderState& src, ParseTree::Rende
 	ApplyProperty(isDepthWriteEnabled);
 	ApplyProperty(isDepthBiasEnabled);
 	ApplyProperty(isDepthClampEnabled);
+	ApplyProperty(isInstancingEnabled);
 
 	ApplyProperty(depthBiasConstantFactor);
 	ApplyProperty(depthBiasSlopeFactor);
@@ -101,6 +102,7 @@ static void ApplyRenderStateDefaults(ParseTree::RenderState& target) {
 	ApplyPropertyDefault(target.isDepthWriteEnabled, true);
 	ApplyPropertyDefault(target.isDepthBiasEnabled, false);
 	ApplyPropertyDefault(target.isDepthClampEnabled, false);
+	ApplyPropertyDefault(target.isInstancingEnabled, true);
 
 	ApplyPropertyDefault(target.depthBiasConstantFactor, 0.0f);
 	ApplyPropertyDefault(target.depthBiasSlopeFactor, 0.0f);
@@ -33,7 +33,13 @@ extern "C" {
 
 		pluginInterface->RegisterWorldContextFactory<Grindstone::Physics::WorldContext>(physicsWorldContextName);
 		pluginInterface->RegisterComponent<RigidBodyComponent>();
-		pluginInterface->RegisterSystem("PhysicsSystem", PhysicsBulletSystem);
+		pluginInterface->RegisterSystem(
+			"PhysicsSystem",
+			PhysicsBulletSystem,
+			Grindstone::ECS::SystemComponentAccess()
+				.Read<RigidBodyComponent>()
+				.Write<Grindstone::TransformComponent>()
+		);
 	}
 
 	BULLET_PHYSICS_EXPORT void ReleaseModule(Plugins::Interface* pluginInterface) {
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+namespace Grindstone::Jobs {
+	class JobSystem;
+}
+
+namespace Grindstone::Physics {
+	// Runs Jolt's jobs on the engine-wide job system, instead of a thread pool owned by each world context.
+	class JobSystemAdapter final : public JPH::JobSystemWithBarrier {
+	public:
+		JobSystemAdapter(Grindstone::Jobs::JobSystem& engineJobSystem, JPH::uint maxJobs, JPH::uint maxBarriers);
+
+		virtual int GetMaxConcurrency() const override;
+		virtual JobHandle CreateJob(const char* name, JPH::ColorArg color, const JobFunction& jobFunction, JPH::uint32 numDependencies = 0) override;
+
+	protected:
+		virtual void QueueJob(Job* job) override;
+		virtual void QueueJobs(Job** jobs, JPH::uint numJobs) override;
+		virtual void FreeJob(Job* job) override;
+
+	private:
+		using AvailableJobs = JPH::FixedSizeFreeList<Job>;
+
+		Grindstone::Jobs::JobSystem& engineJobSystem;
+		AvailableJobs availableJobs;
+	};
+}
@@ -2,13 +2,14 @@
 
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
 
 #include <Common/HashedString.hpp>
 #include <Common/Memory/SmartPointers/UniquePtr.hpp>
 #include <EngineCore/WorldContext/WorldContext.hpp>
 
+#include "JobSystemAdapter.hpp"
+
 const Grindstone::ConstHashedString physicsWorldContextName("Grindstone::Physics::WorldContext");
 
 namespace Grindstone::Physics {
@@ -143,7 +144,7 @@ namespace Grindstone::Physics {
 		JPH::BodyInterface& GetBodyInterface();
 		JPH::PhysicsSystem& GetPhysicsSystem();
 		JPH::TempAllocatorImpl& GetTempAllocator();
-		JPH::JobSystemThreadPool& GetJobSystem();
+		JPH::JobSystem& GetJobSystem();
 
 		[[nodiscard]] static WorldContext* GetActiveContext();
 		static void SetActiveContext(WorldContext& cxt);
@@ -151,7 +152,7 @@ namespace Grindstone::Physics {
 
 	protected:
 		JPH::TempAllocatorImpl tempAllocator;
-		JPH::JobSystemThreadPool jobSystem;
+		JobSystemAdapter jobSystem;
 		JPH::PhysicsSystem physicsSystem;
 		JPH::BodyInterface* bodyInterface = nullptr;
 
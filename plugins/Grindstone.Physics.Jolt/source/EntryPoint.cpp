@@ -99,7 +99,13 @@ extern "C" {
 		pluginInterface->RegisterComponent<RigidBodyComponent>();
 		pluginInterface->RegisterComponent<CharacterRigidbodyControllerComponent>();
 
-		pluginInterface->RegisterSystem("PhysicsSystem", PhysicsJoltSystem);
+		pluginInterface->RegisterSystem(
+			"PhysicsSystem",
+			PhysicsJoltSystem,
+			Grindstone::ECS::SystemComponentAccess()
+				.Read<RigidBodyComponent>()
+				.Write<CharacterRigidbodyControllerComponent, Grindstone::TransformComponent>()
+		);
 	}
 
 	JOLT_PHYSICS_EXPORT void ReleaseModule(Plugins::Interface* pluginInterface) {
@@ -0,0 +1,54 @@
+#include <thread>
+
+#include <EngineCore/Jobs/JobSystem.hpp>
+
+#include <Grindstone.Physics.Jolt/include/JobSystemAdapter.hpp>
+
+using namespace Grindstone::Physics;
+
+JobSystemAdapter::JobSystemAdapter(Grindstone::Jobs::JobSystem& engineJobSystem, JPH::uint maxJobs, JPH::uint maxBarriers)
+	: JPH::JobSystemWithBarrier(maxBarriers), engineJobSystem(engineJobSystem) {
+	availableJobs.Init(maxJobs, maxJobs);
+}
+
+int JobSystemAdapter::GetMaxConcurrency() const {
+	return static_cast<int>(engineJobSystem.GetThreadCount());
+}
+
+JPH::JobHandle JobSystemAdapter::CreateJob(const char* name, JPH::ColorArg color, const JobFunction& jobFunction, JPH::uint32 numDependencies) {
+	JPH::uint32 jobIndex = availableJobs.ConstructObject(name, color, this, jobFunction, numDependencies);
+	while (jobIndex == AvailableJobs::cInvalidObjectIndex) {
+		JPH_ASSERT(false, "No jobs available!");
+		std::this_thread::yield();
+		jobIndex = availableJobs.ConstructObject(name, color, this, jobFunction, numDependencies);
+	}
+
+	Job* job = &availableJobs.Get(jobIndex);
+
+	// Keep a reference in the handle, since the job can complete as soon as it's queued.
+	JobHandle handle(job);
+	if (numDependencies == 0) {
+		QueueJob(job);
+	}
+
+	return handle;
+}
+
+void JobSystemAdapter::QueueJob(Job* job) {
+	// Released once the job has executed, so it stays alive while it is queued.
+	job->AddRef();
+	engineJobSystem.Schedule([job] {
+		job->Execute();
+		job->Release();
+	});
+}
+
+void JobSystemAdapter::QueueJobs(Job** jobs, JPH::uint numJobs) {
+	for (JPH::uint i = 0; i < numJobs; ++i) {
+		QueueJob(jobs[i]);
+	}
+}
+
+void JobSystemAdapter::FreeJob(Job* job) {
+	availableJobs.DestructObject(job);
+}
@@ -9,6 +9,7 @@
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 
+#include <EngineCore/EngineCore.hpp>
 #include <EngineCore/Utils/MemoryAllocator.hpp>
 
 #include <Grindstone.Physics.Jolt/include/PhysicsWorldContext.hpp>
@@ -20,7 +21,7 @@ Grindstone::Physics::WorldContext* activeContext = nullptr;
 
 Grindstone::Physics::WorldContext::WorldContext() :
 	tempAllocator(JPH::TempAllocatorImpl(10 * 1024 * 1024)),
-	jobSystem(JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1))
+	jobSystem(*Grindstone::EngineCore::GetInstance().GetJobSystem(), JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers)
 {
 	
 	// This is the max amount of rigid bodies that you can add to the physics system. If you try to add more you'll get an error.
@@ -69,7 +70,7 @@ JPH::TempAllocatorImpl& Grindstone::Physics::WorldContext::GetTempAllocator() {
 	return tempAllocator;
 }
 
-JPH::JobSystemThreadPool& Grindstone::Physics::WorldContext::GetJobSystem() {
+JPH::JobSystem& Grindstone::Physics::WorldContext::GetJobSystem() {
 	return jobSystem;
 }
 
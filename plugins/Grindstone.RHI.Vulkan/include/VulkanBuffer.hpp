@@ -2,6 +2,7 @@
 
 #include <Common/Graphics/Buffer.hpp>
 #include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
 
 namespace Grindstone::GraphicsAPI::Vulkan {
 	class Buffer : public Grindstone::GraphicsAPI::Buffer {
@@ -16,7 +17,9 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 		virtual VkBuffer GetBuffer() const;
 
 	protected:
-		VkDeviceMemory deviceMemory = nullptr;
+		VmaAllocation allocation = nullptr;
 		VkBuffer bufferObject = nullptr;
+		// Host-visible memory stays mapped for the buffer's whole lifetime. Null for GPU-only buffers.
+		void* persistentlyMappedPtr = nullptr;
 	};
 }
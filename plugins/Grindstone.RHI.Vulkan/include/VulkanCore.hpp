@@ -44,6 +44,7 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 		virtual VkInstance GetInstance();
 		virtual VkDevice GetDevice();
 		virtual VkPhysicalDevice GetPhysicalDevice();
+		VmaAllocator GetAllocator() const;
 		virtual VkCommandBuffer BeginSingleTimeCommands(const char* debugName);
 		virtual uint32_t GetGraphicsFamily();
 		virtual void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
@@ -130,6 +131,7 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 		virtual inline bool SupportsMultiDrawIndirect() const override;
 
 		virtual void WaitUntilIdle() override;
+		virtual GraphicsAPI::MemoryStats GetMemoryStats() const override;
 
 		// Unused
 		virtual void Clear(ClearMode mask, float clear_color[4], float clear_depth, uint32_t clear_stencil) override;
@@ -148,6 +150,7 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 		std::string adapterName;
 		std::string apiVersion;
 		VmaAllocator allocator;
+		bool isMemoryBudgetSupported = false;
 		GpuCrashTracker* gpuCrashTracker = nullptr;
 
 		Window* primaryWindow = nullptr;
@@ -3,6 +3,7 @@
 #include <Common/Graphics/Image.hpp>
 #include <Common/Graphics/Formats.hpp>
 #include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
 
 namespace Grindstone::GraphicsAPI::Vulkan {
 	VkAttachmentLoadOp TranslateLoadOpToVulkan(Grindstone::GraphicsAPI::LoadOp loadOp);
@@ -16,7 +17,7 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 	VkSamplerAddressMode TranslateWrapToVulkan(TextureWrapMode);
 	VkFormat TranslateFormatToVulkan(Format format);
 	Format TranslateFormatFromVulkan(VkFormat format);
-	VkMemoryPropertyFlags TranslateMemoryUsageToVulkan(MemoryUsage memUsage);
+	VmaAllocationCreateInfo TranslateMemoryUsageToVma(MemoryUsage memoryUsage, bool isImage);
 	VkCullModeFlags TranslateCullModeToVulkan(CullMode cullMode);
 	VkColorComponentFlags TranslateColorMaskToVulkan(ColorMask colorMask);
 	VkPolygonMode TranslatePolygonModeToVulkan(PolygonFillMode mode);
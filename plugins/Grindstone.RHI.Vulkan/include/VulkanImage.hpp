@@ -2,6 +2,7 @@
 
 #include <Common/Graphics/Image.hpp>
 #include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
 
 namespace Grindstone::GraphicsAPI::Vulkan {
 	class Image : public Grindstone::GraphicsAPI::Image {
@@ -36,7 +37,9 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 		std::string imageName;
 		VkImageAspectFlags aspect;
 		VkImageViewType imageViewType;
-		VkDeviceMemory imageMemory = nullptr;
+		VmaAllocation imageAllocation = nullptr;
+		// Persistent mapping of host-visible images, null for GPU-only images.
+		void* mappedMemory = nullptr;
 		VkImageView imageView = nullptr;
 		VkImage image = nullptr;
 		VkFormat vkFormat = VK_FORMAT_UNDEFINED;
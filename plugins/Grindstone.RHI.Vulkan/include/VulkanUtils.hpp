@@ -2,6 +2,7 @@
 
 #include <Common/Graphics/Formats.hpp>
 #include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
 #include <stdint.h>
 
 namespace Grindstone::GraphicsAPI::Vulkan {
@@ -16,12 +17,16 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 		VkFormat format,
 		VkImageTiling tiling,
 		VkImageUsageFlags usage,
-		VkMemoryPropertyFlags properties,
+		MemoryUsage memoryUsage,
 		VkImage& image,
-		VkDeviceMemory& imageMemory,
+		VmaAllocation& imageAllocation,
+		void** mappedMemory,
 		VkImageCreateFlags flags
 	);
-	void CreateBuffer(const char* debugName, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+	// Sub-allocates the buffer's memory through VMA. If mappedMemory is given, it receives the persistent mapping of host-visible memory.
+	void CreateBuffer(const char* debugName, VkDeviceSize size, VkBufferUsageFlags usage, MemoryUsage memoryUsage, VkBuffer& buffer, VmaAllocation& bufferAllocation, void** mappedMemory = nullptr);
+	void DestroyBuffer(VkBuffer buffer, VmaAllocation bufferAllocation);
+	void DestroyImage(VkImage image, VmaAllocation imageAllocation);
 	VkCommandBuffer BeginSingleTimeCommands(const char* debugName);
 	void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
 	VkShaderStageFlags TranslateShaderStageBits(ShaderStageBit shaderStageBits);
@@ -35,90 +35,67 @@ Vulkan::Buffer::Buffer(const CreateInfo& createInfo) : GraphicsAPI::Buffer(creat
 		usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 	}
 
-	VkMemoryPropertyFlags properties = TranslateMemoryUsageToVulkan(createInfo.memoryUsage);
-
-	VkDevice device = Vulkan::Core::Get().GetDevice();
-	CreateBuffer(createInfo.debugName, bufferSize, usage, properties, bufferObject, deviceMemory);
+	CreateBuffer(createInfo.debugName, bufferSize, usage, memoryUsage, bufferObject, allocation, &persistentlyMappedPtr);
 
 	// Copy data if content is not nullptr.
 	if (createInfo.content != nullptr) {
-		if ((properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) > 0) {
-			// If I'm CPUOnly or CPUToGPU, then copy data directly to buffer.
-			void* data;
-			vkMapMemory(device, deviceMemory, 0, bufferSize, 0, &data);
-			memcpy(data, createInfo.content, bufferSize);
-			vkUnmapMemory(device, deviceMemory);
+		if (persistentlyMappedPtr != nullptr) {
+			// If I'm CPUOnly, CPUToGPU or GPUToCPU, then copy data directly to buffer.
+			UploadData(createInfo.content, bufferSize, 0);
 		}
 		else {
 			// Otherwise, use a staging buffer.
 			std::string stagingDebugName = std::string(createInfo.debugName) + " Staging";
 
 			VkBuffer stagingBuffer;
-			VkDeviceMemory stagingBufferMemory;
-			CreateBuffer(stagingDebugName.c_str(), bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+			VmaAllocation stagingAllocation;
+			void* stagingMappedPtr = nullptr;
+			CreateBuffer(stagingDebugName.c_str(), bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::CPUToGPU, stagingBuffer, stagingAllocation, &stagingMappedPtr);
 
-			void* data;
-			vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
-			memcpy(data, createInfo.content, bufferSize);
-			vkUnmapMemory(device, stagingBufferMemory);
+			memcpy(stagingMappedPtr, createInfo.content, bufferSize);
+			vmaFlushAllocation(Vulkan::Core::Get().GetAllocator(), stagingAllocation, 0, VK_WHOLE_SIZE);
 
 			CopyBuffer(stagingBuffer, bufferObject, bufferSize);
 
-			vkDestroyBuffer(device, stagingBuffer, nullptr);
-			vkFreeMemory(device, stagingBufferMemory, nullptr);
+			DestroyBuffer(stagingBuffer, stagingAllocation);
 		}
 	}
 }
 
 Vulkan::Buffer::~Buffer() {
-	VkDevice device = Vulkan::Core::Get().GetDevice();
-
 	if (bufferObject != nullptr) {
-		vkDestroyBuffer(device, bufferObject, nullptr);
-	}
-
-	if (deviceMemory != nullptr) {
-		vkFreeMemory(device, deviceMemory, nullptr);
+		DestroyBuffer(bufferObject, allocation);
 	}
 }
 
 void* Vulkan::Buffer::Map() {
-	if (mappedMemoryPtr == nullptr) {
-		VkDevice device = Vulkan::Core::Get().GetDevice();
-		VkResult result = vkMapMemory(device, deviceMemory, 0, bufferSize, 0, &mappedMemoryPtr);
-		if (result != VK_SUCCESS) {
-			GPRINT_ERROR_V(LogSource::GraphicsAPI, "Failed to map buffer memory!");
-			return nullptr;
-		}
+	if (persistentlyMappedPtr == nullptr) {
+		GPRINT_ERROR_V(LogSource::GraphicsAPI, "Failed to map buffer memory, it is not host visible!");
+		return nullptr;
 	}
 
+	// Pick up anything the GPU wrote, in case the memory isn't host coherent.
+	vmaInvalidateAllocation(Vulkan::Core::Get().GetAllocator(), allocation, 0, VK_WHOLE_SIZE);
+	mappedMemoryPtr = persistentlyMappedPtr;
 	return mappedMemoryPtr;
 }
 
 void Vulkan::Buffer::Unmap() {
-	VkDevice device = Vulkan::Core::Get().GetDevice();
-
 	if (mappedMemoryPtr != nullptr) {
-		vkUnmapMemory(device, deviceMemory);
+		vmaFlushAllocation(Vulkan::Core::Get().GetAllocator(), allocation, 0, VK_WHOLE_SIZE);
 		mappedMemoryPtr = nullptr;
 	}
 }
 
 void Vulkan::Buffer::UploadData(const void* data, size_t size, size_t offset) {
-	VkDevice device = Vulkan::Core::Get().GetDevice();
-
-	bool ownsMemoryMap = false;
-	if (!mappedMemoryPtr) {
-		ownsMemoryMap = true;
-		vkMapMemory(device, deviceMemory, offset, bufferSize, 0, &mappedMemoryPtr);
+	if (persistentlyMappedPtr == nullptr) {
+		GPRINT_ERROR_V(LogSource::GraphicsAPI, "Failed to upload buffer data, its memory is not host visible!");
+		return;
 	}
 
-	std::memcpy(mappedMemoryPtr, data, size);
-
-	if (ownsMemoryMap) {
-		vkUnmapMemory(device, deviceMemory);
-		mappedMemoryPtr = nullptr;
-	}
+	GS_ASSERT_ENGINE(offset + size <= bufferSize);
+	std::memcpy(static_cast<char*>(persistentlyMappedPtr) + offset, data, size);
+	vmaFlushAllocation(Vulkan::Core::Get().GetAllocator(), allocation, offset, size);
 }
 
 VkBuffer Vulkan::Buffer::GetBuffer() const {
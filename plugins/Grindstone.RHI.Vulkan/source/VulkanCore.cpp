@@ -193,6 +193,9 @@ void Vulkan::Core::CreateAllocator() {
 	allocatorInfo.physicalDevice = physicalDevice;
 	allocatorInfo.device = device;
 	allocatorInfo.instance = instance;
+	if (isMemoryBudgetSupported) {
+		allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+	}
 
 	vmaCreateAllocator(&allocatorInfo, &allocator);
 }
@@ -402,6 +405,12 @@ void Vulkan::Core::CreateLogicalDevice() {
 
 	std::vector<const char*> usedDeviceExtensions = requiredDeviceExtensions;
 
+	// Lets VMA report the driver's real budget instead of estimating it from heap sizes.
+	isMemoryBudgetSupported = IsExtensionSupported(supportedExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	if (isMemoryBudgetSupported) {
+		usedDeviceExtensions.emplace_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	}
+
 	void* firstDeviceFeature = &deviceFeatures2;
 
 	VkPhysicalDeviceFaultFeaturesEXT faultFeatures{
@@ -774,6 +783,31 @@ VkPhysicalDevice Vulkan::Core::GetPhysicalDevice() {
 	return physicalDevice;
 }
 
+VmaAllocator Vulkan::Core::GetAllocator() const {
+	return allocator;
+}
+
+Base::MemoryStats Vulkan::Core::GetMemoryStats() const {
+	const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+	vmaGetMemoryProperties(allocator, &memoryProperties);
+
+	std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> heapBudgets{};
+	vmaGetHeapBudgets(allocator, heapBudgets.data());
+
+	Base::MemoryStats stats{};
+	for (uint32_t heapIndex = 0; heapIndex < memoryProperties->memoryHeapCount; ++heapIndex) {
+		const VmaBudget& heapBudget = heapBudgets[heapIndex];
+		stats.budgetBytes += heapBudget.budget;
+		stats.usageBytes += heapBudget.usage;
+		stats.blockBytes += heapBudget.statistics.blockBytes;
+		stats.allocationBytes += heapBudget.statistics.allocationBytes;
+		stats.blockCount += heapBudget.statistics.blockCount;
+		stats.allocationCount += heapBudget.statistics.allocationCount;
+	}
+
+	return stats;
+}
+
 VkCommandBuffer Vulkan::Core::BeginSingleTimeCommands(const char* debugName) {
 	return Vulkan::BeginSingleTimeCommands(debugName);
 }
@@ -612,15 +612,35 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 		return Format::Invalid;
 	}
 
-	VkMemoryPropertyFlags TranslateMemoryUsageToVulkan(GraphicsAPI::MemoryUsage memUsage) {
-		switch (memUsage) {
+	VmaAllocationCreateInfo TranslateMemoryUsageToVma(MemoryUsage memoryUsage, bool isImage) {
+		// Host-visible memory is mapped for the lifetime of the allocation, so uploads never have to map it.
+		VmaAllocationCreateInfo allocationCreateInfo{};
+		switch (memoryUsage) {
 		default:
-		case MemoryUsage::GPUOnly:		return VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-		case MemoryUsage::CPUOnly:		return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-		case MemoryUsage::CPUToGPU:		return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-		case MemoryUsage::GPUToCPU:		return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-		case MemoryUsage::Transient:	return VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+		case MemoryUsage::GPUOnly:
+			allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+			break;
+		case MemoryUsage::CPUOnly:
+			allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+			allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+			break;
+		case MemoryUsage::CPUToGPU:
+			allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+			allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+			break;
+		case MemoryUsage::GPUToCPU:
+			allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+			allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+			break;
+		case MemoryUsage::Transient:
+			// Only attachments can be lazily allocated, so transient buffers just live on the GPU.
+			allocationCreateInfo.usage = isImage
+				? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED
+				: VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+			break;
 		}
+
+		return allocationCreateInfo;
 	}
 
 	VkCullModeFlags TranslateCullModeToVulkan(CullMode cullMode) {
@@ -131,10 +131,9 @@ void Vulkan::Image::Create() {
 
 	if (!imageName.empty()) {
 		std::string imageViewDebugName = imageName + " View";
-		std::string imageMemoryDebugName = imageName + " Memory";
 		Vulkan::Core::Get().NameObject(VK_OBJECT_TYPE_IMAGE, image, imageName.c_str());
 		Vulkan::Core::Get().NameObject(VK_OBJECT_TYPE_IMAGE_VIEW, imageView, imageViewDebugName.c_str());
-		Vulkan::Core::Get().NameObject(VK_OBJECT_TYPE_DEVICE_MEMORY, imageMemory, imageMemoryDebugName.c_str());
+		vmaSetAllocationName(Vulkan::Core::Get().GetAllocator(), imageAllocation, imageName.c_str());
 	}
 	else {
 		GPRINT_WARN(LogSource::GraphicsAPI, "Unnamed image!");
@@ -264,8 +263,9 @@ void Vulkan::Image::Resize(uint32_t width, uint32_t height) {
 
 	VkDevice device = Vulkan::Core::Get().GetDevice();
 	vkDestroyImageView(device, imageView, nullptr);
-	vkDestroyImage(device, image, nullptr);
-	vkFreeMemory(device, imageMemory, nullptr);
+	DestroyImage(image, imageAllocation);
+	imageAllocation = nullptr;
+	mappedMemory = nullptr;
 	Create();
 }
 
@@ -273,8 +273,7 @@ Vulkan::Image::~Image() {
 	VkDevice device = Vulkan::Core::Get().GetDevice();
 	vkDestroyImageView(device, imageView, nullptr);
 
-	vkDestroyImage(device, image, nullptr);
-	vkFreeMemory(device, imageMemory, nullptr);
+	DestroyImage(image, imageAllocation);
 }
 
 void Vulkan::Image::CreateImage() {
@@ -305,8 +304,6 @@ void Vulkan::Image::CreateImage() {
 		usageFlags |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
 	}
 
-	VkMemoryPropertyFlags vkMemoryProperties = TranslateMemoryUsageToVulkan(memoryUsage);
-
 	VkImageTiling tiling = (memoryUsage == GraphicsAPI::MemoryUsage::GPUOnly)
 		? VK_IMAGE_TILING_OPTIMAL
 		: VK_IMAGE_TILING_LINEAR;
@@ -320,9 +317,10 @@ void Vulkan::Image::CreateImage() {
 		vkFormat,
 		tiling,
 		usageFlags,
-		vkMemoryProperties,
+		memoryUsage,
 		image,
-		imageMemory,
+		imageAllocation,
+		&mappedMemory,
 		createFlags
 	);
 
@@ -339,23 +337,21 @@ void Vulkan::Image::CreateImage() {
 }
 
 void Vulkan::Image::UploadData(const char* data, uint64_t dataSize) {
-	VkDevice device = Vulkan::Core::Get().GetDevice();
-
 	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
+	VmaAllocation stagingAllocation;
+	void* mappedData = nullptr;
 	CreateBuffer(
 		imageName.c_str(),
 		dataSize,
 		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		MemoryUsage::CPUToGPU,
 		stagingBuffer,
-		stagingBufferMemory
+		stagingAllocation,
+		&mappedData
 	);
 
-	void* mappedData;
-	vkMapMemory(device, stagingBufferMemory, 0, dataSize, 0, &mappedData);
 	memcpy(mappedData, data, static_cast<size_t>(dataSize));
-	vkUnmapMemory(device, stagingBufferMemory);
+	vmaFlushAllocation(Vulkan::Core::Get().GetAllocator(), stagingAllocation, 0, VK_WHOLE_SIZE);
 
 	TransitionImageLayout(
 		image,
@@ -425,28 +421,25 @@ void Vulkan::Image::UploadData(const char* data, uint64_t dataSize) {
 
 	EndSingleTimeCommands(commandBuffer);
 	
-	vkDestroyBuffer(device, stagingBuffer, nullptr);
-	vkFreeMemory(device, stagingBufferMemory, nullptr);
+	DestroyBuffer(stagingBuffer, stagingAllocation);
 }
 
 void Vulkan::Image::UploadDataRegions(void* buffer, size_t bufferSize, ImageRegion* regions, uint32_t regionCount) {
-	VkDevice device = Vulkan::Core::Get().GetDevice();
-
 	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
+	VmaAllocation stagingAllocation;
+	void* mappedData = nullptr;
 	CreateBuffer(
 		imageName.c_str(),
 		bufferSize,
 		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		MemoryUsage::CPUToGPU,
 		stagingBuffer,
-		stagingBufferMemory
+		stagingAllocation,
+		&mappedData
 	);
 
-	void* mappedData;
-	vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &mappedData);
 	memcpy(mappedData, buffer, static_cast<size_t>(bufferSize));
-	vkUnmapMemory(device, stagingBufferMemory);
+	vmaFlushAllocation(Vulkan::Core::Get().GetAllocator(), stagingAllocation, 0, VK_WHOLE_SIZE);
 
 	std::string cmdBufferDebugName = std::format("{} Upload Regions Command Buffer", imageName.c_str());
 	VkCommandBuffer commandBuffer = BeginSingleTimeCommands(cmdBufferDebugName.c_str());
@@ -550,41 +543,42 @@ void Vulkan::Image::UploadDataRegions(void* buffer, size_t bufferSize, ImageRegi
 
 	EndSingleTimeCommands(commandBuffer);
 
-	vkDestroyBuffer(device, stagingBuffer, nullptr);
-	vkFreeMemory(device, stagingBufferMemory, nullptr);
+	DestroyBuffer(stagingBuffer, stagingAllocation);
 }
 
 void* Vulkan::Image::MapMemory(uint64_t dataSize, uint64_t dataOffset) {
-	void* mappedData;
+	// Host-visible images are persistently mapped when they are created.
+	if (mappedMemory == nullptr) {
+		GPRINT_ERROR(LogSource::GraphicsAPI, "Failed to map image memory, it is not host visible!");
+		return nullptr;
+	}
 
 	if (dataSize == Image::MAPPED_MEMORY_ENTIRE_BUFFER) {
 		dataSize = VK_WHOLE_SIZE;
 	}
 
-	VkDevice device = Vulkan::Core::Get().GetDevice();
-	VkResult result = vkMapMemory(device, imageMemory, dataOffset, dataSize, 0, &mappedData);
-	return result == VkResult::VK_SUCCESS
-		? mappedData
-		: nullptr;
+	vmaInvalidateAllocation(Vulkan::Core::Get().GetAllocator(), imageAllocation, dataOffset, dataSize);
+	return static_cast<char*>(mappedMemory) + dataOffset;
 }
 
 void Vulkan::Image::UnmapMemory() {
-	VkDevice device = Vulkan::Core::Get().GetDevice();
-	vkFreeMemory(device, imageMemory, nullptr);
+	if (mappedMemory != nullptr) {
+		vmaFlushAllocation(Vulkan::Core::Get().GetAllocator(), imageAllocation, 0, VK_WHOLE_SIZE);
+	}
 }
 
 Grindstone::Buffer Vulkan::Image::ReadbackMemory() {
-	VkDevice device = Vulkan::Core::Get().GetDevice();
-
 	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
+	VmaAllocation stagingAllocation;
+	void* mappedData = nullptr;
 	CreateBuffer(
 		imageName.c_str(),
 		maxImageSize,
 		VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		MemoryUsage::GPUToCPU,
 		stagingBuffer,
-		stagingBufferMemory
+		stagingAllocation,
+		&mappedData
 	);
 
 	std::string cmdBufferDebugName = std::format("{} Readback Command Buffer", imageName.c_str());
@@ -619,13 +613,10 @@ Grindstone::Buffer Vulkan::Image::ReadbackMemory() {
 	EndSingleTimeCommands(commandBuffer);
 
 	Grindstone::Buffer buffer(maxImageSize);
-	void* mappedData;
-	vkMapMemory(device, stagingBufferMemory, 0, maxImageSize, 0, &mappedData);
+	vmaInvalidateAllocation(Vulkan::Core::Get().GetAllocator(), stagingAllocation, 0, VK_WHOLE_SIZE);
 	memcpy(buffer.Get(), mappedData, static_cast<size_t>(maxImageSize));
-	vkUnmapMemory(device, stagingBufferMemory);
 
-	vkDestroyBuffer(device, stagingBuffer, nullptr);
-	vkFreeMemory(device, stagingBufferMemory, nullptr);
+	DestroyBuffer(stagingBuffer, stagingAllocation);
 	return buffer;
 }
 
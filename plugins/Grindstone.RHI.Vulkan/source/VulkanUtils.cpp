@@ -1,6 +1,7 @@
 #include <EngineCore/Logger.hpp>
 
 #include <Grindstone.RHI.Vulkan/include/VulkanCore.hpp>
+#include <Grindstone.RHI.Vulkan/include/VulkanFormat.hpp>
 #include <Grindstone.RHI.Vulkan/include/VulkanUtils.hpp>
 
 namespace Grindstone::GraphicsAPI::Vulkan {
@@ -53,13 +54,12 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 		VkFormat format,
 		VkImageTiling tiling,
 		VkImageUsageFlags usage,
-		VkMemoryPropertyFlags properties,
+		MemoryUsage memoryUsage,
 		VkImage& image,
-		VkDeviceMemory& imageMemory,
+		VmaAllocation& imageAllocation,
+		void** mappedMemory,
 		VkImageCreateFlags flags
 	) {
-		VkDevice device = Vulkan::Core::Get().GetDevice();
-			
 		VkImageCreateInfo imageInfo{};
 		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -76,68 +76,60 @@ namespace Grindstone::GraphicsAPI::Vulkan {
 		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		imageInfo.flags = flags;
 
-		if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
+		// VMA gives an image its own memory block only when the driver requires or prefers it.
+		VmaAllocationCreateInfo allocationCreateInfo = TranslateMemoryUsageToVma(memoryUsage, true);
+		VmaAllocationInfo allocationInfo{};
+		if (vmaCreateImage(Vulkan::Core::Get().GetAllocator(), &imageInfo, &allocationCreateInfo, &image, &imageAllocation, &allocationInfo) != VK_SUCCESS) {
 			GPRINT_FATAL(LogSource::GraphicsAPI, "failed to create image!");
 		}
 
-		VkMemoryRequirements memRequirements;
-		vkGetImageMemoryRequirements(device, image, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo = {};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = Vulkan::Core::Get().FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-		if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-			GPRINT_FATAL(LogSource::GraphicsAPI, "failed to allocate image memory!");
+		if (mappedMemory != nullptr) {
+			*mappedMemory = allocationInfo.pMappedData;
 		}
 
-		vkBindImageMemory(device, image, imageMemory, 0);
-
-		return memRequirements.size;
+		return allocationInfo.size;
 	}
 
 	void CreateBuffer(
 		const char* debugName,
 		VkDeviceSize size,
 		VkBufferUsageFlags usage,
-		VkMemoryPropertyFlags properties,
+		MemoryUsage memoryUsage,
 		VkBuffer& buffer,
-		VkDeviceMemory& bufferMemory
+		VmaAllocation& bufferAllocation,
+		void** mappedMemory
 	) {
 		if (debugName == nullptr) {
 			GPRINT_FATAL(LogSource::GraphicsAPI, "Unnamed Buffer!");
 		}
 
-		VkDevice device = Vulkan::Core::Get().GetDevice();
 		VkBufferCreateInfo bufferInfo = {};
 		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		bufferInfo.size = size;
 		bufferInfo.usage = usage;
 		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-		if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+		VmaAllocator allocator = Vulkan::Core::Get().GetAllocator();
+		VmaAllocationCreateInfo allocationCreateInfo = TranslateMemoryUsageToVma(memoryUsage, false);
+		VmaAllocationInfo allocationInfo{};
+		if (vmaCreateBuffer(allocator, &bufferInfo, &allocationCreateInfo, &buffer, &bufferAllocation, &allocationInfo) != VK_SUCCESS) {
 			GPRINT_FATAL(LogSource::GraphicsAPI, "failed to create buffer!");
 		}
 
 		Vulkan::Core::Get().NameObject(VK_OBJECT_TYPE_BUFFER, buffer, debugName);
+		vmaSetAllocationName(allocator, bufferAllocation, debugName);
 
-		VkMemoryRequirements memRequirements;
-		vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo = {};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = Vulkan::Core::Get().FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-		if (vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-			GPRINT_FATAL(LogSource::GraphicsAPI, "failed to allocate buffer memory!");
+		if (mappedMemory != nullptr) {
+			*mappedMemory = allocationInfo.pMappedData;
 		}
+	}
 
-		std::string memoryName = std::string(debugName) + " Memory";
-		Vulkan::Core::Get().NameObject(VK_OBJECT_TYPE_DEVICE_MEMORY, bufferMemory, memoryName.c_str());
+	void DestroyBuffer(VkBuffer buffer, VmaAllocation bufferAllocation) {
+		vmaDestroyBuffer(Vulkan::Core::Get().GetAllocator(), buffer, bufferAllocation);
+	}
 
-		vkBindBufferMemory(device, buffer, bufferMemory, 0);
+	void DestroyImage(VkImage image, VmaAllocation imageAllocation) {
+		vmaDestroyImage(Vulkan::Core::Get().GetAllocator(), image, imageAllocation);
 	}
 
 	VkCommandBuffer BeginSingleTimeCommands(const char* debugName) {
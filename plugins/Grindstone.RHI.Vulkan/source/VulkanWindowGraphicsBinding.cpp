@@ -374,6 +374,7 @@ void Vulkan::WindowGraphicsBinding::WaitForRenderingFence() {
 	Vulkan::Core& vkCore = Vulkan::Core::Get();
 	VkDevice device = vkCore.GetDevice();
 	vkWaitForFences(device, 1, &inFlightFences[currentFrameIndex], VK_TRUE, UINT64_MAX);
+	++currentFrame;
 }
 
 bool Vulkan::WindowGraphicsBinding::AcquireNextImage() {
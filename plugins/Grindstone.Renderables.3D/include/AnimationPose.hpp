@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Grindstone.Renderables.3D/include/Components/AnimatorComponent.hpp>
+
+namespace Grindstone {
+	// Posing a skeleton is cheap, so each job poses several animators.
+	const size_t ANIMATORS_PER_JOB = 16;
+
+	// Matches the animation's channels to the rig's bones, so they aren't looked up by name every frame.
+	void BindAnimation(AnimatorComponent& animatorComponent, const AnimationClipAsset& animation, const RigAsset& rig);
+	// Asset slots are reused, so the uuids are checked as well as the pointers.
+	[[nodiscard]] bool IsAnimationBound(const AnimatorComponent& animatorComponent, const AnimationClipAsset* animation, const RigAsset* rig);
+	// Poses a bound animator's skeleton into its boneMatrices. Only touches the animator's own state, so animators can be posed on any thread.
+	void EvaluatePose(AnimatorComponent& animatorComponent, double currentTime);
+}
@@ -15,6 +15,7 @@ namespace Grindstone {
 	}
 
 	class EngineCore;
+	struct Mesh3dStreamedPayload;
 
 	class Mesh3dImporter : public SpecificAssetImporter<Mesh3dAsset, AssetType::Mesh3d> {
 		public:
@@ -23,16 +24,19 @@ namespace Grindstone {
 
 			virtual void* LoadAsset(Uuid uuid) override;
 			virtual void QueueReloadAsset(Uuid uuid) override;
+			virtual bool CanStreamAssets() const override { return true; }
+			virtual void CreateStreamingAsset(Uuid uuid) override;
+			virtual std::unique_ptr<Assets::StreamedAssetPayload> DecodeStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result) override;
+			virtual void FinishStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result, Assets::StreamedAssetPayload* payload) override;
 			void PrepareLayouts();
 			virtual void OnDeleteAsset(Grindstone::Mesh3dAsset& asset) override;
 		private:
 			uint64_t GetTotalFileSize(Formats::Model::V1::Header& header);
 			bool ImportModelFile(Mesh3dAsset& mesh);
-			void LoadMeshImportSubmeshes(
-				Mesh3dAsset& mesh,
-				const Formats::Model::V1::Header& header,
-				char*& sourcePtr
-			);
+			bool ImportModelFile(Mesh3dAsset& mesh, Assets::AssetLoadBinaryResult& result);
+			// Only reads the file, so it's safe to run in a streaming job.
+			void DecodeModelFile(Uuid uuid, Assets::AssetLoadBinaryResult& result, Mesh3dStreamedPayload& payload);
+			bool CreateMeshFromPayload(Mesh3dAsset& mesh, Assets::AssetLoadBinaryResult& result, Mesh3dStreamedPayload& payload);
 			void LoadMeshImportVertices(
 				Mesh3dAsset& mesh,
 				const Formats::Model::V1::Header& header,
@@ -19,7 +19,26 @@ namespace Grindstone {
 		AssetReference<AnimationClipAsset> animation;
 		AssetReference<RigAsset> rig;
 		GraphicsAPI::Buffer* skeletonMatrixBuffer = nullptr;
-		
+
+		// A channel of the animation, matched to the rig bone it animates when the animation is bound.
+		struct BoundChannel {
+			uint32_t boneIndex = 0;
+			uint32_t channelIndex = 0;
+			// The keyframe each track was last sampled at, so playing forward rarely has to search.
+			uint32_t positionCursor = 0;
+			uint32_t rotationCursor = 0;
+			uint32_t scaleCursor = 0;
+		};
+
+		// Bound by AnimateSkeletonSystem whenever the animation or rig changes.
+		const AnimationClipAsset* boundAnimation = nullptr;
+		const RigAsset* boundRig = nullptr;
+		Grindstone::Uuid boundAnimationUuid;
+		Grindstone::Uuid boundRigUuid;
+		// Sorted by bone index.
+		std::vector<BoundChannel> boundChannels;
+		std::vector<Math::Matrix4> boneMatrices;
+
 		REFLECT("Animator")
 	};
 }
@@ -24,6 +24,8 @@ namespace Grindstone {
 		Grindstone::GraphicsAPI::Buffer* vertexCountBuffer = nullptr;
 		Grindstone::GraphicsAPI::VertexArrayObject* skinnedVertexArrayObject = nullptr;
 		Grindstone::GraphicsAPI::DescriptorSet* skinningDescriptorSet = nullptr;
+		// The animator's matrix buffer that skinningDescriptorSet was created with, which changes when the animator is bound to another rig.
+		Grindstone::GraphicsAPI::Buffer* skinningMatrixBuffer = nullptr;
 
 		REFLECT("SkeletalMesh")
 	};
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <stdint.h>
+
 #include <Common/Rendering/RenderViewData.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
 
 namespace Grindstone::Renderer {
 	struct CullingFrustum {
@@ -22,6 +25,60 @@ namespace Grindstone::Renderer {
 		glm::vec3 axes[3] = {};
 	};
 
+	/*
+	 * World space boxes, stored as structure-of-arrays so several can be culled per instruction.
+	 * Each box is an OBB, made of a center and three axes scaled to half the box's size. They
+	 * don't depend on the view, so the same list can be culled against any number of frustums.
+	 */
+	struct CullingBoundsList {
+		enum Component : uint8_t {
+			CenterX, CenterY, CenterZ,
+			Axis0X, Axis0Y, Axis0Z,
+			Axis1X, Axis1Y, Axis1Z,
+			Axis2X, Axis2Y, Axis2Z,
+			ComponentCount
+		};
+
+		Grindstone::Memory::AllocatorCore::FrameVector<float> components[ComponentCount];
+		size_t count = 0;
+
+		void Reserve(size_t capacity);
+		void Add(const glm::mat4& worldMatrix, const AABB& aabb);
+		size_t GetVisibilityMaskWordCount() const;
+	};
+
+	// The planes of a CullingFrustum, moved into world space for one view.
+	struct BatchCullingFrustum {
+		static constexpr size_t planeCount = 5;
+
+		bool isOrtho;
+		float normalX[planeCount];
+		float normalY[planeCount];
+		float normalZ[planeCount];
+		float offset[planeCount];
+		// A box is outside if its whole extent along a normal is below minDistance or above maxDistance.
+		float minDistance[planeCount];
+		float maxDistance[planeCount];
+	};
+
+	enum class CullingInstructionSet {
+		Scalar,
+		Sse,
+		Avx2,
+		// The widest instruction set the CPU supports.
+		Best
+	};
+
 	bool IsInFrustum(const CullingFrustum& frustum, const glm::mat4& viewModelMatrix, const AABB& aabb);
 	CullingFrustum CreateFrustum(const Grindstone::Rendering::RenderViewData& renderViewData);
+
+	BatchCullingFrustum CreateBatchCullingFrustum(const CullingFrustum& frustum, const glm::mat4& viewMatrix);
+	// Sets one bit per box in visibilityMask, which must have GetVisibilityMaskWordCount() words. Gives the same
+	// results as IsInFrustum, except for boxes with no size along some axis, which IsInFrustum never culls.
+	void CullBounds(
+		const BatchCullingFrustum& frustum,
+		const CullingBoundsList& bounds,
+		uint64_t* visibilityMask,
+		CullingInstructionSet instructionSet = CullingInstructionSet::Best
+	);
 }
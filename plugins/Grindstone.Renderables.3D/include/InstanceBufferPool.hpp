@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <glm/mat4x4.hpp>
+
+namespace Grindstone::GraphicsAPI {
+	class Buffer;
+	class DescriptorSet;
+	class DescriptorSetLayout;
+}
+
+namespace Grindstone::Renderer {
+	// Matches RenderInstance in meshRenderer.gpset, padded to the same stride on every backend.
+	struct RenderInstanceData {
+		glm::mat4 matrix;
+		uint32_t entityId;
+		uint32_t padding[3];
+	};
+
+	static_assert(sizeof(RenderInstanceData) == 80, "RenderInstanceData must match the stride of RenderInstance in shaders.");
+
+	/*
+	 * A growable storage buffer per frame in flight, holding the instance data of every instanced draw
+	 * of that frame, bound as the per-draw descriptor set. Draws select their instances with firstInstance,
+	 * so the set only changes when the pipeline layout does. A frame's buffer is reused once that frame's
+	 * fence has been waited on again, so its contents are never overwritten while the GPU may still read them.
+	 */
+	class InstanceBufferPool {
+	public:
+		static constexpr uint32_t initialInstanceCapacity = 1024;
+
+		struct Range {
+			GraphicsAPI::Buffer* buffer = nullptr;
+			GraphicsAPI::DescriptorSet* descriptorSet = nullptr;
+			uint32_t firstInstance = 0;
+		};
+
+		InstanceBufferPool(const char* debugName);
+		~InstanceBufferPool();
+		InstanceBufferPool(const InstanceBufferPool&) = delete;
+		InstanceBufferPool& operator=(const InstanceBufferPool&) = delete;
+
+		// Reserves room for instanceCount instances that no other draw of this frame uses.
+		Range Allocate(uint32_t instanceCount);
+
+		static GraphicsAPI::DescriptorSetLayout* GetDescriptorSetLayout();
+	private:
+		struct FrameBuffer {
+			GraphicsAPI::Buffer* buffer = nullptr;
+			GraphicsAPI::DescriptorSet* descriptorSet = nullptr;
+			uint32_t capacity = 0;
+			uint32_t usedInstanceCount = 0;
+			uint64_t frameNumber = UINT64_MAX;
+		};
+
+		void CreateFrameBuffer(FrameBuffer& frame, uint32_t capacity);
+
+		const char* debugName = nullptr;
+		std::vector<FrameBuffer> frames;
+	};
+}
@@ -9,6 +9,7 @@
 #include "EngineCore/AssetRenderer/BaseAssetRenderer.hpp"
 #include "Components/MeshRendererComponent.hpp"
 #include "Assets/Mesh3dAsset.hpp"
+#include "InstanceBufferPool.hpp"
 
 namespace Grindstone {
 	namespace GraphicsAPI {
@@ -36,6 +37,7 @@ namespace Grindstone {
 			EngineCore* engineCore = nullptr;
 			std::string rendererName = "Mesh3d";
 			GraphicsAPI::DescriptorSet* engineDescriptorSet = nullptr;
+			Grindstone::Renderer::InstanceBufferPool instanceBufferPool;
 			static class GraphicsAPI::DescriptorSetLayout* perDrawDescriptorSetLayout;
 	};
 }
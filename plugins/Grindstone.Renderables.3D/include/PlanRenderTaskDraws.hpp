@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace Grindstone::Renderer {
+	template<typename RenderTask>
+	bool CanInstanceTogether(const RenderTask& a, const RenderTask& b) {
+		return a.pipeline == b.pipeline
+			&& a.materialDescriptorSet == b.materialDescriptorSet
+			&& a.vertexArrayObject == b.vertexArrayObject
+			&& a.baseIndex == b.baseIndex
+			&& a.indexCount == b.indexCount
+			&& a.baseVertex == b.baseVertex;
+	}
+
+	// One draw call, covering instanceCount tasks from firstTaskIndex.
+	struct RenderTaskDraw {
+		uint32_t firstTaskIndex;
+		uint32_t instanceCount;
+		// Where the draw's instances start in the task list's instance range. Unused with instancing disabled.
+		uint32_t firstInstance;
+	};
+
+	/*
+	 * Groups the tasks into draws, in order. Runs of tasks with the same pipeline, material, and submesh are
+	 * merged into one instanced draw, unless the pipeline has instancing disabled, in which case every task
+	 * is its own draw. Returns how many instances the draws read from the instance buffer.
+	 */
+	template<typename RenderTask, typename TaskAllocator, typename DrawAllocator>
+	uint32_t PlanRenderTaskDraws(const std::vector<RenderTask, TaskAllocator>& renderTasks, std::vector<RenderTaskDraw, DrawAllocator>& outDraws) {
+		uint32_t instanceCount = 0;
+
+		size_t taskIndex = 0;
+		while (taskIndex < renderTasks.size()) {
+			const RenderTask& renderTask = renderTasks[taskIndex];
+
+			RenderTaskDraw draw{ static_cast<uint32_t>(taskIndex), 1, 0 };
+			if (renderTask.isInstancingEnabled) {
+				while (
+					taskIndex + draw.instanceCount < renderTasks.size() &&
+					CanInstanceTogether(renderTask, renderTasks[taskIndex + draw.instanceCount])
+				) {
+					++draw.instanceCount;
+				}
+
+				draw.firstInstance = instanceCount;
+				instanceCount += draw.instanceCount;
+			}
+
+			outDraws.push_back(draw);
+			taskIndex += draw.instanceCount;
+		}
+
+		return instanceCount;
+	}
+}
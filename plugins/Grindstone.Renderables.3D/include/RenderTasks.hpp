@@ -2,8 +2,12 @@
 
 #include <Common/HashedString.hpp>
 #include <Common/Rendering/GeometryRenderingStats.hpp>
+#include <EngineCore/CoreComponents/Transform/WorldTransformComponent.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
 #include <Grindstone.Renderables.3D/include/Assets/Mesh3dAsset.hpp>
 #include <Grindstone.Renderables.3D/include/FrustumCulling.hpp>
+#include <Grindstone.Renderables.3D/include/InstanceBufferPool.hpp>
+#include <Grindstone.Renderables.3D/include/PlanRenderTaskDraws.hpp>
 #include <Grindstone.Renderables.3D/include/Components/MeshRendererComponent.hpp>
 
 namespace Grindstone::Renderer {
@@ -12,30 +16,56 @@ namespace Grindstone::Renderer {
 		uint32_t entityId;
 	};
 
+	// Task lists are rebuilt every frame, so they live on the frame arena.
+	template<typename RenderTask>
+	using RenderTaskList = Grindstone::Memory::AllocatorCore::FrameVector<RenderTask>;
+
+	// Sorts by pipeline first, then keeps draws of the same material and submesh next to each other,
+	// so they can be merged into instanced draws.
+	inline uint64_t MakeRenderSortData(
+		const void* pipeline,
+		const void* materialDescriptorSet,
+		const void* vertexArrayObject,
+		uint32_t baseIndex
+	) {
+		const uint64_t pipelineBits = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pipeline) >> 4) & 0xFFFFFFFF;
+		const uint64_t materialBits = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(materialDescriptorSet) >> 4) & 0xFFFF;
+		const uint64_t submeshBits = (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(vertexArrayObject) >> 4) ^ baseIndex) & 0xFFFF;
+		return (pipelineBits << 32) | (materialBits << 16) | submeshBits;
+	}
+
 	template<typename MeshComponentType, typename RenderTask>
-	std::vector<RenderTask> GenerateTaskList(
+	RenderTaskList<RenderTask> GenerateTaskList(
 		Grindstone::Rendering::GeometryRenderStats& renderingStats,
 		entt::registry& registry,
 		const Grindstone::Renderer::CullingFrustum& frustum,
 		const glm::mat4& viewMatrix,
 		Grindstone::HashedString renderQueueHash,
 		std::function<void(
-			std::vector<RenderTask>&,
+			RenderTaskList<RenderTask>&,
 			const Grindstone::HashedString,
 			const Mesh3dAsset::Submesh&,
 			const Mesh3dAsset*,
 			const MeshComponentType&,
-			const MeshRendererComponent&
+			const MeshRendererComponent&,
+			const RenderableBufferPair&
 		)> submeshCallback
 	) {
-		std::vector<RenderTask> renderTasks;
+		RenderTaskList<RenderTask> renderTasks;
 		renderTasks.reserve(1000);
 
-		auto view = registry.view<const entt::entity, const TransformComponent, const MeshComponentType, MeshRendererComponent>();
+		// Uses the world matrices cached by the transform system, rather than walking each hierarchy.
+		auto view = registry.view<const entt::entity, const WorldTransformComponent, const MeshComponentType, MeshRendererComponent>();
+
+		// Gather every box first, so they can be culled together in a batch.
+		Grindstone::Memory::AllocatorCore::FrameVector<entt::entity> candidateEntities;
+		Grindstone::Renderer::CullingBoundsList cullingBounds;
+		candidateEntities.reserve(view.size_hint());
+		cullingBounds.Reserve(view.size_hint());
 		view.each(
-			[&submeshCallback, &renderingStats, &registry, &renderTasks, &viewMatrix, frustum, renderQueueHash](
+			[&candidateEntities, &cullingBounds](
 				entt::entity entity,
-				const TransformComponent& transformComponent,
+				const WorldTransformComponent& worldTransformComponent,
 				const MeshComponentType& meshComponent,
 				MeshRendererComponent& meshRenderComponent
 			) {
@@ -45,66 +75,147 @@ namespace Grindstone::Renderer {
 					return;
 				}
 
-				Math::Matrix4 transform = TransformComponent::GetWorldTransformMatrix(entity, registry);
-				glm::mat4 viewTransformTransform = viewMatrix * transform;
-
 				Grindstone::Renderer::AABB aabb{ meshAsset->boundingData.minAABB, meshAsset->boundingData.maxAABB };
-				if (!IsInFrustum(frustum, viewTransformTransform, aabb)) {
-					renderingStats.objectsCulled += 1;
-					return;
-				}
+				cullingBounds.Add(worldTransformComponent.worldMatrix, aabb);
+				candidateEntities.push_back(entity);
+			}
+		);
 
-				renderingStats.objectsRendered += 1;
+		Grindstone::Memory::AllocatorCore::FrameVector<uint64_t> visibilityMask(cullingBounds.GetVisibilityMaskWordCount());
+		CullBounds(CreateBatchCullingFrustum(frustum, viewMatrix), cullingBounds, visibilityMask.data());
 
-				RenderableBufferPair renderableData{
-					.matrix = transform,
-					.entityId = static_cast<uint32_t>(entity)
-				};
-				meshRenderComponent.perDrawUniformBuffer->UploadData(&renderableData);
-
-				std::vector<Grindstone::AssetReference<Grindstone::MaterialAsset>>& materials = meshRenderComponent.materials;
-				for (const Grindstone::Mesh3dAsset::Submesh& submesh : meshAsset->submeshes) {
-					submeshCallback(
-						renderTasks,
-						renderQueueHash,
-						submesh,
-						meshAsset,
-						meshComponent,
-						meshRenderComponent
-					);
+		for (size_t candidateIndex = 0; candidateIndex < candidateEntities.size(); ++candidateIndex) {
+			const bool isVisible = (visibilityMask[candidateIndex / 64] >> (candidateIndex % 64)) & 1;
+			if (!isVisible) {
+				renderingStats.objectsCulled += 1;
+				continue;
+			}
+
+			renderingStats.objectsRendered += 1;
+
+			const entt::entity entity = candidateEntities[candidateIndex];
+			const WorldTransformComponent& worldTransformComponent = registry.get<const WorldTransformComponent>(entity);
+			const MeshComponentType& meshComponent = registry.template get<const MeshComponentType>(entity);
+			MeshRendererComponent& meshRenderComponent = registry.get<MeshRendererComponent>(entity);
+			const Mesh3dAsset* meshAsset = meshComponent.mesh.Get();
+
+			RenderableBufferPair renderableData{
+				.matrix = worldTransformComponent.worldMatrix,
+				.entityId = static_cast<uint32_t>(entity)
+			};
+			const size_t firstTaskIndex = renderTasks.size();
+			for (const Grindstone::Mesh3dAsset::Submesh& submesh : meshAsset->submeshes) {
+				submeshCallback(
+					renderTasks,
+					renderQueueHash,
+					submesh,
+					meshAsset,
+					meshComponent,
+					meshRenderComponent,
+					renderableData
+				);
+			}
+
+			// Instanced draws read their transforms from the instance buffer, so the per-draw buffer is
+			// only needed if one of this entity's draws has instancing disabled.
+			for (size_t taskIndex = firstTaskIndex; taskIndex < renderTasks.size(); ++taskIndex) {
+				if (!renderTasks[taskIndex].isInstancingEnabled) {
+					meshRenderComponent.perDrawUniformBuffer->UploadData(&renderableData);
+					break;
 				}
 			}
-		);
+		}
 
 		return renderTasks;
 	}
 
+	/*
+	 * Draws the tasks in order, as planned by PlanRenderTaskDraws. The instance data of every instanced draw is
+	 * uploaded at once to one range of the frame's instance buffer, and each draw selects its instances with
+	 * firstInstance, so set 2 stays bound between them. Draws with instancing disabled use their own per-draw set.
+	 */
 	template<typename RenderTask>
 	void RenderAllTasks(
 		Grindstone::Rendering::GeometryRenderStats& renderingStats,
 		GraphicsAPI::DescriptorSet* engineDescriptorSet,
 		GraphicsAPI::CommandBuffer* commandBuffer,
-		const std::vector<RenderTask>& renderTasks
+		const RenderTaskList<RenderTask>& renderTasks,
+		InstanceBufferPool& instanceBufferPool
 	) {
+		if (renderTasks.empty()) {
+			return;
+		}
+
+		RenderTaskList<RenderTaskDraw> draws;
+		draws.reserve(renderTasks.size());
+		const uint32_t instanceCount = PlanRenderTaskDraws(renderTasks, draws);
+
+		InstanceBufferPool::Range instanceRange;
+		if (instanceCount > 0) {
+			instanceRange = instanceBufferPool.Allocate(instanceCount);
+
+			RenderInstanceData* instanceData = Grindstone::Memory::AllocatorCore::AllocateFrameArray<RenderInstanceData>(instanceCount);
+			for (const RenderTaskDraw& draw : draws) {
+				if (!renderTasks[draw.firstTaskIndex].isInstancingEnabled) {
+					continue;
+				}
+
+				for (uint32_t instanceIndex = 0; instanceIndex < draw.instanceCount; ++instanceIndex) {
+					const RenderableBufferPair& srcInstance = renderTasks[draw.firstTaskIndex + instanceIndex].instanceData;
+					instanceData[draw.firstInstance + instanceIndex] = RenderInstanceData{ srcInstance.matrix, srcInstance.entityId, {} };
+				}
+			}
+
+			instanceRange.buffer->UploadData(
+				instanceData,
+				sizeof(RenderInstanceData) * instanceCount,
+				sizeof(RenderInstanceData) * instanceRange.firstInstance
+			);
+		}
+
 		const GraphicsAPI::PipelineLayout* pipelineLayout = nullptr;
 		const GraphicsAPI::GraphicsPipeline* graphicsPipeline = nullptr;
+		const GraphicsAPI::VertexArrayObject* vertexArrayObject = nullptr;
 		const GraphicsAPI::DescriptorSet* materialDescriptorSet = nullptr;
+		const GraphicsAPI::DescriptorSet* perDrawDescriptorSet = nullptr;
+		bool areDescriptorSetsBound = false;
+
+		for (const RenderTaskDraw& draw : draws) {
+			const RenderTask& renderTask = renderTasks[draw.firstTaskIndex];
+
+			GraphicsAPI::DescriptorSet* taskPerDrawDescriptorSet = renderTask.isInstancingEnabled
+				? instanceRange.descriptorSet
+				: renderTask.perDrawDescriptorSet;
 
-		for (const RenderTask& renderTask : renderTasks) {
 			if (graphicsPipeline != renderTask.pipeline) {
 				graphicsPipeline = renderTask.pipeline;
 				pipelineLayout = graphicsPipeline->pipelineLayout;
 				commandBuffer->BindGraphicsPipeline(renderTask.pipeline);
 				renderingStats.pipelineBinds += 1;
+
+				// The descriptor sets need to be bound again for the new layout.
+				areDescriptorSetsBound = false;
 			}
 
-			commandBuffer->BindVertexArrayObject(renderTask.vertexArrayObject);
+			if (vertexArrayObject != renderTask.vertexArrayObject) {
+				vertexArrayObject = renderTask.vertexArrayObject;
+				commandBuffer->BindVertexArrayObject(renderTask.vertexArrayObject);
+			}
+
+			const bool hasMaterialChanged = !areDescriptorSetsBound || renderTask.materialDescriptorSet != materialDescriptorSet;
+			if (hasMaterialChanged || taskPerDrawDescriptorSet != perDrawDescriptorSet) {
+				if (hasMaterialChanged) {
+					renderingStats.materialBinds += 1;
+				}
+
+				areDescriptorSetsBound = true;
+				materialDescriptorSet = renderTask.materialDescriptorSet;
+				perDrawDescriptorSet = taskPerDrawDescriptorSet;
 
-			if (renderTask.materialDescriptorSet != materialDescriptorSet) {
 				std::array<GraphicsAPI::DescriptorSet*, 3> descriptors = {
 					engineDescriptorSet,
 					renderTask.materialDescriptorSet,
-					renderTask.perDrawDescriptorSet,
+					taskPerDrawDescriptorSet,
 				};
 				commandBuffer->BindGraphicsDescriptorSet(
 					pipelineLayout,
@@ -112,18 +223,21 @@ namespace Grindstone::Renderer {
 					0,
 					static_cast<uint32_t>(descriptors.size())
 				);
-				renderingStats.materialBinds += 1;
 			}
 
 			renderingStats.drawCalls += 1;
-			renderingStats.vertices += renderTask.indexCount;
-			renderingStats.triangles += renderTask.indexCount / 3;
+			renderingStats.vertices += renderTask.indexCount * draw.instanceCount;
+			renderingStats.triangles += (renderTask.indexCount / 3) * draw.instanceCount;
+
+			const uint32_t firstInstance = renderTask.isInstancingEnabled
+				? instanceRange.firstInstance + draw.firstInstance
+				: 0;
 
 			commandBuffer->DrawIndices(
 				renderTask.baseIndex,
 				renderTask.indexCount,
-				0,
-				1,
+				firstInstance,
+				draw.instanceCount,
 				renderTask.baseVertex
 			);
 		}
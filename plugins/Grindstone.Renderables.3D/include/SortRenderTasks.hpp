@@ -14,13 +14,13 @@ namespace Grindstone::Renderer {
 		return a.sortData < b.sortData;
 	}
 
-	template<typename RenderTask>
-	void SortRenderTasks(std::vector<RenderTask>& renderTasks) {
+	template<typename RenderTask, typename Allocator>
+	void SortRenderTasks(std::vector<RenderTask, Allocator>& renderTasks) {
 		std::sort(renderTasks.begin(), renderTasks.end(), CompareRenderSort<RenderTask>);
 	}
 
-	template<typename RenderTask>
-	void SortRenderTasksReverse(std::vector<RenderTask>& renderTasks) {
+	template<typename RenderTask, typename Allocator>
+	void SortRenderTasksReverse(std::vector<RenderTask, Allocator>& renderTasks) {
 		std::sort(renderTasks.begin(), renderTasks.end(), CompareReverseRenderSort<RenderTask>);
 	}
 }
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <limits>
+
+#include <Common/Containers/Span.hpp>
+#include <EngineCore/Logger.hpp>
+
+#include <Grindstone.Renderables.3D/include/AnimationPose.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Containers;
+
+using AnimationTime = double;
+using AnimationWeight = float;
+
+const uint32_t invalidBoneIndex = std::numeric_limits<uint32_t>::max();
+
+[[nodiscard]] static AnimationWeight GetKeyframeWeight(AnimationTime lastTimeStamp, AnimationTime nextTimeStamp, AnimationTime animationTime) {
+	AnimationTime midWayLength = animationTime - lastTimeStamp;
+	AnimationTime framesDiff = nextTimeStamp - lastTimeStamp;
+	AnimationTime scaleFactor = midWayLength / framesDiff;
+	return glm::clamp(static_cast<AnimationWeight>(scaleFactor), 0.0f, 1.0f);
+}
+
+/*
+ * Returns the index of the keyframe at or before animationTime, clamped so there is always a keyframe
+ * after it. Checks the keyframe the track was last sampled at and the one after it first, which is
+ * all that playing forward needs, and only does a binary search when that fails, such as on a loop.
+ */
+template<typename T>
+[[nodiscard]] static uint32_t GetKeyframeIndexByTime(const Span<const AnimationClipAsset::Keyframe<T>> keyframes, AnimationTime animationTime, uint32_t cursor) {
+	GS_ASSERT(keyframes.GetSize() > 1);
+
+	const uint32_t lastIndex = static_cast<uint32_t>(keyframes.GetSize() - 2);
+	if (cursor <= lastIndex && keyframes[cursor].time <= animationTime) {
+		if (cursor == lastIndex || animationTime < keyframes[cursor + 1].time) {
+			return cursor;
+		}
+
+		if (cursor + 1 == lastIndex || animationTime < keyframes[cursor + 2].time) {
+			return cursor + 1;
+		}
+	}
+
+	const AnimationClipAsset::Keyframe<T>* begin = &keyframes.GetBegin();
+	const AnimationClipAsset::Keyframe<T>* end = begin + keyframes.GetSize();
+	const AnimationClipAsset::Keyframe<T>* nextKeyframe = std::upper_bound(begin, end, animationTime,
+		[](AnimationTime time, const AnimationClipAsset::Keyframe<T>& keyframe) -> bool {
+			return time < keyframe.time;
+		}
+	);
+
+	const uint32_t nextIndex = static_cast<uint32_t>(nextKeyframe - begin);
+	return nextIndex == 0
+		? 0
+		: std::min(nextIndex - 1, lastIndex);
+}
+
+[[nodiscard]] static Math::Float3 InterpolateValue(const Math::Float3& last, const Math::Float3& next, AnimationWeight weight) {
+	return glm::mix(last, next, weight);
+}
+
+[[nodiscard]] static Math::Quaternion InterpolateValue(const Math::Quaternion& last, const Math::Quaternion& next, AnimationWeight weight) {
+	return glm::slerp(last, next, weight);
+}
+
+template<typename T>
+[[nodiscard]] static T SampleKeyframes(
+	const Span<const AnimationClipAsset::Keyframe<T>> keyframes,
+	AnimationClipAsset::KeyframeInterpolation interpolation,
+	AnimationTime animationTime,
+	uint32_t& cursor,
+	const T& defaultValue
+) {
+	if (keyframes.GetSize() == 0) {
+		return defaultValue;
+	}
+
+	if (keyframes.GetSize() == 1) {
+		return keyframes[0].value;
+	}
+
+	cursor = GetKeyframeIndexByTime(keyframes, animationTime, cursor);
+	const AnimationClipAsset::Keyframe<T>& lastKeyframe = keyframes[cursor];
+	const AnimationClipAsset::Keyframe<T>& nextKeyframe = keyframes[cursor + 1];
+
+	switch (interpolation) {
+	case AnimationClipAsset::KeyframeInterpolation::Step:
+		return lastKeyframe.value;
+	case AnimationClipAsset::KeyframeInterpolation::Linear: {
+		AnimationWeight weight = GetKeyframeWeight(lastKeyframe.time, nextKeyframe.time, animationTime);
+		return InterpolateValue(lastKeyframe.value, nextKeyframe.value, weight);
+	}
+	default:
+		GS_ASSERT_LOG("Invalid interpolation type.");
+		return lastKeyframe.value;
+	}
+}
+
+// Builds translation * rotation * scale without multiplying three matrices together.
+[[nodiscard]] static Math::Matrix4 ComposeTransform(const Math::Float3& position, const Math::Quaternion& rotation, const Math::Float3& scale) {
+	// TODO: Can we get away with normalizing rotations in the importer instead?
+	Math::Matrix4 transform = glm::toMat4(glm::normalize(rotation));
+	transform[0] *= scale.x;
+	transform[1] *= scale.y;
+	transform[2] *= scale.z;
+	transform[3] = glm::vec4(position, 1.0f);
+	return transform;
+}
+
+void Grindstone::BindAnimation(AnimatorComponent& animatorComponent, const AnimationClipAsset& animation, const RigAsset& rig) {
+	GS_ASSERT_ENGINE(rig.bones.size() == rig.boneNameToIndex.size());
+
+	animatorComponent.boundAnimation = &animation;
+	animatorComponent.boundRig = &rig;
+	animatorComponent.boundAnimationUuid = animation.uuid;
+	animatorComponent.boundRigUuid = rig.uuid;
+
+	std::vector<AnimatorComponent::BoundChannel>& boundChannels = animatorComponent.boundChannels;
+	boundChannels.clear();
+	boundChannels.reserve(animation.boneChannels.size());
+
+	for (uint32_t channelIndex = 0; channelIndex < animation.boneChannels.size(); ++channelIndex) {
+		const AnimationClipAsset::BoneChannel& channel = animation.boneChannels[channelIndex];
+		auto boneIt = rig.boneNameToIndex.find(channel.boneName);
+		if (boneIt == rig.boneNameToIndex.end()) {
+			GPRINT_WARN_V(Grindstone::LogSource::Rendering, "Bone channel for bone name \"{}\" does not exist in RigAsset \"{}\". This bone channel will be ignored.", channel.boneName, rig.name);
+			continue;
+		}
+
+		GS_ASSERT_ENGINE_WITH_MESSAGE(boneIt->second < rig.bones.size(), "Bone index is out of bounds for RigAsset bones vector.");
+
+		// This is not supported yet because Assimp does not support tangent data.
+		GS_ASSERT_ENGINE(channel.interpolation != AnimationClipAsset::KeyframeInterpolation::Cubic);
+
+		AnimatorComponent::BoundChannel& boundChannel = boundChannels.emplace_back();
+		boundChannel.boneIndex = boneIt->second;
+		boundChannel.channelIndex = channelIndex;
+	}
+
+	std::sort(boundChannels.begin(), boundChannels.end(),
+		[](const AnimatorComponent::BoundChannel& a, const AnimatorComponent::BoundChannel& b) -> bool {
+			return a.boneIndex < b.boneIndex;
+		}
+	);
+
+	animatorComponent.boneMatrices.resize(rig.bones.size());
+}
+
+bool Grindstone::IsAnimationBound(const AnimatorComponent& animatorComponent, const AnimationClipAsset* animation, const RigAsset* rig) {
+	return
+		animatorComponent.boundAnimation == animation &&
+		animatorComponent.boundRig == rig &&
+		animatorComponent.boundAnimationUuid == animation->uuid &&
+		animatorComponent.boundRigUuid == rig->uuid;
+}
+
+void Grindstone::EvaluatePose(AnimatorComponent& animatorComponent, double currentTime) {
+	const AnimationClipAsset& animation = *animatorComponent.boundAnimation;
+	const RigAsset& rig = *animatorComponent.boundRig;
+	std::vector<Math::Matrix4>& boneMatrices = animatorComponent.boneMatrices;
+
+	const AnimationTime ticks = animation.ticksPerSecond * currentTime;
+	const AnimationTime animationTime = animation.duration > 0.0
+		? fmod(ticks, animation.duration)
+		: 0.0;
+
+	for (size_t i = 0; i < rig.bones.size(); ++i) {
+		boneMatrices[i] = rig.bones[i].localBindTransform;
+	}
+
+	for (AnimatorComponent::BoundChannel& boundChannel : animatorComponent.boundChannels) {
+		const AnimationClipAsset::BoneChannel& channel = animation.boneChannels[boundChannel.channelIndex];
+
+		const Span<const AnimationClipAsset::PositionKeyframe> positionSpan(animation.positions.data() + channel.positionKeyOffset, channel.positionCount);
+		const Span<const AnimationClipAsset::RotationKeyframe> rotationSpan(animation.rotations.data() + channel.rotationKeyOffset, channel.rotationCount);
+		const Span<const AnimationClipAsset::ScaleKeyframe> scaleSpan(animation.scales.data() + channel.scaleKeyOffset, channel.scaleCount);
+
+		const Math::Float3 position = SampleKeyframes(positionSpan, channel.interpolation, animationTime, boundChannel.positionCursor, Math::Float3(0.0f));
+		const Math::Quaternion rotation = SampleKeyframes(rotationSpan, channel.interpolation, animationTime, boundChannel.rotationCursor, Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f));
+		const Math::Float3 scale = SampleKeyframes(scaleSpan, channel.interpolation, animationTime, boundChannel.scaleCursor, Math::Float3(1.0f));
+		boneMatrices[boundChannel.boneIndex] = ComposeTransform(position, rotation, scale);
+	}
+
+	// Move local pose to global space. Parents come before their children in the rig.
+	for (size_t i = 0; i < rig.bones.size(); ++i) {
+		const RigAsset::Bone& bone = rig.bones[i];
+
+		if (bone.parentBoneIndex != invalidBoneIndex) {
+			const glm::mat4& parentGlobalMatrix = boneMatrices[bone.parentBoneIndex];
+			const glm::mat4& localMatrix = boneMatrices[i];
+			boneMatrices[i] = parentGlobalMatrix * localMatrix;
+		}
+	}
+
+	for (size_t i = 0; i < rig.bones.size(); ++i) {
+		boneMatrices[i] = boneMatrices[i] * rig.bones[i].inverseBindTransform;
+	}
+}
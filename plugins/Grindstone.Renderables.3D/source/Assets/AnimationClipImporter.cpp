@@ -91,8 +91,7 @@ static bool ImportAnimationClipFile(AnimationClipAsset& anim) {
 AnimationClipImporter::~AnimationClipImporter() {}
 
 void* AnimationClipImporter::LoadAsset(Uuid uuid) {
-	auto animIterator = assets.emplace(uuid, AnimationClipAsset(uuid, uuid.ToString()));
-	AnimationClipAsset& animAsset = animIterator.first->second;
+	AnimationClipAsset& animAsset = assets.Emplace(uuid, AnimationClipAsset(uuid, uuid.ToString()));
 
 	animAsset.assetLoadStatus = AssetLoadStatus::Loading;
 	if (!ImportAnimationClipFile(animAsset)) {
@@ -18,6 +18,17 @@ struct SourceSubmesh {
 	uint32_t materialIndex = UINT32_MAX;
 };
 
+struct Grindstone::Mesh3dStreamedPayload : public Grindstone::Assets::StreamedAssetPayload {
+	bool isDecoded = false;
+	// The mesh's status if it couldn't be decoded.
+	AssetLoadStatus failedStatus = AssetLoadStatus::Failed;
+	Formats::Model::V1::Header header;
+	Formats::Model::V1::BoundingData boundingData{};
+	std::vector<Mesh3dAsset::Submesh> submeshes;
+	// Points into the file's buffer, where the vertex channels start, followed by the indices.
+	char* vertexData = nullptr;
+};
+
 static GraphicsAPI::Buffer* LoadVertexBufferVec(
 	GraphicsAPI::Core* graphicsCore,
 	std::string& fileName,
@@ -156,24 +167,24 @@ void Mesh3dImporter::OnDeleteAsset(Grindstone::Mesh3dAsset& asset) {
 
 void Mesh3dImporter::QueueReloadAsset(Uuid uuid) {
 	GraphicsAPI::Core* graphicsCore = engineCore->GetGraphicsCore();
-	auto meshInMap = assets.find(uuid);
-	if (meshInMap == assets.end()) {
+	Grindstone::Mesh3dAsset* meshAssetPtr = assets.Find(uuid);
+	if (meshAssetPtr == nullptr) {
 		return;
 	}
 
-	Grindstone::Mesh3dAsset& meshAsset = meshInMap->second;
+	Grindstone::Mesh3dAsset& meshAsset = *meshAssetPtr;
 	meshAsset.assetLoadStatus = AssetLoadStatus::Reloading;
 	OnDeleteAsset(meshAsset);
 	ImportModelFile(meshAsset);
 }
 
-void Mesh3dImporter::LoadMeshImportSubmeshes(Mesh3dAsset& mesh, const Formats::Model::V1::Header& header, char*& sourcePtr) {
-	SourceSubmesh* sourceSubmeshes = reinterpret_cast<SourceSubmesh*>(sourcePtr);
-	mesh.submeshes.resize(header.meshCount);
+static void DecodeSubmeshes(Mesh3dStreamedPayload& payload, char*& sourcePtr) {
+	const SourceSubmesh* sourceSubmeshes = reinterpret_cast<const SourceSubmesh*>(sourcePtr);
+	payload.submeshes.resize(payload.header.meshCount);
 
-	for (uint32_t i = 0; i < header.meshCount; ++i) {
-		Mesh3dAsset::Submesh& dst = mesh.submeshes[i];
-		SourceSubmesh& src = sourceSubmeshes[i];
+	for (uint32_t i = 0; i < payload.header.meshCount; ++i) {
+		Mesh3dAsset::Submesh& dst = payload.submeshes[i];
+		const SourceSubmesh& src = sourceSubmeshes[i];
 		dst.baseIndex = src.baseIndex;
 		dst.baseVertex = src.baseVertex;
 		dst.indexCount = src.indexCount;
@@ -181,7 +192,7 @@ void Mesh3dImporter::LoadMeshImportSubmeshes(Mesh3dAsset& mesh, const Formats::M
 		dst.vertexArrayObject = nullptr;
 	}
 
-	sourcePtr += header.meshCount * sizeof(SourceSubmesh);
+	sourcePtr += payload.header.meshCount * sizeof(SourceSubmesh);
 }
 
 void Mesh3dImporter::LoadMeshImportVertices(
@@ -243,28 +254,25 @@ void Mesh3dImporter::LoadMeshImportIndices(
 	GraphicsAPI::Buffer*& indexBuffer
 ) {
 	auto graphicsCore = engineCore->GetGraphicsCore();
-	std::vector<uint16_t> indices;
-	indices.resize(header.indexCount);
 	uint64_t indexSize = header.indexCount * sizeof(uint16_t);
-	memcpy(indices.data(), sourcePtr, indexSize);
+	void* indices = sourcePtr;
 	sourcePtr += indexSize;
 
 	std::string debugName = mesh.name + " Index Buffer";
 	GraphicsAPI::Buffer::CreateInfo indexBufferCreateInfo{};
 	indexBufferCreateInfo.debugName = debugName.c_str();
-	indexBufferCreateInfo.content = indices.data();
+	indexBufferCreateInfo.content = indices;
 	indexBufferCreateInfo.bufferUsage =
 		GraphicsAPI::BufferUsage::TransferDst |
 		GraphicsAPI::BufferUsage::TransferSrc |
 		GraphicsAPI::BufferUsage::Index;
 	indexBufferCreateInfo.memoryUsage = GraphicsAPI::MemoryUsage::GPUOnly;
-	indexBufferCreateInfo.bufferSize = static_cast<uint32_t>(indices.size() * sizeof(indices[0]));
+	indexBufferCreateInfo.bufferSize = static_cast<uint32_t>(indexSize);
 	mesh.indexBuffer = indexBuffer = graphicsCore->CreateBuffer(indexBufferCreateInfo);
 }
 
 void* Mesh3dImporter::LoadAsset(Uuid uuid) {
-	auto meshIterator = assets.emplace(uuid, Mesh3dAsset(uuid, uuid.ToString()));
-	Mesh3dAsset& meshAsset = meshIterator.first->second;
+	Mesh3dAsset& meshAsset = assets.Emplace(uuid, Mesh3dAsset(uuid, uuid.ToString()));
 
 	meshAsset.assetLoadStatus = AssetLoadStatus::Loading;
 	if (!ImportModelFile(meshAsset)) {
@@ -274,30 +282,57 @@ void* Mesh3dImporter::LoadAsset(Uuid uuid) {
 	return &meshAsset;
 }
 
+void Mesh3dImporter::CreateStreamingAsset(Uuid uuid) {
+	Mesh3dAsset& meshAsset = assets.Emplace(uuid, Mesh3dAsset(uuid, uuid.ToString()));
+	meshAsset.assetLoadStatus = AssetLoadStatus::Loading;
+}
+
+std::unique_ptr<Assets::StreamedAssetPayload> Mesh3dImporter::DecodeStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result) {
+	std::unique_ptr<Mesh3dStreamedPayload> payload = std::make_unique<Mesh3dStreamedPayload>();
+	DecodeModelFile(uuid, result, *payload);
+	return payload;
+}
+
+void Mesh3dImporter::FinishStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result, Assets::StreamedAssetPayload* payload) {
+	Mesh3dAsset* meshAsset = assets.Find(uuid);
+	if (meshAsset == nullptr || meshAsset->assetLoadStatus != AssetLoadStatus::Loading || payload == nullptr) {
+		return;
+	}
+
+	CreateMeshFromPayload(*meshAsset, result, *static_cast<Mesh3dStreamedPayload*>(payload));
+}
+
 bool Mesh3dImporter::ImportModelFile(Mesh3dAsset& mesh) {
 	Grindstone::Assets::AssetLoadBinaryResult result = engineCore->assetManager->LoadBinaryByUuid(AssetType::Mesh3d, mesh.uuid);
+	return ImportModelFile(mesh, result);
+}
+
+bool Mesh3dImporter::ImportModelFile(Mesh3dAsset& mesh, Assets::AssetLoadBinaryResult& result) {
+	Mesh3dStreamedPayload payload;
+	DecodeModelFile(mesh.uuid, result, payload);
+	return CreateMeshFromPayload(mesh, result, payload);
+}
+
+void Mesh3dImporter::DecodeModelFile(Uuid uuid, Assets::AssetLoadBinaryResult& result, Mesh3dStreamedPayload& payload) {
 	if (result.status != Grindstone::Assets::AssetLoadStatus::Success) {
-		GPRINT_ERROR_V(LogSource::EngineCore, "Mesh3dImporter::LoadAsset Unable to load file with id: {}", mesh.uuid.ToString());
-		mesh.assetLoadStatus = AssetLoadStatus::Missing;
-		return false;
+		GPRINT_ERROR_V(LogSource::EngineCore, "Mesh3dImporter::LoadAsset Unable to load file with id: {}", uuid.ToString());
+		payload.failedStatus = AssetLoadStatus::Missing;
+		return;
 	}
 
 	char* fileContent = reinterpret_cast<char*>(result.buffer.Get());
 	uint64_t fileSize = result.buffer.GetCapacity();
-	mesh.name = result.displayName;
+	const std::string& name = result.displayName;
 
-	auto graphicsCore = engineCore->GetGraphicsCore();
 	if (fileSize < 3 && strncmp("GMF", fileContent, 3) != 0) {
-		GPRINT_ERROR_V(LogSource::EngineCore, "Mesh3dImporter::LoadAsset \"{}\" with id \"{}\" doesn't start with GMF magic code.", mesh.name.c_str(), mesh.uuid.ToString());
-		mesh.assetLoadStatus = AssetLoadStatus::Failed;
-		return false;
+		GPRINT_ERROR_V(LogSource::EngineCore, "Mesh3dImporter::LoadAsset \"{}\" with id \"{}\" doesn't start with GMF magic code.", name.c_str(), uuid.ToString());
+		return;
 	}
 
-	Formats::Model::V1::Header header;
+	Formats::Model::V1::Header& header = payload.header;
 	if (fileSize < (3 + sizeof(header))) {
-		GPRINT_ERROR_V(LogSource::EngineCore, "Mesh3dImporter::LoadAsset \"{}\" with id \"{}\" not big enough to fit header.", mesh.name.c_str(), mesh.uuid.ToString());
-		mesh.assetLoadStatus = AssetLoadStatus::Failed;
-		return false;
+		GPRINT_ERROR_V(LogSource::EngineCore, "Mesh3dImporter::LoadAsset \"{}\" with id \"{}\" not big enough to fit header.", name.c_str(), uuid.ToString());
+		return;
 	}
 
 	char* headerPtr = fileContent + 3;
@@ -307,18 +342,37 @@ bool Mesh3dImporter::ImportModelFile(Mesh3dAsset& mesh) {
 
 	uint64_t totalFileExpectedSize = GetTotalFileSize(header);
 	if (totalFileExpectedSize > fileSize || header.totalFileSize > fileSize) {
-		GPRINT_ERROR_V(LogSource::EngineCore, "Mesh3dImporter::LoadAsset \"{}\" with id \"{}\" not big enough to fit all contents.", mesh.name.c_str(), mesh.uuid.ToString());
-		mesh.assetLoadStatus = AssetLoadStatus::Failed;
+		GPRINT_ERROR_V(LogSource::EngineCore, "Mesh3dImporter::LoadAsset \"{}\" with id \"{}\" not big enough to fit all contents.", name.c_str(), uuid.ToString());
+		return;
+	}
+
+	payload.boundingData = *(Formats::Model::V1::BoundingData*)srcPtr;
+	srcPtr = srcPtr + sizeof(Formats::Model::V1::BoundingData);
+
+	DecodeSubmeshes(payload, srcPtr);
+	payload.vertexData = srcPtr;
+	payload.isDecoded = true;
+}
+
+bool Mesh3dImporter::CreateMeshFromPayload(Mesh3dAsset& mesh, Assets::AssetLoadBinaryResult& result, Mesh3dStreamedPayload& payload) {
+	if (result.status == Grindstone::Assets::AssetLoadStatus::Success) {
+		mesh.name = result.displayName;
+	}
+
+	if (!payload.isDecoded) {
+		mesh.assetLoadStatus = payload.failedStatus;
 		return false;
 	}
 
+	auto graphicsCore = engineCore->GetGraphicsCore();
+	const Formats::Model::V1::Header& header = payload.header;
 	std::vector<GraphicsAPI::Buffer*> vertexBuffers;
 	GraphicsAPI::Buffer* indexBuffer = nullptr;
 
-	mesh.boundingData = *(Formats::Model::V1::BoundingData*)srcPtr;
-	srcPtr = srcPtr + sizeof(Formats::Model::V1::BoundingData);
+	mesh.boundingData = payload.boundingData;
+	mesh.submeshes = std::move(payload.submeshes);
 
-	LoadMeshImportSubmeshes(mesh, header, srcPtr);
+	char* srcPtr = payload.vertexData;
 	LoadMeshImportVertices(mesh, header, srcPtr, vertexBuffers);
 	LoadMeshImportIndices(mesh, header, srcPtr, indexBuffer);
 
@@ -369,19 +423,19 @@ uint64_t Mesh3dImporter::GetTotalFileSize(Formats::Model::V1::Header& header) {
 Mesh3dImporter::~Mesh3dImporter() {
 	GraphicsAPI::Core* graphicsCore = engineCore->GetGraphicsCore();
 
-	for (auto& asset : assets) {
-		graphicsCore->DeleteVertexArrayObject(asset.second.vertexArrayObject);
-		graphicsCore->DeleteBuffer(asset.second.positionBuffer);
-		graphicsCore->DeleteBuffer(asset.second.normalBuffer);
-		graphicsCore->DeleteBuffer(asset.second.tangentBuffer);
-		for (size_t i = 0; i < asset.second.uvBuffers.size(); ++i) {
-			if (asset.second.uvBuffers[i] != nullptr) {
-				graphicsCore->DeleteBuffer(asset.second.uvBuffers[i]);
+	for (Mesh3dAsset& asset : assets) {
+		graphicsCore->DeleteVertexArrayObject(asset.vertexArrayObject);
+		graphicsCore->DeleteBuffer(asset.positionBuffer);
+		graphicsCore->DeleteBuffer(asset.normalBuffer);
+		graphicsCore->DeleteBuffer(asset.tangentBuffer);
+		for (size_t i = 0; i < asset.uvBuffers.size(); ++i) {
+			if (asset.uvBuffers[i] != nullptr) {
+				graphicsCore->DeleteBuffer(asset.uvBuffers[i]);
 			}
 		}
-		graphicsCore->DeleteBuffer(asset.second.indexBuffer);
+		graphicsCore->DeleteBuffer(asset.indexBuffer);
 	}
-	assets.clear();
+	assets.Clear();
 }
 
 Grindstone::GraphicsAPI::VertexInputLayout Mesh3dImporter::vertexLayout;
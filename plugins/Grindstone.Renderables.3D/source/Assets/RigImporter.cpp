@@ -83,8 +83,7 @@ static bool ImportRigFile(RigAsset& rig) {
 RigImporter::~RigImporter() {}
 
 void* RigImporter::LoadAsset(Uuid uuid) {
-	auto rigIterator = assets.emplace(uuid, RigAsset(uuid, uuid.ToString()));
-	RigAsset& rigAsset = rigIterator.first->second;
+	RigAsset& rigAsset = assets.Emplace(uuid, RigAsset(uuid, uuid.ToString()));
 
 	rigAsset.assetLoadStatus = AssetLoadStatus::Loading;
 	if (!ImportRigFile(rigAsset)) {
@@ -54,8 +54,10 @@ extern "C" {
 		pluginInterface->RegisterComponent<AnimatorComponent>();
 		pluginInterface->RegisterAssetRenderer(skeletalMeshRenderer);
 		pluginInterface->RegisterAssetRenderer(mesh3dRenderer);
-		pluginInterface->RegisterSystem("Grindstone::AnimateSkeletonSystem", Grindstone::AnimateSkeletonSystem);
-		pluginInterface->RegisterEditorSystem("Grindstone::Ed::AnimateSkeletonSystem", Grindstone::AnimateSkeletonSystem);
+		// Resolves assets and creates and uploads GPU buffers, so it must run on the main thread. Poses are still evaluated on the job system.
+		const Grindstone::ECS::SystemComponentAccess animateSkeletonAccess = Grindstone::ECS::SystemComponentAccess::Exclusive();
+		pluginInterface->RegisterSystem("Grindstone::AnimateSkeletonSystem", Grindstone::AnimateSkeletonSystem, animateSkeletonAccess);
+		pluginInterface->RegisterEditorSystem("Grindstone::Ed::AnimateSkeletonSystem", Grindstone::AnimateSkeletonSystem, animateSkeletonAccess);
 	}
 
 	RENDERABLES_3D_EXPORT void ReleaseModule(Plugins::Interface* pluginInterface) {
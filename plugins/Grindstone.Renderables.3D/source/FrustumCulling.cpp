@@ -1,7 +1,22 @@
+#include <cstring>
 #include <glm/gtx/transform.hpp>
 #include <Grindstone.Renderables.3D/include/FrustumCulling.hpp>
 
+#if defined(_M_X64) || defined(__x86_64__)
+	#define GS_CULLING_HAS_X64 1
+	#include <immintrin.h>
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+		// MSVC allows AVX2 intrinsics in any function, whatever /arch is set to.
+		#define GS_CULLING_TARGET_AVX2
+	#else
+		#define GS_CULLING_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
 using namespace Grindstone;
+using CullingBoundsList = Grindstone::Renderer::CullingBoundsList;
+using BatchCullingFrustum = Grindstone::Renderer::BatchCullingFrustum;
 
 // Thanks to Bruno Opsenica https://bruop.github.io/improved_frustum_culling/
 bool Grindstone::Renderer::IsInFrustum(const CullingFrustum& frustum, const glm::mat4& viewModelMatrix, const AABB& aabb) {
@@ -129,3 +144,268 @@ Grindstone::Renderer::CullingFrustum Grindstone::Renderer::CreateFrustum(const G
 		.farDistance = -farDistance,
 	};
 }
+
+void CullingBoundsList::Reserve(size_t capacity) {
+	for (Grindstone::Memory::AllocatorCore::FrameVector<float>& component : components) {
+		component.reserve(capacity);
+	}
+}
+
+void CullingBoundsList::Add(const glm::mat4& worldMatrix, const AABB& aabb) {
+	const glm::vec3 center = worldMatrix * glm::vec4((aabb.min + aabb.max) * 0.5f, 1.0f);
+	const glm::vec3 halfSize = (aabb.max - aabb.min) * 0.5f;
+	const glm::vec3 axes[3] = {
+		glm::vec3(worldMatrix[0]) * halfSize.x,
+		glm::vec3(worldMatrix[1]) * halfSize.y,
+		glm::vec3(worldMatrix[2]) * halfSize.z
+	};
+
+	components[CenterX].push_back(center.x);
+	components[CenterY].push_back(center.y);
+	components[CenterZ].push_back(center.z);
+	for (size_t i = 0; i < 3; ++i) {
+		components[Axis0X + i * 3].push_back(axes[i].x);
+		components[Axis0Y + i * 3].push_back(axes[i].y);
+		components[Axis0Z + i * 3].push_back(axes[i].z);
+	}
+
+	++count;
+}
+
+size_t CullingBoundsList::GetVisibilityMaskWordCount() const {
+	return (count + 63) / 64;
+}
+
+// The same planes as IsInFrustum, with their normals taken from view space to world space,
+// so the boxes never need to be transformed by the view matrix.
+BatchCullingFrustum Grindstone::Renderer::CreateBatchCullingFrustum(const CullingFrustum& frustum, const glm::mat4& viewMatrix) {
+	BatchCullingFrustum batchFrustum{};
+	batchFrustum.isOrtho = frustum.isOrtho;
+
+	const float zNear = frustum.nearDistance;
+	const float zFar = frustum.farDistance;
+	const float xNear = frustum.nearRight;
+	const float yNear = frustum.nearTop;
+
+	const glm::vec3 viewNormals[BatchCullingFrustum::planeCount] = {
+		{ 0.0f, 0.0f, 1.0f },		// Near and far planes
+		{ 0.0f, -zNear, yNear },	// Top plane
+		{ 0.0f, zNear, yNear },		// Bottom plane
+		{ -zNear, 0.0f, xNear },	// Right plane
+		{ zNear, 0.0f, xNear },		// Left plane
+	};
+
+	for (size_t planeIndex = 0; planeIndex < BatchCullingFrustum::planeCount; ++planeIndex) {
+		const glm::vec3& viewNormal = viewNormals[planeIndex];
+		batchFrustum.normalX[planeIndex] = glm::dot(glm::vec3(viewMatrix[0][0], viewMatrix[0][1], viewMatrix[0][2]), viewNormal);
+		batchFrustum.normalY[planeIndex] = glm::dot(glm::vec3(viewMatrix[1][0], viewMatrix[1][1], viewMatrix[1][2]), viewNormal);
+		batchFrustum.normalZ[planeIndex] = glm::dot(glm::vec3(viewMatrix[2][0], viewMatrix[2][1], viewMatrix[2][2]), viewNormal);
+		batchFrustum.offset[planeIndex] = glm::dot(glm::vec3(viewMatrix[3][0], viewMatrix[3][1], viewMatrix[3][2]), viewNormal);
+
+		if (planeIndex == 0) {
+			batchFrustum.minDistance[planeIndex] = zFar;
+			batchFrustum.maxDistance[planeIndex] = zNear;
+			continue;
+		}
+
+		const float p = xNear * fabsf(viewNormal.x) + yNear * fabsf(viewNormal.y);
+		float tau0 = zNear * viewNormal.z - p;
+		float tau1 = zNear * viewNormal.z + p;
+
+		if (tau0 < 0.0f) {
+			tau0 *= zFar / zNear;
+		}
+		if (tau1 > 0.0f) {
+			tau1 *= zFar / zNear;
+		}
+
+		batchFrustum.minDistance[planeIndex] = tau0;
+		batchFrustum.maxDistance[planeIndex] = tau1;
+	}
+
+	return batchFrustum;
+}
+
+static void GetComponentPointers(const CullingBoundsList& bounds, const float* (&outComponents)[CullingBoundsList::ComponentCount]) {
+	for (size_t i = 0; i < CullingBoundsList::ComponentCount; ++i) {
+		outComponents[i] = bounds.components[i].data();
+	}
+}
+
+static void CullBoundsScalar(const BatchCullingFrustum& frustum, const CullingBoundsList& bounds, size_t firstBox, uint64_t* visibilityMask) {
+	const float* components[CullingBoundsList::ComponentCount];
+	GetComponentPointers(bounds, components);
+
+	for (size_t boxIndex = firstBox; boxIndex < bounds.count; ++boxIndex) {
+		bool isVisible = true;
+		for (size_t planeIndex = 0; planeIndex < BatchCullingFrustum::planeCount && isVisible; ++planeIndex) {
+			const float nx = frustum.normalX[planeIndex];
+			const float ny = frustum.normalY[planeIndex];
+			const float nz = frustum.normalZ[planeIndex];
+
+			const float distance = nx * components[CullingBoundsList::CenterX][boxIndex]
+				+ ny * components[CullingBoundsList::CenterY][boxIndex]
+				+ nz * components[CullingBoundsList::CenterZ][boxIndex]
+				+ frustum.offset[planeIndex];
+
+			float radius = 0.0f;
+			for (size_t axisIndex = 0; axisIndex < 3; ++axisIndex) {
+				const size_t axisComponent = CullingBoundsList::Axis0X + axisIndex * 3;
+				radius += fabsf(
+					nx * components[axisComponent][boxIndex]
+					+ ny * components[axisComponent + 1][boxIndex]
+					+ nz * components[axisComponent + 2][boxIndex]
+				);
+			}
+
+			isVisible = !(distance - radius > frustum.maxDistance[planeIndex] || distance + radius < frustum.minDistance[planeIndex]);
+		}
+
+		if (isVisible) {
+			visibilityMask[boxIndex / 64] |= uint64_t(1) << (boxIndex % 64);
+		}
+	}
+}
+
+#ifdef GS_CULLING_HAS_X64
+// Returns the index of the first box it didn't cull, so the rest can be culled by a narrower path.
+static size_t CullBoundsSse(const BatchCullingFrustum& frustum, const CullingBoundsList& bounds, uint64_t* visibilityMask) {
+	const float* components[CullingBoundsList::ComponentCount];
+	GetComponentPointers(bounds, components);
+
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	size_t boxIndex = 0;
+	for (; boxIndex + 4 <= bounds.count; boxIndex += 4) {
+		__m128 isVisible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (size_t planeIndex = 0; planeIndex < BatchCullingFrustum::planeCount; ++planeIndex) {
+			const __m128 nx = _mm_set1_ps(frustum.normalX[planeIndex]);
+			const __m128 ny = _mm_set1_ps(frustum.normalY[planeIndex]);
+			const __m128 nz = _mm_set1_ps(frustum.normalZ[planeIndex]);
+
+			__m128 distance = _mm_mul_ps(nx, _mm_loadu_ps(components[CullingBoundsList::CenterX] + boxIndex));
+			distance = _mm_add_ps(distance, _mm_mul_ps(ny, _mm_loadu_ps(components[CullingBoundsList::CenterY] + boxIndex)));
+			distance = _mm_add_ps(distance, _mm_mul_ps(nz, _mm_loadu_ps(components[CullingBoundsList::CenterZ] + boxIndex)));
+			distance = _mm_add_ps(distance, _mm_set1_ps(frustum.offset[planeIndex]));
+
+			__m128 radius = _mm_setzero_ps();
+			for (size_t axisIndex = 0; axisIndex < 3; ++axisIndex) {
+				const size_t axisComponent = CullingBoundsList::Axis0X + axisIndex * 3;
+				__m128 axisDistance = _mm_mul_ps(nx, _mm_loadu_ps(components[axisComponent] + boxIndex));
+				axisDistance = _mm_add_ps(axisDistance, _mm_mul_ps(ny, _mm_loadu_ps(components[axisComponent + 1] + boxIndex)));
+				axisDistance = _mm_add_ps(axisDistance, _mm_mul_ps(nz, _mm_loadu_ps(components[axisComponent + 2] + boxIndex)));
+				radius = _mm_add_ps(radius, _mm_and_ps(axisDistance, absMask));
+			}
+
+			const __m128 isAbove = _mm_cmpgt_ps(_mm_sub_ps(distance, radius), _mm_set1_ps(frustum.maxDistance[planeIndex]));
+			const __m128 isBelow = _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_set1_ps(frustum.minDistance[planeIndex]));
+			isVisible = _mm_andnot_ps(_mm_or_ps(isAbove, isBelow), isVisible);
+		}
+
+		const uint64_t laneMask = static_cast<uint64_t>(_mm_movemask_ps(isVisible));
+		visibilityMask[boxIndex / 64] |= laneMask << (boxIndex % 64);
+	}
+
+	return boxIndex;
+}
+
+GS_CULLING_TARGET_AVX2
+static size_t CullBoundsAvx2(const BatchCullingFrustum& frustum, const CullingBoundsList& bounds, uint64_t* visibilityMask) {
+	const float* components[CullingBoundsList::ComponentCount];
+	GetComponentPointers(bounds, components);
+
+	const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	size_t boxIndex = 0;
+	for (; boxIndex + 8 <= bounds.count; boxIndex += 8) {
+		__m256 isVisible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (size_t planeIndex = 0; planeIndex < BatchCullingFrustum::planeCount; ++planeIndex) {
+			const __m256 nx = _mm256_set1_ps(frustum.normalX[planeIndex]);
+			const __m256 ny = _mm256_set1_ps(frustum.normalY[planeIndex]);
+			const __m256 nz = _mm256_set1_ps(frustum.normalZ[planeIndex]);
+
+			__m256 distance = _mm256_mul_ps(nx, _mm256_loadu_ps(components[CullingBoundsList::CenterX] + boxIndex));
+			distance = _mm256_add_ps(distance, _mm256_mul_ps(ny, _mm256_loadu_ps(components[CullingBoundsList::CenterY] + boxIndex)));
+			distance = _mm256_add_ps(distance, _mm256_mul_ps(nz, _mm256_loadu_ps(components[CullingBoundsList::CenterZ] + boxIndex)));
+			distance = _mm256_add_ps(distance, _mm256_set1_ps(frustum.offset[planeIndex]));
+
+			__m256 radius = _mm256_setzero_ps();
+			for (size_t axisIndex = 0; axisIndex < 3; ++axisIndex) {
+				const size_t axisComponent = CullingBoundsList::Axis0X + axisIndex * 3;
+				__m256 axisDistance = _mm256_mul_ps(nx, _mm256_loadu_ps(components[axisComponent] + boxIndex));
+				axisDistance = _mm256_add_ps(axisDistance, _mm256_mul_ps(ny, _mm256_loadu_ps(components[axisComponent + 1] + boxIndex)));
+				axisDistance = _mm256_add_ps(axisDistance, _mm256_mul_ps(nz, _mm256_loadu_ps(components[axisComponent + 2] + boxIndex)));
+				radius = _mm256_add_ps(radius, _mm256_and_ps(axisDistance, absMask));
+			}
+
+			const __m256 isAbove = _mm256_cmp_ps(_mm256_sub_ps(distance, radius), _mm256_set1_ps(frustum.maxDistance[planeIndex]), _CMP_GT_OQ);
+			const __m256 isBelow = _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_set1_ps(frustum.minDistance[planeIndex]), _CMP_LT_OQ);
+			isVisible = _mm256_andnot_ps(_mm256_or_ps(isAbove, isBelow), isVisible);
+		}
+
+		const uint64_t laneMask = static_cast<uint64_t>(_mm256_movemask_ps(isVisible));
+		visibilityMask[boxIndex / 64] |= laneMask << (boxIndex % 64);
+	}
+
+	return boxIndex;
+}
+
+static bool IsAvx2Supported() {
+#if defined(_MSC_VER) && !defined(__clang__)
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	if (cpuInfo[0] < 7) {
+		return false;
+	}
+
+	// The OS must also save the AVX registers on context switches.
+	__cpuid(cpuInfo, 1);
+	const bool hasOsxsave = (cpuInfo[2] & (1 << 27)) != 0;
+	const bool hasAvx = (cpuInfo[2] & (1 << 28)) != 0;
+	if (!hasOsxsave || !hasAvx || (_xgetbv(0) & 0x6) != 0x6) {
+		return false;
+	}
+
+	__cpuidex(cpuInfo, 7, 0);
+	return (cpuInfo[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+void Grindstone::Renderer::CullBounds(
+	const BatchCullingFrustum& frustum,
+	const CullingBoundsList& bounds,
+	uint64_t* visibilityMask,
+	CullingInstructionSet instructionSet
+) {
+	const size_t maskWordCount = bounds.GetVisibilityMaskWordCount();
+
+	// TODO: Fix this along with IsInFrustum
+	if (frustum.isOrtho) {
+		memset(visibilityMask, 0xFF, maskWordCount * sizeof(uint64_t));
+		return;
+	}
+
+	memset(visibilityMask, 0, maskWordCount * sizeof(uint64_t));
+
+#ifdef GS_CULLING_HAS_X64
+	static const bool isAvx2Supported = IsAvx2Supported();
+	if (instructionSet == CullingInstructionSet::Best) {
+		instructionSet = isAvx2Supported
+			? CullingInstructionSet::Avx2
+			: CullingInstructionSet::Sse;
+	}
+
+	size_t culledCount = 0;
+	if (instructionSet == CullingInstructionSet::Avx2 && isAvx2Supported) {
+		culledCount = CullBoundsAvx2(frustum, bounds, visibilityMask);
+	}
+	else if (instructionSet != CullingInstructionSet::Scalar) {
+		culledCount = CullBoundsSse(frustum, bounds, visibilityMask);
+	}
+
+	CullBoundsScalar(frustum, bounds, culledCount, visibilityMask);
+#else
+	CullBoundsScalar(frustum, bounds, 0, visibilityMask);
+#endif
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <string>
+
+#include <Common/Graphics/Core.hpp>
+#include <Common/Graphics/WindowGraphicsBinding.hpp>
+#include <Common/Window/WindowManager.hpp>
+#include <EngineCore/EngineCore.hpp>
+
+#include <Grindstone.Renderables.3D/include/InstanceBufferPool.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Renderer;
+
+InstanceBufferPool::InstanceBufferPool(const char* debugName) : debugName(debugName) {}
+
+InstanceBufferPool::~InstanceBufferPool() {
+	GraphicsAPI::Core* graphicsCore = EngineCore::GetInstance().GetGraphicsCore();
+	if (graphicsCore == nullptr) {
+		return;
+	}
+
+	for (FrameBuffer& frame : frames) {
+		if (frame.buffer != nullptr) {
+			graphicsCore->DeleteDescriptorSet(frame.descriptorSet);
+			graphicsCore->DeleteBuffer(frame.buffer);
+		}
+	}
+}
+
+GraphicsAPI::DescriptorSetLayout* InstanceBufferPool::GetDescriptorSetLayout() {
+	GraphicsAPI::DescriptorSetLayout::Binding instanceBufferBinding{};
+	instanceBufferBinding.bindingId = 0;
+	instanceBufferBinding.type = GraphicsAPI::BindingType::StorageBuffer;
+	instanceBufferBinding.count = 1;
+	instanceBufferBinding.stages = GraphicsAPI::ShaderStageBit::Vertex;
+
+	GraphicsAPI::DescriptorSetLayout::CreateInfo descriptorSetLayoutCreateInfo{};
+	descriptorSetLayoutCreateInfo.debugName = "Instance Buffer Descriptor Set Layout";
+	descriptorSetLayoutCreateInfo.bindingCount = 1;
+	descriptorSetLayoutCreateInfo.bindings = &instanceBufferBinding;
+
+	GraphicsAPI::Core* graphicsCore = EngineCore::GetInstance().GetGraphicsCore();
+	return graphicsCore->GetOrCreateDescriptorSetLayoutFromCache(descriptorSetLayoutCreateInfo);
+}
+
+InstanceBufferPool::Range InstanceBufferPool::Allocate(uint32_t instanceCount) {
+	GraphicsAPI::WindowGraphicsBinding* windowGraphicsBinding = EngineCore::GetInstance().windowManager->GetWindowByIndex(0)->GetWindowGraphicsBinding();
+	if (frames.empty()) {
+		frames.resize(std::max(windowGraphicsBinding->GetMaxFramesInFlight(), 1u));
+	}
+
+	FrameBuffer& frame = frames[windowGraphicsBinding->GetCurrentImageIndex() % frames.size()];
+
+	// The frame's fence has been waited on since its buffer was last used, so it's free again.
+	// This is tied to the swapchain rather than the frame allocator, as the editor renders even when
+	// nothing else about the frame advances.
+	const uint64_t frameNumber = windowGraphicsBinding->GetCurrentFrame();
+	if (frame.frameNumber != frameNumber) {
+		frame.frameNumber = frameNumber;
+		frame.usedInstanceCount = 0;
+	}
+
+	if (frame.usedInstanceCount + instanceCount > frame.capacity) {
+		// Draws recorded earlier this frame still read the old buffer, so it's only deleted once they're done.
+		if (frame.buffer != nullptr) {
+			EngineCore& engineCore = EngineCore::GetInstance();
+			GraphicsAPI::Core* graphicsCore = engineCore.GetGraphicsCore();
+			GraphicsAPI::Buffer* oldBuffer = frame.buffer;
+			GraphicsAPI::DescriptorSet* oldDescriptorSet = frame.descriptorSet;
+			engineCore.PushDeletion([graphicsCore, oldBuffer, oldDescriptorSet]() {
+				graphicsCore->DeleteDescriptorSet(oldDescriptorSet);
+				graphicsCore->DeleteBuffer(oldBuffer);
+			});
+		}
+
+		const uint32_t capacity = std::max({ frame.capacity * 2, instanceCount, initialInstanceCapacity });
+		CreateFrameBuffer(frame, capacity);
+	}
+
+	Range range{ frame.buffer, frame.descriptorSet, frame.usedInstanceCount };
+	frame.usedInstanceCount += instanceCount;
+	return range;
+}
+
+void InstanceBufferPool::CreateFrameBuffer(FrameBuffer& frame, uint32_t capacity) {
+	GraphicsAPI::Core* graphicsCore = EngineCore::GetInstance().GetGraphicsCore();
+
+	{
+		std::string bufferDebugName = std::string(debugName) + " Instance Buffer";
+		GraphicsAPI::Buffer::CreateInfo bufferCreateInfo{};
+		bufferCreateInfo.debugName = bufferDebugName.c_str();
+		bufferCreateInfo.bufferUsage =
+			GraphicsAPI::BufferUsage::TransferDst |
+			GraphicsAPI::BufferUsage::Storage;
+		bufferCreateInfo.memoryUsage = GraphicsAPI::MemoryUsage::CPUToGPU;
+		bufferCreateInfo.bufferSize = sizeof(RenderInstanceData) * capacity;
+		frame.buffer = graphicsCore->CreateBuffer(bufferCreateInfo);
+	}
+
+	{
+		GraphicsAPI::DescriptorSet::Binding instanceBufferBinding = GraphicsAPI::DescriptorSet::Binding::StorageBuffer(frame.buffer);
+
+		std::string descriptorSetDebugName = std::string(debugName) + " Instance Descriptor Set";
+		GraphicsAPI::DescriptorSet::CreateInfo descriptorSetCreateInfo{};
+		descriptorSetCreateInfo.debugName = descriptorSetDebugName.c_str();
+		descriptorSetCreateInfo.bindingCount = 1;
+		descriptorSetCreateInfo.bindings = &instanceBufferBinding;
+		descriptorSetCreateInfo.layout = GetDescriptorSetLayout();
+		frame.descriptorSet = graphicsCore->CreateDescriptorSet(descriptorSetCreateInfo);
+	}
+
+	frame.capacity = capacity;
+	frame.usedInstanceCount = 0;
+}
@@ -29,17 +29,19 @@ struct RenderTask {
 	uint32_t indexCount;
 	uint32_t baseVertex;
 	uint32_t baseIndex;
-	glm::mat4 transformMatrix;
-	uint32_t sortData;
+	bool isInstancingEnabled;
+	Grindstone::Renderer::RenderableBufferPair instanceData;
+	uint64_t sortData;
 };
 
 static void AppendStaticSubmeshRenderTask(
-	std::vector<RenderTask>& renderTasks,
+	Grindstone::Renderer::RenderTaskList<RenderTask>& renderTasks,
 	const Grindstone::HashedString renderQueueHash,
 	const Mesh3dAsset::Submesh& submesh,
 	const Mesh3dAsset* meshAsset,
 	const MeshComponent& meshComponent,
-	const MeshRendererComponent& meshRenderComponent
+	const MeshRendererComponent& meshRenderComponent,
+	const Grindstone::Renderer::RenderableBufferPair& instanceData
 ) {
 	if (submesh.materialIndex >= meshRenderComponent.materials.size()) {
 		return;
@@ -56,12 +58,15 @@ static void AppendStaticSubmeshRenderTask(
 		return;
 	}
 
-	const GraphicsAPI::GraphicsPipeline* pipeline = graphicsPipelineAsset->GetPassPipelineByRenderQueue(renderQueueHash, &meshAsset->vertexArrayObject->GetLayout());
-	if (pipeline == nullptr) {
+	const GraphicsPipelineAsset::Pass* pass = graphicsPipelineAsset->GetPassByRenderQueue(renderQueueHash);
+	if (pass == nullptr) {
 		return;
 	}
 
-	uint32_t sortData = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(pipeline));
+	const GraphicsAPI::GraphicsPipeline* pipeline = graphicsPipelineAsset->GetPassPipeline(*pass, &meshAsset->vertexArrayObject->GetLayout());
+	if (pipeline == nullptr) {
+		return;
+	}
 
 	RenderTask renderTask{
 		.materialDescriptorSet = materialAsset->materialDescriptorSet,
@@ -71,13 +76,15 @@ static void AppendStaticSubmeshRenderTask(
 		.indexCount = submesh.indexCount,
 		.baseVertex = submesh.baseVertex,
 		.baseIndex = submesh.baseIndex,
-		.sortData = sortData
+		.isInstancingEnabled = pass->isInstancingEnabled,
+		.instanceData = instanceData,
+		.sortData = Grindstone::Renderer::MakeRenderSortData(pipeline, materialAsset->materialDescriptorSet, meshAsset->vertexArrayObject, submesh.baseIndex)
 	};
 
 	renderTasks.emplace_back(renderTask);
 }
 
-Grindstone::Mesh3dRenderer::Mesh3dRenderer(EngineCore* engineCore) {
+Grindstone::Mesh3dRenderer::Mesh3dRenderer(EngineCore* engineCore) : instanceBufferPool("Mesh3d") {
 	this->engineCore = engineCore;
 
 	GraphicsAPI::DescriptorSetLayout::Binding descriptorSetUniformBinding{};
@@ -115,7 +122,7 @@ Grindstone::Rendering::GeometryRenderStats Mesh3dRenderer::RenderQueue(
 
 	std::chrono::time_point start = std::chrono::steady_clock::now();
 
-	std::vector<RenderTask> renderTasks = Grindstone::Renderer::GenerateTaskList<MeshComponent, RenderTask>(
+	Grindstone::Renderer::RenderTaskList<RenderTask> renderTasks = Grindstone::Renderer::GenerateTaskList<MeshComponent, RenderTask>(
 		renderingStats,
 		registry,
 		frustum,
@@ -124,7 +131,7 @@ Grindstone::Rendering::GeometryRenderStats Mesh3dRenderer::RenderQueue(
 		AppendStaticSubmeshRenderTask
 	);
 	Grindstone::Renderer::SortRenderTasks<RenderTask>(renderTasks);
-	Grindstone::Renderer::RenderAllTasks<RenderTask>(renderingStats, engineDescriptorSet, commandBuffer, renderTasks);
+	Grindstone::Renderer::RenderAllTasks<RenderTask>(renderingStats, engineDescriptorSet, commandBuffer, renderTasks, instanceBufferPool);
 
 	std::chrono::time_point end = std::chrono::steady_clock::now();
 	long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+#include <glm/glm.hpp>
+
+// Mirrors GsLightClusters in lightClusters.gpset and the culling loop in lightCulling.gpset,
+// so the cluster layout and light assignment can be checked without a GPU.
+namespace Grindstone::Renderer::LightClusters {
+	// Must match lightClusterGridSize and maxLightsPerCluster in lightClusters.gpset.
+	constexpr uint32_t gridSizeX = 16;
+	constexpr uint32_t gridSizeY = 9;
+	constexpr uint32_t gridSizeZ = 24;
+	constexpr uint32_t clusterCount = gridSizeX * gridSizeY * gridSizeZ;
+	// Lights past this are dropped from a cluster, point lights being assigned before spot lights.
+	constexpr uint32_t maxLightsPerCluster = 512;
+
+	struct Cluster {
+		uint32_t x;
+		uint32_t y;
+		uint32_t z;
+	};
+
+	struct ClusterBounds {
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	// The light counts written to a cluster's entry in lightClusterGrid.
+	struct ClusterLightCounts {
+		uint32_t pointLightCount = 0;
+		uint32_t spotLightCount = 0;
+	};
+
+	// A light's view-space position and attenuation radius.
+	struct LightSphere {
+		glm::vec3 viewPosition;
+		float radius;
+	};
+
+	// Slices are distributed exponentially, so distant slices are as thick as they are wide on screen.
+	inline float GetSliceDistance(float nearDistance, float farDistance, uint32_t slice) {
+		return nearDistance * std::pow(farDistance / nearDistance, float(slice) / float(gridSizeZ));
+	}
+
+	inline Cluster GetCluster(float u, float v, float viewDistance, float nearDistance, float farDistance) {
+		const float slice =
+			std::log(std::max(viewDistance, nearDistance) / nearDistance) *
+			float(gridSizeZ) / std::log(farDistance / nearDistance);
+
+		return Cluster{
+			std::min(uint32_t(std::clamp(u, 0.0f, 1.0f) * float(gridSizeX)), gridSizeX - 1),
+			std::min(uint32_t(std::clamp(v, 0.0f, 1.0f) * float(gridSizeY)), gridSizeY - 1),
+			std::min(uint32_t(slice), gridSizeZ - 1)
+		};
+	}
+
+	inline uint32_t GetClusterIndex(Cluster cluster) {
+		return cluster.x + gridSizeX * (cluster.y + gridSizeY * cluster.z);
+	}
+
+	/*
+	 * The view-space box around a cluster of a symmetric perspective projection, where tanHalfFovX and
+	 * tanHalfFovY are the view ray's slopes at the edges of the screen. Like the shaders, y follows NDC, and
+	 * the view looks down negative z.
+	 */
+	inline ClusterBounds GetClusterBounds(Cluster cluster, float tanHalfFovX, float tanHalfFovY, float nearDistance, float farDistance) {
+		// The first slice reaches the eye, so lights in front of the near plane still touch it.
+		const float sliceNear = (cluster.z == 0) ? 0.0f : GetSliceDistance(nearDistance, farDistance, cluster.z);
+		const float sliceFar = GetSliceDistance(nearDistance, farDistance, cluster.z + 1);
+
+		ClusterBounds bounds{ glm::vec3(1e30f, 1e30f, 1e30f), glm::vec3(-1e30f, -1e30f, -1e30f) };
+		for (uint32_t corner = 0; corner < 4; ++corner) {
+			const float u = float(cluster.x + (corner & 1)) / float(gridSizeX);
+			const float v = float(cluster.y + (corner >> 1)) / float(gridSizeY);
+			const glm::vec3 viewRay((u * 2.0f - 1.0f) * tanHalfFovX, (v * 2.0f - 1.0f) * tanHalfFovY, -1.0f);
+
+			for (const glm::vec3 point : { viewRay * sliceNear, viewRay * sliceFar }) {
+				for (int axis = 0; axis < 3; ++axis) {
+					bounds.min[axis] = std::min(bounds.min[axis], point[axis]);
+					bounds.max[axis] = std::max(bounds.max[axis], point[axis]);
+				}
+			}
+		}
+
+		return bounds;
+	}
+
+	inline bool DoesSphereIntersectBounds(const LightSphere& light, const ClusterBounds& bounds) {
+		float distanceSquared = 0.0f;
+		for (int axis = 0; axis < 3; ++axis) {
+			const float closest = std::clamp(light.viewPosition[axis], bounds.min[axis], bounds.max[axis]);
+			const float offset = closest - light.viewPosition[axis];
+			distanceSquared += offset * offset;
+		}
+
+		return distanceSquared <= light.radius * light.radius;
+	}
+
+	// Writes the indices of the lights touching a cluster into its maxLightsPerCluster entries of lightIndices.
+	template<typename PointLightContainer, typename SpotLightContainer>
+	ClusterLightCounts AssignLights(
+		const ClusterBounds& bounds,
+		const PointLightContainer& pointLights,
+		const SpotLightContainer& spotLights,
+		uint32_t* lightIndices
+	) {
+		uint32_t lightCount = 0;
+		for (uint32_t i = 0; i < uint32_t(pointLights.size()) && lightCount < maxLightsPerCluster; ++i) {
+			if (DoesSphereIntersectBounds(pointLights[i], bounds)) {
+				lightIndices[lightCount++] = i;
+			}
+		}
+
+		const uint32_t pointLightCount = lightCount;
+		for (uint32_t j = 0; j < uint32_t(spotLights.size()) && lightCount < maxLightsPerCluster; ++j) {
+			if (DoesSphereIntersectBounds(spotLights[j], bounds)) {
+				lightIndices[lightCount++] = j;
+			}
+		}
+
+		return ClusterLightCounts{ pointLightCount, lightCount - pointLightCount };
+	}
+}
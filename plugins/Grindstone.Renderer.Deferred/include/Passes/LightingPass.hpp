@@ -1,8 +1,15 @@
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include <Common/Rendering/RenderGraphBuilder.hpp>
+#include <Common/Rendering/GeometryRenderingStats.hpp>
 #include <EngineCore/Assets/AssetReference.hpp>
+#include <EngineCore/Assets/PipelineSet/ComputePipelineAsset.hpp>
 #include <EngineCore/Assets/PipelineSet/GraphicsPipelineAsset.hpp>
+#include <EngineCore/CoreComponents/Lights/PointLightComponent.hpp>
+#include <EngineCore/CoreComponents/Lights/SpotLightComponent.hpp>
 
 #include "GbufferPass.hpp"
 
@@ -11,8 +18,14 @@ namespace Grindstone::Renderer {
 		RenderGraphBuilderResourceRef lightingOutputRef;
 	};
 
+	/*
+	 * Shades the gbuffer. Point and spot lights are packed into storage buffers and assigned to a grid of
+	 * view-space clusters by a compute pass, so a single full-screen pass shades each pixel with only the
+	 * lights in its cluster. Directional lights affect every pixel, so they're still drawn one at a time.
+	 */
 	class LightingPass {
 	public:
+		~LightingPass();
 		bool Initialize();
 		LightingPassReturnData AddPass(
 			GraphicsAPI::Buffer* vertexBuffer,
@@ -20,13 +33,30 @@ namespace Grindstone::Renderer {
 			Grindstone::Renderer::RenderGraphBuilder& renderGraph,
 			Grindstone::Renderer::GbufferData& gbufferData,
 			RenderGraphBuilderResourceRef shadowAtlasRef,
-			RenderGraphBuilderResourceRef ambientOcclusionRef
+			RenderGraphBuilderResourceRef ambientOcclusionRef,
+			std::function<void(const Grindstone::Rendering::GeometryRenderStats&)> pushRenderingStatsCallback
 		);
 
 	private:
+		// The point and spot lights of a frame in flight, bound as set 2 of the culling and lighting pipelines.
+		struct ClusteredLightFrame {
+			Grindstone::GraphicsAPI::Buffer* constantsBuffer = nullptr;
+			Grindstone::GraphicsAPI::Buffer* pointLightBuffer = nullptr;
+			Grindstone::GraphicsAPI::Buffer* spotLightBuffer = nullptr;
+			Grindstone::GraphicsAPI::DescriptorSet* descriptorSet = nullptr;
+			uint32_t pointLightCapacity = 0;
+			uint32_t spotLightCapacity = 0;
+			uint32_t pointLightCount = 0;
+			uint32_t spotLightCount = 0;
+			double packingTimeMs = 0.0;
+		};
+
+		ClusteredLightFrame& GetClusteredLightFrame();
+		void PackClusteredLights(entt::registry& registry, ClusteredLightFrame& frame);
+
 		Grindstone::AssetReference<Grindstone::GraphicsPipelineAsset> imageBasedLightingPipelineSet;
-		Grindstone::AssetReference<Grindstone::GraphicsPipelineAsset> spotLightPipelineSet;
-		Grindstone::AssetReference<Grindstone::GraphicsPipelineAsset> pointLightPipelineSet;
+		Grindstone::AssetReference<Grindstone::GraphicsPipelineAsset> clusteredLightingPipelineSet;
+		Grindstone::AssetReference<Grindstone::ComputePipelineAsset> lightCullingPipelineSet;
 		Grindstone::AssetReference<Grindstone::GraphicsPipelineAsset> directionalLightPipelineSet;
 		Grindstone::AssetReference<Grindstone::TextureAsset> brdfLut;
 
@@ -34,5 +64,10 @@ namespace Grindstone::Renderer {
 		Grindstone::GraphicsAPI::DescriptorSetLayout* ambientOcclusionDescriptorSetLayout = nullptr;
 		Grindstone::GraphicsAPI::DescriptorSet* ambientOcclusionDescriptorSet = nullptr;
 		Grindstone::GraphicsAPI::Sampler* screenSampler = nullptr;
+
+		Grindstone::GraphicsAPI::DescriptorSetLayout* clusteredLightDescriptorSetLayout = nullptr;
+		std::vector<ClusteredLightFrame> clusteredLightFrames;
+		std::vector<PointLightComponent::UniformStruct> packedPointLights;
+		std::vector<SpotLightComponent::UniformStruct> packedSpotLights;
 	};
 }
@@ -166,7 +166,7 @@ void DeferredRenderer::Render(
 	Grindstone::Renderer::RenderGraphBuilderResourceRef ssaoOutput = ssao.AddPass(vertexBuffer, indexBuffer, renderGraphBuilder, gbufferData);
 	// TODO: Move this into the ssao pass, maybe? Specify a Two-Pass Separable Blur
 	Grindstone::Renderer::RenderGraphBuilderResourceRef ssaoBlurredOutput = blur.AddPass(renderGraphBuilder, ssaoBlurMetaRect, attachmentAmbientOcclusionBlur, ssaoOutput);
-	Grindstone::Renderer::LightingPassReturnData lightingData = lighting.AddPass(vertexBuffer, indexBuffer, renderGraphBuilder, gbufferData, shadowOutput.shadowOutputRef, ssaoBlurredOutput);
+	Grindstone::Renderer::LightingPassReturnData lightingData = lighting.AddPass(vertexBuffer, indexBuffer, renderGraphBuilder, gbufferData, shadowOutput.shadowOutputRef, ssaoBlurredOutput, [this](auto& a) { PushRenderingStats(a); });
 	Grindstone::Renderer::RenderGraphBuilderResourceRef ssrOutput = ssr.AddPass(renderGraphBuilder, lightingData.lightingOutputRef, ssaoBlurredOutput, gbufferData);
 	// auto dofOutput = dof.AddPass(renderGraph, ssrOutput);
 
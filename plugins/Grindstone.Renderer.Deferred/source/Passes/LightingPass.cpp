@@ -1,17 +1,60 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+
 #include <EngineCore/Assets/AssetManager.hpp>
 #include <EngineCore/Assets/PipelineSet/GraphicsPipelineAsset.hpp>
 #include <EngineCore/WorldContext/WorldContextSet.hpp>
 #include <EngineCore/Scenes/Manager.hpp>
 
 #include <Grindstone.Renderer.Deferred/include/Passes/LightingPass.hpp>
+#include <Grindstone.Renderer.Deferred/include/Passes/LightClusters.hpp>
 #include <Grindstone.Renderer.Deferred/include/DeferredRendererCommon.hpp>
 #include <EngineCore/CoreComponents/Transform/TransformComponent.hpp>
 #include <EngineCore/CoreComponents/EnvironmentMap/EnvironmentMapComponent.hpp>
 #include <EngineCore/CoreComponents/Lights/DirectionalLightComponent.hpp>
 #include <EngineCore/CoreComponents/Lights/PointLightComponent.hpp>
 #include <EngineCore/CoreComponents/Lights/SpotLightComponent.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
 
 using namespace Grindstone;
+using namespace Grindstone::Memory;
+
+static constexpr uint32_t minimumLightCapacity = 16;
+
+static_assert(sizeof(PointLightComponent::UniformStruct) == 512, "PointLightComponent::UniformStruct must match the stride of PointLight in lightClusters.gpset.");
+static_assert(sizeof(SpotLightComponent::UniformStruct) == 128, "SpotLightComponent::UniformStruct must match the stride of SpotLight in lightClusters.gpset.");
+
+struct LightClusterConstants {
+	uint32_t pointLightCount;
+	uint32_t spotLightCount;
+	uint32_t padding[2];
+};
+
+struct LightClusterData {
+	Renderer::RenderGraphBuilderResourceRef clusterGridRef;
+	Renderer::RenderGraphBuilderResourceRef clusterIndicesRef;
+};
+
+static GraphicsAPI::Buffer* CreateLightStorageBuffer(GraphicsAPI::Core* graphicsCore, const char* debugName, size_t size) {
+	GraphicsAPI::Buffer::CreateInfo bufferCreateInfo{};
+	bufferCreateInfo.debugName = debugName;
+	bufferCreateInfo.bufferUsage =
+		GraphicsAPI::BufferUsage::TransferDst |
+		GraphicsAPI::BufferUsage::Storage;
+	bufferCreateInfo.memoryUsage = GraphicsAPI::MemoryUsage::CPUToGPU;
+	bufferCreateInfo.bufferSize = size;
+	return graphicsCore->CreateBuffer(bufferCreateInfo);
+}
+
+static uint32_t GrowLightCapacity(uint32_t capacity, uint32_t lightCount) {
+	capacity = std::max(capacity, minimumLightCapacity);
+	while (capacity < lightCount) {
+		capacity *= 2;
+	}
+
+	return capacity;
+}
 
 static void PerformImageBasedLighting(
 	entt::registry& registry,
@@ -40,8 +83,8 @@ bool Renderer::LightingPass::Initialize() {
 
 	{
 		imageBasedLightingPipelineSet = assetManager->GetAssetReferenceByAddress<GraphicsPipelineAsset>("@CORESHADERS/lighting/ambientIbl");
-		pointLightPipelineSet = assetManager->GetAssetReferenceByAddress<GraphicsPipelineAsset>("@CORESHADERS/lighting/point");
-		spotLightPipelineSet = assetManager->GetAssetReferenceByAddress<GraphicsPipelineAsset>("@CORESHADERS/lighting/spot");
+		clusteredLightingPipelineSet = assetManager->GetAssetReferenceByAddress<GraphicsPipelineAsset>("@CORESHADERS/lighting/clustered");
+		lightCullingPipelineSet = assetManager->GetAssetReferenceByAddress<ComputePipelineAsset>("@CORESHADERS/lighting/clusterCulling");
 		directionalLightPipelineSet = assetManager->GetAssetReferenceByAddress<GraphicsPipelineAsset>("@CORESHADERS/lighting/directional");
 		brdfLut = assetManager->GetAssetReferenceByAddress<TextureAsset>("@CORESHADERS/textures/ibl_brdf_lut");
 	}
@@ -90,21 +133,269 @@ bool Renderer::LightingPass::Initialize() {
 		ambientOcclusionDescriptorSet = graphicsCore->CreateDescriptorSet(aoInputCreateInfo);
 	}
 
+	{
+		const GraphicsAPI::ShaderStageBit clusteredLightStages = GraphicsAPI::ShaderStageBit::Compute | GraphicsAPI::ShaderStageBit::Fragment;
+		std::array<GraphicsAPI::DescriptorSetLayout::Binding, 3> clusteredLightLayoutBindings{
+			GraphicsAPI::DescriptorSetLayout::Binding{
+				.bindingId = 0,
+				.count = 1,
+				.type = GraphicsAPI::BindingType::UniformBuffer,
+				.stages = clusteredLightStages
+			},
+			GraphicsAPI::DescriptorSetLayout::Binding{
+				.bindingId = 1,
+				.count = 1,
+				.type = GraphicsAPI::BindingType::StorageBuffer,
+				.stages = clusteredLightStages
+			},
+			GraphicsAPI::DescriptorSetLayout::Binding{
+				.bindingId = 2,
+				.count = 1,
+				.type = GraphicsAPI::BindingType::StorageBuffer,
+				.stages = clusteredLightStages
+			}
+		};
+
+		GraphicsAPI::DescriptorSetLayout::CreateInfo clusteredLightLayoutCreateInfo{};
+		clusteredLightLayoutCreateInfo.debugName = "Clustered Light Descriptor Set Layout";
+		clusteredLightLayoutCreateInfo.bindingCount = static_cast<uint32_t>(clusteredLightLayoutBindings.size());
+		clusteredLightLayoutCreateInfo.bindings = clusteredLightLayoutBindings.data();
+		clusteredLightDescriptorSetLayout = graphicsCore->CreateDescriptorSetLayout(clusteredLightLayoutCreateInfo);
+	}
+
 	return true;
 }
 
+Renderer::LightingPass::~LightingPass() {
+	GraphicsAPI::Core* graphicsCore = EngineCore::GetInstance().GetGraphicsCore();
+	if (graphicsCore == nullptr) {
+		return;
+	}
+
+	for (ClusteredLightFrame& frame : clusteredLightFrames) {
+		graphicsCore->DeleteDescriptorSet(frame.descriptorSet);
+		graphicsCore->DeleteBuffer(frame.constantsBuffer);
+		graphicsCore->DeleteBuffer(frame.pointLightBuffer);
+		graphicsCore->DeleteBuffer(frame.spotLightBuffer);
+	}
+}
+
+Renderer::LightingPass::ClusteredLightFrame& Renderer::LightingPass::GetClusteredLightFrame() {
+	if (clusteredLightFrames.empty()) {
+		clusteredLightFrames.resize(std::max(AllocatorCore::GetFrameCount(), 1u));
+	}
+
+	// The frame's fence was waited on before it came around again, so its buffers are free to be rewritten.
+	ClusteredLightFrame& frame = clusteredLightFrames[AllocatorCore::GetCurrentFrameIndex() % clusteredLightFrames.size()];
+	if (frame.descriptorSet != nullptr) {
+		return frame;
+	}
+
+	GraphicsAPI::Core* graphicsCore = EngineCore::GetInstance().GetGraphicsCore();
+
+	{
+		GraphicsAPI::Buffer::CreateInfo constantsBufferCreateInfo{};
+		constantsBufferCreateInfo.debugName = "Light Cluster Constants";
+		constantsBufferCreateInfo.bufferUsage = GraphicsAPI::BufferUsage::Uniform;
+		constantsBufferCreateInfo.memoryUsage = GraphicsAPI::MemoryUsage::CPUToGPU;
+		constantsBufferCreateInfo.bufferSize = sizeof(LightClusterConstants);
+		frame.constantsBuffer = graphicsCore->CreateBuffer(constantsBufferCreateInfo);
+	}
+
+	frame.pointLightCapacity = minimumLightCapacity;
+	frame.spotLightCapacity = minimumLightCapacity;
+	frame.pointLightBuffer = CreateLightStorageBuffer(graphicsCore, "Point Light Buffer", sizeof(PointLightComponent::UniformStruct) * frame.pointLightCapacity);
+	frame.spotLightBuffer = CreateLightStorageBuffer(graphicsCore, "Spot Light Buffer", sizeof(SpotLightComponent::UniformStruct) * frame.spotLightCapacity);
+
+	{
+		std::array<GraphicsAPI::DescriptorSet::Binding, 3> clusteredLightBindings = {
+			GraphicsAPI::DescriptorSet::Binding::UniformBuffer(frame.constantsBuffer),
+			GraphicsAPI::DescriptorSet::Binding::StorageBuffer(frame.pointLightBuffer),
+			GraphicsAPI::DescriptorSet::Binding::StorageBuffer(frame.spotLightBuffer)
+		};
+
+		GraphicsAPI::DescriptorSet::CreateInfo clusteredLightCreateInfo{};
+		clusteredLightCreateInfo.debugName = "Clustered Light Descriptor Set";
+		clusteredLightCreateInfo.layout = clusteredLightDescriptorSetLayout;
+		clusteredLightCreateInfo.bindingCount = static_cast<uint32_t>(clusteredLightBindings.size());
+		clusteredLightCreateInfo.bindings = clusteredLightBindings.data();
+		frame.descriptorSet = graphicsCore->CreateDescriptorSet(clusteredLightCreateInfo);
+	}
+
+	return frame;
+}
+
+void Renderer::LightingPass::PackClusteredLights(entt::registry& registry, ClusteredLightFrame& frame) {
+	EngineCore& engineCore = EngineCore::GetInstance();
+	GraphicsAPI::Core* graphicsCore = engineCore.GetGraphicsCore();
+
+	std::chrono::time_point start = std::chrono::steady_clock::now();
+
+	// TODO: We should be able to get transforms below without a scene.
+	Grindstone::SceneManagement::SceneManager* sceneManager = engineCore.GetSceneManager();
+	Grindstone::SceneManagement::Scene* scene = sceneManager->scenes.begin()->second;
+
+	const glm::mat4 bias = glm::mat4(
+		0.5f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.5f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.5f, 0.5f, 0.0f, 1.0f
+	);
+
+	packedPointLights.clear();
+	packedSpotLights.clear();
+
+	{
+		auto view = registry.view<const entt::entity, const PointLightComponent>();
+		view.each(
+			[&](const entt::entity entityHandle, const PointLightComponent& pointLightComponent) {
+				const ECS::Entity entity(entityHandle, scene);
+				PointLightComponent::UniformStruct& lightStruct = packedPointLights.emplace_back(
+					PointLightComponent::UniformStruct{
+						.lightPosition = entity.GetWorldPosition(),
+						.lightAttenuationRadius = pointLightComponent.attenuationRadius,
+						.lightColor = pointLightComponent.color * pointLightComponent.intensity
+					}
+				);
+
+				for (size_t i = 0; i < 6; ++i) {
+					lightStruct.shadowData[i].shadowMatrix = pointLightComponent.shadowData[i].shadowMatrix;
+					lightStruct.shadowData[i].shadowRenderArea = pointLightComponent.shadowData[i].shadowRenderArea;
+				}
+			}
+		);
+	}
+
+	{
+		auto view = registry.view<const entt::entity, const SpotLightComponent>();
+		view.each(
+			[&](const entt::entity entityHandle, const SpotLightComponent& spotLightComponent) {
+				const ECS::Entity entity(entityHandle, scene);
+				packedSpotLights.emplace_back(
+					SpotLightComponent::UniformStruct{
+						.shadowMatrix = bias * spotLightComponent.shadowMatrix,
+						.position = entity.GetWorldPosition(),
+						.attenuationRadius = spotLightComponent.attenuationRadius,
+						.direction = entity.GetWorldForward(),
+						.innerAngle = glm::cos(glm::radians(spotLightComponent.innerAngle)),
+						.color = spotLightComponent.color * spotLightComponent.intensity,
+						.outerAngle = glm::cos(glm::radians(spotLightComponent.outerAngle)),
+						.shadowRenderArea = spotLightComponent.shadowRenderArea
+					}
+				);
+			}
+		);
+	}
+
+	frame.pointLightCount = static_cast<uint32_t>(packedPointLights.size());
+	frame.spotLightCount = static_cast<uint32_t>(packedSpotLights.size());
+
+	// Buffers only grow, and are replaced rather than resized so the set keeps pointing at a live buffer.
+	if (frame.pointLightCount > frame.pointLightCapacity) {
+		frame.pointLightCapacity = GrowLightCapacity(frame.pointLightCapacity, frame.pointLightCount);
+		graphicsCore->DeleteBuffer(frame.pointLightBuffer);
+		frame.pointLightBuffer = CreateLightStorageBuffer(graphicsCore, "Point Light Buffer", sizeof(PointLightComponent::UniformStruct) * frame.pointLightCapacity);
+		GraphicsAPI::DescriptorSet::Binding binding = GraphicsAPI::DescriptorSet::Binding::StorageBuffer(frame.pointLightBuffer);
+		frame.descriptorSet->ChangeBindings(&binding, 1u /* count */, 1u /* offset */);
+	}
+
+	if (frame.spotLightCount > frame.spotLightCapacity) {
+		frame.spotLightCapacity = GrowLightCapacity(frame.spotLightCapacity, frame.spotLightCount);
+		graphicsCore->DeleteBuffer(frame.spotLightBuffer);
+		frame.spotLightBuffer = CreateLightStorageBuffer(graphicsCore, "Spot Light Buffer", sizeof(SpotLightComponent::UniformStruct) * frame.spotLightCapacity);
+		GraphicsAPI::DescriptorSet::Binding binding = GraphicsAPI::DescriptorSet::Binding::StorageBuffer(frame.spotLightBuffer);
+		frame.descriptorSet->ChangeBindings(&binding, 1u /* count */, 2u /* offset */);
+	}
+
+	if (!packedPointLights.empty()) {
+		frame.pointLightBuffer->UploadData(packedPointLights.data(), sizeof(PointLightComponent::UniformStruct) * packedPointLights.size());
+	}
+
+	if (!packedSpotLights.empty()) {
+		frame.spotLightBuffer->UploadData(packedSpotLights.data(), sizeof(SpotLightComponent::UniformStruct) * packedSpotLights.size());
+	}
+
+	const LightClusterConstants constants{
+		.pointLightCount = frame.pointLightCount,
+		.spotLightCount = frame.spotLightCount
+	};
+	frame.constantsBuffer->UploadData(&constants);
+
+	std::chrono::time_point end = std::chrono::steady_clock::now();
+	long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	frame.packingTimeMs = static_cast<double>(ns) * 0.000001;
+}
+
 Grindstone::Renderer::LightingPassReturnData Renderer::LightingPass::AddPass(
 	GraphicsAPI::Buffer* vertexBuffer,
 	GraphicsAPI::Buffer* indexBuffer,
 	Renderer::RenderGraphBuilder& renderGraph,
 	Grindstone::Renderer::GbufferData& gbufferData,
 	RenderGraphBuilderResourceRef shadowAtlasRef,
-	RenderGraphBuilderResourceRef ambientOcclusionRef
+	RenderGraphBuilderResourceRef ambientOcclusionRef,
+	std::function<void(const Grindstone::Rendering::GeometryRenderStats&)> pushRenderingStatsCallback
 ) {
+	ComputePipelineAsset* lightCullingAsset = lightCullingPipelineSet.Get();
+	GraphicsAPI::ComputePipeline* lightCullingPipeline = lightCullingAsset != nullptr ? lightCullingAsset->GetPipeline() : nullptr;
+	GraphicsAPI::PipelineLayout* lightCullingPipelineLayout = lightCullingAsset != nullptr ? lightCullingAsset->GetPipelineLayout() : nullptr;
+	const bool hasLightClusters = lightCullingPipeline != nullptr && lightCullingPipelineLayout != nullptr;
+
+	LightClusterData lightClusterData{};
+	if (hasLightClusters) {
+		lightClusterData = renderGraph.CreateComputePass<LightClusterData>(
+			"Light Culling",
+			[](ComputeRenderGraphBuilderPass<LightClusterData>& pass) -> LightClusterData {
+				// Each cluster stores how many point and spot lights touch it, followed by a fixed-size list of their indices.
+				return LightClusterData{
+					.clusterGridRef = pass.WriteBuffer(
+						BufferDescription{
+							.name = "Light Cluster Grid",
+							.size = sizeof(uint32_t) * 2 * LightClusters::clusterCount,
+							.bufferUsage = GraphicsAPI::BufferUsage::Storage,
+							.memoryUsage = GraphicsAPI::MemoryUsage::GPUOnly
+						}
+					),
+					.clusterIndicesRef = pass.WriteBuffer(
+						BufferDescription{
+							.name = "Light Cluster Indices",
+							.size = sizeof(uint32_t) * LightClusters::maxLightsPerCluster * LightClusters::clusterCount,
+							.bufferUsage = GraphicsAPI::BufferUsage::Storage,
+							.memoryUsage = GraphicsAPI::MemoryUsage::GPUOnly
+						}
+					)
+				};
+			},
+			[lightCullingPipeline, lightCullingPipelineLayout, this](
+				RenderGraphContext& cxt,
+				const RenderGraphFrameResources& frameResources,
+				LightClusterData& lightClusterData
+			) {
+				ClusteredLightFrame& frame = GetClusteredLightFrame();
+				PackClusteredLights(cxt.worldContextSet->GetEntityRegistry(), frame);
+
+				GraphicsAPI::CommandBuffer* cmd = cxt.commandBuffer;
+
+				constexpr uint32_t WORKGROUP_SIZE = 4;
+				uint32_t groupCountX = (LightClusters::gridSizeX + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+				uint32_t groupCountY = (LightClusters::gridSizeY + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+				uint32_t groupCountZ = (LightClusters::gridSizeZ + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+
+				cmd->BindComputePipeline(lightCullingPipeline);
+				cmd->BindComputeDescriptorSet(
+					lightCullingPipelineLayout,
+					&frame.descriptorSet,
+					2u, // Offset
+					1u // Count
+				);
+				cmd->DispatchCompute(groupCountX, groupCountY, groupCountZ);
+			}
+		);
+	}
+
 	return renderGraph.CreateGraphicsPass<LightingPassReturnData>(
 		"Lighting Pass",
 		MetaRect::Swapchain(),
-		[this, shadowAtlasRef, ambientOcclusionRef, &gbufferData](Renderer::GraphicsRenderGraphBuilderPass<LightingPassReturnData>& renderPass) -> LightingPassReturnData {
+		[this, shadowAtlasRef, ambientOcclusionRef, &gbufferData, hasLightClusters, lightClusterData](Renderer::GraphicsRenderGraphBuilderPass<LightingPassReturnData>& renderPass) -> LightingPassReturnData {
 			renderPass.ReadExternalSampler(screenSampler);
 			renderPass.ReadSampledImage(gbufferData.depthRef);
 			renderPass.ReadSampledImage(gbufferData.albedoRef);
@@ -112,13 +403,17 @@ Grindstone::Renderer::LightingPassReturnData Renderer::LightingPass::AddPass(
 			renderPass.ReadSampledImage(gbufferData.specularRoughnessRef);
 			renderPass.ReadSampledImage(shadowAtlasRef);
 			renderPass.ReadSampledImage(ambientOcclusionRef);
+			if (hasLightClusters) {
+				renderPass.ReadBuffer(lightClusterData.clusterGridRef);
+				renderPass.ReadBuffer(lightClusterData.clusterIndicesRef);
+			}
 			RenderGraphBuilderResourceRef layoutImgRef = renderPass.WriteColorAttachment(attachmentlighting, GraphicsAPI::LoadOp::Clear, GraphicsAPI::ClearColor(0.0f, 0.0f, 0.0f, 1.0f));
 
 			return LightingPassReturnData{
 				.lightingOutputRef = layoutImgRef
 			};
 		},
-		[vertexBuffer, indexBuffer, this](
+		[vertexBuffer, indexBuffer, hasLightClusters, pushRenderingStatsCallback, this](
 			Grindstone::Math::IntRect2D viewportArea,
 			const Renderer::RenderGraphContext& cxt,
 			const Grindstone::Renderer::RenderGraphFrameResources& frameResources,
@@ -127,7 +422,10 @@ Grindstone::Renderer::LightingPassReturnData Renderer::LightingPass::AddPass(
 				GraphicsAPI::CommandBuffer* cmd = cxt.commandBuffer;
 				EngineCore& engineCore = EngineCore::GetInstance();
 				entt::registry& registry = cxt.worldContextSet->GetEntityRegistry();
-				GraphicsAPI::Core* graphicsCore = engineCore.GetGraphicsCore();
+
+				Grindstone::Rendering::GeometryRenderStats renderingStats{};
+				renderingStats.debugName = "Lighting";
+				std::chrono::time_point start = std::chrono::steady_clock::now();
 
 				// TODO: We should be able to get transforms below without a scene.
 				Grindstone::SceneManagement::SceneManager* sceneManager = engineCore.GetSceneManager();
@@ -136,13 +434,6 @@ Grindstone::Renderer::LightingPassReturnData Renderer::LightingPass::AddPass(
 				cmd->BindVertexBuffers(&vertexBuffer, 1);
 				cmd->BindIndexBuffer(indexBuffer);
 
-				const glm::mat4 bias = glm::mat4(
-					0.5f, 0.0f, 0.0f, 0.0f,
-					0.0f, 0.5f, 0.0f, 0.0f,
-					0.0f, 0.0f, 1.0f, 0.0f,
-					0.5f, 0.5f, 0.0f, 1.0f
-				);
-
 				GraphicsPipelineAsset* imageBasedLightingAsset = imageBasedLightingPipelineSet.Get();
 				if (imageBasedLightingAsset != nullptr) {
 					PerformImageBasedLighting(
@@ -152,81 +443,32 @@ Grindstone::Renderer::LightingPassReturnData Renderer::LightingPass::AddPass(
 						imageBasedLightingPipelineSet.Get(),
 						currentEnvironmentMapImage
 					);
+					++renderingStats.drawCalls;
 				}
 
-				GraphicsPipelineAsset* pointLightAsset = pointLightPipelineSet.Get();
-				if (pointLightAsset != nullptr) {
-					GraphicsAPI::PipelineLayout* pointLightPipelineLayout = pointLightAsset->GetFirstPassPipelineLayout();
-					GraphicsAPI::GraphicsPipeline* pointLightPipeline = pointLightAsset->GetFirstPassPipeline(&vertexLightPositionLayout);
-					if (pointLightPipeline != nullptr) {
-						cmd->BeginDebugLabelSection("Point Lighting", nullptr);
-						cmd->BindGraphicsPipeline(pointLightPipeline);
-
-						auto view = registry.view<const entt::entity, PointLightComponent>();
-						view.each(
-							[&](const entt::entity entityHandle, PointLightComponent& pointLightComponent) {
-								const ECS::Entity entity(entityHandle, scene);
-								PointLightComponent::UniformStruct lightStruct{
-									.lightPosition = entity.GetWorldPosition(),
-									.lightAttenuationRadius = pointLightComponent.attenuationRadius,
-									.lightColor = pointLightComponent.color * pointLightComponent.intensity
-								};
-
-								for (size_t i = 0; i < 6; ++i) {
-									lightStruct.shadowData[i].shadowMatrix = pointLightComponent.shadowData[i].shadowMatrix;
-									lightStruct.shadowData[i].shadowRenderArea = pointLightComponent.shadowData[i].shadowRenderArea;
-								}
-
-								pointLightComponent.uniformBufferObject->UploadData(&lightStruct);
-								cmd->BindGraphicsDescriptorSet(
-									pointLightPipelineLayout,
-									&pointLightComponent.descriptorSet,
-									2u, // Offset
-									1u // Count
-								);
-								cmd->DrawIndices(0, 6, 0, 1, 0);
-							}
+				GraphicsPipelineAsset* clusteredLightingAsset = clusteredLightingPipelineSet.Get();
+				if (hasLightClusters && clusteredLightingAsset != nullptr) {
+					GraphicsAPI::PipelineLayout* clusteredLightingPipelineLayout = clusteredLightingAsset->GetFirstPassPipelineLayout();
+					GraphicsAPI::GraphicsPipeline* clusteredLightingPipeline = clusteredLightingAsset->GetFirstPassPipeline(&vertexLightPositionLayout);
+					ClusteredLightFrame& frame = GetClusteredLightFrame();
+					if (clusteredLightingPipeline != nullptr && frame.pointLightCount + frame.spotLightCount > 0) {
+						cmd->BeginDebugLabelSection("Clustered Lighting", nullptr);
+						cmd->BindGraphicsPipeline(clusteredLightingPipeline);
+						cmd->BindGraphicsDescriptorSet(
+							clusteredLightingPipelineLayout,
+							&frame.descriptorSet,
+							2u, // Offset
+							1u // Count
 						);
+						cmd->DrawIndices(0, 6, 0, 1, 0);
 						cmd->EndDebugLabelSection();
-					}
-				}
-
-				GraphicsPipelineAsset* spotLightAsset = spotLightPipelineSet.Get();
-				if (spotLightAsset != nullptr) {
-					GraphicsAPI::PipelineLayout* spotLightPipelineLayout = spotLightAsset->GetFirstPassPipelineLayout();
-					GraphicsAPI::GraphicsPipeline* spotLightPipeline = spotLightAsset->GetFirstPassPipeline(&vertexLightPositionLayout);
-					if (spotLightPipeline != nullptr) {
-						cmd->BeginDebugLabelSection("Spot Lighting", nullptr);
-						cmd->BindGraphicsPipeline(spotLightPipeline);
-
-						auto view = registry.view<const entt::entity, SpotLightComponent>();
-						view.each(
-							[&](const entt::entity entityHandle, SpotLightComponent& spotLightComponent) {
-								const ECS::Entity entity(entityHandle, scene);
-
-								const SpotLightComponent::UniformStruct lightStruct{
-									.shadowMatrix = bias * spotLightComponent.shadowMatrix,
-									.position = entity.GetWorldPosition(),
-									.attenuationRadius = spotLightComponent.attenuationRadius,
-									.direction = entity.GetWorldForward(),
-									.innerAngle = glm::cos(glm::radians(spotLightComponent.innerAngle)),
-									.color = spotLightComponent.color * spotLightComponent.intensity,
-									.outerAngle = glm::cos(glm::radians(spotLightComponent.outerAngle)),
-									.shadowRenderArea = spotLightComponent.shadowRenderArea
-								};
-								spotLightComponent.uniformBufferObject->UploadData(&lightStruct);
 
-								cmd->BindGraphicsDescriptorSet(
-									spotLightPipelineLayout,
-									&spotLightComponent.descriptorSet,
-									2u, // Offset
-									1u // Count
-								);
-								cmd->DrawIndices(0, 6, 0, 1, 0);
-							}
-						);
-						cmd->EndDebugLabelSection();
+						++renderingStats.drawCalls;
+						++renderingStats.pipelineBinds;
+						renderingStats.objectsRendered += frame.pointLightCount + frame.spotLightCount;
 					}
+
+					renderingStats.cpuTimeMs += frame.packingTimeMs;
 				}
 
 				GraphicsPipelineAsset* directionalLightAsset = directionalLightPipelineSet.Get();
@@ -236,6 +478,7 @@ Grindstone::Renderer::LightingPassReturnData Renderer::LightingPass::AddPass(
 					if (directionalLightPipeline != nullptr) {
 						cmd->BeginDebugLabelSection("Directional Lighting", nullptr);
 						cmd->BindGraphicsPipeline(directionalLightPipeline);
+						++renderingStats.pipelineBinds;
 
 						auto view = registry.view<const entt::entity, const TransformComponent, DirectionalLightComponent>();
 						view.each(
@@ -265,11 +508,18 @@ Grindstone::Renderer::LightingPassReturnData Renderer::LightingPass::AddPass(
 									1u // Count
 								);
 								cmd->DrawIndices(0, 6, 0, 1, 0);
+								++renderingStats.drawCalls;
+								++renderingStats.objectsRendered;
 							}
 						);
 						cmd->EndDebugLabelSection();
 					}
 				}
+
+				std::chrono::time_point end = std::chrono::steady_clock::now();
+				long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+				renderingStats.cpuTimeMs += static_cast<double>(ns) * 0.000001;
+				pushRenderingStatsCallback(renderingStats);
 		}
 	);
 }
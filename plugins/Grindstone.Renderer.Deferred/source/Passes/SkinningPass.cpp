@@ -105,13 +105,22 @@ void Grindstone::Renderer::SkinningPass::AddPass(
 		) {
 			Mesh3dAsset* meshAsset = skeletalMeshComp.mesh.Get();
 
-			if (meshAsset == nullptr) {
+			if (meshAsset == nullptr || animatorComp.skeletonMatrixBuffer == nullptr) {
 				return;
 			}
 
 			EngineCore& engineCore = EngineCore::GetInstance();
 			GraphicsAPI::Core* graphicsCore = engineCore.GetGraphicsCore();
 
+			// The animator recreated its matrix buffer, so the descriptor set has to be created again. Frames in flight may still use the old one.
+			GraphicsAPI::DescriptorSet* oldDescriptorSet = skeletalMeshComp.skinningDescriptorSet;
+			if (oldDescriptorSet != nullptr && skeletalMeshComp.skinningMatrixBuffer != animatorComp.skeletonMatrixBuffer) {
+				engineCore.PushDeletion([graphicsCore, oldDescriptorSet]() {
+					graphicsCore->DeleteDescriptorSet(oldDescriptorSet);
+				});
+				skeletalMeshComp.skinningDescriptorSet = nullptr;
+			}
+
 			uint32_t vertexCount = meshAsset->vertexCount;
 			if (skeletalMeshComp.vertexCountBuffer == nullptr) {
 				std::string vertexCountBufferName = std::vformat("Skinning VertexCount Buffer '{}'", std::make_format_args(tagComp.tag));
@@ -235,6 +244,7 @@ void Grindstone::Renderer::SkinningPass::AddPass(
 					.bindingCount = static_cast<uint32_t>(bindings.size())
 				};
 				skeletalMeshComp.skinningDescriptorSet = graphicsCore->CreateDescriptorSet(createInfo);
+				skeletalMeshComp.skinningMatrixBuffer = animatorComp.skeletonMatrixBuffer;
 			}
 
 			std::string computePassLabel = std::vformat("Skinning Pass for '{}'", std::make_format_args(tagComp.tag));
@@ -244,6 +254,8 @@ void Grindstone::Renderer::SkinningPass::AddPass(
 					ComputeRenderGraphBuilderPass<RenderGraphBuilderResourceRef>& pass
 				) -> RenderGraphBuilderResourceRef {
 					RenderGraphBuilderResourceRef output{};
+					// Skinned vertices are written to the mesh's own buffers, outside of the graph.
+					pass.SetHasSideEffects(true);
 
 					return output;
 				},
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cstring>
+
+#include <lz4.h>
+
+#include "ArchiveCompression.hpp"
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+static uint64_t GetBlockCount(uint64_t uncompressedSize) {
+	return (uncompressedSize + archiveCompressionBlockSize - 1) / archiveCompressionBlockSize;
+}
+
+bool Grindstone::Assets::CompressArchiveBlocks(const Byte* src, uint64_t srcSize, std::vector<Byte>& outCompressed) {
+	const uint64_t blockCount = GetBlockCount(srcSize);
+	const uint64_t blockTableSize = blockCount * sizeof(uint32_t);
+	if (srcSize == 0 || blockTableSize >= srcSize) {
+		return false;
+	}
+
+	const int maxCompressedBlockSize = LZ4_compressBound(static_cast<int>(archiveCompressionBlockSize));
+	outCompressed.clear();
+	outCompressed.resize(blockTableSize);
+
+	uint64_t storedBlockOffset = blockTableSize;
+	for (uint64_t blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+		const uint64_t srcOffset = blockIndex * archiveCompressionBlockSize;
+		const int blockSize = static_cast<int>(std::min(archiveCompressionBlockSize, srcSize - srcOffset));
+		const char* srcBlock = reinterpret_cast<const char*>(src + srcOffset);
+
+		outCompressed.resize(storedBlockOffset + maxCompressedBlockSize);
+		char* dstBlock = reinterpret_cast<char*>(outCompressed.data() + storedBlockOffset);
+		int storedBlockSize = LZ4_compress_default(srcBlock, dstBlock, blockSize, maxCompressedBlockSize);
+		if (storedBlockSize <= 0 || storedBlockSize >= blockSize) {
+			memcpy(dstBlock, srcBlock, static_cast<size_t>(blockSize));
+			storedBlockSize = blockSize;
+		}
+
+		const uint32_t storedBlockSize32 = static_cast<uint32_t>(storedBlockSize);
+		memcpy(outCompressed.data() + blockIndex * sizeof(uint32_t), &storedBlockSize32, sizeof(uint32_t));
+		storedBlockOffset += static_cast<uint64_t>(storedBlockSize);
+
+		// Bail out early once the data can no longer come out smaller.
+		if (storedBlockOffset >= srcSize) {
+			return false;
+		}
+	}
+
+	outCompressed.resize(storedBlockOffset);
+	return true;
+}
+
+bool Grindstone::Assets::DecompressArchiveBlocks(const Byte* src, uint64_t srcSize, Byte* dst, uint64_t dstSize) {
+	const uint64_t blockCount = GetBlockCount(dstSize);
+	const uint64_t blockTableSize = blockCount * sizeof(uint32_t);
+	if (blockTableSize > srcSize) {
+		return false;
+	}
+
+	uint64_t storedBlockOffset = blockTableSize;
+	for (uint64_t blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+		uint32_t storedBlockSize = 0;
+		memcpy(&storedBlockSize, src + blockIndex * sizeof(uint32_t), sizeof(uint32_t));
+
+		const uint64_t dstOffset = blockIndex * archiveCompressionBlockSize;
+		const uint64_t blockSize = std::min(archiveCompressionBlockSize, dstSize - dstOffset);
+		if (storedBlockOffset + storedBlockSize > srcSize) {
+			return false;
+		}
+
+		const Byte* srcBlock = src + storedBlockOffset;
+		Byte* dstBlock = dst + dstOffset;
+		if (storedBlockSize == blockSize) {
+			memcpy(dstBlock, srcBlock, blockSize);
+		}
+		else {
+			const int decompressedSize = LZ4_decompress_safe(
+				reinterpret_cast<const char*>(srcBlock),
+				reinterpret_cast<char*>(dstBlock),
+				static_cast<int>(storedBlockSize),
+				static_cast<int>(blockSize)
+			);
+
+			if (decompressedSize != static_cast<int>(blockSize)) {
+				return false;
+			}
+		}
+
+		storedBlockOffset += storedBlockSize;
+	}
+
+	// The blocks have to fill the data exactly, or the block table doesn't belong to it.
+	return storedBlockOffset == srcSize;
+}
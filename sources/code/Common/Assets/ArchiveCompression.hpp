@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include <Common/IntTypes.hpp>
+
+namespace Grindstone::Assets {
+	enum class ArchiveCompression : uint8_t {
+		// The asset is stored as is.
+		None = 0,
+		// The asset is split into blocks of archiveCompressionBlockSize, each compressed with LZ4 on its own.
+		Lz4Blocks
+	};
+
+	/*
+	 * A block-compressed asset is a table of uint32_t stored block sizes followed by the blocks. A block
+	 * that LZ4 can't shrink is stored raw, which is the case when its stored size equals its uncompressed
+	 * size. Only the last block may be smaller than archiveCompressionBlockSize.
+	 */
+	constexpr uint64_t archiveCompressionBlockSize = 256ull * 1024ull;
+
+	// Compresses srcSize bytes of src into outCompressed. Returns false if compressing wouldn't make the data any smaller.
+	bool CompressArchiveBlocks(const Byte* src, uint64_t srcSize, std::vector<Byte>& outCompressed);
+
+	// Decompresses a block-compressed asset one block at a time, straight into dst. Returns false if the data is malformed.
+	bool DecompressArchiveBlocks(const Byte* src, uint64_t srcSize, Byte* dst, uint64_t dstSize);
+}
@@ -5,10 +5,12 @@
 #include <string_view>
 #include <vector>
 
+#include <Common/Assets/ArchiveCompression.hpp>
 #include <Common/ResourcePipeline/AssetType.hpp>
 #include <Common/ResourcePipeline/Uuid.hpp>
 
 namespace Grindstone::Assets {
+	// The contents of an archive directory while it's being built. Runtime lookups use ArchiveDirectoryView instead.
 	struct ArchiveDirectory {
 		struct AssetInfo {
 			std::string_view displayName;
@@ -17,11 +19,12 @@ namespace Grindstone::Assets {
 			uint16_t archiveIndex;
 			uint64_t offset;
 			uint64_t size;
+			uint64_t uncompressedSize;
+			ArchiveCompression compression;
 		};
 
 		struct AssetTypeIndex {
 			std::map<Uuid, AssetInfo> assetsByUuid;
-			std::map<std::string_view, Grindstone::Uuid> assetUuidByAddress;
 		};
 
 		struct ArchiveInfo {
@@ -34,6 +37,5 @@ namespace Grindstone::Assets {
 
 		std::vector<AssetTypeIndex> assetTypeIndices;
 		std::vector<ArchiveInfo> archives;
-		std::vector<char> strings;
 	};
 }
@@ -1,14 +1,20 @@
 #pragma once
 
-#include <string>
+#include <stdint.h>
 #include <vector>
 
+#include <Common/Assets/ArchiveCompression.hpp>
 #include <Common/ResourcePipeline/AssetType.hpp>
 #include <Common/ResourcePipeline/Uuid.hpp>
 
 namespace Grindstone::Assets {
+	/*
+	 * The layout of a .gdir file, which is memory-mapped and used in place. Every section starts at an
+	 * eight byte aligned offset from the start of the file. Within each asset type, assets are sorted by
+	 * uuid and addresses by their hash, so both can be binary searched without building any lookup tables.
+	 */
 	struct ArchiveDirectoryFile {
-		const static uint32_t CURRENT_VERSION = 1;
+		const static uint32_t CURRENT_VERSION = 3;
 
 		struct Header {
 			const char signature[4] = { 'G', 'D', 'I', 'R' };
@@ -16,27 +22,48 @@ namespace Grindstone::Assets {
 			uint32_t buildCode = 0;
 			uint32_t headerSize = sizeof(Header);
 			uint32_t assetTypeCount = static_cast<uint32_t>(AssetType::Count);
-			uint32_t assetTypeIndexSize;
-			uint32_t assetInfoIndexSize;
-			uint32_t archiveIndexSize;
-			uint32_t stringsSize;
+			uint32_t archiveCount = 0;
+			uint64_t assetTypeIndexOffset = 0;
+			uint64_t assetsOffset = 0;
+			uint64_t assetCount = 0;
+			uint64_t addressesOffset = 0;
+			uint64_t addressCount = 0;
+			uint64_t archivesOffset = 0;
+			uint64_t stringsOffset = 0;
+			uint64_t stringsSize = 0;
 		};
 
+		// The range of assets and addresses belonging to an asset type.
 		struct AssetTypeSectionInfo {
-			uint64_t offset;
-			uint16_t count;
+			uint32_t firstAssetIndex = 0;
+			uint32_t assetCount = 0;
+			uint32_t firstAddressIndex = 0;
+			uint32_t addressCount = 0;
 		};
 
 		struct AssetInfo {
 			Grindstone::Uuid uuid;
-			uint64_t displayNameOffset;
+			uint64_t offset;
+			// The size stored in the archive, which is smaller than uncompressedSize if the asset is compressed.
+			uint64_t size;
+			uint64_t uncompressedSize;
+			// Offsets of strings are from the start of the strings section.
+			uint32_t displayNameOffset;
+			uint32_t addressOffset;
+			uint32_t crc;
 			uint16_t displayNameSize;
-			uint64_t addressOffset;
 			uint16_t addressSize;
-			uint32_t crc;
 			uint16_t archiveIndex;
-			uint64_t offset;
-			uint64_t size;
+			ArchiveCompression compression;
+			uint8_t reserved[5] = {};
+		};
+
+		struct AddressEntry {
+			// Hash::MurmurOAAT64 of the address.
+			uint64_t addressHash;
+			// An index into the whole asset section, not just the asset type's range.
+			uint32_t assetIndex;
+			uint32_t reserved = 0;
 		};
 
 		struct ArchiveInfo {
@@ -44,9 +71,13 @@ namespace Grindstone::Assets {
 		};
 
 		Header header;
-		std::vector<AssetTypeSectionInfo> assetInfoIndex;
+		std::vector<AssetTypeSectionInfo> assetTypeIndex;
 		std::vector<AssetInfo> assets;
+		std::vector<AddressEntry> addresses;
 		std::vector<ArchiveInfo> archives;
-		std::vector<std::string> strings;
 	};
+
+	static_assert(sizeof(ArchiveDirectoryFile::Header) == 88, "The archive directory header must not contain padding.");
+	static_assert(sizeof(ArchiveDirectoryFile::AssetInfo) == 64, "The archive directory asset info must not contain padding.");
+	static_assert(sizeof(ArchiveDirectoryFile::AddressEntry) == 16, "The archive directory address entry must not contain padding.");
 }
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include <Common/Hash.hpp>
+
+#include "ArchiveDirectoryView.hpp"
+
+using namespace Grindstone::Assets;
+
+// Whether a section of count elements of T starting at offset lies inside the file and is aligned for T.
+template<typename T>
+static bool IsSectionValid(uint64_t fileSize, uint64_t offset, uint64_t count) {
+	return
+		offset % alignof(T) == 0 &&
+		offset <= fileSize &&
+		count <= (fileSize - offset) / sizeof(T);
+}
+
+ArchiveDirectoryOpenStatus ArchiveDirectoryView::Open(const std::filesystem::path& path) {
+	Close();
+
+	if (!file.Open(path)) {
+		return ArchiveDirectoryOpenStatus::FileNotFound;
+	}
+
+	const uint64_t fileSize = file.GetSize();
+	const Byte* fileData = file.GetData();
+	if (fileSize < sizeof(ArchiveDirectoryFile::Header)) {
+		file.Close();
+		return ArchiveDirectoryOpenStatus::InvalidFormat;
+	}
+
+	const ArchiveDirectoryFile::Header* fileHeader = reinterpret_cast<const ArchiveDirectoryFile::Header*>(fileData);
+	if (strncmp(fileHeader->signature, "GDIR", 4) != 0) {
+		file.Close();
+		return ArchiveDirectoryOpenStatus::InvalidFormat;
+	}
+
+	if (fileHeader->version != ArchiveDirectoryFile::CURRENT_VERSION || fileHeader->headerSize != sizeof(ArchiveDirectoryFile::Header)) {
+		file.Close();
+		return ArchiveDirectoryOpenStatus::UnsupportedVersion;
+	}
+
+	const bool areSectionsValid =
+		IsSectionValid<ArchiveDirectoryFile::AssetTypeSectionInfo>(fileSize, fileHeader->assetTypeIndexOffset, fileHeader->assetTypeCount) &&
+		IsSectionValid<ArchiveDirectoryFile::AssetInfo>(fileSize, fileHeader->assetsOffset, fileHeader->assetCount) &&
+		IsSectionValid<ArchiveDirectoryFile::AddressEntry>(fileSize, fileHeader->addressesOffset, fileHeader->addressCount) &&
+		IsSectionValid<ArchiveDirectoryFile::ArchiveInfo>(fileSize, fileHeader->archivesOffset, fileHeader->archiveCount) &&
+		IsSectionValid<char>(fileSize, fileHeader->stringsOffset, fileHeader->stringsSize);
+
+	if (!areSectionsValid) {
+		file.Close();
+		return ArchiveDirectoryOpenStatus::InvalidFormat;
+	}
+
+	// Only the ranges of each asset type are checked, which keeps opening independent of the asset count.
+	const ArchiveDirectoryFile::AssetTypeSectionInfo* fileAssetTypeSections =
+		reinterpret_cast<const ArchiveDirectoryFile::AssetTypeSectionInfo*>(fileData + fileHeader->assetTypeIndexOffset);
+	for (uint32_t assetTypeIndex = 0; assetTypeIndex < fileHeader->assetTypeCount; ++assetTypeIndex) {
+		const ArchiveDirectoryFile::AssetTypeSectionInfo& section = fileAssetTypeSections[assetTypeIndex];
+		if (
+			static_cast<uint64_t>(section.firstAssetIndex) + section.assetCount > fileHeader->assetCount ||
+			static_cast<uint64_t>(section.firstAddressIndex) + section.addressCount > fileHeader->addressCount
+		) {
+			file.Close();
+			return ArchiveDirectoryOpenStatus::InvalidFormat;
+		}
+	}
+
+	header = fileHeader;
+	assetTypeSections = fileAssetTypeSections;
+	assets = reinterpret_cast<const ArchiveDirectoryFile::AssetInfo*>(fileData + header->assetsOffset);
+	addresses = reinterpret_cast<const ArchiveDirectoryFile::AddressEntry*>(fileData + header->addressesOffset);
+	archives = reinterpret_cast<const ArchiveDirectoryFile::ArchiveInfo*>(fileData + header->archivesOffset);
+	strings = reinterpret_cast<const char*>(fileData + header->stringsOffset);
+	name = path.stem().string();
+
+	return ArchiveDirectoryOpenStatus::Success;
+}
+
+void ArchiveDirectoryView::Close() {
+	header = nullptr;
+	assetTypeSections = nullptr;
+	assets = nullptr;
+	addresses = nullptr;
+	archives = nullptr;
+	strings = nullptr;
+	name.clear();
+	file.Close();
+}
+
+size_t ArchiveDirectoryView::GetArchiveCount() const {
+	return header != nullptr
+		? header->archiveCount
+		: 0;
+}
+
+uint32_t ArchiveDirectoryView::GetArchiveCrc(size_t archiveIndex) const {
+	return archiveIndex < GetArchiveCount()
+		? archives[archiveIndex].crc
+		: 0;
+}
+
+const ArchiveDirectoryFile::AssetTypeSectionInfo* ArchiveDirectoryView::GetAssetTypeSection(AssetType assetType) const {
+	const size_t assetTypeIndex = static_cast<size_t>(assetType);
+	if (header == nullptr || assetTypeIndex >= header->assetTypeCount) {
+		return nullptr;
+	}
+
+	return &assetTypeSections[assetTypeIndex];
+}
+
+Grindstone::Containers::Span<const ArchiveDirectoryFile::AssetInfo> ArchiveDirectoryView::GetAssets(AssetType assetType) const {
+	const ArchiveDirectoryFile::AssetTypeSectionInfo* section = GetAssetTypeSection(assetType);
+	if (section == nullptr) {
+		return {};
+	}
+
+	return Grindstone::Containers::Span<const ArchiveDirectoryFile::AssetInfo>(assets + section->firstAssetIndex, section->assetCount);
+}
+
+const ArchiveDirectoryFile::AssetInfo* ArchiveDirectoryView::FindAsset(AssetType assetType, const Uuid& uuid) const {
+	const ArchiveDirectoryFile::AssetTypeSectionInfo* section = GetAssetTypeSection(assetType);
+	if (section == nullptr) {
+		return nullptr;
+	}
+
+	const ArchiveDirectoryFile::AssetInfo* first = assets + section->firstAssetIndex;
+	const ArchiveDirectoryFile::AssetInfo* last = first + section->assetCount;
+	const ArchiveDirectoryFile::AssetInfo* asset = std::lower_bound(
+		first, last, uuid,
+		[](const ArchiveDirectoryFile::AssetInfo& lhs, const Uuid& rhs) {
+			return lhs.uuid < rhs;
+		}
+	);
+
+	return (asset != last && asset->uuid == uuid)
+		? asset
+		: nullptr;
+}
+
+const ArchiveDirectoryFile::AssetInfo* ArchiveDirectoryView::FindAssetByAddress(AssetType assetType, std::string_view address) const {
+	const ArchiveDirectoryFile::AssetTypeSectionInfo* section = GetAssetTypeSection(assetType);
+	if (section == nullptr) {
+		return nullptr;
+	}
+
+	const uint64_t addressHash = Grindstone::Hash::MurmurOAAT64(address.data(), address.size());
+	const ArchiveDirectoryFile::AddressEntry* first = addresses + section->firstAddressIndex;
+	const ArchiveDirectoryFile::AddressEntry* last = first + section->addressCount;
+	const ArchiveDirectoryFile::AddressEntry* entry = std::lower_bound(
+		first, last, addressHash,
+		[](const ArchiveDirectoryFile::AddressEntry& lhs, uint64_t rhs) {
+			return lhs.addressHash < rhs;
+		}
+	);
+
+	// Different addresses can share a hash, so check each candidate's actual address.
+	for (; entry != last && entry->addressHash == addressHash; ++entry) {
+		if (entry->assetIndex < header->assetCount && GetAddress(assets[entry->assetIndex]) == address) {
+			return &assets[entry->assetIndex];
+		}
+	}
+
+	return nullptr;
+}
+
+std::string_view ArchiveDirectoryView::GetDisplayName(const ArchiveDirectoryFile::AssetInfo& asset) const {
+	return GetString(asset.displayNameOffset, asset.displayNameSize);
+}
+
+std::string_view ArchiveDirectoryView::GetAddress(const ArchiveDirectoryFile::AssetInfo& asset) const {
+	return GetString(asset.addressOffset, asset.addressSize);
+}
+
+std::string_view ArchiveDirectoryView::GetString(uint32_t offset, uint16_t size) const {
+	if (header == nullptr || static_cast<uint64_t>(offset) + size > header->stringsSize) {
+		return {};
+	}
+
+	return std::string_view(strings + offset, size);
+}
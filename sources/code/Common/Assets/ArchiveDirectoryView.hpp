@@ -0,0 +1,64 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <Common/Assets/ArchiveDirectoryFile.hpp>
+#include <Common/Containers/Span.hpp>
+#include <Common/Utilities/MemoryMappedFile.hpp>
+
+namespace Grindstone::Assets {
+	enum class ArchiveDirectoryOpenStatus : uint8_t {
+		Success = 0,
+		FileNotFound,
+		InvalidFormat,
+		UnsupportedVersion
+	};
+
+	/*
+	 * A read-only archive directory, used straight out of its memory-mapped .gdir file. Opening only
+	 * checks the header and section bounds, so it takes the same time however many assets are listed,
+	 * and lookups are binary searches over the sorted sections. Safe to read from several threads once open.
+	 */
+	class ArchiveDirectoryView {
+	public:
+		ArchiveDirectoryOpenStatus Open(const std::filesystem::path& path);
+		void Close();
+
+		[[nodiscard]] bool IsOpen() const {
+			return header != nullptr;
+		}
+
+		// The directory file is {name}.gdir, and each archive it lists is {name}_{archiveIndex}.garc.
+		[[nodiscard]] const std::string& GetName() const {
+			return name;
+		}
+
+		[[nodiscard]] size_t GetArchiveCount() const;
+		[[nodiscard]] uint32_t GetArchiveCrc(size_t archiveIndex) const;
+
+		// Assets of a type, sorted by uuid.
+		[[nodiscard]] Grindstone::Containers::Span<const ArchiveDirectoryFile::AssetInfo> GetAssets(AssetType assetType) const;
+		// Returns nullptr if the asset isn't in the directory.
+		[[nodiscard]] const ArchiveDirectoryFile::AssetInfo* FindAsset(AssetType assetType, const Uuid& uuid) const;
+		// Returns nullptr if no asset of this type has the address.
+		[[nodiscard]] const ArchiveDirectoryFile::AssetInfo* FindAssetByAddress(AssetType assetType, std::string_view address) const;
+
+		[[nodiscard]] std::string_view GetDisplayName(const ArchiveDirectoryFile::AssetInfo& asset) const;
+		[[nodiscard]] std::string_view GetAddress(const ArchiveDirectoryFile::AssetInfo& asset) const;
+
+	private:
+		[[nodiscard]] const ArchiveDirectoryFile::AssetTypeSectionInfo* GetAssetTypeSection(AssetType assetType) const;
+		[[nodiscard]] std::string_view GetString(uint32_t offset, uint16_t size) const;
+
+		Utilities::MemoryMappedFile file;
+		std::string name;
+		const ArchiveDirectoryFile::Header* header = nullptr;
+		const ArchiveDirectoryFile::AssetTypeSectionInfo* assetTypeSections = nullptr;
+		const ArchiveDirectoryFile::AssetInfo* assets = nullptr;
+		const ArchiveDirectoryFile::AddressEntry* addresses = nullptr;
+		const ArchiveDirectoryFile::ArchiveInfo* archives = nullptr;
+		const char* strings = nullptr;
+	};
+}
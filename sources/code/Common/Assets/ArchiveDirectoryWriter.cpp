@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+#include <Common/Assets/ArchiveDirectoryFile.hpp>
+#include <Common/Hash.hpp>
+
+#include "ArchiveDirectoryWriter.hpp"
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+// Sections of a directory start at eight byte boundaries, so they can be used in place once mapped.
+static uint64_t AlignDirectorySectionOffset(uint64_t offset) {
+	constexpr uint64_t sectionAlignment = 8;
+	return (offset + sectionAlignment - 1) & ~(sectionAlignment - 1);
+}
+
+static void WriteDirectorySection(std::ofstream& output, uint64_t sectionOffset, const void* data, uint64_t size) {
+	const char padding[8] = {};
+	const uint64_t currentOffset = static_cast<uint64_t>(output.tellp());
+	output.write(padding, static_cast<std::streamsize>(sectionOffset - currentOffset));
+	output.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+// Strings are null-terminated in the file, though their sizes don't include the terminator.
+static uint32_t AddDirectoryString(std::vector<char>& strings, std::string_view string) {
+	const uint32_t offset = static_cast<uint32_t>(strings.size());
+	strings.insert(strings.end(), string.begin(), string.end());
+	strings.push_back('\0');
+	return offset;
+}
+
+bool Grindstone::Assets::WriteArchiveDirectory(const std::filesystem::path& path, const ArchiveDirectory& directory) {
+	const uint16_t assetTypeCount = static_cast<uint16_t>(AssetType::Count);
+
+	ArchiveDirectoryFile outputFile;
+	std::vector<char> strings;
+	outputFile.assetTypeIndex.resize(assetTypeCount);
+	outputFile.archives.reserve(directory.archives.size());
+
+	// Assets come from a map with the same ordering the view searches with, so they're already sorted by uuid within each type.
+	for (uint16_t assetTypeIndex = 0; assetTypeIndex < assetTypeCount; ++assetTypeIndex) {
+		ArchiveDirectoryFile::AssetTypeSectionInfo& assetTypeSection = outputFile.assetTypeIndex[assetTypeIndex];
+		assetTypeSection.firstAssetIndex = static_cast<uint32_t>(outputFile.assets.size());
+		assetTypeSection.firstAddressIndex = static_cast<uint32_t>(outputFile.addresses.size());
+
+		for (const auto& [uuid, asset] : directory.assetTypeIndices[assetTypeIndex].assetsByUuid) {
+			if (!asset.address.empty()) {
+				outputFile.addresses.emplace_back(
+					ArchiveDirectoryFile::AddressEntry{
+						Hash::MurmurOAAT64(asset.address.data(), asset.address.size()),
+						static_cast<uint32_t>(outputFile.assets.size())
+					}
+				);
+			}
+
+			const uint32_t displayNameOffset = AddDirectoryString(strings, asset.displayName);
+			const uint32_t addressOffset = AddDirectoryString(strings, asset.address);
+			outputFile.assets.emplace_back(
+				ArchiveDirectoryFile::AssetInfo{
+					uuid,
+					asset.offset,
+					asset.size,
+					asset.uncompressedSize,
+					displayNameOffset,
+					addressOffset,
+					asset.crc,
+					static_cast<uint16_t>(asset.displayName.size()),
+					static_cast<uint16_t>(asset.address.size()),
+					asset.archiveIndex,
+					asset.compression
+				}
+			);
+		}
+
+		assetTypeSection.assetCount = static_cast<uint32_t>(outputFile.assets.size()) - assetTypeSection.firstAssetIndex;
+		assetTypeSection.addressCount = static_cast<uint32_t>(outputFile.addresses.size()) - assetTypeSection.firstAddressIndex;
+
+		// Colliding hashes are ordered by address, so the directory is the same every build.
+		auto addressesBegin = outputFile.addresses.begin() + assetTypeSection.firstAddressIndex;
+		std::sort(
+			addressesBegin, outputFile.addresses.end(),
+			[&outputFile, &strings](const ArchiveDirectoryFile::AddressEntry& lhs, const ArchiveDirectoryFile::AddressEntry& rhs) {
+				if (lhs.addressHash != rhs.addressHash) {
+					return lhs.addressHash < rhs.addressHash;
+				}
+
+				const ArchiveDirectoryFile::AssetInfo& lhsAsset = outputFile.assets[lhs.assetIndex];
+				const ArchiveDirectoryFile::AssetInfo& rhsAsset = outputFile.assets[rhs.assetIndex];
+				return
+					std::string_view(strings.data() + lhsAsset.addressOffset, lhsAsset.addressSize) <
+					std::string_view(strings.data() + rhsAsset.addressOffset, rhsAsset.addressSize);
+			}
+		);
+	}
+
+	for (const auto& [crc] : directory.archives) {
+		outputFile.archives.emplace_back(ArchiveDirectoryFile::ArchiveInfo{ crc });
+	}
+
+	const uint64_t assetTypeIndexSize = sizeof(ArchiveDirectoryFile::AssetTypeSectionInfo) * outputFile.assetTypeIndex.size();
+	const uint64_t assetsSize = sizeof(ArchiveDirectoryFile::AssetInfo) * outputFile.assets.size();
+	const uint64_t addressesSize = sizeof(ArchiveDirectoryFile::AddressEntry) * outputFile.addresses.size();
+	const uint64_t archivesSize = sizeof(ArchiveDirectoryFile::ArchiveInfo) * outputFile.archives.size();
+
+	ArchiveDirectoryFile::Header& header = outputFile.header;
+	header.assetTypeCount = assetTypeCount;
+	header.archiveCount = static_cast<uint32_t>(outputFile.archives.size());
+	header.assetTypeIndexOffset = AlignDirectorySectionOffset(sizeof(ArchiveDirectoryFile::Header));
+	header.assetsOffset = AlignDirectorySectionOffset(header.assetTypeIndexOffset + assetTypeIndexSize);
+	header.assetCount = outputFile.assets.size();
+	header.addressesOffset = AlignDirectorySectionOffset(header.assetsOffset + assetsSize);
+	header.addressCount = outputFile.addresses.size();
+	header.archivesOffset = AlignDirectorySectionOffset(header.addressesOffset + addressesSize);
+	header.stringsOffset = AlignDirectorySectionOffset(header.archivesOffset + archivesSize);
+	header.stringsSize = strings.size();
+
+	std::ofstream output(path, std::ios::binary);
+	if (!output.is_open()) {
+		return false;
+	}
+
+	WriteDirectorySection(output, 0, &header, sizeof(header));
+	WriteDirectorySection(output, header.assetTypeIndexOffset, outputFile.assetTypeIndex.data(), assetTypeIndexSize);
+	WriteDirectorySection(output, header.assetsOffset, outputFile.assets.data(), assetsSize);
+	WriteDirectorySection(output, header.addressesOffset, outputFile.addresses.data(), addressesSize);
+	WriteDirectorySection(output, header.archivesOffset, outputFile.archives.data(), archivesSize);
+	WriteDirectorySection(output, header.stringsOffset, strings.data(), header.stringsSize);
+
+	output.close();
+	return static_cast<bool>(output);
+}
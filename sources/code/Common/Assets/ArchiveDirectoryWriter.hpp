@@ -0,0 +1,10 @@
+#pragma once
+
+#include <filesystem>
+
+#include <Common/Assets/ArchiveDirectory.hpp>
+
+namespace Grindstone::Assets {
+	// Writes a directory in the .gdir layout that ArchiveDirectoryView reads in place. Returns false if the file couldn't be written.
+	bool WriteArchiveDirectory(const std::filesystem::path& path, const ArchiveDirectory& directory);
+}
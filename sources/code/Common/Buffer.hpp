@@ -20,13 +20,14 @@ namespace Grindstone {
 		}
 
 		// Move-Constructor
-		Buffer(Buffer&& other) noexcept : bufferPtr(other.bufferPtr), capacity(other.capacity) {
+		Buffer(Buffer&& other) noexcept : bufferPtr(other.bufferPtr), capacity(other.capacity), isOwner(other.isOwner) {
 			other.bufferPtr = nullptr;
 			other.capacity = 0;
+			other.isOwner = true;
 		}
 
 		~Buffer() {
-			if (bufferPtr != nullptr) {
+			if (bufferPtr != nullptr && isOwner) {
 				Grindstone::Memory::AllocatorCore::Free(bufferPtr);
 				bufferPtr = nullptr;
 			}
@@ -146,6 +147,7 @@ namespace Grindstone {
 
 			capacity = other.capacity;
 			bufferPtr = static_cast<Byte*>(Grindstone::Memory::AllocatorCore::AllocateRaw(capacity, alignof(Buffer), "Buffer"));
+			isOwner = true;
 			memcpy(bufferPtr, other.bufferPtr, capacity);
 			return *this;
 		}
@@ -155,15 +157,17 @@ namespace Grindstone {
 				return *this;
 			}
 
-			if (bufferPtr) {
+			if (bufferPtr && isOwner) {
 				Grindstone::Memory::AllocatorCore::Free(bufferPtr);
 			}
 
 			bufferPtr = other.bufferPtr;
 			capacity = other.capacity;
+			isOwner = other.isOwner;
 
 			other.bufferPtr = nullptr;
 			other.capacity = 0;
+			other.isOwner = true;
 
 			return *this;
 		}
@@ -181,12 +185,13 @@ namespace Grindstone {
 		}
 
 		void Clear() {
-			if (bufferPtr != nullptr) {
+			if (bufferPtr != nullptr && isOwner) {
 				Grindstone::Memory::AllocatorCore::Free(bufferPtr);
-				bufferPtr = nullptr;
 			}
 
+			bufferPtr = nullptr;
 			capacity = 0;
+			isOwner = true;
 		}
 
 		[[nodiscard]] Byte* Get() {
@@ -212,11 +217,24 @@ namespace Grindstone {
 			return Buffer( bufferPtr, capacity );
 		}
 
+		// Wraps memory owned by something else, such as a memory-mapped file, without copying or freeing it.
+		// The memory must outlive the buffer. Copies of a view own their own copy of the memory.
+		[[nodiscard]] static Buffer MakeViewBuffer(void* srcBufferPtr, const uint64_t capacity) {
+			Buffer buffer( srcBufferPtr, capacity );
+			buffer.isOwner = false;
+			return buffer;
+		}
+
+		[[nodiscard]] bool IsView() const {
+			return !isOwner;
+		}
+
 	protected:
 		Buffer(void* bufferPtr, const uint64_t capacity) : bufferPtr(static_cast<Byte*>(bufferPtr)), capacity(capacity) {}
 
 		Byte* bufferPtr = nullptr;
 		uint64_t capacity = 0;
+		bool isOwner = true;
 	};
 
 	class ResizableBuffer : public Buffer {
@@ -38,6 +38,18 @@ namespace Grindstone::GraphicsAPI {
 		Intel
 	};
 
+	// GPU memory usage summed over every heap. Backends that don't track memory leave it empty.
+	struct MemoryStats {
+		// How much memory the driver allows this process to use, and how much it currently uses.
+		uint64_t budgetBytes = 0;
+		uint64_t usageBytes = 0;
+		// Device memory blocks allocated from the driver, and the resources sub-allocated from them.
+		uint64_t blockBytes = 0;
+		uint64_t allocationBytes = 0;
+		uint32_t blockCount = 0;
+		uint32_t allocationCount = 0;
+	};
+
 	class Core {
 	public:
 		struct CreateInfo {
@@ -111,6 +123,7 @@ namespace Grindstone::GraphicsAPI {
 		virtual void BindDefaultFramebufferRead() = 0;
 
 		virtual void WaitUntilIdle() = 0;
+		virtual MemoryStats GetMemoryStats() const { return MemoryStats{}; }
 
 		virtual void BindGraphicsPipeline(GraphicsPipeline* pipeline) = 0;
 		virtual void BindVertexArrayObject(VertexArrayObject*) = 0;
@@ -32,7 +32,10 @@ namespace Grindstone::GraphicsAPI {
 		virtual Image* GetCurrentSwapchainImage() const = 0;
 		virtual Image* GetSwapchainImage(uint32_t index) const = 0;
 		virtual uint32_t GetCurrentSwapchainIndex() const = 0;
+		// The frame in flight being recorded, which WaitForRenderingFence waits on.
 		virtual uint32_t GetCurrentImageIndex() const = 0;
+		// Counts calls to WaitForRenderingFence. Once it changes, the GPU is done with everything
+		// previously recorded for the current image index.
 		virtual uint32_t GetCurrentFrame() const = 0;
 		virtual uint32_t GetMaxFramesInFlight() const = 0;
 		virtual void Resize(uint32_t width, uint32_t height) = 0;
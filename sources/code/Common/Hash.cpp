@@ -0,0 +1,66 @@
+#include <array>
+#include <cstring>
+
+#include "Hash.hpp"
+
+using namespace Grindstone;
+
+using Crc32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+// Table 0 is the usual byte-at-a-time table. Table n advances a byte through n further zero bytes,
+// which lets eight input bytes be folded in with independent lookups.
+static constexpr Crc32Tables MakeCrc32Tables() {
+	Crc32Tables tables{};
+	for (uint32_t byte = 0; byte < 256; ++byte) {
+		uint32_t crc = byte;
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc >> 1) ^ ((crc & 1u) ? 0xEDB88320u : 0u);
+		}
+		tables[0][byte] = crc;
+	}
+
+	for (uint32_t byte = 0; byte < 256; ++byte) {
+		for (size_t tableIndex = 1; tableIndex < tables.size(); ++tableIndex) {
+			const uint32_t previous = tables[tableIndex - 1][byte];
+			tables[tableIndex][byte] = (previous >> 8) ^ tables[0][previous & 0xFFu];
+		}
+	}
+
+	return tables;
+}
+
+static constexpr Crc32Tables crc32Tables = MakeCrc32Tables();
+
+uint32_t Hash::Crc32(const void* data, size_t size, uint32_t crc) {
+	const Byte* bytes = static_cast<const Byte*>(data);
+	crc = ~crc;
+
+	while (size >= 8) {
+		uint32_t low = 0;
+		uint32_t high = 0;
+		memcpy(&low, bytes, sizeof(uint32_t));
+		memcpy(&high, bytes + 4, sizeof(uint32_t));
+		low ^= crc;
+
+		crc =
+			crc32Tables[7][low & 0xFFu] ^
+			crc32Tables[6][(low >> 8) & 0xFFu] ^
+			crc32Tables[5][(low >> 16) & 0xFFu] ^
+			crc32Tables[4][low >> 24] ^
+			crc32Tables[3][high & 0xFFu] ^
+			crc32Tables[2][(high >> 8) & 0xFFu] ^
+			crc32Tables[1][(high >> 16) & 0xFFu] ^
+			crc32Tables[0][high >> 24];
+
+		bytes += 8;
+		size -= 8;
+	}
+
+	while (size > 0) {
+		crc = (crc >> 8) ^ crc32Tables[0][(crc ^ *bytes) & 0xFFu];
+		++bytes;
+		--size;
+	}
+
+	return ~crc;
+}
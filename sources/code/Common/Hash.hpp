@@ -55,6 +55,9 @@ namespace Grindstone {
 			Combine(seed, rest...);
 		}
 
+		// Standard CRC-32 (as used by zlib and PNG), computed eight bytes at a time. Pass a previous result as crc to continue it.
+		uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0);
+
 		struct HashPair {
 			template <class T1, class T2>
 			size_t operator()(const std::pair<T1, T2>& p) const {
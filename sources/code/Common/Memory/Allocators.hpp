@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Allocators/DynamicAllocator.hpp"
+#include "Allocators/FrameAllocator.hpp"
 #include "Allocators/LinearAllocator.hpp"
 #include "Allocators/StackAllocator.hpp"
 #include "Allocators/PoolAllocator.hpp"
+#include "Allocators/ThreadCachingAllocator.hpp"
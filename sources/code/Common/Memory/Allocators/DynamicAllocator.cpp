@@ -1,3 +1,5 @@
+#include <bit>
+#include <cstddef>
 #include <memory>
 #include <iostream>
 #include <sstream>
@@ -12,6 +14,15 @@ using namespace Grindstone::Memory::Allocators;
 constexpr size_t allocationHeaderSize = sizeof(DynamicAllocator::AllocationHeader);
 constexpr size_t freeHeaderSize = sizeof(DynamicAllocator::FreeHeader);
 
+// Allocated segregated blocks only keep the first two members of their header.
+static constexpr size_t segregatedBlockHeaderSize = offsetof(DynamicAllocator::SegregatedBlockHeader, nextFreeBlock);
+static constexpr size_t minSegregatedBlockSize = sizeof(DynamicAllocator::SegregatedBlockHeader);
+static constexpr size_t segregatedAlignment = 16;
+static constexpr size_t segregatedFreeFlag = 1;
+static constexpr size_t secondLevelCountLog2 = std::bit_width(DynamicAllocator::secondLevelCount) - 1;
+static constexpr size_t firstLevelShift = secondLevelCountLog2 + std::bit_width(segregatedAlignment) - 1;
+static constexpr size_t smallSegregatedBlockSize = size_t(1) << firstLevelShift;
+
 static constexpr size_t minBlockSize = std::max(sizeof(DynamicAllocator::FreeHeader), sizeof(DynamicAllocator::AllocationHeader) + 1);
 static constexpr size_t maxMetadataAlignment = std::max(alignof(DynamicAllocator::FreeHeader), alignof(DynamicAllocator::AllocationHeader));
 
@@ -151,12 +162,16 @@ void DynamicAllocator::InitializeImpl(void* ownedMemory, size_t size) {
 	};
 
 	memset(startMemory, 0, size);
-	firstFreeHeader = reinterpret_cast<FreeHeader*>(startMemory);
 	usedSize = 0;
 	peakSize = 0;
 	totalMemorySize = size;
-	hasAllocatedOwnMemory = false;
 
+	if (searchPolicy == SearchPolicy::SegregatedFit) {
+		InitializeSegregatedBlocks();
+		return;
+	}
+
+	firstFreeHeader = reinterpret_cast<FreeHeader*>(startMemory);
 	firstFreeHeader->blockSize = size;
 	firstFreeHeader->nextFreeBlock = nullptr;
 }
@@ -181,8 +196,7 @@ bool DynamicAllocator::Initialize(size_t size) {
 DynamicAllocator::~DynamicAllocator() {
 #ifdef _DEBUG
 	for (auto& allocation : nameMap) {
-		AllocationHeader* header = reinterpret_cast<AllocationHeader*>(static_cast<char*>(allocation.first) - sizeof(AllocationHeader));
-		GPRINT_TRACE_V(LogSource::EngineCore, "Unfreed Memory - {} Size({}): {}", allocation.first, header->blockSize, allocation.second);
+		GPRINT_TRACE_V(LogSource::EngineCore, "Unfreed Memory - {} Size({}): {}", allocation.first, GetAllocationSize(allocation.first), allocation.second);
 	}
 #endif
 
@@ -207,7 +221,55 @@ size_t DynamicAllocator::GetTotalMemorySize() const {
 	return totalMemorySize;
 }
 
+void DynamicAllocator::SetSearchPolicy(SearchPolicy policy) {
+	GS_ASSERT(startMemory == nullptr);
+	searchPolicy = policy;
+}
+
+DynamicAllocator::SearchPolicy DynamicAllocator::GetSearchPolicy() const {
+	return searchPolicy;
+}
+
+size_t DynamicAllocator::GetAllocationSize(void* memPtr) const {
+	if (searchPolicy == SearchPolicy::SegregatedFit) {
+		const SegregatedBlockHeader* block = reinterpret_cast<const SegregatedBlockHeader*>(static_cast<char*>(memPtr) - segregatedBlockHeaderSize);
+		return block->sizeAndFlags & ~segregatedFreeFlag;
+	}
+
+	const AllocationHeader* header = reinterpret_cast<const AllocationHeader*>(static_cast<char*>(memPtr) - allocationHeaderSize);
+	return header->blockSize;
+}
+
 void* DynamicAllocator::AllocateRaw(size_t size, size_t alignment, const char* debugName) {
+	void* memPtr = (searchPolicy == SearchPolicy::SegregatedFit)
+		? AllocateFromSegregatedLists(size, alignment)
+		: AllocateFromFreeList(size, alignment);
+
+#ifdef _DEBUG
+	if (memPtr != nullptr) {
+		strncpy_s(nameMap[memPtr], debugName, DEBUG_NAME_SIZE - 1);
+	}
+#endif
+
+	return memPtr;
+}
+
+bool DynamicAllocator::Free(void* memPtr) {
+	if (searchPolicy == SearchPolicy::SegregatedFit) {
+		FreeToSegregatedLists(memPtr);
+	}
+	else {
+		FreeToFreeList(memPtr);
+	}
+
+#ifdef _DEBUG
+	nameMap.erase(memPtr);
+#endif
+
+	return true;
+}
+
+void* DynamicAllocator::AllocateFromFreeList(size_t size, size_t alignment) {
 	DynamicAllocator::FreeHeader* previousNode = nullptr;
 	DynamicAllocator::FreeHeader* selectedNode = nullptr;
 	size_t padding = 0;
@@ -223,7 +285,11 @@ void* DynamicAllocator::AllocateRaw(size_t size, size_t alignment, const char* d
 
 	const std::size_t rest = selectedNode->blockSize - requiredSize;
 
-	if (rest > minBlockSize) {
+	if (rest <= minBlockSize) {
+		// Too small to hold a free block, so it stays part of this allocation and is returned with it.
+		requiredSize = selectedNode->blockSize;
+	}
+	else {
 		// We have to split the block into the data block and a free block of size 'rest'
 		DynamicAllocator::FreeHeader* newFreeNode = (DynamicAllocator::FreeHeader*)((std::size_t)selectedNode + requiredSize);
 		newFreeNode->blockSize = rest;
@@ -246,13 +312,7 @@ void* DynamicAllocator::AllocateRaw(size_t size, size_t alignment, const char* d
 	usedSize += requiredSize;
 	peakSize = std::max(peakSize, usedSize);
 
-	void* voidAddr = reinterpret_cast<void*>(dataAddress);
-
-#ifdef _DEBUG
-	strncpy_s(nameMap[voidAddr], debugName, DEBUG_NAME_SIZE - 1);
-#endif
-
-	return voidAddr;
+	return reinterpret_cast<void*>(dataAddress);
 }
 
 static void Coalesce(DynamicAllocator::FreeHeader*& head, DynamicAllocator::FreeHeader* previousNode, DynamicAllocator::FreeHeader* freeNode) {
@@ -268,12 +328,14 @@ static void Coalesce(DynamicAllocator::FreeHeader*& head, DynamicAllocator::Free
 	}
 }
 
-bool DynamicAllocator::Free(void* ptr) {
+void DynamicAllocator::FreeToFreeList(void* ptr) {
 	size_t currentAddress = reinterpret_cast<size_t>(ptr);
 	AllocationHeader* allocationHeader = reinterpret_cast<AllocationHeader*>(currentAddress - allocationHeaderSize);
 
-	FreeHeader* freeNode = (FreeHeader*)(allocationHeader);
-	freeNode->blockSize = allocationHeader->blockSize;
+	// The block starts before the header, at the alignment padding it was allocated with.
+	const size_t blockSize = allocationHeader->blockSize;
+	FreeHeader* freeNode = (FreeHeader*)(reinterpret_cast<size_t>(allocationHeader) - allocationHeader->padding);
+	freeNode->blockSize = blockSize;
 	freeNode->nextFreeBlock = nullptr;
 
 	FreeHeader* it = firstFreeHeader;
@@ -281,7 +343,7 @@ bool DynamicAllocator::Free(void* ptr) {
 
 	// Find the previous node
 	while (it != nullptr) {
-		if (ptr < it) {
+		if (freeNode < it) {
 			FreeListInsert(firstFreeHeader, itPrev, freeNode);
 			GS_ASSERT(
 				reinterpret_cast<uintptr_t>(freeNode) %
@@ -305,8 +367,234 @@ bool DynamicAllocator::Free(void* ptr) {
 	usedSize -= freeNode->blockSize;
 
 	Coalesce(firstFreeHeader, itPrev, freeNode);
+}
 
-	return true;
+// Segregated fit keeps a free list for every (first level, second level) size range. The first level is the
+// power of two of the block size, and the second level splits it linearly into secondLevelCount ranges, with
+// blocks under smallSegregatedBlockSize all in first level zero. A bit is set in the bitmaps for every
+// non-empty list, so a suitable list is found with two bit scans. Every block knows its physical neighbours,
+// and is merged with them as soon as it's freed, so two free blocks are never next to each other.
+
+static size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static void MapToSegregatedList(size_t blockSize, size_t& firstLevel, size_t& secondLevel) {
+	if (blockSize < smallSegregatedBlockSize) {
+		firstLevel = 0;
+		secondLevel = blockSize / (smallSegregatedBlockSize / DynamicAllocator::secondLevelCount);
+		return;
+	}
+
+	const size_t topBit = std::bit_width(blockSize) - 1;
+	secondLevel = (blockSize >> (topBit - secondLevelCountLog2)) ^ DynamicAllocator::secondLevelCount;
+	firstLevel = topBit - (firstLevelShift - 1);
+}
+
+// Rounds up to the start of the next list, so any block in the list that is found is big enough.
+static size_t RoundUpToSegregatedList(size_t blockSize) {
+	if (blockSize < smallSegregatedBlockSize) {
+		return blockSize;
+	}
+
+	const size_t topBit = std::bit_width(blockSize) - 1;
+	return blockSize + (size_t(1) << (topBit - secondLevelCountLog2)) - 1;
+}
+
+static size_t GetSegregatedBlockSize(const DynamicAllocator::SegregatedBlockHeader* block) {
+	return block->sizeAndFlags & ~segregatedFreeFlag;
+}
+
+static bool IsSegregatedBlockFree(const DynamicAllocator::SegregatedBlockHeader* block) {
+	return (block->sizeAndFlags & segregatedFreeFlag) != 0;
+}
+
+static DynamicAllocator::SegregatedBlockHeader* GetNextPhysicalBlock(DynamicAllocator::SegregatedBlockHeader* block) {
+	return reinterpret_cast<DynamicAllocator::SegregatedBlockHeader*>(reinterpret_cast<char*>(block) + GetSegregatedBlockSize(block));
+}
+
+// Splits the end of a block off into a new block, and returns the new one.
+static DynamicAllocator::SegregatedBlockHeader* SplitSegregatedBlock(DynamicAllocator::SegregatedBlockHeader* block, size_t newBlockOffset) {
+	const size_t blockSize = GetSegregatedBlockSize(block);
+	DynamicAllocator::SegregatedBlockHeader* newBlock = reinterpret_cast<DynamicAllocator::SegregatedBlockHeader*>(reinterpret_cast<char*>(block) + newBlockOffset);
+	newBlock->previousPhysicalBlock = block;
+	newBlock->sizeAndFlags = blockSize - newBlockOffset;
+	GetNextPhysicalBlock(newBlock)->previousPhysicalBlock = newBlock;
+	block->sizeAndFlags = newBlockOffset | (block->sizeAndFlags & segregatedFreeFlag);
+	return newBlock;
+}
+
+void DynamicAllocator::InitializeSegregatedBlocks() {
+	firstLevelBitmap = 0;
+	memset(secondLevelBitmaps, 0, sizeof(secondLevelBitmaps));
+	memset(segregatedFreeLists, 0, sizeof(segregatedFreeLists));
+
+	// The memory ends with an empty, allocated block, so the last real block never merges past the end.
+	const size_t firstBlockAddress = AlignUp(reinterpret_cast<size_t>(startMemory), segregatedAlignment);
+	const size_t sentinelAddress = (reinterpret_cast<size_t>(endMemory) - segregatedBlockHeaderSize) & ~(segregatedAlignment - 1);
+	if (sentinelAddress < firstBlockAddress + minSegregatedBlockSize) {
+		return;
+	}
+
+	SegregatedBlockHeader* firstBlock = reinterpret_cast<SegregatedBlockHeader*>(firstBlockAddress);
+	firstBlock->previousPhysicalBlock = nullptr;
+	firstBlock->sizeAndFlags = (sentinelAddress - firstBlockAddress) | segregatedFreeFlag;
+
+	SegregatedBlockHeader* sentinelBlock = reinterpret_cast<SegregatedBlockHeader*>(sentinelAddress);
+	sentinelBlock->previousPhysicalBlock = firstBlock;
+	sentinelBlock->sizeAndFlags = 0;
+
+	InsertSegregatedBlock(firstBlock);
+}
+
+void DynamicAllocator::InsertSegregatedBlock(SegregatedBlockHeader* block) {
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+	MapToSegregatedList(GetSegregatedBlockSize(block), firstLevel, secondLevel);
+
+	SegregatedBlockHeader*& listHead = segregatedFreeLists[firstLevel][secondLevel];
+	block->previousFreeBlock = nullptr;
+	block->nextFreeBlock = listHead;
+	if (listHead != nullptr) {
+		listHead->previousFreeBlock = block;
+	}
+
+	listHead = block;
+	firstLevelBitmap |= uint64_t(1) << firstLevel;
+	secondLevelBitmaps[firstLevel] |= uint32_t(1) << secondLevel;
+}
+
+void DynamicAllocator::RemoveSegregatedBlock(SegregatedBlockHeader* block) {
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+	MapToSegregatedList(GetSegregatedBlockSize(block), firstLevel, secondLevel);
+
+	if (block->previousFreeBlock != nullptr) {
+		block->previousFreeBlock->nextFreeBlock = block->nextFreeBlock;
+	}
+	else {
+		segregatedFreeLists[firstLevel][secondLevel] = block->nextFreeBlock;
+		if (block->nextFreeBlock == nullptr) {
+			secondLevelBitmaps[firstLevel] &= ~(uint32_t(1) << secondLevel);
+			if (secondLevelBitmaps[firstLevel] == 0) {
+				firstLevelBitmap &= ~(uint64_t(1) << firstLevel);
+			}
+		}
+	}
+
+	if (block->nextFreeBlock != nullptr) {
+		block->nextFreeBlock->previousFreeBlock = block->previousFreeBlock;
+	}
+}
+
+DynamicAllocator::SegregatedBlockHeader* DynamicAllocator::FindSegregatedBlock(size_t blockSize) {
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+	MapToSegregatedList(RoundUpToSegregatedList(blockSize), firstLevel, secondLevel);
+	if (firstLevel >= firstLevelCount) {
+		return FindSegregatedBlockInExactList(blockSize);
+	}
+
+	uint32_t secondLevelBitmap = secondLevelBitmaps[firstLevel] & (~uint32_t(0) << secondLevel);
+	if (secondLevelBitmap == 0) {
+		const uint64_t firstLevelMask = (firstLevel + 1 < 64) ? (~uint64_t(0) << (firstLevel + 1)) : 0;
+		const uint64_t remainingFirstLevels = firstLevelBitmap & firstLevelMask;
+		if (remainingFirstLevels == 0) {
+			return FindSegregatedBlockInExactList(blockSize);
+		}
+
+		firstLevel = std::countr_zero(remainingFirstLevels);
+		secondLevelBitmap = secondLevelBitmaps[firstLevel];
+	}
+
+	secondLevel = std::countr_zero(secondLevelBitmap);
+	return segregatedFreeLists[firstLevel][secondLevel];
+}
+
+// Only the list holding blockSize itself can still have a large enough block. Searching it isn't constant
+// time, but it only happens when nearly out of memory, and stops a large allocation failing needlessly.
+DynamicAllocator::SegregatedBlockHeader* DynamicAllocator::FindSegregatedBlockInExactList(size_t blockSize) {
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+	MapToSegregatedList(blockSize, firstLevel, secondLevel);
+	if (firstLevel >= firstLevelCount) {
+		return nullptr;
+	}
+
+	for (SegregatedBlockHeader* block = segregatedFreeLists[firstLevel][secondLevel]; block != nullptr; block = block->nextFreeBlock) {
+		if (GetSegregatedBlockSize(block) >= blockSize) {
+			return block;
+		}
+	}
+
+	return nullptr;
+}
+
+void* DynamicAllocator::AllocateFromSegregatedLists(size_t size, size_t alignment) {
+	alignment = std::max(alignment, segregatedAlignment);
+	const size_t blockSize = std::max(AlignUp(std::max<size_t>(size, 1), segregatedAlignment) + segregatedBlockHeaderSize, minSegregatedBlockSize);
+
+	// Overaligned allocations need room to split a free block off the front, to line up the data.
+	const size_t searchSize = (alignment > segregatedAlignment)
+		? blockSize + alignment + minSegregatedBlockSize
+		: blockSize;
+
+	SegregatedBlockHeader* block = FindSegregatedBlock(searchSize);
+	if (block == nullptr) {
+		return nullptr;
+	}
+
+	RemoveSegregatedBlock(block);
+
+	if (alignment > segregatedAlignment) {
+		const size_t dataAddress = reinterpret_cast<size_t>(block) + segregatedBlockHeaderSize;
+		size_t gap = AlignUp(dataAddress, alignment) - dataAddress;
+		if (gap != 0 && gap < minSegregatedBlockSize) {
+			gap += AlignUp(minSegregatedBlockSize - gap, alignment);
+		}
+
+		if (gap != 0) {
+			// The block was free, so the block before it isn't, and the gap can't merge with anything.
+			SegregatedBlockHeader* alignedBlock = SplitSegregatedBlock(block, gap);
+			InsertSegregatedBlock(block);
+			block = alignedBlock;
+		}
+	}
+
+	if (GetSegregatedBlockSize(block) - blockSize >= minSegregatedBlockSize) {
+		SegregatedBlockHeader* remainingBlock = SplitSegregatedBlock(block, blockSize);
+		remainingBlock->sizeAndFlags |= segregatedFreeFlag;
+		InsertSegregatedBlock(remainingBlock);
+	}
+
+	block->sizeAndFlags &= ~segregatedFreeFlag;
+
+	usedSize += GetSegregatedBlockSize(block);
+	peakSize = std::max(peakSize, usedSize);
+
+	return reinterpret_cast<char*>(block) + segregatedBlockHeaderSize;
+}
+
+void DynamicAllocator::FreeToSegregatedLists(void* ptr) {
+	SegregatedBlockHeader* block = reinterpret_cast<SegregatedBlockHeader*>(static_cast<char*>(ptr) - segregatedBlockHeaderSize);
+	usedSize -= GetSegregatedBlockSize(block);
+
+	SegregatedBlockHeader* previousBlock = block->previousPhysicalBlock;
+	if (previousBlock != nullptr && IsSegregatedBlockFree(previousBlock)) {
+		RemoveSegregatedBlock(previousBlock);
+		previousBlock->sizeAndFlags += GetSegregatedBlockSize(block);
+		block = previousBlock;
+	}
+
+	SegregatedBlockHeader* nextBlock = GetNextPhysicalBlock(block);
+	if (IsSegregatedBlockFree(nextBlock)) {
+		RemoveSegregatedBlock(nextBlock);
+		block->sizeAndFlags += GetSegregatedBlockSize(nextBlock);
+	}
+
+	block->sizeAndFlags |= segregatedFreeFlag;
+	GetNextPhysicalBlock(block)->previousPhysicalBlock = block;
+	InsertSegregatedBlock(block);
 }
 
 bool DynamicAllocator::IsEmpty() const {
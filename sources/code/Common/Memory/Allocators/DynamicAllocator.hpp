@@ -10,11 +10,12 @@
 
 namespace Grindstone::Memory::Allocators {
 	/**
-	 * \brief A dynamic allocator represented by a linked list.
+	 * \brief A dynamic allocator represented by free lists.
 	 *
 	 * Memory in a dynamic allocator can be allocated and deallocated freely, with no restrictions.
-	 * Allocations have a header that points to the next block of memory, and so free memory can be found
-	 * in between allocated blocks of memory.
+	 * By default, free blocks are kept in segregated lists by size (two-level segregated fit), so
+	 * allocating and freeing take constant time. The FirstSearch and BestSearch policies instead keep
+	 * a single list sorted by address, and walk it to find free memory in between allocated blocks.
 	 */
 	class DynamicAllocator {
 	public:
@@ -27,16 +28,34 @@ namespace Grindstone::Memory::Allocators {
 
 		struct AllocationHeader {
 			size_t blockSize;
-			uint8_t padding;
+			size_t padding;
+		};
+
+		struct SegregatedBlockHeader {
+			SegregatedBlockHeader* previousPhysicalBlock;
+			// The block size including this header. The lowest bit is set while the block is free.
+			size_t sizeAndFlags;
+			// Only used while the block is free. Allocations start here instead.
+			SegregatedBlockHeader* nextFreeBlock;
+			SegregatedBlockHeader* previousFreeBlock;
 		};
 
 		enum class SearchPolicy {
 			FirstSearch = 0,
-			BestSearch
+			BestSearch,
+			SegregatedFit
 		};
 
+		static const size_t secondLevelCount = 16;
+		// One first level for blocks under 256 bytes, then one per remaining bit of size_t.
+		static const size_t firstLevelCount = 57;
+
 		~DynamicAllocator();
 
+		// Must be set before Initialize.
+		void SetSearchPolicy(SearchPolicy policy);
+		SearchPolicy GetSearchPolicy() const;
+
 		bool Initialize(size_t size);
 		void Initialize(void* ownedMemory, size_t size);
 
@@ -49,6 +68,8 @@ namespace Grindstone::Memory::Allocators {
 		size_t GetPeakSize() const;
 		size_t GetUsedSize() const;
 		void* GetMemory() const;
+		// The size of the block holding an allocation, including its header and padding.
+		size_t GetAllocationSize(void* memPtr) const;
 
 #ifdef _DEBUG
 		const std::map<void*, char[DEBUG_NAME_SIZE]>& GetNameMap() const {
@@ -120,15 +141,30 @@ namespace Grindstone::Memory::Allocators {
 	private:
 		void InitializeImpl(void* ownedMemory, size_t size);
 
+		void* AllocateFromFreeList(size_t size, size_t alignment);
+		void FreeToFreeList(void* memPtr);
+
+		void InitializeSegregatedBlocks();
+		void InsertSegregatedBlock(SegregatedBlockHeader* block);
+		void RemoveSegregatedBlock(SegregatedBlockHeader* block);
+		SegregatedBlockHeader* FindSegregatedBlock(size_t blockSize);
+		SegregatedBlockHeader* FindSegregatedBlockInExactList(size_t blockSize);
+		void* AllocateFromSegregatedLists(size_t size, size_t alignment);
+		void FreeToSegregatedLists(void* memPtr);
+
 		void* startMemory = nullptr;
 		void* endMemory = nullptr;
 		FreeHeader* firstFreeHeader = nullptr;
 
+		uint64_t firstLevelBitmap = 0;
+		uint32_t secondLevelBitmaps[firstLevelCount] = {};
+		SegregatedBlockHeader* segregatedFreeLists[firstLevelCount][secondLevelCount] = {};
+
 		std::function<void(void*)> deleterFn;
 		size_t totalMemorySize = 0;
 		size_t usedSize = 0;
 		size_t peakSize = 0;
-		SearchPolicy searchPolicy = SearchPolicy::BestSearch;
+		SearchPolicy searchPolicy = SearchPolicy::SegregatedFit;
 		bool shouldClear = false;
 		bool hasAllocatedOwnMemory = false;
 
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include <EngineCore/Logger.hpp>
+
+#include "FrameAllocator.hpp"
+
+using namespace Grindstone::Memory::Allocators;
+
+static uintptr_t AlignUp(uintptr_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+}
+
+FrameAllocator::~FrameAllocator() {
+	Destroy();
+}
+
+void FrameAllocator::Initialize(void* ownedMemory, size_t size, uint32_t newFrameCount) {
+	Destroy();
+
+	if (ownedMemory == nullptr || newFrameCount == 0) {
+		return;
+	}
+
+	memory = ownedMemory;
+	frameCount = newFrameCount;
+	arenaSize = size / frameCount;
+	arenas = std::make_unique<Arena[]>(frameCount);
+	for (uint32_t i = 0; i < frameCount; ++i) {
+		arenas[i].memory = static_cast<char*>(memory) + arenaSize * i;
+#ifdef _DEBUG
+		memset(arenas[i].memory, poisonByte, arenaSize);
+#endif
+	}
+
+	currentArenaIndex.store(0, std::memory_order_relaxed);
+}
+
+void FrameAllocator::Destroy() {
+	if (arenas != nullptr) {
+		for (uint32_t i = 0; i < frameCount; ++i) {
+			ClearArena(arenas[i]);
+		}
+	}
+
+	arenas.reset();
+	memory = nullptr;
+	arenaSize = 0;
+	frameCount = 0;
+}
+
+void FrameAllocator::BeginFrame() {
+	if (arenas == nullptr) {
+		return;
+	}
+
+	const uint32_t nextArenaIndex = (currentArenaIndex.load(std::memory_order_relaxed) + 1) % frameCount;
+	ClearArena(arenas[nextArenaIndex]);
+	currentArenaIndex.store(nextArenaIndex, std::memory_order_release);
+	frameNumber.fetch_add(1, std::memory_order_release);
+}
+
+void* FrameAllocator::AllocateRaw(size_t size, size_t alignment) {
+	if (arenas == nullptr) {
+		return nullptr;
+	}
+
+	Arena& arena = arenas[currentArenaIndex.load(std::memory_order_acquire)];
+	const uintptr_t arenaStart = reinterpret_cast<uintptr_t>(arena.memory);
+
+	size_t usedSize = arena.usedSize.load(std::memory_order_relaxed);
+	size_t alignedOffset = 0;
+	do {
+		alignedOffset = static_cast<size_t>(AlignUp(arenaStart + usedSize, alignment) - arenaStart);
+		if (alignedOffset + size > arenaSize) {
+			return AllocateOverflow(arena, size, alignment);
+		}
+	} while (!arena.usedSize.compare_exchange_weak(usedSize, alignedOffset + size, std::memory_order_relaxed));
+
+	return arena.memory + alignedOffset;
+}
+
+bool FrameAllocator::IsInitialized() const {
+	return arenas != nullptr;
+}
+
+void* FrameAllocator::GetMemory() const {
+	return memory;
+}
+
+size_t FrameAllocator::GetArenaSize() const {
+	return arenaSize;
+}
+
+uint32_t FrameAllocator::GetFrameCount() const {
+	return frameCount;
+}
+
+uint32_t FrameAllocator::GetCurrentFrameIndex() const {
+	return currentArenaIndex.load(std::memory_order_acquire);
+}
+
+uint64_t FrameAllocator::GetFrameNumber() const {
+	return frameNumber.load(std::memory_order_acquire);
+}
+
+size_t FrameAllocator::GetUsedSize() const {
+	if (arenas == nullptr) {
+		return 0;
+	}
+
+	const Arena& arena = arenas[currentArenaIndex.load(std::memory_order_acquire)];
+	return std::min(arena.usedSize.load(std::memory_order_relaxed), arenaSize);
+}
+
+void* FrameAllocator::AllocateOverflow(Arena& arena, size_t size, size_t alignment) {
+	void* overflowMemory = ::operator new(size, std::align_val_t(alignment), std::nothrow);
+	if (overflowMemory == nullptr) {
+		return nullptr;
+	}
+
+	std::scoped_lock lock(arena.overflowMutex);
+	arena.overflowAllocations.push_back(OverflowAllocation{ overflowMemory, alignment });
+	arena.overflowSize += size;
+	return overflowMemory;
+}
+
+void FrameAllocator::ClearArena(Arena& arena) {
+	if (!arena.overflowAllocations.empty()) {
+		GPRINT_WARN_V(Grindstone::LogSource::EngineCore, "Frame arena of {} bytes overflowed by {} bytes. Consider increasing its size.", arenaSize, arena.overflowSize);
+		for (const OverflowAllocation& overflowAllocation : arena.overflowAllocations) {
+			::operator delete(overflowAllocation.memory, std::align_val_t(overflowAllocation.alignment));
+		}
+
+		arena.overflowAllocations.clear();
+		arena.overflowSize = 0;
+	}
+
+#ifdef _DEBUG
+	memset(arena.memory, poisonByte, std::min(arena.usedSize.load(std::memory_order_relaxed), arenaSize));
+#endif
+
+	arena.usedSize.store(0, std::memory_order_relaxed);
+}
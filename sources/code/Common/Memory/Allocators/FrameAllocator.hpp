@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace Grindstone::Memory::Allocators {
+	/**
+	 * \brief A set of linear arenas, one per frame in flight, for memory that only lives for a frame.
+	 *
+	 * Allocations bump an atomic offset into the current frame's arena, so any thread can allocate without
+	 * locking, and nothing is freed individually. BeginFrame moves on to the next arena and clears it, so
+	 * memory allocated during a frame stays valid until that frame's fence has been waited on. In debug
+	 * builds, cleared memory is poisoned so pointers kept past their frame are easy to spot. If an arena
+	 * runs out, allocations fall back to the system heap until the arena is next cleared.
+	 */
+	class FrameAllocator {
+	public:
+		static const uint8_t poisonByte = 0xDD;
+
+		FrameAllocator() = default;
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+		~FrameAllocator();
+
+		// Splits ownedMemory into frameCount arenas. The memory must outlive the allocator, or its Destroy call.
+		void Initialize(void* ownedMemory, size_t size, uint32_t frameCount);
+		void Destroy();
+
+		// Clears the arena of the oldest frame, and allocates from it until the next call.
+		void BeginFrame();
+		// Returns nullptr if the allocator isn't initialized, or the heap is out of memory.
+		void* AllocateRaw(size_t size, size_t alignment);
+
+		bool IsInitialized() const;
+		void* GetMemory() const;
+		size_t GetArenaSize() const;
+		uint32_t GetFrameCount() const;
+		// Which of the frameCount arenas is being allocated from.
+		uint32_t GetCurrentFrameIndex() const;
+		// How many times BeginFrame has been called, which is never reset.
+		uint64_t GetFrameNumber() const;
+		// How much of the current frame's arena is used.
+		size_t GetUsedSize() const;
+
+		template<typename T, typename... Args>
+		T* Allocate(Args&&... params) {
+			T* ptr = static_cast<T*>(AllocateRaw(sizeof(T), alignof(T)));
+			if (ptr != nullptr) {
+				// Call the constructor on the newly allocated memory
+				new (ptr) T(std::forward<Args>(params)...);
+			}
+
+			return ptr;
+		}
+
+		template<typename T>
+		T* AllocateArray(size_t arraySize) {
+			return static_cast<T*>(AllocateRaw(sizeof(T) * arraySize, alignof(T)));
+		}
+
+	private:
+		struct OverflowAllocation {
+			void* memory;
+			size_t alignment;
+		};
+
+		struct Arena {
+			char* memory = nullptr;
+			std::atomic<size_t> usedSize = 0;
+			std::mutex overflowMutex;
+			std::vector<OverflowAllocation> overflowAllocations;
+			size_t overflowSize = 0;
+		};
+
+		void* AllocateOverflow(Arena& arena, size_t size, size_t alignment);
+		void ClearArena(Arena& arena);
+
+		void* memory = nullptr;
+		size_t arenaSize = 0;
+		uint32_t frameCount = 0;
+		std::unique_ptr<Arena[]> arenas;
+		std::atomic<uint32_t> currentArenaIndex = 0;
+		std::atomic<uint64_t> frameNumber = 0;
+	};
+}
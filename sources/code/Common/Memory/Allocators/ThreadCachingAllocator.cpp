@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <array>
+
+#include <EngineCore/Logger.hpp>
+
+#include "ThreadCachingAllocator.hpp"
+
+using namespace Grindstone::Memory::Allocators;
+
+using ThreadCache = ThreadCachingAllocator::ThreadCache;
+using FreeBlock = ThreadCachingAllocator::FreeBlock;
+
+static constexpr size_t sizeClassGranularity = 16;
+static constexpr uint8_t notASpanPage = 0;
+
+// Maps (size + 15) / 16 to the smallest size class that fits it.
+static constexpr std::array<uint8_t, ThreadCachingAllocator::maxSmallSize / sizeClassGranularity + 1> sizeClassLookup = [] {
+	std::array<uint8_t, ThreadCachingAllocator::maxSmallSize / sizeClassGranularity + 1> lookup{};
+	uint8_t sizeClassIndex = 0;
+	for (size_t i = 0; i < lookup.size(); ++i) {
+		while (ThreadCachingAllocator::sizeClasses[sizeClassIndex] < i * sizeClassGranularity) {
+			++sizeClassIndex;
+		}
+
+		lookup[i] = sizeClassIndex;
+	}
+
+	return lookup;
+}();
+
+static thread_local ThreadCache currentThreadCache;
+
+// Small classes move more blocks per batch, so every refill amortizes the lock over roughly the same number of bytes.
+static size_t GetBatchSize(size_t sizeClassIndex) {
+	return std::clamp<size_t>(4096 / ThreadCachingAllocator::sizeClasses[sizeClassIndex], 4, 64);
+}
+
+ThreadCache::~ThreadCache() {
+	if (owner != nullptr) {
+		owner->ReleaseThreadCache(*this);
+	}
+}
+
+void ThreadCache::Reset() {
+	owner = nullptr;
+	previousCache = nullptr;
+	nextCache = nullptr;
+	smallUsedSize.store(0, std::memory_order_relaxed);
+	for (SizeClassCache& sizeClassCache : sizeClassCaches) {
+		sizeClassCache = SizeClassCache{};
+	}
+}
+
+bool ThreadCachingAllocator::Initialize(size_t size) {
+	if (!backingAllocator.Initialize(size)) {
+		return false;
+	}
+
+	deleterFn = [this](void* ptr) -> void {
+		this->Free(ptr);
+	};
+
+	const uintptr_t memoryStart = reinterpret_cast<uintptr_t>(backingAllocator.GetMemory());
+	firstSpanPage = memoryStart / spanSize;
+	spanPageCount = (memoryStart + size - 1) / spanSize - firstSpanPage + 1;
+	spanPageSizeClasses = std::make_unique<std::atomic<uint8_t>[]>(spanPageCount);
+	for (size_t i = 0; i < spanPageCount; ++i) {
+		spanPageSizeClasses[i].store(notASpanPage, std::memory_order_relaxed);
+	}
+
+	return true;
+}
+
+ThreadCachingAllocator::~ThreadCachingAllocator() {
+	{
+		// Any thread still holding a cache is abandoning its blocks along with the memory they came from.
+		std::scoped_lock lock(threadCacheMutex);
+		for (ThreadCache* threadCache = firstThreadCache; threadCache != nullptr;) {
+			ThreadCache* nextCache = threadCache->nextCache;
+			threadCache->Reset();
+			threadCache = nextCache;
+		}
+
+		firstThreadCache = nullptr;
+	}
+
+	std::scoped_lock lock(backingAllocatorMutex);
+	for (void* spanChunk : spanChunks) {
+		backingAllocator.Free(spanChunk);
+	}
+}
+
+void* ThreadCachingAllocator::AllocateRaw(size_t size, size_t alignment, const char* debugName) {
+	if (size <= maxSmallSize && alignment <= maxSmallAlignment) {
+		return AllocateSmall(sizeClassLookup[(size + sizeClassGranularity - 1) / sizeClassGranularity]);
+	}
+
+	std::scoped_lock lock(backingAllocatorMutex);
+	return backingAllocator.AllocateRaw(size, alignment, debugName);
+}
+
+bool ThreadCachingAllocator::Free(void* memPtr) {
+	if (memPtr == nullptr) {
+		return false;
+	}
+
+	const size_t spanSizeClass = GetSpanSizeClass(memPtr);
+	if (spanSizeClass != notASpanPage) {
+		FreeSmall(memPtr, spanSizeClass - 1);
+		return true;
+	}
+
+	std::scoped_lock lock(backingAllocatorMutex);
+	return backingAllocator.Free(memPtr);
+}
+
+void ThreadCachingAllocator::FlushThreadCache() {
+	ThreadCache* threadCache = GetThreadCache();
+	if (threadCache != nullptr) {
+		FlushThreadCache(*threadCache);
+	}
+}
+
+bool ThreadCachingAllocator::IsEmpty() const {
+	return GetUsedSize() == 0;
+}
+
+size_t ThreadCachingAllocator::GetTotalMemorySize() const {
+	return backingAllocator.GetTotalMemorySize();
+}
+
+size_t ThreadCachingAllocator::GetPeakSize() const {
+	std::scoped_lock lock(backingAllocatorMutex);
+	return backingAllocator.GetPeakSize();
+}
+
+size_t ThreadCachingAllocator::GetUsedSize() const {
+	int64_t smallUsedSize = uncachedSmallUsedSize.load(std::memory_order_relaxed);
+	{
+		std::scoped_lock lock(threadCacheMutex);
+		for (ThreadCache* threadCache = firstThreadCache; threadCache != nullptr; threadCache = threadCache->nextCache) {
+			smallUsedSize += threadCache->smallUsedSize.load(std::memory_order_relaxed);
+		}
+	}
+
+	std::scoped_lock lock(backingAllocatorMutex);
+	const size_t largeUsedSize = backingAllocator.GetUsedSize() - reservedSpanSize;
+	return largeUsedSize + static_cast<size_t>(std::max<int64_t>(smallUsedSize, 0));
+}
+
+std::mutex& ThreadCachingAllocator::GetBackingAllocatorMutex() {
+	return backingAllocatorMutex;
+}
+
+DynamicAllocator& ThreadCachingAllocator::GetBackingAllocator() {
+	return backingAllocator;
+}
+
+// A thread only caches blocks for the first allocator it uses. This engine only has one, and any
+// other allocator still works from another thread, it just goes to the central lists every time.
+ThreadCache* ThreadCachingAllocator::GetThreadCache() {
+	ThreadCache& threadCache = currentThreadCache;
+	if (threadCache.owner == this) {
+		return &threadCache;
+	}
+
+	if (threadCache.owner != nullptr) {
+		return nullptr;
+	}
+
+	std::scoped_lock lock(threadCacheMutex);
+	threadCache.owner = this;
+	threadCache.previousCache = nullptr;
+	threadCache.nextCache = firstThreadCache;
+	if (firstThreadCache != nullptr) {
+		firstThreadCache->previousCache = &threadCache;
+	}
+
+	firstThreadCache = &threadCache;
+	return &threadCache;
+}
+
+void ThreadCachingAllocator::ReleaseThreadCache(ThreadCache& threadCache) {
+	FlushThreadCache(threadCache);
+
+	std::scoped_lock lock(threadCacheMutex);
+	uncachedSmallUsedSize.fetch_add(threadCache.smallUsedSize.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	if (threadCache.previousCache != nullptr) {
+		threadCache.previousCache->nextCache = threadCache.nextCache;
+	}
+	else {
+		firstThreadCache = threadCache.nextCache;
+	}
+
+	if (threadCache.nextCache != nullptr) {
+		threadCache.nextCache->previousCache = threadCache.previousCache;
+	}
+
+	threadCache.Reset();
+}
+
+void ThreadCachingAllocator::FlushThreadCache(ThreadCache& threadCache) {
+	for (size_t sizeClassIndex = 0; sizeClassIndex < sizeClassCount; ++sizeClassIndex) {
+		ThreadCache::SizeClassCache& sizeClassCache = threadCache.sizeClassCaches[sizeClassIndex];
+		if (sizeClassCache.firstBlock == nullptr) {
+			continue;
+		}
+
+		FreeBlock* lastBlock = sizeClassCache.firstBlock;
+		while (lastBlock->nextBlock != nullptr) {
+			lastBlock = lastBlock->nextBlock;
+		}
+
+		ReturnBlocks(sizeClassIndex, sizeClassCache.firstBlock, lastBlock, sizeClassCache.blockCount);
+		sizeClassCache = ThreadCache::SizeClassCache{};
+	}
+}
+
+void* ThreadCachingAllocator::AllocateSmall(size_t sizeClassIndex) {
+	const int64_t blockSize = static_cast<int64_t>(sizeClasses[sizeClassIndex]);
+	ThreadCache* threadCache = GetThreadCache();
+	if (threadCache == nullptr) {
+		FreeBlock* block = nullptr;
+		if (FetchBlocks(sizeClassIndex, 1, block) == 0) {
+			return nullptr;
+		}
+
+		uncachedSmallUsedSize.fetch_add(blockSize, std::memory_order_relaxed);
+		return block;
+	}
+
+	ThreadCache::SizeClassCache& sizeClassCache = threadCache->sizeClassCaches[sizeClassIndex];
+	if (sizeClassCache.firstBlock == nullptr) {
+		sizeClassCache.blockCount = FetchBlocks(sizeClassIndex, GetBatchSize(sizeClassIndex), sizeClassCache.firstBlock);
+		if (sizeClassCache.blockCount == 0) {
+			return nullptr;
+		}
+	}
+
+	FreeBlock* block = sizeClassCache.firstBlock;
+	sizeClassCache.firstBlock = block->nextBlock;
+	--sizeClassCache.blockCount;
+
+	const int64_t smallUsedSize = threadCache->smallUsedSize.load(std::memory_order_relaxed);
+	threadCache->smallUsedSize.store(smallUsedSize + blockSize, std::memory_order_relaxed);
+	return block;
+}
+
+void ThreadCachingAllocator::FreeSmall(void* memPtr, size_t sizeClassIndex) {
+	const int64_t blockSize = static_cast<int64_t>(sizeClasses[sizeClassIndex]);
+	FreeBlock* block = static_cast<FreeBlock*>(memPtr);
+	ThreadCache* threadCache = GetThreadCache();
+	if (threadCache == nullptr) {
+		block->nextBlock = nullptr;
+		ReturnBlocks(sizeClassIndex, block, block, 1);
+		uncachedSmallUsedSize.fetch_sub(blockSize, std::memory_order_relaxed);
+		return;
+	}
+
+	ThreadCache::SizeClassCache& sizeClassCache = threadCache->sizeClassCaches[sizeClassIndex];
+	block->nextBlock = sizeClassCache.firstBlock;
+	sizeClassCache.firstBlock = block;
+	++sizeClassCache.blockCount;
+
+	const int64_t smallUsedSize = threadCache->smallUsedSize.load(std::memory_order_relaxed);
+	threadCache->smallUsedSize.store(smallUsedSize - blockSize, std::memory_order_relaxed);
+
+	// Keep a batch around for the next allocations, and hand the rest back in one go.
+	const size_t batchSize = GetBatchSize(sizeClassIndex);
+	if (sizeClassCache.blockCount >= batchSize * 2) {
+		FreeBlock* firstReturnedBlock = sizeClassCache.firstBlock;
+		FreeBlock* lastReturnedBlock = firstReturnedBlock;
+		for (size_t i = 1; i < batchSize; ++i) {
+			lastReturnedBlock = lastReturnedBlock->nextBlock;
+		}
+
+		sizeClassCache.firstBlock = lastReturnedBlock->nextBlock;
+		sizeClassCache.blockCount -= batchSize;
+		lastReturnedBlock->nextBlock = nullptr;
+		ReturnBlocks(sizeClassIndex, firstReturnedBlock, lastReturnedBlock, batchSize);
+	}
+}
+
+size_t ThreadCachingAllocator::FetchBlocks(size_t sizeClassIndex, size_t maxBlockCount, FreeBlock*& outFirstBlock) {
+	CentralFreeList& centralFreeList = centralFreeLists[sizeClassIndex];
+	std::scoped_lock lock(centralFreeList.mutex);
+
+	if (centralFreeList.firstBlock == nullptr && !CarveSpan(sizeClassIndex, centralFreeList)) {
+		outFirstBlock = nullptr;
+		return 0;
+	}
+
+	FreeBlock* firstBlock = centralFreeList.firstBlock;
+	FreeBlock* lastBlock = firstBlock;
+	size_t blockCount = 1;
+	while (blockCount < maxBlockCount && lastBlock->nextBlock != nullptr) {
+		lastBlock = lastBlock->nextBlock;
+		++blockCount;
+	}
+
+	centralFreeList.firstBlock = lastBlock->nextBlock;
+	centralFreeList.blockCount -= blockCount;
+	lastBlock->nextBlock = nullptr;
+
+	outFirstBlock = firstBlock;
+	return blockCount;
+}
+
+void ThreadCachingAllocator::ReturnBlocks(size_t sizeClassIndex, FreeBlock* firstBlock, FreeBlock* lastBlock, size_t blockCount) {
+	CentralFreeList& centralFreeList = centralFreeLists[sizeClassIndex];
+	std::scoped_lock lock(centralFreeList.mutex);
+	lastBlock->nextBlock = centralFreeList.firstBlock;
+	centralFreeList.firstBlock = firstBlock;
+	centralFreeList.blockCount += blockCount;
+}
+
+// Spans are taken from chunks of several spans at once, since aligning every span separately
+// would waste up to a span's worth of padding in the backing allocator each time.
+bool ThreadCachingAllocator::CarveSpan(size_t sizeClassIndex, CentralFreeList& centralFreeList) {
+	char* span = nullptr;
+	{
+		std::scoped_lock lock(backingAllocatorMutex);
+		if (nextFreeSpan == spanChunkEnd) {
+			const size_t usedSizeBeforeChunk = backingAllocator.GetUsedSize();
+			void* spanChunk = backingAllocator.AllocateRaw(spanSize * spansPerChunk, spanSize, "Small Block Spans");
+			if (spanChunk == nullptr) {
+				GPRINT_ERROR(Grindstone::LogSource::EngineCore, "Out of memory for small block spans.");
+				return false;
+			}
+
+			reservedSpanSize += backingAllocator.GetUsedSize() - usedSizeBeforeChunk;
+			spanChunks.push_back(spanChunk);
+			nextFreeSpan = static_cast<char*>(spanChunk);
+			spanChunkEnd = nextFreeSpan + spanSize * spansPerChunk;
+		}
+
+		span = nextFreeSpan;
+		nextFreeSpan += spanSize;
+	}
+
+	const size_t spanPageIndex = reinterpret_cast<uintptr_t>(span) / spanSize - firstSpanPage;
+	spanPageSizeClasses[spanPageIndex].store(static_cast<uint8_t>(sizeClassIndex + 1), std::memory_order_release);
+
+	const size_t blockSize = sizeClasses[sizeClassIndex];
+	const size_t blockCount = spanSize / blockSize;
+	for (size_t i = 0; i < blockCount; ++i) {
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(span + i * blockSize);
+		block->nextBlock = (i + 1 < blockCount)
+			? reinterpret_cast<FreeBlock*>(span + (i + 1) * blockSize)
+			: centralFreeList.firstBlock;
+	}
+
+	centralFreeList.firstBlock = reinterpret_cast<FreeBlock*>(span);
+	centralFreeList.blockCount += blockCount;
+	return true;
+}
+
+// Spans fill their whole page, so a pointer in a span page can only be one of its blocks.
+size_t ThreadCachingAllocator::GetSpanSizeClass(const void* memPtr) const {
+	const uintptr_t page = reinterpret_cast<uintptr_t>(memPtr) / spanSize;
+	if (page < firstSpanPage || page - firstSpanPage >= spanPageCount) {
+		return notASpanPage;
+	}
+
+	return spanPageSizeClasses[page - firstSpanPage].load(std::memory_order_acquire);
+}
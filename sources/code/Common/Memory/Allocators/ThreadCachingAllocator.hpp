@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+#include "../SmartPointers.hpp"
+#include "DynamicAllocator.hpp"
+
+namespace Grindstone::Memory::Allocators {
+	/**
+	 * \brief A thread-safe front end for a DynamicAllocator.
+	 *
+	 * Small allocations are served from per-thread caches of size-classed blocks. The blocks are carved
+	 * out of spans taken from the backing DynamicAllocator, and kept in a central free list per size class.
+	 * Threads refill and flush their caches in batches, so the central locks are only taken once per batch.
+	 * A block freed on another thread goes into that thread's cache, and only returns to the central list
+	 * once that cache overflows. Large or overaligned allocations go to the backing allocator under a lock.
+	 */
+	class ThreadCachingAllocator {
+	public:
+		static constexpr size_t sizeClassCount = 12;
+		static constexpr size_t sizeClasses[sizeClassCount] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+		static constexpr size_t maxSmallSize = 1024;
+		static constexpr size_t maxSmallAlignment = 16;
+		static constexpr size_t spanSize = 64 * 1024;
+		static constexpr size_t spansPerChunk = 16;
+
+		struct FreeBlock {
+			FreeBlock* nextBlock;
+		};
+
+		struct ThreadCache;
+
+		ThreadCachingAllocator() = default;
+		ThreadCachingAllocator(const ThreadCachingAllocator&) = delete;
+		ThreadCachingAllocator& operator=(const ThreadCachingAllocator&) = delete;
+		~ThreadCachingAllocator();
+
+		bool Initialize(size_t size);
+
+		void* AllocateRaw(size_t size, size_t alignment, const char* debugName);
+		bool Free(void* memPtr);
+
+		// Returns every block cached by the calling thread to the central free lists.
+		void FlushThreadCache();
+
+		bool IsEmpty() const;
+
+		size_t GetTotalMemorySize() const;
+		// Includes the spans reserved for small blocks, whether they are in use or not.
+		size_t GetPeakSize() const;
+		size_t GetUsedSize() const;
+
+		// The backing allocator is not thread-safe, so hold this mutex while inspecting it.
+		std::mutex& GetBackingAllocatorMutex();
+		DynamicAllocator& GetBackingAllocator();
+
+		template<typename T>
+		Grindstone::SharedPtr<T> MakeShared(T* ptr) {
+			return Grindstone::SharedPtr<T>(ptr, deleterFn);
+		}
+
+		template<typename T>
+		Grindstone::UniquePtr<T> MakeUnique(T* ptr) {
+			return Grindstone::UniquePtr<T>(ptr, deleterFn);
+		}
+
+		template<typename T, typename... Args>
+		Grindstone::SharedPtr<T> AllocateShared(Args&&... params) {
+			static_assert(std::is_constructible_v<T, Args...>, "Type T must be constructible with given arguments.");
+
+			T* ptr = static_cast<T*>(AllocateRaw(sizeof(T), alignof(T), typeid(T).name()));
+			if (ptr != nullptr) {
+				// Call the constructor on the newly allocated memory
+				new (ptr) T(std::forward<Args>(params)...);
+			}
+
+			return Grindstone::SharedPtr<T>(ptr, deleterFn);
+		}
+
+		template<typename T, typename... Args>
+		Grindstone::UniquePtr<T> AllocateUnique(Args&&... params) {
+			static_assert(std::is_constructible_v<T, Args...>, "Type T must be constructible with given arguments.");
+
+			T* ptr = static_cast<T*>(AllocateRaw(sizeof(T), alignof(T), typeid(T).name()));
+			if (ptr != nullptr) {
+				// Call the constructor on the newly allocated memory
+				new (ptr) T(std::forward<Args>(params)...);
+			}
+
+			return Grindstone::UniquePtr<T>(ptr, deleterFn);
+		}
+
+	private:
+		struct CentralFreeList {
+			std::mutex mutex;
+			FreeBlock* firstBlock = nullptr;
+			size_t blockCount = 0;
+		};
+
+		friend struct ThreadCache;
+
+		ThreadCache* GetThreadCache();
+		void ReleaseThreadCache(ThreadCache& threadCache);
+		void FlushThreadCache(ThreadCache& threadCache);
+
+		void* AllocateSmall(size_t sizeClassIndex);
+		void FreeSmall(void* memPtr, size_t sizeClassIndex);
+		size_t FetchBlocks(size_t sizeClassIndex, size_t maxBlockCount, FreeBlock*& outFirstBlock);
+		void ReturnBlocks(size_t sizeClassIndex, FreeBlock* firstBlock, FreeBlock* lastBlock, size_t blockCount);
+		bool CarveSpan(size_t sizeClassIndex, CentralFreeList& centralFreeList);
+		size_t GetSpanSizeClass(const void* memPtr) const;
+
+		DynamicAllocator backingAllocator;
+		mutable std::mutex backingAllocatorMutex;
+		std::function<void(void*)> deleterFn;
+
+		CentralFreeList centralFreeLists[sizeClassCount];
+
+		// One entry per spanSize-aligned page of the backing memory. Zero means the page isn't a span,
+		// otherwise it's the size class index of the span's blocks plus one.
+		std::unique_ptr<std::atomic<uint8_t>[]> spanPageSizeClasses;
+		uintptr_t firstSpanPage = 0;
+		size_t spanPageCount = 0;
+
+		// Guarded by backingAllocatorMutex.
+		std::vector<void*> spanChunks;
+		char* nextFreeSpan = nullptr;
+		char* spanChunkEnd = nullptr;
+		size_t reservedSpanSize = 0;
+
+		mutable std::mutex threadCacheMutex;
+		ThreadCache* firstThreadCache = nullptr;
+		// Small allocation sizes from threads that have no cache, or whose cache has been released.
+		std::atomic<int64_t> uncachedSmallUsedSize = 0;
+	};
+
+	struct ThreadCachingAllocator::ThreadCache {
+		struct SizeClassCache {
+			FreeBlock* firstBlock = nullptr;
+			size_t blockCount = 0;
+		};
+
+		~ThreadCache();
+		void Reset();
+
+		ThreadCachingAllocator* owner = nullptr;
+		ThreadCache* previousCache = nullptr;
+		ThreadCache* nextCache = nullptr;
+		SizeClassCache sizeClassCaches[sizeClassCount];
+		// Only written by the owning thread. It goes negative when this thread frees other threads' blocks.
+		std::atomic<int64_t> smallUsedSize = 0;
+	};
+}
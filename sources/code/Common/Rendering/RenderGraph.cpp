@@ -1,7 +1,10 @@
+#include <algorithm>
+
 #include <Common/Rendering/RenderGraph.hpp>
 #include <Common/Graphics/Core.hpp>
 #include <Common/Window/WindowManager.hpp>
 #include <EngineCore/EngineCore.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
 
 #include "RenderGraphFrameResources.hpp"
 
@@ -9,10 +12,168 @@
 // - RenderPassExecution
 // ===============================================================
 
+static bool HasWriteAccess(Grindstone::GraphicsAPI::AccessFlags accessFlags) {
+	using Grindstone::GraphicsAPI::AccessFlags;
+
+	const AccessFlags writeAccessFlags =
+		AccessFlags::ShaderWrite |
+		AccessFlags::ColorAttachmentWrite |
+		AccessFlags::DepthStencilAttachmentWrite |
+		AccessFlags::TransferWrite |
+		AccessFlags::HostWrite |
+		AccessFlags::MemoryWrite |
+		AccessFlags::TransformFeedbackWrite |
+		AccessFlags::TransformFeedbackCounterWrite |
+		AccessFlags::AccelerationStructureWrite |
+		AccessFlags::CommandPreprocessWrite;
+
+	return Any(accessFlags & writeAccessFlags);
+}
+
+bool Grindstone::Renderer::IsBarrierRequired(
+	Grindstone::GraphicsAPI::ImageLayout oldLayout,
+	Grindstone::GraphicsAPI::AccessFlags oldAccessFlags,
+	Grindstone::GraphicsAPI::ImageLayout newLayout,
+	Grindstone::GraphicsAPI::AccessFlags newAccessFlags
+) {
+	return oldLayout != newLayout || HasWriteAccess(oldAccessFlags) || HasWriteAccess(newAccessFlags);
+}
+
 Grindstone::Renderer::RenderGraph::RenderGraph(
+	size_t topologyHash,
+	std::vector<PassId>&& sortedPassIds,
+	std::vector<Grindstone::UniquePtr<Grindstone::Renderer::RenderGraphPass>>&& passes,
+	std::vector<Grindstone::Renderer::RenderGraphDependencyLevel>&& dependencyLevels,
+	const std::vector<UnionResourceDescription>& resourceDescriptions,
+	std::vector<TransientResourceLifetime>&& resourceLifetimes
+) :	isCompiled(true),
+	topologyHash(topologyHash),
+	sortedPassIds(std::move(sortedPassIds)),
+	passes(std::move(passes)),
+	dependencyLevels(std::move(dependencyLevels)),
+	resourceDescriptions(resourceDescriptions),
+	resourceLifetimes(std::move(resourceLifetimes)) {
+	for (ResourceId id = 0; id < this->resourceLifetimes.size(); ++id) {
+		if (this->resourceLifetimes[id].IsUsed()) {
+			resourceAcquireOrder.push_back(id);
+		}
+	}
+
+	std::stable_sort(
+		resourceAcquireOrder.begin(), resourceAcquireOrder.end(),
+		[this](ResourceId lhs, ResourceId rhs) {
+			return this->resourceLifetimes[lhs].firstLevel < this->resourceLifetimes[rhs].firstLevel;
+		}
+	);
+}
+
+void Grindstone::Renderer::RenderGraph::Rebind(
 	std::vector<Grindstone::UniquePtr<Grindstone::Renderer::RenderGraphPass>>&& passes,
 	const std::vector<UnionResourceDescription>& resourceDescriptions
-) : passes(std::move(passes)), resourceDescriptions(resourceDescriptions) {
+) {
+	GS_ASSERT(passes.size() == sortedPassIds.size());
+	GS_ASSERT(resourceDescriptions.size() == resourceLifetimes.size());
+
+	this->passes = std::move(passes);
+	this->resourceDescriptions = resourceDescriptions;
+}
+
+bool Grindstone::Renderer::RenderGraph::IsCompiled() const {
+	return isCompiled;
+}
+
+size_t Grindstone::Renderer::RenderGraph::GetTopologyHash() const {
+	return topologyHash;
+}
+
+const std::vector<Grindstone::Renderer::PassId>& Grindstone::Renderer::RenderGraph::GetSortedPassIds() const {
+	return sortedPassIds;
+}
+
+const std::vector<Grindstone::Renderer::RenderGraphDependencyLevel>& Grindstone::Renderer::RenderGraph::GetDependencyLevels() const {
+	return dependencyLevels;
+}
+
+void Grindstone::Renderer::RenderGraph::SubmitTransitions(
+	Grindstone::Renderer::RenderGraphContext& context,
+	Grindstone::Renderer::RenderGraphFrameResources& frameResources,
+	const Grindstone::Renderer::RenderGraphDependencyLevel& dependencyLevel
+) {
+	Grindstone::Memory::AllocatorCore::FrameVector<GraphicsAPI::ImageBarrier> imageBarriers;
+	Grindstone::Memory::AllocatorCore::FrameVector<GraphicsAPI::BufferBarrier> bufferBarriers;
+
+	for (const RenderGraphResourceTransition& transition : dependencyLevel.transitions) {
+		if (transition.isBuffer) {
+			auto [prevAccessFlags, prevPipelineStage] = frameResources.GetBufferAccess(transition.resourceId);
+
+			// Buffers have no layout, so reads after reads only need their stages tracked.
+			if (!IsBarrierRequired(GraphicsAPI::ImageLayout::Undefined, prevAccessFlags, GraphicsAPI::ImageLayout::Undefined, transition.accessFlags)) {
+				frameResources.SetBufferAccess(transition.resourceId, prevAccessFlags | transition.accessFlags, prevPipelineStage | transition.pipelineStage);
+				continue;
+			}
+
+			const Grindstone::Renderer::BufferDescription& desc = std::get<Grindstone::Renderer::BufferDescription>(resourceDescriptions[transition.resourceId]);
+			bufferBarriers.emplace_back(
+				Grindstone::GraphicsAPI::BufferBarrier{
+					.buffer = frameResources.GetBuffer(transition.resourceId),
+					.srcStageMask = prevPipelineStage == GraphicsAPI::PipelineStageBit::None
+						? GraphicsAPI::PipelineStageBit::TopOfPipe
+						: prevPipelineStage,
+					.dstStageMask = transition.pipelineStage,
+					.srcAccess = prevAccessFlags,
+					.dstAccess = transition.accessFlags,
+					.offset = 0,
+					.size = static_cast<uint32_t>(desc.size)
+				}
+			);
+
+			frameResources.SetBufferAccess(transition.resourceId, transition.accessFlags, transition.pipelineStage);
+			continue;
+		}
+
+		auto [prevLayout, prevAccessFlags, prevPipelineStage] = frameResources.GetLayout(transition.resourceId);
+		if (!IsBarrierRequired(prevLayout, prevAccessFlags, transition.layout, transition.accessFlags)) {
+			frameResources.SetLayout(transition.resourceId, prevLayout, prevAccessFlags | transition.accessFlags, prevPipelineStage | transition.pipelineStage);
+			continue;
+		}
+
+		Grindstone::GraphicsAPI::Image* image = frameResources.GetImage(transition.resourceId);
+		Grindstone::GraphicsAPI::ImageAspectBits imageAspect = Any(GraphicsAPI::GetFormatDepthStencilType(image->GetFormat()) & GraphicsAPI::FormatDepthStencilType::Depth)
+			? Grindstone::GraphicsAPI::ImageAspectBits::Depth
+			: Grindstone::GraphicsAPI::ImageAspectBits::Color;
+
+		imageBarriers.emplace_back(
+			Grindstone::GraphicsAPI::ImageBarrier{
+				.image = image,
+				.srcStageMask = prevPipelineStage == GraphicsAPI::PipelineStageBit::None
+					? GraphicsAPI::PipelineStageBit::TopOfPipe
+					: prevPipelineStage,
+				.dstStageMask = transition.pipelineStage,
+				.oldLayout = prevLayout,
+				.newLayout = transition.layout,
+				.srcAccess = prevAccessFlags,
+				.dstAccess = transition.accessFlags,
+				.imageAspect = imageAspect,
+				.baseMipLevel = 0,
+				.levelCount = 1,
+				.baseArrayLayer = 0,
+				.layerCount = 1
+			}
+		);
+
+		frameResources.SetLayout(transition.resourceId, transition.layout, transition.accessFlags, transition.pipelineStage);
+	}
+
+	if (imageBarriers.empty() && bufferBarriers.empty()) {
+		return;
+	}
+
+	context.commandBuffer->PipelineBarrier(
+		bufferBarriers.data(),
+		static_cast<uint32_t>(bufferBarriers.size()),
+		imageBarriers.data(),
+		static_cast<uint32_t>(imageBarriers.size())
+	);
 }
 
 void Grindstone::Renderer::RenderGraph::ExecuteGraph(Grindstone::Renderer::RenderGraphContext context) {
@@ -22,7 +183,7 @@ void Grindstone::Renderer::RenderGraph::ExecuteGraph(Grindstone::Renderer::Rende
 	// Build this frame's ResourceId -> physical mapping
 	Grindstone::Renderer::RenderGraphFrameResources frameResources;
 
-	for (ResourceId id = 0; id < resourceDescriptions.size(); ++id) {
+	for (ResourceId id : resourceAcquireOrder) {
 		const Grindstone::Renderer::UnionResourceDescription& entry = resourceDescriptions[id];
 
 		if (std::holds_alternative<Grindstone::Renderer::ImageDescription>(entry)) {
@@ -59,28 +220,38 @@ void Grindstone::Renderer::RenderGraph::ExecuteGraph(Grindstone::Renderer::Rende
 						}
 					}
 				}
-				TransientImageKey key = resourceManager->AcquireImage(viewport, context.swapchainSize, desc);
+				TransientImageKey key = resourceManager->AcquireImage(viewport, context.swapchainSize, desc, resourceLifetimes[id]);
 				frameResources.imageKeys[id] = key;
 			}
 		}
 		else {
 			const Grindstone::Renderer::BufferDescription& desc = std::get<Grindstone::Renderer::BufferDescription>(entry);
-			TransientBufferKey key = resourceManager->AcquireBuffer(desc);
+			TransientBufferKey key = resourceManager->AcquireBuffer(desc, resourceLifetimes[id]);
 			frameResources.bufferKeys[id] = key;
 		}
 	}
 
 	frameResources.RealizeKeys(context.transientResourceManager);
 
-	for (auto& pass : passes) {
-		pass->RealizeResources(context, frameResources);
-		pass->Execute(context, frameResources);
+	size_t passIndex = 0;
+	for (const RenderGraphDependencyLevel& dependencyLevel : dependencyLevels) {
+		SubmitTransitions(context, frameResources, dependencyLevel);
+
+		for (uint32_t i = 0; i < dependencyLevel.passCount; ++i) {
+			Grindstone::UniquePtr<RenderGraphPass>& pass = passes[passIndex++];
+			pass->RealizeResources(context, frameResources);
+			pass->Execute(context, frameResources);
+		}
 	}
 
 	std::vector<GraphicsAPI::ImageBarrier> finalImageBarriers;
 	std::vector<GraphicsAPI::BufferBarrier> finalBufferBarriers;
 
 	for (ResourceId id = 0; id < resourceDescriptions.size(); ++id) {
+		if (!resourceLifetimes[id].IsUsed()) {
+			continue;
+		}
+
 		const Grindstone::Renderer::UnionResourceDescription& entry = resourceDescriptions[id];
 
 		if (std::holds_alternative<Grindstone::Renderer::ImageDescription>(entry)) {
@@ -26,18 +26,79 @@ namespace Grindstone::GraphicsAPI {
 }
 
 namespace Grindstone::Renderer {
+	// The state a pass needs one of its resources in before it runs. Buffers have no layout.
+	struct RenderGraphResourceTransition {
+		Grindstone::Renderer::ResourceId resourceId;
+		bool isBuffer;
+		Grindstone::GraphicsAPI::ImageLayout layout;
+		Grindstone::GraphicsAPI::AccessFlags accessFlags;
+		Grindstone::GraphicsAPI::PipelineStageBit pipelineStage;
+	};
+
+	// A run of consecutive passes that don't depend on each other. Every transition they need is
+	// submitted as a single barrier before the first of them runs.
+	struct RenderGraphDependencyLevel {
+		uint32_t passCount = 0;
+		std::vector<Grindstone::Renderer::RenderGraphResourceTransition> transitions;
+	};
+
+	// Reads following reads in the same layout can share the resource without synchronizing.
+	bool IsBarrierRequired(
+		Grindstone::GraphicsAPI::ImageLayout oldLayout,
+		Grindstone::GraphicsAPI::AccessFlags oldAccessFlags,
+		Grindstone::GraphicsAPI::ImageLayout newLayout,
+		Grindstone::GraphicsAPI::AccessFlags newAccessFlags
+	);
+
 	class RenderGraph {
 	public:
 		using ResourceId = size_t;
 
 		RenderGraph() = default;
-		RenderGraph(std::vector<Grindstone::UniquePtr<Grindstone::Renderer::RenderGraphPass>>&& passes, const std::vector<Grindstone::Renderer::UnionResourceDescription>& resourceDescriptions);
+		RenderGraph(
+			size_t topologyHash,
+			std::vector<Grindstone::Renderer::PassId>&& sortedPassIds,
+			std::vector<Grindstone::UniquePtr<Grindstone::Renderer::RenderGraphPass>>&& passes,
+			std::vector<Grindstone::Renderer::RenderGraphDependencyLevel>&& dependencyLevels,
+			const std::vector<Grindstone::Renderer::UnionResourceDescription>& resourceDescriptions,
+			std::vector<Grindstone::Renderer::TransientResourceLifetime>&& resourceLifetimes
+		);
 		void ExecuteGraph(Grindstone::Renderer::RenderGraphContext context);
 
+		// Replaces the passes and resource descriptions with another frame's, built from the same topology.
+		// The pass order, barriers and resource lifetimes compiled for that topology are kept.
+		void Rebind(
+			std::vector<Grindstone::UniquePtr<Grindstone::Renderer::RenderGraphPass>>&& passes,
+			const std::vector<Grindstone::Renderer::UnionResourceDescription>& resourceDescriptions
+		);
+
+		bool IsCompiled() const;
+		size_t GetTopologyHash() const;
+		// The builder's ids of the compiled passes, in the order they execute.
+		const std::vector<Grindstone::Renderer::PassId>& GetSortedPassIds() const;
+		// The levels the sorted passes are grouped into, with the transitions submitted before each.
+		const std::vector<Grindstone::Renderer::RenderGraphDependencyLevel>& GetDependencyLevels() const;
+
 	protected:
 
+		void SubmitTransitions(
+			Grindstone::Renderer::RenderGraphContext& context,
+			Grindstone::Renderer::RenderGraphFrameResources& frameResources,
+			const Grindstone::Renderer::RenderGraphDependencyLevel& dependencyLevel
+		);
+
+		bool isCompiled = false;
+		size_t topologyHash = 0;
+		std::vector<Grindstone::Renderer::PassId> sortedPassIds;
+
+		// Passes are sorted by dependency level, in the order of dependencyLevels.
 		std::vector<Grindstone::UniquePtr<Grindstone::Renderer::RenderGraphPass>> passes;
+		std::vector<Grindstone::Renderer::RenderGraphDependencyLevel> dependencyLevels;
 		std::vector<Grindstone::Renderer::UnionResourceDescription> resourceDescriptions;
+		// Resources only used by culled passes are never acquired. Transient resources are acquired in
+		// order of their first level, so ones whose lifetimes don't overlap can share pooled resources.
+		std::vector<Grindstone::Renderer::TransientResourceLifetime> resourceLifetimes;
+		std::vector<Grindstone::Renderer::ResourceId> resourceAcquireOrder;
 
 	};
 }
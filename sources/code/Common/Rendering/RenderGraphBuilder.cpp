@@ -1,6 +1,9 @@
+#include <algorithm>
+
 #include <EngineCore/EngineCore.hpp>
 #include <EngineCore/Logger.hpp>
 #include <Common/Graphics/Core.hpp>
+#include <Common/Hash.hpp>
 
 #include "TransientResourceManager.hpp"
 #include "RenderGraphBuilder.hpp"
@@ -11,14 +14,14 @@ using namespace Grindstone::Renderer;
 // - Setup Phase
 // ===============================================================
 
-// TODO: These should be allocated on a linear allocator.
+// Builder passes only live until the graph is compiled, so they are allocated on the frame arena.
 
 TransferRenderGraphBuilderPass* RenderGraphBuilder::CreateTransferPass(
 	Grindstone::StringRef name,
 	std::function<void(TransferRenderGraphBuilderPass&)> setupImmediateCallback
 ) {
 	uint32_t passIndex = static_cast<uint32_t>(passes.size());
-	auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateUnique<TransferRenderGraphBuilderPass>());
+	auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateFrameUnique<TransferRenderGraphBuilderPass>());
 	auto pass = static_cast<TransferRenderGraphBuilderPass*>(uniquePtr.Get());
 	pass->name = name;
 	pass->type = GpuPassType::Transfer;
@@ -31,7 +34,7 @@ TransferRenderGraphBuilderPass* RenderGraphBuilder::CreateTransferPass(
 const char* presentPassName = "Present to Screen";
 PresentRenderGraphBuilderPass* RenderGraphBuilder::CreatePresentPass(RenderGraphBuilderResourceRef imageRef) {
 	uint32_t passIndex = static_cast<uint32_t>(passes.size());
-	auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateUnique<PresentRenderGraphBuilderPass>());
+	auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateFrameUnique<PresentRenderGraphBuilderPass>());
 	auto pass = static_cast<PresentRenderGraphBuilderPass*>(uniquePtr.Get());
 	pass->name = presentPassName;
 	pass->type = GpuPassType::Present;
@@ -45,7 +48,7 @@ void RenderGraphBuilder::CreatePresentPass(
 	std::function<void(PresentRenderGraphBuilderPass&)> setupImmediateCallback
 ) {
 	uint32_t passIndex = static_cast<uint32_t>(passes.size());
-	auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateUnique<PresentRenderGraphBuilderPass>());
+	auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateFrameUnique<PresentRenderGraphBuilderPass>());
 	auto pass = static_cast<PresentRenderGraphBuilderPass*>(uniquePtr.Get());
 	pass->name = presentPassName;
 	pass->type = GpuPassType::Present;
@@ -60,165 +63,528 @@ void RenderGraphBuilder::CreatePresentPass(
 
 using RenderGraphPassList = std::vector<Grindstone::UniquePtr<RenderGraphBuilderPass>>;
 
-static void SetupBarriers();
-static bool OptimizeRenderGraph(
-	const RenderGraphPassList& passes,
-	std::vector<PassId>& sortedAndCulledPasses
-);
-static void RealizeResources();
-static void SetupAttachments();
-static void CreatePasses(
-	const RenderGraphPassList& passes,
-	const std::vector<PassId>& sortedPassesIndices,
-	std::vector<Grindstone::UniquePtr<RenderGraphPass>>& compiledPasses
-);
+// How a pass uses one of its resources, and the state it needs that resource in.
+struct PassResourceUsage {
+	RenderGraphResourceTransition state;
+	bool isRead;
+	bool isWrite;
+};
 
-RenderGraphBuilderResourceRef RenderGraphBuilder::AddImage(ImageDescription imageDesc, Renderer::PassId passId) {
-	size_t imageIndex = resources.size();
-	resources.emplace_back(imageDesc);
+using PassUsageList = std::vector<PassResourceUsage>;
+using PassIdList = std::vector<PassId>;
 
-	return {
-		.resourceIndex = static_cast<Renderer::ResourceId>(imageIndex),
-		.passIndex = passId
-	};
+struct ImageUsageSyncInfo {
+	Grindstone::GraphicsAPI::PipelineStageBit stageMask;
+	Grindstone::GraphicsAPI::AccessFlags accessMask;
+	Grindstone::GraphicsAPI::ImageLayout layout;
+};
+
+static Grindstone::GraphicsAPI::PipelineStageBit DeriveShaderStageMask(Grindstone::GraphicsAPI::ShaderStageBit visibility) {
+	Grindstone::GraphicsAPI::PipelineStageBit mask = Grindstone::GraphicsAPI::PipelineStageBit::None;
+
+	if (static_cast<uint8_t>(visibility) & static_cast<uint8_t>(Grindstone::GraphicsAPI::ShaderStageBit::Vertex))
+		mask |= Grindstone::GraphicsAPI::PipelineStageBit::VertexShader;
+
+	if (static_cast<uint8_t>(visibility) & static_cast<uint8_t>(Grindstone::GraphicsAPI::ShaderStageBit::Fragment))
+		mask |= Grindstone::GraphicsAPI::PipelineStageBit::FragmentShader;
+
+	if (static_cast<uint8_t>(visibility) & static_cast<uint8_t>(Grindstone::GraphicsAPI::ShaderStageBit::Compute))
+		mask |= Grindstone::GraphicsAPI::PipelineStageBit::ComputeShader;
+
+	return mask;
 }
 
-RenderGraphBuilderResourceRef RenderGraphBuilder::AddBuffer(BufferDescription bufferDesc, Renderer::PassId passId) {
-	size_t bufferIndex = resources.size();
-	resources.emplace_back(bufferDesc);
+static Grindstone::GraphicsAPI::ImageLayout DeriveDepthStencilLayout(
+	bool isDepth, bool isStencil,
+	bool isRead, bool isWrite
+) {
+	// TODO: Fix Stencil and DepthStencil variatns
+	if (isDepth && isStencil) {
+		if (isRead && !isWrite) return Grindstone::GraphicsAPI::ImageLayout::DepthRead;
+		return Grindstone::GraphicsAPI::ImageLayout::DepthWrite;
+	}
 
-	return {
-		.resourceIndex = static_cast<Renderer::ResourceId>(bufferIndex),
-		.passIndex = passId
-	};
+	if (isDepth) {
+		if (isRead && !isWrite) return Grindstone::GraphicsAPI::ImageLayout::DepthRead;
+		return Grindstone::GraphicsAPI::ImageLayout::DepthWrite;
+	}
+
+	if (isStencil) {
+		if (isRead && !isWrite) return Grindstone::GraphicsAPI::ImageLayout::DepthRead;
+		return Grindstone::GraphicsAPI::ImageLayout::DepthWrite;
+	}
+
+	return Grindstone::GraphicsAPI::ImageLayout::Undefined;
 }
 
-RenderGraph RenderGraphBuilder::Compile() const {
-	Grindstone::EngineCore& engineCore = Grindstone::EngineCore::GetInstance();
-	Grindstone::GraphicsAPI::Core* graphicsCore = engineCore.GetGraphicsCore();
+static ImageUsageSyncInfo DeriveImageSyncInfo(
+	RenderGraphImageUsage usage,
+	Grindstone::GraphicsAPI::ShaderStageBit visibility = Grindstone::GraphicsAPI::ShaderStageBit::AllGraphics
+) {
+	const bool isRead = Any(usage & RenderGraphImageUsage::Read);
+	const bool isWrite = Any(usage & RenderGraphImageUsage::Write);
+	const bool isSampled = Any(usage & RenderGraphImageUsage::Sampled);
+	const bool isStorage = Any(usage & RenderGraphImageUsage::Storage);
+	const bool isColor = Any(usage & RenderGraphImageUsage::ColorAttachment);
+	const bool isDepth = Any(usage & RenderGraphImageUsage::DepthAttachment);
+	const bool isStencil = Any(usage & RenderGraphImageUsage::StencilAttachment);
+	const bool isSubpassInput = Any(usage & RenderGraphImageUsage::SubpassInputAttachment);
+	const bool isTransfer = Any(usage & RenderGraphImageUsage::Transfer);
+
+	Grindstone::GraphicsAPI::PipelineStageBit stageMask = Grindstone::GraphicsAPI::PipelineStageBit::None;
+	Grindstone::GraphicsAPI::AccessFlags accessMask = Grindstone::GraphicsAPI::AccessFlags::None;
+	Grindstone::GraphicsAPI::ImageLayout layout = Grindstone::GraphicsAPI::ImageLayout::Undefined;
+
+	// Transfer
+	if (isTransfer) {
+		if (isRead) {
+			stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::Transfer;
+			accessMask |= Grindstone::GraphicsAPI::AccessFlags::TransferRead;
+			layout = Grindstone::GraphicsAPI::ImageLayout::TransferSrc;
+		}
+		if (isWrite) {
+			stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::Transfer;
+			accessMask |= Grindstone::GraphicsAPI::AccessFlags::TransferWrite;
+			layout = Grindstone::GraphicsAPI::ImageLayout::TransferDst;
+		}
+		// Transfer is mutually exclusive with other usage types
+		// so return early — no further flag combinations are valid
+		return { stageMask, accessMask, layout };
+	}
 
-	std::vector<PassId> sortedPassesIndices;
+	// Color Attachment
+	if (isColor) {
+		stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::ColorAttachmentOutput;
+
+		if (isRead)  accessMask |= Grindstone::GraphicsAPI::AccessFlags::ColorAttachmentRead;
+		if (isWrite) accessMask |= Grindstone::GraphicsAPI::AccessFlags::ColorAttachmentWrite;
 
-	for (PassId i = 0; i < static_cast<PassId>(passes.size()); ++i) {
-		sortedPassesIndices.emplace_back(i);
+		layout = Grindstone::GraphicsAPI::ImageLayout::ColorAttachment;
 	}
 
-	bool isGraphValid = true; // OptimizeRenderGraph(passes, sortedPassesIndices);
-	if (!isGraphValid) {
-		GPRINT_ERROR(LogSource::RenderingBackend, "Render graph has a cycle - we cannot compile it. Ensure passes do not depend on passes that depend on themselves");
-		throw "";
-		// return RenderGraph();
+	// Depth / Stencil Attachment
+	if (isDepth || isStencil) {
+		// Stage: early + late fragment tests cover all depth/stencil access
+		stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::EarlyFragmentTests
+			| Grindstone::GraphicsAPI::PipelineStageBit::LateFragmentTests;
+
+		if (isRead)  accessMask |= Grindstone::GraphicsAPI::AccessFlags::DepthStencilAttachmentRead;
+		if (isWrite) accessMask |= Grindstone::GraphicsAPI::AccessFlags::DepthStencilAttachmentWrite;
+
+		// Layout is determined by the combination of depth+stencil × read+write
+		layout = DeriveDepthStencilLayout(isDepth, isStencil, isRead, isWrite);
 	}
 
-	std::vector<Grindstone::UniquePtr<RenderGraphPass>> compiledPasses;
-	CreatePasses(passes, sortedPassesIndices, compiledPasses);
-	SetupBarriers();
-	RealizeResources();
-	SetupAttachments();
+	// Sampled (shader read via sampler)
+	if (isSampled && isRead) {
+		stageMask |= DeriveShaderStageMask(visibility);
+		accessMask |= Grindstone::GraphicsAPI::AccessFlags::ShaderRead;
+
+		// Only set layout here if no attachment flags are present
+		// Attachment flags take precedence and produce read-only variants
+		if (!isDepth && !isStencil && !isColor && !isSubpassInput) {
+			layout = Grindstone::GraphicsAPI::ImageLayout::ShaderRead;
+		}
+		// If combined with depth/stencil, layout stays as depth read-only variant
+		// (DEPTH_READ_ONLY_OPTIMAL also permits shader sampling)
+	}
+
+	// Storage Image (shader read/write without sampler)
+	if (isStorage) {
+		stageMask |= DeriveShaderStageMask(visibility);
+
+		if (isRead)  accessMask |= Grindstone::GraphicsAPI::AccessFlags::ShaderRead;
+		if (isWrite) accessMask |= Grindstone::GraphicsAPI::AccessFlags::ShaderWrite;
+
+		layout = Grindstone::GraphicsAPI::ImageLayout::General;
+	}
+
+	// Subpass Input Attachment
+	if (isSubpassInput && isRead) {
+		stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::FragmentShader;
+		accessMask |= Grindstone::GraphicsAPI::AccessFlags::InputAttachmentRead;
+		layout = Grindstone::GraphicsAPI::ImageLayout::ShaderRead;
+	}
+
+	if (isStorage && (isColor || isDepth || isStencil)) {
+		layout = Grindstone::GraphicsAPI::ImageLayout::General;
+	}
 
-	return RenderGraph(std::move(compiledPasses), resources);
+	return { stageMask, accessMask, layout };
 }
 
-void RenderGraphBuilder::Clear() {
-	passes.clear();
-	resources.clear();
-	presentationResourceId = invalidResourceId;
+
+static void AddResourceUsage(PassUsageList& usages, const PassResourceUsage& usage) {
+	for (PassResourceUsage& existingUsage : usages) {
+		if (existingUsage.state.resourceId != usage.state.resourceId) {
+			continue;
+		}
+
+		// A pass using an image in two ways, like attaching and sampling it, needs a layout allowing both.
+		if (existingUsage.state.layout != usage.state.layout) {
+			existingUsage.state.layout = Grindstone::GraphicsAPI::ImageLayout::General;
+		}
+
+		existingUsage.state.accessFlags |= usage.state.accessFlags;
+		existingUsage.state.pipelineStage |= usage.state.pipelineStage;
+		existingUsage.isRead = existingUsage.isRead || usage.isRead;
+		existingUsage.isWrite = existingUsage.isWrite || usage.isWrite;
+		return;
+	}
+
+	usages.emplace_back(usage);
+}
+
+static void AddImageUsage(PassUsageList& usages, RenderGraphBuilderResourceRef ref, ImageUsageSyncInfo syncInfo, bool isRead, bool isWrite) {
+	AddResourceUsage(
+		usages,
+		PassResourceUsage{
+			.state = RenderGraphResourceTransition{
+				.resourceId = ref.GetResourceIndex(),
+				.isBuffer = false,
+				.layout = syncInfo.layout,
+				.accessFlags = syncInfo.accessMask,
+				.pipelineStage = syncInfo.stageMask
+			},
+			.isRead = isRead,
+			.isWrite = isWrite
+		}
+	);
+}
+
+static void AddBufferUsage(
+	PassUsageList& usages,
+	RenderGraphBuilderResourceRef ref,
+	Grindstone::GraphicsAPI::PipelineStageBit pipelineStage,
+	Grindstone::GraphicsAPI::AccessFlags readAccess,
+	Grindstone::GraphicsAPI::AccessFlags writeAccess,
+	bool isRead,
+	bool isWrite
+) {
+	Grindstone::GraphicsAPI::AccessFlags accessFlags = Grindstone::GraphicsAPI::AccessFlags::None;
+	if (isRead) {
+		accessFlags |= readAccess;
+	}
+
+	if (isWrite) {
+		accessFlags |= writeAccess;
+	}
+
+	AddResourceUsage(
+		usages,
+		PassResourceUsage{
+			.state = RenderGraphResourceTransition{
+				.resourceId = ref.GetResourceIndex(),
+				.isBuffer = true,
+				.layout = Grindstone::GraphicsAPI::ImageLayout::Undefined,
+				.accessFlags = accessFlags,
+				.pipelineStage = pipelineStage
+			},
+			.isRead = isRead,
+			.isWrite = isWrite
+		}
+	);
+}
+
+static PassUsageList GatherResourceUsages(const RenderGraphBuilderPass& pass) {
+	using namespace Grindstone::GraphicsAPI;
+
+	PassUsageList usages;
+	const ShaderStageBit visibility = (pass.type == GpuPassType::Compute)
+		? ShaderStageBit::Compute
+		: ShaderStageBit::AllGraphics;
+
+	for (const PassImageDesc& imageDesc : pass.imageRefs) {
+		// Attachments that load their previous contents read them, even if they're only declared as written.
+		const bool isLoaded = imageDesc.IsAttachment() && imageDesc.attachment.loadOp == LoadOp::Load;
+		const bool isRead = Any(imageDesc.usage & RenderGraphImageUsage::Read) || isLoaded;
+		AddImageUsage(usages, imageDesc.ref, DeriveImageSyncInfo(imageDesc.usage, visibility), isRead, imageDesc.IsWrite());
+	}
+
+	for (const PassBufferDesc& bufferDesc : pass.bufferRefs) {
+		AddBufferUsage(
+			usages,
+			bufferDesc.ref,
+			DeriveShaderStageMask(visibility),
+			AccessFlags::ShaderRead,
+			AccessFlags::ShaderWrite,
+			bufferDesc.accessType != AccessType::Write,
+			bufferDesc.accessType != AccessType::Read
+		);
+	}
+
+	if (pass.type == GpuPassType::Transfer) {
+		const TransferRenderGraphBuilderPass& transferPass = static_cast<const TransferRenderGraphBuilderPass&>(pass);
+		for (const BuilderImageTransfer& transfer : transferPass.imageTransfers) {
+			AddImageUsage(usages, transfer.srcImage, DeriveImageSyncInfo(RenderGraphImageUsage::TransferSrc), true, false);
+			AddImageUsage(usages, transfer.dstImage, DeriveImageSyncInfo(RenderGraphImageUsage::TransferDst), false, true);
+		}
+
+		for (const BuilderBufferTransfer& transfer : transferPass.bufferTransfers) {
+			AddBufferUsage(usages, transfer.srcBuffer, PipelineStageBit::Transfer, AccessFlags::TransferRead, AccessFlags::None, true, false);
+			AddBufferUsage(usages, transfer.dstBuffer, PipelineStageBit::Transfer, AccessFlags::None, AccessFlags::TransferWrite, false, true);
+		}
+	}
+	else if (pass.type == GpuPassType::Present) {
+		const PresentRenderGraphBuilderPass& presentPass = static_cast<const PresentRenderGraphBuilderPass&>(pass);
+		RenderGraphBuilderResourceRef presentationImage = presentPass.GetPresentationImage();
+		if (!presentationImage.IsInvalid()) {
+			const ImageUsageSyncInfo presentSyncInfo{ PipelineStageBit::BottomOfPipe, AccessFlags::None, ImageLayout::Present };
+			AddImageUsage(usages, presentationImage, presentSyncInfo, true, false);
+		}
+	}
+
+	return usages;
 }
 
 /*!
-	\brief Sort and cull the Render Graph so that we can execute them in order based off of the resources of each pass.
-	\param passes The list of all render graph builder passes.
-	\param sortedAndCulledPasses The output indices of each pass, culled and sorted.
-	\return Whether the render graph is valid (ie has no cyclic dependencies).
+	\brief Find which passes must run before each pass, walking the passes in the order they were declared.
+	\param passUsages The resource usages of every pass.
+	\param isPassIncluded Which passes to consider. Hazards are only tracked between included passes.
+	\param producers The output passes whose results each pass reads (read-after-write).
+	\param predecessors The output passes each pass must run after, which also includes write-after-read,
+		write-after-write, and reads in a different layout than the reads before them.
 */
-/*
-static bool OptimizeRenderGraph(
-	const RenderGraphPassList& passes,
-	std::vector<PassId>& sortedAndCulledPasses
+static void FindPassHazards(
+	const std::vector<PassUsageList>& passUsages,
+	const std::vector<bool>& isPassIncluded,
+	size_t resourceCount,
+	std::vector<PassIdList>& producers,
+	std::vector<PassIdList>& predecessors
 ) {
-	using namespace Grindstone::Renderer;
+	struct ResourceHistory {
+		PassId lastWriter = invalidPassId;
+		// Every pass that read the resource since it was last written.
+		PassIdList readers;
+		// The most recent readers that share a layout, which can run alongside each other.
+		PassIdList readGroup;
+		Grindstone::GraphicsAPI::ImageLayout readGroupLayout = Grindstone::GraphicsAPI::ImageLayout::Undefined;
+	};
+
+	std::vector<ResourceHistory> histories(resourceCount);
+	producers.assign(passUsages.size(), {});
+	predecessors.assign(passUsages.size(), {});
+
+	for (PassId passId = 0; passId < static_cast<PassId>(passUsages.size()); ++passId) {
+		if (!isPassIncluded[passId]) {
+			continue;
+		}
+
+		PassIdList& passProducers = producers[passId];
+		PassIdList& passPredecessors = predecessors[passId];
+		for (const PassResourceUsage& usage : passUsages[passId]) {
+			ResourceHistory& history = histories[usage.state.resourceId];
 
-	PassId totalPassCount = static_cast<PassId>(passes.size());
-	std::vector<PassId> indegree(totalPassCount, 0);
+			if (history.lastWriter != invalidPassId) {
+				passPredecessors.emplace_back(history.lastWriter);
+				if (usage.isRead) {
+					passProducers.emplace_back(history.lastWriter);
+				}
+			}
 
-	size_t n = passes.size();
+			if (usage.isWrite) {
+				passPredecessors.insert(passPredecessors.end(), history.readers.begin(), history.readers.end());
+				history.lastWriter = passId;
+				history.readers.clear();
+				history.readGroup.clear();
+				continue;
+			}
 
-	passDependencies.resize(n);
-	for (size_t index = 0; index < n; ++index) {
-		const Grindstone::UniquePtr<RenderGraphBuilderPass>& pass = passes[index];
+			if (!history.readGroup.empty() && history.readGroupLayout != usage.state.layout) {
+				passPredecessors.insert(passPredecessors.end(), history.readGroup.begin(), history.readGroup.end());
+				history.readGroup.clear();
+			}
 
-		for (const PassBufferDesc& buffer : pass->bufferRefs) {
-			passDependencies[index].insert(buffer.ref.passIndex);
+			history.readGroupLayout = usage.state.layout;
+			history.readGroup.emplace_back(passId);
+			history.readers.emplace_back(passId);
 		}
 
-		for (const PassImageDesc& image : pass->imageRefs) {
-			passDependencies[index].insert(image.ref.passIndex);
+		std::sort(passPredecessors.begin(), passPredecessors.end());
+		passPredecessors.erase(std::unique(passPredecessors.begin(), passPredecessors.end()), passPredecessors.end());
+	}
+}
+
+// Passes have to run if they present, write to something outside of the graph, or do something the graph can't see.
+static bool IsOutputPass(
+	const RenderGraphBuilderPass& pass,
+	const PassUsageList& usages,
+	const std::vector<UnionResourceDescription>& resources
+) {
+	if (pass.type == GpuPassType::Present || pass.hasSideEffects) {
+		return true;
+	}
+
+	for (const PassResourceUsage& usage : usages) {
+		if (!usage.isWrite) {
+			continue;
 		}
 
-		if (pass->type == )
+		const UnionResourceDescription& resource = resources[usage.state.resourceId];
+		if (std::holds_alternative<ImageDescription>(resource)) {
+			if (std::get<ImageDescription>(resource).externalGetterCallback != nullptr) {
+				return true;
+			}
+		}
+		else if (std::get<BufferDescription>(resource).memoryUsage == Grindstone::GraphicsAPI::MemoryUsage::GPUToCPU) {
+			// Readback buffers are consumed by the CPU after the graph has run.
+			return true;
+		}
 	}
 
-	std::set<PassId> usedPasses;
-	std::queue<PassId> passesToProcess;
+	return false;
+}
 
-	for (PassId passId : externalOutputs) {
-		passesToProcess.push(passId);
+static std::vector<bool> CullUnusedPasses(
+	const RenderGraphPassList& passes,
+	const std::vector<PassUsageList>& passUsages,
+	const std::vector<PassIdList>& producers,
+	const std::vector<UnionResourceDescription>& resources
+) {
+	std::vector<bool> isPassUsed(passes.size(), false);
+	PassIdList passesToVisit;
+
+	for (PassId passId = 0; passId < static_cast<PassId>(passes.size()); ++passId) {
+		if (IsOutputPass(*passes[passId], passUsages[passId], resources)) {
+			passesToVisit.emplace_back(passId);
+		}
 	}
 
-	// For each resource in resources queue:
-	while (!passesToProcess.empty()) {
-		PassId passId = passesToProcess.front();
-		passesToProcess.pop();
+	while (!passesToVisit.empty()) {
+		PassId passId = passesToVisit.back();
+		passesToVisit.pop_back();
 
-		// Don't iterate if we already used this pass.
-		if (usedPasses.contains(passId)) {
+		if (isPassUsed[passId]) {
 			continue;
 		}
 
-		// Mark this resource's source pass as used.
-		usedPasses.insert(passId);
+		isPassUsed[passId] = true;
+		passesToVisit.insert(passesToVisit.end(), producers[passId].begin(), producers[passId].end());
+	}
+
+	return isPassUsed;
+}
 
-		const std::set<PassId>& passInputs = passDependencies[passId];
-		for (PassId passInput : passInputs) {
-			passesToProcess.push(passInput);
+/*!
+	\brief Sort the Render Graph with Kahn's algorithm, grouping passes into levels that only depend on earlier levels.
+	\param predecessors The passes each pass must run after.
+	\param isPassUsed Which passes survived culling.
+	\param sortedPasses The output indices of each used pass, sorted by level, and by declaration order within a level.
+	\param levelPassCounts The output number of passes in each level.
+	\return Whether the render graph is valid (ie has no cyclic dependencies).
+*/
+static bool SortIntoDependencyLevels(
+	const std::vector<PassIdList>& predecessors,
+	const std::vector<bool>& isPassUsed,
+	PassIdList& sortedPasses,
+	std::vector<uint32_t>& levelPassCounts
+) {
+	const size_t totalPassCount = predecessors.size();
+	std::vector<uint32_t> indegrees(totalPassCount, 0);
+	std::vector<PassIdList> successors(totalPassCount);
+	size_t usedPassCount = 0;
+
+	for (PassId passId = 0; passId < static_cast<PassId>(totalPassCount); ++passId) {
+		if (!isPassUsed[passId]) {
+			continue;
 		}
-	}
 
-	// Compute indegrees (number of dependencies) for each pass.
-	for (PassId i = 0; i < totalPassCount; i++) {
-		for (PassId next : passes[i].tex) {
-			indegree[next]++;
+		++usedPassCount;
+		for (PassId predecessor : predecessors[passId]) {
+			successors[predecessor].emplace_back(passId);
+			++indegrees[passId];
 		}
 	}
 
-	std::queue<PassId> queue;
-
-	// Add all nodes with indegree 0 into the front of the queue
-	// because they should be as early as possible.
-	for (PassId i = 0; i < totalPassCount; i++) {
-		if (indegree[i] == 0) {
-			queue.push(i);
+	PassIdList currentLevel;
+	for (PassId passId = 0; passId < static_cast<PassId>(totalPassCount); ++passId) {
+		if (isPassUsed[passId] && indegrees[passId] == 0) {
+			currentLevel.emplace_back(passId);
 		}
 	}
 
-	// Kahn's Algorithm (BFS)
-	while (!queue.empty()) {
-		PassId top = queue.front();
-		queue.pop();
-		sortedOutput.push_back(top);
-		for (PassId next : graph[top]) {
-			indegree[next]--;
-			if (indegree[next] == 0) {
-				queue.push(next);
+	PassIdList nextLevel;
+	while (!currentLevel.empty()) {
+		levelPassCounts.emplace_back(static_cast<uint32_t>(currentLevel.size()));
+		for (PassId passId : currentLevel) {
+			sortedPasses.emplace_back(passId);
+			for (PassId successor : successors[passId]) {
+				if (--indegrees[successor] == 0) {
+					nextLevel.emplace_back(successor);
+				}
 			}
 		}
+
+		std::sort(nextLevel.begin(), nextLevel.end());
+		currentLevel.swap(nextLevel);
+		nextLevel.clear();
 	}
 
 	// A cycle is contained if the generated output does not have the same number of nodes
 	// as the input graph.
-	return (sortedOutput.size() == totalPassCount);
+	return sortedPasses.size() == usedPassCount;
 }
+
+/*!
+	\brief Merge the resource states every pass of a level needs into one list of transitions, skipping any
+		that would leave a resource in the state the previous level already put it in.
+	\return The levels, each with the transitions to submit before their passes run.
 */
+static std::vector<RenderGraphDependencyLevel> SetupBarriers(
+	const std::vector<PassUsageList>& passUsages,
+	const PassIdList& sortedPasses,
+	const std::vector<uint32_t>& levelPassCounts,
+	size_t resourceCount
+) {
+	std::vector<RenderGraphDependencyLevel> dependencyLevels;
+	dependencyLevels.reserve(levelPassCounts.size());
+
+	// The first use of a resource always gets a transition, as its state is only known when the graph executes.
+	std::vector<RenderGraphResourceTransition> resourceStates(resourceCount);
+	std::vector<bool> isResourceStateKnown(resourceCount, false);
+
+	size_t sortedPassIndex = 0;
+	for (uint32_t levelPassCount : levelPassCounts) {
+		RenderGraphDependencyLevel& dependencyLevel = dependencyLevels.emplace_back();
+		dependencyLevel.passCount = levelPassCount;
+
+		// Passes in the same level only share resources they all read in the same layout, so their states can be merged.
+		PassUsageList levelUsages;
+		for (uint32_t i = 0; i < levelPassCount; ++i) {
+			for (const PassResourceUsage& usage : passUsages[sortedPasses[sortedPassIndex++]]) {
+				AddResourceUsage(levelUsages, usage);
+			}
+		}
+
+		for (const PassResourceUsage& usage : levelUsages) {
+			const RenderGraphResourceTransition& newState = usage.state;
+			RenderGraphResourceTransition& currentState = resourceStates[newState.resourceId];
+
+			if (
+				isResourceStateKnown[newState.resourceId] &&
+				!IsBarrierRequired(currentState.layout, currentState.accessFlags, newState.layout, newState.accessFlags)
+			) {
+				// Reads after reads don't need a barrier, but later writes have to wait on every stage that read.
+				const Grindstone::GraphicsAPI::AccessFlags mergedAccessFlags = currentState.accessFlags | newState.accessFlags;
+				const Grindstone::GraphicsAPI::PipelineStageBit mergedPipelineStage = currentState.pipelineStage | newState.pipelineStage;
+				if (mergedAccessFlags == currentState.accessFlags && mergedPipelineStage == currentState.pipelineStage) {
+					continue;
+				}
+
+				currentState.accessFlags = mergedAccessFlags;
+				currentState.pipelineStage = mergedPipelineStage;
+				dependencyLevel.transitions.emplace_back(newState);
+				continue;
+			}
+
+			currentState = newState;
+			isResourceStateKnown[newState.resourceId] = true;
+			dependencyLevel.transitions.emplace_back(newState);
+		}
+	}
+
+	return dependencyLevels;
+}
 
 static void CreatePasses(
 	const RenderGraphPassList& builderPasses,
@@ -233,317 +599,142 @@ static void CreatePasses(
 	}
 }
 
-void SetupBarriers() {}
-void SetupAttachments() {}
-
-/*
-static std::tuple<
-	Grindstone::GraphicsAPI::ImageLayout,
-	Grindstone::GraphicsAPI::AccessFlags,
-	Grindstone::GraphicsAPI::PipelineStageBit
-> InferBarrierData(
-	GpuPassType gpuQueue,
-	RenderGraphBuilder::ResourceType resourceType,
-	AccessType accessType
-	// Grindstone::GraphicsAPI::ShaderStageBit stages
-) {
-	using namespace Grindstone::GraphicsAPI;
-	using namespace Grindstone::Renderer;
+RenderGraphBuilderResourceRef RenderGraphBuilder::AddImage(ImageDescription imageDesc, Renderer::PassId passId) {
+	size_t imageIndex = resources.size();
+	resources.emplace_back(imageDesc);
 
-	if (accessType == AccessType::Read) {
-		return {
-			ImageLayout::ShaderRead,
-			AccessFlags::ShaderRead,
-			gpuQueue == GpuPassType::Compute
-				? PipelineStageBit::ComputeShader
-				: PipelineStageBit::FragmentShader // ShaderStagesToPipelineStages(stages)
-		};
-	}
-
-	switch (resourceType) {
-	case RenderGraph::ResourceType::ColorAttachment:
-		return {
-			ImageLayout::ColorAttachment,
-			AccessFlags::ColorAttachmentWrite,
-			PipelineStageBit::ColorAttachmentOutput
-		};
-
-	case RenderGraph::ResourceType::DepthAttachment:
-		return {
-			ImageLayout::DepthWrite,
-			AccessFlags::DepthStencilAttachmentWrite,
-			PipelineStageBit::EarlyFragmentTests |
-			PipelineStageBit::LateFragmentTests
-		};
-	case RenderGraph::ResourceType::StorageImage:
-		return {
-			ImageLayout::General,
-			AccessFlags::ShaderWrite,
-			PipelineStageBit::ComputeShader
-		};
-	}
+	return {
+		.resourceIndex = static_cast<Renderer::ResourceId>(imageIndex),
+		.passIndex = passId
+	};
+}
 
-	GS_ASSERT_LOG("Invalid resource!");
+RenderGraphBuilderResourceRef RenderGraphBuilder::AddBuffer(BufferDescription bufferDesc, Renderer::PassId passId) {
+	size_t bufferIndex = resources.size();
+	resources.emplace_back(bufferDesc);
 
-	return { ImageLayout::Undefined, AccessFlags::None, PipelineStageBit::None };
+	return {
+		.resourceIndex = static_cast<Renderer::ResourceId>(bufferIndex),
+		.passIndex = passId
+	};
 }
 
-static void SetupBarriers() {
-	for (RenderGraphPass& pass : passes) {
-		Grindstone::GraphicsAPI::PipelineStageBit srcPipelineStageMask = Grindstone::GraphicsAPI::PipelineStageBit::AllGraphics;
-		Grindstone::GraphicsAPI::PipelineStageBit dstPipelineStageMask = Grindstone::GraphicsAPI::PipelineStageBit::None;
-		std::vector<Grindstone::GraphicsAPI::ImageBarrier> imageBarriers;
-		std::vector<Grindstone::GraphicsAPI::BufferBarrier> bufferBarriers;
-
-		for (ResourceRead& read : pass.reads) {
-			switch (read.resource.resourceType) {
-			case ResourceType::ColorAttachment:
-			case ResourceType::DepthAttachment:
-			case ResourceType::StorageImage:
-			{
-				ImageDescription& imageDesc = read.resource.image;
-				ResourceId resourceId = namesToResourceIds[read.name];
-				TransientImageData& imageData = transientResourceManager.GetTrackedImage(context.swapchainSize.x, context.swapchainSize.y, imageDesc, trackedResources[resourceId].second);
-
-				GraphicsAPI::ImageLayout srcLayout = imageData.currentLayout;
-				GraphicsAPI::AccessFlags srcAccess = imageData.currentAccessFlags;
-				GraphicsAPI::ImageLayout dstLayout = GraphicsAPI::ImageLayout::Undefined;
-				GraphicsAPI::AccessFlags dstAccess = GraphicsAPI::AccessFlags::None;
-				GraphicsAPI::PipelineStageBit dstPipelineStageBit = GraphicsAPI::PipelineStageBit::None;
-
-				std::tie(dstLayout, dstAccess, dstPipelineStageBit) = InferBarrierData(pass.type, read.resource.resourceType, AccessType::Read);
-
-				if (srcLayout != dstLayout && srcAccess != dstAccess) {
-					GraphicsAPI::ImageAspectBits aspect = GraphicsAPI::GetFormatAspect(imageDesc.format);
-					imageBarriers.emplace_back(
-						GraphicsAPI::ImageBarrier{
-							.image = imageData.image,
-							.oldLayout = srcLayout,
-							.newLayout = dstLayout,
-							.srcAccess = srcAccess,
-							.dstAccess = dstAccess,
-							.imageAspect = aspect,
-							.baseMipLevel = 0,
-							.levelCount = imageDesc.mipLevels,
-							.baseArrayLayer = 0,
-							.layerCount = imageDesc.arrayLayers
-						}
-					);
-
-					imageData.currentLayout = dstLayout;
-					imageData.currentAccessFlags = dstAccess;
-					dstPipelineStageMask |= dstPipelineStageBit;
-				}
-				break;
-			}
-			case ResourceType::StorageBuffer:
-			case ResourceType::UniformBuffer:
-			{
-				BufferDescription& bufferDesc = read.resource.buffer;
-				ResourceId resourceId = namesToResourceIds[read.name];
-				TransientBufferData& bufferData = transientResourceManager.GetTrackedBuffer(bufferDesc, trackedResources[resourceId].second);
-
-				GraphicsAPI::AccessFlags srcAccess = bufferData.currentAccessFlags;
-				GraphicsAPI::AccessFlags dstAccess = read.resource.resourceType == ResourceType::UniformBuffer
-					? GraphicsAPI::AccessFlags::UniformRead
-					: GraphicsAPI::AccessFlags::ShaderRead;
-
-				if (srcAccess != dstAccess) {
-					bufferBarriers.emplace_back(
-						GraphicsAPI::BufferBarrier{
-							.buffer = bufferData.buffer,
-							.srcAccess = srcAccess,
-							.dstAccess = dstAccess,
-							.offset = 0,
-							.size = static_cast<uint32_t>(bufferDesc.size)
-						}
-					);
-
-					bufferData.currentAccessFlags = dstAccess;
-				}
-				break;
-			}
-			}
+size_t RenderGraphBuilder::ComputeTopologyHash() const {
+	size_t hash = 0;
+	Grindstone::Hash::Combine(hash, passes.size(), resources.size());
+
+	for (const UnionResourceDescription& resource : resources) {
+		Grindstone::Hash::Combine(hash, resource.index());
+		if (std::holds_alternative<ImageDescription>(resource)) {
+			Grindstone::Hash::Combine(hash, std::get<ImageDescription>(resource).externalGetterCallback != nullptr);
+		}
+		else {
+			Grindstone::Hash::Combine(hash, std::get<BufferDescription>(resource).memoryUsage);
 		}
+	}
 
-		for (ResourceReadWrite& readWrite : pass.readWrites) {
-			switch (readWrite.resource.resourceType) {
-			case ResourceType::ColorAttachment:
-			case ResourceType::DepthAttachment:
-			case ResourceType::StorageImage:
-			{
-				ImageDescription& imageDesc = readWrite.resource.image;
-				ResourceId resourceId = namesToResourceIds[readWrite.input];
-				TransientImageData& imageData = transientResourceManager.GetTrackedImage(context.swapchainSize.x, context.swapchainSize.y, imageDesc, trackedResources[resourceId].second);
-
-				GraphicsAPI::ImageLayout srcLayout = imageData.currentLayout;
-				GraphicsAPI::AccessFlags srcAccess = imageData.currentAccessFlags;
-				GraphicsAPI::ImageLayout dstLayout = GraphicsAPI::ImageLayout::Undefined;
-				GraphicsAPI::AccessFlags dstAccess = GraphicsAPI::AccessFlags::None;
-				GraphicsAPI::PipelineStageBit dstPipelineStageBit = GraphicsAPI::PipelineStageBit::None;
-
-				std::tie(dstLayout, dstAccess, dstPipelineStageBit) = InferBarrierData(pass.type, readWrite.resource.resourceType, AccessType::ReadWrite);
-
-				if (srcLayout != dstLayout && srcAccess != dstAccess) {
-					GraphicsAPI::ImageAspectBits aspect = GraphicsAPI::GetFormatAspect(imageDesc.format);
-					imageBarriers.emplace_back(
-						GraphicsAPI::ImageBarrier{
-							.image = imageData.image,
-							.oldLayout = srcLayout,
-							.newLayout = dstLayout,
-							.srcAccess = srcAccess,
-							.dstAccess = dstAccess,
-							.imageAspect = aspect,
-							.baseMipLevel = 0,
-							.levelCount = imageDesc.mipLevels,
-							.baseArrayLayer = 0,
-							.layerCount = imageDesc.arrayLayers
-						}
-					);
-
-					dstPipelineStageMask |= dstPipelineStageBit;
-					imageData.currentLayout = dstLayout;
-					imageData.currentAccessFlags = dstAccess;
-				}
-				break;
-			}
-			case ResourceType::StorageBuffer:
-			case ResourceType::UniformBuffer:
-			{
-				BufferDescription& bufferDesc = readWrite.resource.buffer;
-				ResourceId resourceId = namesToResourceIds[readWrite.input];
-				TransientBufferData& bufferData = transientResourceManager.GetTrackedBuffer(bufferDesc, trackedResources[resourceId].second);
-
-				GraphicsAPI::AccessFlags srcAccess = bufferData.currentAccessFlags;
-				GraphicsAPI::AccessFlags dstAccess = GraphicsAPI::AccessFlags::ShaderWrite;
-
-				if (srcAccess != dstAccess) {
-					bufferBarriers.emplace_back(
-						GraphicsAPI::BufferBarrier{
-							.buffer = bufferData.buffer,
-							.srcAccess = srcAccess,
-							.dstAccess = dstAccess,
-							.offset = 0,
-							.size = static_cast<uint32_t>(bufferDesc.size)
-						}
-					);
-
-					bufferData.currentAccessFlags = dstAccess;
-				}
-				break;
-			}
-			}
+	for (const Grindstone::UniquePtr<RenderGraphBuilderPass>& pass : passes) {
+		Grindstone::Hash::Combine(hash, pass->type, pass->hasSideEffects, pass->imageRefs.size(), pass->bufferRefs.size());
+
+		for (const PassImageDesc& imageDesc : pass->imageRefs) {
+			const bool isLoaded = imageDesc.IsAttachment() && imageDesc.attachment.loadOp == Grindstone::GraphicsAPI::LoadOp::Load;
+			Grindstone::Hash::Combine(hash, imageDesc.ref.GetResourceIndex(), imageDesc.usage, isLoaded);
 		}
 
-		for (ResourceWrite& write : pass.writes) {
-			switch (write.resource.resourceType) {
-			case ResourceType::ColorAttachment:
-			case ResourceType::DepthAttachment:
-			case ResourceType::StorageImage:
-			{
-				ImageDescription& imageDesc = write.resource.image;
-				ResourceId resourceId = namesToResourceIds[write.name];
-				TransientImageData& imageData = transientResourceManager.GetTrackedImage(context.swapchainSize.x, context.swapchainSize.y, imageDesc, trackedResources[resourceId].second);
-
-				GraphicsAPI::ImageLayout srcLayout = imageData.currentLayout;
-				GraphicsAPI::AccessFlags srcAccess = imageData.currentAccessFlags;
-				GraphicsAPI::ImageLayout dstLayout = GraphicsAPI::ImageLayout::Undefined;
-				GraphicsAPI::AccessFlags dstAccess = GraphicsAPI::AccessFlags::None;
-				GraphicsAPI::PipelineStageBit dstPipelineStageBit = GraphicsAPI::PipelineStageBit::None;
-
-				std::tie(dstLayout, dstAccess, dstPipelineStageBit) = InferBarrierData(pass.type, write.resource.resourceType, AccessType::Write);
-
-				if (srcLayout != dstLayout && srcAccess != dstAccess) {
-					GraphicsAPI::ImageAspectBits aspect = GraphicsAPI::GetFormatAspect(imageDesc.format);
-					imageBarriers.emplace_back(
-						GraphicsAPI::ImageBarrier{
-							.image = imageData.image,
-							.oldLayout = srcLayout,
-							.newLayout = dstLayout,
-							.srcAccess = srcAccess,
-							.dstAccess = dstAccess,
-							.imageAspect = aspect,
-							.baseMipLevel = 0,
-							.levelCount = imageDesc.mipLevels,
-							.baseArrayLayer = 0,
-							.layerCount = imageDesc.arrayLayers
-						}
-					);
-
-					imageData.currentLayout = dstLayout;
-					imageData.currentAccessFlags = dstAccess;
-					dstPipelineStageMask |= dstPipelineStageBit;
-				}
-				break;
-			}
-			case ResourceType::StorageBuffer:
-			case ResourceType::UniformBuffer:
-			{
-				BufferDescription& bufferDesc = write.resource.buffer;
-				ResourceId resourceId = namesToResourceIds[write.name];
-				TransientBufferData& bufferData = transientResourceManager.GetTrackedBuffer(bufferDesc, trackedResources[resourceId].second);
-
-				GraphicsAPI::AccessFlags srcAccess = bufferData.currentAccessFlags;
-				GraphicsAPI::AccessFlags dstAccess = GraphicsAPI::AccessFlags::ShaderWrite;
-
-				if (srcAccess != dstAccess) {
-					bufferBarriers.emplace_back(
-						GraphicsAPI::BufferBarrier{
-							.buffer = bufferData.buffer,
-							.srcAccess = srcAccess,
-							.dstAccess = dstAccess,
-							.offset = 0,
-							.size = static_cast<uint32_t>(bufferDesc.size)
-						}
-					);
-
-					bufferData.currentAccessFlags = dstAccess;
-				}
-				break;
+		for (const PassBufferDesc& bufferDesc : pass->bufferRefs) {
+			Grindstone::Hash::Combine(hash, bufferDesc.ref.GetResourceIndex(), bufferDesc.accessType);
+		}
+
+		if (pass->type == GpuPassType::Transfer) {
+			const TransferRenderGraphBuilderPass& transferPass = static_cast<const TransferRenderGraphBuilderPass&>(*pass);
+			Grindstone::Hash::Combine(hash, transferPass.imageTransfers.size(), transferPass.bufferTransfers.size());
+
+			for (const BuilderImageTransfer& transfer : transferPass.imageTransfers) {
+				Grindstone::Hash::Combine(hash, transfer.srcImage.GetResourceIndex(), transfer.dstImage.GetResourceIndex());
 			}
+
+			for (const BuilderBufferTransfer& transfer : transferPass.bufferTransfers) {
+				Grindstone::Hash::Combine(hash, transfer.srcBuffer.GetResourceIndex(), transfer.dstBuffer.GetResourceIndex());
 			}
 		}
+		else if (pass->type == GpuPassType::Present) {
+			const PresentRenderGraphBuilderPass& presentPass = static_cast<const PresentRenderGraphBuilderPass&>(*pass);
+			const RenderGraphBuilderResourceRef presentationImage = presentPass.GetPresentationImage();
+			Grindstone::Hash::Combine(hash, presentationImage.IsInvalid() ? invalidResourceId : presentationImage.GetResourceIndex());
+		}
 	}
+
+	return hash;
 }
-*/
 
-static void RealizeResources() {
-	/*
-	for (size_t i = 0; i < resources.size(); ++i) {
-		ResourceWrite& resource = resources[i];
-		void* trackedResource = nullptr;
-		UnionResource& unionResource = resource.resource;
-		switch (unionResource.resourceType) {
-		case ResourceType::StorageBuffer:
-		case ResourceType::UniformBuffer: {
-			Renderer::TransientBufferData bufferData;
-			size_t index;
-			std::tie(bufferData, index) = transientResourceManager.AddTrackedBuffer(resource.resource.buffer);
-			trackedResources.emplace_back(
-				TransientResourceUnion{
-					.buffer = bufferData
-				},
-				index
-			);
-			break;
-		}
-		case ResourceType::ColorAttachment:
-		case ResourceType::DepthAttachment:
-		case ResourceType::StorageImage: {
-			Renderer::TransientImageData imageData;
-			size_t index;
-			std::tie(imageData, index) = transientResourceManager.AddTrackedImage(context.swapchainSize.x, context.swapchainSize.y, resource.resource.image);
-			trackedResources.emplace_back(
-				TransientResourceUnion{
-					.image = imageData
-				},
-				index
-			);
-			break;
-		}
-		default:
-			GS_ASSERT_LOG("Invalid ResourceType!");
+void RenderGraphBuilder::Compile(RenderGraph& cachedGraph) const {
+	const size_t topologyHash = ComputeTopologyHash();
+	if (!cachedGraph.IsCompiled() || cachedGraph.GetTopologyHash() != topologyHash) {
+		cachedGraph = Compile();
+		return;
+	}
+
+	// Passes hold this frame's execution callbacks, so they're always recreated.
+	std::vector<Grindstone::UniquePtr<RenderGraphPass>> compiledPasses;
+	CreatePasses(passes, cachedGraph.GetSortedPassIds(), compiledPasses);
+	cachedGraph.Rebind(std::move(compiledPasses), resources);
+}
+
+RenderGraph RenderGraphBuilder::Compile() const {
+	std::vector<PassUsageList> passUsages;
+	passUsages.reserve(passes.size());
+	for (const Grindstone::UniquePtr<RenderGraphBuilderPass>& pass : passes) {
+		passUsages.emplace_back(GatherResourceUsages(*pass));
+	}
+
+	std::vector<PassIdList> producers;
+	std::vector<PassIdList> predecessors;
+	const std::vector<bool> allPasses(passes.size(), true);
+	FindPassHazards(passUsages, allPasses, resources.size(), producers, predecessors);
+	const std::vector<bool> isPassUsed = CullUnusedPasses(passes, passUsages, producers, resources);
+
+	// Hazards are found again without the culled passes, so passes that were only ordered through them still are.
+	FindPassHazards(passUsages, isPassUsed, resources.size(), producers, predecessors);
+
+	std::vector<PassId> sortedPassesIndices;
+	std::vector<uint32_t> levelPassCounts;
+	bool isGraphValid = SortIntoDependencyLevels(predecessors, isPassUsed, sortedPassesIndices, levelPassCounts);
+	if (!isGraphValid) {
+		GPRINT_ERROR(LogSource::RenderingBackend, "Render graph has a cycle - we cannot compile it. Ensure passes do not depend on passes that depend on themselves");
+		throw "";
+		// return RenderGraph();
+	}
+
+	std::vector<TransientResourceLifetime> resourceLifetimes(resources.size());
+	size_t sortedPassIndex = 0;
+	for (uint32_t level = 0; level < levelPassCounts.size(); ++level) {
+		for (uint32_t i = 0; i < levelPassCounts[level]; ++i) {
+			for (const PassResourceUsage& usage : passUsages[sortedPassesIndices[sortedPassIndex]]) {
+				TransientResourceLifetime& lifetime = resourceLifetimes[usage.state.resourceId];
+				lifetime.firstLevel = std::min(lifetime.firstLevel, level);
+				lifetime.lastLevel = std::max(lifetime.lastLevel, level);
+			}
+
+			++sortedPassIndex;
 		}
 	}
-	*/
+
+	std::vector<Grindstone::UniquePtr<RenderGraphPass>> compiledPasses;
+	CreatePasses(passes, sortedPassesIndices, compiledPasses);
+	std::vector<RenderGraphDependencyLevel> dependencyLevels = SetupBarriers(passUsages, sortedPassesIndices, levelPassCounts, resources.size());
+
+	return RenderGraph(
+		ComputeTopologyHash(),
+		std::move(sortedPassesIndices),
+		std::move(compiledPasses),
+		std::move(dependencyLevels),
+		resources,
+		std::move(resourceLifetimes)
+	);
+}
+
+void RenderGraphBuilder::Clear() {
+	passes.clear();
+	resources.clear();
+	presentationResourceId = invalidResourceId;
 }
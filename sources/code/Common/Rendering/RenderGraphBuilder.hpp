@@ -21,7 +21,7 @@ namespace Grindstone::Renderer {
 			static_assert(std::is_invocable_r_v<ReturnType, SetupCallback, Grindstone::Renderer::GraphicsRenderGraphBuilderPass<ReturnType>&>, "Rendergraph setup callback must match expected signature.");
 			static_assert(std::is_invocable_r_v<void, ExecutionCallback, Grindstone::Math::IntRect2D, const Grindstone::Renderer::RenderGraphContext&, const Grindstone::Renderer::RenderGraphFrameResources&, ReturnType&>, "Rendergraph execution callback must match expected signature.");
 			uint32_t passIndex = static_cast<uint32_t>(passes.size());
-			auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateUnique<GraphicsRenderGraphBuilderPass<ReturnType>>());
+			auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateFrameUnique<GraphicsRenderGraphBuilderPass<ReturnType>>());
 			auto pass = static_cast<GraphicsRenderGraphBuilderPass<ReturnType>*>(uniquePtr.Get());
 			pass->name = name;
 			pass->type = GpuPassType::Graphics;
@@ -43,7 +43,7 @@ namespace Grindstone::Renderer {
 			static_assert(std::is_invocable_r_v<void, ExecutionCallback, Grindstone::Renderer::RenderGraphContext&, const Grindstone::Renderer::RenderGraphFrameResources&, ReturnType&>, "Rendergraph execution callback must match expected signature.");
 
 			uint32_t passIndex = static_cast<uint32_t>(passes.size());
-			auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateUnique<ComputeRenderGraphBuilderPass<ReturnType>>());
+			auto& uniquePtr = passes.emplace_back(Grindstone::Memory::AllocatorCore::AllocateFrameUnique<ComputeRenderGraphBuilderPass<ReturnType>>());
 			auto pass = static_cast<ComputeRenderGraphBuilderPass<ReturnType>*>(uniquePtr.Get());
 			pass->name = name;
 			pass->type = GpuPassType::Compute;
@@ -68,6 +68,12 @@ namespace Grindstone::Renderer {
 		Grindstone::Renderer::RenderGraphBuilderResourceRef AddBuffer(BufferDescription bufferDesc, Renderer::PassId passId = Renderer::invalidPassId);
 
 		Grindstone::Renderer::RenderGraph Compile() const;
+		// Compiles into cachedGraph. If it was compiled from the same topology, only this frame's passes
+		// and resource descriptions are rebound, and its pass order, barriers and lifetimes are reused.
+		void Compile(Grindstone::Renderer::RenderGraph& cachedGraph) const;
+
+		// Hashes everything compiling depends on: the passes, how they use resources, and which resources are outputs.
+		size_t ComputeTopologyHash() const;
 
 		void Clear();
 
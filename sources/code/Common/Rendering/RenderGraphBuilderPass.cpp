@@ -1,6 +1,10 @@
 #include "RenderGraphBuilderPass.hpp"
 #include "RenderGraphBuilder.hpp"
 
+void Grindstone::Renderer::RenderGraphBuilderPass::SetHasSideEffects(bool hasSideEffects) {
+	this->hasSideEffects = hasSideEffects;
+}
+
 // ============================================
 // Pipeline Pass (Graphics and Compute)
 // ============================================
@@ -206,3 +210,7 @@ void Grindstone::Renderer::TransferRenderGraphBuilderPass::AddBufferTransfer(Bui
 void Grindstone::Renderer::PresentRenderGraphBuilderPass::SetPresentationImage(RenderGraphBuilderResourceRef targetImage) {
 	this->targetImage = targetImage;
 }
+
+Grindstone::Renderer::RenderGraphBuilderResourceRef Grindstone::Renderer::PresentRenderGraphBuilderPass::GetPresentationImage() const {
+	return targetImage;
+}
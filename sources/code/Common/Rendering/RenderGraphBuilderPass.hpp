@@ -29,6 +29,12 @@ namespace Grindstone::Renderer {
 		std::vector<PassBufferDesc> bufferRefs;
 		std::vector<PassImageDesc> imageRefs;
 
+		// Passes are culled when nothing uses their outputs, unless they affect something the graph doesn't track,
+		// like a readback buffer that isn't one of its resources.
+		bool hasSideEffects = false;
+
+		void SetHasSideEffects(bool hasSideEffects);
+
 		virtual Grindstone::UniquePtr<RenderGraphPass> ConstructExecutionPass() const = 0;
 	};
 
@@ -162,6 +168,7 @@ namespace Grindstone::Renderer {
 	class PresentRenderGraphBuilderPass : public RenderGraphBuilderPass {
 	public:
 		virtual void SetPresentationImage(RenderGraphBuilderResourceRef targetImage);
+		RenderGraphBuilderResourceRef GetPresentationImage() const;
 
 		virtual Grindstone::UniquePtr<RenderGraphPass> ConstructExecutionPass() const override {
 			auto pass = Grindstone::Memory::AllocatorCore::AllocateUnique<PresentRenderGraphPass>();
@@ -171,7 +178,7 @@ namespace Grindstone::Renderer {
 		}
 
 	protected:
-		RenderGraphBuilderResourceRef targetImage;
+		RenderGraphBuilderResourceRef targetImage = RenderGraphBuilderResourceRef::Invalid();
 
 	};
 
@@ -79,5 +79,22 @@ namespace Grindstone::Renderer {
 			TransientImageData& transientResource = *images.at(id);
 			return { transientResource.currentLayout, transientResource.currentAccessFlags, transientResource.currentPipelineStage };
 		}
+
+		void SetBufferAccess(
+			Grindstone::Renderer::ResourceId id,
+			Grindstone::GraphicsAPI::AccessFlags access,
+			Grindstone::GraphicsAPI::PipelineStageBit pipelineStage
+		) {
+			TransientBufferData& bufferResource = *buffers.at(id);
+			bufferResource.currentAccessFlags = access;
+			bufferResource.currentPipelineStage = pipelineStage;
+		}
+
+		std::tuple<Grindstone::GraphicsAPI::AccessFlags, Grindstone::GraphicsAPI::PipelineStageBit> GetBufferAccess(
+			Grindstone::Renderer::ResourceId id
+		) {
+			TransientBufferData& bufferResource = *buffers.at(id);
+			return { bufferResource.currentAccessFlags, bufferResource.currentPipelineStage };
+		}
 	};
 }
@@ -4,159 +4,6 @@
 
 using namespace Grindstone::Renderer;
 
-void Grindstone::Renderer::RenderGraphPass::SubmitBarriers(Grindstone::Renderer::RenderGraphContext& context) {
-	if (imageBarriers.empty() && bufferBarriers.empty()) {
-		return;
-	}
-
-	context.commandBuffer->PipelineBarrier(
-		bufferBarriers.data(),
-		static_cast<uint32_t>(bufferBarriers.size()),
-		imageBarriers.data(),
-		static_cast<uint32_t>(imageBarriers.size())
-	);
-}
-
-struct ImageUsageSyncInfo {
-	Grindstone::GraphicsAPI::PipelineStageBit stageMask;
-	Grindstone::GraphicsAPI::AccessFlags accessMask;
-	Grindstone::GraphicsAPI::ImageLayout layout;
-};
-
-static Grindstone::GraphicsAPI::PipelineStageBit DeriveShaderStageMask(Grindstone::GraphicsAPI::ShaderStageBit visibility) {
-	Grindstone::GraphicsAPI::PipelineStageBit mask = Grindstone::GraphicsAPI::PipelineStageBit::None;
-
-	if (static_cast<uint8_t>(visibility) & static_cast<uint8_t>(Grindstone::GraphicsAPI::ShaderStageBit::Vertex))
-		mask |= Grindstone::GraphicsAPI::PipelineStageBit::VertexShader;
-
-	if (static_cast<uint8_t>(visibility) & static_cast<uint8_t>(Grindstone::GraphicsAPI::ShaderStageBit::Fragment))
-		mask |= Grindstone::GraphicsAPI::PipelineStageBit::FragmentShader;
-
-	if (static_cast<uint8_t>(visibility) & static_cast<uint8_t>(Grindstone::GraphicsAPI::ShaderStageBit::Compute))
-		mask |= Grindstone::GraphicsAPI::PipelineStageBit::ComputeShader;
-
-	return mask;
-}
-
-static Grindstone::GraphicsAPI::ImageLayout DeriveDepthStencilLayout(
-	bool isDepth, bool isStencil,
-	bool isRead, bool isWrite
-) {
-	// TODO: Fix Stencil and DepthStencil variatns
-	if (isDepth && isStencil) {
-		if (isRead && !isWrite) return Grindstone::GraphicsAPI::ImageLayout::DepthRead;
-		return Grindstone::GraphicsAPI::ImageLayout::DepthWrite;
-	}
-
-	if (isDepth) {
-		if (isRead && !isWrite) return Grindstone::GraphicsAPI::ImageLayout::DepthRead;
-		return Grindstone::GraphicsAPI::ImageLayout::DepthWrite;
-	}
-
-	if (isStencil) {
-		if (isRead && !isWrite) return Grindstone::GraphicsAPI::ImageLayout::DepthRead;
-		return Grindstone::GraphicsAPI::ImageLayout::DepthWrite;
-	}
-
-	return Grindstone::GraphicsAPI::ImageLayout::Undefined;
-}
-
-static ImageUsageSyncInfo DeriveImageSyncInfo(
-	RenderGraphImageUsage usage,
-	Grindstone::GraphicsAPI::ShaderStageBit visibility = Grindstone::GraphicsAPI::ShaderStageBit::AllGraphics
-) {
-	const bool isRead = Any(usage & RenderGraphImageUsage::Read);
-	const bool isWrite = Any(usage & RenderGraphImageUsage::Write);
-	const bool isSampled = Any(usage & RenderGraphImageUsage::Sampled);
-	const bool isStorage = Any(usage & RenderGraphImageUsage::Storage);
-	const bool isColor = Any(usage & RenderGraphImageUsage::ColorAttachment);
-	const bool isDepth = Any(usage & RenderGraphImageUsage::DepthAttachment);
-	const bool isStencil = Any(usage & RenderGraphImageUsage::StencilAttachment);
-	const bool isSubpassInput = Any(usage & RenderGraphImageUsage::SubpassInputAttachment);
-	const bool isTransfer = Any(usage & RenderGraphImageUsage::Transfer);
-
-	Grindstone::GraphicsAPI::PipelineStageBit stageMask = Grindstone::GraphicsAPI::PipelineStageBit::None;
-	Grindstone::GraphicsAPI::AccessFlags accessMask = Grindstone::GraphicsAPI::AccessFlags::None;
-	Grindstone::GraphicsAPI::ImageLayout layout = Grindstone::GraphicsAPI::ImageLayout::Undefined;
-
-	// Transfer
-	if (isTransfer) {
-		if (isRead) {
-			stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::Transfer;
-			accessMask |= Grindstone::GraphicsAPI::AccessFlags::TransferRead;
-			layout = Grindstone::GraphicsAPI::ImageLayout::TransferSrc;
-		}
-		if (isWrite) {
-			stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::Transfer;
-			accessMask |= Grindstone::GraphicsAPI::AccessFlags::TransferWrite;
-			layout = Grindstone::GraphicsAPI::ImageLayout::TransferDst;
-		}
-		// Transfer is mutually exclusive with other usage types
-		// so return early — no further flag combinations are valid
-		return { stageMask, accessMask, layout };
-	}
-
-	// Color Attachment
-	if (isColor) {
-		stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::ColorAttachmentOutput;
-
-		if (isRead)  accessMask |= Grindstone::GraphicsAPI::AccessFlags::ColorAttachmentRead;
-		if (isWrite) accessMask |= Grindstone::GraphicsAPI::AccessFlags::ColorAttachmentWrite;
-
-		layout = Grindstone::GraphicsAPI::ImageLayout::ColorAttachment;
-	}
-
-	// Depth / Stencil Attachment
-	if (isDepth || isStencil) {
-		// Stage: early + late fragment tests cover all depth/stencil access
-		stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::EarlyFragmentTests
-			| Grindstone::GraphicsAPI::PipelineStageBit::LateFragmentTests;
-
-		if (isRead)  accessMask |= Grindstone::GraphicsAPI::AccessFlags::DepthStencilAttachmentRead;
-		if (isWrite) accessMask |= Grindstone::GraphicsAPI::AccessFlags::DepthStencilAttachmentWrite;
-
-		// Layout is determined by the combination of depth+stencil × read+write
-		layout = DeriveDepthStencilLayout(isDepth, isStencil, isRead, isWrite);
-	}
-
-	// Sampled (shader read via sampler)
-	if (isSampled && isRead) {
-		stageMask |= DeriveShaderStageMask(visibility);
-		accessMask |= Grindstone::GraphicsAPI::AccessFlags::ShaderRead;
-
-		// Only set layout here if no attachment flags are present
-		// Attachment flags take precedence and produce read-only variants
-		if (!isDepth && !isStencil && !isColor && !isSubpassInput) {
-			layout = Grindstone::GraphicsAPI::ImageLayout::ShaderRead;
-		}
-		// If combined with depth/stencil, layout stays as depth read-only variant
-		// (DEPTH_READ_ONLY_OPTIMAL also permits shader sampling)
-	}
-
-	// Storage Image (shader read/write without sampler)
-	if (isStorage) {
-		stageMask |= DeriveShaderStageMask(visibility);
-
-		if (isRead)  accessMask |= Grindstone::GraphicsAPI::AccessFlags::ShaderRead;
-		if (isWrite) accessMask |= Grindstone::GraphicsAPI::AccessFlags::ShaderWrite;
-
-		layout = Grindstone::GraphicsAPI::ImageLayout::General;
-	}
-
-	// Subpass Input Attachment
-	if (isSubpassInput && isRead) {
-		stageMask |= Grindstone::GraphicsAPI::PipelineStageBit::FragmentShader;
-		accessMask |= Grindstone::GraphicsAPI::AccessFlags::InputAttachmentRead;
-		layout = Grindstone::GraphicsAPI::ImageLayout::ShaderRead;
-	}
-
-	if (isStorage && (isColor || isDepth || isStencil)) {
-		layout = Grindstone::GraphicsAPI::ImageLayout::General;
-	}
-
-	return { stageMask, accessMask, layout };
-}
-
 void Grindstone::Renderer::PipelineRenderGraphPass::RealizeResources(
 	Grindstone::Renderer::RenderGraphContext& context,
 	Grindstone::Renderer::RenderGraphFrameResources& frameResources
@@ -215,54 +62,24 @@ void Grindstone::Renderer::PipelineRenderGraphPass::RealizeResources(
 				}
 			);
 		}
-
-		auto [prevLayout, prevAccessFlags, prevPipelineStage] = frameResources.GetLayout(imageRef);
-		auto [newStageMask, newAccessMask, newImageLayout] = DeriveImageSyncInfo(imageDesc.usage);
-
-
-		if (
-			prevLayout != newImageLayout ||
-			prevAccessFlags != newAccessMask ||
-			prevPipelineStage != newStageMask
-		) {
-			Grindstone::GraphicsAPI::ImageAspectBits imageAspect = Any(GraphicsAPI::GetFormatDepthStencilType(image->GetFormat()) & GraphicsAPI::FormatDepthStencilType::Depth)
-				? Grindstone::GraphicsAPI::ImageAspectBits::Depth
-				: Grindstone::GraphicsAPI::ImageAspectBits::Color;
-
-			Grindstone::GraphicsAPI::ImageBarrier imageBarrier{
-				.image = image,
-				.srcStageMask = prevPipelineStage,
-				.dstStageMask = newStageMask,
-				.oldLayout = prevLayout,
-				.newLayout = newImageLayout,
-				.srcAccess = prevAccessFlags,
-				.dstAccess = newAccessMask,
-				.imageAspect = imageAspect,
-				.baseMipLevel = 0,
-				.levelCount = 1,
-				.baseArrayLayer = 0,
-				.layerCount = 1
-			};
-
-			frameResources.SetLayout(imageRef, newImageLayout, newAccessMask, newStageMask);
-			imageBarriers.emplace_back(imageBarrier);
-		}
 	}
 
+	// Buffers are bound after samplers and images, as storage buffers in the order they were declared.
 	for (const Grindstone::Renderer::PassBufferDesc& bufferDesc : bufferDescs) {
-		/*
-		if (bufferDesc.accessType != AccessType::Write) {
-			layoutBindings.emplace_back(
-				Grindstone::GraphicsAPI::DescriptorSetLayout::Binding{
-					.
-				}
-			);
+		ResourceId bufferRef = bufferDesc.ref.GetResourceIndex();
+		Grindstone::GraphicsAPI::Buffer* buffer = frameResources.GetBuffer(bufferRef);
+		bindings.emplace_back(GraphicsAPI::DescriptorSet::Binding::StorageBuffer(buffer));
 
-			bindings.emplace_back(
-				Grindstone::GraphicsAPI::DescriptorSet::Binding::
-			);
-		}
-		*/
+		layoutBindings.emplace_back(
+			GraphicsAPI::DescriptorSetLayout::Binding{
+				.bindingId = currentBinding++,
+				.count = 1,
+				.type = Grindstone::GraphicsAPI::BindingType::StorageBuffer,
+				.stages = (type == GpuPassType::Compute
+					? Grindstone::GraphicsAPI::ShaderStageBit::Compute
+					: Grindstone::GraphicsAPI::ShaderStageBit::AllGraphics)
+			}
+		);
 	}
 
 	std::vector<Grindstone::GraphicsAPI::DescriptorSetLayout*> descriptorSetLayouts{
@@ -308,8 +125,6 @@ void Grindstone::Renderer::PipelineRenderGraphPass::RealizeResources(
 }
 
 void Grindstone::Renderer::ComputeRenderGraphPassBase::PrepareComputePass(Grindstone::Renderer::RenderGraphContext& context) {
-	SubmitBarriers(context);
-
 	std::vector<GraphicsAPI::DescriptorSet*> descriptorSets = {
 		context.globalDescriptorSet
 	};
@@ -325,8 +140,6 @@ Grindstone::Math::IntRect2D Grindstone::Renderer::GraphicsRenderGraphPassBase::P
 	Grindstone::Renderer::RenderGraphContext& context,
 	Grindstone::Renderer::RenderGraphFrameResources& frameResources
 ) {
-	SubmitBarriers(context);
-
 	Grindstone::Math::IntRect2D renderingArea = metaRenderingArea.Resolve(context.swapchainSize);
 
 	std::vector<GraphicsAPI::RenderAttachment> colorAttachments;
@@ -411,8 +224,6 @@ void Grindstone::Renderer::TransferRenderGraphPass::Execute(
 	Grindstone::Renderer::RenderGraphContext& context,
 	Grindstone::Renderer::RenderGraphFrameResources& frameResources
 ) {
-	SubmitBarriers(context);
-
 	for (const ImageTransfer& copy : imageTransfers) {
 		GraphicsAPI::ImageAspectBits aspect = GraphicsAPI::ImageAspectBits::Color;
 		Grindstone::GraphicsAPI::Image* srcImg = copy.src;
@@ -452,5 +263,4 @@ void Grindstone::Renderer::PresentRenderGraphPass::Execute(
 	Grindstone::Renderer::RenderGraphContext& context,
 	Grindstone::Renderer::RenderGraphFrameResources& frameResources
 ) {
-	SubmitBarriers(context);
 }
@@ -34,13 +34,6 @@ namespace Grindstone::Renderer {
 		Grindstone::String name;
 		GpuPassType type;
 
-		std::vector<Grindstone::GraphicsAPI::ImageBarrier> imageBarriers;
-		std::vector<Grindstone::GraphicsAPI::BufferBarrier> bufferBarriers;
-
-	protected:
-
-		void SubmitBarriers(Grindstone::Renderer::RenderGraphContext& context);
-
 	};
 
 	class PipelineRenderGraphPass : public RenderGraphPass {
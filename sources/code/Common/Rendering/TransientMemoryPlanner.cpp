@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <numeric>
+
+#include "TransientMemoryPlanner.hpp"
+
+using namespace Grindstone::Renderer;
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+	return ((value + alignment - 1) / alignment) * alignment;
+}
+
+static bool AreLifetimesOverlapping(const TransientMemoryRequest& a, const TransientMemoryRequest& b) {
+	return a.firstLevel <= b.lastLevel && b.firstLevel <= a.lastLevel;
+}
+
+TransientMemoryPlan Grindstone::Renderer::PlanTransientMemory(const std::vector<TransientMemoryRequest>& requests) {
+	TransientMemoryPlan plan;
+	plan.offsets.resize(requests.size(), 0);
+
+	std::vector<size_t> placementOrder(requests.size());
+	std::iota(placementOrder.begin(), placementOrder.end(), size_t(0));
+	std::stable_sort(
+		placementOrder.begin(), placementOrder.end(),
+		[&requests](size_t lhs, size_t rhs) {
+			return requests[lhs].size > requests[rhs].size;
+		}
+	);
+
+	struct MemoryRange {
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	std::vector<size_t> placedRequests;
+	std::vector<MemoryRange> occupiedRanges;
+	placedRequests.reserve(requests.size());
+	occupiedRanges.reserve(requests.size());
+
+	for (size_t requestIndex : placementOrder) {
+		const TransientMemoryRequest& request = requests[requestIndex];
+		const uint64_t alignment = std::max<uint64_t>(request.alignment, 1);
+		plan.unaliasedSize += request.size;
+
+		// Only memory used by requests that are alive at the same time is off limits.
+		occupiedRanges.clear();
+		for (size_t placedIndex : placedRequests) {
+			if (AreLifetimesOverlapping(request, requests[placedIndex])) {
+				const uint64_t offset = plan.offsets[placedIndex];
+				occupiedRanges.push_back(MemoryRange{ offset, offset + requests[placedIndex].size });
+			}
+		}
+
+		std::sort(
+			occupiedRanges.begin(), occupiedRanges.end(),
+			[](const MemoryRange& lhs, const MemoryRange& rhs) {
+				return lhs.begin < rhs.begin;
+			}
+		);
+
+		// Find the first gap large enough, skipping past every range the request would overlap.
+		uint64_t offset = 0;
+		for (const MemoryRange& range : occupiedRanges) {
+			if (offset + request.size <= range.begin) {
+				break;
+			}
+
+			offset = std::max(offset, AlignUp(range.end, alignment));
+		}
+
+		plan.offsets[requestIndex] = offset;
+		plan.heapSize = std::max(plan.heapSize, offset + request.size);
+		placedRequests.push_back(requestIndex);
+	}
+
+	return plan;
+}
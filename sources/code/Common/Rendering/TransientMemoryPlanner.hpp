@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace Grindstone::Renderer {
+	// A transient allocation that is alive from firstLevel to lastLevel of a render graph, inclusively.
+	struct TransientMemoryRequest {
+		uint64_t size = 0;
+		uint64_t alignment = 1;
+		uint32_t firstLevel = 0;
+		uint32_t lastLevel = 0;
+	};
+
+	struct TransientMemoryPlan {
+		// The offset of each request into the heap, in the order they were requested.
+		std::vector<uint64_t> offsets;
+		// The size of a heap holding every request, where requests with disjoint lifetimes share memory.
+		uint64_t heapSize = 0;
+		// The memory needed if every request had its own allocation.
+		uint64_t unaliasedSize = 0;
+	};
+
+	/*
+	 * Packs transient allocations into a single heap. Larger allocations are placed first, each at the
+	 * lowest aligned offset that doesn't overlap an allocation already placed with an overlapping lifetime.
+	 */
+	TransientMemoryPlan PlanTransientMemory(const std::vector<TransientMemoryRequest>& requests);
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <Common/Graphics/Core.hpp>
 
 #include <EngineCore/EngineCore.hpp>
@@ -5,6 +7,9 @@
 #include "TransientResourceManager.hpp"
 
 const int8_t USED_LIFETIME = 3;
+// Alignments that placed resources need on common hardware, used when planning a shared heap.
+const uint64_t IMAGE_PLACEMENT_ALIGNMENT = 64 * 1024;
+const uint64_t BUFFER_PLACEMENT_ALIGNMENT = 256;
 
 static Grindstone::Renderer::TransientImageDescription ToTransient(
 	Grindstone::Renderer::ImageDescription desc,
@@ -38,6 +43,29 @@ static Grindstone::Renderer::TransientBufferDescription ToTransient(
 	};
 }
 
+static uint64_t EstimateImageMemorySize(const Grindstone::Renderer::TransientImageDescription& desc) {
+	const uint64_t bytesPerPixel = Grindstone::GraphicsAPI::GetFormatBytesPerPixel(desc.format);
+
+	uint64_t mipChainSize = 0;
+	for (uint32_t mip = 0; mip < desc.mipLevels; ++mip) {
+		const uint64_t width = std::max(desc.size.x >> mip, 1u);
+		const uint64_t height = std::max(desc.size.y >> mip, 1u);
+		const uint64_t depth = std::max(desc.depth >> mip, 1u);
+		mipChainSize += width * height * depth * bytesPerPixel;
+	}
+
+	return mipChainSize * desc.arrayLayers * desc.samples;
+}
+
+// CPU-visible contents may be read after the graph runs, so only GPU-only resources are shared within a frame.
+static bool CanReuseThisFrame(
+	Grindstone::GraphicsAPI::MemoryUsage memoryUsage,
+	uint32_t lastUsedLevel,
+	Grindstone::Renderer::TransientResourceLifetime lifetime
+) {
+	return memoryUsage == Grindstone::GraphicsAPI::MemoryUsage::GPUOnly && lastUsedLevel < lifetime.firstLevel;
+}
+
 void Grindstone::Renderer::TransientResourceManager::BeginFrame() {
 	Grindstone::GraphicsAPI::Core* graphicsCore = Grindstone::EngineCore::GetInstance().GetGraphicsCore();
 
@@ -76,23 +104,36 @@ void Grindstone::Renderer::TransientResourceManager::BeginFrame() {
 
 	std::erase_if(images, [](auto& kv) { return kv.second.empty(); });
 	std::erase_if(buffers, [](auto& kv) { return kv.second.empty(); });
+
+	frameMemoryRequests.clear();
 }
 
 Grindstone::Renderer::TransientImageKey Grindstone::Renderer::TransientResourceManager::AcquireImage(
 	Math::Uint2 viewportResolution,
 	Math::Uint2 swapchainResolution,
-	const Grindstone::Renderer::ImageDescription& inDesc
+	const Grindstone::Renderer::ImageDescription& inDesc,
+	Grindstone::Renderer::TransientResourceLifetime lifetime
 ) {
 	TransientImageDescription desc = ToTransient(inDesc, viewportResolution, swapchainResolution);
+	const uint64_t memorySize = EstimateImageMemorySize(desc);
+	frameMemoryRequests.emplace_back(
+		TransientMemoryRequest{
+			.size = memorySize,
+			.alignment = IMAGE_PLACEMENT_ALIGNMENT,
+			.firstLevel = lifetime.firstLevel,
+			.lastLevel = lifetime.lastLevel
+		}
+	);
 
 	auto it = images.find(desc);
 	if (it != images.end()) {
 		auto& arr = it->second;
 		for (size_t index = 0; index < arr.size(); ++index) {
 			auto& img = it->second[index];
-			if (!img.isUsedThisFrame) {
+			if (!img.isUsedThisFrame || CanReuseThisFrame(desc.memoryUsage, img.lastUsedLevel, lifetime)) {
 				img.lifetime = USED_LIFETIME;
 				img.isUsedThisFrame = true;
+				img.lastUsedLevel = lifetime.lastLevel;
 				return { desc, index };
 			}
 		}
@@ -131,6 +172,8 @@ Grindstone::Renderer::TransientImageKey Grindstone::Renderer::TransientResourceM
 			},
 			.lifetime = USED_LIFETIME,
 			.isUsedThisFrame = true,
+			.lastUsedLevel = lifetime.lastLevel,
+			.memorySize = memorySize
 		}
 	);
 
@@ -138,18 +181,28 @@ Grindstone::Renderer::TransientImageKey Grindstone::Renderer::TransientResourceM
 }
 
 Grindstone::Renderer::TransientBufferKey Grindstone::Renderer::TransientResourceManager::AcquireBuffer(
-	const Grindstone::Renderer::BufferDescription& inDesc
+	const Grindstone::Renderer::BufferDescription& inDesc,
+	Grindstone::Renderer::TransientResourceLifetime lifetime
 ) {
 	TransientBufferDescription desc = ToTransient(inDesc);
+	frameMemoryRequests.emplace_back(
+		TransientMemoryRequest{
+			.size = desc.size,
+			.alignment = BUFFER_PLACEMENT_ALIGNMENT,
+			.firstLevel = lifetime.firstLevel,
+			.lastLevel = lifetime.lastLevel
+		}
+	);
 
 	auto it = buffers.find(desc);
 	if (it != buffers.end()) {
 		auto& arr = it->second;
 		for (size_t index = 0; index < arr.size(); ++index) {
 			auto& b = it->second[index];
-			if (!b.isUsedThisFrame) {
+			if (!b.isUsedThisFrame || CanReuseThisFrame(desc.memoryUsage, b.lastUsedLevel, lifetime)) {
 				b.lifetime = USED_LIFETIME;
 				b.isUsedThisFrame = true;
+				b.lastUsedLevel = lifetime.lastLevel;
 				return { desc, index };
 			}
 		}
@@ -176,10 +229,12 @@ Grindstone::Renderer::TransientBufferKey Grindstone::Renderer::TransientResource
 		PooledBuffer{
 			.data = TransientBufferData {
 				.buffer = buffer,
-				.currentAccessFlags = GraphicsAPI::AccessFlags::None
+				.currentAccessFlags = GraphicsAPI::AccessFlags::None,
+				.currentPipelineStage = GraphicsAPI::PipelineStageBit::None
 			},
 			.lifetime = USED_LIFETIME,
 			.isUsedThisFrame = true,
+			.lastUsedLevel = lifetime.lastLevel
 		}
 	);
 
@@ -201,3 +256,32 @@ Grindstone::Renderer::TransientBufferData& Grindstone::Renderer::TransientResour
 
 	return it->second[key.poolIndex].data;
 }
+
+Grindstone::Renderer::TransientMemoryStats Grindstone::Renderer::TransientResourceManager::GetMemoryStats() const {
+	TransientMemoryStats stats{};
+	stats.resourceCount = static_cast<uint32_t>(frameMemoryRequests.size());
+
+	for (const auto& [desc, pooledImages] : images) {
+		for (const PooledImage& pooledImage : pooledImages) {
+			if (pooledImage.isUsedThisFrame) {
+				stats.pooledBytes += pooledImage.memorySize;
+				++stats.pooledResourceCount;
+			}
+		}
+	}
+
+	for (const auto& [desc, pooledBuffers] : buffers) {
+		for (const PooledBuffer& pooledBuffer : pooledBuffers) {
+			if (pooledBuffer.isUsedThisFrame) {
+				stats.pooledBytes += desc.size;
+				++stats.pooledResourceCount;
+			}
+		}
+	}
+
+	for (const TransientMemoryRequest& request : frameMemoryRequests) {
+		stats.unaliasedBytes += request.size;
+	}
+
+	return stats;
+}
@@ -15,6 +15,7 @@
 #include "AttachmentInfo.hpp"
 #include "BufferInfo.hpp"
 #include "GpuPassType.hpp"
+#include "TransientMemoryPlanner.hpp"
 
 namespace Grindstone::GraphicsAPI {
 	class CommandBuffer;
@@ -73,6 +74,27 @@ namespace Grindstone::Renderer {
 	struct TransientBufferData {
 		GraphicsAPI::Buffer* buffer;
 		GraphicsAPI::AccessFlags currentAccessFlags;
+		Grindstone::GraphicsAPI::PipelineStageBit currentPipelineStage;
+	};
+
+	// The dependency levels of a compiled render graph that use a resource, inclusively.
+	struct TransientResourceLifetime {
+		uint32_t firstLevel = UINT32_MAX;
+		uint32_t lastLevel = 0;
+
+		bool IsUsed() const {
+			return firstLevel != UINT32_MAX;
+		}
+	};
+
+	// Transient memory of the last frame, to compare how much aliasing saves.
+	struct TransientMemoryStats {
+		// Every transient resource in its own allocation.
+		uint64_t unaliasedBytes = 0;
+		// The pooled resources used, after resources with disjoint lifetimes shared them.
+		uint64_t pooledBytes = 0;
+		uint32_t resourceCount = 0;
+		uint32_t pooledResourceCount = 0;
 	};
 
 	union TransientResourceUnion {
@@ -143,28 +165,37 @@ namespace Grindstone::Renderer {
 	public:
 		void BeginFrame();
 
-		TransientImageKey AcquireImage(Math::Uint2 viewportResolution, Math::Uint2 swapchainResolution, const ImageDescription& desc);
-		TransientBufferKey AcquireBuffer(const BufferDescription& desc);
+		// Resources should be acquired in order of their first level, so a later resource can reuse
+		// a GPU-only resource of the same description once every pass using it has run.
+		TransientImageKey AcquireImage(Math::Uint2 viewportResolution, Math::Uint2 swapchainResolution, const ImageDescription& desc, TransientResourceLifetime lifetime);
+		TransientBufferKey AcquireBuffer(const BufferDescription& desc, TransientResourceLifetime lifetime);
 
 		Grindstone::Renderer::TransientImageData& GetTrackedImage(TransientImageKey key);
 		Grindstone::Renderer::TransientBufferData& GetTrackedBuffer(TransientBufferKey key);
 
+		TransientMemoryStats GetMemoryStats() const;
+
 	protected:
 
 		struct PooledImage {
 			TransientImageData data;
 			int8_t lifetime;
 			bool isUsedThisFrame = false;
+			uint32_t lastUsedLevel = 0;
+			uint64_t memorySize = 0;
 		};
 
 		struct PooledBuffer {
 			TransientBufferData data;
 			int8_t lifetime;
 			bool isUsedThisFrame = false;
+			uint32_t lastUsedLevel = 0;
 		};
 
 		std::unordered_map<TransientImageDescription, std::vector<PooledImage>> images;
 		std::unordered_map<TransientBufferDescription, std::vector<PooledBuffer>> buffers;
+		// Every resource acquired this frame, with the memory it would need in its own allocation.
+		std::vector<TransientMemoryRequest> frameMemoryRequests;
 
 	};
 }
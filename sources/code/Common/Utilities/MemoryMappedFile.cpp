@@ -0,0 +1,87 @@
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MemoryMappedFile.hpp"
+
+using namespace Grindstone::Utilities;
+
+MemoryMappedFile::~MemoryMappedFile() {
+	Close();
+}
+
+bool MemoryMappedFile::Open(const std::filesystem::path& path) {
+	Close();
+
+#if defined(_WIN32)
+	HANDLE fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	CloseHandle(fileHandle);
+	if (mappingHandle == nullptr) {
+		return false;
+	}
+
+	// The view keeps the mapping object alive, so neither handle is needed past this point.
+	void* mappedPtr = MapViewOfFile(mappingHandle, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mappingHandle);
+	if (mappedPtr == nullptr) {
+		return false;
+	}
+
+	data = static_cast<Grindstone::Byte*>(mappedPtr);
+	size = static_cast<uint64_t>(fileSize.QuadPart);
+	return true;
+#elif defined(__linux__)
+	const int fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (fileDescriptor == -1) {
+		return false;
+	}
+
+	struct stat fileStats{};
+	if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size == 0) {
+		close(fileDescriptor);
+		return false;
+	}
+
+	// The mapping keeps its own reference to the file, so the descriptor can be closed right away.
+	void* mappedPtr = mmap(nullptr, static_cast<size_t>(fileStats.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor);
+	if (mappedPtr == MAP_FAILED) {
+		return false;
+	}
+
+	data = static_cast<Grindstone::Byte*>(mappedPtr);
+	size = static_cast<uint64_t>(fileStats.st_size);
+	return true;
+#endif
+}
+
+void MemoryMappedFile::Close() {
+	if (data == nullptr) {
+		return;
+	}
+
+#if defined(_WIN32)
+	UnmapViewOfFile(data);
+#elif defined(__linux__)
+	munmap(data, static_cast<size_t>(size));
+#endif
+
+	data = nullptr;
+	size = 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+
+#include <Common/IntTypes.hpp>
+
+namespace Grindstone::Utilities {
+	/*
+	 * Maps a whole file into memory, so its contents are paged in on first access instead of read
+	 * up front. The mapping is copy-on-write: writes through GetData() are private to this process
+	 * and never reach the file.
+	 */
+	class MemoryMappedFile {
+	public:
+		MemoryMappedFile() = default;
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+		~MemoryMappedFile();
+
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		[[nodiscard]] bool IsOpen() const {
+			return data != nullptr;
+		}
+
+		[[nodiscard]] Grindstone::Byte* GetData() const {
+			return data;
+		}
+
+		[[nodiscard]] uint64_t GetSize() const {
+			return size;
+		}
+
+	private:
+		Grindstone::Byte* data = nullptr;
+		uint64_t size = 0;
+	};
+}
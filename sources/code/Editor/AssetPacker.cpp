@@ -0,0 +1,654 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <Common/Assets/ArchiveCompression.hpp>
+#include <Common/Assets/ArchiveDirectoryWriter.hpp>
+#include <Common/Hash.hpp>
+#include <EngineCore/Jobs/JobSystem.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
+#include <EngineCore/Utils/Utilities.hpp>
+
+#include "AssetPacker.hpp"
+
+namespace Grindstone::Assets {
+	/*
+	 * Streams new blobs into staged archive files on its own thread, in the order they are queued, so
+	 * packing never waits on the disk. Each archive is filled from front to back, which lets its CRC be
+	 * built up as it is written. Queueing blocks while too many bytes are waiting to be written.
+	 */
+	class ArchiveWriter {
+	public:
+		ArchiveWriter(std::filesystem::path outputDirectory, std::string archiveName) :
+			outputDirectory(std::move(outputDirectory)), archiveName(std::move(archiveName)) {
+			writerThread = std::thread(&ArchiveWriter::WriterLoop, this);
+		}
+
+		ArchiveWriter(const ArchiveWriter&) = delete;
+		ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+		~ArchiveWriter() {
+			// A build that failed partway through has already reported its error, so only the thread needs stopping here.
+			try {
+				Finish();
+			}
+			catch (const std::exception&) {}
+		}
+
+		std::filesystem::path GetStagedArchivePath(size_t stagedArchiveIndex) const {
+			return outputDirectory / (archiveName + "_staged_" + std::to_string(stagedArchiveIndex) + ".garc.tmp");
+		}
+
+		// The writer holds its own reference to data until the blob is on disk, so callers can keep a weak_ptr to tell when it has been written.
+		void Write(size_t stagedArchiveIndex, uint64_t offset, uint64_t size, std::shared_ptr<const BlobData> data) {
+			{
+				std::unique_lock lock(mutex);
+				writtenCondition.wait(lock, [this] {
+					return queuedByteCount < maxQueuedByteCount || pendingWrites.empty();
+				});
+
+				queuedByteCount += size;
+				pendingWrites.push_back(PendingWrite{ stagedArchiveIndex, offset, size, std::move(data) });
+			}
+
+			queuedCondition.notify_one();
+		}
+
+		// Reads back a blob that is already on disk, which is once the writer has released its data.
+		bool Read(size_t stagedArchiveIndex, uint64_t offset, uint64_t size, std::vector<Byte>& outData) const {
+			std::ifstream input(GetStagedArchivePath(stagedArchiveIndex), std::ios::binary);
+			outData.resize(size);
+			input.seekg(static_cast<std::streamoff>(offset));
+			return static_cast<bool>(input.read(reinterpret_cast<char*>(outData.data()), static_cast<std::streamsize>(size)));
+		}
+
+		// Waits for every queued write and closes the staged archives. Throws if any write failed.
+		void Finish() {
+			{
+				std::scoped_lock lock(mutex);
+				if (isFinished) {
+					return;
+				}
+
+				isFinished = true;
+			}
+
+			queuedCondition.notify_one();
+			writerThread.join();
+			archiveStreams.clear();
+
+			if (!errorMessage.empty()) {
+				throw std::runtime_error(errorMessage);
+			}
+		}
+
+		uint32_t GetArchiveCrc(size_t stagedArchiveIndex) const {
+			return stagedArchiveIndex < archiveCrcs.size()
+				? archiveCrcs[stagedArchiveIndex]
+				: 0;
+		}
+
+	private:
+		struct PendingWrite {
+			size_t stagedArchiveIndex;
+			uint64_t offset;
+			uint64_t size;
+			std::shared_ptr<const BlobData> data;
+		};
+
+		void WriterLoop() {
+			while (true) {
+				PendingWrite pendingWrite;
+				{
+					std::unique_lock lock(mutex);
+					writtenCondition.notify_all();
+					queuedCondition.wait(lock, [this] {
+						return isFinished || !pendingWrites.empty();
+					});
+
+					if (pendingWrites.empty()) {
+						break;
+					}
+
+					pendingWrite = std::move(pendingWrites.front());
+					pendingWrites.pop_front();
+					queuedByteCount -= pendingWrite.size;
+				}
+
+				WriteToArchive(pendingWrite);
+			}
+
+			Grindstone::Memory::AllocatorCore::FlushThreadCache();
+		}
+
+		void WriteToArchive(const PendingWrite& pendingWrite) {
+			const size_t archiveIndex = pendingWrite.stagedArchiveIndex;
+			if (archiveIndex >= archiveStreams.size()) {
+				archiveStreams.resize(archiveIndex + 1);
+				archiveCrcs.resize(archiveIndex + 1, 0);
+			}
+
+			std::unique_ptr<std::ofstream>& archiveStream = archiveStreams[archiveIndex];
+			if (archiveStream == nullptr) {
+				const std::filesystem::path path = GetStagedArchivePath(archiveIndex);
+				archiveStream = std::make_unique<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+				if (!archiveStream->is_open()) {
+					errorMessage = std::string("Failed to open ") + path.string();
+					return;
+				}
+			}
+
+			const char* data = reinterpret_cast<const char*>(pendingWrite.data->Get());
+			archiveStream->seekp(static_cast<std::streamoff>(pendingWrite.offset));
+			archiveStream->write(data, static_cast<std::streamsize>(pendingWrite.size));
+			archiveStream->flush();
+			if (!*archiveStream) {
+				errorMessage = std::string("Failed to write ") + GetStagedArchivePath(archiveIndex).string();
+			}
+
+			archiveCrcs[archiveIndex] = Hash::Crc32(data, pendingWrite.size, archiveCrcs[archiveIndex]);
+		}
+
+		// Bounds how much packed data can wait in memory for the disk to catch up.
+		const uint64_t maxQueuedByteCount = 512ull * 1024ull * 1024ull;
+
+		std::filesystem::path outputDirectory;
+		std::string archiveName;
+		std::thread writerThread;
+
+		std::mutex mutex;
+		std::condition_variable queuedCondition;
+		std::condition_variable writtenCondition;
+		std::deque<PendingWrite> pendingWrites;
+		uint64_t queuedByteCount = 0;
+		bool isFinished = false;
+
+		// Only touched by the writer thread until it has been joined.
+		std::vector<std::unique_ptr<std::ofstream>> archiveStreams;
+		std::vector<uint32_t> archiveCrcs;
+		std::string errorMessage;
+	};
+
+	// Assets whose formats are already compressed gain nothing from another pass, so they are stored as is.
+	static ArchiveCompression GetCompressionForAssetType(AssetType assetType) {
+		switch (assetType) {
+			case AssetType::AudioClip:
+				return ArchiveCompression::None;
+			default:
+				return ArchiveCompression::Lz4Blocks;
+		}
+	}
+
+	// Archives that are mostly unreferenced are repacked instead of kept, so dead blobs don't pile up across builds.
+	constexpr double minKeptArchiveLiveFraction = 0.5;
+
+	AssetPacker::AssetPacker(
+		std::filesystem::path compiledAssetsPath,
+		std::filesystem::path outputDirectory,
+		std::string archiveName,
+		CookSceneFunction cookScene
+	) :
+		compiledAssetsPath(std::move(compiledAssetsPath)),
+		outputDirectory(std::move(outputDirectory)),
+		archiveName(std::move(archiveName)),
+		cookScene(std::move(cookScene)) {
+		archiveWriter = std::make_unique<ArchiveWriter>(this->outputDirectory, this->archiveName);
+		packedAssets.resize(static_cast<size_t>(AssetType::Count));
+	}
+
+	AssetPacker::~AssetPacker() = default;
+
+	void AssetPacker::PackEntries(
+		const std::vector<Editor::AssetRegistry::Entry>& entries,
+		Jobs::JobSystem& jobSystem,
+		const std::function<void(float)>& onProgress
+	) {
+		// Assets are prepared a window at a time, which bounds how many are held in memory before they're written.
+		const size_t windowSize = std::max<size_t>(jobSystem.GetThreadCount() * 4, 16);
+		std::vector<PreparedAsset> preparedAssets(windowSize);
+		for (size_t windowBegin = 0; windowBegin < entries.size(); windowBegin += windowSize) {
+			const size_t windowEnd = std::min(entries.size(), windowBegin + windowSize);
+			jobSystem.ParallelFor(windowBegin, windowEnd, 1, [&](size_t entryIndex) {
+				preparedAssets[entryIndex - windowBegin] = PrepareEntry(entries[entryIndex]);
+			});
+
+			for (size_t entryIndex = windowBegin; entryIndex < windowEnd; ++entryIndex) {
+				CommitEntry(entries[entryIndex], preparedAssets[entryIndex - windowBegin]);
+			}
+
+			if (onProgress) {
+				onProgress(static_cast<float>(windowEnd) / static_cast<float>(entries.size()));
+			}
+		}
+	}
+
+	std::filesystem::path AssetPacker::GetArchivePath(size_t archiveIndex) const {
+		return outputDirectory / (archiveName + "_" + std::to_string(archiveIndex) + ".garc");
+	}
+
+	bool AssetPacker::IsPreviousBlobIntact(const ArchiveDirectoryFile::AssetInfo& asset) const {
+		return
+			asset.archiveIndex < previousArchives.size() &&
+			previousArchives[asset.archiveIndex].isValid &&
+			asset.offset + asset.size <= previousArchives[asset.archiveIndex].fileSize;
+	}
+
+	void AssetPacker::LoadPreviousBuild() {
+		const std::filesystem::path directoryPath = outputDirectory / (archiveName + ".gdir");
+		const std::filesystem::path buildCachePath = outputDirectory / (archiveName + ".gbuild");
+		// A directory from an older version is ignored, so everything gets repacked.
+		if (previousDirectory.Open(directoryPath) != ArchiveDirectoryOpenStatus::Success) {
+			return;
+		}
+
+		previousArchives.resize(previousDirectory.GetArchiveCount());
+		for (size_t archiveIndex = 0; archiveIndex < previousArchives.size(); ++archiveIndex) {
+			const std::filesystem::path archivePath = GetArchivePath(archiveIndex);
+			PreviousArchive& previousArchive = previousArchives[archiveIndex];
+			previousArchive.isValid = std::filesystem::exists(archivePath);
+			if (previousArchive.isValid) {
+				previousArchive.fileSize = std::filesystem::file_size(archivePath);
+			}
+		}
+
+		// Every blob in the previous archives can be shared with an asset of this build that has the same contents.
+		std::set<std::pair<uint16_t, uint64_t>> registeredBlobs;
+		for (uint16_t assetTypeIndex = 0; assetTypeIndex < static_cast<uint16_t>(AssetType::Count); ++assetTypeIndex) {
+			for (const ArchiveDirectoryFile::AssetInfo& asset : previousDirectory.GetAssets(static_cast<AssetType>(assetTypeIndex))) {
+				if (!IsPreviousBlobIntact(asset) || !registeredBlobs.emplace(asset.archiveIndex, asset.offset).second) {
+					continue;
+				}
+
+				BlobLocation blob{ true, asset.archiveIndex, asset.offset, asset.size, asset.uncompressedSize, asset.compression, asset.crc };
+				blobsByContent[BlobKey{ blob.crc, blob.uncompressedSize, blob.compression }].push_back(blob);
+			}
+		}
+
+		std::ifstream buildCacheFile(buildCachePath, std::ios::binary);
+		BuildCacheFile::Header header;
+		if (!buildCacheFile.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+			return;
+		}
+
+		if (strncmp(header.signature, "GBLD", 4) != 0 || header.version != BuildCacheFile::CURRENT_VERSION) {
+			return;
+		}
+
+		std::vector<BuildCacheFile::Entry> entries(header.entryCount);
+		if (!buildCacheFile.read(reinterpret_cast<char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(BuildCacheFile::Entry)))) {
+			return;
+		}
+
+		for (const BuildCacheFile::Entry& entry : entries) {
+			previousBuildCache[{ entry.assetType, entry.uuid }] = entry;
+		}
+	}
+
+	PreparedAsset AssetPacker::PrepareEntry(const Editor::AssetRegistry::Entry& entry) const {
+		PreparedAsset preparedAsset;
+		const std::filesystem::path actualFilePath = compiledAssetsPath / entry.uuid.ToString();
+		if (!std::filesystem::exists(actualFilePath)) {
+			preparedAsset.isCompiledFileMissing = true;
+			return preparedAsset;
+		}
+
+		BuildCacheFile::Entry& buildCacheEntry = preparedAsset.buildCacheEntry;
+		buildCacheEntry.uuid = entry.uuid;
+		buildCacheEntry.assetType = entry.assetType;
+		buildCacheEntry.compiledFileWriteTime = static_cast<int64_t>(std::filesystem::last_write_time(actualFilePath).time_since_epoch().count());
+		buildCacheEntry.compiledFileSize = std::filesystem::file_size(actualFilePath);
+
+		// If the compiled file hasn't changed since the last build, its blob can be reused without reading it.
+		// Cooked scenes also depend on the layout of their components, so they're always cooked again.
+		auto previousCacheIterator = previousBuildCache.find({ entry.assetType, entry.uuid });
+		if (previousCacheIterator != previousBuildCache.end() && entry.assetType != AssetType::Scene) {
+			const BuildCacheFile::Entry& previousCacheEntry = previousCacheIterator->second;
+			const ArchiveDirectoryFile::AssetInfo* previousAsset = previousDirectory.FindAsset(entry.assetType, entry.uuid);
+			if (
+				previousCacheEntry.compiledFileWriteTime == buildCacheEntry.compiledFileWriteTime &&
+				previousCacheEntry.compiledFileSize == buildCacheEntry.compiledFileSize &&
+				previousAsset != nullptr &&
+				previousAsset->crc == previousCacheEntry.crc &&
+				IsPreviousBlobIntact(*previousAsset)
+			) {
+				preparedAsset.isReused = true;
+				preparedAsset.blob = BlobLocation{
+					true,
+					previousAsset->archiveIndex,
+					previousAsset->offset,
+					previousAsset->size,
+					previousAsset->uncompressedSize,
+					previousAsset->compression,
+					previousAsset->crc
+				};
+				buildCacheEntry.crc = previousAsset->crc;
+				return preparedAsset;
+			}
+		}
+
+		BlobData& data = preparedAsset.data;
+		data.fileData = Utils::LoadFile(actualFilePath.string().c_str());
+		if (entry.assetType == AssetType::Scene && cookScene) {
+			cookScene(entry, data.fileData);
+		}
+
+		const uint64_t uncompressedSize = data.fileData.GetCapacity();
+		const uint32_t crc = Hash::Crc32(data.fileData.Get(), uncompressedSize);
+
+		// Fall back to storing the asset raw if compression doesn't make it any smaller.
+		ArchiveCompression compression = GetCompressionForAssetType(entry.assetType);
+		if (compression == ArchiveCompression::Lz4Blocks) {
+			if (CompressArchiveBlocks(data.fileData.Get(), uncompressedSize, data.compressedData)) {
+				data.fileData.Clear();
+			}
+			else {
+				data.compressedData.clear();
+				compression = ArchiveCompression::None;
+			}
+		}
+
+		const uint64_t size = compression == ArchiveCompression::None
+			? uncompressedSize
+			: data.compressedData.size();
+
+		preparedAsset.blob = BlobLocation{ false, 0, 0, size, uncompressedSize, compression, crc };
+		buildCacheEntry.crc = crc;
+		return preparedAsset;
+	}
+
+	void AssetPacker::CommitEntry(const Editor::AssetRegistry::Entry& entry, PreparedAsset& preparedAsset) {
+		if (preparedAsset.isCompiledFileMissing) {
+			return;
+		}
+
+		const char* copiedNamePtr = static_cast<const char*>(resizableStringBuffer.AddToBuffer(entry.displayName.c_str(), entry.displayName.size() + 1));
+		const char* copiedAddressPtr = static_cast<const char*>(resizableStringBuffer.AddToBuffer(entry.address.c_str(), entry.address.size() + 1));
+		PackedAsset& packedAsset = packedAssets[static_cast<size_t>(entry.assetType)][entry.uuid];
+		packedAsset.displayName = copiedNamePtr;
+		packedAsset.address = copiedAddressPtr;
+
+		buildCache.push_back(preparedAsset.buildCacheEntry);
+		totalUncompressedSize += preparedAsset.blob.uncompressedSize;
+		totalStoredSize += preparedAsset.blob.size;
+
+		if (preparedAsset.isReused) {
+			packedAsset.blob = preparedAsset.blob;
+			++reusedAssetCount;
+			return;
+		}
+
+		if (TryFindDuplicateBlob(preparedAsset.blob, preparedAsset.data.Get(), packedAsset.blob)) {
+			++deduplicatedAssetCount;
+			preparedAsset.data = BlobData{};
+			return;
+		}
+
+		packedAsset.blob = AddNewBlob(preparedAsset.blob, std::move(preparedAsset.data));
+		++writtenAssetCount;
+	}
+
+	const Byte* AssetPacker::GetPreviousBlobData(const BlobLocation& blob) {
+		PreviousArchive& previousArchive = previousArchives[blob.archiveIndex];
+		if (previousArchive.mappedFile == nullptr) {
+			previousArchive.mappedFile = std::make_unique<Utilities::MemoryMappedFile>();
+			if (!previousArchive.mappedFile->Open(GetArchivePath(blob.archiveIndex))) {
+				return nullptr;
+			}
+		}
+
+		if (!previousArchive.mappedFile->IsOpen()) {
+			return nullptr;
+		}
+
+		return previousArchive.mappedFile->GetData() + blob.offset;
+	}
+
+	bool AssetPacker::TryFindDuplicateBlob(const BlobLocation& blob, const Byte* storedData, BlobLocation& outDuplicate) {
+		auto blobIterator = blobsByContent.find(BlobKey{ blob.crc, blob.uncompressedSize, blob.compression });
+		if (blobIterator == blobsByContent.end()) {
+			return false;
+		}
+
+		// Hashes can collide, so only share blobs whose bytes actually match.
+		for (const BlobLocation& candidate : blobIterator->second) {
+			if (candidate.size != blob.size) {
+				continue;
+			}
+
+			// Blobs still waiting to be written are compared in memory, so this never waits on the writer.
+			const Byte* candidateData = nullptr;
+			const std::shared_ptr<const BlobData> queuedData = candidate.isInPreviousArchive
+				? nullptr
+				: FindQueuedBlobData(candidate);
+			if (candidate.isInPreviousArchive) {
+				candidateData = GetPreviousBlobData(candidate);
+			}
+			else if (queuedData != nullptr) {
+				candidateData = queuedData->Get();
+			}
+			else if (archiveWriter->Read(candidate.archiveIndex, candidate.offset, candidate.size, readBackBuffer)) {
+				candidateData = readBackBuffer.data();
+			}
+
+			if (candidateData != nullptr && memcmp(candidateData, storedData, blob.size) == 0) {
+				outDuplicate = candidate;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::shared_ptr<const BlobData> AssetPacker::FindQueuedBlobData(const BlobLocation& blob) {
+		auto queuedIterator = queuedBlobData.find({ blob.archiveIndex, blob.offset });
+		if (queuedIterator == queuedBlobData.end()) {
+			return nullptr;
+		}
+
+		std::shared_ptr<const BlobData> data = queuedIterator->second.lock();
+		if (data == nullptr) {
+			// Already written, so it can be read back from the staged archive from now on.
+			queuedBlobData.erase(queuedIterator);
+		}
+
+		return data;
+	}
+
+	BlobLocation AssetPacker::AddNewBlob(const BlobLocation& blob, BlobData&& data) {
+		const uint16_t newArchiveIndex = FindSuitableArchiveIndex(blob.size);
+		NewArchive& newArchive = newArchives[newArchiveIndex];
+
+		BlobLocation newBlob = blob;
+		newBlob.isInPreviousArchive = false;
+		newBlob.archiveIndex = newArchiveIndex;
+		newBlob.offset = newArchive.usedSize;
+		newArchive.usedSize += blob.size;
+
+		std::shared_ptr<const BlobData> sharedData = std::make_shared<const BlobData>(std::move(data));
+		queuedBlobData[{ newBlob.archiveIndex, newBlob.offset }] = sharedData;
+		archiveWriter->Write(newBlob.archiveIndex, newBlob.offset, newBlob.size, std::move(sharedData));
+		blobsByContent[BlobKey{ newBlob.crc, newBlob.uncompressedSize, newBlob.compression }].push_back(newBlob);
+		return newBlob;
+	}
+
+	void AssetPacker::FinalizeArchives() {
+		// Find out how much of each previous archive this build still uses.
+		std::vector<uint64_t> liveBytes(previousArchives.size(), 0);
+		std::set<std::pair<uint16_t, uint64_t>> liveBlobs;
+		for (const std::map<Uuid, PackedAsset>& assetsOfType : packedAssets) {
+			for (const auto& [uuid, asset] : assetsOfType) {
+				if (asset.blob.isInPreviousArchive && liveBlobs.emplace(asset.blob.archiveIndex, asset.blob.offset).second) {
+					liveBytes[asset.blob.archiveIndex] += asset.blob.size;
+				}
+			}
+		}
+
+		// Keep archives that are still mostly in use as they are, and move the live blobs of the rest into new archives.
+		std::vector<bool> isArchiveKept(previousArchives.size(), false);
+		std::vector<uint16_t> newArchiveIndices(previousArchives.size(), 0);
+		std::map<std::pair<uint16_t, uint64_t>, BlobLocation> movedBlobs;
+		keptArchiveCount = 0;
+		for (size_t archiveIndex = 0; archiveIndex < previousArchives.size(); ++archiveIndex) {
+			const PreviousArchive& previousArchive = previousArchives[archiveIndex];
+			isArchiveKept[archiveIndex] =
+				previousArchive.isValid &&
+				liveBytes[archiveIndex] > 0 &&
+				static_cast<double>(liveBytes[archiveIndex]) >= minKeptArchiveLiveFraction * static_cast<double>(previousArchive.fileSize);
+
+			if (isArchiveKept[archiveIndex]) {
+				newArchiveIndices[archiveIndex] = static_cast<uint16_t>(keptArchiveCount++);
+			}
+		}
+
+		for (const std::map<Uuid, PackedAsset>& assetsOfType : packedAssets) {
+			for (const auto& [uuid, asset] : assetsOfType) {
+				const BlobLocation& blob = asset.blob;
+				if (!blob.isInPreviousArchive || isArchiveKept[blob.archiveIndex] || movedBlobs.contains({ blob.archiveIndex, blob.offset })) {
+					continue;
+				}
+
+				const Byte* blobData = GetPreviousBlobData(blob);
+				if (blobData == nullptr) {
+					throw std::runtime_error(std::string("Failed to map ") + GetArchivePath(blob.archiveIndex).string());
+				}
+
+				BlobData movedData;
+				movedData.compressedData.assign(blobData, blobData + blob.size);
+				movedBlobs[{ blob.archiveIndex, blob.offset }] = AddNewBlob(blob, std::move(movedData));
+			}
+		}
+
+		archiveWriter->Finish();
+
+		archiveDirectory.archives.clear();
+		archiveDirectory.archives.resize(keptArchiveCount + newArchives.size(), ArchiveDirectory::ArchiveInfo{ 0 });
+		for (size_t archiveIndex = 0; archiveIndex < previousArchives.size(); ++archiveIndex) {
+			if (isArchiveKept[archiveIndex]) {
+				archiveDirectory.archives[newArchiveIndices[archiveIndex]].crc = previousDirectory.GetArchiveCrc(archiveIndex);
+			}
+		}
+
+		for (size_t newArchiveIndex = 0; newArchiveIndex < newArchives.size(); ++newArchiveIndex) {
+			archiveDirectory.archives[keptArchiveCount + newArchiveIndex].crc = archiveWriter->GetArchiveCrc(newArchiveIndex);
+		}
+
+		for (size_t assetType = 0; assetType < packedAssets.size(); ++assetType) {
+			std::map<Uuid, ArchiveDirectory::AssetInfo>& assetTypeMap = archiveDirectory.assetTypeIndices[assetType].assetsByUuid;
+			for (const auto& [uuid, asset] : packedAssets[assetType]) {
+				BlobLocation blob = asset.blob;
+				if (blob.isInPreviousArchive && !isArchiveKept[blob.archiveIndex]) {
+					blob = movedBlobs[{ blob.archiveIndex, blob.offset }];
+				}
+
+				const uint16_t archiveIndex = blob.isInPreviousArchive
+					? newArchiveIndices[blob.archiveIndex]
+					: static_cast<uint16_t>(keptArchiveCount + blob.archiveIndex);
+
+				assetTypeMap[uuid] = {
+					asset.displayName,
+					asset.address,
+					blob.crc,
+					archiveIndex,
+					blob.offset,
+					blob.size,
+					blob.uncompressedSize,
+					blob.compression
+				};
+			}
+		}
+
+		// Every blob has been copied out of the previous archives, so they can be renamed and deleted now.
+		for (PreviousArchive& previousArchive : previousArchives) {
+			previousArchive.mappedFile.reset();
+		}
+
+		// The previous directory is about to be overwritten, so it can't stay mapped.
+		previousDirectory.Close();
+
+		for (size_t archiveIndex = 0; archiveIndex < previousArchives.size(); ++archiveIndex) {
+			if (!isArchiveKept[archiveIndex]) {
+				std::filesystem::remove(GetArchivePath(archiveIndex));
+			}
+		}
+
+		// Kept archives only ever move to a lower index, so renaming them in order never overwrites one still to be moved.
+		for (size_t archiveIndex = 0; archiveIndex < previousArchives.size(); ++archiveIndex) {
+			if (isArchiveKept[archiveIndex] && newArchiveIndices[archiveIndex] != archiveIndex) {
+				std::filesystem::rename(GetArchivePath(archiveIndex), GetArchivePath(newArchiveIndices[archiveIndex]));
+			}
+		}
+
+		for (size_t newArchiveIndex = 0; newArchiveIndex < newArchives.size(); ++newArchiveIndex) {
+			std::filesystem::rename(archiveWriter->GetStagedArchivePath(newArchiveIndex), GetArchivePath(keptArchiveCount + newArchiveIndex));
+		}
+
+		// Clear out archives left behind by a build whose directory couldn't be read.
+		for (size_t archiveIndex = archiveDirectory.archives.size(); std::filesystem::exists(GetArchivePath(archiveIndex)); ++archiveIndex) {
+			std::filesystem::remove(GetArchivePath(archiveIndex));
+		}
+	}
+
+	uint16_t AssetPacker::FindSuitableArchiveIndex(uint64_t size) {
+		for (size_t i = 0; i < newArchives.size(); ++i) {
+			if (newArchives[i].capacity - newArchives[i].usedSize >= size) {
+				return static_cast<uint16_t>(i);
+			}
+		}
+
+		// If this asset size is bigger than an entire archive (this probably shouldn't happen), then make the archive just this file.
+		uint64_t newArchiveSize = size > archiveSize
+			? size
+			: archiveSize;
+
+		// If no available archive has enough space, add a new one
+		newArchives.push_back(NewArchive{ newArchiveSize, 0 });
+
+		return static_cast<uint16_t>(newArchives.size() - 1);
+	}
+
+	void AssetPacker::WriteDirectory() {
+		const std::filesystem::path outputPath = outputDirectory / (archiveName + ".gdir");
+		if (!WriteArchiveDirectory(outputPath, archiveDirectory)) {
+			throw std::runtime_error(std::string("Failed to write ") + outputPath.string());
+		}
+	}
+
+	uint64_t AssetPacker::GetUncompressedSize() const {
+		return totalUncompressedSize;
+	}
+
+	uint64_t AssetPacker::GetStoredSize() const {
+		return totalStoredSize;
+	}
+
+	size_t AssetPacker::GetReusedAssetCount() const {
+		return reusedAssetCount;
+	}
+
+	size_t AssetPacker::GetDeduplicatedAssetCount() const {
+		return deduplicatedAssetCount;
+	}
+
+	size_t AssetPacker::GetWrittenAssetCount() const {
+		return writtenAssetCount;
+	}
+
+	void AssetPacker::WriteBuildCache() const {
+		const std::filesystem::path outputPath = outputDirectory / (archiveName + ".gbuild");
+		std::ofstream output(outputPath, std::ios::binary);
+
+		if (!output.is_open()) {
+			throw std::runtime_error(std::string("Failed to open ") + outputPath.string());
+		}
+
+		BuildCacheFile::Header header;
+		header.entryCount = buildCache.size();
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		output.write(reinterpret_cast<const char*>(buildCache.data()), static_cast<std::streamsize>(buildCache.size() * sizeof(BuildCacheFile::Entry)));
+	}
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <Common/Buffer.hpp>
+#include <Common/Assets/ArchiveDirectory.hpp>
+#include <Common/Assets/ArchiveDirectoryFile.hpp>
+#include <Common/Assets/ArchiveDirectoryView.hpp>
+#include <Common/Utilities/MemoryMappedFile.hpp>
+
+#include "Editor/AssetRegistry.hpp"
+
+namespace Grindstone::Jobs {
+	class JobSystem;
+}
+
+namespace Grindstone::Assets {
+	class ArchiveWriter;
+
+	// Remembers which compiled file each asset was packed from, so the next build can reuse unchanged assets without reading them.
+	struct BuildCacheFile {
+		const static uint32_t CURRENT_VERSION = 1;
+
+		struct Header {
+			const char signature[4] = { 'G', 'B', 'L', 'D' };
+			uint32_t version = CURRENT_VERSION;
+			uint64_t entryCount = 0;
+		};
+
+		struct Entry {
+			Grindstone::Uuid uuid;
+			AssetType assetType;
+			int64_t compiledFileWriteTime;
+			uint64_t compiledFileSize;
+			uint32_t crc;
+		};
+	};
+
+	// Where an asset's bytes are stored. Blobs in the previous build's archives use their old archive index until the archives are renumbered.
+	struct BlobLocation {
+		bool isInPreviousArchive = false;
+		uint16_t archiveIndex = 0;
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		uint64_t uncompressedSize = 0;
+		ArchiveCompression compression = ArchiveCompression::None;
+		uint32_t crc = 0;
+	};
+
+	// The bytes of a blob waiting to be written. Compressed blobs live in compressedData, and raw ones in fileData.
+	struct BlobData {
+		Grindstone::Buffer fileData;
+		std::vector<Byte> compressedData;
+
+		[[nodiscard]] const Byte* Get() const {
+			return compressedData.empty()
+				? fileData.Get()
+				: compressedData.data();
+		}
+	};
+
+	// Everything about an asset that can be worked out on its own, so it can be done on any thread.
+	struct PreparedAsset {
+		bool isCompiledFileMissing = false;
+		// The compiled file is unchanged since the last build, so blob points into a previous archive and data is empty.
+		bool isReused = false;
+		BuildCacheFile::Entry buildCacheEntry{};
+		BlobLocation blob;
+		BlobData data;
+	};
+
+	/*
+	 * Packs compiled assets into archives and writes the directory the game loads them through. Assets
+	 * unchanged since the previous build in the same directory keep their blobs, and assets with the same
+	 * contents share one blob.
+	 */
+	class AssetPacker {
+	public:
+		// Replaces a json scene with its cooked form in place. Returns false to pack the json as it is.
+		using CookSceneFunction = std::function<bool(const Editor::AssetRegistry::Entry& entry, Buffer& fileData)>;
+
+		AssetPacker(
+			std::filesystem::path compiledAssetsPath,
+			std::filesystem::path outputDirectory,
+			std::string archiveName,
+			CookSceneFunction cookScene = {}
+		);
+		~AssetPacker();
+
+		void LoadPreviousBuild();
+		// Prepares entries on the job system and commits them in order. Entries must be in the same order every build to produce the same archives.
+		void PackEntries(
+			const std::vector<Editor::AssetRegistry::Entry>& entries,
+			Jobs::JobSystem& jobSystem,
+			const std::function<void(float)>& onProgress = {}
+		);
+		// Reads, hashes and compresses an asset. Only reads state that is fixed once the previous build is loaded, so it can run on any thread.
+		PreparedAsset PrepareEntry(const Editor::AssetRegistry::Entry& entry) const;
+		// Places a prepared asset into the archives. Must be called in the same order every build to produce the same archives.
+		void CommitEntry(const Editor::AssetRegistry::Entry& entry, PreparedAsset& preparedAsset);
+		void FinalizeArchives();
+		void WriteDirectory();
+		void WriteBuildCache() const;
+		uint16_t FindSuitableArchiveIndex(uint64_t size);
+		uint64_t GetUncompressedSize() const;
+		uint64_t GetStoredSize() const;
+		size_t GetReusedAssetCount() const;
+		size_t GetDeduplicatedAssetCount() const;
+		size_t GetWrittenAssetCount() const;
+	protected:
+		struct PackedAsset {
+			std::string_view displayName;
+			std::string_view address;
+			BlobLocation blob;
+		};
+
+		struct PreviousArchive {
+			bool isValid = false;
+			uint64_t fileSize = 0;
+			std::unique_ptr<Utilities::MemoryMappedFile> mappedFile;
+		};
+
+		struct NewArchive {
+			uint64_t capacity = 0;
+			uint64_t usedSize = 0;
+		};
+
+		// Blobs are matched on their hash, uncompressed size and compression, then on their stored bytes.
+		using BlobKey = std::tuple<uint32_t, uint64_t, ArchiveCompression>;
+
+		std::filesystem::path GetArchivePath(size_t archiveIndex) const;
+		bool IsPreviousBlobIntact(const ArchiveDirectoryFile::AssetInfo& asset) const;
+		const Byte* GetPreviousBlobData(const BlobLocation& blob);
+		bool TryFindDuplicateBlob(const BlobLocation& blob, const Byte* storedData, BlobLocation& outDuplicate);
+		// Returns the in-memory data of a new blob that hasn't been written yet, or nullptr once it is on disk.
+		std::shared_ptr<const BlobData> FindQueuedBlobData(const BlobLocation& blob);
+		BlobLocation AddNewBlob(const BlobLocation& blob, BlobData&& data);
+
+		ArchiveDirectory archiveDirectory;
+		std::vector<NewArchive> newArchives;
+		const uint64_t archiveSize = 1024ul * 1024ul * 200ul; // 200mb
+
+		std::filesystem::path compiledAssetsPath;
+		std::filesystem::path outputDirectory;
+		ResizableBuffer resizableStringBuffer{10485760}; // 10mb
+		std::string archiveName;
+		std::unique_ptr<ArchiveWriter> archiveWriter;
+		CookSceneFunction cookScene;
+		std::vector<Byte> readBackBuffer;
+		uint64_t totalUncompressedSize = 0;
+		uint64_t totalStoredSize = 0;
+
+		ArchiveDirectoryView previousDirectory;
+		std::vector<PreviousArchive> previousArchives;
+		std::map<std::pair<AssetType, Uuid>, BuildCacheFile::Entry> previousBuildCache;
+		std::vector<BuildCacheFile::Entry> buildCache;
+		std::map<BlobKey, std::vector<BlobLocation>> blobsByContent;
+		// The data of new blobs, by archive index and offset, which stays readable until the writer has put it on disk.
+		std::map<std::pair<uint16_t, uint64_t>, std::weak_ptr<const BlobData>> queuedBlobData;
+		std::vector<std::map<Uuid, PackedAsset>> packedAssets;
+		// Previous archives kept as they are, in their new order. New archives are numbered after them.
+		size_t keptArchiveCount = 0;
+
+		size_t reusedAssetCount = 0;
+		size_t deduplicatedAssetCount = 0;
+		size_t writtenAssetCount = 0;
+	};
+}
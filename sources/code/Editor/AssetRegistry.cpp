@@ -1,6 +1,7 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <rapidjson/document.h>
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/stringbuffer.h>
@@ -31,6 +32,7 @@ void AssetRegistry::Initialize(const std::filesystem::path& projectPath) {
 }
 
 void AssetRegistry::Cleanup() {
+	std::unique_lock lock(assetsMutex);
 	assets.clear();
 }
 
@@ -52,6 +54,7 @@ void AssetRegistry::UpdateEntry(
 	TryGetPathWithMountPoint(path, mountedPath);
 	Utils::FixPathSlashes(mountedPath);
 
+	std::unique_lock lock(assetsMutex);
 	assets[uuid] = Entry{
 		.uuid = uuid,
 		.displayName = std::string(displayName),
@@ -113,6 +116,7 @@ void AssetRegistry::WriteFile() {
 }
 
 void AssetRegistry::ReadFile() {
+	std::unique_lock lock(assetsMutex);
 	assets.clear();
 	if (!std::filesystem::exists(assetRegistryPath)) {
 		return;
@@ -214,10 +218,12 @@ const std::filesystem::path& AssetRegistry::GetCompiledAssetsPath() const {
 }
 
 bool AssetRegistry::RemoveEntry(Uuid uuid) {
+	std::unique_lock lock(assetsMutex);
 	return assets.erase(uuid) != 0;
 }
 
 bool AssetRegistry::HasAsset(Uuid uuid) const {
+	std::shared_lock lock(assetsMutex);
 	return assets.find(uuid) != assets.end();
 }
 
@@ -240,6 +246,7 @@ bool AssetRegistry::TryGetAssetDataFromAbsolutePath(const std::filesystem::path&
 		return false;
 	}
 
+	std::shared_lock lock(assetsMutex);
 	for (const auto& [_, assetEntry] : assets) {
 		if (assetEntry.path == mountedPath) {
 			outEntry = assetEntry;
@@ -251,6 +258,7 @@ bool AssetRegistry::TryGetAssetDataFromAbsolutePath(const std::filesystem::path&
 }
 
 bool AssetRegistry::TryGetAssetData(const std::filesystem::path& path, AssetRegistry::Entry& outEntry) const {
+	std::shared_lock lock(assetsMutex);
 	for (const auto& [_, assetEntry] : assets) {
 		if (assetEntry.path == path) {
 			outEntry = assetEntry;
@@ -262,6 +270,7 @@ bool AssetRegistry::TryGetAssetData(const std::filesystem::path& path, AssetRegi
 }
 
 bool AssetRegistry::TryGetAssetData(const std::string& address, AssetRegistry::Entry& outEntry) const {
+	std::shared_lock lock(assetsMutex);
 	for (const auto& [_, assetEntry] : assets) {
 		if (assetEntry.address == address) {
 			outEntry = assetEntry;
@@ -273,6 +282,7 @@ bool AssetRegistry::TryGetAssetData(const std::string& address, AssetRegistry::E
 }
 
 bool AssetRegistry::TryGetAssetData(Uuid uuid, AssetRegistry::Entry& outEntry) const {
+	std::shared_lock lock(assetsMutex);
 	const auto& assetIterator = assets.find(uuid);
 	if (assetIterator == assets.end()) {
 		return false;
@@ -283,6 +293,7 @@ bool AssetRegistry::TryGetAssetData(Uuid uuid, AssetRegistry::Entry& outEntry) c
 }
 
 void AssetRegistry::FindAllFilesOfType(AssetType assetType, std::vector<Entry>& outEntries) const {
+	std::shared_lock lock(assetsMutex);
 	for (const auto& [_, entry] : assets) {
 		if (entry.assetType == assetType) {
 			outEntries.push_back(entry);
@@ -292,6 +303,7 @@ void AssetRegistry::FindAllFilesOfType(AssetType assetType, std::vector<Entry>&
 
 std::unordered_set<Grindstone::Uuid> Grindstone::Editor::AssetRegistry::GetUsedUuids() const {
 	std::unordered_set<Grindstone::Uuid> unusedUuids;
+	std::shared_lock lock(assetsMutex);
 
 	for (const auto& [uuid, _] : assets) {
 		unusedUuids.insert(uuid);
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <map>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 #include <unordered_set>
@@ -67,6 +68,8 @@ namespace Grindstone::Editor {
 
 		virtual std::unordered_set<Grindstone::Uuid> GetUsedUuids() const;
 	private:
+		// Assets are streamed in on other threads, which look up their entries while the editor may update them.
+		mutable std::shared_mutex assetsMutex;
 		std::map<Uuid, Entry> assets;
 		std::filesystem::path assetsPath;
 		std::filesystem::path compiledAssetsPath;
@@ -120,8 +120,13 @@ namespace Grindstone::Editor {
 			return;
 		}
 
+		// Archives from the last build are kept, so only the assets that changed since then need to be packed again.
 		if (std::filesystem::exists(targetPath)) {
-			std::filesystem::remove_all(targetPath);
+			for (const std::filesystem::directory_entry& directoryEntry : std::filesystem::directory_iterator(targetPath)) {
+				if (directoryEntry.path().filename() != "archives") {
+					std::filesystem::remove_all(directoryEntry.path());
+				}
+			}
 		}
 
 		const EngineCore& engine = Grindstone::Editor::Manager::GetEngineCore();
@@ -550,19 +550,21 @@ void EditorCamera::Render(GraphicsAPI::CommandBuffer* commandBuffer) {
 						(isBoundingSphereGizmoEnabled || isBoundingBoxGizmoEnabled) &&
 						selectedEntity.TryGetComponent<Grindstone::MeshComponent>(mesh)
 					) {
-						Grindstone::Mesh3dAsset* meshAsset = engineCore.assetManager->GetAssetByUuid<Grindstone::Mesh3dAsset>(mesh->mesh.uuid);
-						auto& boundingData = meshAsset->boundingData;
-						TransformComponent& transf = selectedEntity.GetComponent<TransformComponent>();
-						Math::Matrix4 matrix = TransformComponent::GetWorldTransformMatrix(selectedEntity);
-						glm::vec3 center = boundingData.sphereCenter;
-						glm::vec3 boxSize = boundingData.maxAABB - boundingData.minAABB;
-						matrix = matrix * glm::translate(center);
-						if (isBoundingSphereGizmoEnabled) {
-							gizmoRenderer.SubmitSphereGizmo(matrix, boundingData.sphereRadius, boundingSphereColor);
-						}
+						const Grindstone::Mesh3dAsset* meshAsset = mesh->mesh.Get();
+						if (meshAsset != nullptr) {
+							auto& boundingData = meshAsset->boundingData;
+							TransformComponent& transf = selectedEntity.GetComponent<TransformComponent>();
+							Math::Matrix4 matrix = TransformComponent::GetWorldTransformMatrix(selectedEntity);
+							glm::vec3 center = boundingData.sphereCenter;
+							glm::vec3 boxSize = boundingData.maxAABB - boundingData.minAABB;
+							matrix = matrix * glm::translate(center);
+							if (isBoundingSphereGizmoEnabled) {
+								gizmoRenderer.SubmitSphereGizmo(matrix, boundingData.sphereRadius, boundingSphereColor);
+							}
 
-						if (isBoundingBoxGizmoEnabled) {
-							gizmoRenderer.SubmitCubeGizmo(matrix, boxSize, boundingBoxColor);
+							if (isBoundingBoxGizmoEnabled) {
+								gizmoRenderer.SubmitCubeGizmo(matrix, boxSize, boundingBoxColor);
+							}
 						}
 					}
 
@@ -684,6 +686,8 @@ void EditorCamera::Render(GraphicsAPI::CommandBuffer* commandBuffer) {
 
 				Renderer::RenderGraphBuilderResourceRef outputRef = pass.WriteColorAttachment(resource, GraphicsAPI::LoadOp::Clear, clearColor);
 				pass.WriteDepthStencilAttachment(depthResourceDesc, GraphicsAPI::LoadOp::Clear, clearDepthStencil);
+				// The picked entity is written to mousePickResponseBuffer, which the graph doesn't track.
+				pass.SetHasSideEffects(true);
 				return outputRef;
 			},
 			[this, adjustedPerspectiveMatrix, pushStats, imageIndex](
@@ -728,7 +732,7 @@ void EditorCamera::Render(GraphicsAPI::CommandBuffer* commandBuffer) {
 		gizmoImageRef = callback(renderGraphBuilder, gizmoImageRef, depthImageRef);
 	}
 
-	auto renderGraph = renderGraphBuilder.Compile();
+	renderGraphBuilder.Compile(renderGraph);
 	renderGraph.ExecuteGraph(context);
 }
 
@@ -880,8 +884,8 @@ void EditorCamera::RenderPlayModeCamera(GraphicsAPI::CommandBuffer* commandBuffe
 		depthImageRef
 	);
 
-	auto renderGraph = renderGraphBuilder.Compile();
-	renderGraph.ExecuteGraph(context);
+	renderGraphBuilder.Compile(playModeRenderGraph);
+	playModeRenderGraph.ExecuteGraph(context);
 }
 
 const float maxAngle = 1.55f;
@@ -994,6 +998,20 @@ BaseRenderer* EditorCamera::GetRenderer() const {
 	return renderer;
 }
 
+Grindstone::Renderer::TransientMemoryStats EditorCamera::GetTransientMemoryStats() {
+	EngineCore& engineCore = Editor::Manager::GetInstance().GetEngineCore();
+	auto window = engineCore.windowManager->GetWindowByIndex(0);
+	auto wgb = window->GetWindowGraphicsBinding();
+	uint32_t imageIndex = wgb->GetCurrentImageIndex();
+
+	Grindstone::Renderer::TransientResourceManager* transientResourceManager = transientResourceManagers[imageIndex];
+	if (transientResourceManager == nullptr) {
+		return {};
+	}
+
+	return transientResourceManager->GetMemoryStats();
+}
+
 void Grindstone::Editor::EditorCamera::ClearRenderer() {
 	gizmoRenderCallbacks.clear();
 	AllocatorCore::Free(renderer);
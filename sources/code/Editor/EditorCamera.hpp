@@ -56,6 +56,8 @@ namespace Grindstone {
 			glm::mat4& GetProjectionMatrix();
 			glm::mat4& GetViewMatrix();
 			BaseRenderer* GetRenderer() const;
+			// The transient render graph memory used by the frame of the current swapchain image.
+			static Grindstone::Renderer::TransientMemoryStats GetTransientMemoryStats();
 			void ClearRenderer();
 
 			glm::vec3 GetPosition() const;
@@ -103,6 +105,9 @@ namespace Grindstone {
 			std::array<GraphicsAPI::Buffer*, 3> mousePickResponseBuffer{};
 
 			BaseRenderer* renderer = nullptr;
+			// Reused while the passes declared each frame keep the same topology.
+			Grindstone::Renderer::RenderGraph renderGraph;
+			Grindstone::Renderer::RenderGraph playModeRenderGraph;
 			glm::mat4 projection;
 			glm::mat4 view;
 			glm::vec3 position = glm::vec3();
@@ -20,6 +20,7 @@
 #include <Editor/PluginSystem/EditorPluginInterface.hpp>
 #include <Editor/PluginSystem/EditorPluginManager.hpp>
 #include <Editor/ImguiEditor/ViewportPanel.hpp>
+#include <EngineCore/CoreComponents/Transform/WorldTransformComponent.hpp>
 #include <EngineCore/Rendering/BaseRenderer.hpp>
 #include <EngineCore/EngineCore.hpp>
 #include <EngineCore/Scenes/Manager.hpp>
@@ -180,6 +181,10 @@ void Manager::Run() {
 			engineCore->RunLoopIteration();
 			break;
 		case PlayMode::Pause:
+			// The viewport keeps rendering while paused, so frames must still be recycled.
+			engineCore->BeginFrame();
+			// Systems don't run while paused, but entities can still be moved in the editor.
+			UpdateWorldTransforms(engineCore->GetEntityRegistry());
 			break;
 		}
 
@@ -1,8 +1,10 @@
 #include <imgui.h>
+#include <cinttypes>
 #include <vector>
 
 #include <Editor/EditorCamera.hpp>
 #include <Editor/EditorManager.hpp>
+#include <Common/Graphics/Core.hpp>
 #include <EngineCore/EngineCore.hpp>
 #include <EngineCore/Utils/MemoryAllocator.hpp>
 #include <EngineCore/Assets/AssetManager.hpp>
@@ -69,9 +71,9 @@ void RenderAsset(Grindstone::Assets::AssetManager* assetManager, const char* tit
 				ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg0, color);
 				ImGui::TableNextRow();
 				ImGui::TableNextColumn();
-				ImGui::Text("%s", asset.second.name.c_str());
+				ImGui::Text("%s", asset.name.c_str());
 				ImGui::TableNextColumn();
-				ImGui::Text("%lu", asset.second.referenceCount);
+				ImGui::Text("%zu", asset.referenceCount.Get());
 			}
 
 			ImGui::EndTable();
@@ -129,6 +131,35 @@ static void RenderRenderQueueTable(const char* name, Grindstone::BaseRenderer* r
 	}
 }
 
+static void RenderTransientMemoryTable() {
+	if (!ImGui::TreeNode("Transient Render Graph Memory")) {
+		return;
+	}
+
+	const Grindstone::Renderer::TransientMemoryStats stats = Grindstone::Editor::EditorCamera::GetTransientMemoryStats();
+	const uint64_t oneKB = 1024u;
+	ImGui::Text("Resources: %u (%u pooled)", stats.resourceCount, stats.pooledResourceCount);
+	ImGui::Text("Without Aliasing: %" PRIu64 "KB", stats.unaliasedBytes / oneKB);
+	ImGui::Text("Pooled With Aliasing: %" PRIu64 "KB", stats.pooledBytes / oneKB);
+
+	ImGui::TreePop();
+}
+
+static void RenderGpuMemoryTable(Grindstone::EngineCore& engineCore) {
+	if (!ImGui::TreeNode("GPU Memory")) {
+		return;
+	}
+
+	const Grindstone::GraphicsAPI::MemoryStats stats = engineCore.GetGraphicsCore()->GetMemoryStats();
+	const uint64_t oneKB = 1024u;
+	ImGui::Text("Budget: %" PRIu64 "KB", stats.budgetBytes / oneKB);
+	ImGui::Text("Usage: %" PRIu64 "KB", stats.usageBytes / oneKB);
+	ImGui::Text("Blocks: %u (%" PRIu64 "KB)", stats.blockCount, stats.blockBytes / oneKB);
+	ImGui::Text("Allocations: %u (%" PRIu64 "KB)", stats.allocationCount, stats.allocationBytes / oneKB);
+
+	ImGui::TreePop();
+}
+
 static void RenderRenderQueuesTable(Grindstone::EngineCore& engineCore) {
 	if (!ImGui::TreeNode("Render Queues")) {
 		return;
@@ -195,16 +226,18 @@ void StatsPanel::RenderContents() {
 		if (ImGui::Button("Capture Memory Dump")) {
 			memoryDumpData.hasCapturedMemoryDump = true;
 
-			const auto& nameMap = AllocatorCore::GetAllocatorState()->dynamicAllocator.GetNameMap();
+			// Small blocks live in the thread caches' spans, so only the larger allocations keep their names.
+			Memory::Allocators::ThreadCachingAllocator& allocator = AllocatorCore::GetAllocatorState()->allocator;
+			std::scoped_lock lock(allocator.GetBackingAllocatorMutex());
+			const Memory::Allocators::DynamicAllocator& backingAllocator = allocator.GetBackingAllocator();
+			const auto& nameMap = backingAllocator.GetNameMap();
 
 			memoryDumpData.rows.reserve(nameMap.size());
 
-			using AllocatorHeader = Memory::Allocators::DynamicAllocator::AllocationHeader;
-			char* memStart = static_cast<char*>(AllocatorCore::GetAllocatorState()->dynamicAllocator.GetMemory());
+			char* memStart = static_cast<char*>(backingAllocator.GetMemory());
 			for (const auto& allocation : nameMap) {
-				AllocatorHeader* header = reinterpret_cast<AllocatorHeader*>(static_cast<char*>(allocation.first) - sizeof(AllocatorHeader));
 				size_t offset = static_cast<size_t>(static_cast<char*>(allocation.first) - memStart);
-				memoryDumpData.rows.emplace_back(MemoryDumpRow{ allocation.second, header->blockSize, allocation.first, offset });
+				memoryDumpData.rows.emplace_back(MemoryDumpRow{ allocation.second, backingAllocator.GetAllocationSize(allocation.first), allocation.first, offset });
 			}
 		}
 
@@ -257,6 +290,8 @@ void StatsPanel::RenderContents() {
 	Assets::AssetManager* assetManager = engineCore.assetManager;
 
 	RenderRenderQueuesTable(engineCore);
+	RenderTransientMemoryTable();
+	RenderGpuMemoryTable(engineCore);
 
 	RenderAsset<MaterialImporter>(assetManager, "Materials");
 	RenderAsset<ComputePipelineImporter>(assetManager, "Compute Pipeline Sets");
@@ -12,8 +12,8 @@ namespace Grindstone::Editor::ImguiEditor {
 		if (isShowingPanel) {
 			ImGui::Begin("Systems", &isShowingPanel);
 
-			for (auto& system : systemRegistrar->systemFactories) {
-				RenderSystem(system.first.c_str());
+			for (auto& system : systemRegistrar->systems) {
+				RenderSystem(system.name.c_str());
 			}
 
 			ImGui::End();
@@ -29,11 +29,11 @@ static void ValuesGetter(
 	}
 
 	if (caption != nullptr) {
-		*caption = stage.name.c_str();
+		*caption = stage.name;
 	}
 
 	if (level != nullptr) {
-		*level = stage.depth - 1;
+		*level = static_cast<ImU8>(stage.depth);
 	}
 }
 
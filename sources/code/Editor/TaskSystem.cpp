@@ -1,13 +1,12 @@
 #include <Windows.h>
 
+#include <EngineCore/EngineCore.hpp>
+#include <EngineCore/Jobs/JobSystem.hpp>
+
 #include "TaskSystem.hpp"
 
 using namespace Grindstone::Editor;
 
-
-Task::Task(const Task& other)
-	: fnPtr(other.fnPtr), name(other.name), status(other.status), thread() {}
-
 TaskSystem::TaskSystem() {
 }
 
@@ -33,24 +32,30 @@ void TaskSystem::Execute(std::string jobName, std::function<void()> jobPtr) {
 		Task& task = tasks[uuid];
 		task.name = jobName;
 		task.fnPtr = jobPtr;
-		task.status = Task::Status::InProgress;
+		task.status = Task::Status::Queued;
 	}
 
-#ifndef GS_SINGLETHREAD_EDITOR
-	tasks[uuid].thread = std::thread([jobPtr, uuid, this]
-#endif
-	{
+	auto taskFn = [jobPtr, uuid, this] {
+		{
+			std::scoped_lock lock(mutex);
+			tasks[uuid].status = Task::Status::InProgress;
+		}
+
 		try {
 			jobPtr();
 		}
 		catch (std::runtime_error e) {
 			OutputDebugString(e.what());
 		}
+
 		std::scoped_lock lock(mutex);
 		tasks[uuid].status = Task::Status::Done;
-	}
+	};
+
 #ifndef GS_SINGLETHREAD_EDITOR
-	);
+	Grindstone::EngineCore::GetInstance().GetJobSystem()->Schedule(taskFn, nullptr, Grindstone::Jobs::JobAffinity::Background);
+#else
+	taskFn();
 #endif
 }
 
@@ -60,7 +65,6 @@ void TaskSystem::CullDoneTasks() {
 	for (auto task = tasks.begin(), next_it = task; task != tasks.end(); task = next_it) {
 		++next_it;
 		if (task->second.status == Task::Status::Done) {
-			task->second.thread.join();
 			tasks.erase(task->first);
 		}
 	}
@@ -2,9 +2,9 @@
 
 #include <map>
 #include <mutex>
-#include <thread>
 #include <functional>
 #include <string>
+#include <vector>
 
 #include <Common/ResourcePipeline/Uuid.hpp>
 
@@ -18,11 +18,10 @@ namespace Grindstone::Editor {
 
 		std::string name;
 		std::function<void()> fnPtr;
-		std::thread thread;
 		Status status;
 
 		Task() = default;
-		Task(const Task& other);
+		Task(const Task& other) = default;
 		Task(Task&& other) = default;
 		Task(std::string& name, std::function<void()> fnPtr) : name(name), fnPtr(fnPtr), status(Status::Queued) {}
 	};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <type_traits>
 
@@ -23,13 +24,46 @@ namespace Grindstone {
 		Failed
 	};
 
+	// An asset's reference count, which can be changed from any thread. Copying it copies its current value.
+	class AssetReferenceCount {
+	public:
+		AssetReferenceCount(size_t count = 1) : count(count) {}
+		AssetReferenceCount(const AssetReferenceCount& other) : count(other.Get()) {}
+
+		AssetReferenceCount& operator=(const AssetReferenceCount& other) {
+			count.store(other.Get(), std::memory_order_relaxed);
+			return *this;
+		}
+
+		size_t Get() const {
+			return count.load(std::memory_order_acquire);
+		}
+
+		operator size_t() const {
+			return Get();
+		}
+
+		// Returns the count from before it was incremented.
+		size_t Increment() {
+			return count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Returns the count from before it was decremented.
+		size_t Decrement() {
+			return count.fetch_sub(1, std::memory_order_acq_rel);
+		}
+
+	private:
+		std::atomic<size_t> count;
+	};
+
 	struct Asset {
 		Asset() = default;
 		Asset(Uuid uuid, std::string_view name) : uuid(uuid), name(name) {}
 
 		Uuid uuid;
 		std::string name;
-		size_t referenceCount = 1;
+		AssetReferenceCount referenceCount = 1;
 		AssetLoadStatus assetLoadStatus = AssetLoadStatus::Unloaded;
 
 		static AssetType GetStaticType() { return AssetType::Undefined; }
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace Grindstone::Assets {
+	// Refers to an asset by its slot in an AssetStorage. A handle stops resolving once its asset is removed, even if the slot is reused.
+	struct AssetHandle {
+		static constexpr uint32_t invalidIndex = UINT32_MAX;
+
+		uint32_t index = invalidIndex;
+		uint32_t generation = 0;
+
+		bool IsValid() const noexcept {
+			return index != invalidIndex;
+		}
+
+		bool operator==(const AssetHandle& other) const noexcept {
+			return index == other.index && generation == other.generation;
+		}
+
+		bool operator!=(const AssetHandle& other) const noexcept {
+			return !(*this == other);
+		}
+	};
+}
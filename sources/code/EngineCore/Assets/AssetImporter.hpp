@@ -1,11 +1,14 @@
 #pragma once
 
+#include <memory>
 #include <string>
-#include <map>
 
 #include <Common/ResourcePipeline/Uuid.hpp>
 #include <Common/ResourcePipeline/AssetType.hpp>
 #include <EngineCore/Assets/Asset.hpp>
+#include <EngineCore/Assets/AssetStorage.hpp>
+#include <EngineCore/Assets/AssetStreamer.hpp>
+#include <EngineCore/Assets/Loaders/AssetLoader.hpp>
 
 namespace Grindstone {
 	class AssetImporter {
@@ -18,8 +21,26 @@ namespace Grindstone {
 		virtual void* IncrementAssetUse(Uuid uuid) = 0;
 		virtual void DecrementAssetUse(Uuid uuid) = 0;
 		virtual void IncrementOrLoad(Uuid uuid) = 0;
+		// Returns Unloaded if the asset doesn't exist in this importer.
+		virtual AssetLoadStatus GetLoadStatus(Uuid uuid) = 0;
 		virtual AssetType GetAssetType() { return assetType; }
 
+		// Handles find a loaded asset with an array index instead of a uuid lookup. A handle stops resolving once its asset is unloaded.
+		virtual Assets::AssetHandle GetHandle(Uuid uuid) { return {}; }
+		virtual void* GetAssetByHandle(Assets::AssetHandle handle) { return nullptr; }
+
+		/*
+		 * Streamed assets are loaded in three steps. CreateStreamingAsset adds the asset with a Loading status,
+		 * so it can be referenced while its file is read in a background job. DecodeStreamingAsset parses the
+		 * file in that same job, so it must only touch the file and the payload it returns. FinishStreamingAsset
+		 * then creates the asset's GPU objects from the payload on the main thread. Importers that don't
+		 * support streaming always load synchronously.
+		 */
+		virtual bool CanStreamAssets() const { return false; }
+		virtual void CreateStreamingAsset(Uuid uuid) {}
+		virtual std::unique_ptr<Assets::StreamedAssetPayload> DecodeStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result) { return nullptr; }
+		virtual void FinishStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result, Assets::StreamedAssetPayload* payload) {}
+
 	protected:
 		AssetType assetType = AssetType::Undefined;
 
@@ -35,22 +56,15 @@ namespace Grindstone {
 		virtual void OnDeleteAsset(AssetStructType& asset) {}
 
 		virtual void* IncrementAssetUse(Uuid uuid) override {
-			void* output = nullptr;
-			if (TryGetIfLoaded(uuid, output)) {
-				AssetStructType* asset = static_cast<AssetStructType*>(output);
-
-				if (asset->assetLoadStatus == AssetLoadStatus::Ready) {
-					++asset->referenceCount;
-					return asset;
-				}
-
-				return nullptr;
-			}
-			else {
-				return LoadAsset(uuid);
+			// Assets that are still streaming in are referenced too, they just can't be used yet.
+			AssetStructType* asset = assets.FindAndIncrement(uuid);
+			if (asset != nullptr) {
+				return asset->assetLoadStatus == AssetLoadStatus::Ready
+					? asset
+					: nullptr;
 			}
 
-			return nullptr;
+			return LoadAsset(uuid);
 		}
 
 		virtual void DecrementAssetUse(Uuid uuid) override {
@@ -58,46 +72,56 @@ namespace Grindstone {
 
 			if (TryGetIfLoaded(uuid, output) && output != nullptr) {
 				AssetStructType* asset = static_cast<AssetStructType*>(output);
-				if (asset->referenceCount <= 1) {
-					OnDeleteAsset(*asset);
-					assets.erase(uuid);
-				}
-				else {
-					--asset->referenceCount;
+				if (asset->referenceCount.Decrement() <= 1) {
+					assets.EraseIfUnreferenced(uuid, [this](AssetStructType& erasedAsset) {
+						OnDeleteAsset(erasedAsset);
+					});
 				}
 			}
 		}
 
 		virtual bool TryGetIfLoaded(Uuid uuid, void*& output) override {
-			auto assetInMap = assets.find(uuid);
-			if (assetInMap != assets.end()) {
-				output = &assetInMap->second;
+			AssetStructType* asset = assets.Find(uuid);
+			if (asset != nullptr) {
+				output = asset;
 				return true;
 			}
 
 			return false;
 		}
 
+		virtual AssetLoadStatus GetLoadStatus(Uuid uuid) override {
+			AssetStructType* asset = assets.Find(uuid);
+			return asset != nullptr
+				? asset->assetLoadStatus
+				: AssetLoadStatus::Unloaded;
+		}
+
 		virtual void IncrementOrLoad(Uuid uuid) override {
-			auto assetInMap = assets.find(uuid);
-			if (assetInMap != assets.end()) {
-				++assetInMap->second.referenceCount;
-				return;
+			if (assets.FindAndIncrement(uuid) == nullptr) {
+				LoadAsset(uuid);
 			}
+		}
 
-			LoadAsset(uuid);
+		virtual Assets::AssetHandle GetHandle(Uuid uuid) override {
+			return assets.FindHandle(uuid);
 		}
 
-		size_t AssetCount() const { return assets.size(); }
-		bool HasAssets() const { return assets.size() != 0; }
+		virtual void* GetAssetByHandle(Assets::AssetHandle handle) override {
+			return assets.Get(handle);
+		}
+
+		// Returns nullptr if the handle's asset has been unloaded.
+		AssetStructType* GetAsset(Assets::AssetHandle handle) { return assets.Get(handle); }
+
+		size_t AssetCount() const { return assets.GetSize(); }
+		bool HasAssets() const { return assets.GetSize() != 0; }
 
 		auto begin() noexcept { return assets.begin(); }
-		auto cbegin() const noexcept { return assets.begin(); }
 		auto end() noexcept { return assets.end(); }
-		auto cend() const noexcept { return assets.cend(); }
 
 	protected:
-		std::map<Uuid, AssetStructType> assets;
+		Assets::AssetStorage<AssetStructType> assets;
 
 	};
 }
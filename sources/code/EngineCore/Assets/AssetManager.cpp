@@ -17,12 +17,13 @@ using namespace Grindstone;
 using namespace Grindstone::Assets;
 using namespace Grindstone::Memory;
 
-AssetManager::AssetManager(AssetLoader* assetLoader) {
+AssetManager::AssetManager(AssetLoader* assetLoader, Jobs::JobSystem* jobSystem) {
 	// TODO: Decide via preprocessor after we implement building the engine code during game build
 	ownsAssetLoader = assetLoader == nullptr;
 	this->assetLoader = ownsAssetLoader
 		? static_cast<AssetLoader*>(AllocatorCore::Allocate<ArchiveAssetLoader>())
 		: assetLoader;
+	assetStreamer = AllocatorCore::Allocate<AssetStreamer>(this->assetLoader, jobSystem);
 
 	size_t count = static_cast<size_t>(AssetType::Count);
 	assetTypeNames.resize(count);
@@ -40,6 +41,10 @@ void AssetManager::UnregisterAssetType(AssetType assetType) {
 }
 
 AssetManager::~AssetManager() {
+	// Finish the streaming jobs before anything they read from is freed.
+	AllocatorCore::Free(assetStreamer);
+	assetStreamer = nullptr;
+
 	if (ownsAssetLoader) {
 		AllocatorCore::Free(assetLoader);
 	}
@@ -119,6 +124,20 @@ void* AssetManager::GetAssetByUuid(AssetType assetType, Uuid uuid) {
 	}
 }
 
+void* AssetManager::GetAssetByHandle(AssetType assetType, AssetHandle handle) {
+	AssetImporter* assetImporter = GetImporterIfValid(assetType);
+	return assetImporter != nullptr
+		? assetImporter->GetAssetByHandle(handle)
+		: nullptr;
+}
+
+AssetHandle AssetManager::GetAssetHandle(AssetType assetType, Uuid uuid) {
+	AssetImporter* assetImporter = GetImporterIfValid(assetType);
+	return assetImporter != nullptr
+		? assetImporter->GetHandle(uuid)
+		: AssetHandle{};
+}
+
 Grindstone::Uuid AssetManager::GetUuidByAddress(AssetType assetType, std::string_view address) {
 	return assetLoader->GetUuidByAddress(assetType, address);
 }
@@ -159,6 +178,93 @@ void AssetManager::DecrementAssetCount(Grindstone::AssetType assetType, Grindsto
 
 	AssetImporter* assetImporter = assetTypeImporters[assetTypeSizeT];
 	assetImporter->DecrementAssetUse(uuid);
+
+	// Nothing references the asset anymore, so there's no need to finish streaming it in.
+	if (assetImporter->CanStreamAssets() && assetImporter->GetLoadStatus(uuid) == Grindstone::AssetLoadStatus::Unloaded) {
+		assetStreamer->Cancel(assetType, uuid);
+	}
+}
+
+AssetImporter* AssetManager::GetImporterIfValid(AssetType assetType) const {
+	const size_t assetTypeSizeT = static_cast<size_t>(assetType);
+	if (assetTypeSizeT < 1 || assetTypeSizeT >= assetTypeImporters.size()) {
+		return nullptr;
+	}
+
+	return assetTypeImporters[assetTypeSizeT];
+}
+
+AssetStreamHandle AssetManager::IncrementAssetCountAsync(Grindstone::AssetType assetType, Grindstone::Uuid uuid, AssetStreamPriority priority) {
+	AssetImporter* assetImporter = GetImporterIfValid(assetType);
+	if (assetImporter == nullptr || !uuid.IsValid()) {
+		return AssetStreamHandle{};
+	}
+
+	if (!assetImporter->CanStreamAssets()) {
+		assetImporter->IncrementAssetUse(uuid);
+		return AssetStreamHandle{ assetType, uuid };
+	}
+
+	void* loadedAsset = nullptr;
+	if (assetImporter->TryGetIfLoaded(uuid, loadedAsset)) {
+		assetImporter->IncrementAssetUse(uuid);
+		assetStreamer->RaisePriority(assetType, uuid, priority);
+		return AssetStreamHandle{ assetType, uuid };
+	}
+
+	assetImporter->CreateStreamingAsset(uuid);
+	assetStreamer->Queue(assetImporter, uuid, priority);
+	return AssetStreamHandle{ assetType, uuid };
+}
+
+AssetStreamStatus AssetManager::GetAssetStreamStatus(AssetStreamHandle handle) {
+	AssetImporter* assetImporter = GetImporterIfValid(handle.assetType);
+	if (assetImporter == nullptr) {
+		return AssetStreamStatus::Failed;
+	}
+
+	AssetStreamStatus streamStatus;
+	if (assetStreamer->TryGetStatus(handle.assetType, handle.uuid, streamStatus)) {
+		return streamStatus;
+	}
+
+	switch (assetImporter->GetLoadStatus(handle.uuid)) {
+	case Grindstone::AssetLoadStatus::Ready:
+		return AssetStreamStatus::Ready;
+	case Grindstone::AssetLoadStatus::Loading:
+	case Grindstone::AssetLoadStatus::Reloading:
+		return AssetStreamStatus::Loading;
+	case Grindstone::AssetLoadStatus::Missing:
+	case Grindstone::AssetLoadStatus::Failed:
+		return AssetStreamStatus::Failed;
+	case Grindstone::AssetLoadStatus::Unloaded:
+	default:
+		return AssetStreamStatus::Unloaded;
+	}
+}
+
+void AssetManager::SetAssetStreamPriority(AssetStreamHandle handle, AssetStreamPriority priority) {
+	assetStreamer->SetPriority(handle.assetType, handle.uuid, priority);
+}
+
+void AssetManager::CancelAssetStream(AssetStreamHandle handle) {
+	if (handle.IsValid()) {
+		DecrementAssetCount(handle.assetType, handle.uuid);
+	}
+}
+
+void AssetManager::ProcessStreamedAssets() {
+	GRIND_PROFILE_SCOPE("AssetManager::ProcessStreamedAssets()");
+	assetStreamer->TakeFinishedLoads(streamedAssetLoads, maxStreamedAssetsPerFrame);
+
+	for (StreamedAssetLoad& streamedAssetLoad : streamedAssetLoads) {
+		AssetImporter* assetImporter = GetImporterIfValid(streamedAssetLoad.assetType);
+		if (assetImporter != nullptr) {
+			assetImporter->FinishStreamingAsset(streamedAssetLoad.uuid, streamedAssetLoad.result, streamedAssetLoad.payload.get());
+		}
+	}
+
+	streamedAssetLoads.clear();
 }
 
 const std::string& AssetManager::GetTypeName(AssetType assetType) const {
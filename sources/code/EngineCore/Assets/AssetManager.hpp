@@ -7,6 +7,7 @@
 #include <Common/Buffer.hpp>
 #include <EngineCore/Assets/Loaders/AssetLoader.hpp>
 #include <EngineCore/Assets/AssetReference.hpp>
+#include <EngineCore/Assets/AssetStreamer.hpp>
 
 #include "Asset.hpp"
 #include "AssetImporter.hpp"
@@ -14,10 +15,12 @@
 namespace Grindstone::Assets {
 	class AssetManager {
 	public:
-		AssetManager(AssetLoader* assetLoader);
+		AssetManager(AssetLoader* assetLoader, Jobs::JobSystem* jobSystem);
 		~AssetManager();
 
 		void ReloadQueuedAssets();
+		// Creates assets whose files have finished streaming in. Must be called from the main thread.
+		void ProcessStreamedAssets();
 		virtual AssetImporter* GetManager(AssetType assetType);
 
 		template<typename AssetImporterClass>
@@ -28,6 +31,9 @@ namespace Grindstone::Assets {
 
 		virtual void QueueReloadAsset(AssetType assetType, Uuid uuid);
 		virtual void* GetAssetByUuid(AssetType assetType, Uuid uuid);
+		// Resolves a handle from GetAssetHandle without a uuid lookup. Returns nullptr once the asset has been unloaded.
+		virtual void* GetAssetByHandle(AssetType assetType, AssetHandle handle);
+		virtual AssetHandle GetAssetHandle(AssetType assetType, Uuid uuid);
 		virtual Grindstone::Uuid GetUuidByAddress(AssetType assetType, std::string_view address);
 
 		virtual AssetLoadBinaryResult LoadBinaryByUuid(AssetType assetType, Uuid uuid);
@@ -38,6 +44,17 @@ namespace Grindstone::Assets {
 		virtual void IncrementAssetCount(Grindstone::AssetType assetType, Grindstone::Uuid uuid);
 		virtual void DecrementAssetCount(Grindstone::AssetType assetType, Grindstone::Uuid uuid);
 
+		/*
+		 * Like IncrementAssetCount, but returns without waiting for the asset to load. The asset's file is read in a
+		 * background job, and the asset is only created on the main thread, in ProcessStreamedAssets. Until then,
+		 * references to it return nullptr from Get. Asset types whose importer can't stream are loaded synchronously.
+		 */
+		virtual AssetStreamHandle IncrementAssetCountAsync(Grindstone::AssetType assetType, Grindstone::Uuid uuid, AssetStreamPriority priority = AssetStreamPriority::Normal);
+		virtual AssetStreamStatus GetAssetStreamStatus(AssetStreamHandle handle);
+		virtual void SetAssetStreamPriority(AssetStreamHandle handle, AssetStreamPriority priority);
+		// Releases the reference taken by IncrementAssetCountAsync. The load is cancelled once nothing references the asset.
+		virtual void CancelAssetStream(AssetStreamHandle handle);
+
 		template<typename AssetImporterClass>
 		void RegisterAssetType() {
 			static_assert(std::is_base_of_v<Grindstone::AssetImporter, AssetImporterClass>, "AssetImporterClass not derived from Grindstone::AssetImporter");
@@ -62,6 +79,17 @@ namespace Grindstone::Assets {
 			return Grindstone::AssetReference<T>::CreateAndIncrement(uuid);
 		}
 
+		template<typename T>
+		Grindstone::AssetReference<T> GetAssetReferenceByUuidAsync(Grindstone::Uuid uuid, AssetStreamPriority priority = AssetStreamPriority::Normal) {
+			static_assert(std::is_base_of_v<Grindstone::Asset, T>, "T not derived from Grindstone::Asset");
+
+			if (!IncrementAssetCountAsync(T::GetStaticType(), uuid, priority).IsValid()) {
+				return Grindstone::AssetReference<T>();
+			}
+
+			return Grindstone::AssetReference<T>::CreateWithoutIncrement(uuid);
+		}
+
 		template<typename T>
 		Grindstone::AssetReference<T> GetAssetReferenceByAddress(std::string_view address) {
 			static_assert(std::is_base_of_v<Grindstone::Asset, T>, "T not derived from Grindstone::Asset");
@@ -79,9 +107,15 @@ namespace Grindstone::Assets {
 		virtual void RegisterAssetType(AssetType assetType, const char* typeName, AssetImporter* importer);
 		virtual void UnregisterAssetType(AssetType assetType);
 	private:
+		AssetImporter* GetImporterIfValid(AssetType assetType) const;
+
+		// Creating GPU objects for many assets in one frame would hitch, so the rest wait for the next frame.
+		static constexpr size_t maxStreamedAssetsPerFrame = 32;
 
 		bool ownsAssetLoader = false;
 		Grindstone::Assets::AssetLoader* assetLoader = nullptr;
+		AssetStreamer* assetStreamer = nullptr;
+		std::vector<StreamedAssetLoad> streamedAssetLoads;
 		std::vector<std::string> assetTypeNames;
 		std::vector<AssetImporter*> assetTypeImporters;
 		std::vector<std::pair<AssetType, Uuid>> queuedAssetReloads;
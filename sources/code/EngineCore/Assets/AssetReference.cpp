@@ -6,6 +6,14 @@ void* Grindstone::AssetFunctions::Get(Grindstone::AssetType assetType, Grindston
 	return Grindstone::EngineCore::GetInstance().assetManager->GetAssetByUuid(assetType, uuid);
 }
 
+void* Grindstone::AssetFunctions::GetByHandle(Grindstone::AssetType assetType, Grindstone::Assets::AssetHandle handle) {
+	return Grindstone::EngineCore::GetInstance().assetManager->GetAssetByHandle(assetType, handle);
+}
+
+Grindstone::Assets::AssetHandle Grindstone::AssetFunctions::GetHandle(Grindstone::AssetType assetType, Grindstone::Uuid uuid) {
+	return Grindstone::EngineCore::GetInstance().assetManager->GetAssetHandle(assetType, uuid);
+}
+
 void* Grindstone::AssetFunctions::GetAndIncrement(Grindstone::AssetType assetType, Grindstone::Uuid uuid) {
 	return Grindstone::EngineCore::GetInstance().assetManager->GetAndIncrementAssetCount(assetType, uuid);
 }
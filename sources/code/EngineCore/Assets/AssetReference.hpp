@@ -4,9 +4,12 @@
 #include <type_traits>
 
 #include <EngineCore/Assets/Asset.hpp>
+#include <EngineCore/Assets/AssetHandle.hpp>
 
 namespace Grindstone::AssetFunctions {
 	[[nodiscard]] void* Get(Grindstone::AssetType assetType, Grindstone::Uuid uuid);
+	[[nodiscard]] void* GetByHandle(Grindstone::AssetType assetType, Grindstone::Assets::AssetHandle handle);
+	[[nodiscard]] Grindstone::Assets::AssetHandle GetHandle(Grindstone::AssetType assetType, Grindstone::Uuid uuid);
 	[[nodiscard]] void* GetAndIncrement(Grindstone::AssetType assetType, Grindstone::Uuid uuid);
 	void Increment(Grindstone::AssetType assetType, Grindstone::Uuid uuid);
 	void Decrement(Grindstone::AssetType assetType, Grindstone::Uuid uuid);
@@ -56,14 +59,15 @@ namespace Grindstone {
 
 		AssetReference() : GenericAssetReference() {}
 
-		AssetReference(const AssetReference& other) : GenericAssetReference(other.uuid) {
+		AssetReference(const AssetReference& other) : GenericAssetReference(other.uuid), handle(other.handle) {
 			if (uuid.IsValid()) {
 				Grindstone::AssetFunctions::Increment(T::GetStaticType(), uuid);
 			}
 		}
 
-		AssetReference(AssetReference&& other) noexcept : GenericAssetReference(other.uuid) {
+		AssetReference(AssetReference&& other) noexcept : GenericAssetReference(other.uuid), handle(other.handle) {
 			other.uuid = Grindstone::Uuid();
+			other.handle = Assets::AssetHandle();
 		}
 
 		AssetReference& operator=(const AssetReference& other) {
@@ -73,6 +77,7 @@ namespace Grindstone {
 				}
 
 				uuid = other.uuid;
+				handle = other.handle;
 				if (uuid.IsValid()) {
 					Grindstone::AssetFunctions::Increment(T::GetStaticType(), uuid);
 				}
@@ -88,7 +93,9 @@ namespace Grindstone {
 				}
 
 				uuid = other.uuid;
+				handle = other.handle;
 				other.uuid = Grindstone::Uuid();
+				other.handle = Assets::AssetHandle();
 			}
 
 			return *this;
@@ -106,21 +113,23 @@ namespace Grindstone {
 				Grindstone::AssetFunctions::Decrement(T::GetStaticType(), uuid);
 				uuid = Uuid();
 			}
+
+			handle = Assets::AssetHandle();
 		}
 
 		// Return a pointer to the actual asset whether or not there was an error.
 		[[nodiscard]] T* GetUnchecked() {
-			return reinterpret_cast<T*>(Grindstone::AssetFunctions::Get(T::GetStaticType(), uuid));
+			return Resolve();
 		}
 
 		// Return a pointer to the actual asset whether or not there was an error.
 		[[nodiscard]] const T* GetUnchecked() const {
-			return reinterpret_cast<T*>(Grindstone::AssetFunctions::Get(T::GetStaticType(), uuid));
+			return ResolveWithoutCaching();
 		}
 
 		// Return a pointer to the actual asset, but only if the asset is ready to be used.
 		[[nodiscard]] T* Get() {
-			T* asset = reinterpret_cast<T*>(Grindstone::AssetFunctions::Get(T::GetStaticType(), uuid));
+			T* asset = Resolve();
 			return asset && asset->assetLoadStatus == Grindstone::AssetLoadStatus::Ready
 				? asset
 				: nullptr;
@@ -128,7 +137,7 @@ namespace Grindstone {
 
 		// Return a pointer to the actual asset, but only if the asset is ready to be used.
 		[[nodiscard]] const T* Get() const {
-			T* asset = reinterpret_cast<T*>(Grindstone::AssetFunctions::Get(T::GetStaticType(), uuid));
+			const T* asset = ResolveWithoutCaching();
 			return asset && asset->assetLoadStatus == Grindstone::AssetLoadStatus::Ready
 				? asset
 				: nullptr;
@@ -140,5 +149,41 @@ namespace Grindstone {
 
 	private:
 		AssetReference(Grindstone::Uuid uuid) : GenericAssetReference(uuid) {}
+
+		// Returns the asset the cached handle points to, if it's still this reference's asset. The uuid is checked too, as it can be set through GenericAssetReference.
+		T* GetByCachedHandle() const {
+			if (!handle.IsValid()) {
+				return nullptr;
+			}
+
+			T* asset = reinterpret_cast<T*>(Grindstone::AssetFunctions::GetByHandle(T::GetStaticType(), handle));
+			return asset != nullptr && asset->uuid == uuid
+				? asset
+				: nullptr;
+		}
+
+		// Resolves through the cached handle, and only looks the uuid up when the handle is stale, caching the new handle.
+		T* Resolve() {
+			if (T* asset = GetByCachedHandle()) {
+				return asset;
+			}
+
+			T* asset = reinterpret_cast<T*>(Grindstone::AssetFunctions::Get(T::GetStaticType(), uuid));
+			handle = asset != nullptr
+				? Grindstone::AssetFunctions::GetHandle(T::GetStaticType(), uuid)
+				: Assets::AssetHandle();
+			return asset;
+		}
+
+		// Const references may be read from several threads at once, so they use the cached handle but never write it.
+		T* ResolveWithoutCaching() const {
+			if (T* asset = GetByCachedHandle()) {
+				return asset;
+			}
+
+			return reinterpret_cast<T*>(Grindstone::AssetFunctions::Get(T::GetStaticType(), uuid));
+		}
+
+		Assets::AssetHandle handle;
 	};
 }
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include <Common/ResourcePipeline/Uuid.hpp>
+#include <EngineCore/Assets/AssetHandle.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
+
+namespace Grindstone::Assets {
+	/*
+	 * Stores the assets of an importer in slots, which live in fixed-size pages that never move, so
+	 * pointers and handles stay valid for as long as their asset is stored. Resolving a handle is an
+	 * array index and a generation check, without taking a lock. A slot's generation is odd while it
+	 * holds an asset, so handles never resolve to an empty slot. Finding an asset by uuid goes through a
+	 * hash index behind a shared lock, so it's safe from any thread. Taking a reference through
+	 * FindAndIncrement is safe from any thread too, because EraseIfUnreferenced checks the count again
+	 * under the exclusive lock. Adding, removing and iterating assets must not happen at the same time
+	 * as each other, which importers ensure by only doing them on the main thread.
+	 */
+	template<typename T>
+	class AssetStorage {
+	public:
+		static constexpr uint32_t slotsPerPage = 256;
+		static constexpr uint32_t maxPageCount = 4096;
+
+		class Iterator {
+		public:
+			Iterator(AssetStorage* storage, size_t denseIndex) : storage(storage), denseIndex(denseIndex) {}
+
+			T& operator*() const {
+				return *storage->GetSlot(storage->occupiedSlotIndices[denseIndex]).asset;
+			}
+
+			T* operator->() const {
+				return &**this;
+			}
+
+			Iterator& operator++() {
+				++denseIndex;
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const {
+				return denseIndex == other.denseIndex;
+			}
+
+			bool operator!=(const Iterator& other) const {
+				return denseIndex != other.denseIndex;
+			}
+
+		private:
+			AssetStorage* storage;
+			size_t denseIndex;
+		};
+
+		AssetStorage() = default;
+		AssetStorage(const AssetStorage&) = delete;
+		AssetStorage& operator=(const AssetStorage&) = delete;
+
+		~AssetStorage() {
+			Clear();
+			for (std::atomic<Page*>& page : pages) {
+				Grindstone::Memory::AllocatorCore::Free(page.load(std::memory_order_relaxed));
+			}
+		}
+
+		// Stores an asset under uuid, and returns it. If an asset is already stored under uuid, it's returned instead and asset is discarded.
+		T& Emplace(Uuid uuid, T&& asset) {
+			std::unique_lock lock(mutex);
+			auto slotIterator = slotIndexByUuid.find(uuid);
+			if (slotIterator != slotIndexByUuid.end()) {
+				return *GetSlot(slotIterator->second).asset;
+			}
+
+			uint32_t slotIndex = 0;
+			if (!freeSlotIndices.empty()) {
+				slotIndex = freeSlotIndices.back();
+				freeSlotIndices.pop_back();
+			}
+			else {
+				slotIndex = AddSlot();
+			}
+
+			Slot& slot = GetSlot(slotIndex);
+			slot.asset.emplace(std::move(asset));
+			// Handles can only resolve once the asset has been constructed.
+			slot.generation.fetch_add(1, std::memory_order_release);
+			slot.denseIndex = static_cast<uint32_t>(occupiedSlotIndices.size());
+			occupiedSlotIndices.push_back(slotIndex);
+			slotIndexByUuid[uuid] = slotIndex;
+			return *slot.asset;
+		}
+
+		// Returns nullptr if no asset is stored under uuid.
+		T* Find(Uuid uuid) {
+			std::shared_lock lock(mutex);
+			auto slotIterator = slotIndexByUuid.find(uuid);
+			return slotIterator != slotIndexByUuid.end()
+				? &*GetSlot(slotIterator->second).asset
+				: nullptr;
+		}
+
+		// Adds a reference to the asset stored under uuid and returns it, or returns nullptr. The lock keeps the asset from being erased in between.
+		T* FindAndIncrement(Uuid uuid) {
+			std::shared_lock lock(mutex);
+			auto slotIterator = slotIndexByUuid.find(uuid);
+			if (slotIterator == slotIndexByUuid.end()) {
+				return nullptr;
+			}
+
+			T& asset = *GetSlot(slotIterator->second).asset;
+			asset.referenceCount.Increment();
+			return &asset;
+		}
+
+		// Returns an invalid handle if no asset is stored under uuid.
+		AssetHandle FindHandle(Uuid uuid) {
+			std::shared_lock lock(mutex);
+			auto slotIterator = slotIndexByUuid.find(uuid);
+			if (slotIterator == slotIndexByUuid.end()) {
+				return AssetHandle{};
+			}
+
+			const uint32_t slotIndex = slotIterator->second;
+			return AssetHandle{ slotIndex, GetSlot(slotIndex).generation.load(std::memory_order_relaxed) };
+		}
+
+		// Returns nullptr if the handle's asset has been removed.
+		T* Get(AssetHandle handle) {
+			if (handle.index >= slotsPerPage * maxPageCount) {
+				return nullptr;
+			}
+
+			Page* page = pages[handle.index / slotsPerPage].load(std::memory_order_acquire);
+			if (page == nullptr) {
+				return nullptr;
+			}
+
+			Slot& slot = (*page)[handle.index % slotsPerPage];
+			return slot.generation.load(std::memory_order_acquire) == handle.generation
+				? &*slot.asset
+				: nullptr;
+		}
+
+		bool Erase(Uuid uuid) {
+			std::unique_lock lock(mutex);
+			auto slotIterator = slotIndexByUuid.find(uuid);
+			if (slotIterator == slotIndexByUuid.end()) {
+				return false;
+			}
+
+			const uint32_t slotIndex = slotIterator->second;
+			slotIndexByUuid.erase(slotIterator);
+			FreeSlot(slotIndex);
+			return true;
+		}
+
+		/*
+		 * Erases the asset stored under uuid if nothing references it, calling onErase on it first. Another
+		 * thread may have taken a reference since the count reached zero, so it is checked again under the
+		 * lock. onErase runs under the lock, so it must not use this storage.
+		 */
+		template<typename OnEraseFn>
+		bool EraseIfUnreferenced(Uuid uuid, OnEraseFn&& onErase) {
+			std::unique_lock lock(mutex);
+			auto slotIterator = slotIndexByUuid.find(uuid);
+			if (slotIterator == slotIndexByUuid.end()) {
+				return false;
+			}
+
+			const uint32_t slotIndex = slotIterator->second;
+			T& asset = *GetSlot(slotIndex).asset;
+			if (asset.referenceCount.Get() != 0) {
+				return false;
+			}
+
+			onErase(asset);
+			slotIndexByUuid.erase(slotIterator);
+			FreeSlot(slotIndex);
+			return true;
+		}
+
+		void Clear() {
+			std::unique_lock lock(mutex);
+			while (!occupiedSlotIndices.empty()) {
+				FreeSlot(occupiedSlotIndices.back());
+			}
+
+			slotIndexByUuid.clear();
+		}
+
+		size_t GetSize() const {
+			std::shared_lock lock(mutex);
+			return occupiedSlotIndices.size();
+		}
+
+		Iterator begin() {
+			return Iterator(this, 0);
+		}
+
+		Iterator end() {
+			return Iterator(this, occupiedSlotIndices.size());
+		}
+
+	private:
+		struct Slot {
+			// Bumped whenever an asset is added to or removed from the slot, which invalidates every handle to the removed asset.
+			std::atomic<uint32_t> generation = 0;
+			// Where the slot is in occupiedSlotIndices, for removing it without a search.
+			uint32_t denseIndex = 0;
+			std::optional<T> asset;
+		};
+
+		using Page = std::array<Slot, slotsPerPage>;
+
+		Slot& GetSlot(uint32_t slotIndex) {
+			return (*pages[slotIndex / slotsPerPage].load(std::memory_order_relaxed))[slotIndex % slotsPerPage];
+		}
+
+		uint32_t AddSlot() {
+			if (slotCount == slotsPerPage * maxPageCount) {
+				throw std::length_error("Too many assets of one type are loaded.");
+			}
+
+			const uint32_t slotIndex = slotCount++;
+			std::atomic<Page*>& page = pages[slotIndex / slotsPerPage];
+			if (page.load(std::memory_order_relaxed) == nullptr) {
+				page.store(Grindstone::Memory::AllocatorCore::Allocate<Page>(), std::memory_order_release);
+			}
+
+			return slotIndex;
+		}
+
+		void FreeSlot(uint32_t slotIndex) {
+			Slot& slot = GetSlot(slotIndex);
+
+			// Keep iteration dense by moving the last occupied slot into this one's place.
+			const uint32_t lastSlotIndex = occupiedSlotIndices.back();
+			occupiedSlotIndices[slot.denseIndex] = lastSlotIndex;
+			GetSlot(lastSlotIndex).denseIndex = slot.denseIndex;
+			occupiedSlotIndices.pop_back();
+
+			// Handles stop resolving before the asset is destroyed.
+			slot.generation.fetch_add(1, std::memory_order_release);
+			slot.asset.reset();
+			freeSlotIndices.push_back(slotIndex);
+		}
+
+		mutable std::shared_mutex mutex;
+		std::array<std::atomic<Page*>, maxPageCount> pages{};
+		uint32_t slotCount = 0;
+		std::vector<uint32_t> freeSlotIndices;
+		std::vector<uint32_t> occupiedSlotIndices;
+		std::unordered_map<Uuid, uint32_t> slotIndexByUuid;
+	};
+}
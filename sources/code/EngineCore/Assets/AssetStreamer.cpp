@@ -0,0 +1,168 @@
+#include <algorithm>
+
+#include <EngineCore/Assets/AssetImporter.hpp>
+
+#include "AssetStreamer.hpp"
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+AssetStreamer::AssetStreamer(AssetLoader* assetLoader, Jobs::JobSystem* jobSystem, uint32_t maxConcurrentReads) :
+	assetLoader(assetLoader),
+	jobSystem(jobSystem),
+	maxConcurrentReads(std::max(maxConcurrentReads, 1u)) {}
+
+AssetStreamer::~AssetStreamer() {
+	{
+		std::scoped_lock lock(mutex);
+		isShuttingDown = true;
+	}
+
+	// Jobs that haven't started yet return right away, so this only waits on reads already in progress.
+	jobSystem->Wait(streamingJobCounter);
+}
+
+void AssetStreamer::Queue(AssetImporter* assetImporter, Uuid uuid, AssetStreamPriority priority) {
+	std::scoped_lock lock(mutex);
+	const AssetKey key{ assetImporter->GetAssetType(), uuid };
+	auto [requestIterator, wasInserted] = requests.try_emplace(key);
+	Request& request = requestIterator->second;
+	if (!wasInserted) {
+		// A cancelled read that hasn't finished yet can be reused as is.
+		request.isCancelled = false;
+		if (priority > request.priority) {
+			UpdatePriority(request, key, priority);
+		}
+
+		return;
+	}
+
+	request.assetImporter = assetImporter;
+	request.priority = priority;
+	request.sequence = nextSequence++;
+	queue.insert(QueueEntry{ request.priority, request.sequence, key });
+	ScheduleStreamingJobs();
+}
+
+void AssetStreamer::RaisePriority(AssetType assetType, Uuid uuid, AssetStreamPriority priority) {
+	std::scoped_lock lock(mutex);
+	const AssetKey key{ assetType, uuid };
+	auto requestIterator = requests.find(key);
+	if (requestIterator != requests.end() && priority > requestIterator->second.priority) {
+		UpdatePriority(requestIterator->second, key, priority);
+	}
+}
+
+void AssetStreamer::SetPriority(AssetType assetType, Uuid uuid, AssetStreamPriority priority) {
+	std::scoped_lock lock(mutex);
+	const AssetKey key{ assetType, uuid };
+	auto requestIterator = requests.find(key);
+	if (requestIterator != requests.end()) {
+		UpdatePriority(requestIterator->second, key, priority);
+	}
+}
+
+void AssetStreamer::UpdatePriority(Request& request, const AssetKey& key, AssetStreamPriority priority) {
+	if (request.isReading) {
+		request.priority = priority;
+		return;
+	}
+
+	queue.erase(QueueEntry{ request.priority, request.sequence, key });
+	request.priority = priority;
+	queue.insert(QueueEntry{ request.priority, request.sequence, key });
+}
+
+void AssetStreamer::Cancel(AssetType assetType, Uuid uuid) {
+	std::scoped_lock lock(mutex);
+	const AssetKey key{ assetType, uuid };
+	auto requestIterator = requests.find(key);
+	if (requestIterator == requests.end()) {
+		return;
+	}
+
+	Request& request = requestIterator->second;
+	if (request.isReading) {
+		// The streaming job drops the read once it finishes.
+		request.isCancelled = true;
+		return;
+	}
+
+	queue.erase(QueueEntry{ request.priority, request.sequence, key });
+	requests.erase(requestIterator);
+}
+
+bool AssetStreamer::TryGetStatus(AssetType assetType, Uuid uuid, AssetStreamStatus& outStatus) {
+	std::scoped_lock lock(mutex);
+	auto requestIterator = requests.find(AssetKey{ assetType, uuid });
+	if (requestIterator == requests.end() || requestIterator->second.isCancelled) {
+		return false;
+	}
+
+	outStatus = requestIterator->second.isReading
+		? AssetStreamStatus::Loading
+		: AssetStreamStatus::Queued;
+	return true;
+}
+
+void AssetStreamer::TakeFinishedLoads(std::vector<StreamedAssetLoad>& outLoads, size_t maxLoadCount) {
+	std::scoped_lock lock(mutex);
+	size_t finishedLoadIndex = 0;
+	for (size_t takenLoadCount = 0; finishedLoadIndex < finishedLoads.size() && takenLoadCount < maxLoadCount; ++finishedLoadIndex) {
+		StreamedAssetLoad& finishedLoad = finishedLoads[finishedLoadIndex];
+		auto requestIterator = requests.find(AssetKey{ finishedLoad.assetType, finishedLoad.uuid });
+		const bool isCancelled = requestIterator->second.isCancelled;
+		requests.erase(requestIterator);
+
+		if (!isCancelled) {
+			outLoads.emplace_back(std::move(finishedLoad));
+			++takenLoadCount;
+		}
+	}
+
+	finishedLoads.erase(finishedLoads.begin(), finishedLoads.begin() + finishedLoadIndex);
+}
+
+void AssetStreamer::ScheduleStreamingJobs() {
+	// Jobs pick the best queued asset when they start rather than when they're scheduled,
+	// so priority changes and cancellations made in the meantime are respected.
+	while (!isShuttingDown && scheduledJobCount < maxConcurrentReads && scheduledJobCount < queue.size()) {
+		++scheduledJobCount;
+		jobSystem->Schedule([this] { StreamNextAsset(); }, &streamingJobCounter, Jobs::JobAffinity::Background);
+	}
+}
+
+void AssetStreamer::StreamNextAsset() {
+	AssetKey key;
+	AssetImporter* assetImporter = nullptr;
+	{
+		std::scoped_lock lock(mutex);
+		if (isShuttingDown || queue.empty()) {
+			--scheduledJobCount;
+			return;
+		}
+
+		key = queue.begin()->key;
+		queue.erase(queue.begin());
+		Request& request = requests[key];
+		request.isReading = true;
+		assetImporter = request.assetImporter;
+	}
+
+	AssetLoadBinaryResult result = assetLoader->LoadBinaryByUuid(key.first, key.second);
+	std::unique_ptr<StreamedAssetPayload> payload = assetImporter->DecodeStreamingAsset(key.second, result);
+
+	std::scoped_lock lock(mutex);
+	--scheduledJobCount;
+	auto requestIterator = requests.find(key);
+	if (requestIterator->second.isCancelled) {
+		requests.erase(requestIterator);
+	}
+	else {
+		// Stays in requests until the main thread takes it, so repeated requests still join this load.
+		finishedLoads.emplace_back(StreamedAssetLoad{ key.first, key.second, std::move(result), std::move(payload) });
+	}
+
+	// Rescheduled instead of looping, so other background jobs queued meanwhile aren't starved.
+	ScheduleStreamingJobs();
+}
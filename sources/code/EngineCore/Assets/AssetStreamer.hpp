@@ -0,0 +1,134 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <Common/ResourcePipeline/Uuid.hpp>
+#include <Common/ResourcePipeline/AssetType.hpp>
+#include <EngineCore/Assets/Loaders/AssetLoader.hpp>
+#include <EngineCore/Jobs/JobSystem.hpp>
+
+namespace Grindstone {
+	class AssetImporter;
+}
+
+namespace Grindstone::Assets {
+	enum class AssetStreamPriority : uint8_t {
+		Low = 0,
+		Normal,
+		High,
+		Critical
+	};
+
+	enum class AssetStreamStatus : uint8_t {
+		// The asset is waiting for a streaming job to read it.
+		Queued = 0,
+		// The asset is being read and decoded, or is waiting for the main thread to create it.
+		Loading,
+		// The asset is ready for use.
+		Ready,
+		// The asset could not be found or failed to load.
+		Failed,
+		// The asset isn't loaded or being loaded, because its load was cancelled or it has been released.
+		Unloaded
+	};
+
+	// Identifies a streamed asset. Requests for the same asset share a single load, so they share a handle too.
+	struct AssetStreamHandle {
+		AssetType assetType = AssetType::Undefined;
+		Uuid uuid;
+
+		bool IsValid() const noexcept {
+			return assetType != AssetType::Undefined && uuid.IsValid();
+		}
+	};
+
+	// What an importer decoded from an asset's file off the main thread. Importers derive their own payloads from it.
+	struct StreamedAssetPayload {
+		virtual ~StreamedAssetPayload() = default;
+	};
+
+	struct StreamedAssetLoad {
+		AssetType assetType = AssetType::Undefined;
+		Uuid uuid;
+		AssetLoadBinaryResult result;
+		// May point into result's buffer, so the two are kept together.
+		std::unique_ptr<StreamedAssetPayload> payload;
+	};
+
+	/*
+	 * Reads asset files and decodes them with their importers in background jobs, so the main thread never
+	 * waits on I/O or parsing. Queued assets are read in priority order, and in request order within a
+	 * priority. Each job reads a single asset, so no more than maxConcurrentReads background threads are
+	 * busy streaming, and builds queued behind them still get a turn. Finished loads are collected by the
+	 * main thread, which hands them to their importers to create any GPU objects.
+	 */
+	class AssetStreamer {
+	public:
+		AssetStreamer(AssetLoader* assetLoader, Jobs::JobSystem* jobSystem, uint32_t maxConcurrentReads = 2);
+		AssetStreamer(const AssetStreamer&) = delete;
+		AssetStreamer& operator=(const AssetStreamer&) = delete;
+		~AssetStreamer();
+
+		// Queues an asset to be read and decoded by its importer. If it is already queued or being read, its priority is raised instead.
+		void Queue(AssetImporter* assetImporter, Uuid uuid, AssetStreamPriority priority);
+		// Raises the priority of an asset if it is queued or being read, and does nothing otherwise.
+		void RaisePriority(AssetType assetType, Uuid uuid, AssetStreamPriority priority);
+		void SetPriority(AssetType assetType, Uuid uuid, AssetStreamPriority priority);
+		// Removes a queued asset, or discards the read of an asset that's already being read.
+		void Cancel(AssetType assetType, Uuid uuid);
+		// Returns false if the asset isn't queued or being read.
+		bool TryGetStatus(AssetType assetType, Uuid uuid, AssetStreamStatus& outStatus);
+		// Moves up to maxLoadCount finished reads into outLoads, in the order they finished.
+		void TakeFinishedLoads(std::vector<StreamedAssetLoad>& outLoads, size_t maxLoadCount);
+
+	private:
+		using AssetKey = std::pair<AssetType, Uuid>;
+
+		struct Request {
+			AssetImporter* assetImporter = nullptr;
+			AssetStreamPriority priority = AssetStreamPriority::Normal;
+			uint64_t sequence = 0;
+			bool isReading = false;
+			bool isCancelled = false;
+		};
+
+		// Sorted so the first entry is the next request to read.
+		struct QueueEntry {
+			AssetStreamPriority priority;
+			uint64_t sequence;
+			AssetKey key;
+
+			bool operator<(const QueueEntry& other) const {
+				if (priority != other.priority) {
+					return priority > other.priority;
+				}
+
+				return sequence < other.sequence;
+			}
+		};
+
+		// Must be called with the mutex held.
+		void ScheduleStreamingJobs();
+		void StreamNextAsset();
+		void UpdatePriority(Request& request, const AssetKey& key, AssetStreamPriority priority);
+
+		AssetLoader* assetLoader = nullptr;
+		Jobs::JobSystem* jobSystem = nullptr;
+		Jobs::JobCounter streamingJobCounter;
+		uint32_t maxConcurrentReads = 0;
+
+		std::mutex mutex;
+		// Streaming jobs that have been scheduled and haven't taken an asset yet, or are still reading it.
+		uint32_t scheduledJobCount = 0;
+		std::map<AssetKey, Request> requests;
+		std::set<QueueEntry> queue;
+		std::vector<StreamedAssetLoad> finishedLoads;
+		uint64_t nextSequence = 0;
+		bool isShuttingDown = false;
+	};
+}
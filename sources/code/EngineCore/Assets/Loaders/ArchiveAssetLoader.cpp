@@ -1,20 +1,36 @@
 #include <fstream>
 #include <filesystem>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
 #include <EngineCore/Utils/Utilities.hpp>
 #include <EngineCore/EngineCore.hpp>
 #include <EngineCore/Logger.hpp>
+#include <Common/Assets/ArchiveCompression.hpp>
+#include <Common/Hash.hpp>
 #include <Common/Graphics/Core.hpp>
 
-#include "ArchiveDirectoryDeserializer.hpp"
 #include "ArchiveAssetLoader.hpp"
 using namespace Grindstone::Assets;
 
-ArchiveAssetLoader::ArchiveAssetLoader() {
+// TODO: How should we get this filename? Maybe search for all asset directories?
+ArchiveAssetLoader::ArchiveAssetLoader() :
+	ArchiveAssetLoader(EngineCore::GetInstance().GetProjectPath() / "archives/TestArchive.gdir") {}
+
+ArchiveAssetLoader::ArchiveAssetLoader(std::filesystem::path directoryPath) : directoryPath(std::move(directoryPath)) {
 	InitializeDirectory();
 }
 
 void ArchiveAssetLoader::InitializeDirectory() {
-	ArchiveDirectoryDeserializer deserializer(archiveDirectory);
+	switch (archiveDirectory.Open(directoryPath)) {
+		case ArchiveDirectoryOpenStatus::Success:
+		case ArchiveDirectoryOpenStatus::FileNotFound:
+			break;
+		case ArchiveDirectoryOpenStatus::InvalidFormat:
+			GPRINT_ERROR_V(LogSource::EngineCore, "Invalid archive directory: {}", directoryPath.string());
+			break;
+		case ArchiveDirectoryOpenStatus::UnsupportedVersion:
+			GPRINT_ERROR_V(LogSource::EngineCore, "Unsupported archive directory version: expected {}.", ArchiveDirectoryFile::CURRENT_VERSION);
+			break;
+	}
 }
 
 AssetLoadBinaryResult ArchiveAssetLoader::LoadBinaryByUuid(AssetType assetType, Uuid uuid) {
@@ -25,15 +41,13 @@ AssetLoadBinaryResult ArchiveAssetLoader::LoadBinaryByUuid(AssetType assetType,
 		return { AssetLoadStatus::InvalidAssetType, {} };
 	}
 
-	ArchiveDirectory::AssetTypeIndex& assetTypeSegment = archiveDirectory.assetTypeIndices[static_cast<size_t>(assetType)];
-	auto assetIterator = assetTypeSegment.assetsByUuid.find(uuid);
-
-	if (assetIterator == assetTypeSegment.assetsByUuid.end()) {
+	const ArchiveDirectoryFile::AssetInfo* assetInfo = archiveDirectory.FindAsset(assetType, uuid);
+	if (assetInfo == nullptr) {
 		GPRINT_ERROR_V(LogSource::EngineCore, "Could not load asset: {}", uuid.ToString());
 		return { AssetLoadStatus::AssetNotInRegistry, {} };
 	}
 
-	return LoadAsset(assetIterator->second);
+	return LoadAsset(*assetInfo);
 }
 
 AssetLoadTextResult ArchiveAssetLoader::LoadTextByUuid(AssetType assetType, Uuid uuid) {
@@ -54,21 +68,110 @@ Grindstone::Uuid ArchiveAssetLoader::GetUuidByAddress(AssetType assetType, std::
 		return Uuid();
 	}
 
-	ArchiveDirectory::AssetTypeIndex& assetTypeSegment = archiveDirectory.assetTypeIndices[static_cast<size_t>(assetType)];
+	const ArchiveDirectoryFile::AssetInfo* assetInfo = archiveDirectory.FindAssetByAddress(assetType, address);
+	return assetInfo != nullptr
+		? assetInfo->uuid
+		: Uuid();
+}
 
-	return assetTypeSegment.assetUuidByAddress[address];
+void ArchiveAssetLoader::SetMaxMappedArchiveCount(size_t maxCount) {
+	std::scoped_lock lock(mappedArchivesMutex);
+	maxMappedArchiveCount = maxCount;
+	EvictLeastRecentlyUsedArchives();
 }
 
-AssetLoadBinaryResult ArchiveAssetLoader::LoadAsset(const ArchiveDirectory::AssetInfo& assetInfo) {
-	if (lastBufferIndex != assetInfo.archiveIndex) {
-		lastBufferIndex = assetInfo.archiveIndex;
+void ArchiveAssetLoader::SetVerifyAssetHashes(bool shouldVerify) {
+	shouldVerifyAssetHashes = shouldVerify;
+}
+
+AssetLoadBinaryResult ArchiveAssetLoader::LoadAsset(const ArchiveDirectoryFile::AssetInfo& assetInfo) {
+	const std::string_view displayName = archiveDirectory.GetDisplayName(assetInfo);
+	std::shared_ptr<MappedArchive> archive = AcquireArchive(assetInfo.archiveIndex);
+	if (archive == nullptr) {
+		return { AssetLoadStatus::FileNotFound, std::string(displayName), {} };
+	}
+
+	if (assetInfo.offset + assetInfo.size > archive->file.GetSize()) {
+		GPRINT_ERROR_V(LogSource::EngineCore, "Asset {} extends past the end of archive {}.", displayName, assetInfo.archiveIndex);
+		return { AssetLoadStatus::FileNotFound, std::string(displayName), {} };
+	}
 
-		const std::string filename = "TestArchive_0.garc";
-		const std::filesystem::path path = EngineCore::GetInstance().GetProjectPath() / "archives" / filename;
-		const std::string filepathAsStr = path.string();
-		lastBuffer = Utils::LoadFile(filepathAsStr.c_str());
+	Byte* storedData = archive->file.GetData() + assetInfo.offset;
+	AssetLoadBinaryResult result{ AssetLoadStatus::Success, std::string(displayName), {} };
+	if (assetInfo.compression == ArchiveCompression::None) {
+		result.buffer = Buffer::MakeViewBuffer(storedData, assetInfo.size);
+		result.pinnedMemory = std::move(archive);
 	}
+	else {
+		// Compressed assets are decompressed straight out of the mapping, so they don't pin the archive.
+		result.buffer = Buffer(assetInfo.uncompressedSize);
+		if (!DecompressArchiveBlocks(storedData, assetInfo.size, result.buffer.Get(), assetInfo.uncompressedSize)) {
+			GPRINT_ERROR_V(LogSource::EngineCore, "Could not decompress asset {} from archive {}.", displayName, assetInfo.archiveIndex);
+			return { AssetLoadStatus::CorruptData, std::string(displayName), {} };
+		}
+	}
+
+	if (shouldVerifyAssetHashes && Grindstone::Hash::Crc32(result.buffer.Get(), result.buffer.GetCapacity()) != assetInfo.crc) {
+		GPRINT_ERROR_V(LogSource::EngineCore, "Asset {} doesn't match the hash it was packed with.", displayName);
+		return { AssetLoadStatus::CorruptData, std::string(displayName), {} };
+	}
+
+	return result;
+}
 
-	Buffer buffer = Buffer::MakeCopiedBuffer(lastBuffer.Get(assetInfo.offset), assetInfo.size);
-	return { AssetLoadStatus::Success, std::string(assetInfo.displayName), buffer };
+std::shared_ptr<ArchiveAssetLoader::MappedArchive> ArchiveAssetLoader::AcquireArchive(uint16_t archiveIndex) {
+	std::scoped_lock lock(mappedArchivesMutex);
+	if (archiveIndex >= archiveDirectory.GetArchiveCount()) {
+		GPRINT_ERROR_V(LogSource::EngineCore, "Archive index {} is not in the archive directory.", archiveIndex);
+		return nullptr;
+	}
+
+	if (mappedArchiveSlots.size() != archiveDirectory.GetArchiveCount()) {
+		mappedArchiveSlots.resize(archiveDirectory.GetArchiveCount());
+	}
+
+	MappedArchiveSlot& slot = mappedArchiveSlots[archiveIndex];
+	slot.lastUseTick = ++currentUseTick;
+	if (slot.archive != nullptr) {
+		return slot.archive;
+	}
+
+	const std::string filename = archiveDirectory.GetName() + "_" + std::to_string(archiveIndex) + ".garc";
+	const std::filesystem::path path = directoryPath.parent_path() / filename;
+
+	MappedArchive* mappedArchive = Grindstone::Memory::AllocatorCore::Allocate<MappedArchive>();
+	std::shared_ptr<MappedArchive> archive(mappedArchive, [](MappedArchive* archiveToFree) {
+		Grindstone::Memory::AllocatorCore::Free(archiveToFree);
+	});
+
+	if (!archive->file.Open(path)) {
+		GPRINT_ERROR_V(LogSource::EngineCore, "Could not map archive: {}", path.string());
+		return nullptr;
+	}
+
+	slot.archive = archive;
+	++mappedArchiveCount;
+	EvictLeastRecentlyUsedArchives();
+	return archive;
+}
+
+void ArchiveAssetLoader::EvictLeastRecentlyUsedArchives() {
+	while (mappedArchiveCount > maxMappedArchiveCount) {
+		MappedArchiveSlot* leastRecentlyUsedSlot = nullptr;
+		for (MappedArchiveSlot& slot : mappedArchiveSlots) {
+			// Only the slot holds a reference to an unpinned archive.
+			const bool isUnpinned = slot.archive != nullptr && slot.archive.use_count() == 1;
+			if (isUnpinned && (leastRecentlyUsedSlot == nullptr || slot.lastUseTick < leastRecentlyUsedSlot->lastUseTick)) {
+				leastRecentlyUsedSlot = &slot;
+			}
+		}
+
+		// Every mapped archive is in use, so go over the cap until some are released.
+		if (leastRecentlyUsedSlot == nullptr) {
+			return;
+		}
+
+		leastRecentlyUsedSlot->archive.reset();
+		--mappedArchiveCount;
+	}
 }
@@ -1,25 +1,60 @@
 #pragma once
 
+#include <atomic>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include <Common/Buffer.hpp>
-#include <Common/Assets/ArchiveDirectory.hpp>
+#include <Common/Assets/ArchiveDirectoryView.hpp>
+#include <Common/Utilities/MemoryMappedFile.hpp>
 
 #include "AssetLoader.hpp"
 
 namespace Grindstone::Assets {
+	/*
+	 * Loads assets from the archives listed in the archive directory. Each archive is memory-mapped
+	 * the first time an asset in it is loaded, and assets are returned as views into the mapping
+	 * rather than copies. A view pins its archive, so the archive stays mapped until every view of it
+	 * has been released, even if it has since been evicted.
+	 */
 	class ArchiveAssetLoader : public AssetLoader {
 	public:
 		ArchiveAssetLoader();
+		// Loads from the directory at directoryPath, and the archives next to it.
+		ArchiveAssetLoader(std::filesystem::path directoryPath);
 		void InitializeDirectory();
 		virtual AssetLoadBinaryResult LoadBinaryByUuid(AssetType assetType, Uuid uuid) override;
 		virtual AssetLoadTextResult LoadTextByUuid(AssetType assetType, Uuid uuid) override;
 		virtual Grindstone::Uuid GetUuidByAddress(AssetType assetType, std::string_view address) override;
+
+		// Once more archives than this are mapped, the least recently used ones no asset is pinning are unmapped.
+		void SetMaxMappedArchiveCount(size_t maxCount);
+		// Checks each loaded asset against the content hash it was packed with. Off by default, as it hashes every byte loaded.
+		void SetVerifyAssetHashes(bool shouldVerify);
 	protected:
-		AssetLoadBinaryResult LoadAsset(const ArchiveDirectory::AssetInfo& assetInfo);
-		ArchiveDirectory archiveDirectory;
+		struct MappedArchive {
+			Utilities::MemoryMappedFile file;
+		};
+
+		struct MappedArchiveSlot {
+			std::shared_ptr<MappedArchive> archive;
+			uint64_t lastUseTick = 0;
+		};
+
+		AssetLoadBinaryResult LoadAsset(const ArchiveDirectoryFile::AssetInfo& assetInfo);
+		std::shared_ptr<MappedArchive> AcquireArchive(uint16_t archiveIndex);
+		void EvictLeastRecentlyUsedArchives();
+		std::filesystem::path directoryPath;
+		ArchiveDirectoryView archiveDirectory;
 
-		Buffer lastBuffer;
-		uint16_t lastBufferIndex = UINT16_MAX;
+		// Assets are streamed in from several threads, which share the mapped archives.
+		std::mutex mappedArchivesMutex;
+		std::vector<MappedArchiveSlot> mappedArchiveSlots;
+		size_t mappedArchiveCount = 0;
+		size_t maxMappedArchiveCount = 16;
+		uint64_t currentUseTick = 0;
+		std::atomic<bool> shouldVerifyAssetHashes = false;
 	};
 }
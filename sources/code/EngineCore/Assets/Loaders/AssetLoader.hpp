@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <vector>
 
 #include <Common/Buffer.hpp>
@@ -15,12 +16,15 @@ namespace Grindstone::Assets {
 		NotEnoughMemory,		///< The asset was found, but could not be loaded because it requires an amount of memory that could not be allocated.
 		InvalidAssetType,		///< The asset was found, but has a type other than that which was attempted to be loaded.
 		AssetNotInRegistry,		///< The asset could not be found in the registry, likely due to an incorrect UUID.
+		CorruptData,			///< The asset was found, but its contents don't match the hash it was packed with.
 	};
 
 	struct AssetLoadBinaryResult {
 		AssetLoadStatus status;
 		std::string displayName;
 		Buffer buffer;
+		// Keeps the memory behind buffer alive when it is a view, such as into a memory-mapped archive.
+		std::shared_ptr<const void> pinnedMemory;
 	};
 
 	struct AssetLoadTextResult {
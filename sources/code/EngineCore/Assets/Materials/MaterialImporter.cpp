@@ -382,8 +382,7 @@ void* MaterialImporter::LoadAsset(Uuid uuid) {
 	GraphicsAPI::Core* graphicsCore = EngineCore::GetInstance().GetGraphicsCore();
 	Assets::AssetManager* assetManager = EngineCore::GetInstance().assetManager;
 
-	auto materialIterator = assets.emplace(uuid, Grindstone::MaterialAsset(uuid));
-	Grindstone::MaterialAsset& materialAsset = materialIterator.first->second;
+	Grindstone::MaterialAsset& materialAsset = assets.Emplace(uuid, Grindstone::MaterialAsset(uuid));
 
 	Assets::AssetLoadTextResult result = assetManager->LoadTextByUuid(AssetType::Material, uuid);
 	if (result.status != Assets::AssetLoadStatus::Success) {
@@ -402,14 +401,14 @@ void* MaterialImporter::LoadAsset(Uuid uuid) {
 }
 
 void MaterialImporter::QueueReloadAsset(Uuid uuid) {
-	auto materialIterator = assets.find(uuid);
-	if (materialIterator == assets.end()) {
+	MaterialAsset* materialAssetPtr = assets.Find(uuid);
+	if (materialAssetPtr == nullptr) {
 		return;
 	}
 
 	GraphicsAPI::Core* graphicsCore = EngineCore::GetInstance().GetGraphicsCore();
 	Assets::AssetManager* assetManager = EngineCore::GetInstance().assetManager;
-	MaterialAsset& materialAsset = materialIterator->second;
+	MaterialAsset& materialAsset = *materialAssetPtr;
 
 	Assets::AssetLoadTextResult result = assetManager->LoadTextByUuid(AssetType::Material, uuid);
 	if (result.status != Assets::AssetLoadStatus::Success) {
@@ -444,8 +443,7 @@ MaterialImporter::~MaterialImporter() {
 	EngineCore& engineCore = EngineCore::GetInstance();
 	GraphicsAPI::Core* graphicsCore = engineCore.GetGraphicsCore();
 
-	for (auto& asset : assets) {
-		Grindstone::MaterialAsset& assetData = asset.second;
+	for (Grindstone::MaterialAsset& assetData : assets) {
 		if (assetData.materialDescriptorSet != nullptr) {
 			graphicsCore->DeleteDescriptorSet(assetData.materialDescriptorSet);
 		}
@@ -455,7 +453,7 @@ MaterialImporter::~MaterialImporter() {
 		}
 	}
 
-	assets.clear();
+	assets.Clear();
 
 	graphicsCore->DeleteImage(missingTexture);
 }
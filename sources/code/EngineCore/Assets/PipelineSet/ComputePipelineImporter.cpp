@@ -169,8 +169,7 @@ static bool ImportComputeAsset(ComputePipelineAsset& computePipelineAsset) {
 }
 
 void* ComputePipelineImporter::LoadAsset(Uuid uuid) {
-	auto pipelineIterator = assets.emplace(uuid, ComputePipelineAsset(uuid));
-	ComputePipelineAsset& computePipelineAsset = pipelineIterator.first->second;
+	ComputePipelineAsset& computePipelineAsset = assets.Emplace(uuid, ComputePipelineAsset(uuid));
 
 	computePipelineAsset.assetLoadStatus = AssetLoadStatus::Loading;
 	if (!ImportComputeAsset(computePipelineAsset)) {
@@ -181,12 +180,12 @@ void* ComputePipelineImporter::LoadAsset(Uuid uuid) {
 }
 
 void ComputePipelineImporter::QueueReloadAsset(Uuid uuid) {
-	auto shaderInMap = assets.find(uuid);
-	if (shaderInMap == assets.end()) {
+	Grindstone::ComputePipelineAsset* computePipelineAssetPtr = assets.Find(uuid);
+	if (computePipelineAssetPtr == nullptr) {
 		return;
 	}
 
-	Grindstone::ComputePipelineAsset& computePipelineAsset = shaderInMap->second;
+	Grindstone::ComputePipelineAsset& computePipelineAsset = *computePipelineAssetPtr;
 
 	computePipelineAsset.assetLoadStatus = AssetLoadStatus::Reloading;
 	Grindstone::GraphicsAPI::Core* graphicsCore = EngineCore::GetInstance().GetGraphicsCore();
@@ -199,8 +198,8 @@ ComputePipelineImporter::~ComputePipelineImporter() {
 	EngineCore& engineCore = EngineCore::GetInstance();
 	GraphicsAPI::Core* graphicsCore = engineCore.GetGraphicsCore();
 
-	for (auto& asset : assets) {
-		graphicsCore->DeleteComputePipeline(asset.second.pipeline);
+	for (ComputePipelineAsset& asset : assets) {
+		graphicsCore->DeleteComputePipeline(asset.pipeline);
 	}
-	assets.clear();
+	assets.Clear();
 }
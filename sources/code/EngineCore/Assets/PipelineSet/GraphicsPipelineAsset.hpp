@@ -34,6 +34,8 @@ namespace Grindstone {
 			std::array<Grindstone::Buffer, GraphicsAPI::numShaderGraphicStage> stageBuffers;
 			std::array<GraphicsAPI::ShaderStage, GraphicsAPI::numShaderGraphicStage> stageTypes;
 			std::array<GraphicsAPI::GraphicsPipeline::AttachmentData, 8> colorAttachmentData;
+			// Whether the shaders read per-draw data from an instance buffer, so identical draws can be merged.
+			bool isInstancingEnabled = false;
 		};
 
 		struct MetaData {
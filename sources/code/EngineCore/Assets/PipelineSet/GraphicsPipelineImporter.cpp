@@ -224,6 +224,7 @@ static bool ImportGraphicsPipelineAsset(GraphicsPipelineAsset& graphicsPipelineA
 		pipelineData.colorAttachmentCount = srcPass.attachmentCount;
 
 		UnpackGraphicsPipelineHeader(srcPass, pipelineData);
+		pass.isInstancingEnabled = srcPass.flags & 0b1000000;
 
 		for (uint8_t i = 0; i < srcPass.shaderStageCount; ++i) {
 			V1::PassPipelineShaderStageHeader& srcStage = shaderStages[srcPass.shaderStageStartIndex + i];
@@ -267,8 +268,7 @@ static bool ImportGraphicsPipelineAsset(GraphicsPipelineAsset& graphicsPipelineA
 }
 
 void* GraphicsPipelineImporter::LoadAsset(Uuid uuid) {
-	auto pipelineIterator = assets.emplace(uuid, GraphicsPipelineAsset(uuid));
-	Grindstone::GraphicsPipelineAsset& graphicsPipelineAsset = pipelineIterator.first->second;
+	Grindstone::GraphicsPipelineAsset& graphicsPipelineAsset = assets.Emplace(uuid, GraphicsPipelineAsset(uuid));
 
 	graphicsPipelineAsset.assetLoadStatus = AssetLoadStatus::Loading;
 	if (!ImportGraphicsPipelineAsset(graphicsPipelineAsset)) {
@@ -279,12 +279,12 @@ void* GraphicsPipelineImporter::LoadAsset(Uuid uuid) {
 }
 
 void GraphicsPipelineImporter::QueueReloadAsset(Uuid uuid) {
-	auto pipelineIterator = assets.find(uuid);
-	if (pipelineIterator == assets.end()) {
+	Grindstone::GraphicsPipelineAsset* graphicsPipelineAssetPtr = assets.Find(uuid);
+	if (graphicsPipelineAssetPtr == nullptr) {
 		return;
 	}
 
-	Grindstone::GraphicsPipelineAsset& graphicsPipelineAsset = pipelineIterator->second;
+	Grindstone::GraphicsPipelineAsset& graphicsPipelineAsset = *graphicsPipelineAssetPtr;
 
 	graphicsPipelineAsset.assetLoadStatus = AssetLoadStatus::Reloading;
 	Grindstone::GraphicsAPI::Core* graphicsCore = EngineCore::GetInstance().GetGraphicsCore();
@@ -295,5 +295,5 @@ void GraphicsPipelineImporter::QueueReloadAsset(Uuid uuid) {
 }
 
 GraphicsPipelineImporter::~GraphicsPipelineImporter() {
-	assets.clear();
+	assets.Clear();
 }
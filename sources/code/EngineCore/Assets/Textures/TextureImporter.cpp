@@ -15,24 +15,39 @@
 using namespace Grindstone;
 using namespace Grindstone::Formats::DDS;
 
-static bool LoadTextureAsset(TextureAsset& textureAsset) {
-	EngineCore& engineCore = EngineCore::GetInstance();
+struct TextureStreamedPayload : public Grindstone::Assets::StreamedAssetPayload {
+	bool isDecoded = false;
+	// The texture's status if it couldn't be decoded.
+	Grindstone::AssetLoadStatus failedStatus = Grindstone::AssetLoadStatus::Failed;
+	// Its data points into the file's buffer.
+	DdsParseOutput output{};
+};
 
-	Grindstone::Assets::AssetLoadBinaryResult result = engineCore.assetManager->LoadBinaryByUuid(AssetType::Texture, textureAsset.uuid);
+// Only reads the file, so it's safe to run in a streaming job.
+static void DecodeTexture(Uuid uuid, Grindstone::Assets::AssetLoadBinaryResult& result, TextureStreamedPayload& payload) {
 	if (result.status != Grindstone::Assets::AssetLoadStatus::Success) {
-		GPRINT_WARN_V(LogSource::EngineCore, "Unable to load texture: {}", textureAsset.uuid.ToString());
-		textureAsset.assetLoadStatus = Grindstone::AssetLoadStatus::Missing;
-		return false;
+		GPRINT_WARN_V(LogSource::EngineCore, "Unable to load texture: {}", uuid.ToString());
+		payload.failedStatus = Grindstone::AssetLoadStatus::Missing;
+		return;
 	}
 
-	textureAsset.name = result.displayName;
+	payload.isDecoded = TryParseDds(result.displayName.c_str(), result.buffer.GetSpan(), payload.output);
+}
 
-	DdsParseOutput output{};
-	if (!TryParseDds(textureAsset.name.c_str(), result.buffer.GetSpan(), output)) {
-		textureAsset.assetLoadStatus = Grindstone::AssetLoadStatus::Failed;
+static bool CreateTextureAsset(TextureAsset& textureAsset, Grindstone::Assets::AssetLoadBinaryResult& result, const TextureStreamedPayload& payload) {
+	EngineCore& engineCore = EngineCore::GetInstance();
+
+	if (result.status == Grindstone::Assets::AssetLoadStatus::Success) {
+		textureAsset.name = result.displayName;
+	}
+
+	if (!payload.isDecoded) {
+		textureAsset.assetLoadStatus = payload.failedStatus;
 		return false;
 	}
 
+	const DdsParseOutput& output = payload.output;
+
 	Grindstone::GraphicsAPI::Image::CreateInfo imgCreateInfo;
 	imgCreateInfo.debugName = textureAsset.name.c_str();
 	imgCreateInfo.initialData = reinterpret_cast<const char*>(&output.data.GetBegin());
@@ -72,9 +87,16 @@ static bool LoadTextureAsset(TextureAsset& textureAsset) {
 	return true;
 }
 
+static bool LoadTextureAsset(TextureAsset& textureAsset) {
+	EngineCore& engineCore = EngineCore::GetInstance();
+	Grindstone::Assets::AssetLoadBinaryResult result = engineCore.assetManager->LoadBinaryByUuid(AssetType::Texture, textureAsset.uuid);
+	TextureStreamedPayload payload;
+	DecodeTexture(textureAsset.uuid, result, payload);
+	return CreateTextureAsset(textureAsset, result, payload);
+}
+
 void* TextureImporter::LoadAsset(Uuid uuid) {
-	auto textureIterator = assets.emplace(uuid, TextureAsset(uuid));
-	TextureAsset& textureAsset = textureIterator.first->second;
+	TextureAsset& textureAsset = assets.Emplace(uuid, TextureAsset(uuid));
 
 	textureAsset.assetLoadStatus = AssetLoadStatus::Loading;
 	if (!LoadTextureAsset(textureAsset)) {
@@ -84,26 +106,46 @@ void* TextureImporter::LoadAsset(Uuid uuid) {
 	return &textureAsset;
 }
 
+void TextureImporter::CreateStreamingAsset(Uuid uuid) {
+	TextureAsset& textureAsset = assets.Emplace(uuid, TextureAsset(uuid));
+	textureAsset.assetLoadStatus = AssetLoadStatus::Loading;
+}
+
+std::unique_ptr<Assets::StreamedAssetPayload> TextureImporter::DecodeStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result) {
+	std::unique_ptr<TextureStreamedPayload> payload = std::make_unique<TextureStreamedPayload>();
+	DecodeTexture(uuid, result, *payload);
+	return payload;
+}
+
+void TextureImporter::FinishStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result, Assets::StreamedAssetPayload* payload) {
+	TextureAsset* textureAsset = assets.Find(uuid);
+	if (textureAsset == nullptr || textureAsset->assetLoadStatus != AssetLoadStatus::Loading || payload == nullptr) {
+		return;
+	}
+
+	CreateTextureAsset(*textureAsset, result, *static_cast<TextureStreamedPayload*>(payload));
+}
+
 void TextureImporter::QueueReloadAsset(Uuid uuid) {
-	auto textureIterator = assets.find(uuid);
-	if (textureIterator == assets.end()) {
+	TextureAsset* textureAsset = assets.Find(uuid);
+	if (textureAsset == nullptr) {
 		return;
 	}
 
 	EngineCore& engineCore = EngineCore::GetInstance();
-	textureIterator->second.assetLoadStatus = AssetLoadStatus::Reloading;
-	GraphicsAPI::Image* image = textureIterator->second.image;
-	GraphicsAPI::Sampler* defaultSampler = textureIterator->second.defaultSampler;
+	textureAsset->assetLoadStatus = AssetLoadStatus::Reloading;
+	GraphicsAPI::Image* image = textureAsset->image;
+	GraphicsAPI::Sampler* defaultSampler = textureAsset->defaultSampler;
 	engineCore.PushDeletion([image, defaultSampler]() {
 		EngineCore& engineCore = EngineCore::GetInstance();
 		GraphicsAPI::Core* graphicsCore = engineCore.GetGraphicsCore();
 		graphicsCore->DeleteImage(image);
 		// TODO: Maybe decrement sampler usage
 	});
-	textureIterator->second.image = nullptr;
-	textureIterator->second.defaultSampler = nullptr;
+	textureAsset->image = nullptr;
+	textureAsset->defaultSampler = nullptr;
 
-	LoadTextureAsset(textureIterator->second);
+	LoadTextureAsset(*textureAsset);
 }
 
 void TextureImporter::OnDeleteAsset(TextureAsset& asset) {
@@ -124,13 +166,13 @@ TextureImporter::~TextureImporter() {
 	EngineCore& engineCore = EngineCore::GetInstance();
 	GraphicsAPI::Core* graphicsCore = engineCore.GetGraphicsCore();
 
-	for (auto& asset : assets) {
-		Grindstone::GraphicsAPI::Image* image = asset.second.image;
-		Grindstone::GraphicsAPI::Sampler* sampler = asset.second.defaultSampler;
+	for (TextureAsset& asset : assets) {
+		Grindstone::GraphicsAPI::Image* image = asset.image;
+		Grindstone::GraphicsAPI::Sampler* sampler = asset.defaultSampler;
 		graphicsCore->DeleteImage(image);
 		// TODO: Maybe decrement sampler usage
 	}
-	assets.clear();
+	assets.Clear();
 
 	for (auto& asset : texturesByAddress) {
 		Grindstone::GraphicsAPI::Image* image = asset.second.image;
@@ -18,6 +18,10 @@ namespace Grindstone {
 		virtual void OnDeleteAsset(TextureAsset& asset) override;
 		virtual void* LoadAsset(Uuid uuid) override;
 		virtual void QueueReloadAsset(Uuid uuid) override;
+		virtual bool CanStreamAssets() const override { return true; }
+		virtual void CreateStreamingAsset(Uuid uuid) override;
+		virtual std::unique_ptr<Assets::StreamedAssetPayload> DecodeStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result) override;
+		virtual void FinishStreamingAsset(Uuid uuid, Assets::AssetLoadBinaryResult& result, Assets::StreamedAssetPayload* payload) override;
 	private:
 		std::map<std::string, TextureAsset> texturesByAddress;
 	};
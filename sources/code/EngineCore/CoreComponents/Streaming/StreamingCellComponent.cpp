@@ -0,0 +1,12 @@
+#include "EngineCore/Reflection/ComponentReflection.hpp"
+
+#include "StreamingCellComponent.hpp"
+
+using namespace Grindstone;
+
+REFLECT_STRUCT_BEGIN(StreamingCellComponent)
+	REFLECT_STRUCT_MEMBER(scene)
+	REFLECT_STRUCT_MEMBER(loadDistance)
+	REFLECT_STRUCT_MEMBER(unloadDistance)
+	REFLECT_NO_SUBCAT()
+REFLECT_STRUCT_END()
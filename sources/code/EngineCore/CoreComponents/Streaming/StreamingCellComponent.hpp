@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include "EngineCore/Reflection/ComponentReflection.hpp"
+
+namespace Grindstone {
+	// A cell of a streamed world. Its entities live in their own scene, which CellStreamer loads while a
+	// streaming source is near the cell's position, and unloads once every source has moved away.
+	struct StreamingCellComponent {
+		// The uuid of the scene holding the cell's entities.
+		std::string scene;
+		float loadDistance = 100.0f;
+		// Kept larger than loadDistance, so a source at the edge of the cell doesn't load and unload it every frame.
+		float unloadDistance = 120.0f;
+
+		REFLECT("StreamingCell")
+	};
+}
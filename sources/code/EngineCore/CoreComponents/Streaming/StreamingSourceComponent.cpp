@@ -0,0 +1,10 @@
+#include "EngineCore/Reflection/ComponentReflection.hpp"
+
+#include "StreamingSourceComponent.hpp"
+
+using namespace Grindstone;
+
+REFLECT_STRUCT_BEGIN(StreamingSourceComponent)
+	REFLECT_STRUCT_MEMBER(isEnabled)
+	REFLECT_NO_SUBCAT()
+REFLECT_STRUCT_END()
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "EngineCore/Reflection/ComponentReflection.hpp"
+
+namespace Grindstone {
+	// Loads the streaming cells around its entity. Main cameras are streaming sources without it.
+	struct StreamingSourceComponent {
+		bool isEnabled = true;
+
+		REFLECT("StreamingSource")
+	};
+}
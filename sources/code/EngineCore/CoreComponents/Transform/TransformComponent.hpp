@@ -7,6 +7,7 @@
 
 #include <EngineCore/ECS/Entity.hpp>
 #include <EngineCore/CoreComponents/Parent/ParentComponent.hpp>
+#include "WorldTransformComponent.hpp"
 
 namespace Grindstone {
 	struct TransformComponent {
@@ -18,7 +19,22 @@ namespace Grindstone {
 			return GetWorldTransformMatrix(entity.GetHandle(), entity.GetSceneEntityRegistry());
 		}
 
+		// Reads the matrix cached by UpdateWorldTransforms, so it reflects the transforms as of the last update.
 		static Math::Matrix4 GetWorldTransformMatrix(entt::entity entity, const entt::registry& registry) {
+			const WorldTransformComponent* worldTransformComponent = registry.try_get<WorldTransformComponent>(entity);
+			if (worldTransformComponent != nullptr && !worldTransformComponent->isDirty) {
+				return worldTransformComponent->worldMatrix;
+			}
+
+			return ComputeWorldTransformMatrix(entity, registry);
+		}
+
+		static Math::Matrix4 ComputeWorldTransformMatrix(ECS::Entity entity) {
+			return ComputeWorldTransformMatrix(entity.GetHandle(), entity.GetSceneEntityRegistry());
+		}
+
+		// Walks up the hierarchy to compute the current world matrix, ignoring the cache.
+		static Math::Matrix4 ComputeWorldTransformMatrix(entt::entity entity, const entt::registry& registry) {
 			Math::Matrix4 matrix = Math::Matrix4(1.0f);
 			entt::entity currentEntity = entity;
 			while (currentEntity != entt::null) {
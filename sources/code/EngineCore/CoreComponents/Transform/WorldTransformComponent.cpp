@@ -0,0 +1,150 @@
+#include <cstdint>
+#include <vector>
+
+#include <EngineCore/CoreComponents/Parent/ParentComponent.hpp>
+#include "TransformComponent.hpp"
+#include "WorldTransformComponent.hpp"
+
+using namespace Grindstone;
+
+namespace {
+	// Kept in the registry's context, so each registry counts its own passes.
+	struct WorldTransformUpdateState {
+		uint32_t updatePass = 0;
+	};
+}
+
+static entt::entity GetParentEntity(const entt::registry& registry, entt::entity entity) {
+	const ParentComponent* parentComponent = registry.try_get<ParentComponent>(entity);
+	return parentComponent == nullptr
+		? entt::null
+		: parentComponent->parentEntity;
+}
+
+// Depths are found by walking up to the closest ancestor with a known depth, so every entity
+// is only visited once, however deep the hierarchy is.
+static void SortByHierarchyDepth(entt::registry& registry) {
+	auto& worldStorage = registry.storage<WorldTransformComponent>();
+	const uint32_t unknownDepth = UINT32_MAX;
+	for (WorldTransformComponent& world : worldStorage) {
+		world.hierarchyDepth = unknownDepth;
+	}
+
+	std::vector<entt::entity> ancestorStack;
+	for (auto [entity, world] : worldStorage.each()) {
+		if (world.hierarchyDepth != unknownDepth) {
+			continue;
+		}
+
+		entt::entity currentEntity = entity;
+		uint32_t depth = 0;
+		while (currentEntity != entt::null) {
+			WorldTransformComponent& currentWorld = worldStorage.get(currentEntity);
+			if (currentWorld.hierarchyDepth != unknownDepth) {
+				depth = currentWorld.hierarchyDepth + 1;
+				break;
+			}
+
+			ancestorStack.push_back(currentEntity);
+			const entt::entity parentEntity = GetParentEntity(registry, currentEntity);
+			const bool isParentValid = parentEntity != entt::null && worldStorage.contains(parentEntity);
+			// SetParent refuses to create cycles, but don't hang if one was loaded from a scene.
+			if (!isParentValid || ancestorStack.size() > worldStorage.size()) {
+				break;
+			}
+
+			currentEntity = parentEntity;
+		}
+
+		while (!ancestorStack.empty()) {
+			worldStorage.get(ancestorStack.back()).hierarchyDepth = depth++;
+			ancestorStack.pop_back();
+		}
+	}
+
+	registry.sort<WorldTransformComponent>(
+		[](const WorldTransformComponent& lhs, const WorldTransformComponent& rhs) {
+			return lhs.hierarchyDepth < rhs.hierarchyDepth;
+		}
+	);
+}
+
+// Returns false if an entity was reached before its parent. Entities that couldn't be updated
+// because of that are left dirty, so another pass in the right order will update them.
+static bool UpdateWorldTransformsInStorageOrder(entt::registry& registry, uint32_t updatePass) {
+	auto& worldStorage = registry.storage<WorldTransformComponent>();
+	const auto& transformStorage = registry.storage<TransformComponent>();
+
+	bool isOrderValid = true;
+	for (auto [entity, world] : worldStorage.each()) {
+		world.lastUpdatePass = updatePass;
+
+		const TransformComponent& transform = transformStorage.get(entity);
+		const entt::entity parentEntity = GetParentEntity(registry, entity);
+		const WorldTransformComponent* parentWorld = (parentEntity != entt::null && worldStorage.contains(parentEntity))
+			? &worldStorage.get(parentEntity)
+			: nullptr;
+
+		if (parentWorld != nullptr && parentWorld->lastUpdatePass != updatePass) {
+			isOrderValid = false;
+			world.isDirty = true;
+			world.hasChanged = false;
+			continue;
+		}
+
+		const bool hasParentChanged = parentEntity != world.parentEntity || (parentWorld != nullptr) != world.hasParentTransform;
+		const bool hasLocalChanged = transform.position != world.localPosition
+			|| transform.rotation != world.localRotation
+			|| transform.scale != world.localScale;
+
+		world.hasChanged = world.isDirty
+			|| hasParentChanged
+			|| hasLocalChanged
+			|| (parentWorld != nullptr && parentWorld->hasChanged);
+
+		if (!world.hasChanged) {
+			continue;
+		}
+
+		world.localPosition = transform.position;
+		world.localRotation = transform.rotation;
+		world.localScale = transform.scale;
+		world.parentEntity = parentEntity;
+		world.hasParentTransform = parentWorld != nullptr;
+		world.isDirty = false;
+
+		const Math::Matrix4 localMatrix = transform.GetTransformMatrix();
+		world.worldMatrix = parentWorld != nullptr
+			? parentWorld->worldMatrix * localMatrix
+			: localMatrix;
+	}
+
+	return isOrderValid;
+}
+
+void Grindstone::UpdateWorldTransforms(entt::registry& registry) {
+	std::vector<entt::entity> changedEntities;
+	for (entt::entity entity : registry.view<TransformComponent>(entt::exclude<WorldTransformComponent>)) {
+		changedEntities.push_back(entity);
+	}
+
+	for (entt::entity entity : changedEntities) {
+		registry.emplace<WorldTransformComponent>(entity);
+	}
+
+	changedEntities.clear();
+	for (entt::entity entity : registry.view<WorldTransformComponent>(entt::exclude<TransformComponent>)) {
+		changedEntities.push_back(entity);
+	}
+
+	registry.remove<WorldTransformComponent>(changedEntities.begin(), changedEntities.end());
+
+	WorldTransformUpdateState& updateState = registry.ctx().emplace<WorldTransformUpdateState>();
+
+	// The storage stays sorted by depth between updates, so it's only re-sorted after
+	// a new child or a reparent puts a child ahead of its parent.
+	if (!UpdateWorldTransformsInStorageOrder(registry, ++updateState.updatePass)) {
+		SortByHierarchyDepth(registry);
+		UpdateWorldTransformsInStorageOrder(registry, ++updateState.updatePass);
+	}
+}
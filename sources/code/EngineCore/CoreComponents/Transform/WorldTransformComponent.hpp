@@ -0,0 +1,42 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+#include <Common/HashedString.hpp>
+#include <Common/Math.hpp>
+
+namespace Grindstone {
+	/*
+	 * The world matrix of an entity's TransformComponent, cached by UpdateWorldTransforms. It isn't
+	 * reflected, so it's never saved with scenes or shown in the inspector. Entities with a transform
+	 * get one the first time the transforms are updated.
+	 */
+	struct WorldTransformComponent {
+		Math::Matrix4 worldMatrix = Math::Matrix4(1.0f);
+
+		// The local transform and parent that worldMatrix was computed from.
+		Math::Quaternion localRotation = Math::Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
+		Math::Float3 localPosition = Math::Float3(0.0f, 0.0f, 0.0f);
+		Math::Float3 localScale = Math::Float3(1.0f, 1.0f, 1.0f);
+		entt::entity parentEntity = entt::null;
+		bool hasParentTransform = false;
+
+		// Set until worldMatrix has been computed from the current local transform and parent.
+		bool isDirty = true;
+		// Whether worldMatrix changed during the last update, so children need recomputing.
+		bool hasChanged = false;
+
+		uint32_t hierarchyDepth = 0;
+		uint32_t lastUpdatePass = 0;
+
+		static Grindstone::ConstHashedString GetComponentHashString() { return Grindstone::ConstHashedString("WorldTransform"); }
+	};
+
+	/*
+	 * Recomputes the world matrices of every entity whose local transform, parent, or ancestors changed
+	 * since the last update. Parents are always updated before their children. Changes are found by
+	 * comparing each local transform against the one its world matrix was computed from, so transforms
+	 * can keep being written to directly.
+	 */
+	void UpdateWorldTransforms(entt::registry& registry);
+}
@@ -9,6 +9,8 @@
 #include "Lights/PointLightComponent.hpp"
 #include "Lights/SpotLightComponent.hpp"
 #include "Lights/DirectionalLightComponent.hpp"
+#include "Streaming/StreamingCellComponent.hpp"
+#include "Streaming/StreamingSourceComponent.hpp"
 
 using namespace Grindstone;
 
@@ -21,4 +23,6 @@ void Grindstone::SetupCoreComponents(ECS::ComponentRegistrar* registrar) {
 	registrar->RegisterComponent<Grindstone::PointLightComponent>();
 	registrar->RegisterComponent<Grindstone::DirectionalLightComponent>();
 	registrar->RegisterComponent<Grindstone::EnvironmentMapComponent>();
+	registrar->RegisterComponent<Grindstone::StreamingCellComponent>();
+	registrar->RegisterComponent<Grindstone::StreamingSourceComponent>();
 }
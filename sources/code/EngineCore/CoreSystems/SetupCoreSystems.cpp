@@ -1,8 +1,26 @@
 #include "../ECS/SystemRegistrar.hpp"
+#include <EngineCore/CoreComponents/Parent/ParentComponent.hpp>
+#include <EngineCore/CoreComponents/Transform/TransformComponent.hpp>
+#include <EngineCore/CoreComponents/Transform/WorldTransformComponent.hpp>
 #include "SetupCoreSystems.hpp"
 #include "RenderSystem.hpp"
+#include "TransformSystem.hpp"
 using namespace Grindstone;
 
 void Grindstone::SetupCoreSystems(ECS::SystemRegistrar* registrar) {
-	registrar->RegisterSystem("Render", RenderSystem);
+	// Late, so the world transforms are cached after every system that writes transforms, including
+	// exclusive ones like scripts, and before rendering reads them.
+	ECS::SystemComponentAccess transformAccess;
+	transformAccess
+		.Read<TransformComponent, ParentComponent>()
+		.Write<WorldTransformComponent>()
+		.InStage(ECS::SystemStage::LateUpdate);
+
+	registrar->RegisterSystem("Transform", TransformSystem, transformAccess);
+	registrar->RegisterEditorSystem("Transform", TransformSystem, transformAccess);
+
+	// Rendering is exclusive, so it waits for every system of the earlier stages.
+	ECS::SystemComponentAccess renderAccess = ECS::SystemComponentAccess::Exclusive();
+	renderAccess.InStage(ECS::SystemStage::Render);
+	registrar->RegisterSystem("Render", RenderSystem, renderAccess);
 }
@@ -0,0 +1,13 @@
+#include <EngineCore/CoreComponents/Parent/ParentComponent.hpp>
+#include <EngineCore/CoreComponents/Transform/TransformComponent.hpp>
+#include <EngineCore/CoreComponents/Transform/WorldTransformComponent.hpp>
+#include <EngineCore/Profiling.hpp>
+
+#include "TransformSystem.hpp"
+
+namespace Grindstone {
+	void TransformSystem(Grindstone::WorldContextSet& worldContextSet) {
+		GRIND_PROFILE_SCOPE("TransformSystem()");
+		UpdateWorldTransforms(worldContextSet.GetEntityRegistry());
+	}
+}
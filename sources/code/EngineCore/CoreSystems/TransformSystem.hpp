@@ -0,0 +1,7 @@
+#pragma once
+
+#include <EngineCore/WorldContext/WorldContextSet.hpp>
+
+namespace Grindstone {
+	void TransformSystem(Grindstone::WorldContextSet& worldContextSet);
+}
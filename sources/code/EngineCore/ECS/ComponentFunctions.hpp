@@ -18,6 +18,9 @@ namespace Grindstone {
 		using CreateComponentFn = void*(*)(entt::registry&, entt::entity);
 		using RemoveComponentFn = void(*)(entt::registry&, entt::entity);
 		using CopyRegistryComponentsFn = void(*)(WorldContextSet& dst, WorldContextSet& src);
+		using CreateComponentsFn = void(*)(entt::registry&, const entt::entity* entities, size_t entityCount);
+		using ConstructCopyableComponentFn = void(*)(void* destination);
+		using InsertCopiedComponentsFn = void(*)(entt::registry&, const entt::entity* entities, size_t entityCount, const void* components);
 		
 		class ComponentFunctions {
 		public:
@@ -30,6 +33,10 @@ namespace Grindstone {
 			TryGetComponentFn TryGetComponentFn = nullptr;
 			GetComponentReflectionDataFn GetComponentReflectionDataFn = nullptr;
 			CopyRegistryComponentsFn CopyRegistryComponentsFn = nullptr;
+			CreateComponentsFn CreateComponentsFn = nullptr;
+			// Only set for trivially copyable components, whose bytes can be cooked ahead of time and copied back in.
+			ConstructCopyableComponentFn ConstructCopyableComponentFn = nullptr;
+			InsertCopiedComponentsFn InsertCopiedComponentsFn = nullptr;
 		};
 	}
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstring>
+#include <type_traits>
+#include <vector>
 #include <entt/entt.hpp>
 #include <EngineCore/WorldContext/WorldContextSet.hpp>
 
@@ -31,6 +34,34 @@ namespace Grindstone::ECS {
 		return &registry.emplace<ComponentType>(entity);
 	}
 
+	template<typename ComponentType>
+	void CreateComponents(entt::registry& registry, const entt::entity* entities, size_t entityCount) {
+		auto& storage = registry.storage<ComponentType>();
+		storage.reserve(storage.size() + entityCount);
+		for (size_t i = 0; i < entityCount; ++i) {
+			registry.emplace<ComponentType>(entities[i]);
+		}
+	}
+
+	template<typename ComponentType>
+	void ConstructCopyableComponent(void* destination) {
+		new (destination) ComponentType();
+	}
+
+	template<typename ComponentType>
+	void InsertCopiedComponents(entt::registry& registry, const entt::entity* entities, size_t entityCount, const void* components) {
+		// Cooked data is only as aligned as the buffer it was loaded into.
+		if (reinterpret_cast<uintptr_t>(components) % alignof(ComponentType) == 0) {
+			const ComponentType* firstComponent = static_cast<const ComponentType*>(components);
+			registry.insert<ComponentType>(entities, entities + entityCount, firstComponent);
+			return;
+		}
+
+		std::vector<ComponentType> alignedComponents(entityCount);
+		std::memcpy(alignedComponents.data(), components, entityCount * sizeof(ComponentType));
+		registry.insert<ComponentType>(entities, entities + entityCount, alignedComponents.begin());
+	}
+
 	template<typename ComponentType>
 	void RemoveComponent(entt::registry& registry, entt::entity entity) {
 		if (registry.any_of<ComponentType>(entity)) {
@@ -81,6 +81,40 @@ void ComponentRegistrar::CallDestroyOnRegistry(Grindstone::WorldContextSet& worl
 	}
 }
 
+void ComponentRegistrar::CallCreateOnEntities(Grindstone::WorldContextSet& worldContextSet, const entt::entity* entities, size_t entityCount) {
+	entt::registry& registry = worldContextSet.GetEntityRegistry();
+
+	for (auto& compFnPair : componentFunctionsList) {
+		ComponentFunctions& compFns = compFnPair.second;
+		if (compFns.SetupComponentFn == nullptr) {
+			continue;
+		}
+
+		for (size_t entityIndex = 0; entityIndex < entityCount; ++entityIndex) {
+			if (compFns.HasComponentFn(registry, entities[entityIndex])) {
+				compFns.SetupComponentFn(worldContextSet, entities[entityIndex]);
+			}
+		}
+	}
+}
+
+void ComponentRegistrar::CallDestroyOnEntities(Grindstone::WorldContextSet& worldContextSet, const entt::entity* entities, size_t entityCount) {
+	entt::registry& registry = worldContextSet.GetEntityRegistry();
+
+	for (auto& compFnPair : componentFunctionsList) {
+		ComponentFunctions& compFns = compFnPair.second;
+		if (compFns.DestroyComponentFn == nullptr) {
+			continue;
+		}
+
+		for (size_t entityIndex = 0; entityIndex < entityCount; ++entityIndex) {
+			if (compFns.HasComponentFn(registry, entities[entityIndex])) {
+				compFns.DestroyComponentFn(worldContextSet, entities[entityIndex]);
+			}
+		}
+	}
+}
+
 void ComponentRegistrar::RegisterComponent(Grindstone::HashedString name, ComponentFunctions componentFunctions) {
 	auto comp = componentFunctionsList.find(name);
 	if (comp != componentFunctionsList.end()) {
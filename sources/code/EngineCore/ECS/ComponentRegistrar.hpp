@@ -29,6 +29,13 @@ namespace Grindstone::ECS {
 				destroyComponentFn = ComponentType::Destroy;
 			}
 
+			ConstructCopyableComponentFn constructCopyableComponentFn = nullptr;
+			InsertCopiedComponentsFn insertCopiedComponentsFn = nullptr;
+			if constexpr (std::is_trivially_copyable_v<ComponentType>) {
+				constructCopyableComponentFn = &ECS::ConstructCopyableComponent<ComponentType>;
+				insertCopiedComponentsFn = &ECS::InsertCopiedComponents<ComponentType>;
+			}
+
 			RegisterComponent(
 				ComponentType::GetComponentHashString(),
 				ComponentFunctions{
@@ -40,7 +47,10 @@ namespace Grindstone::ECS {
 					&ECS::HasComponent<ComponentType>,
 					&ECS::TryGetComponent<ComponentType>,
 					&ECS::GetComponentReflectionData<ComponentType>,
-					&ECS::CopyRegistryComponents<ComponentType>
+					&ECS::CopyRegistryComponents<ComponentType>,
+					&ECS::CreateComponents<ComponentType>,
+					constructCopyableComponentFn,
+					insertCopiedComponentsFn
 				}
 			);
 		}
@@ -65,6 +75,9 @@ namespace Grindstone::ECS {
 		virtual void CopyRegistry(WorldContextSet& to, WorldContextSet& from);
 		virtual void CallCreateOnRegistry(WorldContextSet& worldContextSet);
 		virtual void CallDestroyOnRegistry(WorldContextSet& worldContextSet);
+		// Like CallCreateOnRegistry and CallDestroyOnRegistry, but only for the given entities.
+		virtual void CallCreateOnEntities(WorldContextSet& worldContextSet, const entt::entity* entities, size_t entityCount);
+		virtual void CallDestroyOnEntities(WorldContextSet& worldContextSet, const entt::entity* entities, size_t entityCount);
 		virtual void DestroyEntity(ECS::Entity entity);
 		virtual void RegisterComponent(Grindstone::HashedString name, ComponentFunctions componentFunctions);
 		virtual void UnregisterComponent(Grindstone::HashedString name);
@@ -82,7 +82,8 @@ bool Entity::SetParent(const Entity newParent) {
 
 	TransformComponent& transformComponent = GetComponent<TransformComponent>();
 	auto& [parentEntity] = GetComponent<ParentComponent>();
-	const Math::Matrix4 currentWorldMatrix = GetWorldMatrix();
+	// The cached world matrices may be out of date if the hierarchy has been changed this frame.
+	const Math::Matrix4 currentWorldMatrix = TransformComponent::ComputeWorldTransformMatrix(*this);
 
 	if (!newParent) {
 		transformComponent.SetLocalMatrix(currentWorldMatrix);
@@ -90,7 +91,7 @@ bool Entity::SetParent(const Entity newParent) {
 		return true;
 	}
 
-	transformComponent.SetWorldMatrixRelativeTo(currentWorldMatrix, newParent.GetWorldMatrix());
+	transformComponent.SetWorldMatrixRelativeTo(currentWorldMatrix, TransformComponent::ComputeWorldTransformMatrix(newParent));
 	parentEntity = newParent.entityId;
 
 	return true;
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <entt/entity/registry.hpp>
+
+namespace Grindstone::ECS {
+	// Conflicting systems run in stage order, and in registration order within a stage.
+	enum class SystemStage : uint8_t {
+		Update,
+		// For systems that must see everything the Update systems wrote, like caching world transforms.
+		LateUpdate,
+		Render
+	};
+
+	/*
+	 * Describes which component types a system reads and writes. The SystemRegistrar
+	 * uses this to decide which systems can run at the same time. Systems registered
+	 * without a declaration are treated as exclusive: they run alone on the calling
+	 * thread, in stage and registration order relative to every other system.
+	 */
+	struct SystemComponentAccess {
+		using PrepareStorageFn = void(*)(entt::registry&);
+
+		struct Entry {
+			uint64_t componentHash = 0;
+			// Creates the component pool up front, so concurrently running systems never
+			// insert a pool into the registry while another system is iterating it.
+			PrepareStorageFn prepareStorageFn = nullptr;
+		};
+
+		std::vector<Entry> reads;
+		std::vector<Entry> writes;
+		bool isExclusive = false;
+		SystemStage stage = SystemStage::Update;
+
+		static SystemComponentAccess Exclusive() {
+			SystemComponentAccess access;
+			access.isExclusive = true;
+			return access;
+		}
+
+		SystemComponentAccess& InStage(SystemStage newStage) {
+			stage = newStage;
+			return *this;
+		}
+
+		template<typename... ComponentTypes>
+		SystemComponentAccess& Read() {
+			(reads.push_back(MakeEntry<ComponentTypes>()), ...);
+			return *this;
+		}
+
+		template<typename... ComponentTypes>
+		SystemComponentAccess& Write() {
+			(writes.push_back(MakeEntry<ComponentTypes>()), ...);
+			return *this;
+		}
+
+		[[nodiscard]] bool ConflictsWith(const SystemComponentAccess& other) const {
+			if (isExclusive || other.isExclusive) {
+				return true;
+			}
+
+			return Overlaps(writes, other.writes) ||
+				Overlaps(writes, other.reads) ||
+				Overlaps(reads, other.writes);
+		}
+
+		void PrepareStorage(entt::registry& registry) const {
+			for (const Entry& entry : reads) {
+				entry.prepareStorageFn(registry);
+			}
+
+			for (const Entry& entry : writes) {
+				entry.prepareStorageFn(registry);
+			}
+		}
+
+	private:
+		template<typename ComponentType>
+		static Entry MakeEntry() {
+			return Entry{
+				ComponentType::GetComponentHashString().GetHash(),
+				[](entt::registry& registry) { static_cast<void>(registry.storage<ComponentType>()); }
+			};
+		}
+
+		[[nodiscard]] static bool Overlaps(const std::vector<Entry>& a, const std::vector<Entry>& b) {
+			for (const Entry& entryA : a) {
+				for (const Entry& entryB : b) {
+					if (entryA.componentHash == entryB.componentHash) {
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+	};
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <EngineCore/Profiling.hpp>
 #include <EngineCore/Logger.hpp>
 
@@ -5,68 +7,180 @@
 
 using namespace Grindstone::ECS;
 
-SystemRegistrar::SystemRegistrar() {
+using RegisteredSystem = SystemRegistrar::RegisteredSystem;
+
+static std::vector<RegisteredSystem>::iterator FindSystem(std::vector<RegisteredSystem>& systemList, const char* name) {
+	return std::find_if(
+		systemList.begin(),
+		systemList.end(),
+		[name](const RegisteredSystem& system) { return system.name == name; }
+	);
+}
+
+SystemRegistrar::SystemRegistrar(Grindstone::Jobs::JobSystem* jobSystem) : jobSystem(jobSystem) {
 }
 
 void SystemRegistrar::RegisterSystem(const char* name, SystemFactory factory) {
-	auto sys = editorSystemFactories.find(name);
-	if (sys != editorSystemFactories.end()) {
+	RegisterSystem(name, factory, SystemComponentAccess::Exclusive());
+}
+
+void SystemRegistrar::RegisterSystem(const char* name, SystemFactory factory, const SystemComponentAccess& access) {
+	if (FindSystem(systems, name) != systems.end()) {
 		GPRINT_ERROR_V(LogSource::EngineCore, "Registering a system that has already been registered: {}", name);
 		return;
 	}
 
-	systemFactories.emplace(name, factory);
+	systems.push_back(RegisteredSystem{ name, factory, access, Grindstone::Profiler::Manager::Get().InternName(name) });
+	schedule.isDirty = true;
 }
 
 void SystemRegistrar::RegisterEditorSystem(const char* name, SystemFactory factory) {
-	auto sys = editorSystemFactories.find(name);
-	if (sys != editorSystemFactories.end()) {
+	RegisterEditorSystem(name, factory, SystemComponentAccess::Exclusive());
+}
+
+void SystemRegistrar::RegisterEditorSystem(const char* name, SystemFactory factory, const SystemComponentAccess& access) {
+	if (FindSystem(editorSystems, name) != editorSystems.end()) {
 		GPRINT_ERROR_V(LogSource::EngineCore, "Registering an editor system that has already been registered: {}", name);
 		return;
 	}
 
-	editorSystemFactories.emplace(name, factory);
+	editorSystems.push_back(RegisteredSystem{ name, factory, access, Grindstone::Profiler::Manager::Get().InternName(name) });
+	editorSchedule.isDirty = true;
 }
 
 void SystemRegistrar::UnregisterSystem(const char* name) {
-	auto sys = systemFactories.find(name);
-	if (sys == systemFactories.end()) {
+	auto sys = FindSystem(systems, name);
+	if (sys == systems.end()) {
 		GPRINT_ERROR_V(LogSource::EngineCore, "Unregistering a system that isn't registered: {}", name);
 		return;
 	}
 
-	systemFactories.erase(sys);
+	systems.erase(sys);
+	schedule.isDirty = true;
 }
 
 void SystemRegistrar::UnregisterEditorSystem(const char* name) {
-	auto sys = editorSystemFactories.find(name);
-	if (sys == editorSystemFactories.end()) {
+	auto sys = FindSystem(editorSystems, name);
+	if (sys == editorSystems.end()) {
 		GPRINT_ERROR_V(LogSource::EngineCore, "Unregistering an editor system that isn't registered: {}", name);
 		return;
 	}
 
-	editorSystemFactories.erase(sys);
+	editorSystems.erase(sys);
+	editorSchedule.isDirty = true;
 }
 
 void SystemRegistrar::Update(Grindstone::WorldContextSet& worldContextSet) {
 	GRIND_PROFILE_SCOPE("SystemRegistrar::Update");
-	for (auto& systemFactory : systemFactories) {
-		GRIND_PROFILE_SCOPE(systemFactory.first.c_str());
-		auto systemFn = systemFactory.second;
-		systemFn(worldContextSet);
-	}
+	RunSystems(systems, schedule, worldContextSet);
 }
 
 void SystemRegistrar::EditorUpdate(Grindstone::WorldContextSet& worldContextSet) {
 	GRIND_PROFILE_SCOPE("SystemRegistrar::EditorUpdate");
-	for (auto& systemFactory : editorSystemFactories) {
-		GRIND_PROFILE_SCOPE(systemFactory.first.c_str());
-		auto systemFn = systemFactory.second;
-		systemFn(worldContextSet);
+	RunSystems(editorSystems, editorSchedule, worldContextSet);
+}
+
+// Every pair of conflicting systems gets an edge from the one in the earlier stage, or registered first
+// within a stage, to the other one, so the graph is acyclic and conflicting systems keep a deterministic order.
+void SystemRegistrar::BuildSchedule(const std::vector<RegisteredSystem>& systemList, Schedule& targetSchedule) {
+	const size_t systemCount = systemList.size();
+	targetSchedule.dependents.assign(systemCount, {});
+	targetSchedule.dependencyCounts.assign(systemCount, 0);
+
+	std::vector<size_t> executionOrder(systemCount);
+	for (size_t i = 0; i < systemCount; ++i) {
+		executionOrder[i] = i;
+	}
+
+	std::stable_sort(executionOrder.begin(), executionOrder.end(), [&systemList](size_t a, size_t b) {
+		return systemList[a].access.stage < systemList[b].access.stage;
+	});
+
+	for (size_t laterPosition = 0; laterPosition < systemCount; ++laterPosition) {
+		const size_t later = executionOrder[laterPosition];
+		for (size_t earlierPosition = 0; earlierPosition < laterPosition; ++earlierPosition) {
+			const size_t earlier = executionOrder[earlierPosition];
+			if (systemList[earlier].access.ConflictsWith(systemList[later].access)) {
+				targetSchedule.dependents[earlier].push_back(later);
+				++targetSchedule.dependencyCounts[later];
+			}
+		}
+	}
+
+	targetSchedule.isDirty = false;
+}
+
+void SystemRegistrar::RunSystems(const std::vector<RegisteredSystem>& systemList, Schedule& targetSchedule, Grindstone::WorldContextSet& worldContextSet) {
+	if (systemList.empty()) {
+		return;
 	}
+
+	if (targetSchedule.isDirty) {
+		BuildSchedule(systemList, targetSchedule);
+	}
+
+	entt::registry& registry = worldContextSet.GetEntityRegistry();
+	for (const RegisteredSystem& system : systemList) {
+		system.access.PrepareStorage(registry);
+	}
+
+	const size_t systemCount = systemList.size();
+	if (remainingDependenciesCapacity < systemCount) {
+		remainingDependencies = std::make_unique<std::atomic<uint32_t>[]>(systemCount);
+		remainingDependenciesCapacity = systemCount;
+	}
+
+	for (size_t i = 0; i < systemCount; ++i) {
+		remainingDependencies[i].store(targetSchedule.dependencyCounts[i], std::memory_order_relaxed);
+	}
+
+	activeSystems = &systemList;
+	activeSchedule = &targetSchedule;
+	activeWorldContextSet = &worldContextSet;
+
+	for (size_t i = 0; i < systemCount; ++i) {
+		if (targetSchedule.dependencyCounts[i] == 0) {
+			ScheduleSystem(i);
+		}
+	}
+
+	// Exclusive systems are main-thread jobs, so they run here while we wait.
+	jobSystem->Wait(systemsCounter);
+
+	activeSystems = nullptr;
+	activeSchedule = nullptr;
+	activeWorldContextSet = nullptr;
+}
+
+// A system is scheduled once every system it conflicts with has finished. Dependents are scheduled
+// before the finishing system's job completes, so systemsCounter can't reach zero early.
+void SystemRegistrar::ScheduleSystem(size_t systemIndex) {
+	const Grindstone::Jobs::JobAffinity affinity = (*activeSystems)[systemIndex].access.isExclusive
+		? Grindstone::Jobs::JobAffinity::MainThread
+		: Grindstone::Jobs::JobAffinity::Any;
+
+	jobSystem->Schedule(
+		[this, systemIndex] {
+			RunSystem(systemIndex);
+
+			for (size_t dependentIndex : activeSchedule->dependents[systemIndex]) {
+				if (remainingDependencies[dependentIndex].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					ScheduleSystem(dependentIndex);
+				}
+			}
+		},
+		&systemsCounter,
+		affinity
+	);
+}
+
+void SystemRegistrar::RunSystem(size_t systemIndex) {
+	const RegisteredSystem& system = (*activeSystems)[systemIndex];
+	GRIND_PROFILE_SCOPE_ID(system.profilerNameId);
+	system.factory(*activeWorldContextSet);
 }
 
 SystemRegistrar::~SystemRegistrar() {
-	systemFactories.clear();
-	editorSystemFactories.clear();
+	systems.clear();
+	editorSystems.clear();
 }
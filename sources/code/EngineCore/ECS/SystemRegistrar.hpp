@@ -1,9 +1,14 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <atomic>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
+#include <EngineCore/Jobs/JobSystem.hpp>
+
+#include "SystemComponentAccess.hpp"
 #include "SystemFactory.hpp"
 using namespace Grindstone;
 
@@ -11,17 +16,50 @@ namespace Grindstone {
 	namespace ECS {
 		class SystemRegistrar {
 		public:
-			SystemRegistrar();
+			struct RegisteredSystem {
+				std::string name;
+				SystemFactory factory = nullptr;
+				SystemComponentAccess access;
+				// System names are dynamic, so they're interned once when registered.
+				uint32_t profilerNameId = 0;
+			};
+
+			SystemRegistrar(Grindstone::Jobs::JobSystem* jobSystem);
 			virtual void RegisterSystem(const char* name, SystemFactory factory);
+			virtual void RegisterSystem(const char* name, SystemFactory factory, const SystemComponentAccess& access);
 			virtual void RegisterEditorSystem(const char* name, SystemFactory factory);
+			virtual void RegisterEditorSystem(const char* name, SystemFactory factory, const SystemComponentAccess& access);
 			virtual void UnregisterSystem(const char* name);
 			virtual void UnregisterEditorSystem(const char* name);
 			void Update(Grindstone::WorldContextSet& worldContextSet);
 			void EditorUpdate(Grindstone::WorldContextSet& worldContextSet);
 			~SystemRegistrar();
-			std::unordered_map<std::string, SystemFactory> systemFactories;
-			std::unordered_map<std::string, SystemFactory> editorSystemFactories;
+
+			// Stored in registration order. Conflicting systems run in stage order, then in this order.
+			std::vector<RegisteredSystem> systems;
+			std::vector<RegisteredSystem> editorSystems;
 		private:
+			struct Schedule {
+				std::vector<std::vector<size_t>> dependents;
+				std::vector<uint32_t> dependencyCounts;
+				bool isDirty = true;
+			};
+
+			void BuildSchedule(const std::vector<RegisteredSystem>& systemList, Schedule& schedule);
+			void RunSystems(const std::vector<RegisteredSystem>& systemList, Schedule& schedule, Grindstone::WorldContextSet& worldContextSet);
+			void ScheduleSystem(size_t systemIndex);
+			void RunSystem(size_t systemIndex);
+
+			Schedule schedule;
+			Schedule editorSchedule;
+
+			Grindstone::Jobs::JobSystem* jobSystem = nullptr;
+			Grindstone::Jobs::JobCounter systemsCounter;
+			std::unique_ptr<std::atomic<uint32_t>[]> remainingDependencies;
+			size_t remainingDependenciesCapacity = 0;
+			const std::vector<RegisteredSystem>* activeSystems = nullptr;
+			const Schedule* activeSchedule = nullptr;
+			Grindstone::WorldContextSet* activeWorldContextSet = nullptr;
 		};
 	}
 }
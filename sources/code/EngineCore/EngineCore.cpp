@@ -3,6 +3,7 @@
 
 #include <EngineCore/Utils/MemoryAllocator.hpp>
 #include <EngineCore/ECS/SystemRegistrar.hpp>
+#include <EngineCore/Jobs/JobSystem.hpp>
 #include <EngineCore/ECS/ComponentRegistrar.hpp>
 #include <EngineCore/CoreComponents/setupCoreComponents.hpp>
 #include <EngineCore/CoreSystems/setupCoreSystems.hpp>
@@ -50,7 +51,9 @@ bool EngineCore::EarlyInitialize(EarlyCreateInfo& createInfo) {
 	firstFrameTime = std::chrono::steady_clock::now();
 
 	profiler = &Profiler::Manager::Get();
-	systemRegistrar = AllocatorCore::Allocate<ECS::SystemRegistrar>();
+	profiler->Initialize();
+	jobSystem = AllocatorCore::Allocate<Jobs::JobSystem>();
+	systemRegistrar = AllocatorCore::Allocate<ECS::SystemRegistrar>(jobSystem);
 	componentRegistrar = AllocatorCore::Allocate<ECS::ComponentRegistrar>();
 
 	pluginInterface = AllocatorCore::Allocate<Plugins::Interface>();
@@ -58,7 +61,7 @@ bool EngineCore::EarlyInitialize(EarlyCreateInfo& createInfo) {
 	pluginInterface->systemRegistrar = systemRegistrar;
 
 	Logger::Initialize(projectPath / "log" / "output.log", eventDispatcher);
-	GRIND_PROFILE_BEGIN_SESSION("Grindstone Loading", projectPath / "log" / "grind-profile-load.json");
+	GRIND_PROFILE_BEGIN_SESSION("Grindstone Loading", projectPath / "log" / "grind-profile-load.gtrace");
 	GPRINT_INFO_V(LogSource::EngineCore, "Initializing {0}...", createInfo.applicationTitle);
 
 	return true;
@@ -121,11 +124,18 @@ bool EngineCore::Initialize(LateCreateInfo& createInfo) {
 	}
 
 	const uint32_t poolSize = 2048;
-	deferredDeletionQueue.Initialize(mainWindow->GetWindowGraphicsBinding()->GetMaxFramesInFlight(), poolSize);
+	const uint32_t maxFramesInFlight = mainWindow->GetWindowGraphicsBinding()->GetMaxFramesInFlight();
+	deferredDeletionQueue.Initialize(maxFramesInFlight, poolSize);
+
+	const size_t frameArenaSizeInMegs = 16u;
+	if (!AllocatorCore::InitializeFrameAllocator(maxFramesInFlight, frameArenaSizeInMegs)) {
+		GPRINT_ERROR(LogSource::EngineCore, "Could not allocate the frame arenas.");
+		return false;
+	}
 
 	{
 		GRIND_PROFILE_SCOPE("Initialize Asset Managers");
-		assetManager = AllocatorCore::Allocate<Assets::AssetManager>(createInfo.assetLoader);
+		assetManager = AllocatorCore::Allocate<Assets::AssetManager>(createInfo.assetLoader, jobSystem);
 		assetRendererManager = AllocatorCore::Allocate<AssetRendererManager>();
 	}
 
@@ -183,20 +193,29 @@ void EngineCore::Run() {
 	}
 }
 
-void EngineCore::RunEditorLoopIteration() {
-	GRIND_PROFILE_BEGIN_SESSION("Grindstone Running", projectPath / "log/grind-profile-run.json");
+void EngineCore::BeginFrame() {
 	windowManager->GetWindowByIndex(0)->GetWindowGraphicsBinding()->WaitForRenderingFence();
 	deferredDeletionQueue.DeleteForFrame();
+	AllocatorCore::BeginFrame();
+}
+
+void EngineCore::RunEditorLoopIteration() {
+	GRIND_PROFILE_BEGIN_SESSION("Grindstone Running", projectPath / "log/grind-profile-run.gtrace");
+	BeginFrame();
 	assetManager->ReloadQueuedAssets();
+	jobSystem->RunMainThreadJobs();
+	assetManager->ProcessStreamedAssets();
 	CalculateDeltaTime();
 	systemRegistrar->EditorUpdate(*worldContextManager->GetActiveWorldContextSet());
 	GRIND_PROFILE_END_SESSION();
 }
 
 void EngineCore::RunLoopIteration() {
-	GRIND_PROFILE_BEGIN_SESSION("Grindstone Running", projectPath / "log/grind-profile-run.json");
-	windowManager->GetWindowByIndex(0)->GetWindowGraphicsBinding()->WaitForRenderingFence();
-	deferredDeletionQueue.DeleteForFrame();
+	GRIND_PROFILE_BEGIN_SESSION("Grindstone Running", projectPath / "log/grind-profile-run.gtrace");
+	BeginFrame();
+	jobSystem->RunMainThreadJobs();
+	assetManager->ProcessStreamedAssets();
+	sceneManager->GetCellStreamer().Update();
 	CalculateDeltaTime();
 	systemRegistrar->Update(*worldContextManager->GetActiveWorldContextSet());
 	GRIND_PROFILE_END_SESSION();
@@ -253,10 +272,17 @@ EngineCore::~EngineCore() {
 
 	AllocatorCore::Free(componentRegistrar);
 	AllocatorCore::Free(systemRegistrar);
+	AllocatorCore::Free(jobSystem);
+
+	if (profiler != nullptr) {
+		profiler->Shutdown();
+	}
+
 	Logger::GetLoggerState()->dispatcher = nullptr;
 	AllocatorCore::Free(eventDispatcher);
 	AllocatorCore::Free(Grindstone::CvarSystem::GetInstance());
 	AllocatorCore::Free(Grindstone::HashedString::GetHashedStringMap());
+	AllocatorCore::CloseFrameAllocator();
 
 	if (!AllocatorCore::IsEmpty()) {
 		GPRINT_ERROR_V(LogSource::EngineCore, "Uncleared memory: {0} bytes left!", static_cast<intmax_t>(AllocatorCore::GetUsed()));
@@ -351,6 +377,10 @@ Profiler::Manager* EngineCore::GetProfiler() const {
 	return profiler;
 }
 
+Jobs::JobSystem* EngineCore::GetJobSystem() const {
+	return jobSystem;
+}
+
 bool EngineCore::OnTryQuit(Grindstone::Events::BaseEvent* ev) {
 	const auto castedEv = dynamic_cast<Grindstone::Events::WindowTryQuitEvent*>(ev);
 	shouldClose = true;
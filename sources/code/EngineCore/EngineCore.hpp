@@ -48,6 +48,10 @@ namespace Grindstone {
 		class Manager;
 	}
 
+	namespace Jobs {
+		class JobSystem;
+	}
+
 	class Window;
 	class DisplayManager;
 	class WindowManager;
@@ -85,6 +89,9 @@ namespace Grindstone {
 		virtual void Run();
 		virtual void RunEditorLoopIteration();
 		virtual void RunLoopIteration();
+		// Waits on the rendering fence, then recycles the memory of the frame that fence guarded. Must run
+		// once for every rendered frame, even ones where systems don't update, like while the editor is paused.
+		virtual void BeginFrame();
 		virtual void UpdateWindows();
 		void RegisterGraphicsCore(GraphicsAPI::Core*);
 		virtual void RegisterInputManager(Input::Interface*);
@@ -98,6 +105,7 @@ namespace Grindstone {
 		virtual ECS::ComponentRegistrar* GetComponentRegistrar() const;
 		virtual GraphicsAPI::Core* GetGraphicsCore() const;
 		virtual Profiler::Manager* GetProfiler() const;
+		virtual Jobs::JobSystem* GetJobSystem() const;
 		virtual BaseRendererFactory* GetRendererFactory() const;
 		virtual RenderPassRegistry* GetRenderPassRegistry() const;
 		virtual WorldContextManager* GetWorldContextManager() const;
@@ -169,6 +177,7 @@ namespace Grindstone {
 		SceneManagement::SceneManager* sceneManager = nullptr;
 		ECS::ComponentRegistrar* componentRegistrar = nullptr;
 		ECS::SystemRegistrar* systemRegistrar = nullptr;
+		Jobs::JobSystem* jobSystem = nullptr;
 		BaseRendererFactory* rendererFactory = nullptr;
 		RenderPassRegistry* renderpassRegistry = nullptr;
 		Events::Dispatcher* eventDispatcher = nullptr;
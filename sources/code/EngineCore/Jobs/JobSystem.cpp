@@ -0,0 +1,288 @@
+#include "JobSystem.hpp"
+
+using namespace Grindstone::Jobs;
+
+static constexpr uint32_t invalidQueueIndex = UINT32_MAX;
+// Enough for a build and an asset pack to run side by side, without taking cores from the frame.
+static constexpr uint32_t backgroundThreadCount = 2;
+static thread_local const JobSystem* currentThreadJobSystem = nullptr;
+static thread_local uint32_t currentThreadQueueIndex = invalidQueueIndex;
+
+JobSystem::JobSystem(uint32_t workerThreadCount) : mainThreadId(std::this_thread::get_id()) {
+	if (workerThreadCount == 0) {
+		const uint32_t hardwareThreadCount = std::thread::hardware_concurrency();
+		// Always keep at least one worker, so jobs still progress while the main thread is blocked.
+		workerThreadCount = hardwareThreadCount > 2 ? hardwareThreadCount - 1 : 1;
+	}
+
+	queues = std::vector<WorkerQueue>(workerThreadCount + 1);
+
+	workerThreads.reserve(workerThreadCount);
+	for (uint32_t i = 0; i < workerThreadCount; ++i) {
+		workerThreads.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+
+	backgroundThreads.reserve(backgroundThreadCount);
+	for (uint32_t i = 0; i < backgroundThreadCount; ++i) {
+		backgroundThreads.emplace_back(&JobSystem::BackgroundLoop, this);
+	}
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::scoped_lock lock(backgroundQueue.mutex);
+		areBackgroundThreadsStopping = true;
+	}
+
+	// Background jobs can still schedule frame work, so they finish before the workers stop.
+	backgroundCondition.notify_all();
+	for (std::thread& backgroundThread : backgroundThreads) {
+		backgroundThread.join();
+	}
+
+	{
+		std::scoped_lock lock(sleepMutex);
+		isShuttingDown = true;
+	}
+
+	sleepCondition.notify_all();
+	for (std::thread& workerThread : workerThreads) {
+		workerThread.join();
+	}
+
+	RunMainThreadJobs();
+}
+
+void JobSystem::Schedule(JobFunction function, JobCounter* counter, JobAffinity affinity) {
+	if (counter != nullptr) {
+		counter->pendingJobCount.fetch_add(1, std::memory_order_acq_rel);
+	}
+
+	Enqueue(Job{ std::move(function), counter, affinity });
+}
+
+void JobSystem::ScheduleAfter(JobCounter& dependency, JobFunction function, JobCounter* counter, JobAffinity affinity) {
+	if (counter != nullptr) {
+		counter->pendingJobCount.fetch_add(1, std::memory_order_acq_rel);
+	}
+
+	Job job{ std::move(function), counter, affinity };
+	{
+		// The last job of a counter decrements it under this lock, so the check can't race with its release.
+		std::scoped_lock lock(dependency.waitingJobsMutex);
+		if (dependency.pendingJobCount.load(std::memory_order_acquire) != 0) {
+			dependency.waitingJobs.emplace_back(std::move(job));
+			return;
+		}
+	}
+
+	Enqueue(std::move(job));
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+	const bool canRunMainThreadJobs = IsMainThread();
+	while (!counter.IsDone()) {
+		if (!TryRunJob(canRunMainThreadJobs)) {
+			std::this_thread::yield();
+		}
+	}
+
+	// Make sure the thread that finished the last job no longer touches the counter before the caller can destroy it.
+	std::scoped_lock lock(counter.waitingJobsMutex);
+}
+
+void JobSystem::RunMainThreadJobs() {
+	std::deque<Job> jobs;
+	{
+		std::scoped_lock lock(mainThreadQueue.mutex);
+		jobs.swap(mainThreadQueue.jobs);
+	}
+
+	for (Job& job : jobs) {
+		Execute(job);
+	}
+}
+
+bool JobSystem::IsMainThread() const {
+	return std::this_thread::get_id() == mainThreadId;
+}
+
+uint32_t JobSystem::GetThreadCount() const {
+	return static_cast<uint32_t>(workerThreads.size()) + 1;
+}
+
+void JobSystem::Enqueue(Job&& job) {
+	if (job.affinity == JobAffinity::MainThread) {
+		std::scoped_lock lock(mainThreadQueue.mutex);
+		mainThreadQueue.jobs.emplace_back(std::move(job));
+		return;
+	}
+
+	if (job.affinity == JobAffinity::Background) {
+		{
+			std::scoped_lock lock(backgroundQueue.mutex);
+			backgroundQueue.jobs.emplace_back(std::move(job));
+		}
+
+		backgroundCondition.notify_one();
+		return;
+	}
+
+	const uint32_t queueIndex = currentThreadJobSystem == this
+		? currentThreadQueueIndex
+		: static_cast<uint32_t>(queues.size() - 1);
+
+	{
+		WorkerQueue& queue = queues[queueIndex];
+		std::scoped_lock lock(queue.mutex);
+		queue.jobs.emplace_back(std::move(job));
+	}
+
+	queuedJobCount.fetch_add(1, std::memory_order_release);
+	{
+		std::scoped_lock lock(sleepMutex);
+	}
+	sleepCondition.notify_one();
+}
+
+void JobSystem::WorkerLoop(uint32_t workerIndex) {
+	currentThreadJobSystem = this;
+	currentThreadQueueIndex = workerIndex;
+
+	while (true) {
+		if (TryRunJob(false)) {
+			continue;
+		}
+
+		std::unique_lock lock(sleepMutex);
+		if (isShuttingDown && queuedJobCount.load(std::memory_order_acquire) == 0) {
+			break;
+		}
+
+		sleepCondition.wait(lock, [this] {
+			return isShuttingDown || queuedJobCount.load(std::memory_order_acquire) > 0;
+		});
+	}
+
+	currentThreadJobSystem = nullptr;
+	currentThreadQueueIndex = invalidQueueIndex;
+}
+
+void JobSystem::BackgroundLoop() {
+	// Not registered as a worker, so frame work scheduled from here goes through the shared queue.
+	while (true) {
+		Job job;
+		{
+			std::unique_lock lock(backgroundQueue.mutex);
+			backgroundCondition.wait(lock, [this] {
+				return areBackgroundThreadsStopping || !backgroundQueue.jobs.empty();
+			});
+
+			if (backgroundQueue.jobs.empty()) {
+				break;
+			}
+
+			job = std::move(backgroundQueue.jobs.front());
+			backgroundQueue.jobs.pop_front();
+		}
+
+		Execute(job);
+	}
+}
+
+bool JobSystem::TryRunJob(bool canRunMainThreadJobs) {
+	Job job;
+	if ((canRunMainThreadJobs && TryPopMainThreadJob(job)) || TryPopJob(job)) {
+		Execute(job);
+		return true;
+	}
+
+	return false;
+}
+
+bool JobSystem::TryPopJob(Job& outJob) {
+	if (queuedJobCount.load(std::memory_order_acquire) == 0) {
+		return false;
+	}
+
+	const uint32_t queueCount = static_cast<uint32_t>(queues.size());
+	const uint32_t sharedQueueIndex = queueCount - 1;
+	const bool isWorker = currentThreadJobSystem == this;
+
+	// Newest work from our own deque first, since it's most likely to still be in cache.
+	if (isWorker) {
+		WorkerQueue& ownQueue = queues[currentThreadQueueIndex];
+		std::scoped_lock lock(ownQueue.mutex);
+		if (!ownQueue.jobs.empty()) {
+			outJob = std::move(ownQueue.jobs.back());
+			ownQueue.jobs.pop_back();
+			queuedJobCount.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	// Then the shared queue, then steal the oldest work from the other workers.
+	const uint32_t firstIndex = isWorker ? currentThreadQueueIndex + 1 : 0;
+	for (uint32_t offset = 0; offset < queueCount; ++offset) {
+		const uint32_t queueIndex = offset == 0
+			? sharedQueueIndex
+			: (firstIndex + offset - 1) % sharedQueueIndex;
+
+		if (isWorker && queueIndex == currentThreadQueueIndex) {
+			continue;
+		}
+
+		WorkerQueue& queue = queues[queueIndex];
+		std::scoped_lock lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			outJob = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			queuedJobCount.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool JobSystem::TryPopMainThreadJob(Job& outJob) {
+	std::scoped_lock lock(mainThreadQueue.mutex);
+	if (mainThreadQueue.jobs.empty()) {
+		return false;
+	}
+
+	outJob = std::move(mainThreadQueue.jobs.front());
+	mainThreadQueue.jobs.pop_front();
+	return true;
+}
+
+void JobSystem::Execute(Job& job) {
+	job.function();
+	FinishJob(job.counter);
+}
+
+void JobSystem::FinishJob(JobCounter* counter) {
+	if (counter == nullptr) {
+		return;
+	}
+
+	uint32_t pendingJobCount = counter->pendingJobCount.load(std::memory_order_acquire);
+	while (pendingJobCount > 1) {
+		if (counter->pendingJobCount.compare_exchange_weak(pendingJobCount, pendingJobCount - 1, std::memory_order_acq_rel)) {
+			return;
+		}
+	}
+
+	// This is the last job, so release everything waiting on the counter.
+	std::vector<Job> releasedJobs;
+	{
+		std::scoped_lock lock(counter->waitingJobsMutex);
+		if (counter->pendingJobCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			releasedJobs.swap(counter->waitingJobs);
+		}
+	}
+
+	for (Job& releasedJob : releasedJobs) {
+		Enqueue(std::move(releasedJob));
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Grindstone::Jobs {
+	using JobFunction = std::function<void()>;
+
+	enum class JobAffinity : uint8_t {
+		// Runs on any worker, or on a thread that is waiting on a counter.
+		Any,
+		// Only runs on the thread that created the JobSystem, from RunMainThreadJobs or while it waits.
+		MainThread,
+		// Runs on a dedicated background thread, for long tasks such as builds. Threads waiting on a
+		// counter never pick these up, so they can't stall a frame.
+		Background
+	};
+
+	class JobCounter;
+
+	struct Job {
+		JobFunction function;
+		JobCounter* counter = nullptr;
+		JobAffinity affinity = JobAffinity::Any;
+	};
+
+	/*
+	 * Tracks a group of scheduled jobs. Every job scheduled against a counter increments it,
+	 * and decrements it once it has finished. Jobs can also be scheduled to start only after
+	 * a counter has reached zero.
+	 */
+	class JobCounter {
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		[[nodiscard]] bool IsDone() const {
+			return pendingJobCount.load(std::memory_order_acquire) == 0;
+		}
+
+		[[nodiscard]] uint32_t GetPendingJobCount() const {
+			return pendingJobCount.load(std::memory_order_acquire);
+		}
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<uint32_t> pendingJobCount = 0;
+		std::mutex waitingJobsMutex;
+		std::vector<Job> waitingJobs;
+	};
+
+	/*
+	 * The engine-wide job system. Each worker owns a deque of jobs: it pushes and pops its own
+	 * work from the back, and steals from the front of other workers' deques when it runs dry.
+	 * Threads that aren't workers push into a shared queue instead. Background jobs have their own
+	 * queue and threads, which only run frame work while they wait on a counter. The public interface is
+	 * virtual so plugins always run the EngineCore implementation through Plugins::Interface.
+	 */
+	class JobSystem {
+	public:
+		// Zero worker threads means one per hardware thread, minus the main thread.
+		JobSystem(uint32_t workerThreadCount = 0);
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		virtual ~JobSystem();
+
+		virtual void Schedule(JobFunction function, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::Any);
+		virtual void ScheduleAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::Any);
+		// Runs other jobs on this thread until the counter reaches zero. Never runs background jobs.
+		virtual void Wait(JobCounter& counter);
+		// Runs every queued main-thread job. Must be called from the main thread.
+		virtual void RunMainThreadJobs();
+		[[nodiscard]] virtual bool IsMainThread() const;
+		// The number of threads executing jobs, including the main thread.
+		[[nodiscard]] virtual uint32_t GetThreadCount() const;
+
+		// Calls function(index) for each index in [begin, end), in batches of batchSize, and waits for all of them.
+		template<typename FunctionType>
+		void ParallelFor(size_t begin, size_t end, size_t batchSize, const FunctionType& function) {
+			if (begin >= end) {
+				return;
+			}
+
+			batchSize = std::max<size_t>(batchSize, 1);
+			JobCounter counter;
+			for (size_t batchBegin = begin; batchBegin < end; batchBegin += batchSize) {
+				const size_t batchEnd = std::min(end, batchBegin + batchSize);
+				Schedule(
+					[&function, batchBegin, batchEnd] {
+						for (size_t i = batchBegin; i < batchEnd; ++i) {
+							function(i);
+						}
+					},
+					&counter
+				);
+			}
+
+			Wait(counter);
+		}
+
+	private:
+		struct WorkerQueue {
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		void Enqueue(Job&& job);
+		void WorkerLoop(uint32_t workerIndex);
+		void BackgroundLoop();
+		bool TryRunJob(bool canRunMainThreadJobs);
+		bool TryPopJob(Job& outJob);
+		bool TryPopMainThreadJob(Job& outJob);
+		void Execute(Job& job);
+		void FinishJob(JobCounter* counter);
+
+		std::thread::id mainThreadId;
+		std::vector<std::thread> workerThreads;
+		// One per worker thread, plus a final shared queue used by threads that aren't workers.
+		std::vector<WorkerQueue> queues;
+		WorkerQueue mainThreadQueue;
+		std::vector<std::thread> backgroundThreads;
+		WorkerQueue backgroundQueue;
+		std::condition_variable backgroundCondition;
+		// Guarded by backgroundQueue.mutex.
+		bool areBackgroundThreadsStopping = false;
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+		std::atomic<uint32_t> queuedJobCount = 0;
+		std::atomic<bool> isShuttingDown = false;
+	};
+}
@@ -46,9 +46,9 @@ std::filesystem::path Grindstone::Plugins::DefaultPluginManager::GetLibraryPath(
 }
 
 bool DefaultPluginManager::LoadModule(const std::string& path) {
-#ifdef _DEBUG
+#ifdef GRINDSTONE_PROFILING_ENABLED
 	std::string profileStr = std::string("Loading module ") + path;
-	GRIND_PROFILE_SCOPE(profileStr.c_str());
+	GRIND_PROFILE_DYNAMIC_SCOPE(profileStr.c_str());
 #endif
 
 	// Return true if plugin already loaded
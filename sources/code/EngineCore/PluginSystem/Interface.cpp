@@ -44,6 +44,10 @@ Grindstone::CvarSystem* Grindstone::Plugins::Interface::GetCvarSystem() const {
 	return Grindstone::CvarSystem::GetInstance();
 }
 
+Grindstone::Jobs::JobSystem* Grindstone::Plugins::Interface::GetJobSystem() const {
+	return EngineCore::GetInstance().GetJobSystem();
+}
+
 void Plugins::Interface::RegisterWorldContextFactory(Grindstone::HashedString contextName, Grindstone::UniquePtr<Grindstone::WorldContext>(*factoryFn)()) {
 	Grindstone::EngineCore::GetInstance().GetWorldContextManager()->Register(contextName, factoryFn);
 }
@@ -103,10 +107,18 @@ void Plugins::Interface::RegisterSystem(const char* name, ECS::SystemFactory fac
 	systemRegistrar->RegisterSystem(name, factory);
 }
 
+void Plugins::Interface::RegisterSystem(const char* name, ECS::SystemFactory factory, const ECS::SystemComponentAccess& access) {
+	systemRegistrar->RegisterSystem(name, factory, access);
+}
+
 void Plugins::Interface::RegisterEditorSystem(const char* name, ECS::SystemFactory factory) {
 	systemRegistrar->RegisterEditorSystem(name, factory);
 }
 
+void Plugins::Interface::RegisterEditorSystem(const char* name, ECS::SystemFactory factory, const ECS::SystemComponentAccess& access) {
+	systemRegistrar->RegisterEditorSystem(name, factory, access);
+}
+
 void Plugins::Interface::UnregisterSystem(const char* name) {
 	systemRegistrar->UnregisterSystem(name);
 }
@@ -14,6 +14,7 @@
 #include <EngineCore/Assets/AssetImporter.hpp>
 #include <EngineCore/ECS/ComponentFunctions.hpp>
 #include <EngineCore/ECS/ComponentRegistrar.hpp>
+#include <EngineCore/ECS/SystemComponentAccess.hpp>
 #include <EngineCore/ECS/SystemFactory.hpp>
 #include <EngineCore/ECS/SystemRegistrar.hpp>
 #include <EngineCore/Logger.hpp>
@@ -32,6 +33,10 @@ namespace Grindstone {
 		class SystemRegistrar;
 	}
 
+	namespace Jobs {
+		class JobSystem;
+	}
+
 	class CvarSystem;
 	class WindowManager;
 	class DisplayManager;
@@ -60,7 +65,9 @@ namespace Grindstone {
 			virtual uint8_t CountDisplays();
 			virtual void EnumerateDisplays(Display* displays);
 			virtual void RegisterSystem(const char* name, ECS::SystemFactory factory);
+			virtual void RegisterSystem(const char* name, ECS::SystemFactory factory, const ECS::SystemComponentAccess& access);
 			virtual void RegisterEditorSystem(const char* name, ECS::SystemFactory factory);
+			virtual void RegisterEditorSystem(const char* name, ECS::SystemFactory factory, const ECS::SystemComponentAccess& access);
 			virtual void UnregisterSystem(const char* name);
 			virtual void UnregisterEditorSystem(const char* name);
 			virtual void RegisterAssetRenderer(BaseAssetRenderer* assetRenderer);
@@ -71,6 +78,7 @@ namespace Grindstone {
 			virtual Grindstone::Logger::LoggerState* GetLoggerState() const;
 			virtual Grindstone::Memory::AllocatorCore::AllocatorState* GetAllocatorState() const;
 			virtual Grindstone::CvarSystem* GetCvarSystem() const;
+			virtual Grindstone::Jobs::JobSystem* GetJobSystem() const;
 			virtual void RegisterWorldContextFactory(Grindstone::HashedString contextName, Grindstone::UniquePtr<Grindstone::WorldContext> (*FactoryFn)());
 			virtual void UnregisterWorldContextFactory(Grindstone::HashedString contextName);
 
@@ -1,77 +1,231 @@
-#include <algorithm>
-#include <fstream>
-#include <thread>
+#include <chrono>
+#include <functional>
+
+#ifdef GRIND_PROFILE_USE_QPC
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#endif
 
 #include "Profiling.hpp"
 
 using namespace Grindstone::Profiler;
 
-static void WriteProfile(std::ofstream& outputStream, const Result& result) {
-	std::string name = result.name;
-	std::replace(name.begin(), name.end(), '"', '\'');
+std::atomic<bool> Manager::isRecording = false;
+thread_local Manager::ThreadBuffer* Manager::currentThreadBuffer = nullptr;
+thread_local uint16_t Manager::currentThreadDepth = 0;
+
+static_assert(
+	(Manager::threadBufferCapacity & (Manager::threadBufferCapacity - 1)) == 0,
+	"threadBufferCapacity must be a power of two."
+);
+
+static void WriteChunk(std::ofstream& outputStream, TraceChunkType type, const void* data, size_t size) {
+	TraceChunkHeader chunkHeader{ type, static_cast<uint32_t>(size) };
+	outputStream.write(reinterpret_cast<const char*>(&chunkHeader), sizeof(chunkHeader));
+	outputStream.write(static_cast<const char*>(data), size);
+}
+
+#if defined(GRIND_PROFILE_USE_RDTSC)
+// The timestamp counter's rate isn't exposed portably, so it's measured against the steady clock.
+// Modern x86 processors have an invariant counter, which ticks at a constant rate on every core.
+static uint64_t MeasureTicksPerSecond() {
+	const std::chrono::milliseconds calibrationTime(20);
 
-	long long duration = static_cast<long long>(result.end - result.start);
+	const auto clockStart = std::chrono::steady_clock::now();
+	const uint64_t ticksStart = GetTicks();
+	std::chrono::steady_clock::time_point clockEnd;
+	do {
+		clockEnd = std::chrono::steady_clock::now();
+	} while (clockEnd - clockStart < calibrationTime);
+	const uint64_t ticksEnd = GetTicks();
 
-	outputStream << "{\"cat\":\"function\",\"dur\":" << duration
-		<< ",\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << result.threadId
-		<< ",\"ts\":" << result.start << "}";
+	const double elapsedSeconds = std::chrono::duration<double>(clockEnd - clockStart).count();
+	return static_cast<uint64_t>(static_cast<double>(ticksEnd - ticksStart) / elapsedSeconds);
 }
 
-Manager::Manager() : currentSession(&sessionA), otherSession(&sessionB), depth(0) {
-	sessionA.results.reserve(1000);
-	sessionB.results.reserve(1000);
+uint64_t Grindstone::Profiler::GetTicksPerSecond() {
+	static const uint64_t ticksPerSecond = MeasureTicksPerSecond();
+	return ticksPerSecond;
+}
+#elif defined(GRIND_PROFILE_USE_QPC)
+uint64_t Grindstone::Profiler::QueryPerformanceCounterTicks() {
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return static_cast<uint64_t>(counter.QuadPart);
 }
 
-void Manager::BeginSession(const std::string& name, const std::filesystem::path filepath) {
-	if (currentSession == &sessionB) {
-		currentSession = &sessionA;
-		otherSession = &sessionB;
+uint64_t Grindstone::Profiler::GetTicksPerSecond() {
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return static_cast<uint64_t>(frequency.QuadPart);
+}
+#else
+uint64_t Grindstone::Profiler::GetTicksPerSecond() {
+	return static_cast<uint64_t>(std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num);
+}
+#endif
+
+Manager::Manager() {
+	drainedEvents.reserve(threadBufferCapacity);
+}
+
+Manager::~Manager() {
+	Shutdown();
+}
+
+void Manager::Initialize() {
+	if (writerThread.joinable()) {
+		return;
+	}
+
+	shouldStopWriter = false;
+	isRecording.store(true, std::memory_order_relaxed);
+	writerThread = std::thread(&Manager::RunWriter, this);
+}
+
+void Manager::Shutdown() {
+	if (!writerThread.joinable()) {
+		return;
 	}
-	else {
-		currentSession = &sessionB;
-		otherSession = &sessionA;
+
+	{
+		std::scoped_lock lock(writerMutex);
+		shouldStopWriter = true;
 	}
 
-	currentSession->name = name;
-	currentSession->path = filepath;
-	currentSession->results.clear();
+	writerCondition.notify_one();
+	writerThread.join();
+
+	isRecording.store(false, std::memory_order_relaxed);
+	Flush();
+
+	std::scoped_lock lock(flushMutex);
+	traceFile.close();
+}
+
+void Manager::BeginSession(const char* name, const std::filesystem::path& filepath) {
+	if (filepath != sessionPath) {
+		// Events recorded so far belong to the previous trace.
+		Flush();
 
-	frameStart = std::chrono::system_clock::now();
-	isInSession = true;
+		std::scoped_lock lock(flushMutex);
+		OpenTraceFile(filepath);
+		sessionPath = filepath;
+	}
+
+	sessionNameId = InternName(name);
+	sessionThreadIndex.store(GetThreadBuffer().threadIndex, std::memory_order_relaxed);
+	sessionStartTicks = GetTicks();
 }
 
 void Manager::EndSession() {
-	if (currentSession == nullptr) {
+	if (!isRecording.load(std::memory_order_relaxed)) {
 		return;
 	}
 
-	std::ofstream outputStream;
-	std::filesystem::create_directories(currentSession->path.parent_path());
-	outputStream.open(currentSession->path);
+	PushEvent(TraceEvent{ sessionStartTicks, GetTicks(), sessionNameId, 0, TraceEventType::Session, 0 });
+}
 
-	size_t resultCount = currentSession->results.size();
+void Manager::Flush() {
+	std::scoped_lock lock(flushMutex);
 
-	outputStream << "{\"otherData\":{},\"traceEvents\":[";
+	std::vector<ThreadBuffer*> currentBuffers;
+	{
+		std::scoped_lock buffersLock(buffersMutex);
+		currentBuffers.reserve(buffers.size());
+		for (const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+			currentBuffers.push_back(buffer.get());
+		}
+	}
 
-	if (resultCount > 0) {
-		WriteProfile(outputStream, currentSession->results[0]);
+	if (traceFile.is_open() && static_cast<uint64_t>(traceFile.tellp()) >= maxTraceFileSize.load(std::memory_order_relaxed)) {
+		RotateTraceFile();
 	}
 
-	for (size_t i = 1; i < resultCount; ++i) {
-		outputStream << ",";
-		WriteProfile(outputStream, currentSession->results[i]);
+	if (traceFile.is_open()) {
+		for (; writtenThreadCount < currentBuffers.size(); ++writtenThreadCount) {
+			const ThreadBuffer& buffer = *currentBuffers[writtenThreadCount];
+			TraceThreadInfo threadInfo{ buffer.threadIndex, 0, buffer.osThreadId };
+			WriteChunk(traceFile, TraceChunkType::Thread, &threadInfo, sizeof(threadInfo));
+		}
 	}
 
-	outputStream << "]}";
-	outputStream.close();
+	const uint32_t currentSessionThreadIndex = sessionThreadIndex.load(std::memory_order_relaxed);
+	for (ThreadBuffer* buffer : currentBuffers) {
+		uint32_t droppedEventCount = 0;
+		DrainBuffer(*buffer, drainedEvents, droppedEventCount);
+		if (drainedEvents.empty() && droppedEventCount == 0) {
+			continue;
+		}
+
+		if (traceFile.is_open()) {
+			// Names are interned before any event using them is recorded, so once the events have
+			// been drained, every name they use is in the table.
+			std::scoped_lock namesLock(namesMutex);
+			for (; writtenNameCount < names.size(); ++writtenNameCount) {
+				const std::string& name = names[writtenNameCount];
+				const uint32_t nameId = static_cast<uint32_t>(writtenNameCount);
+				TraceChunkHeader chunkHeader{ TraceChunkType::Name, static_cast<uint32_t>(sizeof(nameId) + name.size()) };
+				traceFile.write(reinterpret_cast<const char*>(&chunkHeader), sizeof(chunkHeader));
+				traceFile.write(reinterpret_cast<const char*>(&nameId), sizeof(nameId));
+				traceFile.write(name.data(), name.size());
+			}
+		}
 
-	isInSession = false;
+		if (traceFile.is_open()) {
+			const size_t eventsSize = drainedEvents.size() * sizeof(TraceEvent);
+			TraceEventsHeader eventsHeader{ buffer->threadIndex, droppedEventCount };
+			TraceChunkHeader chunkHeader{ TraceChunkType::Events, static_cast<uint32_t>(sizeof(eventsHeader) + eventsSize) };
+			traceFile.write(reinterpret_cast<const char*>(&chunkHeader), sizeof(chunkHeader));
+			traceFile.write(reinterpret_cast<const char*>(&eventsHeader), sizeof(eventsHeader));
+			traceFile.write(reinterpret_cast<const char*>(drainedEvents.data()), eventsSize);
+		}
+
+		if (buffer->threadIndex != currentSessionThreadIndex) {
+			buffer->sessionScopes.clear();
+			continue;
+		}
+
+		// A thread's events are ordered by when they ended, so a session's scopes all come before it.
+		for (const TraceEvent& event : drainedEvents) {
+			if (event.type == TraceEventType::Session) {
+				PublishSession(*buffer, event);
+				buffer->sessionScopes.clear();
+			}
+			else {
+				buffer->sessionScopes.push_back(event);
+			}
+		}
+	}
+
+	if (traceFile.is_open()) {
+		traceFile.flush();
+	}
 }
 
-void Manager::AddProfile(const Result& result) {
-	if (isInSession) {
-		currentSession->results.push_back(result);
+void Manager::SetMaxTraceFileSize(uint64_t maxSize) {
+	maxTraceFileSize.store(maxSize, std::memory_order_relaxed);
+}
+
+uint32_t Manager::InternName(const char* name) {
+	std::scoped_lock lock(namesMutex);
+
+	auto nameIterator = nameIds.find(std::string_view(name));
+	if (nameIterator != nameIds.end()) {
+		return nameIterator->second;
 	}
+
+	const uint32_t nameId = static_cast<uint32_t>(names.size());
+	const std::string& storedName = names.emplace_back(name);
+	nameIds.emplace(std::string_view(storedName), nameId);
+	return nameId;
+}
+
+const char* Manager::GetName(uint32_t nameId) const {
+	std::scoped_lock lock(namesMutex);
+	return nameId < names.size()
+		? names[nameId].c_str()
+		: "";
 }
 
 Manager& Manager::Get() {
@@ -79,32 +233,140 @@ Manager& Manager::Get() {
 	return instance;
 }
 
-const InstrumentationSession& Grindstone::Profiler::Manager::GetAvailableSession() const {
-	return *otherSession;
+InstrumentationSession Manager::GetAvailableSession() const {
+	std::scoped_lock lock(availableSessionMutex);
+	return availableSession;
 }
 
-Timer::Timer(const char *name) : name(name), stopped(false) {
-	startTime = std::chrono::system_clock::now();
-	Manager& manager = Manager::Get();
-	++manager.depth;
+Manager::ThreadBuffer& Manager::GetThreadBuffer() {
+	if (currentThreadBuffer == nullptr) {
+		currentThreadBuffer = Get().RegisterThread();
+	}
+
+	return *currentThreadBuffer;
 }
 
-Timer::~Timer() {
-	if (!stopped) {
-		Stop();
+// Only the owning thread pushes to a buffer, and only the writer drains it, so the indices
+// are enough to keep them apart. If the buffer is full, the event is dropped and counted.
+void Manager::PushEvent(const TraceEvent& event) {
+	ThreadBuffer& buffer = GetThreadBuffer();
+	const uint64_t writeIndex = buffer.writeIndex.load(std::memory_order_relaxed);
+	if (writeIndex - buffer.cachedReadIndex >= threadBufferCapacity) {
+		buffer.cachedReadIndex = buffer.readIndex.load(std::memory_order_acquire);
+		if (writeIndex - buffer.cachedReadIndex >= threadBufferCapacity) {
+			buffer.droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
 	}
+
+	buffer.events[writeIndex & (threadBufferCapacity - 1)] = event;
+	buffer.writeIndex.store(writeIndex + 1, std::memory_order_release);
 }
 
-void Timer::Stop() {
-	uint32_t threadID = (uint32_t)std::hash<std::thread::id>{}(std::this_thread::get_id());
-	Manager& manager = Manager::Get();
-	std::chrono::system_clock::time_point frameStart = manager.frameStart;
+Manager::ThreadBuffer* Manager::RegisterThread() {
+	std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+	buffer->osThreadId = static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+	std::scoped_lock lock(buffersMutex);
+	buffer->threadIndex = static_cast<uint32_t>(buffers.size());
+	buffers.push_back(std::move(buffer));
+	return buffers.back().get();
+}
+
+void Manager::RunWriter() {
+	const std::chrono::milliseconds writeInterval(10);
+
+	std::unique_lock lock(writerMutex);
+	while (!shouldStopWriter) {
+		writerCondition.wait_for(lock, writeInterval);
+		lock.unlock();
+		Flush();
+		lock.lock();
+	}
+}
+
+void Manager::OpenTraceFile(const std::filesystem::path& path) {
+	if (traceFile.is_open()) {
+		traceFile.close();
+	}
+
+	if (path.has_parent_path()) {
+		std::filesystem::create_directories(path.parent_path());
+	}
+
+	traceFile.open(path, std::ios::binary | std::ios::trunc);
+	traceFilePath = path;
+	writtenNameCount = 0;
+	writtenThreadCount = 0;
+
+	TraceFileHeader fileHeader;
+	fileHeader.ticksPerSecond = GetTicksPerSecond();
+	traceFile.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+}
 
-	std::chrono::duration<float> start = startTime - frameStart;
-	std::chrono::duration<float> end = std::chrono::system_clock::now() - frameStart;
+// Keeps one older trace, so a long-running process never uses more than twice the maximum size on disk.
+void Manager::RotateTraceFile() {
+	traceFile.close();
 
-	manager.AddProfile({ name, start.count(), end.count(), manager.depth, threadID});
-	--manager.depth;
+	std::filesystem::path rotatedPath = traceFilePath;
+	rotatedPath += ".1";
 
+	std::error_code errorCode;
+	std::filesystem::remove(rotatedPath, errorCode);
+	std::filesystem::rename(traceFilePath, rotatedPath, errorCode);
+
+	// Names and threads are written again, so the new trace can be read on its own.
+	OpenTraceFile(traceFilePath);
+}
+
+void Manager::DrainBuffer(ThreadBuffer& buffer, std::vector<TraceEvent>& outEvents, uint32_t& outDroppedEventCount) {
+	const uint64_t readIndex = buffer.readIndex.load(std::memory_order_relaxed);
+	const uint64_t writeIndex = buffer.writeIndex.load(std::memory_order_acquire);
+
+	outEvents.clear();
+	for (uint64_t i = readIndex; i < writeIndex; ++i) {
+		outEvents.push_back(buffer.events[i & (threadBufferCapacity - 1)]);
+	}
+
+	buffer.readIndex.store(writeIndex, std::memory_order_release);
+	outDroppedEventCount = buffer.droppedEventCount.exchange(0, std::memory_order_relaxed);
+}
+
+void Manager::PublishSession(ThreadBuffer& buffer, const TraceEvent& sessionEvent) {
+	const double secondsPerTick = 1.0 / static_cast<double>(GetTicksPerSecond());
+
+	InstrumentationSession session;
+	session.path = traceFilePath;
+	session.results.reserve(buffer.sessionScopes.size());
+
+	{
+		std::scoped_lock lock(namesMutex);
+		session.name = names[sessionEvent.nameId];
+		for (const TraceEvent& scope : buffer.sessionScopes) {
+			if (scope.startTicks < sessionEvent.startTicks || scope.endTicks > sessionEvent.endTicks) {
+				continue;
+			}
+
+			session.results.push_back(Result{
+				names[scope.nameId].c_str(),
+				static_cast<float>(static_cast<double>(scope.startTicks - sessionEvent.startTicks) * secondsPerTick),
+				static_cast<float>(static_cast<double>(scope.endTicks - sessionEvent.startTicks) * secondsPerTick),
+				scope.depth,
+				buffer.threadIndex
+			});
+		}
+	}
+
+	std::scoped_lock lock(availableSessionMutex);
+	availableSession = std::move(session);
+}
+
+void Timer::Stop() {
+	const uint64_t endTicks = GetTicks();
+	--Manager::currentThreadDepth;
 	stopped = true;
+
+	if (Manager::isRecording.load(std::memory_order_relaxed)) {
+		Manager::PushEvent(TraceEvent{ startTicks, endTicks, nameId, depth, TraceEventType::Scope, 0 });
+	}
 }
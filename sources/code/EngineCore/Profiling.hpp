@@ -1,67 +1,215 @@
 #ifndef _PROFILING_HPP
 #define _PROFILING_HPP
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <chrono>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
-#include <filesystem>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <intrin.h>
+	#define GRIND_PROFILE_USE_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+	#define GRIND_PROFILE_USE_RDTSC
+#elif defined(_WIN32)
+	#define GRIND_PROFILE_USE_QPC
+#else
+	#include <chrono>
+#endif
+
+#include "ProfilingTraceFormat.hpp"
 
 namespace Grindstone {
 	namespace Profiler {
+		// A scope of a finished session, with times in seconds since the session began.
 		struct Result {
-			std::string name;
+			const char* name;
 			float start, end;
 			uint32_t depth;
 			uint32_t threadId;
 		};
 
+		// The scopes recorded by the thread that began the session. The trace file has every thread.
 		struct InstrumentationSession {
 			std::string name;
 			std::filesystem::path path;
 			std::vector<Result> results;
 		};
 
+		/**
+		 * \brief Records profiled scopes from any thread, and writes them to a binary trace.
+		 *
+		 * Each thread pushes fixed-size events into its own lock-free ring buffer, and a background
+		 * thread drains the buffers into the session's trace file. Names are interned once, so events
+		 * only carry an id. Use the TraceConverter tool to turn a trace into Chrome tracing JSON.
+		 */
 		class Manager {
-		private:
-			InstrumentationSession* currentSession = nullptr;
-			InstrumentationSession* otherSession = nullptr;
-			InstrumentationSession sessionA;
-			InstrumentationSession sessionB;
 		public:
+			static constexpr size_t threadBufferCapacity = 8192;
+			static constexpr uint64_t defaultMaxTraceFileSize = 256ull * 1024 * 1024;
+
 			Manager();
-			void BeginSession(const std::string& name, const std::filesystem::path filepath = "results.json");
+			~Manager();
+
+			// Starts the thread that writes events to the trace file.
+			void Initialize();
+			// Writes out every remaining event, and stops the writing thread.
+			void Shutdown();
+
+			// Sessions can be started repeatedly with the same path, and are appended to the same trace.
+			void BeginSession(const char* name, const std::filesystem::path& filepath = "results.gtrace");
 			void EndSession();
-			void AddProfile(const Result& result);
+			// Drains every thread's buffer into the trace file.
+			void Flush();
+			// Once the trace file grows past this, it's moved to "<path>.1", replacing any older one, and a new trace is started.
+			void SetMaxTraceFileSize(uint64_t maxSize);
+
+			// Returns an id that stays valid for the lifetime of the process. Interning takes a lock,
+			// so use GRIND_PROFILE_SCOPE for fixed names, which only interns once per call site.
+			uint32_t InternName(const char* name);
+			const char* GetName(uint32_t nameId) const;
+
 			static Manager& Get();
-			virtual const InstrumentationSession& GetAvailableSession() const;
+			virtual InstrumentationSession GetAvailableSession() const;
 
-			std::chrono::system_clock::time_point frameStart;
-			bool isInSession = false;
-			uint32_t depth;
+		private:
+			friend class Timer;
+
+			struct ThreadBuffer {
+				TraceEvent events[threadBufferCapacity];
+				alignas(64) std::atomic<uint64_t> writeIndex = 0;
+				// Only used by the owning thread, to avoid reading readIndex on every push.
+				uint64_t cachedReadIndex = 0;
+				alignas(64) std::atomic<uint64_t> readIndex = 0;
+				std::atomic<uint32_t> droppedEventCount = 0;
+				uint32_t threadIndex = 0;
+				uint64_t osThreadId = 0;
+				// Only used by the writing thread.
+				std::vector<TraceEvent> sessionScopes;
+			};
+
+			static ThreadBuffer& GetThreadBuffer();
+			static void PushEvent(const TraceEvent& event);
+
+			ThreadBuffer* RegisterThread();
+			void RunWriter();
+			void OpenTraceFile(const std::filesystem::path& path);
+			void RotateTraceFile();
+			void DrainBuffer(ThreadBuffer& buffer, std::vector<TraceEvent>& drainedEvents, uint32_t& droppedEventCount);
+			void PublishSession(ThreadBuffer& buffer, const TraceEvent& sessionEvent);
+
+			static std::atomic<bool> isRecording;
+			static thread_local ThreadBuffer* currentThreadBuffer;
+			static thread_local uint16_t currentThreadDepth;
+
+			mutable std::mutex namesMutex;
+			std::deque<std::string> names;
+			std::unordered_map<std::string_view, uint32_t> nameIds;
+
+			mutable std::mutex buffersMutex;
+			std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+			// Held while draining buffers and writing to the trace file.
+			std::mutex flushMutex;
+			std::ofstream traceFile;
+			std::filesystem::path traceFilePath;
+			std::atomic<uint64_t> maxTraceFileSize = defaultMaxTraceFileSize;
+			size_t writtenNameCount = 0;
+			size_t writtenThreadCount = 0;
+			std::vector<TraceEvent> drainedEvents;
+
+			std::mutex writerMutex;
+			std::condition_variable writerCondition;
+			std::thread writerThread;
+			bool shouldStopWriter = false;
+
+			// Only used by the thread that begins and ends sessions.
+			std::filesystem::path sessionPath;
+			uint64_t sessionStartTicks = 0;
+			uint32_t sessionNameId = 0;
+			std::atomic<uint32_t> sessionThreadIndex = UINT32_MAX;
+
+			mutable std::mutex availableSessionMutex;
+			InstrumentationSession availableSession;
 		};
 
+#ifdef GRIND_PROFILE_USE_QPC
+		uint64_t QueryPerformanceCounterTicks();
+#endif
+
+		/**
+		 * \brief Reads a raw, monotonic cycle counter. This is on the path of every profiled scope,
+		 * so it's inlined, and ticks are only converted to time when a trace is read.
+		 */
+		inline uint64_t GetTicks() {
+#if defined(GRIND_PROFILE_USE_RDTSC)
+			return __rdtsc();
+#elif defined(GRIND_PROFILE_USE_QPC)
+			return QueryPerformanceCounterTicks();
+#else
+			return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+		}
+
+		// The rate GetTicks counts at. With the timestamp counter, this is measured once, on the first call.
+		uint64_t GetTicksPerSecond();
+
 		class Timer {
 		public:
-			Timer(const char* name);
-			~Timer();
+			Timer(uint32_t nameId) : startTicks(GetTicks()), nameId(nameId), depth(Manager::currentThreadDepth++), stopped(false) {}
+			~Timer() {
+				if (!stopped) {
+					Stop();
+				}
+			}
+
 			void Stop();
 		private:
-			const char* name;
-			std::chrono::system_clock::time_point startTime;
+			uint64_t startTicks;
+			uint32_t nameId;
+			uint16_t depth;
 			bool stopped;
 		};
 	}
 }
 
-#ifdef _DEBUG
+#define GRIND_PROFILE_CONCAT_INNER(a, b) a##b
+#define GRIND_PROFILE_CONCAT(a, b) GRIND_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef _MSC_VER
+	#define GRIND_PROFILE_FUNCTION_NAME __FUNCSIG__
+#else
+	#define GRIND_PROFILE_FUNCTION_NAME __PRETTY_FUNCTION__
+#endif
+
+// Profiling is controlled by the GRINDSTONE_ENABLE_PROFILING CMake option, independently of the build type.
+#ifdef GRINDSTONE_PROFILING_ENABLED
 	#define GRIND_PROFILE_BEGIN_SESSION(name, filepath) Grindstone::Profiler::Manager::Get().BeginSession(name, filepath)
 	#define GRIND_PROFILE_END_SESSION() Grindstone::Profiler::Manager::Get().EndSession()
-	#define GRIND_PROFILE_SCOPE(name) Grindstone::Profiler::Timer grindstone_profiler_timer_##__LINE__(name)
-	#define GRIND_PROFILE_FUNC() GRIND_PROFILE_SCOPE(__FUNCSIG__)
+	// The name must be the same every time this scope is reached, as it's only interned once.
+	#define GRIND_PROFILE_SCOPE(name) \
+		static const uint32_t GRIND_PROFILE_CONCAT(grindstone_profiler_name_, __LINE__) = Grindstone::Profiler::Manager::Get().InternName(name); \
+		Grindstone::Profiler::Timer GRIND_PROFILE_CONCAT(grindstone_profiler_timer_, __LINE__)(GRIND_PROFILE_CONCAT(grindstone_profiler_name_, __LINE__))
+	// For names interned ahead of time with Manager::InternName.
+	#define GRIND_PROFILE_SCOPE_ID(nameId) Grindstone::Profiler::Timer GRIND_PROFILE_CONCAT(grindstone_profiler_timer_, __LINE__)(nameId)
+	// Interns the name every time, so it should be kept out of hot code.
+	#define GRIND_PROFILE_DYNAMIC_SCOPE(name) GRIND_PROFILE_SCOPE_ID(Grindstone::Profiler::Manager::Get().InternName(name))
+	#define GRIND_PROFILE_FUNC() GRIND_PROFILE_SCOPE(GRIND_PROFILE_FUNCTION_NAME)
 #else
 	#define GRIND_PROFILE_BEGIN_SESSION(name, filepath)
 	#define GRIND_PROFILE_END_SESSION()
 	#define GRIND_PROFILE_SCOPE(name)
+	#define GRIND_PROFILE_SCOPE_ID(nameId)
+	#define GRIND_PROFILE_DYNAMIC_SCOPE(name)
 	#define GRIND_PROFILE_FUNC()
 #endif
 
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+
+// The binary trace written by the profiler. A trace file is a TraceFileHeader followed by
+// chunks, each a TraceChunkHeader followed by size bytes. Every file is self-contained: the
+// names and threads used by its events are written to it before the events that use them.
+namespace Grindstone::Profiler {
+	constexpr uint32_t traceFileMagic = 0x43525447; // "GTRC"
+	constexpr uint32_t traceFileVersion = 1;
+
+	struct TraceFileHeader {
+		uint32_t magic = traceFileMagic;
+		uint32_t version = traceFileVersion;
+		// Event timestamps are ticks of a monotonic clock, with this many ticks per second.
+		uint64_t ticksPerSecond = 0;
+	};
+
+	enum class TraceChunkType : uint32_t {
+		// A uint32_t name id, followed by the name's characters, without a null terminator.
+		Name,
+		// A TraceThreadInfo.
+		Thread,
+		// A TraceEventsHeader, followed by TraceEvents ordered by when they ended.
+		Events
+	};
+
+	struct TraceChunkHeader {
+		TraceChunkType type;
+		uint32_t size;
+	};
+
+	struct TraceThreadInfo {
+		uint32_t threadIndex;
+		uint32_t padding;
+		uint64_t osThreadId;
+	};
+
+	struct TraceEventsHeader {
+		uint32_t threadIndex;
+		// Events dropped by this thread because its buffer was full, since its last chunk.
+		uint32_t droppedEventCount;
+	};
+
+	enum class TraceEventType : uint8_t {
+		Scope,
+		// Spans from GRIND_PROFILE_BEGIN_SESSION to GRIND_PROFILE_END_SESSION.
+		Session
+	};
+
+	struct TraceEvent {
+		uint64_t startTicks;
+		uint64_t endTicks;
+		uint32_t nameId;
+		// How many scopes were open on the thread when this one began.
+		uint16_t depth;
+		TraceEventType type;
+		uint8_t padding;
+	};
+
+	static_assert(sizeof(TraceEvent) == 24, "TraceEvent is written to trace files as is, so its size must not change.");
+}
@@ -0,0 +1,506 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+#include <rapidjson/document.h>
+
+#include "EngineCore/Profiling.hpp"
+#include "EngineCore/EngineCore.hpp"
+#include <EngineCore/Logger.hpp>
+#include "EngineCore/Assets/AssetManager.hpp"
+#include "EngineCore/CoreComponents/Camera/CameraComponent.hpp"
+#include "EngineCore/CoreComponents/Streaming/StreamingCellComponent.hpp"
+#include "EngineCore/CoreComponents/Streaming/StreamingSourceComponent.hpp"
+#include "EngineCore/CoreComponents/Transform/TransformComponent.hpp"
+#include "EngineCore/ECS/ComponentRegistrar.hpp"
+#include "EngineCore/Jobs/JobSystem.hpp"
+#include "EngineCore/Utils/MemoryAllocator.hpp"
+#include "EngineCore/WorldContext/WorldContextManager.hpp"
+
+#include "CellStreamer.hpp"
+#include "ComponentBlockLoader.hpp"
+#include "SceneCooker.hpp"
+#include "SceneLoaderBinary.hpp"
+#include "Scene.hpp"
+
+using namespace Grindstone;
+using namespace Grindstone::SceneManagement;
+using namespace Grindstone::Memory;
+
+// Small enough that a single step never takes a large part of the insertion budget.
+static const uint32_t ENTITIES_PER_STEP = 256;
+
+struct CellStreamer::PreparedCell {
+	Jobs::JobCounter counter;
+	// Everything below is written by the preparing job, and only read once the counter is done.
+	bool wasPrepared = false;
+	Assets::AssetLoadBinaryResult file;
+	// A copy of a cooked scene, only made if it wasn't loaded at an aligned address.
+	std::vector<Byte> alignedFileData;
+	// Json scenes are parsed in place, so the names in their blocks point into this.
+	std::string sceneJson;
+	SceneCooker::CookedEntities cookedEntities;
+	std::string sceneName;
+	const uint32_t* entities = nullptr;
+	size_t entityCount = 0;
+	// Split so no block has more than ENTITIES_PER_STEP entities.
+	std::vector<ComponentBlockView> blocks;
+	std::vector<AssetDependency> assetDependencies;
+};
+
+CellStreamer::CellStreamer() = default;
+
+CellStreamer::~CellStreamer() {
+	UnloadAllCells();
+}
+
+void CellStreamer::SetInsertionBudget(std::chrono::microseconds budget) {
+	insertionBudget = budget;
+}
+
+std::chrono::microseconds CellStreamer::GetInsertionBudget() const {
+	return insertionBudget;
+}
+
+std::chrono::microseconds CellStreamer::GetLastInsertionTime() const {
+	return lastInsertionTime;
+}
+
+size_t CellStreamer::GetLoadedCellCount() const {
+	size_t loadedCellCount = 0;
+	for (const auto& [cellEntity, cell] : cells) {
+		if (cell.state == CellState::Loaded) {
+			++loadedCellCount;
+		}
+	}
+
+	return loadedCellCount;
+}
+
+void CellStreamer::PrepareCell(PreparedCell& preparedCell, Grindstone::Uuid sceneUuid, const SceneCooker& sceneCooker) {
+	GRIND_PROFILE_SCOPE("CellStreamer::PrepareCell");
+
+	preparedCell.file = EngineCore::GetInstance().assetManager->LoadBinaryByUuid(AssetType::Scene, sceneUuid);
+	if (preparedCell.file.status != Assets::AssetLoadStatus::Success) {
+		return;
+	}
+
+	const Byte* data = preparedCell.file.buffer.Get();
+	const uint64_t size = preparedCell.file.buffer.GetCapacity();
+	SceneBlocks sceneBlocks;
+	if (SceneLoaderBinary::IsCookedScene(data, size)) {
+		if (reinterpret_cast<uintptr_t>(data) % CookedSceneFile::SECTION_ALIGNMENT != 0) {
+			preparedCell.alignedFileData.assign(data, data + size);
+			data = preparedCell.alignedFileData.data();
+		}
+
+		if (!SceneLoaderBinary::ReadCookedScene(data, size, sceneBlocks)) {
+			return;
+		}
+	}
+	else {
+		preparedCell.sceneJson.assign(reinterpret_cast<const char*>(data), size);
+		rapidjson::Document document;
+		if (document.ParseInsitu(preparedCell.sceneJson.data()).HasParseError() || !document.IsObject()) {
+			return;
+		}
+
+		if (!document.HasMember("entities") || !document["entities"].IsArray()) {
+			return;
+		}
+
+		const rapidjson::Value& entitiesJson = document["entities"];
+		SceneCooker::CookedEntities& cookedEntities = preparedCell.cookedEntities;
+		if (!sceneCooker.CookEntities(entitiesJson, 0, entitiesJson.Size(), cookedEntities)) {
+			return;
+		}
+
+		if (document.HasMember("name") && document["name"].IsString()) {
+			sceneBlocks.name = document["name"].GetString();
+		}
+
+		sceneBlocks.entities = cookedEntities.entities.data();
+		sceneBlocks.entityCount = cookedEntities.entities.size();
+		for (const SceneCooker::CookedBlock& block : cookedEntities.blocks) {
+			sceneBlocks.blocks.push_back(block.GetView());
+		}
+	}
+
+	preparedCell.sceneName = sceneBlocks.name.empty()
+		? "Untitled Cell"
+		: sceneBlocks.name;
+	preparedCell.entities = sceneBlocks.entities;
+	preparedCell.entityCount = sceneBlocks.entityCount;
+
+	for (const ComponentBlockView& block : sceneBlocks.blocks) {
+		// Blocks that can't be loaded are kept whole, so ComponentBlockLoader reports them.
+		const SceneCooker::ComponentType* componentType = sceneCooker.FindComponentType(block.componentHash);
+		if (componentType == nullptr || componentType->layoutHash != block.layoutHash) {
+			preparedCell.blocks.push_back(block);
+			continue;
+		}
+
+		if (!ComponentBlockLoader::SplitBlock(block, componentType->reflectionData, ENTITIES_PER_STEP, preparedCell.blocks, preparedCell.assetDependencies)) {
+			return;
+		}
+	}
+
+	// Many entities share the same assets, which only need to be requested once.
+	std::vector<AssetDependency>& assetDependencies = preparedCell.assetDependencies;
+	auto getAssetKey = [](const AssetDependency& assetDependency) {
+		return std::tie(assetDependency.assetType, assetDependency.uuid);
+	};
+
+	std::sort(assetDependencies.begin(), assetDependencies.end(), [&](const AssetDependency& a, const AssetDependency& b) {
+		return getAssetKey(a) < getAssetKey(b);
+	});
+
+	auto duplicateAssets = std::unique(assetDependencies.begin(), assetDependencies.end(), [&](const AssetDependency& a, const AssetDependency& b) {
+		return getAssetKey(a) == getAssetKey(b);
+	});
+
+	assetDependencies.erase(duplicateAssets, assetDependencies.end());
+	preparedCell.wasPrepared = true;
+}
+
+void CellStreamer::Update() {
+	GRIND_PROFILE_SCOPE("CellStreamer::Update");
+
+	UpdateCellTargets(EngineCore::GetInstance().GetEntityRegistry());
+	FinishPreparingCells();
+	RunSteps();
+}
+
+void CellStreamer::UpdateCellTargets(entt::registry& registry) {
+	sourcePositions.clear();
+	for (auto [entity, sourceComponent] : registry.view<StreamingSourceComponent>().each()) {
+		if (sourceComponent.isEnabled) {
+			sourcePositions.push_back(TransformComponent::GetWorldPosition(entity, registry));
+		}
+	}
+
+	for (auto [entity, cameraComponent] : registry.view<CameraComponent>().each()) {
+		if (cameraComponent.isMainCamera) {
+			sourcePositions.push_back(TransformComponent::GetWorldPosition(entity, registry));
+		}
+	}
+
+	// Without any sources, such as while the camera is being replaced, cells are left as they are.
+	const bool hasSources = !sourcePositions.empty();
+	for (auto [cellEntity, cellComponent] : registry.view<StreamingCellComponent>().each()) {
+		const Math::Float3 cellPosition = TransformComponent::GetWorldPosition(cellEntity, registry);
+		float nearestDistanceSquared = std::numeric_limits<float>::max();
+		for (const Math::Float3& sourcePosition : sourcePositions) {
+			const Math::Float3 offset = sourcePosition - cellPosition;
+			nearestDistanceSquared = std::min(nearestDistanceSquared, glm::dot(offset, offset));
+		}
+
+		const float nearestDistance = std::sqrt(nearestDistanceSquared);
+		auto cellIterator = cells.find(cellEntity);
+		if (cellIterator == cells.end()) {
+			if (hasSources && nearestDistance <= cellComponent.loadDistance) {
+				BeginLoadingCell(cellEntity, cellComponent, nearestDistance);
+			}
+
+			continue;
+		}
+
+		Cell& cell = cellIterator->second;
+		cell.distance = nearestDistance;
+		if (hasSources && nearestDistance > std::max(cellComponent.loadDistance, cellComponent.unloadDistance)) {
+			BeginUnloadingCell(cell);
+		}
+	}
+
+	// Cells whose entity has been destroyed, or is no longer a cell, are unloaded too.
+	for (auto& [cellEntity, cell] : cells) {
+		if (!registry.valid(cellEntity) || !registry.all_of<StreamingCellComponent>(cellEntity)) {
+			BeginUnloadingCell(cell);
+		}
+	}
+}
+
+void CellStreamer::BeginLoadingCell(entt::entity cellEntity, const StreamingCellComponent& cellComponent, float distance) {
+	Cell& cell = cells[cellEntity];
+	cell.distance = distance;
+
+	if (!Grindstone::Uuid::MakeFromString(cellComponent.scene.c_str(), cell.sceneUuid)) {
+		GPRINT_ERROR_V(LogSource::EngineCore, "Streaming cell has an invalid scene uuid '{}'.", cellComponent.scene);
+		cell.state = CellState::Failed;
+		return;
+	}
+
+	EngineCore& engineCore = EngineCore::GetInstance();
+	if (sceneCooker == nullptr) {
+		sceneCooker = std::make_unique<SceneCooker>(*engineCore.GetComponentRegistrar());
+	}
+
+	cell.state = CellState::Preparing;
+	cell.preparedCell = std::make_unique<PreparedCell>();
+
+	PreparedCell* preparedCell = cell.preparedCell.get();
+	const SceneCooker* cooker = sceneCooker.get();
+	const Grindstone::Uuid sceneUuid = cell.sceneUuid;
+	// Reading a scene can take a while, so it mustn't be picked up by a thread waiting on frame work.
+	engineCore.GetJobSystem()->Schedule(
+		[preparedCell, sceneUuid, cooker] {
+			PrepareCell(*preparedCell, sceneUuid, *cooker);
+		},
+		&preparedCell->counter,
+		Jobs::JobAffinity::Background
+	);
+}
+
+void CellStreamer::BeginUnloadingCell(Cell& cell) {
+	switch (cell.state) {
+	case CellState::Preparing:
+		cell.shouldUnload = true;
+		return;
+	case CellState::Inserting:
+		cell.entities = cell.blockLoader->GetCreatedEntities();
+		break;
+	case CellState::Loaded:
+	case CellState::Failed:
+		break;
+	case CellState::Unloading:
+		return;
+	}
+
+	ReleasePrefetchedAssets(cell);
+	cell.blockLoader.reset();
+	cell.preparedCell.reset();
+	cell.state = CellState::Unloading;
+	cell.stepCursor = 0;
+}
+
+void CellStreamer::FinishPreparingCells() {
+	Assets::AssetManager* assetManager = EngineCore::GetInstance().assetManager;
+	for (auto& [cellEntity, cell] : cells) {
+		if (cell.state != CellState::Preparing || !cell.preparedCell->counter.IsDone()) {
+			continue;
+		}
+
+		if (cell.shouldUnload) {
+			cell.preparedCell.reset();
+			cell.state = CellState::Unloading;
+			cell.stepCursor = 0;
+			continue;
+		}
+
+		PreparedCell& preparedCell = *cell.preparedCell;
+		if (!preparedCell.wasPrepared) {
+			GPRINT_ERROR_V(LogSource::EngineCore, "Failed to stream in the scene of a cell, with id {}.", cell.sceneUuid.ToString());
+			cell.preparedCell.reset();
+			cell.state = CellState::Failed;
+			continue;
+		}
+
+		// Requested before any entity is created, so the assets stream in while the cell is being inserted.
+		cell.prefetchedAssets.reserve(preparedCell.assetDependencies.size());
+		for (const AssetDependency& assetDependency : preparedCell.assetDependencies) {
+			cell.prefetchedAssets.push_back(assetManager->IncrementAssetCountAsync(assetDependency.assetType, assetDependency.uuid));
+		}
+
+		cell.scene = AllocatorCore::Allocate<Scene>();
+		cell.scene->SetName(preparedCell.sceneName);
+		cell.blockLoader = std::make_unique<ComponentBlockLoader>(cell.scene, false);
+		cell.state = CellState::Inserting;
+		cell.insertionStage = InsertionStage::CreatingEntities;
+		cell.stepCursor = 0;
+	}
+}
+
+void CellStreamer::RunSteps() {
+	GRIND_PROFILE_SCOPE("CellStreamer::RunSteps");
+
+	// Unloading comes first to free memory for the cells being loaded, and nearer cells are inserted before farther ones.
+	std::vector<Cell*> unloadingCells;
+	std::vector<Cell*> insertingCells;
+	for (auto& [cellEntity, cell] : cells) {
+		if (cell.state == CellState::Unloading) {
+			unloadingCells.push_back(&cell);
+		}
+		else if (cell.state == CellState::Inserting) {
+			insertingCells.push_back(&cell);
+		}
+	}
+
+	std::sort(insertingCells.begin(), insertingCells.end(), [](const Cell* a, const Cell* b) {
+		return a->distance < b->distance;
+	});
+
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	const std::chrono::steady_clock::time_point deadline = startTime + insertionBudget;
+	// A step only starts if one as long as the longest step of this frame or the last would still end in time.
+	std::chrono::steady_clock::duration longestStepTime = std::chrono::steady_clock::duration::zero();
+	bool hasRunStep = false;
+	auto canRunStep = [&]() {
+		const std::chrono::steady_clock::duration expectedStepTime = std::max(longestStepTime, lastLongestStepTime);
+		return !hasRunStep || std::chrono::steady_clock::now() + expectedStepTime <= deadline;
+	};
+
+	auto runStep = [&](auto&& step) {
+		const std::chrono::steady_clock::time_point stepStartTime = std::chrono::steady_clock::now();
+		step();
+		longestStepTime = std::max(longestStepTime, std::chrono::steady_clock::now() - stepStartTime);
+		hasRunStep = true;
+	};
+
+	for (Cell* cell : unloadingCells) {
+		while (!cell->isUnloaded && canRunStep()) {
+			runStep([&] { RunUnloadStep(*cell, ENTITIES_PER_STEP); });
+		}
+	}
+
+	for (Cell* cell : insertingCells) {
+		while (cell->state == CellState::Inserting && canRunStep()) {
+			runStep([&] { RunInsertionStep(*cell); });
+		}
+	}
+
+	lastInsertionTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+	// Only kept for a frame, so one slow step doesn't hold back streaming for long.
+	lastLongestStepTime = longestStepTime;
+
+	for (auto cellIterator = cells.begin(); cellIterator != cells.end();) {
+		if (cellIterator->second.isUnloaded) {
+			cellIterator = cells.erase(cellIterator);
+		}
+		else {
+			++cellIterator;
+		}
+	}
+}
+
+void CellStreamer::RunInsertionStep(Cell& cell) {
+	PreparedCell& preparedCell = *cell.preparedCell;
+	ComponentBlockLoader& blockLoader = *cell.blockLoader;
+	const size_t createdEntityCount = blockLoader.GetCreatedEntities().size();
+
+	switch (cell.insertionStage) {
+	case InsertionStage::CreatingEntities: {
+		const size_t entityCount = std::min<size_t>(ENTITIES_PER_STEP, preparedCell.entityCount - cell.stepCursor);
+		blockLoader.CreateEntities(preparedCell.entities + cell.stepCursor, entityCount);
+		cell.stepCursor += entityCount;
+		if (cell.stepCursor == preparedCell.entityCount) {
+			cell.insertionStage = InsertionStage::LoadingBlocks;
+			cell.stepCursor = 0;
+		}
+		break;
+	}
+	case InsertionStage::LoadingBlocks:
+		if (cell.stepCursor < preparedCell.blocks.size()) {
+			blockLoader.LoadBlock(preparedCell.blocks[cell.stepCursor++]);
+		}
+
+		if (cell.stepCursor == preparedCell.blocks.size()) {
+			cell.insertionStage = InsertionStage::FixingUpParents;
+			cell.stepCursor = 0;
+		}
+		break;
+	case InsertionStage::FixingUpParents: {
+		const size_t entityEnd = std::min<size_t>(cell.stepCursor + ENTITIES_PER_STEP, createdEntityCount);
+		blockLoader.FixUpParents(cell.stepCursor, entityEnd);
+		cell.stepCursor = entityEnd;
+		if (cell.stepCursor == createdEntityCount) {
+			cell.insertionStage = InsertionStage::SettingUpComponents;
+			cell.stepCursor = 0;
+		}
+		break;
+	}
+	case InsertionStage::SettingUpComponents: {
+		const size_t entityEnd = std::min<size_t>(cell.stepCursor + ENTITIES_PER_STEP, createdEntityCount);
+		blockLoader.SetUpComponents(cell.stepCursor, entityEnd);
+		cell.stepCursor = entityEnd;
+		cell.setUpEntityCount = entityEnd;
+		if (cell.stepCursor == createdEntityCount) {
+			FinishInsertingCell(cell);
+		}
+		break;
+	}
+	}
+}
+
+void CellStreamer::FinishInsertingCell(Cell& cell) {
+	cell.entities = cell.blockLoader->GetCreatedEntities();
+	cell.blockLoader.reset();
+	cell.preparedCell.reset();
+	// The cell's components now hold their own references to its assets.
+	ReleasePrefetchedAssets(cell);
+	cell.state = CellState::Loaded;
+}
+
+void CellStreamer::RunUnloadStep(Cell& cell, size_t maxEntityCount) {
+	EngineCore& engineCore = EngineCore::GetInstance();
+	WorldContextSet& worldContextSet = *engineCore.GetWorldContextManager()->GetActiveWorldContextSet();
+	entt::registry& registry = worldContextSet.GetEntityRegistry();
+
+	// Gameplay may have destroyed some of the cell's entities already.
+	const size_t entityEnd = std::min(cell.stepCursor + maxEntityCount, cell.entities.size());
+	destroyedEntities.clear();
+	setUpDestroyedEntities.clear();
+	for (size_t entityIndex = cell.stepCursor; entityIndex < entityEnd; ++entityIndex) {
+		const entt::entity entity = cell.entities[entityIndex];
+		if (!registry.valid(entity)) {
+			continue;
+		}
+
+		destroyedEntities.push_back(entity);
+		if (entityIndex < cell.setUpEntityCount) {
+			setUpDestroyedEntities.push_back(entity);
+		}
+	}
+
+	engineCore.GetComponentRegistrar()->CallDestroyOnEntities(worldContextSet, setUpDestroyedEntities.data(), setUpDestroyedEntities.size());
+	registry.destroy(destroyedEntities.begin(), destroyedEntities.end());
+
+	cell.stepCursor = entityEnd;
+	if (cell.stepCursor == cell.entities.size()) {
+		FreeCell(cell);
+		cell.isUnloaded = true;
+	}
+}
+
+void CellStreamer::ReleasePrefetchedAssets(Cell& cell) {
+	Assets::AssetManager* assetManager = EngineCore::GetInstance().assetManager;
+	for (const Assets::AssetStreamHandle& prefetchedAsset : cell.prefetchedAssets) {
+		assetManager->CancelAssetStream(prefetchedAsset);
+	}
+
+	cell.prefetchedAssets.clear();
+}
+
+void CellStreamer::FreeCell(Cell& cell) {
+	if (cell.scene != nullptr) {
+		AllocatorCore::Free(cell.scene);
+		cell.scene = nullptr;
+	}
+
+	cell.entities.clear();
+}
+
+void CellStreamer::UnloadAllCells() {
+	if (cells.empty()) {
+		sceneCooker.reset();
+		return;
+	}
+
+	EngineCore& engineCore = EngineCore::GetInstance();
+	for (auto& [cellEntity, cell] : cells) {
+		if (cell.state == CellState::Preparing) {
+			engineCore.GetJobSystem()->Wait(cell.preparedCell->counter);
+			cell.shouldUnload = true;
+			cell.preparedCell.reset();
+			cell.state = CellState::Unloading;
+			cell.stepCursor = 0;
+		}
+
+		BeginUnloadingCell(cell);
+		RunUnloadStep(cell, cell.entities.size());
+	}
+
+	cells.clear();
+	// Components can change before cells are streamed again, such as when plugins are reloaded.
+	sceneCooker.reset();
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <entt/entt.hpp>
+
+#include <Common/Math.hpp>
+#include <Common/ResourcePipeline/Uuid.hpp>
+#include <EngineCore/Assets/AssetStreamer.hpp>
+
+namespace Grindstone {
+	struct StreamingCellComponent;
+
+	namespace SceneManagement {
+		class ComponentBlockLoader;
+		class Scene;
+		class SceneCooker;
+
+		/*
+		 * Streams the cells of a world (see StreamingCellComponent) in and out around its streaming sources,
+		 * which are entities with a StreamingSourceComponent and main cameras. A cell's scene is read and
+		 * turned into component blocks on the job system. Its assets are requested as soon as that finishes,
+		 * then its entities are created in small steps, with only as many steps each frame as fit in the
+		 * insertion budget. Cells are unloaded the same way.
+		 */
+		class CellStreamer {
+		public:
+			CellStreamer();
+			CellStreamer(const CellStreamer&) = delete;
+			CellStreamer& operator=(const CellStreamer&) = delete;
+			~CellStreamer();
+
+			// Must be called once per frame, from the main thread.
+			void Update();
+			// Unloads every cell right away, waiting for any that are still being prepared.
+			void UnloadAllCells();
+
+			// At least one step runs each frame, so streaming always makes progress even with a tiny budget. Other
+			// steps only run if they're expected to end within the budget, judging by the longest recent step.
+			void SetInsertionBudget(std::chrono::microseconds budget);
+			std::chrono::microseconds GetInsertionBudget() const;
+			// How long the last Update spent creating and destroying the entities of cells.
+			std::chrono::microseconds GetLastInsertionTime() const;
+			size_t GetLoadedCellCount() const;
+		private:
+			enum class CellState {
+				// The cell's scene is being read and cooked on the job system.
+				Preparing,
+				// The cell's entities are being created, a step at a time.
+				Inserting,
+				Loaded,
+				// The cell's scene couldn't be loaded. It's kept until it's out of range, so it isn't retried every frame.
+				Failed,
+				// The cell's entities are being destroyed, a step at a time.
+				Unloading
+			};
+
+			enum class InsertionStage {
+				CreatingEntities,
+				LoadingBlocks,
+				FixingUpParents,
+				SettingUpComponents
+			};
+
+			struct PreparedCell;
+
+			struct Cell {
+				CellState state = CellState::Preparing;
+				Grindstone::Uuid sceneUuid;
+				// The distance to the nearest streaming source, so nearer cells are inserted first.
+				float distance = 0.0f;
+				// Set when a cell goes out of range while it's being prepared, as the job can't be stopped.
+				bool shouldUnload = false;
+				bool isUnloaded = false;
+				std::unique_ptr<PreparedCell> preparedCell;
+				std::unique_ptr<ComponentBlockLoader> blockLoader;
+				Scene* scene = nullptr;
+				InsertionStage insertionStage = InsertionStage::CreatingEntities;
+				// How far the current insertion stage, or the unload, has gotten.
+				size_t stepCursor = 0;
+				std::vector<entt::entity> entities;
+				// Components are only set up a step at a time, so only the first of the entities need to be destroyed through their components.
+				size_t setUpEntityCount = 0;
+				// Held until the cell's components hold their own references.
+				std::vector<Assets::AssetStreamHandle> prefetchedAssets;
+			};
+
+			static void PrepareCell(PreparedCell& preparedCell, Grindstone::Uuid sceneUuid, const SceneCooker& sceneCooker);
+
+			void UpdateCellTargets(entt::registry& registry);
+			void BeginLoadingCell(entt::entity cellEntity, const StreamingCellComponent& cellComponent, float distance);
+			void BeginUnloadingCell(Cell& cell);
+			void FinishPreparingCells();
+			void RunSteps();
+			void RunInsertionStep(Cell& cell);
+			void RunUnloadStep(Cell& cell, size_t maxEntityCount);
+			void FinishInsertingCell(Cell& cell);
+			void ReleasePrefetchedAssets(Cell& cell);
+			void FreeCell(Cell& cell);
+		private:
+			std::unordered_map<entt::entity, Cell> cells;
+			// Created once cells are first streamed, as every component must be registered by then.
+			std::unique_ptr<SceneCooker> sceneCooker;
+			std::vector<Math::Float3> sourcePositions;
+			std::vector<entt::entity> destroyedEntities;
+			std::vector<entt::entity> setUpDestroyedEntities;
+			std::chrono::microseconds insertionBudget = std::chrono::microseconds(2000);
+			std::chrono::microseconds lastInsertionTime = std::chrono::microseconds(0);
+			std::chrono::steady_clock::duration lastLongestStepTime = std::chrono::steady_clock::duration::zero();
+		};
+	}
+}
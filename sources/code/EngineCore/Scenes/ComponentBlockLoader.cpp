@@ -0,0 +1,457 @@
+#include <algorithm>
+#include <cstring>
+
+#include "EngineCore/Profiling.hpp"
+#include "EngineCore/EngineCore.hpp"
+#include <EngineCore/Logger.hpp>
+#include "EngineCore/CoreComponents/Parent/ParentComponent.hpp"
+#include "EngineCore/ECS/ComponentRegistrar.hpp"
+#include "EngineCore/Assets/AssetManager.hpp"
+#include "EngineCore/Reflection/TypeDescriptorAsset.hpp"
+#include "EngineCore/WorldContext/WorldContextManager.hpp"
+
+#include "ComponentBlockLoader.hpp"
+#include "Scene.hpp"
+
+using namespace Grindstone;
+using namespace Grindstone::SceneManagement;
+
+static_assert(sizeof(entt::entity) == sizeof(uint32_t), "Component blocks store entities as uint32_t ids.");
+
+using ReflectionTypeData = Reflection::TypeDescriptor::ReflectionTypeData;
+
+// Reads the values of a member records block, failing instead of reading past its end.
+class CookedSceneReader {
+public:
+	CookedSceneReader(const Byte* data, uint64_t size) : data(data), remainingSize(size) {}
+
+	const Byte* Take(uint64_t size) {
+		if (size > remainingSize) {
+			return nullptr;
+		}
+
+		const Byte* takenData = data;
+		data += size;
+		remainingSize -= size;
+		return takenData;
+	}
+
+	bool Read(void* destination, uint64_t size) {
+		const Byte* source = Take(size);
+		if (source == nullptr) {
+			return false;
+		}
+
+		std::memcpy(destination, source, size);
+		return true;
+	}
+
+	template<typename T>
+	bool Read(T& value) {
+		return Read(&value, sizeof(T));
+	}
+
+	const Byte* GetPosition() const {
+		return data;
+	}
+
+private:
+	const Byte* data;
+	uint64_t remainingSize;
+};
+
+static bool ReadMember(CookedSceneReader& reader, void* memberPtr, const Reflection::TypeDescriptor* member) {
+	switch (member->type) {
+	case ReflectionTypeData::Struct:
+		// Never cooked, as structs can't be loaded from json either.
+		return false;
+	case ReflectionTypeData::String: {
+		uint32_t size = 0;
+		if (!reader.Read(size)) {
+			return false;
+		}
+
+		const Byte* characters = reader.Take(size);
+		if (characters == nullptr) {
+			return false;
+		}
+
+		std::string& str = *static_cast<std::string*>(memberPtr);
+		str.assign(reinterpret_cast<const char*>(characters), size);
+		return true;
+	}
+	case ReflectionTypeData::AssetReference: {
+		GenericAssetReference& assetRefPtr = *static_cast<GenericAssetReference*>(memberPtr);
+		if (!reader.Read(&assetRefPtr.uuid, sizeof(Grindstone::Uuid))) {
+			return false;
+		}
+
+		if (assetRefPtr.uuid.IsValid()) {
+			auto type = static_cast<const Reflection::TypeDescriptor_AssetReference*>(member);
+			EngineCore::GetInstance().assetManager->IncrementAssetCountAsync(type->assetType, assetRefPtr.uuid);
+		}
+
+		return true;
+	}
+	case ReflectionTypeData::Vector: {
+		auto vectorType = static_cast<const Reflection::TypeDescriptor_StdVector*>(member);
+		uint32_t count = 0;
+		if (!reader.Read(count)) {
+			return false;
+		}
+
+		for (size_t size = vectorType->getSize(memberPtr); size > 0; --size) {
+			vectorType->erase(memberPtr, size - 1);
+		}
+
+		for (uint32_t i = 0; i < count; ++i) {
+			vectorType->emplaceBack(memberPtr);
+			if (!ReadMember(reader, vectorType->getItem(memberPtr, i), vectorType->itemType)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+	case ReflectionTypeData::FixedArray: {
+		auto arrayType = static_cast<const Reflection::TypeDescriptor_FixedArray*>(member);
+		uint32_t count = 0;
+		if (!reader.Read(count) || count > arrayType->size) {
+			return false;
+		}
+
+		for (uint32_t i = 0; i < count; ++i) {
+			if (!ReadMember(reader, arrayType->getItem(memberPtr, i), arrayType->itemType)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+	default:
+		// Every other type is stored as its bytes.
+		return reader.Read(memberPtr, member->size);
+	}
+}
+
+// Moves the reader past a member like ReadMember, only noting the assets it references.
+static bool SkipMember(CookedSceneReader& reader, const Reflection::TypeDescriptor* member, std::vector<AssetDependency>& outAssetDependencies) {
+	switch (member->type) {
+	case ReflectionTypeData::Struct:
+		return false;
+	case ReflectionTypeData::String: {
+		uint32_t size = 0;
+		return reader.Read(size) && reader.Take(size) != nullptr;
+	}
+	case ReflectionTypeData::AssetReference: {
+		AssetDependency assetDependency;
+		if (!reader.Read(&assetDependency.uuid, sizeof(Grindstone::Uuid))) {
+			return false;
+		}
+
+		if (assetDependency.uuid.IsValid()) {
+			assetDependency.assetType = static_cast<const Reflection::TypeDescriptor_AssetReference*>(member)->assetType;
+			outAssetDependencies.push_back(assetDependency);
+		}
+
+		return true;
+	}
+	case ReflectionTypeData::Vector:
+	case ReflectionTypeData::FixedArray: {
+		const Reflection::TypeDescriptor* itemType = nullptr;
+		uint32_t count = 0;
+		if (!reader.Read(count)) {
+			return false;
+		}
+
+		if (member->type == ReflectionTypeData::Vector) {
+			itemType = static_cast<const Reflection::TypeDescriptor_StdVector*>(member)->itemType;
+		}
+		else {
+			auto arrayType = static_cast<const Reflection::TypeDescriptor_FixedArray*>(member);
+			if (count > arrayType->size) {
+				return false;
+			}
+
+			itemType = arrayType->itemType;
+		}
+
+		for (uint32_t i = 0; i < count; ++i) {
+			if (!SkipMember(reader, itemType, outAssetDependencies)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+	default:
+		return reader.Take(member->size) != nullptr;
+	}
+}
+
+ComponentBlockLoader::ComponentBlockLoader(Scene* scene, bool shouldKeepEntityIds) : scene(scene), shouldKeepEntityIds(shouldKeepEntityIds) {
+	// Blocks name their component by hash, so look the components up by hash once for the whole scene.
+	for (auto& [componentName, componentFunctions] : *EngineCore::GetInstance().GetComponentRegistrar()) {
+		componentFunctionsByHash[componentName.GetHash()] = &componentFunctions;
+	}
+}
+
+bool ComponentBlockLoader::SplitBlock(
+	const ComponentBlockView& block,
+	const Reflection::TypeDescriptor_Struct& reflectionData,
+	uint32_t maxEntityCount,
+	std::vector<ComponentBlockView>& outBlocks,
+	std::vector<AssetDependency>& outAssetDependencies
+) {
+	maxEntityCount = std::max(maxEntityCount, 1u);
+
+	// Copied components are trivially copyable, so they can't hold asset references, and every component is the same size.
+	if (block.layout == CookedSceneFile::ComponentBlockLayout::CopiedComponents) {
+		for (uint32_t firstEntity = 0; firstEntity < block.entityCount; firstEntity += maxEntityCount) {
+			ComponentBlockView& splitBlock = outBlocks.emplace_back(block);
+			splitBlock.entities = block.entities + firstEntity;
+			splitBlock.entityCount = std::min(maxEntityCount, block.entityCount - firstEntity);
+			splitBlock.data = block.data + static_cast<uint64_t>(firstEntity) * block.componentSize;
+			splitBlock.dataSize = static_cast<uint64_t>(splitBlock.entityCount) * block.componentSize;
+		}
+
+		return true;
+	}
+
+	// Records vary in size, so they're walked to find where each split starts.
+	const std::vector<Reflection::TypeDescriptor_Struct::Member>& members = reflectionData.category.members;
+	CookedSceneReader reader(block.data, block.dataSize);
+	uint32_t firstEntity = 0;
+	const Byte* firstData = block.data;
+	for (uint32_t entityIndex = 0; entityIndex < block.entityCount; ++entityIndex) {
+		uint32_t recordCount = 0;
+		if (!reader.Read(recordCount)) {
+			return false;
+		}
+
+		for (uint32_t recordIndex = 0; recordIndex < recordCount; ++recordIndex) {
+			uint32_t memberIndex = 0;
+			if (!reader.Read(memberIndex) || memberIndex >= members.size()) {
+				return false;
+			}
+
+			if (!SkipMember(reader, members[memberIndex].type, outAssetDependencies)) {
+				return false;
+			}
+		}
+
+		const uint32_t splitEntityCount = entityIndex + 1 - firstEntity;
+		if (splitEntityCount == maxEntityCount || entityIndex + 1 == block.entityCount) {
+			ComponentBlockView& splitBlock = outBlocks.emplace_back(block);
+			splitBlock.entities = block.entities + firstEntity;
+			splitBlock.entityCount = splitEntityCount;
+			splitBlock.data = firstData;
+			splitBlock.dataSize = static_cast<uint64_t>(reader.GetPosition() - firstData);
+			firstEntity = entityIndex + 1;
+			firstData = reader.GetPosition();
+		}
+	}
+
+	return true;
+}
+
+// If the created entities are exactly the saved ids in some order, puts them in the order of the saved ids and returns true.
+static bool TryTakeSavedEntityIds(const uint32_t* entityIds, entt::entity* entities, size_t entityCount) {
+	if (entityCount == 0) {
+		return true;
+	}
+
+	const auto [minEntity, maxEntity] = std::minmax_element(entities, entities + entityCount);
+	const uint32_t minEntityId = static_cast<uint32_t>(*minEntity);
+	const uint64_t entityIdRange = static_cast<uint64_t>(static_cast<uint32_t>(*maxEntity)) - minEntityId + 1;
+	if (entityIdRange != entityCount) {
+		return false;
+	}
+
+	std::vector<bool> isUnclaimed(entityCount, true);
+	for (size_t entityIndex = 0; entityIndex < entityCount; ++entityIndex) {
+		// Ids below the range wrap around to a large offset.
+		const uint64_t offset = static_cast<uint64_t>(entityIds[entityIndex]) - minEntityId;
+		if (offset >= entityCount || !isUnclaimed[offset]) {
+			return false;
+		}
+
+		isUnclaimed[offset] = false;
+	}
+
+	std::transform(entityIds, entityIds + entityCount, entities, [](uint32_t entityId) {
+		return static_cast<entt::entity>(entityId);
+	});
+	return true;
+}
+
+void ComponentBlockLoader::CreateEntities(const uint32_t* entityIds, size_t entityCount) {
+	GRIND_PROFILE_SCOPE("ComponentBlockLoader::CreateEntities");
+
+	const size_t firstEntity = createdEntities.size();
+	createdEntities.resize(firstEntity + entityCount);
+	entt::entity* entities = createdEntities.data() + firstEntity;
+
+	entt::registry& registry = scene->GetEntityRegistry();
+	registry.create(entities, entities + entityCount);
+	if (!shouldKeepEntityIds) {
+		for (size_t entityIndex = 0; entityIndex < entityCount; ++entityIndex) {
+			remappedEntities[static_cast<entt::entity>(entityIds[entityIndex])] = entities[entityIndex];
+		}
+
+		return;
+	}
+
+	// A scene loaded into an empty registry is handed back the ids it was saved with, just in another order.
+	// Otherwise, the range is given back and each entity is created from its saved id.
+	if (TryTakeSavedEntityIds(entityIds, entities, entityCount)) {
+		return;
+	}
+
+	registry.destroy(entities, entities + entityCount);
+	for (size_t entityIndex = 0; entityIndex < entityCount; ++entityIndex) {
+		const entt::entity cookedEntity = static_cast<entt::entity>(entityIds[entityIndex]);
+		const entt::entity entity = scene->CreateEmptyEntity(cookedEntity).GetHandle();
+		if (entity != cookedEntity) {
+			remappedEntities[cookedEntity] = entity;
+		}
+
+		entities[entityIndex] = entity;
+	}
+}
+
+const ComponentBlockLoader::ComponentType* ComponentBlockLoader::GetComponentType(uint64_t componentHash) {
+	auto componentTypeIterator = componentTypes.find(componentHash);
+	if (componentTypeIterator != componentTypes.end()) {
+		return &componentTypeIterator->second;
+	}
+
+	auto componentFunctionsIterator = componentFunctionsByHash.find(componentHash);
+	if (componentFunctionsIterator == componentFunctionsByHash.end()) {
+		return nullptr;
+	}
+
+	ComponentType& componentType = componentTypes[componentHash];
+	componentType.componentFunctions = componentFunctionsIterator->second;
+	componentType.reflectionData = componentType.componentFunctions->GetComponentReflectionDataFn();
+	componentType.layoutHash = ComputeComponentLayoutHash(componentType.reflectionData);
+	return &componentType;
+}
+
+void ComponentBlockLoader::LoadBlock(const ComponentBlockView& block) {
+	const ComponentType* componentType = GetComponentType(block.componentHash);
+	if (componentType == nullptr) {
+		GPRINT_WARN_V(LogSource::EngineCore, "Skipped unregistered component '{}' in scene '{}'.", block.componentName, scene->GetName());
+		return;
+	}
+
+	if (componentType->layoutHash != block.layoutHash) {
+		GPRINT_ERROR_V(LogSource::EngineCore, "Skipped component '{}' in scene '{}', as it has changed since the scene was cooked. Build the game again to cook it.", block.componentName, scene->GetName());
+		return;
+	}
+
+	const entt::entity* entities = reinterpret_cast<const entt::entity*>(block.entities);
+	if (!remappedEntities.empty()) {
+		remappedBlockEntities.assign(entities, entities + block.entityCount);
+		for (entt::entity& entity : remappedBlockEntities) {
+			auto remappedEntityIterator = remappedEntities.find(entity);
+			if (remappedEntityIterator != remappedEntities.end()) {
+				entity = remappedEntityIterator->second;
+			}
+		}
+
+		entities = remappedBlockEntities.data();
+	}
+
+	const ECS::ComponentFunctions& componentFunctions = *componentType->componentFunctions;
+	entt::registry& registry = scene->GetEntityRegistry();
+	if (block.layout == CookedSceneFile::ComponentBlockLayout::CopiedComponents) {
+		if (componentFunctions.InsertCopiedComponentsFn == nullptr || block.componentSize != componentType->reflectionData.size) {
+			GPRINT_ERROR_V(LogSource::EngineCore, "Skipped component '{}' in scene '{}', as it can no longer be copied. Build the game again to cook it.", block.componentName, scene->GetName());
+			return;
+		}
+
+		componentFunctions.InsertCopiedComponentsFn(registry, entities, block.entityCount, block.data);
+		return;
+	}
+
+	if (!LoadMemberRecords(block, *componentType, entities)) {
+		GPRINT_ERROR_V(LogSource::EngineCore, "Component '{}' in scene '{}' is corrupt, so some of its members weren't loaded.", block.componentName, scene->GetName());
+	}
+}
+
+bool ComponentBlockLoader::LoadMemberRecords(const ComponentBlockView& block, const ComponentType& componentType, const entt::entity* entities) {
+	const ECS::ComponentFunctions& componentFunctions = *componentType.componentFunctions;
+	entt::registry& registry = scene->GetEntityRegistry();
+	componentFunctions.CreateComponentsFn(registry, entities, block.entityCount);
+
+	const std::vector<Reflection::TypeDescriptor_Struct::Member>& members = componentType.reflectionData.category.members;
+	CookedSceneReader reader(block.data, block.dataSize);
+	for (uint32_t entityIndex = 0; entityIndex < block.entityCount; ++entityIndex) {
+		void* componentPtr = nullptr;
+		componentFunctions.TryGetComponentFn(registry, entities[entityIndex], componentPtr);
+
+		uint32_t recordCount = 0;
+		if (!reader.Read(recordCount)) {
+			return false;
+		}
+
+		for (uint32_t recordIndex = 0; recordIndex < recordCount; ++recordIndex) {
+			uint32_t memberIndex = 0;
+			if (!reader.Read(memberIndex) || memberIndex >= members.size()) {
+				return false;
+			}
+
+			const Reflection::TypeDescriptor_Struct::Member& member = members[memberIndex];
+			char* memberPtr = static_cast<char*>(componentPtr) + member.offset;
+			if (!ReadMember(reader, memberPtr, member.type)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void ComponentBlockLoader::FixUpParents(size_t begin, size_t end) {
+	GRIND_PROFILE_SCOPE("ComponentBlockLoader::FixUpParents");
+
+	// Parents are stored by the ids they had when the scene was saved, so any that moved are fixed up once everything exists.
+	if (remappedEntities.empty()) {
+		return;
+	}
+
+	entt::registry& registry = scene->GetEntityRegistry();
+	for (size_t entityIndex = begin; entityIndex < end; ++entityIndex) {
+		ParentComponent* parentComponent = registry.try_get<ParentComponent>(createdEntities[entityIndex]);
+		if (parentComponent == nullptr) {
+			continue;
+		}
+
+		auto remappedParentIterator = remappedEntities.find(parentComponent->parentEntity);
+		if (remappedParentIterator != remappedEntities.end()) {
+			parentComponent->parentEntity = remappedParentIterator->second;
+		}
+	}
+}
+
+void ComponentBlockLoader::SetUpComponents(size_t begin, size_t end) {
+	GRIND_PROFILE_SCOPE("ComponentBlockLoader::SetUpComponents");
+
+	// Only the new entities are set up, so loading a scene additively doesn't set up the loaded ones again.
+	EngineCore& engineCore = EngineCore::GetInstance();
+	engineCore.GetComponentRegistrar()->CallCreateOnEntities(
+		*engineCore.GetWorldContextManager()->GetActiveWorldContextSet(),
+		createdEntities.data() + begin,
+		end - begin
+	);
+}
+
+void ComponentBlockLoader::Finish() {
+	FixUpParents(0, createdEntities.size());
+	SetUpComponents(0, createdEntities.size());
+}
+
+const std::vector<entt::entity>& ComponentBlockLoader::GetCreatedEntities() const {
+	return createdEntities;
+}
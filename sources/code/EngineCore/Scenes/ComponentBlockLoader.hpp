@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <entt/entt.hpp>
+
+#include <Common/IntTypes.hpp>
+#include <Common/ResourcePipeline/AssetType.hpp>
+#include <Common/ResourcePipeline/Uuid.hpp>
+#include <EngineCore/Reflection/TypeDescriptorStruct.hpp>
+
+#include "CookedSceneFile.hpp"
+
+namespace Grindstone {
+	namespace ECS {
+		class ComponentFunctions;
+	}
+
+	namespace SceneManagement {
+		class Scene;
+
+		// The components of one type for many entities, laid out as a component block of a cooked scene.
+		struct ComponentBlockView {
+			uint64_t componentHash = 0;
+			uint64_t layoutHash = 0;
+			std::string_view componentName;
+			CookedSceneFile::ComponentBlockLayout layout = CookedSceneFile::ComponentBlockLayout::CopiedComponents;
+			uint32_t componentSize = 0;
+			const uint32_t* entities = nullptr;
+			uint32_t entityCount = 0;
+			const Byte* data = nullptr;
+			uint64_t dataSize = 0;
+		};
+
+		// The entities and component blocks of a scene, ready to be created by a ComponentBlockLoader.
+		struct SceneBlocks {
+			std::string_view name;
+			const uint32_t* entities = nullptr;
+			size_t entityCount = 0;
+			std::vector<ComponentBlockView> blocks;
+		};
+
+		struct AssetDependency {
+			AssetType assetType = AssetType::Undefined;
+			Grindstone::Uuid uuid;
+		};
+
+		/*
+		 * Creates a scene's entities and components in bulk from component blocks, which come either from
+		 * a cooked scene or from json that SceneLoaderJson has cooked while loading. Each block is created
+		 * for all of its entities at once, then Finish sets up every component that was loaded. The steps
+		 * can also be run a range at a time, which CellStreamer uses to spread a cell over several frames.
+		 */
+		class ComponentBlockLoader {
+		public:
+			// Scenes that are loaded together keep their saved entity ids where they can. Cells' ids are only
+			// unique within their cell, so they're created with new ids instead.
+			ComponentBlockLoader(Scene* scene, bool shouldKeepEntityIds = true);
+
+			/*
+			 * Splits a block into blocks of at most maxEntityCount entities, and gathers the assets that its
+			 * members reference. Doesn't touch the registry, so it can run on any thread. Returns false if the
+			 * block is corrupt.
+			 */
+			static bool SplitBlock(
+				const ComponentBlockView& block,
+				const Reflection::TypeDescriptor_Struct& reflectionData,
+				uint32_t maxEntityCount,
+				std::vector<ComponentBlockView>& outBlocks,
+				std::vector<AssetDependency>& outAssetDependencies
+			);
+
+			void CreateEntities(const uint32_t* entityIds, size_t entityCount);
+			void LoadBlock(const ComponentBlockView& block);
+			// Points the parents of the created entities in [begin, end) at the entities they were created as.
+			void FixUpParents(size_t begin, size_t end);
+			// Calls the setup of the components of the created entities in [begin, end).
+			void SetUpComponents(size_t begin, size_t end);
+			// Runs FixUpParents and SetUpComponents for every created entity.
+			void Finish();
+			const std::vector<entt::entity>& GetCreatedEntities() const;
+		private:
+			struct ComponentType {
+				const ECS::ComponentFunctions* componentFunctions = nullptr;
+				Reflection::TypeDescriptor_Struct reflectionData;
+				uint64_t layoutHash = 0;
+			};
+
+			const ComponentType* GetComponentType(uint64_t componentHash);
+			bool LoadMemberRecords(const ComponentBlockView& block, const ComponentType& componentType, const entt::entity* entities);
+		private:
+			Scene* scene;
+			bool shouldKeepEntityIds = true;
+			std::unordered_map<uint64_t, const ECS::ComponentFunctions*> componentFunctionsByHash;
+			// Filled as blocks of each type are loaded, as a scene can hold many blocks of the same type.
+			std::unordered_map<uint64_t, ComponentType> componentTypes;
+			std::vector<entt::entity> createdEntities;
+			// Only filled if some of the scene's entity ids weren't kept, such as when they're already in use.
+			std::unordered_map<entt::entity, entt::entity> remappedEntities;
+			std::vector<entt::entity> remappedBlockEntities;
+		};
+	}
+}
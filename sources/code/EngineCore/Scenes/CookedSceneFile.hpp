@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Common/Hash.hpp>
+#include <EngineCore/Reflection/TypeDescriptorArray.hpp>
+#include <EngineCore/Reflection/TypeDescriptorStruct.hpp>
+#include <EngineCore/Reflection/TypeDescriptorVector.hpp>
+
+namespace Grindstone::SceneManagement {
+	/*
+	 * The layout of a cooked scene, which the build writes in place of the scene's json so it can be
+	 * loaded without parsing. Components are grouped into one block per component type, so each type is
+	 * created for all of its entities at once. Every section starts at a sixteen byte aligned offset.
+	 */
+	struct CookedSceneFile {
+		const static uint32_t CURRENT_VERSION = 1;
+		const static uint64_t SECTION_ALIGNMENT = 16;
+
+		struct Header {
+			const char signature[4] = { 'G', 'S', 'C', 'N' };
+			uint32_t version = CURRENT_VERSION;
+			uint32_t headerSize = sizeof(Header);
+			uint32_t entityCount = 0;
+			uint32_t componentBlockCount = 0;
+			// Offsets of strings are from the start of the strings section.
+			uint32_t nameOffset = 0;
+			uint32_t nameSize = 0;
+			uint32_t reserved = 0;
+			uint64_t entitiesOffset = 0;
+			uint64_t componentBlocksOffset = 0;
+			uint64_t stringsOffset = 0;
+			uint64_t stringsSize = 0;
+		};
+
+		enum class ComponentBlockLayout : uint8_t {
+			// The block holds componentSize bytes per entity, which are copied straight into the components.
+			CopiedComponents = 0,
+			// Each component holds a uint32_t record count, then records of a uint32_t member index followed by the member's value.
+			MemberRecords
+		};
+
+		struct ComponentBlock {
+			// Hash::MurmurOAAT64 of the component's name, which is also its HashedString.
+			uint64_t componentHash;
+			// The component's layout when the scene was cooked, from ComputeComponentLayoutHash.
+			uint64_t layoutHash;
+			// The entities that have this component, as uint32_t entity ids.
+			uint64_t entitiesOffset;
+			uint64_t dataOffset;
+			uint64_t dataSize;
+			uint32_t entityCount;
+			uint32_t componentSize;
+			uint32_t nameOffset;
+			uint16_t nameSize;
+			ComponentBlockLayout layout;
+			uint8_t reserved = 0;
+		};
+	};
+
+	static_assert(sizeof(CookedSceneFile::Header) == 64, "The cooked scene header must not contain padding.");
+	static_assert(sizeof(CookedSceneFile::ComponentBlock) == 56, "The cooked scene component block must not contain padding.");
+
+	inline uint64_t CombineComponentLayoutHash(uint64_t hash, const Reflection::TypeDescriptor* type) {
+		const uint64_t typeData[] = { static_cast<uint64_t>(type->type), type->size };
+		hash = Hash::CombineMurmurOAAT64(hash, reinterpret_cast<const char*>(typeData), sizeof(typeData));
+
+		if (type->type == Reflection::TypeDescriptor::ReflectionTypeData::Vector) {
+			return CombineComponentLayoutHash(hash, static_cast<const Reflection::TypeDescriptor_StdVector*>(type)->itemType);
+		}
+
+		if (type->type == Reflection::TypeDescriptor::ReflectionTypeData::FixedArray) {
+			return CombineComponentLayoutHash(hash, static_cast<const Reflection::TypeDescriptor_FixedArray*>(type)->itemType);
+		}
+
+		return hash;
+	}
+
+	// Changes whenever a component's size or its reflected members change, which makes cooked blocks of it unusable.
+	inline uint64_t ComputeComponentLayoutHash(const Reflection::TypeDescriptor_Struct& reflectionData) {
+		const uint64_t componentSize = reflectionData.size;
+		uint64_t hash = Hash::MurmurOAAT64(reinterpret_cast<const char*>(&componentSize), sizeof(componentSize));
+		for (const Reflection::TypeDescriptor_Struct::Member& member : reflectionData.category.members) {
+			const uint64_t offset = member.offset;
+			hash = Hash::CombineMurmurOAAT64(hash, member.storedName.data(), member.storedName.size());
+			hash = Hash::CombineMurmurOAAT64(hash, reinterpret_cast<const char*>(&offset), sizeof(offset));
+			hash = CombineComponentLayoutHash(hash, member.type);
+		}
+
+		return hash;
+	}
+}
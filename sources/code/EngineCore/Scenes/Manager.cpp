@@ -1,9 +1,11 @@
 #include <EngineCore/EngineCore.hpp>
+#include <EngineCore/Logger.hpp>
 #include <EngineCore/Assets/AssetManager.hpp>
 #include <EngineCore/BuildSettings/SceneBuildSettings.hpp>
 #include <EngineCore/Profiling.hpp>
 #include <EngineCore/Utils/MemoryAllocator.hpp>
 
+#include "SceneLoaderBinary.hpp"
 #include "SceneLoaderJson.hpp"
 #include "SceneWriterJson.hpp"
 #include "Manager.hpp"
@@ -47,7 +49,20 @@ Scene* SceneManager::LoadScene(Grindstone::Uuid uuid) {
 Scene* SceneManager::LoadSceneAdditively(Grindstone::Uuid uuid) {
 	Scene* newScene = AllocatorCore::Allocate<Scene>();
 	scenes[uuid] = newScene;
-	SceneLoaderJson sceneLoader(newScene, uuid);
+
+	// Built games hold cooked scenes, while the editor loads the json it saves.
+	Assets::AssetLoadBinaryResult result = EngineCore::GetInstance().assetManager->LoadBinaryByUuid(AssetType::Scene, uuid);
+	if (result.status != Assets::AssetLoadStatus::Success) {
+		GPRINT_ERROR_V(LogSource::EngineCore, "Could not find scene with id {}.", uuid.ToString());
+	}
+	else if (SceneLoaderBinary::IsCookedScene(result.buffer.Get(), result.buffer.GetCapacity())) {
+		SceneLoaderBinary sceneLoader(newScene, uuid, result.displayName, result.buffer.Get(), result.buffer.GetCapacity());
+	}
+	else {
+		std::string_view content(reinterpret_cast<const char*>(result.buffer.Get()), result.buffer.GetCapacity());
+		SceneLoaderJson sceneLoader(newScene, uuid, result.displayName, content);
+	}
+
 	ProcessSceneAfterLoading(newScene);
 
 	return newScene;
@@ -81,9 +96,16 @@ Scene* SceneManager::CreateEmptySceneAdditively(const char *name) {
 }
 
 void SceneManager::CloseActiveScenes() {
+	// Cells are scenes too, and their entities must be destroyed while the components they use are still registered.
+	cellStreamer.UnloadAllCells();
+
 	for (auto& scene : scenes) {
 		AllocatorCore::Free(scene.second);
 	}
 
 	scenes.clear();
 }
+
+CellStreamer& SceneManager::GetCellStreamer() {
+	return cellStreamer;
+}
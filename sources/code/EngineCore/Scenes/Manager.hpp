@@ -5,6 +5,7 @@
 
 #include <Common/ResourcePipeline/Uuid.hpp>
 
+#include "CellStreamer.hpp"
 #include "Scene.hpp"
 
 namespace Grindstone::SceneManagement {
@@ -21,10 +22,12 @@ namespace Grindstone::SceneManagement {
 		virtual Scene* CreateEmptyScene(const char* name);
 		virtual Scene* CreateEmptySceneAdditively(const char* name);
 		virtual void CloseActiveScenes();
+		virtual CellStreamer& GetCellStreamer();
 		std::map<Grindstone::Uuid, Scene*> scenes;
 	private:
 
 		void ProcessSceneAfterLoading(Scene* scene);
 		std::vector<std::function<void(Scene*)>> postLoadProcesses;
+		CellStreamer cellStreamer;
 	};
 }
@@ -16,9 +16,11 @@ namespace Grindstone {
 	}
 
 	namespace SceneManagement {
+		class SceneLoaderBinary;
 		class SceneLoaderJson;
 
 		class Scene {
+			friend SceneLoaderBinary;
 			friend SceneLoaderJson;
 		private:
 			std::string name;
@@ -0,0 +1,546 @@
+#include <algorithm>
+#include <cstring>
+
+#include <rapidjson/document.h>
+
+#include <Common/Hash.hpp>
+#include <Common/Math.hpp>
+#include <Common/PhysicsLayer.hpp>
+#include <Common/ResourcePipeline/Uuid.hpp>
+#include <EngineCore/CoreComponents/Parent/ParentComponent.hpp>
+#include <EngineCore/CoreComponents/Tag/TagComponent.hpp>
+#include <EngineCore/CoreComponents/Transform/TransformComponent.hpp>
+#include <EngineCore/ECS/ComponentRegistrar.hpp>
+#include <EngineCore/Logger.hpp>
+#include <EngineCore/Reflection/TypeDescriptorAsset.hpp>
+
+#include "SceneCooker.hpp"
+
+using namespace Grindstone;
+using namespace Grindstone::SceneManagement;
+
+using ReflectionTypeData = Reflection::TypeDescriptor::ReflectionTypeData;
+
+template<typename T>
+static bool WriteInt(void* destination, const rapidjson::Value& value) {
+	if (!value.IsInt64()) {
+		return false;
+	}
+
+	*static_cast<T*>(destination) = static_cast<T>(value.GetInt64());
+	return true;
+}
+
+template<typename T>
+static bool WriteUint(void* destination, const rapidjson::Value& value) {
+	if (!value.IsUint64()) {
+		return false;
+	}
+
+	*static_cast<T*>(destination) = static_cast<T>(value.GetUint64());
+	return true;
+}
+
+template<typename T>
+static bool WriteFloat(void* destination, const rapidjson::Value& value) {
+	if (!value.IsNumber()) {
+		return false;
+	}
+
+	*static_cast<T*>(destination) = static_cast<T>(value.GetDouble());
+	return true;
+}
+
+template<typename T>
+static bool WriteIntArray(const rapidjson::Value& value, T* destination, rapidjson::SizeType count) {
+	if (!value.IsArray() || value.Size() < count) {
+		return false;
+	}
+
+	for (rapidjson::SizeType i = 0; i < count; ++i) {
+		if (!value[i].IsInt()) {
+			return false;
+		}
+
+		destination[i] = static_cast<T>(value[i].GetInt());
+	}
+
+	return true;
+}
+
+template<typename T>
+static bool WriteUintArray(const rapidjson::Value& value, T* destination, rapidjson::SizeType count) {
+	if (!value.IsArray() || value.Size() < count) {
+		return false;
+	}
+
+	for (rapidjson::SizeType i = 0; i < count; ++i) {
+		if (!value[i].IsUint()) {
+			return false;
+		}
+
+		destination[i] = static_cast<T>(value[i].GetUint());
+	}
+
+	return true;
+}
+
+template<typename T>
+static bool WriteFloatArray(const rapidjson::Value& value, T* destination, rapidjson::SizeType count) {
+	if (!value.IsArray() || value.Size() < count) {
+		return false;
+	}
+
+	for (rapidjson::SizeType i = 0; i < count; ++i) {
+		if (!value[i].IsNumber()) {
+			return false;
+		}
+
+		destination[i] = static_cast<T>(value[i].GetDouble());
+	}
+
+	return true;
+}
+
+// Writes a value of a type that's stored as its bytes. Returns false for any other type, or if the json doesn't match the type.
+static bool WriteRawValue(void* destination, const Reflection::TypeDescriptor* type, const rapidjson::Value& value) {
+	switch (type->type) {
+	case ReflectionTypeData::Bool:
+		if (!value.IsBool()) {
+			return false;
+		}
+
+		*static_cast<bool*>(destination) = value.GetBool();
+		return true;
+	case ReflectionTypeData::Entity:
+		if (!value.IsUint()) {
+			return false;
+		}
+
+		*static_cast<entt::entity*>(destination) = static_cast<entt::entity>(value.GetUint());
+		return true;
+	case ReflectionTypeData::PhysicsLayer:
+		if (!value.IsUint()) {
+			return false;
+		}
+
+		static_cast<Grindstone::Physics::Layer*>(destination)->layer = static_cast<uint8_t>(value.GetUint());
+		return true;
+	case ReflectionTypeData::PhysicsLayerMask:
+		if (!value.IsUint()) {
+			return false;
+		}
+
+		static_cast<Grindstone::Physics::LayerMask*>(destination)->mask = static_cast<uint32_t>(value.GetUint());
+		return true;
+	case ReflectionTypeData::Int8:
+		return WriteInt<int8_t>(destination, value);
+	case ReflectionTypeData::Int16:
+		return WriteInt<int16_t>(destination, value);
+	case ReflectionTypeData::Int32:
+		return WriteInt<int32_t>(destination, value);
+	case ReflectionTypeData::Int64:
+		return WriteInt<int64_t>(destination, value);
+	case ReflectionTypeData::Uint8:
+		return WriteUint<uint8_t>(destination, value);
+	case ReflectionTypeData::Uint16:
+		return WriteUint<uint16_t>(destination, value);
+	case ReflectionTypeData::Uint32:
+		return WriteUint<uint32_t>(destination, value);
+	case ReflectionTypeData::Uint64:
+		return WriteUint<uint64_t>(destination, value);
+	case ReflectionTypeData::Int2:
+		return WriteIntArray(value, static_cast<int*>(destination), 2);
+	case ReflectionTypeData::Int3:
+		return WriteIntArray(value, static_cast<int*>(destination), 3);
+	case ReflectionTypeData::Int4:
+		return WriteIntArray(value, static_cast<int*>(destination), 4);
+	case ReflectionTypeData::Uint2:
+		return WriteUintArray(value, static_cast<uint32_t*>(destination), 2);
+	case ReflectionTypeData::Uint3:
+		return WriteUintArray(value, static_cast<uint32_t*>(destination), 3);
+	case ReflectionTypeData::Uint4:
+		return WriteUintArray(value, static_cast<uint32_t*>(destination), 4);
+	case ReflectionTypeData::Float:
+		return WriteFloat<float>(destination, value);
+	case ReflectionTypeData::Float2:
+		return WriteFloatArray(value, static_cast<float*>(destination), 2);
+	case ReflectionTypeData::Float3:
+		return WriteFloatArray(value, static_cast<float*>(destination), 3);
+	case ReflectionTypeData::Float4:
+	case ReflectionTypeData::Quaternion:
+		return WriteFloatArray(value, static_cast<float*>(destination), 4);
+	case ReflectionTypeData::Double:
+		return WriteFloat<double>(destination, value);
+	case ReflectionTypeData::Double2:
+		return WriteFloatArray(value, static_cast<double*>(destination), 2);
+	case ReflectionTypeData::Double3:
+		return WriteFloatArray(value, static_cast<double*>(destination), 3);
+	case ReflectionTypeData::Double4:
+		return WriteFloatArray(value, static_cast<double*>(destination), 4);
+	default:
+		return false;
+	}
+}
+
+// Writes a member straight into the bytes of a trivially copyable component.
+static bool WriteCopiedValue(void* destination, const Reflection::TypeDescriptor* type, const rapidjson::Value& value) {
+	if (type->type != ReflectionTypeData::FixedArray) {
+		return WriteRawValue(destination, type, value);
+	}
+
+	auto arrayType = static_cast<const Reflection::TypeDescriptor_FixedArray*>(type);
+	if (!value.IsArray()) {
+		return false;
+	}
+
+	const size_t count = std::min(static_cast<size_t>(value.Size()), arrayType->size);
+	for (rapidjson::SizeType i = 0; i < count; ++i) {
+		if (!WriteCopiedValue(arrayType->getItem(destination, i), arrayType->itemType, value[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void AppendBytes(std::vector<Byte>& data, const void* source, size_t size) {
+	const Byte* sourceBytes = static_cast<const Byte*>(source);
+	data.insert(data.end(), sourceBytes, sourceBytes + size);
+}
+
+template<typename T>
+static void AppendValue(std::vector<Byte>& data, const T& value) {
+	AppendBytes(data, &value, sizeof(T));
+}
+
+// Encodes a member as ComponentBlockLoader reads it from a member records block.
+static bool EncodeValue(std::vector<Byte>& data, const Reflection::TypeDescriptor* type, const rapidjson::Value& value) {
+	switch (type->type) {
+	case ReflectionTypeData::Struct:
+		return false;
+	case ReflectionTypeData::String: {
+		if (!value.IsString()) {
+			return false;
+		}
+
+		AppendValue(data, static_cast<uint32_t>(value.GetStringLength()));
+		AppendBytes(data, value.GetString(), value.GetStringLength());
+		return true;
+	}
+	case ReflectionTypeData::AssetReference: {
+		if (!value.IsString()) {
+			return false;
+		}
+
+		// Resolved now, so loading doesn't parse uuids. An invalid uuid is kept as an empty reference.
+		Grindstone::Uuid uuid;
+		if (!Grindstone::Uuid::MakeFromString(value.GetString(), uuid)) {
+			GPRINT_ERROR(LogSource::EngineCore, "Invalid UUID in entity!");
+			uuid = Grindstone::Uuid();
+		}
+
+		AppendBytes(data, &uuid, sizeof(uuid));
+		return true;
+	}
+	case ReflectionTypeData::Vector:
+	case ReflectionTypeData::FixedArray: {
+		if (!value.IsArray()) {
+			return false;
+		}
+
+		const Reflection::TypeDescriptor* itemType = nullptr;
+		size_t count = value.Size();
+		if (type->type == ReflectionTypeData::Vector) {
+			itemType = static_cast<const Reflection::TypeDescriptor_StdVector*>(type)->itemType;
+		}
+		else {
+			auto arrayType = static_cast<const Reflection::TypeDescriptor_FixedArray*>(type);
+			itemType = arrayType->itemType;
+			count = std::min(count, arrayType->size);
+		}
+
+		AppendValue(data, static_cast<uint32_t>(count));
+		for (rapidjson::SizeType i = 0; i < count; ++i) {
+			if (!EncodeValue(data, itemType, value[i])) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+	default: {
+		const size_t valueOffset = data.size();
+		data.resize(valueOffset + type->size);
+		return WriteRawValue(data.data() + valueOffset, type, value);
+	}
+	}
+}
+
+static uint64_t AlignCookedSection(std::vector<Byte>& data) {
+	const uint64_t alignment = CookedSceneFile::SECTION_ALIGNMENT;
+	data.resize((data.size() + alignment - 1) / alignment * alignment);
+	return data.size();
+}
+
+
+CookedSceneFile::ComponentBlockLayout SceneCooker::CookedBlock::GetLayout() const {
+	return componentType->constructCopyableComponentFn != nullptr
+		? CookedSceneFile::ComponentBlockLayout::CopiedComponents
+		: CookedSceneFile::ComponentBlockLayout::MemberRecords;
+}
+
+ComponentBlockView SceneCooker::CookedBlock::GetView() const {
+	ComponentBlockView blockView;
+	blockView.componentHash = componentType->hash;
+	blockView.layoutHash = componentType->layoutHash;
+	blockView.componentName = componentType->name;
+	blockView.layout = GetLayout();
+	blockView.componentSize = static_cast<uint32_t>(componentType->reflectionData.size);
+	blockView.entities = entities.data();
+	blockView.entityCount = static_cast<uint32_t>(entities.size());
+	blockView.data = data.data();
+	blockView.dataSize = data.size();
+	return blockView;
+}
+
+SceneCooker::SceneCooker(ECS::ComponentRegistrar& componentRegistrar) {
+	for (auto& [componentName, componentFunctions] : componentRegistrar) {
+		ComponentType& componentType = componentTypes[componentName.GetHash()];
+		componentType.name = componentName.ToString();
+		componentType.hash = componentName.GetHash();
+		componentType.reflectionData = componentFunctions.GetComponentReflectionDataFn();
+		componentType.layoutHash = ComputeComponentLayoutHash(componentType.reflectionData);
+		componentType.constructCopyableComponentFn = componentFunctions.ConstructCopyableComponentFn;
+
+		const std::vector<Reflection::TypeDescriptor_Struct::Member>& members = componentType.reflectionData.category.members;
+		for (uint32_t memberIndex = 0; memberIndex < members.size(); ++memberIndex) {
+			componentType.memberIndexByStoredName[members[memberIndex].storedName] = memberIndex;
+		}
+	}
+}
+
+const SceneCooker::ComponentType* SceneCooker::FindComponentType(uint64_t componentHash) const {
+	auto componentTypeIterator = componentTypes.find(componentHash);
+	return componentTypeIterator != componentTypes.end()
+		? &componentTypeIterator->second
+		: nullptr;
+}
+
+bool SceneCooker::Cook(std::string_view sceneJson, std::vector<Byte>& outCookedScene) const {
+	rapidjson::Document document;
+	if (document.Parse(sceneJson.data(), sceneJson.size()).HasParseError() || !document.IsObject()) {
+		return false;
+	}
+
+	if (!document.HasMember("entities") || !document["entities"].IsArray()) {
+		return false;
+	}
+
+	const rapidjson::Value& entitiesJson = document["entities"];
+	CookedEntities cookedEntities;
+	if (!CookEntities(entitiesJson, 0, entitiesJson.Size(), cookedEntities)) {
+		return false;
+	}
+
+	const char* sceneName = (document.HasMember("name") && document["name"].IsString())
+		? document["name"].GetString()
+		: "Untitled Scene";
+
+	WriteCookedScene(sceneName, cookedEntities, outCookedScene);
+	return true;
+}
+
+bool SceneCooker::CookEntities(const rapidjson::Value& entitiesJson, size_t begin, size_t end, CookedEntities& outCookedEntities) const {
+	// There's at most one block per component type, so reserving for all of them keeps pointers to blocks valid.
+	std::vector<CookedBlock>& blocks = outCookedEntities.blocks;
+	blocks.clear();
+	blocks.reserve(componentTypes.size());
+	std::unordered_map<uint64_t, size_t> blockIndexByHash;
+
+	std::vector<uint32_t>& entities = outCookedEntities.entities;
+	entities.clear();
+	entities.reserve(end - begin);
+
+	// A component of the entity being cooked. It's always the last component of its block, so its records can be appended to the block's data.
+	struct CookedComponent {
+		CookedBlock* block;
+		size_t dataOffset;
+	};
+
+	// Entities only have a handful of components, so they're found with a linear search rather than a map per entity.
+	std::vector<std::pair<uint64_t, CookedComponent>> entityComponents;
+
+	auto getOrAddComponent = [&](uint64_t componentHash, uint32_t entity) -> CookedComponent {
+		for (const auto& [entityComponentHash, entityComponent] : entityComponents) {
+			if (entityComponentHash == componentHash) {
+				return entityComponent;
+			}
+		}
+
+		auto componentTypeIterator = componentTypes.find(componentHash);
+		if (componentTypeIterator == componentTypes.end()) {
+			return CookedComponent{ nullptr, 0 };
+		}
+
+		const ComponentType& componentType = componentTypeIterator->second;
+		auto [blockIndexIterator, isNewBlock] = blockIndexByHash.try_emplace(componentHash, blocks.size());
+		if (isNewBlock) {
+			blocks.emplace_back().componentType = &componentType;
+		}
+
+		CookedBlock& block = blocks[blockIndexIterator->second];
+		const size_t dataOffset = block.data.size();
+		block.entities.push_back(entity);
+		if (componentType.constructCopyableComponentFn != nullptr) {
+			block.data.resize(dataOffset + componentType.reflectionData.size);
+			componentType.constructCopyableComponentFn(block.data.data() + dataOffset);
+		}
+		else {
+			AppendValue(block.data, uint32_t(0));
+		}
+
+		const CookedComponent component{ &block, dataOffset };
+		entityComponents.emplace_back(componentHash, component);
+		return component;
+	};
+
+	auto setParameter = [](const CookedComponent& component, const char* parameterKey, const rapidjson::Value& parameter) {
+		const ComponentType& componentType = *component.block->componentType;
+		auto memberIndexIterator = componentType.memberIndexByStoredName.find(parameterKey);
+		if (memberIndexIterator == componentType.memberIndexByStoredName.end()) {
+			return;
+		}
+
+		const uint32_t memberIndex = memberIndexIterator->second;
+		const Reflection::TypeDescriptor_Struct::Member& member = componentType.reflectionData.category.members[memberIndex];
+		std::vector<Byte>& data = component.block->data;
+		bool wasWritten = false;
+		if (componentType.constructCopyableComponentFn != nullptr) {
+			wasWritten = WriteCopiedValue(data.data() + component.dataOffset + member.offset, member.type, parameter);
+		}
+		else {
+			const size_t recordOffset = data.size();
+			AppendValue(data, memberIndex);
+			wasWritten = EncodeValue(data, member.type, parameter);
+			if (wasWritten) {
+				uint32_t recordCount = 0;
+				std::memcpy(&recordCount, data.data() + component.dataOffset, sizeof(recordCount));
+				++recordCount;
+				std::memcpy(data.data() + component.dataOffset, &recordCount, sizeof(recordCount));
+			}
+			else {
+				data.resize(recordOffset);
+			}
+		}
+
+		if (!wasWritten) {
+			GPRINT_ERROR_V(LogSource::EngineCore, "Skipped member '{}' of component '{}' while cooking scene, as its value doesn't match its type '{}'.", member.storedName, componentType.name, member.type->GetFullName());
+		}
+	};
+
+	const rapidjson::Value defaultTag(rapidjson::StringRef("New Entity"));
+	for (size_t entityIndex = begin; entityIndex < end; ++entityIndex) {
+		const rapidjson::Value& entityJson = entitiesJson[static_cast<rapidjson::SizeType>(entityIndex)];
+		if (!entityJson.IsObject() || !entityJson.HasMember("entityId") || !entityJson["entityId"].IsUint()) {
+			return false;
+		}
+
+		const uint32_t entity = entityJson["entityId"].GetUint();
+		entities.push_back(entity);
+		entityComponents.clear();
+
+		// Every entity starts with the same components Scene::CreateEntity gives it.
+		CookedComponent tagComponent = getOrAddComponent(TagComponent::GetComponentHashString().GetHash(), entity);
+		if (tagComponent.block != nullptr) {
+			setParameter(tagComponent, "tag", defaultTag);
+		}
+
+		getOrAddComponent(TransformComponent::GetComponentHashString().GetHash(), entity);
+		getOrAddComponent(ParentComponent::GetComponentHashString().GetHash(), entity);
+
+		if (!entityJson.HasMember("components") || !entityJson["components"].IsArray()) {
+			continue;
+		}
+
+		for (const rapidjson::Value& componentJson : entityJson["components"].GetArray()) {
+			if (!componentJson.IsObject() || !componentJson.HasMember("component") || !componentJson["component"].IsString()) {
+				continue;
+			}
+
+			const rapidjson::Value& componentName = componentJson["component"];
+			const uint64_t componentHash = Hash::MurmurOAAT64(componentName.GetString(), componentName.GetStringLength());
+			const CookedComponent component = getOrAddComponent(componentHash, entity);
+			if (component.block == nullptr) {
+				GPRINT_WARN_V(LogSource::EngineCore, "Skipped unregistered component '{}' while cooking scene.", componentName.GetString());
+				continue;
+			}
+
+			if (!componentJson.HasMember("params") || !componentJson["params"].IsObject()) {
+				continue;
+			}
+
+			const rapidjson::Value& parameterList = componentJson["params"];
+			for (auto parameter = parameterList.MemberBegin(); parameter != parameterList.MemberEnd(); ++parameter) {
+				setParameter(component, parameter->name.GetString(), parameter->value);
+			}
+		}
+	}
+
+	return true;
+}
+
+void SceneCooker::WriteCookedScene(std::string_view sceneName, const CookedEntities& cookedEntities, std::vector<Byte>& outCookedScene) const {
+	const std::vector<uint32_t>& entities = cookedEntities.entities;
+	const std::vector<CookedBlock>& blocks = cookedEntities.blocks;
+
+	std::vector<Byte>& data = outCookedScene;
+	data.clear();
+
+	CookedSceneFile::Header header;
+	header.entityCount = static_cast<uint32_t>(entities.size());
+	header.componentBlockCount = static_cast<uint32_t>(blocks.size());
+	data.resize(sizeof(header));
+
+	header.entitiesOffset = AlignCookedSection(data);
+	AppendBytes(data, entities.data(), entities.size() * sizeof(uint32_t));
+
+	header.componentBlocksOffset = AlignCookedSection(data);
+	data.resize(data.size() + blocks.size() * sizeof(CookedSceneFile::ComponentBlock));
+
+	std::string strings(sceneName);
+	header.nameOffset = 0;
+	header.nameSize = static_cast<uint32_t>(strings.size());
+
+	std::vector<CookedSceneFile::ComponentBlock> blockHeaders(blocks.size());
+	for (size_t blockIndex = 0; blockIndex < blocks.size(); ++blockIndex) {
+		const CookedBlock& block = blocks[blockIndex];
+		const ComponentType& componentType = *block.componentType;
+		CookedSceneFile::ComponentBlock& blockHeader = blockHeaders[blockIndex];
+		blockHeader.componentHash = componentType.hash;
+		blockHeader.layoutHash = componentType.layoutHash;
+		blockHeader.entityCount = static_cast<uint32_t>(block.entities.size());
+		blockHeader.nameOffset = static_cast<uint32_t>(strings.size());
+		blockHeader.nameSize = static_cast<uint16_t>(componentType.name.size());
+		strings += componentType.name;
+
+		blockHeader.entitiesOffset = AlignCookedSection(data);
+		AppendBytes(data, block.entities.data(), block.entities.size() * sizeof(uint32_t));
+
+		blockHeader.layout = block.GetLayout();
+		blockHeader.componentSize = blockHeader.layout == CookedSceneFile::ComponentBlockLayout::CopiedComponents
+			? static_cast<uint32_t>(componentType.reflectionData.size)
+			: 0;
+
+		blockHeader.dataOffset = AlignCookedSection(data);
+		blockHeader.dataSize = block.data.size();
+		AppendBytes(data, block.data.data(), block.data.size());
+	}
+
+	header.stringsOffset = AlignCookedSection(data);
+	header.stringsSize = strings.size();
+	AppendBytes(data, strings.data(), strings.size());
+
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + header.componentBlocksOffset, blockHeaders.data(), blockHeaders.size() * sizeof(CookedSceneFile::ComponentBlock));
+}
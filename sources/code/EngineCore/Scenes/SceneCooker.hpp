@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <rapidjson/document.h>
+
+#include <Common/IntTypes.hpp>
+#include <EngineCore/ECS/ComponentFunctions.hpp>
+#include <EngineCore/Reflection/TypeDescriptorStruct.hpp>
+
+#include "ComponentBlockLoader.hpp"
+#include "CookedSceneFile.hpp"
+
+namespace Grindstone::ECS {
+	class ComponentRegistrar;
+}
+
+namespace Grindstone::SceneManagement {
+	/*
+	 * Turns the entities of json scenes into component blocks (see CookedSceneFile) using the reflection
+	 * data of the registered components. The build writes them out as cooked scenes, and SceneLoaderJson
+	 * cooks ranges of entities on worker threads while loading. The components are gathered when the
+	 * cooker is created, which must be on the main thread, after which it can be used from any thread.
+	 */
+	class SceneCooker {
+	public:
+		struct ComponentType {
+			std::string name;
+			uint64_t hash = 0;
+			uint64_t layoutHash = 0;
+			Reflection::TypeDescriptor_Struct reflectionData;
+			std::unordered_map<std::string, uint32_t> memberIndexByStoredName;
+			// Only set for trivially copyable components, which are cooked as their bytes.
+			ECS::ConstructCopyableComponentFn constructCopyableComponentFn = nullptr;
+		};
+
+		struct CookedBlock {
+			const ComponentType* componentType = nullptr;
+			std::vector<uint32_t> entities;
+			// Laid out the same way as the data of a block in a cooked scene.
+			std::vector<Byte> data;
+
+			CookedSceneFile::ComponentBlockLayout GetLayout() const;
+			// Only valid while the block is alive and unchanged.
+			ComponentBlockView GetView() const;
+		};
+
+		struct CookedEntities {
+			std::vector<uint32_t> entities;
+			// In the order their components first appear, so the same json always cooks the same way.
+			std::vector<CookedBlock> blocks;
+		};
+
+		SceneCooker(ECS::ComponentRegistrar& componentRegistrar);
+
+		// Returns false if the json couldn't be parsed as a scene.
+		bool Cook(std::string_view sceneJson, std::vector<Byte>& outCookedScene) const;
+		// Cooks the entities in [begin, end) of a scene's entity array. Returns false if any of them isn't an entity.
+		bool CookEntities(const rapidjson::Value& entitiesJson, size_t begin, size_t end, CookedEntities& outCookedEntities) const;
+		// Returns nullptr if no component with that hash was registered when the cooker was created.
+		const ComponentType* FindComponentType(uint64_t componentHash) const;
+
+	private:
+		void WriteCookedScene(std::string_view sceneName, const CookedEntities& cookedEntities, std::vector<Byte>& outCookedScene) const;
+
+		std::unordered_map<uint64_t, ComponentType> componentTypes;
+	};
+}
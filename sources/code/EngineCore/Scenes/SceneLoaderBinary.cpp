@@ -0,0 +1,153 @@
+#include <cstring>
+#include <string>
+
+#include "EngineCore/Profiling.hpp"
+#include <EngineCore/Logger.hpp>
+
+#include "ComponentBlockLoader.hpp"
+#include "SceneLoaderBinary.hpp"
+#include "Scene.hpp"
+
+using namespace Grindstone;
+using namespace Grindstone::SceneManagement;
+
+// Whether a section of count elements of T starting at offset lies inside the file and is aligned for T.
+template<typename T>
+static bool IsSectionValid(uint64_t fileSize, uint64_t offset, uint64_t count) {
+	return
+		offset % alignof(T) == 0 &&
+		offset <= fileSize &&
+		count <= (fileSize - offset) / sizeof(T);
+}
+
+bool SceneLoaderBinary::IsCookedScene(const Byte* data, uint64_t size) {
+	return size >= sizeof(CookedSceneFile::Header) && strncmp(reinterpret_cast<const char*>(data), "GSCN", 4) == 0;
+}
+
+SceneLoaderBinary::SceneLoaderBinary(
+	Scene* scene,
+	Grindstone::Uuid uuid,
+	std::string_view displayName,
+	const Byte* data,
+	uint64_t size
+) : scene(scene), uuid(uuid) {
+	Load(displayName, data, size);
+}
+
+bool SceneLoaderBinary::Load(std::string_view displayName, const Byte* data, uint64_t size) {
+	scene->path = displayName;
+
+	// Sections are read in place, which needs the file to be as aligned as it was when it was cooked.
+	if (reinterpret_cast<uintptr_t>(data) % CookedSceneFile::SECTION_ALIGNMENT != 0) {
+		alignedFileData.assign(data, data + size);
+		data = alignedFileData.data();
+	}
+
+	SceneBlocks sceneBlocks;
+	if (!ReadCookedScene(data, size, sceneBlocks)) {
+		GPRINT_ERROR_V(LogSource::EngineCore, "Failed to load scene '{}' with id {} - it isn't a valid cooked scene of this version.", displayName, uuid.ToString());
+		return false;
+	}
+
+	GPRINT_INFO_V(LogSource::EngineCore, "Loading scene '{}' with id {}.", displayName, uuid.ToString());
+
+	ProcessMeta(sceneBlocks);
+	ProcessEntities(sceneBlocks);
+
+	return true;
+}
+
+bool SceneLoaderBinary::ReadCookedScene(const Byte* data, uint64_t size, SceneBlocks& outSceneBlocks) {
+	if (reinterpret_cast<uintptr_t>(data) % CookedSceneFile::SECTION_ALIGNMENT != 0 || !IsValid(data, size)) {
+		return false;
+	}
+
+	const CookedSceneFile::Header* header = reinterpret_cast<const CookedSceneFile::Header*>(data);
+	outSceneBlocks.name = GetString(data, *header, header->nameOffset, header->nameSize);
+	outSceneBlocks.entities = reinterpret_cast<const uint32_t*>(data + header->entitiesOffset);
+	outSceneBlocks.entityCount = header->entityCount;
+
+	const CookedSceneFile::ComponentBlock* blocks = reinterpret_cast<const CookedSceneFile::ComponentBlock*>(data + header->componentBlocksOffset);
+	outSceneBlocks.blocks.resize(header->componentBlockCount);
+	for (uint32_t blockIndex = 0; blockIndex < header->componentBlockCount; ++blockIndex) {
+		const CookedSceneFile::ComponentBlock& block = blocks[blockIndex];
+		ComponentBlockView& blockView = outSceneBlocks.blocks[blockIndex];
+		blockView.componentHash = block.componentHash;
+		blockView.layoutHash = block.layoutHash;
+		blockView.componentName = GetString(data, *header, block.nameOffset, block.nameSize);
+		blockView.layout = block.layout;
+		blockView.componentSize = block.componentSize;
+		blockView.entities = reinterpret_cast<const uint32_t*>(data + block.entitiesOffset);
+		blockView.entityCount = block.entityCount;
+		blockView.data = data + block.dataOffset;
+		blockView.dataSize = block.dataSize;
+	}
+
+	return true;
+}
+
+bool SceneLoaderBinary::IsValid(const Byte* fileData, uint64_t fileSize) {
+	if (!IsCookedScene(fileData, fileSize)) {
+		return false;
+	}
+
+	const CookedSceneFile::Header* fileHeader = reinterpret_cast<const CookedSceneFile::Header*>(fileData);
+	if (fileHeader->version != CookedSceneFile::CURRENT_VERSION || fileHeader->headerSize != sizeof(CookedSceneFile::Header)) {
+		return false;
+	}
+
+	const bool areSectionsValid =
+		IsSectionValid<uint32_t>(fileSize, fileHeader->entitiesOffset, fileHeader->entityCount) &&
+		IsSectionValid<CookedSceneFile::ComponentBlock>(fileSize, fileHeader->componentBlocksOffset, fileHeader->componentBlockCount) &&
+		IsSectionValid<char>(fileSize, fileHeader->stringsOffset, fileHeader->stringsSize);
+
+	if (!areSectionsValid) {
+		return false;
+	}
+
+	const CookedSceneFile::ComponentBlock* blocks = reinterpret_cast<const CookedSceneFile::ComponentBlock*>(fileData + fileHeader->componentBlocksOffset);
+	for (uint32_t blockIndex = 0; blockIndex < fileHeader->componentBlockCount; ++blockIndex) {
+		const CookedSceneFile::ComponentBlock& block = blocks[blockIndex];
+		if (
+			!IsSectionValid<uint32_t>(fileSize, block.entitiesOffset, block.entityCount) ||
+			!IsSectionValid<Byte>(fileSize, block.dataOffset, block.dataSize)
+		) {
+			return false;
+		}
+
+		if (
+			block.layout == CookedSceneFile::ComponentBlockLayout::CopiedComponents &&
+			block.dataSize != static_cast<uint64_t>(block.entityCount) * block.componentSize
+		) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void SceneLoaderBinary::ProcessMeta(const SceneBlocks& sceneBlocks) {
+	scene->name = sceneBlocks.name.empty()
+		? "Untitled Scene"
+		: sceneBlocks.name;
+}
+
+void SceneLoaderBinary::ProcessEntities(const SceneBlocks& sceneBlocks) {
+	GRIND_PROFILE_SCOPE("SceneLoaderBinary::ProcessEntities");
+
+	ComponentBlockLoader blockLoader(scene);
+	blockLoader.CreateEntities(sceneBlocks.entities, sceneBlocks.entityCount);
+	for (const ComponentBlockView& block : sceneBlocks.blocks) {
+		blockLoader.LoadBlock(block);
+	}
+
+	blockLoader.Finish();
+}
+
+std::string_view SceneLoaderBinary::GetString(const Byte* fileData, const CookedSceneFile::Header& header, uint32_t offset, uint32_t size) {
+	if (static_cast<uint64_t>(offset) + size > header.stringsSize) {
+		return {};
+	}
+
+	return std::string_view(reinterpret_cast<const char*>(fileData + header.stringsOffset + offset), size);
+}
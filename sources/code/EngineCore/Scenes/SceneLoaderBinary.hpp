@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include <Common/IntTypes.hpp>
+#include <Common/ResourcePipeline/Uuid.hpp>
+
+#include "ComponentBlockLoader.hpp"
+#include "CookedSceneFile.hpp"
+
+namespace Grindstone {
+	namespace SceneManagement {
+		class Scene;
+
+		/*
+		 * Loads a scene cooked by the build. Each component block is created for all of its entities at
+		 * once by ComponentBlockLoader, straight from the file, so nothing is looked up by name.
+		 */
+		class SceneLoaderBinary {
+		public:
+			// Whether the data is a cooked scene, rather than a json scene.
+			static bool IsCookedScene(const Byte* data, uint64_t size);
+			// Finds the entities and component blocks of a cooked scene, which must be aligned to CookedSceneFile::SECTION_ALIGNMENT. Returns false if it isn't a valid cooked scene.
+			static bool ReadCookedScene(const Byte* data, uint64_t size, SceneBlocks& outSceneBlocks);
+
+			SceneLoaderBinary(Scene*, Grindstone::Uuid uuid, std::string_view displayName, const Byte* data, uint64_t size);
+		private:
+			bool Load(std::string_view displayName, const Byte* data, uint64_t size);
+			static bool IsValid(const Byte* fileData, uint64_t fileSize);
+			static std::string_view GetString(const Byte* fileData, const CookedSceneFile::Header& header, uint32_t offset, uint32_t size);
+			void ProcessMeta(const SceneBlocks& sceneBlocks);
+			void ProcessEntities(const SceneBlocks& sceneBlocks);
+		private:
+			Scene* scene;
+			Grindstone::Uuid uuid;
+			// A copy of the scene, only made if it wasn't loaded at an aligned address.
+			std::vector<Byte> alignedFileData;
+		};
+	}
+}
@@ -1,38 +1,34 @@
 #pragma once
 
 #include <string>
-#include <map>
-#include <entt/entt.hpp>
+#include <string_view>
 #include <rapidjson/document.h>
 
 #include <Common/ResourcePipeline/Uuid.hpp>
 
-#include "../ECS/Entity.hpp"
-#include "../Reflection/TypeDescriptorStruct.hpp"
-
 namespace Grindstone {
 	namespace SceneManagement {
 		class Scene;
 
+		/*
+		 * Loads a json scene. The json is parsed in place, then its entities are cooked into component
+		 * blocks in chunks on worker threads, and finally created in bulk by ComponentBlockLoader.
+		 */
 		class SceneLoaderJson {
 		public:
 			SceneLoaderJson(Scene*, Grindstone::Uuid uuid);
+			// Loads a scene whose json has already been read.
+			SceneLoaderJson(Scene*, Grindstone::Uuid uuid, std::string_view displayName, std::string_view content);
 		private:
 			bool Load(Grindstone::Uuid uuid);
+			// Parses sceneJson and loads the scene from it.
+			bool Load(std::string_view displayName);
 			void ProcessMeta();
-			void ProcessEntities();
-
-			void ProcessEntity(rapidjson::Value& entity);
-			void ProcessComponent(ECS::Entity entity, rapidjson::Value& component);
-			void ProcessComponentParameter(
-				ECS::Entity entity,
-				void* componentPtr,
-				Reflection::TypeDescriptor_Struct& reflectionData,
-				const char* parameterKey,
-				rapidjson::Value& parameter
-			);
+			bool ProcessEntities();
 		private:
 			Scene* scene;
+			// Parsed in place, so the document's strings point into it rather than being copied.
+			std::string sceneJson;
 			rapidjson::Document document;
 			Grindstone::Uuid uuid;
 		};
@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <cstring>
 
 #include <Common/String.hpp>
@@ -17,7 +18,7 @@ void Grindstone::Memory::AllocatorCore::SetAllocatorState(Grindstone::Memory::Al
 }
 
 void* Grindstone::Memory::AllocatorCore::AllocateRaw(size_t size, size_t alignment, const char* debugName) {
-	return GetAllocatorState()->dynamicAllocator.AllocateRaw(size, alignment, debugName);
+	return GetAllocatorState()->allocator.AllocateRaw(size, alignment, debugName);
 }
 
 bool AllocatorCore::Initialize(size_t sizeInMegs) {
@@ -27,15 +28,22 @@ bool AllocatorCore::Initialize(size_t sizeInMegs) {
 	}
 
 	new (allocatorState) AllocatorState();
-	return allocatorState->dynamicAllocator.Initialize(sizeInMegs * 1024u * 1024u);
+	return allocatorState->allocator.Initialize(sizeInMegs * 1024u * 1024u);
 }
 
 void Grindstone::Memory::AllocatorCore::CloseAllocator() {
-	delete allocatorState;
+	if (allocatorState == nullptr) {
+		return;
+	}
+
+	// The state was created with malloc and placement new in Initialize.
+	allocatorState->~AllocatorState();
+	free(allocatorState);
+	allocatorState = nullptr;
 }
 
 Grindstone::StringRef AllocatorCore::AllocateString(size_t size) {
-	char* memory = static_cast<char*>(allocatorState->dynamicAllocator.AllocateRaw(size, alignof(std::string), "String"));
+	char* memory = static_cast<char*>(allocatorState->allocator.AllocateRaw(size, alignof(std::string), "String"));
 
 	return Grindstone::StringRef(memory, size);
 }
@@ -43,28 +51,73 @@ Grindstone::StringRef AllocatorCore::AllocateString(size_t size) {
 Grindstone::StringRef AllocatorCore::AllocateString(Grindstone::StringRef srcString) {
 	size_t srcStringLength = srcString.size() + 1;
 
-	char* memory = static_cast<char*>(allocatorState->dynamicAllocator.AllocateRaw(srcStringLength, alignof(std::string), "String"));
+	char* memory = static_cast<char*>(allocatorState->allocator.AllocateRaw(srcStringLength, alignof(std::string), "String"));
 	memcpy(memory, srcString.data(), srcStringLength);
 
 	return Grindstone::StringRef(memory, srcStringLength - 1);
 }
 
 bool AllocatorCore::FreeWithoutDestructor(void* memPtr) {
-	return allocatorState->dynamicAllocator.Free(memPtr);
+	return allocatorState->allocator.Free(memPtr);
+}
+
+bool AllocatorCore::InitializeFrameAllocator(uint32_t frameCount, size_t sizeInMegsPerFrame) {
+	CloseFrameAllocator();
+
+	const size_t totalSize = sizeInMegsPerFrame * 1024u * 1024u * frameCount;
+	void* memory = allocatorState->allocator.AllocateRaw(totalSize, alignof(std::max_align_t), "Frame Arenas");
+	if (memory == nullptr) {
+		return false;
+	}
+
+	allocatorState->frameAllocator.Initialize(memory, totalSize, frameCount);
+	return true;
+}
+
+void AllocatorCore::CloseFrameAllocator() {
+	void* memory = allocatorState->frameAllocator.GetMemory();
+	allocatorState->frameAllocator.Destroy();
+	if (memory != nullptr) {
+		allocatorState->allocator.Free(memory);
+	}
+}
+
+void AllocatorCore::BeginFrame() {
+	allocatorState->frameAllocator.BeginFrame();
+}
+
+void* AllocatorCore::AllocateFrameRaw(size_t size, size_t alignment) {
+	return allocatorState->frameAllocator.AllocateRaw(size, alignment);
+}
+
+uint32_t AllocatorCore::GetFrameCount() {
+	return allocatorState->frameAllocator.GetFrameCount();
+}
+
+uint32_t AllocatorCore::GetCurrentFrameIndex() {
+	return allocatorState->frameAllocator.GetCurrentFrameIndex();
+}
+
+uint64_t AllocatorCore::GetFrameNumber() {
+	return allocatorState->frameAllocator.GetFrameNumber();
+}
+
+void AllocatorCore::FlushThreadCache() {
+	allocatorState->allocator.FlushThreadCache();
 }
 
 size_t Grindstone::Memory::AllocatorCore::GetPeak() {
-	return allocatorState->dynamicAllocator.GetPeakSize();
+	return allocatorState->allocator.GetPeakSize();
 }
 
 size_t Grindstone::Memory::AllocatorCore::GetUsed() {
-	return allocatorState->dynamicAllocator.GetUsedSize();
+	return allocatorState->allocator.GetUsedSize();
 }
 
 size_t Grindstone::Memory::AllocatorCore::GetTotal() {
-	return allocatorState->dynamicAllocator.GetTotalMemorySize();
+	return allocatorState->allocator.GetTotalMemorySize();
 }
 
 bool Grindstone::Memory::AllocatorCore::IsEmpty() {
-	return allocatorState->dynamicAllocator.IsEmpty();
+	return allocatorState->allocator.IsEmpty();
 }
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <memory>
+#include <new>
+#include <vector>
 
-#include <Common/Memory/Allocators/DynamicAllocator.hpp>
+#include <Common/Memory/Allocators/FrameAllocator.hpp>
+#include <Common/Memory/Allocators/ThreadCachingAllocator.hpp>
 #include <Common/String.hpp>
 
 namespace Grindstone::Memory::AllocatorCore {
 	struct AllocatorState {
-		Allocators::DynamicAllocator dynamicAllocator;
+		Allocators::ThreadCachingAllocator allocator;
+		Allocators::FrameAllocator frameAllocator;
 	};
 
 	Grindstone::Memory::AllocatorCore::AllocatorState* GetAllocatorState();
@@ -21,6 +25,9 @@ namespace Grindstone::Memory::AllocatorCore {
 
 	bool FreeWithoutDestructor(void* memPtr);
 
+	// Returns the blocks cached by the calling thread to the shared heap. Call it before a long-lived thread idles.
+	void FlushThreadCache();
+
 	size_t GetPeak();
 	size_t GetUsed();
 	size_t GetTotal();
@@ -31,27 +38,27 @@ namespace Grindstone::Memory::AllocatorCore {
 
 	template<typename T>
 	Grindstone::SharedPtr<T> MakeShared(T* ptr) {
-		return GetAllocatorState()->dynamicAllocator.MakeShared(ptr);
+		return GetAllocatorState()->allocator.MakeShared(ptr);
 	}
 
 	template<typename T>
 	Grindstone::UniquePtr<T> MakeUnique(T* ptr) {
-		return GetAllocatorState()->dynamicAllocator.MakeUnique(ptr);
+		return GetAllocatorState()->allocator.MakeUnique(ptr);
 	}
 
 	template<typename T, typename... Args>
 	Grindstone::UniquePtr<T> AllocateUnique(Args&&... params) {
-		return GetAllocatorState()->dynamicAllocator.AllocateUnique<T>(std::forward<Args>(params)...);
+		return GetAllocatorState()->allocator.AllocateUnique<T>(std::forward<Args>(params)...);
 	}
 
 	template<typename T, typename... Args>
 	Grindstone::SharedPtr<T> AllocateShared(Args&&... params) {
-		return GetAllocatorState()->dynamicAllocator.AllocateShared<T>(std::forward<Args>(params)...);
+		return GetAllocatorState()->allocator.AllocateShared<T>(std::forward<Args>(params)...);
 	}
 
 	template<typename T, typename... Args>
 	T* Allocate(Args&&... params) {
-		T* ptr = static_cast<T*>(GetAllocatorState()->dynamicAllocator.AllocateRaw(sizeof(T), alignof(T), typeid(T).name()));
+		T* ptr = static_cast<T*>(GetAllocatorState()->allocator.AllocateRaw(sizeof(T), alignof(T), typeid(T).name()));
 		if (ptr != nullptr) {
 			// Call the constructor on the newly allocated memory
 			std::construct_at(ptr, std::forward<Args>(params)...);
@@ -62,13 +69,13 @@ namespace Grindstone::Memory::AllocatorCore {
 
 	template<typename T>
 	T* AllocateArray(size_t arraySize) {
-		T* ptr = static_cast<T*>(GetAllocatorState()->dynamicAllocator.AllocateRaw(sizeof(T) * arraySize, alignof(T), typeid(T).name()));
+		T* ptr = static_cast<T*>(GetAllocatorState()->allocator.AllocateRaw(sizeof(T) * arraySize, alignof(T), typeid(T).name()));
 		return ptr;
 	}
 
 	template<typename T, typename... Args>
 	T* AllocateArray(size_t arraySize, Args&&... params) {
-		T* ptr = static_cast<T*>(GetAllocatorState()->dynamicAllocator.AllocateRaw(sizeof(T) * arraySize, alignof(T), typeid(T).name()));
+		T* ptr = static_cast<T*>(GetAllocatorState()->allocator.AllocateRaw(sizeof(T) * arraySize, alignof(T), typeid(T).name()));
 		if (ptr != nullptr) {
 			// Call the constructor on the newly allocated memory
 			for (size_t i = 0; i < arraySize; ++i) {
@@ -81,7 +88,7 @@ namespace Grindstone::Memory::AllocatorCore {
 
 	template<typename T, typename... Args>
 	T* AllocateNamed(const char* debugName, Args&&... params) {
-		T* ptr = static_cast<T*>(GetAllocatorState()->dynamicAllocator.AllocateRaw(sizeof(T), alignof(T), debugName));
+		T* ptr = static_cast<T*>(GetAllocatorState()->allocator.AllocateRaw(sizeof(T), alignof(T), debugName));
 		if (ptr != nullptr) {
 			// Call the constructor on the newly allocated memory
 			new (ptr) T(std::forward<Args>(params)...);
@@ -92,13 +99,13 @@ namespace Grindstone::Memory::AllocatorCore {
 
 	template<typename T>
 	T* AllocateArrayNamed(const char* debugName, size_t arraySize) {
-		T* ptr = static_cast<T*>(GetAllocatorState()->dynamicAllocator.AllocateRaw(sizeof(T) * arraySize, alignof(T), debugName));
+		T* ptr = static_cast<T*>(GetAllocatorState()->allocator.AllocateRaw(sizeof(T) * arraySize, alignof(T), debugName));
 		return ptr;
 	}
 
 	template<typename T, typename... Args>
 	T* AllocateArrayNamed(const char* debugName, size_t arraySize, Args&&... params) {
-		T* ptr = static_cast<T*>(GetAllocatorState()->dynamicAllocator.AllocateRaw(sizeof(T) * arraySize, alignof(T), debugName));
+		T* ptr = static_cast<T*>(GetAllocatorState()->allocator.AllocateRaw(sizeof(T) * arraySize, alignof(T), debugName));
 		if (ptr != nullptr) {
 			// Call the constructor on the newly allocated memory
 			for (size_t i = 0; i < arraySize; ++i) {
@@ -109,6 +116,67 @@ namespace Grindstone::Memory::AllocatorCore {
 		return ptr;
 	}
 
+	// Frame allocations are valid until this frame in flight comes around again, and are never freed individually.
+	bool InitializeFrameAllocator(uint32_t frameCount, size_t sizeInMegsPerFrame);
+	void CloseFrameAllocator();
+	// Call once the fence of the frame about to be recorded has been waited on.
+	void BeginFrame();
+	void* AllocateFrameRaw(size_t size, size_t alignment);
+	// Lets per-frame GPU resources be kept in step with the frame arenas.
+	uint32_t GetFrameCount();
+	uint32_t GetCurrentFrameIndex();
+	uint64_t GetFrameNumber();
+
+	template<typename T, typename... Args>
+	T* AllocateFrame(Args&&... params) {
+		return GetAllocatorState()->frameAllocator.Allocate<T>(std::forward<Args>(params)...);
+	}
+
+	template<typename T>
+	T* AllocateFrameArray(size_t arraySize) {
+		return GetAllocatorState()->frameAllocator.AllocateArray<T>(arraySize);
+	}
+
+	// The destructor still runs when the pointer is reset, but the memory is only reclaimed with the frame.
+	template<typename T, typename... Args>
+	Grindstone::UniquePtr<T> AllocateFrameUnique(Args&&... params) {
+		return Grindstone::UniquePtr<T>(AllocateFrame<T>(std::forward<Args>(params)...), nullptr);
+	}
+
+	/*
+	 * Lets standard containers allocate from the current frame's arena. Memory is never returned
+	 * before the frame is cleared, so reserve up front, and never keep such a container past its frame.
+	 */
+	template<typename T>
+	class FrameStlAllocator {
+	public:
+		using value_type = T;
+
+		FrameStlAllocator() noexcept = default;
+
+		template<typename U>
+		FrameStlAllocator(const FrameStlAllocator<U>&) noexcept {}
+
+		T* allocate(size_t count) {
+			T* memory = static_cast<T*>(AllocateFrameRaw(sizeof(T) * count, alignof(T)));
+			if (memory == nullptr) {
+				throw std::bad_alloc();
+			}
+
+			return memory;
+		}
+
+		void deallocate(T*, size_t) noexcept {}
+
+		template<typename U>
+		bool operator==(const FrameStlAllocator<U>&) const noexcept {
+			return true;
+		}
+	};
+
+	template<typename T>
+	using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
 	template<typename T>
 	bool Free(T* memPtr) {
 		if (memPtr == nullptr) {
@@ -116,7 +184,7 @@ namespace Grindstone::Memory::AllocatorCore {
 		}
 
 		reinterpret_cast<T*>(memPtr)->~T();
-		GetAllocatorState()->dynamicAllocator.Free(memPtr);
+		GetAllocatorState()->allocator.Free(memPtr);
 
 		return true;
 	}
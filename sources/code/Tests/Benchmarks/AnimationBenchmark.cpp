@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <EngineCore/Jobs/JobSystem.hpp>
+#include <Grindstone.Renderables.3D/include/AnimationPose.hpp>
+
+using namespace Grindstone;
+
+namespace {
+	constexpr uint32_t characterCount = 1'000;
+	// About as many as a humanoid rig with fingers.
+	constexpr uint32_t boneCount = 64;
+	constexpr uint32_t keyframesPerTrack = 32;
+	constexpr double ticksPerSecond = 30.0;
+	// Four loops of the clip at 60 frames per second, so playback wraps around.
+	constexpr uint32_t frameCount = 256;
+	constexpr double frameTime = 1.0 / 60.0;
+	const uint32_t invalidBoneIndex = std::numeric_limits<uint32_t>::max();
+
+	Uuid MakeUuid(uint64_t index) {
+		Uuid uuid;
+		uuid.asUint64[0] = index + 1;
+		uuid.asUint64[1] = 0x414E494D4154494Full;
+		return uuid;
+	}
+
+	std::string GetBoneName(uint32_t boneIndex) {
+		return "Bone " + std::to_string(boneIndex);
+	}
+
+	// A tree where every bone comes after its parent, as the rig importer orders them.
+	std::unique_ptr<RigAsset> GenerateRig() {
+		std::unique_ptr<RigAsset> rig = std::make_unique<RigAsset>(MakeUuid(0), "Benchmark Rig");
+		rig->globalInverseTransform = Math::Matrix4(1.0f);
+		rig->bones.resize(boneCount);
+		for (uint32_t boneIndex = 0; boneIndex < boneCount; ++boneIndex) {
+			RigAsset::Bone& bone = rig->bones[boneIndex];
+			bone.parentBoneIndex = boneIndex == 0 ? invalidBoneIndex : (boneIndex - 1) / 2;
+			bone.localBindTransform = glm::translate(Math::Matrix4(1.0f), Math::Float3(0.0f, 0.1f, 0.0f));
+			bone.inverseBindTransform = glm::translate(Math::Matrix4(1.0f), Math::Float3(0.0f, -0.1f * static_cast<float>(boneIndex), 0.0f));
+			rig->boneNameToIndex[GetBoneName(boneIndex)] = boneIndex;
+		}
+
+		return rig;
+	}
+
+	// Animates every bone, with its channels in the reverse of the rig's order, as the importer doesn't sort them.
+	std::unique_ptr<AnimationClipAsset> GenerateAnimation() {
+		std::unique_ptr<AnimationClipAsset> animation = std::make_unique<AnimationClipAsset>(MakeUuid(1), "Benchmark Animation");
+		animation->ticksPerSecond = ticksPerSecond;
+		animation->duration = static_cast<double>(keyframesPerTrack - 1);
+
+		for (uint32_t channelIndex = 0; channelIndex < boneCount; ++channelIndex) {
+			const uint32_t boneIndex = boneCount - 1 - channelIndex;
+			AnimationClipAsset::BoneChannel& channel = animation->boneChannels.emplace_back();
+			channel.boneName = GetBoneName(boneIndex);
+			channel.interpolation = AnimationClipAsset::KeyframeInterpolation::Linear;
+			channel.positionCount = channel.rotationCount = channel.scaleCount = static_cast<uint16_t>(keyframesPerTrack);
+			channel.positionKeyOffset = static_cast<uint32_t>(animation->positions.size());
+			channel.rotationKeyOffset = static_cast<uint32_t>(animation->rotations.size());
+			channel.scaleKeyOffset = static_cast<uint32_t>(animation->scales.size());
+
+			for (uint32_t keyframeIndex = 0; keyframeIndex < keyframesPerTrack; ++keyframeIndex) {
+				const double time = static_cast<double>(keyframeIndex);
+				const float phase = static_cast<float>(keyframeIndex + boneIndex) * 0.2f;
+				animation->positions.emplace_back(time, Math::Float3(0.0f, 0.1f, 0.02f * std::sin(phase)));
+				animation->rotations.emplace_back(time, glm::angleAxis(0.3f * std::sin(phase), glm::normalize(Math::Float3(1.0f, 0.5f, 0.25f))));
+				animation->scales.emplace_back(time, Math::Float3(1.0f + 0.05f * std::cos(phase)));
+			}
+		}
+
+		return animation;
+	}
+
+	/*
+	 * How AnimateSkeletonSystem posed skeletons before animations were bound to rigs: the clip's channels are
+	 * sorted and matched to bones by name, keyframes are found by linear scan, every bone multiplies three
+	 * matrices together, and a search by name runs for every bone, with its result unused.
+	 */
+	namespace Lookups {
+		template<typename T>
+		size_t FindKeyframe(const AnimationClipAsset::Keyframe<T>* keyframes, size_t count, double time) {
+			for (size_t index = 0; index < count - 1; ++index) {
+				if (time < keyframes[index + 1].time) {
+					return index;
+				}
+			}
+
+			return count - 2;
+		}
+
+		float GetWeight(double lastTime, double nextTime, double time) {
+			return glm::clamp(static_cast<float>((time - lastTime) / (nextTime - lastTime)), 0.0f, 1.0f);
+		}
+
+		void EvaluatePose(AnimationClipAsset& animation, const RigAsset& rig, double currentTime, std::vector<Math::Matrix4>& boneMatrices) {
+			std::sort(animation.boneChannels.begin(), animation.boneChannels.end(),
+				[&rig](const AnimationClipAsset::BoneChannel& a, const AnimationClipAsset::BoneChannel& b) -> bool {
+					return rig.boneNameToIndex.find(a.boneName)->second < rig.boneNameToIndex.find(b.boneName)->second;
+				}
+			);
+
+			boneMatrices.clear();
+			for (const RigAsset::Bone& bone : rig.bones) {
+				boneMatrices.push_back(bone.localBindTransform);
+			}
+
+			const double animationTime = std::fmod(animation.ticksPerSecond * currentTime, animation.duration);
+			for (const AnimationClipAsset::BoneChannel& channel : animation.boneChannels) {
+				const uint32_t boneIndex = rig.boneNameToIndex.find(channel.boneName)->second;
+
+				const AnimationClipAsset::PositionKeyframe* positions = &animation.positions[channel.positionKeyOffset];
+				const AnimationClipAsset::RotationKeyframe* rotations = &animation.rotations[channel.rotationKeyOffset];
+				const AnimationClipAsset::ScaleKeyframe* scales = &animation.scales[channel.scaleKeyOffset];
+
+				const size_t positionIndex = FindKeyframe(positions, channel.positionCount, animationTime);
+				const float positionWeight = GetWeight(positions[positionIndex].time, positions[positionIndex + 1].time, animationTime);
+				const Math::Float3 position = glm::mix(positions[positionIndex].value, positions[positionIndex + 1].value, positionWeight);
+
+				const size_t rotationIndex = FindKeyframe(rotations, channel.rotationCount, animationTime);
+				const float rotationWeight = GetWeight(rotations[rotationIndex].time, rotations[rotationIndex + 1].time, animationTime);
+				const Math::Quaternion rotation = glm::normalize(glm::slerp(rotations[rotationIndex].value, rotations[rotationIndex + 1].value, rotationWeight));
+
+				const size_t scaleIndex = FindKeyframe(scales, channel.scaleCount, animationTime);
+				const float scaleWeight = GetWeight(scales[scaleIndex].time, scales[scaleIndex + 1].time, animationTime);
+				const Math::Float3 scale = glm::mix(scales[scaleIndex].value, scales[scaleIndex + 1].value, scaleWeight);
+
+				boneMatrices[boneIndex] =
+					glm::translate(Math::Matrix4(1.0f), position) *
+					glm::toMat4(rotation) *
+					glm::scale(Math::Matrix4(1.0f), scale);
+			}
+
+			for (size_t i = 0; i < rig.bones.size(); ++i) {
+				if (rig.bones[i].parentBoneIndex != invalidBoneIndex) {
+					boneMatrices[i] = boneMatrices[rig.bones[i].parentBoneIndex] * boneMatrices[i];
+				}
+			}
+
+			for (size_t i = 0; i < rig.bones.size(); ++i) {
+				auto boneIt = std::find_if(rig.boneNameToIndex.begin(), rig.boneNameToIndex.end(), [i](const std::pair<const std::string, uint32_t>& a) { return a.second == i; });
+				[[maybe_unused]] auto channelIt = std::find_if(animation.boneChannels.begin(), animation.boneChannels.end(), [boneIt](const AnimationClipAsset::BoneChannel& a) { return a.boneName == boneIt->first; });
+				boneMatrices[i] = boneMatrices[i] * rig.bones[i].inverseBindTransform;
+			}
+		}
+	}
+
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+	void Fail(const char* message) {
+		std::fprintf(stderr, "%s\n", message);
+		std::exit(1);
+	}
+
+	// Runs every frame, and returns the average time of a frame.
+	template<typename Function>
+	double MeasureMillisecondsPerFrame(Function&& poseCharacters) {
+		const auto start = std::chrono::steady_clock::now();
+		for (uint32_t frame = 0; frame < frameCount; ++frame) {
+			poseCharacters(static_cast<double>(frame) * frameTime);
+		}
+
+		return Milliseconds(std::chrono::steady_clock::now() - start).count() / static_cast<double>(frameCount);
+	}
+
+	bool AreMatricesClose(const Math::Matrix4& a, const Math::Matrix4& b) {
+		for (int column = 0; column < 4; ++column) {
+			for (int row = 0; row < 4; ++row) {
+				if (std::abs(a[column][row] - b[column][row]) > 1e-3f) {
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+// Compares posing a crowd of characters that share an animation the way AnimateSkeletonSystem used to, with
+// lookups by name and linear keyframe searches every frame, against posing animators bound to their rig once,
+// first on one thread and then spread over the job system like AnimateSkeletonSystem does.
+int main() {
+	const std::unique_ptr<RigAsset> rig = GenerateRig();
+	const std::unique_ptr<AnimationClipAsset> animation = GenerateAnimation();
+	// Sorted every frame by the lookups, so it's kept apart from the clip the animators are bound to.
+	const std::unique_ptr<AnimationClipAsset> lookupAnimation = GenerateAnimation();
+
+	std::vector<AnimatorComponent> animators(characterCount);
+	const auto bindStart = std::chrono::steady_clock::now();
+	for (AnimatorComponent& animator : animators) {
+		BindAnimation(animator, *animation, *rig);
+	}
+	const double bindTime = Milliseconds(std::chrono::steady_clock::now() - bindStart).count();
+
+	std::vector<std::vector<Math::Matrix4>> lookupBoneMatrices(characterCount);
+	const double lookupTime = MeasureMillisecondsPerFrame([&](double currentTime) {
+		for (std::vector<Math::Matrix4>& boneMatrices : lookupBoneMatrices) {
+			Lookups::EvaluatePose(*lookupAnimation, *rig, currentTime, boneMatrices);
+		}
+	});
+
+	const double boundTime = MeasureMillisecondsPerFrame([&](double currentTime) {
+		for (AnimatorComponent& animator : animators) {
+			EvaluatePose(animator, currentTime);
+		}
+	});
+
+	Jobs::JobSystem jobSystem;
+	const double jobTime = MeasureMillisecondsPerFrame([&](double currentTime) {
+		jobSystem.ParallelFor(0, animators.size(), ANIMATORS_PER_JOB, [&animators, currentTime](size_t index) {
+			EvaluatePose(animators[index], currentTime);
+		});
+	});
+
+	// Both ways were last run on the same frame, so they should have the same pose.
+	for (uint32_t boneIndex = 0; boneIndex < boneCount; ++boneIndex) {
+		if (!AreMatricesClose(animators.back().boneMatrices[boneIndex], lookupBoneMatrices.back()[boneIndex])) {
+			Fail("The bound animators' poses don't match the lookups' poses.");
+		}
+	}
+
+	std::printf("%u characters, %u bones each, %u keyframes per track\n", characterCount, boneCount, keyframesPerTrack);
+	std::printf("Binding every animator took %.2f ms\n\n", bindTime);
+	std::printf("%-24s %12s %12s %10s\n", "Posing", "Frame", "Character", "Speedup");
+	std::printf("%-24s %9.2f ms %9.2f us %9.1fx\n", "Lookups", lookupTime, lookupTime * 1000.0 / characterCount, 1.0);
+	std::printf("%-24s %9.2f ms %9.2f us %9.1fx\n", "Bound", boundTime, boundTime * 1000.0 / characterCount, lookupTime / boundTime);
+	char jobLabel[64];
+	std::snprintf(jobLabel, sizeof(jobLabel), "Bound, %u threads", jobSystem.GetThreadCount());
+	std::printf("%-24s %9.2f ms %9.2f us %9.1fx\n", jobLabel, jobTime, jobTime * 1000.0 / characterCount, lookupTime / jobTime);
+	return 0;
+}
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Common/Assets/ArchiveDirectoryView.hpp>
+#include <Common/Assets/ArchiveDirectoryWriter.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+namespace {
+	constexpr uint32_t lookupCount = 2'000'000;
+	constexpr uint32_t openCount = 20;
+	const AssetType assetTypes[] = { AssetType::Texture, AssetType::Material, AssetType::Mesh3d, AssetType::AudioClip };
+
+	struct GeneratedAsset {
+		AssetType assetType;
+		Uuid uuid;
+		std::string address;
+	};
+
+	// Random uuids, like the editor generates, so lookups aren't helped by sequential keys.
+	std::vector<GeneratedAsset> GenerateAssets(uint32_t assetCount) {
+		std::mt19937_64 generator(20);
+		std::vector<GeneratedAsset> assets(assetCount);
+		for (uint32_t assetIndex = 0; assetIndex < assetCount; ++assetIndex) {
+			GeneratedAsset& asset = assets[assetIndex];
+			asset.assetType = assetTypes[assetIndex % std::size(assetTypes)];
+			asset.uuid.asUint64[0] = generator();
+			asset.uuid.asUint64[1] = generator();
+			asset.address = "content/level" + std::to_string(assetIndex % 97) + "/asset_" + std::to_string(assetIndex);
+		}
+
+		return assets;
+	}
+
+	bool WriteDirectory(const std::filesystem::path& path, const std::vector<GeneratedAsset>& assets) {
+		ArchiveDirectory directory;
+		directory.archives.resize(16, ArchiveDirectory::ArchiveInfo{ 0 });
+		for (size_t assetIndex = 0; assetIndex < assets.size(); ++assetIndex) {
+			const GeneratedAsset& asset = assets[assetIndex];
+			directory.assetTypeIndices[static_cast<size_t>(asset.assetType)].assetsByUuid[asset.uuid] = ArchiveDirectory::AssetInfo{
+				asset.address,
+				asset.address,
+				static_cast<uint32_t>(assetIndex),
+				static_cast<uint16_t>(assetIndex % 16),
+				assetIndex * 4096,
+				4096,
+				8192,
+				ArchiveCompression::Lz4Blocks
+			};
+		}
+
+		return WriteArchiveDirectory(path, directory);
+	}
+
+	// How the directory used to be loaded: the whole file read and every entry copied into trees keyed by uuid and address.
+	struct ParsedDirectory {
+		struct AssetInfo {
+			std::string displayName;
+			std::string address;
+			uint32_t crc;
+			uint16_t archiveIndex;
+			uint64_t offset;
+			uint64_t size;
+			uint64_t uncompressedSize;
+			ArchiveCompression compression;
+		};
+
+		struct AssetTypeIndex {
+			std::map<Uuid, AssetInfo> assetsByUuid;
+			std::map<std::string, Uuid, std::less<>> uuidsByAddress;
+		};
+
+		std::vector<AssetTypeIndex> assetTypeIndices;
+	};
+
+	bool ParseDirectory(const std::filesystem::path& path, ParsedDirectory& outDirectory) {
+		std::ifstream input(path, std::ios::binary | std::ios::ate);
+		std::vector<char> fileData(static_cast<size_t>(input.tellg()));
+		input.seekg(0);
+		if (!input.read(fileData.data(), static_cast<std::streamsize>(fileData.size()))) {
+			return false;
+		}
+
+		// The view only walks the file here, so this times building the trees rather than decoding the format.
+		ArchiveDirectoryView view;
+		if (view.Open(path) != ArchiveDirectoryOpenStatus::Success) {
+			return false;
+		}
+
+		outDirectory.assetTypeIndices.clear();
+		outDirectory.assetTypeIndices.resize(static_cast<size_t>(AssetType::Count));
+		for (const AssetType assetType : assetTypes) {
+			ParsedDirectory::AssetTypeIndex& assetTypeIndex = outDirectory.assetTypeIndices[static_cast<size_t>(assetType)];
+			for (const ArchiveDirectoryFile::AssetInfo& asset : view.GetAssets(assetType)) {
+				assetTypeIndex.assetsByUuid[asset.uuid] = ParsedDirectory::AssetInfo{
+					std::string(view.GetDisplayName(asset)),
+					std::string(view.GetAddress(asset)),
+					asset.crc,
+					asset.archiveIndex,
+					asset.offset,
+					asset.size,
+					asset.uncompressedSize,
+					asset.compression
+				};
+				assetTypeIndex.uuidsByAddress[std::string(view.GetAddress(asset))] = asset.uuid;
+			}
+		}
+
+		return true;
+	}
+
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+	using Nanoseconds = std::chrono::duration<double, std::nano>;
+	volatile uint64_t sink = 0;
+
+	template<typename Function>
+	double MeasureNanosecondsPerLookup(const std::vector<uint32_t>& lookupOrder, Function&& function) {
+		uint64_t sum = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (const uint32_t assetIndex : lookupOrder) {
+			sum += function(assetIndex);
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		sink = sink + sum;
+		return Nanoseconds(end - start).count() / static_cast<double>(lookupOrder.size());
+	}
+
+	void Fail(const char* message) {
+		std::fprintf(stderr, "%s\n", message);
+		std::exit(1);
+	}
+}
+
+// Compares opening a generated directory in place and looking assets up in it against parsing it into trees,
+// the way directories used to be loaded.
+// Usage: ArchiveDirectoryBenchmark [asset count, default 1000000]
+int main(int argc, char** argv) {
+	const uint32_t assetCount = argc > 1
+		? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10))
+		: 1'000'000;
+	const std::filesystem::path directoryPath = std::filesystem::temp_directory_path() / "ArchiveDirectoryBenchmark.gdir";
+
+	std::printf("Generating a directory of %u assets\n", assetCount);
+	const std::vector<GeneratedAsset> assets = GenerateAssets(assetCount);
+	if (!WriteDirectory(directoryPath, assets)) {
+		Fail("Could not write the directory.");
+	}
+	std::printf("Directory file: %.1f MB\n\n", static_cast<double>(std::filesystem::file_size(directoryPath)) / (1024.0 * 1024.0));
+
+	// Startup: opening in place only checks the header and section bounds.
+	ArchiveDirectoryView view;
+	const auto openStart = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < openCount; ++i) {
+		view.Close();
+		if (view.Open(directoryPath) != ArchiveDirectoryOpenStatus::Success) {
+			Fail("Could not open the directory.");
+		}
+	}
+	const double openTime = Milliseconds(std::chrono::steady_clock::now() - openStart).count() / openCount;
+
+	ParsedDirectory parsedDirectory;
+	const auto parseStart = std::chrono::steady_clock::now();
+	if (!ParseDirectory(directoryPath, parsedDirectory)) {
+		Fail("Could not parse the directory.");
+	}
+	const double parseTime = Milliseconds(std::chrono::steady_clock::now() - parseStart).count();
+
+	std::mt19937 generator(21);
+	std::uniform_int_distribution<uint32_t> assetDistribution(0, assetCount - 1);
+	std::vector<uint32_t> lookupOrder(lookupCount);
+	for (uint32_t& assetIndex : lookupOrder) {
+		assetIndex = assetDistribution(generator);
+	}
+
+	const double viewUuidTime = MeasureNanosecondsPerLookup(lookupOrder, [&](uint32_t assetIndex) {
+		const ArchiveDirectoryFile::AssetInfo* asset = view.FindAsset(assets[assetIndex].assetType, assets[assetIndex].uuid);
+		if (asset == nullptr || asset->crc != assetIndex) {
+			Fail("The view found the wrong asset by uuid.");
+		}
+
+		return asset->offset;
+	});
+
+	const double parsedUuidTime = MeasureNanosecondsPerLookup(lookupOrder, [&](uint32_t assetIndex) {
+		const auto& assetsByUuid = parsedDirectory.assetTypeIndices[static_cast<size_t>(assets[assetIndex].assetType)].assetsByUuid;
+		const auto assetIterator = assetsByUuid.find(assets[assetIndex].uuid);
+		if (assetIterator == assetsByUuid.end() || assetIterator->second.crc != assetIndex) {
+			Fail("The parsed directory found the wrong asset by uuid.");
+		}
+
+		return assetIterator->second.offset;
+	});
+
+	const double viewAddressTime = MeasureNanosecondsPerLookup(lookupOrder, [&](uint32_t assetIndex) {
+		const ArchiveDirectoryFile::AssetInfo* asset = view.FindAssetByAddress(assets[assetIndex].assetType, assets[assetIndex].address);
+		if (asset == nullptr || asset->crc != assetIndex) {
+			Fail("The view found the wrong asset by address.");
+		}
+
+		return asset->offset;
+	});
+
+	const double parsedAddressTime = MeasureNanosecondsPerLookup(lookupOrder, [&](uint32_t assetIndex) {
+		const ParsedDirectory::AssetTypeIndex& assetTypeIndex = parsedDirectory.assetTypeIndices[static_cast<size_t>(assets[assetIndex].assetType)];
+		const auto uuidIterator = assetTypeIndex.uuidsByAddress.find(assets[assetIndex].address);
+		if (uuidIterator == assetTypeIndex.uuidsByAddress.end()) {
+			Fail("The parsed directory found no asset by address.");
+		}
+
+		return assetTypeIndex.assetsByUuid.find(uuidIterator->second)->second.offset;
+	});
+
+	view.Close();
+	std::error_code errorCode;
+	std::filesystem::remove(directoryPath, errorCode);
+
+	std::printf("%-28s %12s %16s %16s\n", "", "Startup", "Uuid lookup", "Address lookup");
+	std::printf("%-28s %9.3f ms %13.1f ns %13.1f ns\n", "In place", openTime, viewUuidTime, viewAddressTime);
+	std::printf("%-28s %9.3f ms %13.1f ns %13.1f ns\n", "Parsed into trees", parseTime, parsedUuidTime, parsedAddressTime);
+	return 0;
+}
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <Common/Assets/ArchiveDirectoryWriter.hpp>
+#include <EngineCore/Assets/Loaders/ArchiveAssetLoader.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+namespace {
+	// Matches the archive size the pack serializer fills before starting a new archive.
+	constexpr uint64_t archiveSize = 200ull * 1024ull * 1024ull;
+	constexpr uint64_t minAssetSize = 64ull * 1024ull;
+	constexpr uint64_t maxAssetSize = 4ull * 1024ull * 1024ull;
+	constexpr uint64_t pageSize = 4096;
+	const char* archiveName = "BenchmarkArchive";
+
+	struct GeneratedAsset {
+		Uuid uuid;
+		uint16_t archiveIndex;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	struct GeneratedBuild {
+		std::filesystem::path directoryPath;
+		std::vector<std::filesystem::path> archivePaths;
+		std::vector<GeneratedAsset> assets;
+		uint64_t totalSize = 0;
+	};
+
+	Uuid MakeUuid(uint64_t index) {
+		Uuid uuid;
+		uuid.asUint64[0] = index + 1;
+		uuid.asUint64[1] = 0;
+		return uuid;
+	}
+
+	std::filesystem::path GetArchivePath(const std::filesystem::path& outputDirectory, size_t archiveIndex) {
+		return outputDirectory / (std::string(archiveName) + "_" + std::to_string(archiveIndex) + ".garc");
+	}
+
+	// Writes archives and a directory laid out like a packed build. Assets are stored uncompressed, so every load can be a view.
+	GeneratedBuild GenerateBuild(const std::filesystem::path& outputDirectory, uint64_t targetSize) {
+		GeneratedBuild build;
+		build.directoryPath = outputDirectory / (std::string(archiveName) + ".gdir");
+
+		std::mt19937_64 generator(16);
+		std::uniform_int_distribution<uint64_t> sizeDistribution(minAssetSize, maxAssetSize);
+		uint64_t archiveUsedSize = archiveSize;
+		while (build.totalSize < targetSize) {
+			const uint64_t size = sizeDistribution(generator);
+			if (archiveUsedSize + size > archiveSize) {
+				build.archivePaths.push_back(GetArchivePath(outputDirectory, build.archivePaths.size()));
+				archiveUsedSize = 0;
+			}
+
+			build.assets.push_back(GeneratedAsset{
+				MakeUuid(build.assets.size()),
+				static_cast<uint16_t>(build.archivePaths.size() - 1),
+				archiveUsedSize,
+				size
+			});
+			archiveUsedSize += size;
+			build.totalSize += size;
+		}
+
+		// Each asset starts with its index, so loads can be checked against the asset they asked for.
+		std::vector<char> assetData(maxAssetSize);
+		std::ofstream archiveStream;
+		uint16_t openArchiveIndex = UINT16_MAX;
+		for (size_t assetIndex = 0; assetIndex < build.assets.size(); ++assetIndex) {
+			const GeneratedAsset& asset = build.assets[assetIndex];
+			if (asset.archiveIndex != openArchiveIndex) {
+				archiveStream = std::ofstream(build.archivePaths[asset.archiveIndex], std::ios::binary | std::ios::trunc);
+				openArchiveIndex = asset.archiveIndex;
+			}
+
+			std::fill(assetData.begin(), assetData.begin() + static_cast<std::ptrdiff_t>(asset.size), static_cast<char>(assetIndex));
+			const uint64_t index = assetIndex;
+			std::memcpy(assetData.data(), &index, sizeof(index));
+			archiveStream.write(assetData.data(), static_cast<std::streamsize>(asset.size));
+		}
+		archiveStream.close();
+
+		std::vector<std::string> displayNames(build.assets.size());
+		ArchiveDirectory directory;
+		directory.archives.resize(build.archivePaths.size(), ArchiveDirectory::ArchiveInfo{ 0 });
+		for (size_t assetIndex = 0; assetIndex < build.assets.size(); ++assetIndex) {
+			const GeneratedAsset& asset = build.assets[assetIndex];
+			displayNames[assetIndex] = "Asset " + std::to_string(assetIndex);
+			directory.assetTypeIndices[static_cast<size_t>(AssetType::Texture)].assetsByUuid[asset.uuid] = ArchiveDirectory::AssetInfo{
+				displayNames[assetIndex],
+				{},
+				0,
+				asset.archiveIndex,
+				asset.offset,
+				asset.size,
+				asset.size,
+				ArchiveCompression::None
+			};
+		}
+
+		if (!WriteArchiveDirectory(build.directoryPath, directory)) {
+			std::fprintf(stderr, "Could not write %s\n", build.directoryPath.string().c_str());
+			std::exit(1);
+		}
+
+		return build;
+	}
+
+	// Drops a file's pages from the OS file cache, so the next load has to read it from disk.
+	bool EvictFromFileCache(const std::filesystem::path& path) {
+#if defined(_WIN32)
+		// Opening a file without buffering makes Windows flush and drop the pages it has cached for it.
+		HANDLE fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		CloseHandle(fileHandle);
+		return true;
+#elif defined(__linux__)
+		const int fileDescriptor = open(path.c_str(), O_RDONLY);
+		if (fileDescriptor == -1) {
+			return false;
+		}
+
+		const bool wasEvicted = posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_DONTNEED) == 0;
+		close(fileDescriptor);
+		return wasEvicted;
+#else
+		return false;
+#endif
+	}
+
+	// Importers read all of an asset, so a view's pages have to be faulted in for the timings to be comparable.
+	uint64_t TouchEveryPage(const Byte* data, uint64_t size) {
+		uint64_t sum = 0;
+		for (uint64_t offset = 0; offset < size; offset += pageSize) {
+			sum += data[offset];
+		}
+
+		return sum;
+	}
+
+	// How ArchiveAssetLoader used to load: read a whole archive, keep only the last one read, and copy each asset out of it.
+	class ReadAndCopyLoader {
+	public:
+		bool Load(const GeneratedBuild& build, const GeneratedAsset& asset, std::vector<Byte>& outData) {
+			if (asset.archiveIndex != loadedArchiveIndex) {
+				std::ifstream input(build.archivePaths[asset.archiveIndex], std::ios::binary | std::ios::ate);
+				loadedArchive.resize(static_cast<size_t>(input.tellg()));
+				input.seekg(0);
+				if (!input.read(reinterpret_cast<char*>(loadedArchive.data()), static_cast<std::streamsize>(loadedArchive.size()))) {
+					return false;
+				}
+
+				loadedArchiveIndex = asset.archiveIndex;
+			}
+
+			outData.assign(loadedArchive.data() + asset.offset, loadedArchive.data() + asset.offset + asset.size);
+			return true;
+		}
+
+	private:
+		std::vector<Byte> loadedArchive;
+		uint16_t loadedArchiveIndex = UINT16_MAX;
+	};
+
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+	volatile uint64_t sink = 0;
+
+	double TimeReadAndCopy(const GeneratedBuild& build) {
+		ReadAndCopyLoader loader;
+		std::vector<Byte> assetData;
+		uint64_t sum = 0;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t assetIndex = 0; assetIndex < build.assets.size(); ++assetIndex) {
+			if (!loader.Load(build, build.assets[assetIndex], assetData) || *reinterpret_cast<const uint64_t*>(assetData.data()) != assetIndex) {
+				std::fprintf(stderr, "Read and copy loaded the wrong data for asset %zu\n", assetIndex);
+				std::exit(1);
+			}
+
+			sum += TouchEveryPage(assetData.data(), assetData.size());
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		sink = sink + sum;
+		return Milliseconds(end - start).count();
+	}
+
+	double TimeMemoryMapped(const GeneratedBuild& build) {
+		uint64_t sum = 0;
+
+		const auto start = std::chrono::steady_clock::now();
+		ArchiveAssetLoader loader(build.directoryPath);
+		for (size_t assetIndex = 0; assetIndex < build.assets.size(); ++assetIndex) {
+			AssetLoadBinaryResult result = loader.LoadBinaryByUuid(AssetType::Texture, build.assets[assetIndex].uuid);
+			if (result.status != AssetLoadStatus::Success || *reinterpret_cast<const uint64_t*>(result.buffer.Get()) != assetIndex) {
+				std::fprintf(stderr, "The memory-mapped loader loaded the wrong data for asset %zu\n", assetIndex);
+				std::exit(1);
+			}
+
+			sum += TouchEveryPage(result.buffer.Get(), result.buffer.GetCapacity());
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		sink = sink + sum;
+		return Milliseconds(end - start).count();
+	}
+
+	bool EvictBuild(const GeneratedBuild& build) {
+		bool wasEvicted = EvictFromFileCache(build.directoryPath);
+		for (const std::filesystem::path& archivePath : build.archivePaths) {
+			wasEvicted = EvictFromFileCache(archivePath) && wasEvicted;
+		}
+
+		return wasEvicted;
+	}
+
+	void PrintResult(const char* name, double milliseconds, const GeneratedBuild& build) {
+		const double megabytes = static_cast<double>(build.totalSize) / (1024.0 * 1024.0);
+		const double microsecondsPerAsset = milliseconds * 1000.0 / static_cast<double>(build.assets.size());
+		std::printf("%-24s %10.1f ms %10.1f MB/s %10.1f us/asset\n", name, milliseconds, megabytes * 1000.0 / milliseconds, microsecondsPerAsset);
+	}
+}
+
+// Loads every asset of a generated multi-gigabyte build with the old read-and-copy path and the memory-mapped
+// loader, first with the archives evicted from the file cache and then again with them cached.
+// Usage: ArchiveLoadBenchmark [size in megabytes, default 2048] [output directory, default the temp directory]
+int main(int argc, char** argv) {
+	const uint64_t targetMegabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2048;
+	const std::filesystem::path outputDirectory = (argc > 2
+		? std::filesystem::path(argv[2])
+		: std::filesystem::temp_directory_path()) / "ArchiveLoadBenchmark";
+
+	Memory::AllocatorCore::Initialize(64);
+	std::filesystem::create_directories(outputDirectory);
+
+	std::printf("Generating a %llu MB build in %s\n", static_cast<unsigned long long>(targetMegabytes), outputDirectory.string().c_str());
+	const GeneratedBuild build = GenerateBuild(outputDirectory, targetMegabytes * 1024ull * 1024ull);
+	std::printf("%zu assets in %zu archives\n\n", build.assets.size(), build.archivePaths.size());
+
+	const bool canEvict = EvictBuild(build);
+	if (!canEvict) {
+		std::printf("The file cache couldn't be cleared, so the cold timings are warm.\n");
+	}
+
+	const double readAndCopyCold = TimeReadAndCopy(build);
+	EvictBuild(build);
+	const double memoryMappedCold = TimeMemoryMapped(build);
+	const double readAndCopyWarm = TimeReadAndCopy(build);
+	const double memoryMappedWarm = TimeMemoryMapped(build);
+
+	PrintResult("Read and copy, cold", readAndCopyCold, build);
+	PrintResult("Memory-mapped, cold", memoryMappedCold, build);
+	PrintResult("Read and copy, warm", readAndCopyWarm, build);
+	PrintResult("Memory-mapped, warm", memoryMappedWarm, build);
+
+	std::error_code errorCode;
+	std::filesystem::remove_all(outputDirectory, errorCode);
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <EngineCore/Assets/Asset.hpp>
+#include <EngineCore/Assets/AssetStorage.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+namespace {
+	constexpr uint32_t assetCount = 100'000;
+	// Roughly what a large frame resolves: every mesh and material of every visible renderable.
+	constexpr uint32_t resolvesPerFrame = 20'000;
+	constexpr uint32_t frameCount = 200;
+
+	struct BenchmarkAsset : public Asset {
+		BenchmarkAsset(Uuid uuid) : Asset(uuid, "Benchmark Asset") {}
+
+		// Stands in for the GPU objects an asset holds, so assets are a realistic size.
+		uint64_t payload[8] = {};
+	};
+
+	Uuid MakeUuid(std::mt19937_64& generator) {
+		Uuid uuid;
+		uuid.asUint64[0] = generator();
+		uuid.asUint64[1] = generator();
+		return uuid;
+	}
+
+	using Nanoseconds = std::chrono::duration<double, std::nano>;
+
+	// Runs every frame's resolves on threadCount threads at once, each resolving its share of every frame.
+	template<typename Function>
+	double MeasureNanosecondsPerResolve(uint32_t threadCount, const std::vector<uint32_t>& resolveOrder, Function&& function) {
+		std::vector<std::thread> threads;
+		std::vector<uint64_t> sums(threadCount, 0);
+		const size_t resolvesPerThread = resolveOrder.size() / threadCount;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+			threads.emplace_back([&, threadIndex] {
+				uint64_t sum = 0;
+				const size_t begin = threadIndex * resolvesPerThread;
+				for (size_t i = begin; i < begin + resolvesPerThread; ++i) {
+					sum += function(resolveOrder[i]);
+				}
+
+				sums[threadIndex] = sum;
+			});
+		}
+
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		uint64_t sum = 0;
+		for (const uint64_t threadSum : sums) {
+			sum += threadSum;
+		}
+
+		if (sum == 0) {
+			std::fprintf(stderr, "Nothing was resolved.\n");
+			std::exit(1);
+		}
+
+		return Nanoseconds(end - start).count() / static_cast<double>(resolvesPerThread * threadCount);
+	}
+}
+
+// Compares resolving assets through handles against looking them up by uuid in AssetStorage, and in the
+// std::map that importers used to store their assets in. Multi-threaded runs show the shared lock that uuid
+// lookups take, which handles don't.
+int main() {
+	Memory::AllocatorCore::Initialize(256);
+
+	std::mt19937_64 generator(21);
+	std::vector<Uuid> uuids(assetCount);
+	for (Uuid& uuid : uuids) {
+		uuid = MakeUuid(generator);
+	}
+
+	AssetStorage<BenchmarkAsset> storage;
+	std::map<Uuid, BenchmarkAsset> assetMap;
+	std::vector<AssetHandle> handles(assetCount);
+	for (uint32_t assetIndex = 0; assetIndex < assetCount; ++assetIndex) {
+		storage.Emplace(uuids[assetIndex], BenchmarkAsset(uuids[assetIndex]));
+		assetMap.emplace(uuids[assetIndex], BenchmarkAsset(uuids[assetIndex]));
+		handles[assetIndex] = storage.FindHandle(uuids[assetIndex]);
+	}
+
+	std::uniform_int_distribution<uint32_t> assetDistribution(0, assetCount - 1);
+	std::vector<uint32_t> resolveOrder(resolvesPerFrame * frameCount);
+	for (uint32_t& assetIndex : resolveOrder) {
+		assetIndex = assetDistribution(generator);
+	}
+
+	std::printf("%u assets, %u resolves per frame\n\n", assetCount, resolvesPerFrame);
+	std::printf("%-8s %16s %16s %16s %16s\n", "Threads", "std::map", "Storage by uuid", "Storage handle", "Frame (handle)");
+	for (const uint32_t threadCount : { 1u, 4u, 8u }) {
+		const double mapTime = MeasureNanosecondsPerResolve(threadCount, resolveOrder, [&](uint32_t assetIndex) {
+			return assetMap.find(uuids[assetIndex])->second.referenceCount.Get();
+		});
+
+		const double uuidTime = MeasureNanosecondsPerResolve(threadCount, resolveOrder, [&](uint32_t assetIndex) {
+			return storage.Find(uuids[assetIndex])->referenceCount.Get();
+		});
+
+		const double handleTime = MeasureNanosecondsPerResolve(threadCount, resolveOrder, [&](uint32_t assetIndex) {
+			return storage.Get(handles[assetIndex])->referenceCount.Get();
+		});
+
+		const double frameMicroseconds = handleTime * resolvesPerFrame / 1000.0;
+		std::printf("%-8u %13.1f ns %13.1f ns %13.1f ns %13.1f us\n", threadCount, mapTime, uuidTime, handleTime, frameMicroseconds);
+	}
+
+	return 0;
+}
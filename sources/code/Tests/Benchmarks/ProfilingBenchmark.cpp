@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+#include <EngineCore/Profiling.hpp>
+
+using namespace Grindstone;
+
+namespace {
+	const uint32_t scopeCount = 4000000;
+
+	template<typename Function>
+	double MeasureNanosecondsPerCall(Function&& function) {
+		const auto start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < scopeCount; ++i) {
+			function();
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(scopeCount);
+	}
+
+	volatile uint64_t sink = 0;
+}
+
+// Measures what a GRIND_PROFILE_SCOPE costs the profiled thread, with the writer thread draining events to a trace.
+int main() {
+	const std::filesystem::path tracePath = std::filesystem::temp_directory_path() / "ProfilingBenchmark.gtrace";
+
+	Profiler::Manager& manager = Profiler::Manager::Get();
+	manager.Initialize();
+	manager.BeginSession("ProfilingBenchmark", tracePath);
+	const uint32_t nameId = manager.InternName("BenchmarkScope");
+
+	const double steadyClockTime = MeasureNanosecondsPerCall([]() {
+		sink = sink + static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+	});
+
+	const double getTicksTime = MeasureNanosecondsPerCall([]() {
+		sink = sink + Profiler::GetTicks();
+	});
+
+	const double scopeTime = MeasureNanosecondsPerCall([nameId]() {
+		Profiler::Timer timer(nameId);
+	});
+
+	const double nestedScopeTime = MeasureNanosecondsPerCall([nameId]() {
+		Profiler::Timer outerTimer(nameId);
+		Profiler::Timer innerTimer(nameId);
+	}) / 2.0;
+
+	manager.EndSession();
+	manager.Shutdown();
+
+	std::error_code errorCode;
+	std::filesystem::remove(tracePath, errorCode);
+
+	std::printf("Ticks per second:       %llu\n", static_cast<unsigned long long>(Profiler::GetTicksPerSecond()));
+	std::printf("steady_clock::now:      %6.2f ns\n", steadyClockTime);
+	std::printf("Profiler::GetTicks:     %6.2f ns\n", getTicksTime);
+	std::printf("Profiled scope:         %6.2f ns\n", scopeTime);
+	std::printf("Nested profiled scope:  %6.2f ns\n", nestedScopeTime);
+	return 0;
+}
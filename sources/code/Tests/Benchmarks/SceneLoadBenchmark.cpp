@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <EngineCore/EngineCore.hpp>
+#include <EngineCore/CoreComponents/Parent/ParentComponent.hpp>
+#include <EngineCore/CoreComponents/Tag/TagComponent.hpp>
+#include <EngineCore/CoreComponents/Transform/TransformComponent.hpp>
+#include <EngineCore/ECS/ComponentRegistrar.hpp>
+#include <EngineCore/Scenes/Scene.hpp>
+#include <EngineCore/Scenes/SceneCooker.hpp>
+#include <EngineCore/Scenes/SceneLoaderBinary.hpp>
+#include <EngineCore/Scenes/SceneLoaderJson.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::SceneManagement;
+
+namespace {
+	constexpr int runCount = 3;
+	// Every group of entities is a root with children, like props placed under a level's sections.
+	constexpr uint32_t entitiesPerGroup = 16;
+	const uint32_t nullEntityId = static_cast<uint32_t>(entt::entity(entt::null));
+
+	// Written the way SceneWriterJson saves scenes, so the loaders do the same work as on a saved level.
+	std::string GenerateSceneJson(uint32_t entityCount) {
+		std::string json;
+		json.reserve(static_cast<size_t>(entityCount) * 256);
+		json += "{\"name\":\"Generated Scene\",\"entities\":[";
+		for (uint32_t entityIndex = 0; entityIndex < entityCount; ++entityIndex) {
+			const uint32_t groupRoot = entityIndex - entityIndex % entitiesPerGroup;
+			const float x = static_cast<float>(entityIndex % 1000);
+			const float z = static_cast<float>(entityIndex / 1000);
+
+			char entityJson[512];
+			std::snprintf(
+				entityJson, sizeof(entityJson),
+				"%s{\"entityId\":%u,\"components\":["
+				"{\"component\":\"Tag\",\"params\":{\"tag\":\"Entity %u\"}},"
+				"{\"component\":\"Transform\",\"params\":{\"position\":[%.1f,0.0,%.1f],\"rotation\":[0.0,0.0,0.0,1.0],\"scale\":[1.0,1.0,1.0]}},"
+				"{\"component\":\"Parent\",\"params\":{\"parentEntity\":%u}}"
+				"]}",
+				entityIndex == 0 ? "" : ",",
+				entityIndex,
+				entityIndex,
+				x,
+				z,
+				entityIndex == groupRoot ? nullEntityId : groupRoot
+			);
+			json += entityJson;
+		}
+
+		json += "]}";
+		return json;
+	}
+
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+	void Fail(const char* message) {
+		std::fprintf(stderr, "%s\n", message);
+		std::exit(1);
+	}
+
+	// Loads the scene into an empty registry runCount times, and returns the fastest load.
+	template<typename Function>
+	double MeasureLoadMilliseconds(EngineCore& engineCore, uint32_t entityCount, Function&& loadScene) {
+		double fastestTime = 0.0;
+		for (int run = 0; run < runCount; ++run) {
+			// A fresh registry, so each load creates its entities with their saved ids like the first load of a level.
+			entt::registry& registry = engineCore.GetEntityRegistry();
+			registry = entt::registry();
+
+			Scene scene;
+			const auto start = std::chrono::steady_clock::now();
+			loadScene(scene);
+			const double time = Milliseconds(std::chrono::steady_clock::now() - start).count();
+
+			if (registry.view<TagComponent>().size() != entityCount || registry.view<ParentComponent>().size() != entityCount) {
+				Fail("The scene didn't load every entity.");
+			}
+
+			const entt::entity lastEntity = static_cast<entt::entity>(entityCount - 1);
+			const entt::entity lastParent = static_cast<entt::entity>((entityCount - 1) - (entityCount - 1) % entitiesPerGroup);
+			if (lastEntity != lastParent && registry.get<ParentComponent>(lastEntity).parentEntity != lastParent) {
+				Fail("The scene's parents weren't loaded.");
+			}
+
+			fastestTime = run == 0
+				? time
+				: std::min(fastestTime, time);
+		}
+
+		engineCore.GetEntityRegistry() = entt::registry();
+		return fastestTime;
+	}
+}
+
+// Compares loading generated scenes from json, which is parsed and cooked while loading, against loading
+// the same scenes cooked by the build. Both are given the file in memory, so only loading is timed.
+// Usage: SceneLoadBenchmark [entity count, default 10000 to 500000]
+int main(int argc, char** argv) {
+	std::vector<uint32_t> entityCounts = { 10'000, 50'000, 100'000, 500'000 };
+	if (argc > 1) {
+		entityCounts = { static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) };
+	}
+
+	const std::string projectPath = (std::filesystem::temp_directory_path() / "SceneLoadBenchmark").string();
+	EngineCore engineCore;
+	EngineCore::SetInstance(engineCore);
+
+	EngineCore::EarlyCreateInfo earlyCreateInfo;
+	earlyCreateInfo.projectPath = projectPath.c_str();
+	if (!engineCore.EarlyInitialize(earlyCreateInfo)) {
+		Fail("Could not initialize the engine.");
+	}
+
+	ECS::ComponentRegistrar& componentRegistrar = *engineCore.GetComponentRegistrar();
+	componentRegistrar.RegisterComponent<TagComponent>();
+	componentRegistrar.RegisterComponent<TransformComponent>();
+	componentRegistrar.RegisterComponent<ParentComponent>();
+
+	EngineCore::LateCreateInfo lateCreateInfo;
+	if (!engineCore.Initialize(lateCreateInfo)) {
+		Fail("Could not initialize the engine.");
+	}
+
+	const SceneCooker sceneCooker(componentRegistrar);
+	std::printf("%-10s %12s %12s %12s %12s %10s\n", "Entities", "Json size", "Json load", "Cooked size", "Cooked load", "Speedup");
+	for (const uint32_t entityCount : entityCounts) {
+		const std::string sceneJson = GenerateSceneJson(entityCount);
+		std::vector<Byte> cookedScene;
+		if (!sceneCooker.Cook(sceneJson, cookedScene)) {
+			Fail("Could not cook the scene.");
+		}
+
+		const double jsonTime = MeasureLoadMilliseconds(engineCore, entityCount, [&](Scene& scene) {
+			SceneLoaderJson sceneLoader(&scene, Uuid(), "Generated Scene", sceneJson);
+		});
+
+		const double cookedTime = MeasureLoadMilliseconds(engineCore, entityCount, [&](Scene& scene) {
+			SceneLoaderBinary sceneLoader(&scene, Uuid(), "Generated Scene", cookedScene.data(), cookedScene.size());
+		});
+
+		std::printf(
+			"%-10u %9.1f MB %9.1f ms %9.1f MB %9.1f ms %9.1fx\n",
+			entityCount,
+			static_cast<double>(sceneJson.size()) / (1024.0 * 1024.0),
+			jsonTime,
+			static_cast<double>(cookedScene.size()) / (1024.0 * 1024.0),
+			cookedTime,
+			jsonTime / cookedTime
+		);
+	}
+
+	return 0;
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdint.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Common/Assets/ArchiveCompression.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+namespace {
+	constexpr Byte guardByte = 0xCD;
+	constexpr size_t guardSize = 64;
+
+	// Repeating text with some variation, which LZ4 shrinks well.
+	std::vector<Byte> MakeCompressibleData(uint64_t size, uint32_t seed = 1) {
+		std::mt19937 generator(seed);
+		std::uniform_int_distribution<int> wordDistribution(0, 7);
+		const char* words[] = { "vertex ", "index ", "normal ", "tangent ", "uv ", "bone ", "weight ", "color " };
+
+		std::vector<Byte> data;
+		data.reserve(size);
+		while (data.size() < size) {
+			const char* word = words[wordDistribution(generator)];
+			data.insert(data.end(), word, word + std::strlen(word));
+		}
+
+		data.resize(size);
+		return data;
+	}
+
+	std::vector<Byte> MakeRandomData(uint64_t size, uint32_t seed = 2) {
+		std::mt19937 generator(seed);
+		std::uniform_int_distribution<int> byteDistribution(0, 255);
+		std::vector<Byte> data(size);
+		for (Byte& byte : data) {
+			byte = static_cast<Byte>(byteDistribution(generator));
+		}
+
+		return data;
+	}
+
+	uint64_t GetBlockCount(uint64_t size) {
+		return (size + archiveCompressionBlockSize - 1) / archiveCompressionBlockSize;
+	}
+
+	uint32_t GetStoredBlockSize(const std::vector<Byte>& compressed, uint64_t blockIndex) {
+		uint32_t storedBlockSize = 0;
+		std::memcpy(&storedBlockSize, compressed.data() + blockIndex * sizeof(uint32_t), sizeof(uint32_t));
+		return storedBlockSize;
+	}
+
+	// Decompresses into a buffer with guard bytes after it, and checks nothing was written past the end.
+	bool Decompress(const std::vector<Byte>& compressed, uint64_t uncompressedSize, std::vector<Byte>& outData) {
+		outData.assign(uncompressedSize + guardSize, guardByte);
+		const bool wasDecompressed = DecompressArchiveBlocks(compressed.data(), compressed.size(), outData.data(), uncompressedSize);
+		const bool areGuardsIntact = std::all_of(
+			outData.begin() + static_cast<std::ptrdiff_t>(uncompressedSize), outData.end(),
+			[](Byte byte) { return byte == guardByte; }
+		);
+
+		EXPECT_TRUE(areGuardsIntact) << "Decompression wrote past the end of its output.";
+		outData.resize(uncompressedSize);
+		return wasDecompressed;
+	}
+}
+
+TEST(ArchiveCompressionTest, CompressibleDataRoundTrips) {
+	const uint64_t sizes[] = {
+		1000,
+		archiveCompressionBlockSize - 1,
+		archiveCompressionBlockSize,
+		archiveCompressionBlockSize + 1,
+		archiveCompressionBlockSize * 7 / 2,
+		10 * 1024 * 1024
+	};
+
+	for (const uint64_t size : sizes) {
+		SCOPED_TRACE(size);
+		const std::vector<Byte> original = MakeCompressibleData(size);
+		std::vector<Byte> compressed;
+		ASSERT_TRUE(CompressArchiveBlocks(original.data(), original.size(), compressed));
+		EXPECT_LT(compressed.size(), original.size());
+
+		// The table lists one stored size per block, and the blocks fill the rest of the data exactly.
+		uint64_t storedSize = GetBlockCount(size) * sizeof(uint32_t);
+		for (uint64_t blockIndex = 0; blockIndex < GetBlockCount(size); ++blockIndex) {
+			storedSize += GetStoredBlockSize(compressed, blockIndex);
+		}
+		EXPECT_EQ(storedSize, compressed.size());
+
+		std::vector<Byte> decompressed;
+		ASSERT_TRUE(Decompress(compressed, size, decompressed));
+		EXPECT_EQ(decompressed, original);
+	}
+}
+
+TEST(ArchiveCompressionTest, IncompressibleDataIsRejected) {
+	const std::vector<Byte> original = MakeRandomData(archiveCompressionBlockSize * 3);
+	std::vector<Byte> compressed;
+	EXPECT_FALSE(CompressArchiveBlocks(original.data(), original.size(), compressed));
+}
+
+TEST(ArchiveCompressionTest, TinyAndEmptyDataIsRejected) {
+	const std::vector<Byte> original = MakeCompressibleData(4);
+	std::vector<Byte> compressed;
+	EXPECT_FALSE(CompressArchiveBlocks(original.data(), 0, compressed));
+	EXPECT_FALSE(CompressArchiveBlocks(original.data(), original.size(), compressed));
+}
+
+TEST(ArchiveCompressionTest, IncompressibleBlocksAreStoredRaw) {
+	// One random block between two compressible ones, so the asset as a whole still shrinks.
+	std::vector<Byte> original = MakeCompressibleData(archiveCompressionBlockSize);
+	const std::vector<Byte> randomBlock = MakeRandomData(archiveCompressionBlockSize);
+	const std::vector<Byte> lastBlock = MakeCompressibleData(archiveCompressionBlockSize / 2, 3);
+	original.insert(original.end(), randomBlock.begin(), randomBlock.end());
+	original.insert(original.end(), lastBlock.begin(), lastBlock.end());
+
+	std::vector<Byte> compressed;
+	ASSERT_TRUE(CompressArchiveBlocks(original.data(), original.size(), compressed));
+	EXPECT_LT(GetStoredBlockSize(compressed, 0), archiveCompressionBlockSize);
+	EXPECT_EQ(GetStoredBlockSize(compressed, 1), archiveCompressionBlockSize);
+	EXPECT_LT(GetStoredBlockSize(compressed, 2), archiveCompressionBlockSize / 2);
+
+	std::vector<Byte> decompressed;
+	ASSERT_TRUE(Decompress(compressed, original.size(), decompressed));
+	EXPECT_EQ(decompressed, original);
+}
+
+TEST(ArchiveCompressionTest, CorruptBlocksFailToDecompress) {
+	const uint64_t size = archiveCompressionBlockSize * 2 + 1000;
+	const std::vector<Byte> original = MakeCompressibleData(size);
+	std::vector<Byte> compressed;
+	ASSERT_TRUE(CompressArchiveBlocks(original.data(), original.size(), compressed));
+
+	const uint64_t blockTableSize = GetBlockCount(size) * sizeof(uint32_t);
+	const uint64_t secondBlockOffset = blockTableSize + GetStoredBlockSize(compressed, 0);
+	std::vector<Byte> decompressed;
+
+	{
+		SCOPED_TRACE("Overwritten block contents");
+		std::vector<Byte> corrupted = compressed;
+		std::fill_n(corrupted.begin() + static_cast<std::ptrdiff_t>(secondBlockOffset), 64, Byte(0xFF));
+		EXPECT_FALSE(Decompress(corrupted, size, decompressed));
+	}
+
+	{
+		SCOPED_TRACE("Stored size past the end of the data");
+		std::vector<Byte> corrupted = compressed;
+		const uint32_t storedBlockSize = static_cast<uint32_t>(compressed.size());
+		std::memcpy(corrupted.data() + sizeof(uint32_t), &storedBlockSize, sizeof(uint32_t));
+		EXPECT_FALSE(Decompress(corrupted, size, decompressed));
+	}
+
+	{
+		SCOPED_TRACE("Stored size shorter than the block");
+		std::vector<Byte> corrupted = compressed;
+		const uint32_t storedBlockSize = GetStoredBlockSize(compressed, 0) - 16;
+		std::memcpy(corrupted.data(), &storedBlockSize, sizeof(uint32_t));
+		EXPECT_FALSE(Decompress(corrupted, size, decompressed));
+	}
+
+	{
+		SCOPED_TRACE("Truncated data");
+		std::vector<Byte> corrupted(compressed.begin(), compressed.end() - 100);
+		EXPECT_FALSE(Decompress(corrupted, size, decompressed));
+	}
+
+	{
+		SCOPED_TRACE("Trailing data");
+		std::vector<Byte> corrupted = compressed;
+		corrupted.push_back(0);
+		EXPECT_FALSE(Decompress(corrupted, size, decompressed));
+	}
+
+	{
+		SCOPED_TRACE("Truncated block table");
+		std::vector<Byte> corrupted(compressed.begin(), compressed.begin() + 4);
+		EXPECT_FALSE(Decompress(corrupted, size, decompressed));
+	}
+}
@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Common/Rendering/RenderGraphBuilder.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Renderer;
+
+namespace {
+	using ComputePass = ComputeRenderGraphBuilderPass<int>;
+	using GraphicsPass = GraphicsRenderGraphBuilderPass<int>;
+
+	ImageDescription MakeImage(const char* name) {
+		ImageDescription imageDescription{};
+		imageDescription.name = name;
+		imageDescription.format = GraphicsAPI::Format::R8G8B8A8_UNORM;
+		return imageDescription;
+	}
+
+	ImageDescription MakeExternalImage(const char* name) {
+		ImageDescription imageDescription = MakeImage(name);
+		imageDescription.externalGetterCallback = []() -> GraphicsAPI::Image* { return nullptr; };
+		return imageDescription;
+	}
+
+	BufferDescription MakeBuffer(const char* name, GraphicsAPI::MemoryUsage memoryUsage = GraphicsAPI::MemoryUsage::GPUOnly) {
+		BufferDescription bufferDescription{};
+		bufferDescription.name = name;
+		bufferDescription.size = 256;
+		bufferDescription.bufferUsage = GraphicsAPI::BufferUsage::Storage;
+		bufferDescription.memoryUsage = memoryUsage;
+		return bufferDescription;
+	}
+
+	BufferDescription MakeReadbackBuffer(const char* name) {
+		return MakeBuffer(name, GraphicsAPI::MemoryUsage::GPUToCPU);
+	}
+
+	// Passes are never executed, so their callbacks do nothing.
+	template<typename SetupCallback>
+	void AddComputePass(RenderGraphBuilder& builder, const char* name, SetupCallback setupCallback) {
+		builder.CreateComputePass<int>(
+			name,
+			[&setupCallback](ComputePass& pass) {
+				setupCallback(pass);
+				return 0;
+			},
+			[](RenderGraphContext&, const RenderGraphFrameResources&, int&) {}
+		);
+	}
+
+	template<typename SetupCallback>
+	void AddGraphicsPass(RenderGraphBuilder& builder, const char* name, SetupCallback setupCallback) {
+		builder.CreateGraphicsPass<int>(
+			name,
+			MetaRect::Pixels(4, 4),
+			[&setupCallback](GraphicsPass& pass) {
+				setupCallback(pass);
+				return 0;
+			},
+			[](Math::IntRect2D, const RenderGraphContext&, const RenderGraphFrameResources&, int&) {}
+		);
+	}
+
+	std::vector<uint32_t> GetLevelPassCounts(const RenderGraph& renderGraph) {
+		std::vector<uint32_t> levelPassCounts;
+		for (const RenderGraphDependencyLevel& level : renderGraph.GetDependencyLevels()) {
+			levelPassCounts.push_back(level.passCount);
+		}
+
+		return levelPassCounts;
+	}
+
+	std::vector<RenderGraphResourceTransition> GetTransitions(const RenderGraphDependencyLevel& level, const RenderGraphBuilderResourceRef& ref) {
+		std::vector<RenderGraphResourceTransition> transitions;
+		for (const RenderGraphResourceTransition& transition : level.transitions) {
+			if (transition.resourceId == ref.GetResourceIndex()) {
+				transitions.push_back(transition);
+			}
+		}
+
+		return transitions;
+	}
+}
+
+class RenderGraphBuilderTest : public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		// Builder passes live on the frame arena, and compiled passes on the general allocator.
+		static bool isAllocatorInitialized = false;
+		if (!isAllocatorInitialized) {
+			isAllocatorInitialized =
+				Memory::AllocatorCore::Initialize(64) &&
+				Memory::AllocatorCore::InitializeFrameAllocator(1, 16);
+		}
+	}
+
+	RenderGraphBuilder builder;
+};
+
+using PassIds = std::vector<PassId>;
+using LevelPassCounts = std::vector<uint32_t>;
+
+TEST_F(RenderGraphBuilderTest, CullsPassesWithoutObservableOutputs) {
+	AddComputePass(builder, "Unused", [](ComputePass& pass) {
+		pass.WriteStorageImage(MakeImage("Unused Image"));
+	});
+	AddComputePass(builder, "Side Effects", [](ComputePass& pass) {
+		pass.WriteStorageImage(MakeImage("Side Effects Image"));
+		pass.SetHasSideEffects(true);
+	});
+	AddComputePass(builder, "Readback", [](ComputePass& pass) {
+		pass.WriteBuffer(MakeReadbackBuffer("Readback Buffer"));
+	});
+	AddComputePass(builder, "External", [](ComputePass& pass) {
+		pass.WriteStorageImage(MakeExternalImage("External Image"));
+	});
+
+	RenderGraphBuilderResourceRef unusedIntermediate;
+	AddComputePass(builder, "Unused Producer", [&](ComputePass& pass) {
+		unusedIntermediate = pass.WriteStorageImage(MakeImage("Unused Intermediate"));
+	});
+	AddComputePass(builder, "Unused Consumer", [&](ComputePass& pass) {
+		pass.ReadStorageImage(unusedIntermediate);
+		pass.WriteStorageImage(MakeImage("Unused Result"));
+	});
+
+	RenderGraph renderGraph = builder.Compile();
+	EXPECT_EQ(renderGraph.GetSortedPassIds(), (PassIds{ 1, 2, 3 }));
+	EXPECT_EQ(GetLevelPassCounts(renderGraph), (LevelPassCounts{ 3 }));
+}
+
+TEST_F(RenderGraphBuilderTest, PresentKeepsTheChainThatProducesItsImage) {
+	RenderGraphBuilderResourceRef lighting;
+	RenderGraphBuilderResourceRef tonemapped;
+	AddComputePass(builder, "Lighting", [&](ComputePass& pass) {
+		lighting = pass.WriteStorageImage(MakeImage("Lighting"));
+	});
+	AddComputePass(builder, "Tonemap", [&](ComputePass& pass) {
+		pass.ReadStorageImage(lighting);
+		tonemapped = pass.WriteStorageImage(MakeImage("Tonemapped"));
+	});
+	AddComputePass(builder, "Debug Overlay", [](ComputePass& pass) {
+		pass.WriteStorageImage(MakeImage("Overlay"));
+	});
+	builder.CreatePresentPass(tonemapped);
+
+	RenderGraph renderGraph = builder.Compile();
+	EXPECT_EQ(renderGraph.GetSortedPassIds(), (PassIds{ 0, 1, 3 }));
+	EXPECT_EQ(GetLevelPassCounts(renderGraph), (LevelPassCounts{ 1, 1, 1 }));
+}
+
+TEST_F(RenderGraphBuilderTest, SortsIntoLevelsInDeclarationOrder) {
+	RenderGraphBuilderResourceRef imageA;
+	RenderGraphBuilderResourceRef imageB;
+	RenderGraphBuilderResourceRef imageC;
+	RenderGraphBuilderResourceRef imageD;
+	AddComputePass(builder, "Write A", [&](ComputePass& pass) {
+		imageA = pass.WriteStorageImage(MakeImage("A"));
+	});
+	AddComputePass(builder, "A to C", [&](ComputePass& pass) {
+		pass.ReadStorageImage(imageA);
+		imageC = pass.WriteStorageImage(MakeImage("C"));
+	});
+	AddComputePass(builder, "Write B", [&](ComputePass& pass) {
+		imageB = pass.WriteStorageImage(MakeImage("B"));
+	});
+	AddComputePass(builder, "B to D", [&](ComputePass& pass) {
+		pass.ReadStorageImage(imageB);
+		imageD = pass.WriteStorageImage(MakeImage("D"));
+	});
+	AddComputePass(builder, "Combine", [&](ComputePass& pass) {
+		pass.ReadStorageImage(imageC);
+		pass.ReadStorageImage(imageD);
+		pass.WriteBuffer(MakeReadbackBuffer("Result"));
+	});
+
+	RenderGraph renderGraph = builder.Compile();
+	EXPECT_EQ(renderGraph.GetSortedPassIds(), (PassIds{ 0, 2, 1, 3, 4 }));
+	EXPECT_EQ(GetLevelPassCounts(renderGraph), (LevelPassCounts{ 2, 2, 1 }));
+}
+
+TEST_F(RenderGraphBuilderTest, WritesWaitForEarlierReaders) {
+	RenderGraphBuilderResourceRef image;
+	AddComputePass(builder, "Write", [&](ComputePass& pass) {
+		image = pass.WriteStorageImage(MakeImage("Image"));
+	});
+	AddComputePass(builder, "Read", [&](ComputePass& pass) {
+		pass.ReadSampledImage(image);
+		pass.WriteBuffer(MakeReadbackBuffer("Readback"));
+	});
+	AddComputePass(builder, "Overwrite", [&](ComputePass& pass) {
+		pass.ReadWriteStorageImage(image);
+		pass.SetHasSideEffects(true);
+	});
+
+	// Without the write-after-read hazard, Overwrite would share a level with Read.
+	RenderGraph renderGraph = builder.Compile();
+	EXPECT_EQ(renderGraph.GetSortedPassIds(), (PassIds{ 0, 1, 2 }));
+	EXPECT_EQ(GetLevelPassCounts(renderGraph), (LevelPassCounts{ 1, 1, 1 }));
+}
+
+TEST_F(RenderGraphBuilderTest, WritesWaitForEarlierWriters) {
+	RenderGraphBuilderResourceRef image;
+	AddGraphicsPass(builder, "First Clear", [&](GraphicsPass& pass) {
+		image = pass.WriteColorAttachment(MakeImage("Image"), GraphicsAPI::LoadOp::Clear, GraphicsAPI::ClearColor{});
+		pass.SetHasSideEffects(true);
+	});
+	AddGraphicsPass(builder, "Second Clear", [&](GraphicsPass& pass) {
+		pass.WriteColorAttachment(image, GraphicsAPI::LoadOp::Clear, GraphicsAPI::ClearColor{});
+		pass.SetHasSideEffects(true);
+	});
+
+	RenderGraph renderGraph = builder.Compile();
+	EXPECT_EQ(renderGraph.GetSortedPassIds(), (PassIds{ 0, 1 }));
+	EXPECT_EQ(GetLevelPassCounts(renderGraph), (LevelPassCounts{ 1, 1 }));
+}
+
+TEST_F(RenderGraphBuilderTest, ReadsInANewLayoutWaitForEarlierReaders) {
+	RenderGraphBuilderResourceRef image;
+	AddComputePass(builder, "Write", [&](ComputePass& pass) {
+		image = pass.WriteStorageImage(MakeImage("Image"));
+	});
+	AddComputePass(builder, "Sample", [&](ComputePass& pass) {
+		pass.ReadSampledImage(image);
+		pass.WriteBuffer(MakeReadbackBuffer("Sampled Readback"));
+	});
+	AddComputePass(builder, "Sample Again", [&](ComputePass& pass) {
+		pass.ReadSampledImage(image);
+		pass.WriteBuffer(MakeReadbackBuffer("Sampled Again Readback"));
+	});
+	AddComputePass(builder, "Load", [&](ComputePass& pass) {
+		pass.ReadStorageImage(image);
+		pass.WriteBuffer(MakeReadbackBuffer("Loaded Readback"));
+	});
+
+	// Both samplers share a layout, so they run together. Loading needs a different layout, so it waits for them.
+	RenderGraph renderGraph = builder.Compile();
+	EXPECT_EQ(renderGraph.GetSortedPassIds(), (PassIds{ 0, 1, 2, 3 }));
+	EXPECT_EQ(GetLevelPassCounts(renderGraph), (LevelPassCounts{ 1, 2, 1 }));
+}
+
+TEST_F(RenderGraphBuilderTest, MergesTheTransitionsOfALevel) {
+	RenderGraphBuilderResourceRef image;
+	RenderGraphBuilderResourceRef firstBuffer;
+	AddComputePass(builder, "Write", [&](ComputePass& pass) {
+		image = pass.WriteStorageImage(MakeImage("Image"));
+	});
+	AddComputePass(builder, "First Reader", [&](ComputePass& pass) {
+		pass.ReadSampledImage(image);
+		firstBuffer = pass.WriteBuffer(MakeReadbackBuffer("First"));
+	});
+	AddComputePass(builder, "Second Reader", [&](ComputePass& pass) {
+		pass.ReadSampledImage(image);
+		pass.WriteBuffer(MakeReadbackBuffer("Second"));
+	});
+	AddComputePass(builder, "Third Reader", [&](ComputePass& pass) {
+		pass.ReadSampledImage(image);
+		pass.ReadBuffer(firstBuffer);
+		pass.WriteBuffer(MakeReadbackBuffer("Third"));
+	});
+
+	RenderGraph renderGraph = builder.Compile();
+	ASSERT_EQ(GetLevelPassCounts(renderGraph), (LevelPassCounts{ 1, 2, 1 }));
+
+	const std::vector<RenderGraphDependencyLevel>& levels = renderGraph.GetDependencyLevels();
+	ASSERT_EQ(GetTransitions(levels[0], image).size(), 1u);
+	EXPECT_EQ(GetTransitions(levels[0], image)[0].layout, GraphicsAPI::ImageLayout::General);
+
+	// Both readers of the second level share one transition to the sampled layout.
+	const std::vector<RenderGraphResourceTransition> readTransitions = GetTransitions(levels[1], image);
+	ASSERT_EQ(readTransitions.size(), 1u);
+	EXPECT_EQ(readTransitions[0].layout, GraphicsAPI::ImageLayout::ShaderRead);
+	EXPECT_EQ(readTransitions[0].accessFlags, GraphicsAPI::AccessFlags::ShaderRead);
+	EXPECT_EQ(readTransitions[0].pipelineStage, GraphicsAPI::PipelineStageBit::ComputeShader);
+
+	// Reading again in the same layout and stage needs no barrier, but the buffer written by the first reader does.
+	EXPECT_TRUE(GetTransitions(levels[2], image).empty());
+	ASSERT_EQ(GetTransitions(levels[2], firstBuffer).size(), 1u);
+	EXPECT_EQ(GetTransitions(levels[2], firstBuffer)[0].accessFlags, GraphicsAPI::AccessFlags::ShaderRead);
+}
+
+TEST_F(RenderGraphBuilderTest, CachedGraphIsReusedWhileTheTopologyIsUnchanged) {
+	const auto buildFrame = [this](GraphicsAPI::Format format) {
+		builder.Clear();
+
+		RenderGraphBuilderResourceRef image;
+		AddComputePass(builder, "Write", [&](ComputePass& pass) {
+			ImageDescription imageDescription = MakeImage("Image");
+			imageDescription.format = format;
+			image = pass.WriteStorageImage(imageDescription);
+		});
+		builder.CreatePresentPass(image);
+	};
+
+	RenderGraph cachedGraph;
+	buildFrame(GraphicsAPI::Format::R8G8B8A8_UNORM);
+	builder.Compile(cachedGraph);
+	ASSERT_TRUE(cachedGraph.IsCompiled());
+	const size_t topologyHash = cachedGraph.GetTopologyHash();
+	const RenderGraphDependencyLevel* compiledLevels = cachedGraph.GetDependencyLevels().data();
+
+	// Descriptions can change between frames without changing the topology, so the levels compiled
+	// for the first frame are kept, rather than the graph being compiled again.
+	buildFrame(GraphicsAPI::Format::R16G16B16A16_SFLOAT);
+	EXPECT_EQ(builder.ComputeTopologyHash(), topologyHash);
+	builder.Compile(cachedGraph);
+	EXPECT_EQ(cachedGraph.GetTopologyHash(), topologyHash);
+	EXPECT_EQ(cachedGraph.GetDependencyLevels().data(), compiledLevels);
+	EXPECT_EQ(cachedGraph.GetSortedPassIds(), (PassIds{ 0, 1 }));
+}
+
+TEST_F(RenderGraphBuilderTest, CachedGraphIsRecompiledWhenTheTopologyChanges) {
+	RenderGraphBuilderResourceRef image;
+	AddComputePass(builder, "Write", [&](ComputePass& pass) {
+		image = pass.WriteStorageImage(MakeImage("Image"));
+	});
+	builder.CreatePresentPass(image);
+
+	RenderGraph cachedGraph;
+	builder.Compile(cachedGraph);
+	ASSERT_TRUE(cachedGraph.IsCompiled());
+	const size_t topologyHash = cachedGraph.GetTopologyHash();
+	EXPECT_EQ(cachedGraph.GetSortedPassIds(), (PassIds{ 0, 1 }));
+
+	AddComputePass(builder, "Side Effects", [](ComputePass& pass) {
+		pass.WriteStorageImage(MakeImage("Side Effects Image"));
+		pass.SetHasSideEffects(true);
+	});
+	EXPECT_NE(builder.ComputeTopologyHash(), topologyHash);
+
+	builder.Compile(cachedGraph);
+	EXPECT_NE(cachedGraph.GetTopologyHash(), topologyHash);
+	EXPECT_EQ(cachedGraph.GetTopologyHash(), builder.ComputeTopologyHash());
+	EXPECT_EQ(cachedGraph.GetSortedPassIds(), (PassIds{ 0, 2, 1 }));
+}
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <random>
+#include <stdint.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Common/Rendering/TransientMemoryPlanner.hpp>
+
+using namespace Grindstone::Renderer;
+
+namespace {
+	TransientMemoryRequest MakeRequest(uint64_t size, uint64_t alignment, uint32_t firstLevel, uint32_t lastLevel) {
+		return TransientMemoryRequest{ size, alignment, firstLevel, lastLevel };
+	}
+
+	// Checks every pair of requests alive at the same time, and every request's alignment and heap bounds.
+	void ExpectValidPlan(const std::vector<TransientMemoryRequest>& requests, const TransientMemoryPlan& plan) {
+		ASSERT_EQ(plan.offsets.size(), requests.size());
+
+		uint64_t unaliasedSize = 0;
+		for (size_t i = 0; i < requests.size(); ++i) {
+			const TransientMemoryRequest& request = requests[i];
+			unaliasedSize += request.size;
+
+			EXPECT_EQ(plan.offsets[i] % request.alignment, 0u) << "Request " << i << " is misaligned.";
+			EXPECT_LE(plan.offsets[i] + request.size, plan.heapSize) << "Request " << i << " is outside the heap.";
+
+			for (size_t j = i + 1; j < requests.size(); ++j) {
+				const TransientMemoryRequest& other = requests[j];
+				const bool areLifetimesOverlapping =
+					request.firstLevel <= other.lastLevel &&
+					other.firstLevel <= request.lastLevel;
+
+				if (!areLifetimesOverlapping) {
+					continue;
+				}
+
+				const bool areBytesOverlapping =
+					plan.offsets[i] < plan.offsets[j] + other.size &&
+					plan.offsets[j] < plan.offsets[i] + request.size;
+				EXPECT_FALSE(areBytesOverlapping) << "Requests " << i << " and " << j << " are alive together but share bytes.";
+			}
+		}
+
+		EXPECT_EQ(plan.unaliasedSize, unaliasedSize);
+	}
+}
+
+TEST(TransientMemoryPlannerTest, EmptyRequestsNeedNoMemory) {
+	const TransientMemoryPlan plan = PlanTransientMemory({});
+	EXPECT_TRUE(plan.offsets.empty());
+	EXPECT_EQ(plan.heapSize, 0u);
+	EXPECT_EQ(plan.unaliasedSize, 0u);
+}
+
+TEST(TransientMemoryPlannerTest, OverlappingLifetimesArePlacedSideBySide) {
+	const std::vector<TransientMemoryRequest> requests = {
+		MakeRequest(1024, 256, 0, 2),
+		MakeRequest(512, 256, 1, 3),
+		MakeRequest(256, 256, 2, 2),
+	};
+
+	const TransientMemoryPlan plan = PlanTransientMemory(requests);
+	ExpectValidPlan(requests, plan);
+	EXPECT_EQ(plan.heapSize, 1024u + 512u + 256u);
+}
+
+TEST(TransientMemoryPlannerTest, DisjointLifetimesShareMemory) {
+	const std::vector<TransientMemoryRequest> requests = {
+		MakeRequest(4096, 256, 0, 1),
+		MakeRequest(4096, 256, 2, 3),
+		MakeRequest(2048, 256, 4, 4),
+	};
+
+	const TransientMemoryPlan plan = PlanTransientMemory(requests);
+	ExpectValidPlan(requests, plan);
+	EXPECT_EQ(plan.offsets, (std::vector<uint64_t>{ 0, 0, 0 }));
+	EXPECT_EQ(plan.heapSize, 4096u);
+	EXPECT_EQ(plan.unaliasedSize, 4096u + 4096u + 2048u);
+}
+
+TEST(TransientMemoryPlannerTest, SmallRequestFillsGapLeftByDeadRequest) {
+	// The middle request dies before the last one starts, so the last one can reuse its bytes.
+	const std::vector<TransientMemoryRequest> requests = {
+		MakeRequest(8192, 256, 0, 4),
+		MakeRequest(4096, 256, 0, 1),
+		MakeRequest(2048, 256, 2, 4),
+	};
+
+	const TransientMemoryPlan plan = PlanTransientMemory(requests);
+	ExpectValidPlan(requests, plan);
+	EXPECT_EQ(plan.offsets[2], plan.offsets[1]);
+	EXPECT_EQ(plan.heapSize, 8192u + 4096u);
+}
+
+TEST(TransientMemoryPlannerTest, OffsetsRespectTheLargestAlignment) {
+	const uint64_t imageAlignment = 64 * 1024;
+	const std::vector<TransientMemoryRequest> requests = {
+		MakeRequest(100, 256, 0, 0),
+		MakeRequest(1000, imageAlignment, 0, 0),
+		MakeRequest(300, 256, 0, 0),
+		MakeRequest(70 * 1024, imageAlignment, 0, 0),
+	};
+
+	const TransientMemoryPlan plan = PlanTransientMemory(requests);
+	ExpectValidPlan(requests, plan);
+}
+
+TEST(TransientMemoryPlannerTest, ZeroAlignmentIsTreatedAsUnaligned) {
+	const std::vector<TransientMemoryRequest> requests = {
+		MakeRequest(3, 0, 0, 0),
+		MakeRequest(5, 0, 0, 0),
+	};
+
+	const TransientMemoryPlan plan = PlanTransientMemory(requests);
+	ASSERT_EQ(plan.offsets.size(), 2u);
+	EXPECT_EQ(plan.heapSize, 8u);
+}
+
+TEST(TransientMemoryPlannerTest, RandomRequestsNeverShareBytesWhileAlive) {
+	std::mt19937 generator(1234);
+	std::uniform_int_distribution<uint64_t> sizeDistribution(1, 256 * 1024);
+	std::uniform_int_distribution<uint32_t> alignmentShiftDistribution(0, 16);
+	std::uniform_int_distribution<uint32_t> levelDistribution(0, 12);
+	std::uniform_int_distribution<uint32_t> requestCountDistribution(1, 64);
+
+	for (uint32_t iteration = 0; iteration < 200; ++iteration) {
+		std::vector<TransientMemoryRequest> requests(requestCountDistribution(generator));
+		for (TransientMemoryRequest& request : requests) {
+			const uint32_t firstLevel = levelDistribution(generator);
+			const uint32_t lastLevel = levelDistribution(generator);
+			request = MakeRequest(
+				sizeDistribution(generator),
+				uint64_t(1) << alignmentShiftDistribution(generator),
+				std::min(firstLevel, lastLevel),
+				std::max(firstLevel, lastLevel)
+			);
+		}
+
+		SCOPED_TRACE(iteration);
+		ExpectValidPlan(requests, PlanTransientMemory(requests));
+		if (HasFailure()) {
+			break;
+		}
+	}
+}
@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Common/Assets/ArchiveCompression.hpp>
+#include <Common/Assets/ArchiveDirectoryView.hpp>
+#include <Editor/AssetPacker.hpp>
+#include <EngineCore/Jobs/JobSystem.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+namespace {
+	const char* archiveName = "TestArchive";
+
+	Uuid MakeUuid(uint64_t index) {
+		Uuid uuid;
+		uuid.asUint64[0] = index + 1;
+		uuid.asUint64[1] = 0x5041434B45525445ull;
+		return uuid;
+	}
+
+	// Text that compresses, with enough variation that no two seeds give the same asset.
+	std::string MakeAssetContents(uint32_t seed, size_t size) {
+		std::mt19937 generator(seed);
+		std::uniform_int_distribution<int> wordDistribution(0, 5);
+		const char* words[] = { "position ", "normal ", "tangent ", "uv0 ", "uv1 ", "color " };
+
+		std::string contents = "asset " + std::to_string(seed) + "\n";
+		while (contents.size() < size) {
+			contents += words[wordDistribution(generator)];
+		}
+
+		contents.resize(size);
+		return contents;
+	}
+
+	std::vector<char> ReadFile(const std::filesystem::path& path) {
+		std::ifstream input(path, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+
+	struct PackResult {
+		size_t reusedAssetCount = 0;
+		size_t deduplicatedAssetCount = 0;
+		size_t writtenAssetCount = 0;
+	};
+}
+
+// Packs a small project of compiled assets like SerializeAllAssets does, into a build directory that is
+// kept between builds.
+class AssetPackerTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		ASSERT_TRUE(Memory::AllocatorCore::Initialize(64));
+
+		const ::testing::TestInfo* testInfo = ::testing::UnitTest::GetInstance()->current_test_info();
+		rootPath = std::filesystem::temp_directory_path() / "AssetPackerTests" / testInfo->name();
+		std::filesystem::remove_all(rootPath);
+		compiledAssetsPath = rootPath / "compiled";
+		std::filesystem::create_directories(compiledAssetsPath);
+
+		// Large enough to span several compression blocks.
+		for (uint32_t i = 0; i < 12; ++i) {
+			AddAsset(AssetType::Texture, MakeAssetContents(i, 100'000 + i * 37'000));
+		}
+
+		AddAsset(AssetType::Mesh3d, MakeAssetContents(100, 20'000));
+		AddAsset(AssetType::AudioClip, MakeAssetContents(101, 30'000));
+		// Scenes are prepared again every build, as their cooked form depends on the component layout.
+		AddAsset(AssetType::Scene, MakeAssetContents(102, 5'000));
+		// Registered, but never compiled, so it's left out of the build.
+		entries.push_back(MakeEntry(AssetType::Texture, entries.size()));
+	}
+
+	void TearDown() override {
+		std::error_code errorCode;
+		std::filesystem::remove_all(rootPath, errorCode);
+		Memory::AllocatorCore::CloseAllocator();
+	}
+
+	Editor::AssetRegistry::Entry MakeEntry(AssetType assetType, uint64_t index) const {
+		Editor::AssetRegistry::Entry entry{};
+		entry.uuid = MakeUuid(index);
+		entry.displayName = "Asset " + std::to_string(index);
+		entry.address = "assets/" + std::to_string(index);
+		entry.assetType = assetType;
+		return entry;
+	}
+
+	Editor::AssetRegistry::Entry& AddAsset(AssetType assetType, const std::string& contents) {
+		entries.push_back(MakeEntry(assetType, entries.size()));
+		WriteCompiledFile(entries.back(), contents);
+		return entries.back();
+	}
+
+	void WriteCompiledFile(const Editor::AssetRegistry::Entry& entry, const std::string& contents) const {
+		std::ofstream output(compiledAssetsPath / entry.uuid.ToString(), std::ios::binary | std::ios::trunc);
+		output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+	}
+
+	// Entries are packed sorted by type, then uuid, like SerializeAllAssets sorts them.
+	PackResult Pack(const std::filesystem::path& outputPath, uint32_t workerThreadCount = 2) {
+		std::vector<Editor::AssetRegistry::Entry> sortedEntries = entries;
+		std::sort(
+			sortedEntries.begin(), sortedEntries.end(),
+			[](const Editor::AssetRegistry::Entry& lhs, const Editor::AssetRegistry::Entry& rhs) {
+				return lhs.assetType != rhs.assetType
+					? lhs.assetType < rhs.assetType
+					: lhs.uuid < rhs.uuid;
+			}
+		);
+
+		std::filesystem::create_directories(outputPath);
+		Jobs::JobSystem jobSystem(workerThreadCount);
+		AssetPacker packer(compiledAssetsPath, outputPath, archiveName);
+		packer.LoadPreviousBuild();
+		packer.PackEntries(sortedEntries, jobSystem);
+		packer.FinalizeArchives();
+		packer.WriteDirectory();
+		packer.WriteBuildCache();
+
+		return PackResult{
+			packer.GetReusedAssetCount(),
+			packer.GetDeduplicatedAssetCount(),
+			packer.GetWrittenAssetCount()
+		};
+	}
+
+	std::vector<std::filesystem::path> GetArchivePaths(const std::filesystem::path& outputPath) const {
+		std::vector<std::filesystem::path> archivePaths;
+		for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(outputPath)) {
+			if (file.path().extension() == ".garc") {
+				archivePaths.push_back(file.path());
+			}
+		}
+
+		std::sort(archivePaths.begin(), archivePaths.end());
+		return archivePaths;
+	}
+
+	// Checks every asset in the build reads back as the compiled file it was packed from.
+	void ExpectBuildMatchesCompiledFiles(const std::filesystem::path& outputPath) const {
+		ArchiveDirectoryView directory;
+		ASSERT_EQ(directory.Open(outputPath / (std::string(archiveName) + ".gdir")), ArchiveDirectoryOpenStatus::Success);
+
+		for (const Editor::AssetRegistry::Entry& entry : entries) {
+			const std::filesystem::path compiledFilePath = compiledAssetsPath / entry.uuid.ToString();
+			const ArchiveDirectoryFile::AssetInfo* asset = directory.FindAsset(entry.assetType, entry.uuid);
+			if (!std::filesystem::exists(compiledFilePath)) {
+				EXPECT_EQ(asset, nullptr) << entry.displayName;
+				continue;
+			}
+
+			ASSERT_NE(asset, nullptr) << entry.displayName;
+			EXPECT_EQ(directory.GetDisplayName(*asset), entry.displayName);
+
+			const std::vector<char> compiledFile = ReadFile(compiledFilePath);
+			const std::vector<char> archive = ReadFile(outputPath / (std::string(archiveName) + "_" + std::to_string(asset->archiveIndex) + ".garc"));
+			ASSERT_LE(asset->offset + asset->size, archive.size()) << entry.displayName;
+			ASSERT_EQ(asset->uncompressedSize, compiledFile.size()) << entry.displayName;
+
+			std::vector<char> storedData(archive.begin() + static_cast<std::ptrdiff_t>(asset->offset), archive.begin() + static_cast<std::ptrdiff_t>(asset->offset + asset->size));
+			if (asset->compression == ArchiveCompression::Lz4Blocks) {
+				std::vector<char> decompressedData(asset->uncompressedSize);
+				ASSERT_TRUE(DecompressArchiveBlocks(
+					reinterpret_cast<const Byte*>(storedData.data()), storedData.size(),
+					reinterpret_cast<Byte*>(decompressedData.data()), decompressedData.size()
+				)) << entry.displayName;
+				storedData = std::move(decompressedData);
+			}
+
+			EXPECT_EQ(storedData, compiledFile) << entry.displayName;
+		}
+	}
+
+	std::filesystem::path rootPath;
+	std::filesystem::path compiledAssetsPath;
+	std::vector<Editor::AssetRegistry::Entry> entries;
+};
+
+TEST_F(AssetPackerTest, UnchangedRebuildRewritesNoArchives) {
+	const std::filesystem::path outputPath = rootPath / "build";
+	const PackResult firstBuild = Pack(outputPath);
+	EXPECT_EQ(firstBuild.reusedAssetCount, 0u);
+	EXPECT_EQ(firstBuild.deduplicatedAssetCount, 0u);
+	EXPECT_EQ(firstBuild.writtenAssetCount, entries.size() - 1);
+	ExpectBuildMatchesCompiledFiles(outputPath);
+
+	const std::vector<std::filesystem::path> archivePaths = GetArchivePaths(outputPath);
+	ASSERT_FALSE(archivePaths.empty());
+	std::vector<std::filesystem::file_time_type> archiveWriteTimes;
+	std::vector<std::vector<char>> archiveContents;
+	for (const std::filesystem::path& archivePath : archivePaths) {
+		archiveWriteTimes.push_back(std::filesystem::last_write_time(archivePath));
+		archiveContents.push_back(ReadFile(archivePath));
+	}
+
+	// Every asset but the scene is reused from the build cache, and the scene matches its previous blob.
+	const PackResult secondBuild = Pack(outputPath);
+	EXPECT_EQ(secondBuild.reusedAssetCount, entries.size() - 2);
+	EXPECT_EQ(secondBuild.deduplicatedAssetCount, 1u);
+	EXPECT_EQ(secondBuild.writtenAssetCount, 0u);
+
+	ASSERT_EQ(GetArchivePaths(outputPath), archivePaths);
+	for (size_t archiveIndex = 0; archiveIndex < archivePaths.size(); ++archiveIndex) {
+		EXPECT_EQ(std::filesystem::last_write_time(archivePaths[archiveIndex]), archiveWriteTimes[archiveIndex]);
+		EXPECT_EQ(ReadFile(archivePaths[archiveIndex]), archiveContents[archiveIndex]);
+	}
+
+	for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(outputPath)) {
+		EXPECT_NE(file.path().extension(), ".tmp") << "Staged archive " << file.path() << " was left behind.";
+	}
+
+	ExpectBuildMatchesCompiledFiles(outputPath);
+}
+
+TEST_F(AssetPackerTest, DuplicateAssetsAreStoredOnce) {
+	const std::string sharedContents = MakeAssetContents(200, 150'000);
+	const Uuid firstCopy = AddAsset(AssetType::Texture, sharedContents).uuid;
+	const Uuid secondCopy = AddAsset(AssetType::Texture, sharedContents).uuid;
+	const Uuid thirdCopy = AddAsset(AssetType::Texture, sharedContents).uuid;
+
+	const std::filesystem::path outputPath = rootPath / "build";
+	const PackResult firstBuild = Pack(outputPath);
+	EXPECT_EQ(firstBuild.deduplicatedAssetCount, 2u);
+	EXPECT_EQ(firstBuild.writtenAssetCount, entries.size() - 3);
+	ExpectBuildMatchesCompiledFiles(outputPath);
+
+	{
+		ArchiveDirectoryView directory;
+		ASSERT_EQ(directory.Open(outputPath / (std::string(archiveName) + ".gdir")), ArchiveDirectoryOpenStatus::Success);
+		const ArchiveDirectoryFile::AssetInfo* firstAsset = directory.FindAsset(AssetType::Texture, firstCopy);
+		ASSERT_NE(firstAsset, nullptr);
+		for (const Uuid& copy : { secondCopy, thirdCopy }) {
+			const ArchiveDirectoryFile::AssetInfo* copyAsset = directory.FindAsset(AssetType::Texture, copy);
+			ASSERT_NE(copyAsset, nullptr);
+			EXPECT_EQ(copyAsset->archiveIndex, firstAsset->archiveIndex);
+			EXPECT_EQ(copyAsset->offset, firstAsset->offset);
+			EXPECT_EQ(copyAsset->size, firstAsset->size);
+		}
+	}
+
+	// A changed asset that now matches another is shared with it rather than written again.
+	Editor::AssetRegistry::Entry& changedEntry = entries[1];
+	WriteCompiledFile(changedEntry, sharedContents);
+	std::filesystem::last_write_time(
+		compiledAssetsPath / changedEntry.uuid.ToString(),
+		std::filesystem::last_write_time(compiledAssetsPath / changedEntry.uuid.ToString()) + std::chrono::seconds(5)
+	);
+
+	const PackResult secondBuild = Pack(outputPath);
+	EXPECT_EQ(secondBuild.writtenAssetCount, 0u);
+	EXPECT_EQ(secondBuild.deduplicatedAssetCount, 2u);
+	ExpectBuildMatchesCompiledFiles(outputPath);
+}
+
+TEST_F(AssetPackerTest, ChangedAssetsAreTheOnlyOnesWritten) {
+	const std::filesystem::path outputPath = rootPath / "build";
+	Pack(outputPath);
+
+	Editor::AssetRegistry::Entry& changedEntry = entries[3];
+	WriteCompiledFile(changedEntry, MakeAssetContents(300, 64'000));
+	std::filesystem::last_write_time(
+		compiledAssetsPath / changedEntry.uuid.ToString(),
+		std::filesystem::last_write_time(compiledAssetsPath / changedEntry.uuid.ToString()) + std::chrono::seconds(5)
+	);
+
+	const PackResult secondBuild = Pack(outputPath);
+	EXPECT_EQ(secondBuild.writtenAssetCount, 1u);
+	EXPECT_EQ(secondBuild.reusedAssetCount, entries.size() - 3);
+	ExpectBuildMatchesCompiledFiles(outputPath);
+}
+
+TEST_F(AssetPackerTest, PackedOutputIsTheSameForAnyThreadCount) {
+	// Enough small assets to fill several windows, so assets finish preparing in a different order on each run.
+	for (uint32_t i = 0; i < 200; ++i) {
+		AddAsset(AssetType::Material, MakeAssetContents(1000 + i, 500 + (i * 7919) % 4000));
+	}
+
+	const std::filesystem::path singleThreadPath = rootPath / "singleThread";
+	const std::filesystem::path multiThreadPath = rootPath / "multiThread";
+	Pack(singleThreadPath, 1);
+	Pack(multiThreadPath, 8);
+	ExpectBuildMatchesCompiledFiles(singleThreadPath);
+
+	std::vector<std::filesystem::path> fileNames;
+	for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(singleThreadPath)) {
+		fileNames.push_back(file.path().filename());
+	}
+
+	std::sort(fileNames.begin(), fileNames.end());
+	ASSERT_FALSE(fileNames.empty());
+	for (const std::filesystem::path& fileName : fileNames) {
+		ASSERT_TRUE(std::filesystem::exists(multiThreadPath / fileName)) << fileName;
+		EXPECT_EQ(ReadFile(singleThreadPath / fileName), ReadFile(multiThreadPath / fileName)) << fileName << " differs between thread counts.";
+	}
+
+	size_t multiThreadFileCount = 0;
+	for ([[maybe_unused]] const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(multiThreadPath)) {
+		++multiThreadFileCount;
+	}
+	EXPECT_EQ(multiThreadFileCount, fileNames.size());
+}
@@ -0,0 +1,240 @@
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <random>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <EngineCore/Assets/Asset.hpp>
+#include <EngineCore/Assets/AssetStorage.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+namespace {
+	Uuid MakeUuid(uint64_t index) {
+		Uuid uuid;
+		uuid.asUint64[0] = index + 1;
+		uuid.asUint64[1] = 0x53544F5241474521ull;
+		return uuid;
+	}
+
+	// Derived from the uuid, so an asset read through the wrong slot or after it was destroyed is caught.
+	uint64_t GetExpectedValue(Uuid uuid) {
+		return uuid.asUint64[0] * 0x9E3779B97F4A7C15ull;
+	}
+
+	struct TestAsset : public Asset {
+		TestAsset(Uuid uuid) : Asset(uuid, "Test Asset"), value(GetExpectedValue(uuid)) {}
+
+		TestAsset(TestAsset&& other) noexcept : Asset(other), value(other.value) {}
+
+		~TestAsset() {
+			value = 0;
+		}
+
+		uint64_t value = 0;
+	};
+}
+
+class AssetStorageTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		ASSERT_TRUE(Memory::AllocatorCore::Initialize(64));
+		storage = std::make_unique<AssetStorage<TestAsset>>();
+	}
+
+	void TearDown() override {
+		storage.reset();
+		Memory::AllocatorCore::CloseAllocator();
+	}
+
+	std::unique_ptr<AssetStorage<TestAsset>> storage;
+};
+
+TEST_F(AssetStorageTest, HandlesStopResolvingWhenTheirSlotIsReused) {
+	const Uuid firstUuid = MakeUuid(0);
+	TestAsset& firstAsset = storage->Emplace(firstUuid, TestAsset(firstUuid));
+	const AssetHandle firstHandle = storage->FindHandle(firstUuid);
+	ASSERT_TRUE(firstHandle.IsValid());
+	EXPECT_EQ(storage->Get(firstHandle), &firstAsset);
+	EXPECT_FALSE(storage->FindHandle(MakeUuid(1)).IsValid());
+
+	ASSERT_TRUE(storage->Erase(firstUuid));
+	EXPECT_EQ(storage->Get(firstHandle), nullptr);
+	EXPECT_EQ(storage->Find(firstUuid), nullptr);
+
+	// The freed slot is reused, but the old handle must not resolve to the asset now in it.
+	const Uuid secondUuid = MakeUuid(1);
+	TestAsset& secondAsset = storage->Emplace(secondUuid, TestAsset(secondUuid));
+	const AssetHandle secondHandle = storage->FindHandle(secondUuid);
+	EXPECT_EQ(secondHandle.index, firstHandle.index);
+	EXPECT_NE(secondHandle.generation, firstHandle.generation);
+	EXPECT_EQ(storage->Get(firstHandle), nullptr);
+	EXPECT_EQ(storage->Get(secondHandle), &secondAsset);
+	EXPECT_EQ(storage->Get(AssetHandle{}), nullptr);
+}
+
+TEST_F(AssetStorageTest, AssetsStayInPlaceAndIterationStaysDense) {
+	constexpr uint64_t assetCount = AssetStorage<TestAsset>::slotsPerPage * 3 + 17;
+	std::vector<TestAsset*> assetPointers;
+	for (uint64_t i = 0; i < assetCount; ++i) {
+		assetPointers.push_back(&storage->Emplace(MakeUuid(i), TestAsset(MakeUuid(i))));
+	}
+
+	// Growing the storage never moves an asset that's already stored.
+	for (uint64_t i = 0; i < assetCount; ++i) {
+		ASSERT_EQ(storage->Find(MakeUuid(i)), assetPointers[i]);
+	}
+
+	for (uint64_t i = 0; i < assetCount; i += 3) {
+		ASSERT_TRUE(storage->Erase(MakeUuid(i)));
+	}
+
+	std::vector<bool> isVisited(assetCount, false);
+	size_t visitedCount = 0;
+	for (TestAsset& asset : *storage) {
+		const uint64_t index = asset.uuid.asUint64[0] - 1;
+		ASSERT_LT(index, assetCount);
+		EXPECT_NE(index % 3, 0u);
+		EXPECT_FALSE(isVisited[index]);
+		isVisited[index] = true;
+		++visitedCount;
+	}
+
+	EXPECT_EQ(visitedCount, storage->GetSize());
+	EXPECT_EQ(visitedCount, assetCount - (assetCount + 2) / 3);
+}
+
+TEST_F(AssetStorageTest, EraseIfUnreferencedKeepsReferencedAssets) {
+	const Uuid uuid = MakeUuid(0);
+	storage->Emplace(uuid, TestAsset(uuid));
+	int eraseCount = 0;
+	EXPECT_FALSE(storage->EraseIfUnreferenced(uuid, [&eraseCount](TestAsset&) { ++eraseCount; }));
+
+	TestAsset* asset = storage->Find(uuid);
+	ASSERT_NE(asset, nullptr);
+	asset->referenceCount.Decrement();
+	EXPECT_TRUE(storage->EraseIfUnreferenced(uuid, [&eraseCount](TestAsset&) { ++eraseCount; }));
+	EXPECT_EQ(eraseCount, 1);
+	EXPECT_FALSE(storage->EraseIfUnreferenced(uuid, [&eraseCount](TestAsset&) { ++eraseCount; }));
+}
+
+/*
+ * Worker threads take and release references and resolve handles, the way renderers and loader threads use
+ * an importer's assets, while one thread keeps loading assets like the main thread does. Every asset is
+ * erased by whichever thread drops its last reference, so slots are freed and reused throughout.
+ */
+TEST_F(AssetStorageTest, ConcurrentReferencesErasesAndHandleResolves) {
+	constexpr uint64_t uuidCount = 512;
+	constexpr uint32_t workerThreadCount = 8;
+	constexpr uint32_t operationsPerWorker = 200'000;
+
+	std::vector<std::atomic<uint32_t>> createdCounts(uuidCount);
+	std::vector<std::atomic<uint32_t>> erasedCounts(uuidCount);
+	std::atomic<bool> areWorkersDone = false;
+	std::atomic<uint64_t> failureCount = 0;
+	std::atomic<uint64_t> resolvedCount = 0;
+
+	// Drops a reference like DecrementAssetUse, erasing the asset if it was the last one.
+	auto releaseReference = [&](Uuid uuid, TestAsset* asset, AssetHandle handle) {
+		if (asset->referenceCount.Decrement() > 1) {
+			return;
+		}
+
+		const bool wasErased = storage->EraseIfUnreferenced(uuid, [&](TestAsset& erasedAsset) {
+			if (erasedAsset.uuid != uuid || erasedAsset.referenceCount.Get() != 0) {
+				++failureCount;
+			}
+
+			++erasedCounts[uuid.asUint64[0] - 1];
+		});
+
+		// Once erased, the handle must never resolve again, even after the slot is reused.
+		if (wasErased && storage->Get(handle) != nullptr) {
+			++failureCount;
+		}
+	};
+
+	std::thread loaderThread([&] {
+		struct HeldReference {
+			Uuid uuid;
+			TestAsset* asset;
+			AssetHandle handle;
+		};
+
+		// The loader holds on to its most recent references for a while, so workers find loaded assets to use.
+		constexpr size_t maxHeldReferenceCount = 128;
+		std::deque<HeldReference> heldReferences;
+		std::mt19937_64 generator(1);
+		std::uniform_int_distribution<uint64_t> uuidDistribution(0, uuidCount - 1);
+		while (!areWorkersDone.load(std::memory_order_relaxed)) {
+			if (heldReferences.size() == maxHeldReferenceCount) {
+				releaseReference(heldReferences.front().uuid, heldReferences.front().asset, heldReferences.front().handle);
+				heldReferences.pop_front();
+			}
+
+			const Uuid uuid = MakeUuid(uuidDistribution(generator));
+			TestAsset* asset = storage->FindAndIncrement(uuid);
+			if (asset == nullptr) {
+				// Only this thread adds assets, like LoadAsset on the main thread. The new asset starts with the loader's reference.
+				asset = &storage->Emplace(uuid, TestAsset(uuid));
+				++createdCounts[uuid.asUint64[0] - 1];
+			}
+
+			heldReferences.push_back(HeldReference{ uuid, asset, storage->FindHandle(uuid) });
+		}
+
+		for (const HeldReference& heldReference : heldReferences) {
+			releaseReference(heldReference.uuid, heldReference.asset, heldReference.handle);
+		}
+	});
+
+	std::vector<std::thread> workerThreads;
+	for (uint32_t threadIndex = 0; threadIndex < workerThreadCount; ++threadIndex) {
+		workerThreads.emplace_back([&, threadIndex] {
+			std::mt19937_64 generator(100 + threadIndex);
+			std::uniform_int_distribution<uint64_t> uuidDistribution(0, uuidCount - 1);
+			for (uint32_t operation = 0; operation < operationsPerWorker; ++operation) {
+				const Uuid uuid = MakeUuid(uuidDistribution(generator));
+				TestAsset* asset = storage->FindAndIncrement(uuid);
+				if (asset == nullptr) {
+					continue;
+				}
+
+				// The reference keeps the asset in its slot, so its handle resolves to it without a lock.
+				const AssetHandle handle = storage->FindHandle(uuid);
+				for (int resolve = 0; resolve < 4; ++resolve) {
+					TestAsset* resolvedAsset = storage->Get(handle);
+					if (resolvedAsset != asset || resolvedAsset->uuid != uuid || resolvedAsset->value != GetExpectedValue(uuid)) {
+						++failureCount;
+					}
+				}
+
+				++resolvedCount;
+				releaseReference(uuid, asset, handle);
+			}
+		});
+	}
+
+	for (std::thread& workerThread : workerThreads) {
+		workerThread.join();
+	}
+
+	areWorkersDone = true;
+	loaderThread.join();
+
+	EXPECT_EQ(failureCount.load(), 0u);
+	EXPECT_GT(resolvedCount.load(), 0u);
+
+	// Every reference was released, so every asset that was loaded has been erased exactly once.
+	EXPECT_EQ(storage->GetSize(), 0u);
+	for (uint64_t i = 0; i < uuidCount; ++i) {
+		EXPECT_EQ(createdCounts[i].load(), erasedCounts[i].load()) << "Asset " << i;
+		EXPECT_EQ(storage->Find(MakeUuid(i)), nullptr) << "Asset " << i;
+	}
+}
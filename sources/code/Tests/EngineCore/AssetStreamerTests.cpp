@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <EngineCore/Assets/AssetImporter.hpp>
+#include <EngineCore/Assets/AssetStreamer.hpp>
+#include <EngineCore/Jobs/JobSystem.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+namespace {
+	constexpr uint64_t smallAssetSize = 256;
+
+	Uuid MakeUuid(uint64_t index) {
+		Uuid uuid;
+		uuid.asUint64[0] = index + 1;
+		uuid.asUint64[1] = 0x53545245414D4552ull;
+		return uuid;
+	}
+
+	// Reads are held until the gate opens, so a test can prove the main thread never waited on one.
+	class FakeAssetLoader : public AssetLoader {
+	public:
+		AssetLoadBinaryResult LoadBinaryByUuid(AssetType assetType, Uuid uuid) override {
+			{
+				std::unique_lock lock(mutex);
+				startedLoads.push_back(uuid);
+				startedCondition.notify_all();
+				gateCondition.wait(lock, [this] { return isGateOpen; });
+				readingThreads.push_back(std::this_thread::get_id());
+			}
+
+			AssetLoadBinaryResult result{ Assets::AssetLoadStatus::Success, "Small Asset", Buffer(smallAssetSize) };
+			memset(result.buffer.Get(), static_cast<int>(uuid.asUint64[0] & 0xFF), smallAssetSize);
+			return result;
+		}
+
+		AssetLoadTextResult LoadTextByUuid(AssetType assetType, Uuid uuid) override {
+			return AssetLoadTextResult{ Assets::AssetLoadStatus::FileNotFound };
+		}
+
+		Uuid GetUuidByAddress(AssetType assetType, std::string_view address) override {
+			return Uuid();
+		}
+
+		void OpenGate() {
+			{
+				std::scoped_lock lock(mutex);
+				isGateOpen = true;
+			}
+
+			gateCondition.notify_all();
+		}
+
+		void WaitForStartedLoads(size_t loadCount) {
+			std::unique_lock lock(mutex);
+			startedCondition.wait(lock, [this, loadCount] { return startedLoads.size() >= loadCount; });
+		}
+
+		std::vector<Uuid> GetStartedLoads() {
+			std::scoped_lock lock(mutex);
+			return startedLoads;
+		}
+
+		std::vector<std::thread::id> GetReadingThreads() {
+			std::scoped_lock lock(mutex);
+			return readingThreads;
+		}
+
+	private:
+		std::mutex mutex;
+		std::condition_variable gateCondition;
+		std::condition_variable startedCondition;
+		bool isGateOpen = false;
+		std::vector<Uuid> startedLoads;
+		std::vector<std::thread::id> readingThreads;
+	};
+
+	struct FakePayload : public StreamedAssetPayload {
+		uint8_t firstByte = 0;
+	};
+
+	class FakeAssetImporter : public AssetImporter {
+	public:
+		FakeAssetImporter() { assetType = AssetType::Texture; }
+
+		void QueueReloadAsset(Uuid uuid) override {}
+		void* LoadAsset(Uuid uuid) override { return nullptr; }
+		bool TryGetIfLoaded(Uuid uuid, void*& output) override { return false; }
+		void* IncrementAssetUse(Uuid uuid) override { return nullptr; }
+		void DecrementAssetUse(Uuid uuid) override {}
+		void IncrementOrLoad(Uuid uuid) override {}
+		Grindstone::AssetLoadStatus GetLoadStatus(Uuid uuid) override { return Grindstone::AssetLoadStatus::Unloaded; }
+		bool CanStreamAssets() const override { return true; }
+
+		std::unique_ptr<StreamedAssetPayload> DecodeStreamingAsset(Uuid uuid, AssetLoadBinaryResult& result) override {
+			if (std::this_thread::get_id() == mainThreadId) {
+				wasDecodedOnMainThread = true;
+			}
+
+			std::unique_ptr<FakePayload> payload = std::make_unique<FakePayload>();
+			payload->firstByte = *result.buffer.Get();
+			return payload;
+		}
+
+		std::thread::id mainThreadId = std::this_thread::get_id();
+		std::atomic<bool> wasDecodedOnMainThread = false;
+	};
+}
+
+class AssetStreamerTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		ASSERT_TRUE(Memory::AllocatorCore::Initialize(64));
+		jobSystem = std::make_unique<Jobs::JobSystem>(2);
+	}
+
+	void TearDown() override {
+		jobSystem.reset();
+		Memory::AllocatorCore::CloseAllocator();
+	}
+
+	// Polls like ProcessStreamedAssets does each frame, until loadCount loads have been taken.
+	std::vector<StreamedAssetLoad> TakeLoads(AssetStreamer& streamer, size_t loadCount) {
+		std::vector<StreamedAssetLoad> loads;
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+		while (loads.size() < loadCount && std::chrono::steady_clock::now() < deadline) {
+			streamer.TakeFinishedLoads(loads, loadCount - loads.size());
+			std::this_thread::yield();
+		}
+
+		return loads;
+	}
+
+	std::unique_ptr<Jobs::JobSystem> jobSystem;
+	FakeAssetLoader assetLoader;
+	FakeAssetImporter assetImporter;
+};
+
+TEST_F(AssetStreamerTest, ThousandsOfSmallAssetsLoadWithoutBlockingTheMainThread) {
+	constexpr uint64_t assetCount = 4000;
+	AssetStreamer streamer(&assetLoader, jobSystem.get());
+
+	// Every read is held, so if queueing or polling waited on one, this would never finish.
+	for (uint64_t i = 0; i < assetCount; ++i) {
+		streamer.Queue(&assetImporter, MakeUuid(i), AssetStreamPriority::Normal);
+	}
+
+	std::vector<StreamedAssetLoad> loads;
+	streamer.TakeFinishedLoads(loads, assetCount);
+	EXPECT_TRUE(loads.empty());
+
+	AssetStreamStatus status = AssetStreamStatus::Unloaded;
+	ASSERT_TRUE(streamer.TryGetStatus(AssetType::Texture, MakeUuid(assetCount - 1), status));
+	EXPECT_EQ(status, AssetStreamStatus::Queued);
+
+	assetLoader.OpenGate();
+	loads = TakeLoads(streamer, assetCount);
+	ASSERT_EQ(loads.size(), assetCount);
+
+	std::vector<bool> isLoaded(assetCount, false);
+	for (const StreamedAssetLoad& load : loads) {
+		const uint64_t index = load.uuid.asUint64[0] - 1;
+		ASSERT_LT(index, assetCount);
+		EXPECT_FALSE(isLoaded[index]) << "Asset " << index << " was loaded twice.";
+		isLoaded[index] = true;
+
+		EXPECT_EQ(load.result.status, Assets::AssetLoadStatus::Success);
+		ASSERT_NE(load.payload, nullptr);
+		EXPECT_EQ(static_cast<FakePayload*>(load.payload.get())->firstByte, uint8_t(load.uuid.asUint64[0] & 0xFF));
+	}
+
+	const std::thread::id mainThreadId = std::this_thread::get_id();
+	for (const std::thread::id readingThread : assetLoader.GetReadingThreads()) {
+		ASSERT_NE(readingThread, mainThreadId);
+	}
+	EXPECT_FALSE(assetImporter.wasDecodedOnMainThread);
+	EXPECT_FALSE(streamer.TryGetStatus(AssetType::Texture, MakeUuid(0), status));
+}
+
+TEST_F(AssetStreamerTest, QueuedAssetsAreReadByPriority) {
+	AssetStreamer streamer(&assetLoader, jobSystem.get(), 1);
+
+	// The first asset occupies the only read, so the rest stay queued until the gate opens.
+	streamer.Queue(&assetImporter, MakeUuid(0), AssetStreamPriority::Low);
+	assetLoader.WaitForStartedLoads(1);
+	streamer.Queue(&assetImporter, MakeUuid(1), AssetStreamPriority::Low);
+	streamer.Queue(&assetImporter, MakeUuid(2), AssetStreamPriority::Normal);
+	streamer.Queue(&assetImporter, MakeUuid(3), AssetStreamPriority::Normal);
+	streamer.Queue(&assetImporter, MakeUuid(4), AssetStreamPriority::Critical);
+	streamer.SetPriority(AssetType::Texture, MakeUuid(1), AssetStreamPriority::High);
+	// Queueing an asset again only ever raises its priority.
+	streamer.Queue(&assetImporter, MakeUuid(4), AssetStreamPriority::Low);
+
+	assetLoader.OpenGate();
+	ASSERT_EQ(TakeLoads(streamer, 5).size(), 5u);
+
+	const std::vector<Uuid> startedLoads = assetLoader.GetStartedLoads();
+	ASSERT_EQ(startedLoads.size(), 5u);
+	const std::vector<uint64_t> expectedOrder = { 0, 4, 1, 2, 3 };
+	for (size_t i = 0; i < expectedOrder.size(); ++i) {
+		EXPECT_EQ(startedLoads[i], MakeUuid(expectedOrder[i])) << "Load " << i;
+	}
+}
+
+TEST_F(AssetStreamerTest, CancelledAssetsAreNeverReturned) {
+	AssetStreamer streamer(&assetLoader, jobSystem.get(), 1);
+
+	streamer.Queue(&assetImporter, MakeUuid(0), AssetStreamPriority::Normal);
+	assetLoader.WaitForStartedLoads(1);
+	streamer.Queue(&assetImporter, MakeUuid(1), AssetStreamPriority::Normal);
+	streamer.Queue(&assetImporter, MakeUuid(2), AssetStreamPriority::Normal);
+
+	AssetStreamStatus status = AssetStreamStatus::Unloaded;
+	ASSERT_TRUE(streamer.TryGetStatus(AssetType::Texture, MakeUuid(0), status));
+	EXPECT_EQ(status, AssetStreamStatus::Loading);
+
+	// One is dropped once its read finishes, and the other is never read at all.
+	streamer.Cancel(AssetType::Texture, MakeUuid(0));
+	streamer.Cancel(AssetType::Texture, MakeUuid(1));
+	EXPECT_FALSE(streamer.TryGetStatus(AssetType::Texture, MakeUuid(0), status));
+	EXPECT_FALSE(streamer.TryGetStatus(AssetType::Texture, MakeUuid(1), status));
+
+	assetLoader.OpenGate();
+	const std::vector<StreamedAssetLoad> loads = TakeLoads(streamer, 1);
+	ASSERT_EQ(loads.size(), 1u);
+	EXPECT_EQ(loads[0].uuid, MakeUuid(2));
+
+	const std::vector<Uuid> startedLoads = assetLoader.GetStartedLoads();
+	EXPECT_EQ(std::count(startedLoads.begin(), startedLoads.end(), MakeUuid(1)), 0);
+
+	std::vector<StreamedAssetLoad> lateLoads;
+	streamer.TakeFinishedLoads(lateLoads, 16);
+	EXPECT_TRUE(lateLoads.empty());
+}
+
+TEST_F(AssetStreamerTest, RepeatedRequestsShareOneRead) {
+	AssetStreamer streamer(&assetLoader, jobSystem.get());
+
+	for (uint32_t i = 0; i < 3; ++i) {
+		streamer.Queue(&assetImporter, MakeUuid(7), AssetStreamPriority::Normal);
+	}
+
+	assetLoader.OpenGate();
+	ASSERT_EQ(TakeLoads(streamer, 1).size(), 1u);
+	EXPECT_EQ(assetLoader.GetStartedLoads().size(), 1u);
+}
+
+TEST_F(AssetStreamerTest, DestroyingTheStreamerSkipsQueuedReads) {
+	constexpr uint64_t assetCount = 1000;
+	std::unique_ptr<AssetStreamer> streamer = std::make_unique<AssetStreamer>(&assetLoader, jobSystem.get(), 1);
+	for (uint64_t i = 0; i < assetCount; ++i) {
+		streamer->Queue(&assetImporter, MakeUuid(i), AssetStreamPriority::Normal);
+	}
+
+	assetLoader.WaitForStartedLoads(1);
+	std::thread destroyingThread([&streamer] { streamer.reset(); });
+
+	// Gives the destructor time to stop the queue before the held read is let go.
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	assetLoader.OpenGate();
+	destroyingThread.join();
+
+	EXPECT_LT(assetLoader.GetStartedLoads().size(), assetCount);
+}
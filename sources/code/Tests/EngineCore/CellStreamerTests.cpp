@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <EngineCore/EngineCore.hpp>
+#include <EngineCore/Assets/Loaders/AssetLoader.hpp>
+#include <EngineCore/CoreComponents/Parent/ParentComponent.hpp>
+#include <EngineCore/CoreComponents/Streaming/StreamingCellComponent.hpp>
+#include <EngineCore/CoreComponents/Streaming/StreamingSourceComponent.hpp>
+#include <EngineCore/CoreComponents/Tag/TagComponent.hpp>
+#include <EngineCore/CoreComponents/Transform/TransformComponent.hpp>
+#include <EngineCore/ECS/ComponentRegistrar.hpp>
+#include <EngineCore/Scenes/CellStreamer.hpp>
+#include <EngineCore/Scenes/SceneCooker.hpp>
+
+using namespace Grindstone;
+using namespace Grindstone::SceneManagement;
+
+namespace {
+	Uuid MakeUuid(uint64_t index) {
+		Uuid uuid;
+		uuid.asUint64[0] = index + 1;
+		uuid.asUint64[1] = 0x43454C4C53434E45ull;
+		return uuid;
+	}
+
+	// A cell's entities, in groups of a root and its children, written the way SceneWriterJson saves scenes.
+	std::string GenerateCellJson(uint32_t cellIndex, uint32_t entityCount) {
+		constexpr uint32_t entitiesPerGroup = 16;
+		const uint32_t nullEntityId = static_cast<uint32_t>(entt::entity(entt::null));
+
+		std::string json = "{\"name\":\"Cell " + std::to_string(cellIndex) + "\",\"entities\":[";
+		for (uint32_t entityIndex = 0; entityIndex < entityCount; ++entityIndex) {
+			const uint32_t groupRoot = entityIndex - entityIndex % entitiesPerGroup;
+			char entityJson[512];
+			std::snprintf(
+				entityJson, sizeof(entityJson),
+				"%s{\"entityId\":%u,\"components\":["
+				"{\"component\":\"Tag\",\"params\":{\"tag\":\"Cell %u Entity %u\"}},"
+				"{\"component\":\"Transform\",\"params\":{\"position\":[%u.0,0.0,0.0]}},"
+				"{\"component\":\"Parent\",\"params\":{\"parentEntity\":%u}}"
+				"]}",
+				entityIndex == 0 ? "" : ",",
+				entityIndex,
+				cellIndex,
+				entityIndex,
+				entityIndex % entitiesPerGroup,
+				entityIndex == groupRoot ? nullEntityId : groupRoot
+			);
+			json += entityJson;
+		}
+
+		json += "]}";
+		return json;
+	}
+
+	// The "Cell N" of a tag from GenerateCellJson, which tells which cell an entity came from.
+	std::string_view GetCellName(std::string_view tag) {
+		return tag.substr(0, tag.find(" Entity"));
+	}
+
+	// Serves the cells' scenes from memory. Only read once the test has added every scene, so it can be used from streaming jobs.
+	class CellSceneLoader : public Assets::AssetLoader {
+	public:
+		void AddScene(Uuid uuid, std::vector<Byte>&& data) {
+			scenes[uuid] = std::move(data);
+		}
+
+		Assets::AssetLoadBinaryResult LoadBinaryByUuid(AssetType assetType, Uuid uuid) override {
+			Assets::AssetLoadBinaryResult result;
+			const auto sceneIterator = scenes.find(uuid);
+			if (assetType != AssetType::Scene || sceneIterator == scenes.end()) {
+				result.status = Assets::AssetLoadStatus::FileNotFound;
+				return result;
+			}
+
+			std::vector<Byte>& data = sceneIterator->second;
+			result.status = Assets::AssetLoadStatus::Success;
+			result.displayName = "Cell";
+			result.buffer = Buffer::MakeViewBuffer(data.data(), data.size());
+			return result;
+		}
+
+		Assets::AssetLoadTextResult LoadTextByUuid(AssetType assetType, Uuid uuid) override {
+			Assets::AssetLoadTextResult result;
+			result.status = Assets::AssetLoadStatus::FileNotFound;
+			return result;
+		}
+
+		Grindstone::Uuid GetUuidByAddress(AssetType assetType, std::string_view address) override {
+			return Uuid();
+		}
+
+	private:
+		std::unordered_map<Uuid, std::vector<Byte>> scenes;
+	};
+}
+
+class CellStreamerTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		projectPath = (std::filesystem::temp_directory_path() / "CellStreamerTests").string();
+		engineCore = std::make_unique<EngineCore>();
+		EngineCore::SetInstance(*engineCore);
+
+		EngineCore::EarlyCreateInfo earlyCreateInfo;
+		earlyCreateInfo.projectPath = projectPath.c_str();
+		ASSERT_TRUE(engineCore->EarlyInitialize(earlyCreateInfo));
+
+		ECS::ComponentRegistrar& componentRegistrar = *engineCore->GetComponentRegistrar();
+		componentRegistrar.RegisterComponent<TagComponent>();
+		componentRegistrar.RegisterComponent<TransformComponent>();
+		componentRegistrar.RegisterComponent<ParentComponent>();
+		componentRegistrar.RegisterComponent<StreamingCellComponent>();
+		componentRegistrar.RegisterComponent<StreamingSourceComponent>();
+
+		EngineCore::LateCreateInfo lateCreateInfo;
+		lateCreateInfo.assetLoader = &sceneLoader;
+		ASSERT_TRUE(engineCore->Initialize(lateCreateInfo));
+
+		cellStreamer = std::make_unique<CellStreamer>();
+	}
+
+	void TearDown() override {
+		// Unloading the cells goes through the engine, so the streamer goes first.
+		cellStreamer.reset();
+		engineCore.reset();
+	}
+
+	std::string projectPath;
+	CellSceneLoader sceneLoader;
+	std::unique_ptr<EngineCore> engineCore;
+	std::unique_ptr<CellStreamer> cellStreamer;
+};
+
+/*
+ * Flies a streaming source back and forth over a grid of cells, like a camera crossing an open world, and
+ * checks that no frame spends longer than the insertion budget creating and destroying cells' entities.
+ * Half the cells are cooked by the build and half are still json, as they are while working in the editor.
+ */
+TEST_F(CellStreamerTest, FlyingThroughAGridStaysWithinTheInsertionBudget) {
+	constexpr uint32_t gridSize = 8;
+	constexpr uint32_t entitiesPerCell = 2048;
+	constexpr float cellSpacing = 64.0f;
+	constexpr float loadDistance = 96.0f;
+	constexpr float unloadDistance = 128.0f;
+	constexpr float flightSpeedPerFrame = 4.0f;
+	constexpr uint32_t maxSettlingFrameCount = 10'000;
+	const std::chrono::microseconds insertionBudget(2000);
+
+	entt::registry& registry = engineCore->GetEntityRegistry();
+	const SceneCooker sceneCooker(*engineCore->GetComponentRegistrar());
+	for (uint32_t cellIndex = 0; cellIndex < gridSize * gridSize; ++cellIndex) {
+		const std::string cellJson = GenerateCellJson(cellIndex, entitiesPerCell);
+		std::vector<Byte> sceneData;
+		if (cellIndex % 2 == 0) {
+			ASSERT_TRUE(sceneCooker.Cook(cellJson, sceneData));
+		}
+		else {
+			sceneData.assign(cellJson.begin(), cellJson.end());
+		}
+
+		const Uuid sceneUuid = MakeUuid(cellIndex);
+		sceneLoader.AddScene(sceneUuid, std::move(sceneData));
+
+		const entt::entity cellEntity = registry.create();
+		TransformComponent& cellTransform = registry.emplace<TransformComponent>(cellEntity);
+		cellTransform.position = Math::Float3(static_cast<float>(cellIndex % gridSize) * cellSpacing, 0.0f, static_cast<float>(cellIndex / gridSize) * cellSpacing);
+		StreamingCellComponent& cellComponent = registry.emplace<StreamingCellComponent>(cellEntity);
+		cellComponent.scene = sceneUuid.ToString();
+		cellComponent.loadDistance = loadDistance;
+		cellComponent.unloadDistance = unloadDistance;
+	}
+
+	const entt::entity cameraEntity = registry.create();
+	registry.emplace<TransformComponent>(cameraEntity);
+	registry.emplace<StreamingSourceComponent>(cameraEntity);
+	// Fetched each time, as destroying cells' entities moves components around in the registry.
+	auto getCameraPosition = [&]() -> Math::Float3& {
+		return registry.get<TransformComponent>(cameraEntity).position;
+	};
+
+	// Back and forth along every other row, starting and ending outside the grid.
+	std::vector<Math::Float3> waypoints;
+	const float gridEnd = static_cast<float>(gridSize) * cellSpacing;
+	for (uint32_t row = 0; row < gridSize; row += 2) {
+		const float z = static_cast<float>(row) * cellSpacing;
+		const bool isGoingRight = (row / 2) % 2 == 0;
+		waypoints.emplace_back(isGoingRight ? -cellSpacing : gridEnd, 0.0f, z);
+		waypoints.emplace_back(isGoingRight ? gridEnd : -cellSpacing, 0.0f, z);
+	}
+
+	getCameraPosition() = waypoints.front();
+	cellStreamer->SetInsertionBudget(insertionBudget);
+
+	uint32_t frameCount = 0;
+	uint32_t overBudgetFrameCount = 0;
+	std::chrono::microseconds longestInsertionTime(0);
+	size_t maxLoadedCellCount = 0;
+	auto runFrame = [&]() {
+		cellStreamer->Update();
+		const std::chrono::microseconds insertionTime = cellStreamer->GetLastInsertionTime();
+		longestInsertionTime = std::max(longestInsertionTime, insertionTime);
+		if (insertionTime > insertionBudget) {
+			++overBudgetFrameCount;
+		}
+
+		maxLoadedCellCount = std::max(maxLoadedCellCount, cellStreamer->GetLoadedCellCount());
+		++frameCount;
+		// Stands in for the rest of the frame, during which the cells being prepared are read on background threads.
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	};
+
+	for (const Math::Float3& waypoint : waypoints) {
+		while (getCameraPosition() != waypoint) {
+			Math::Float3& cameraPosition = getCameraPosition();
+			const Math::Float3 offset = waypoint - cameraPosition;
+			const float distance = glm::length(offset);
+			cameraPosition = distance <= flightSpeedPerFrame
+				? waypoint
+				: cameraPosition + offset * (flightSpeedPerFrame / distance);
+			runFrame();
+		}
+	}
+
+	size_t inRangeCellCount = 0;
+	for (auto [cellEntity, cellTransform, cellComponent] : registry.view<TransformComponent, StreamingCellComponent>().each()) {
+		if (glm::length(cellTransform.position - getCameraPosition()) <= loadDistance) {
+			++inRangeCellCount;
+		}
+	}
+
+	// Hovers at the end until every cell in range has been streamed in, and no cell is half inserted.
+	ASSERT_GT(inRangeCellCount, 0u);
+	auto isSettled = [&]() {
+		const size_t loadedCellCount = cellStreamer->GetLoadedCellCount();
+		return loadedCellCount >= inRangeCellCount && registry.view<TagComponent>().size() == loadedCellCount * entitiesPerCell;
+	};
+
+	for (uint32_t settlingFrame = 0; settlingFrame < maxSettlingFrameCount && !isSettled(); ++settlingFrame) {
+		runFrame();
+	}
+
+	EXPECT_EQ(overBudgetFrameCount, 0u) << "The longest frame spent " << longestInsertionTime.count() << "us inserting cells, over " << frameCount << " frames.";
+
+	// Cells were loaded ahead of the camera, and unloaded behind it.
+	const size_t loadedCellCount = cellStreamer->GetLoadedCellCount();
+	EXPECT_GE(loadedCellCount, inRangeCellCount);
+	EXPECT_GT(maxLoadedCellCount, 0u);
+	EXPECT_LT(loadedCellCount, static_cast<size_t>(gridSize * gridSize));
+
+	// Only cells that are fully loaded remain, and their parents point at entities of the same cell.
+	size_t cellEntityCount = 0;
+	for (auto [entity, tagComponent, parentComponent] : registry.view<TagComponent, ParentComponent>().each()) {
+		++cellEntityCount;
+		if (parentComponent.parentEntity != entt::null) {
+			ASSERT_TRUE(registry.valid(parentComponent.parentEntity));
+			ASSERT_EQ(GetCellName(registry.get<TagComponent>(parentComponent.parentEntity).tag), GetCellName(tagComponent.tag));
+		}
+	}
+
+	EXPECT_EQ(cellEntityCount, loadedCellCount * entitiesPerCell);
+
+	cellStreamer->UnloadAllCells();
+	EXPECT_EQ(cellStreamer->GetLoadedCellCount(), 0u);
+	EXPECT_EQ(registry.view<TagComponent>().size(), 0u);
+	EXPECT_TRUE(registry.valid(cameraEntity));
+}
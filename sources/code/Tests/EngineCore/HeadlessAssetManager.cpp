@@ -0,0 +1,92 @@
+#include <EngineCore/Assets/AssetManager.hpp>
+
+/*
+ * Builds AssetManager for tests and benchmarks, in place of AssetManager.cpp, which registers the texture,
+ * material and pipeline importers and so needs a graphics core. Files are read through the asset loader
+ * it's given, but nothing is imported: no asset is ever created, and asset streams fail right away.
+ */
+
+using namespace Grindstone;
+using namespace Grindstone::Assets;
+
+AssetManager::AssetManager(AssetLoader* assetLoader, Jobs::JobSystem* jobSystem) : assetLoader(assetLoader) {
+	const size_t count = static_cast<size_t>(AssetType::Count);
+	assetTypeNames.resize(count);
+	assetTypeImporters.resize(count);
+}
+
+AssetManager::~AssetManager() {}
+
+void AssetManager::ReloadQueuedAssets() {
+	std::scoped_lock lock(reloadMutex);
+	queuedAssetReloads.clear();
+}
+
+void AssetManager::ProcessStreamedAssets() {}
+
+AssetImporter* AssetManager::GetManager(AssetType assetType) {
+	return assetTypeImporters[static_cast<size_t>(assetType)];
+}
+
+void AssetManager::QueueReloadAsset(AssetType assetType, Uuid uuid) {
+	std::scoped_lock lock(reloadMutex);
+	queuedAssetReloads.emplace_back(assetType, uuid);
+}
+
+void* AssetManager::GetAssetByUuid(AssetType assetType, Uuid uuid) {
+	return nullptr;
+}
+
+void* AssetManager::GetAssetByHandle(AssetType assetType, AssetHandle handle) {
+	return nullptr;
+}
+
+AssetHandle AssetManager::GetAssetHandle(AssetType assetType, Uuid uuid) {
+	return AssetHandle();
+}
+
+Grindstone::Uuid AssetManager::GetUuidByAddress(AssetType assetType, std::string_view address) {
+	return assetLoader->GetUuidByAddress(assetType, address);
+}
+
+AssetLoadBinaryResult AssetManager::LoadBinaryByUuid(AssetType assetType, Uuid uuid) {
+	return assetLoader->LoadBinaryByUuid(assetType, uuid);
+}
+
+AssetLoadTextResult AssetManager::LoadTextByUuid(AssetType assetType, Uuid uuid) {
+	return assetLoader->LoadTextByUuid(assetType, uuid);
+}
+
+const std::string& AssetManager::GetTypeName(AssetType assetType) const {
+	return assetTypeNames[static_cast<size_t>(assetType)];
+}
+
+void* AssetManager::GetAndIncrementAssetCount(Grindstone::AssetType assetType, Grindstone::Uuid uuid) {
+	return nullptr;
+}
+
+void AssetManager::IncrementAssetCount(Grindstone::AssetType assetType, Grindstone::Uuid uuid) {}
+
+void AssetManager::DecrementAssetCount(Grindstone::AssetType assetType, Grindstone::Uuid uuid) {}
+
+AssetStreamHandle AssetManager::IncrementAssetCountAsync(Grindstone::AssetType assetType, Grindstone::Uuid uuid, AssetStreamPriority priority) {
+	return AssetStreamHandle();
+}
+
+AssetStreamStatus AssetManager::GetAssetStreamStatus(AssetStreamHandle handle) {
+	return AssetStreamStatus::Failed;
+}
+
+void AssetManager::SetAssetStreamPriority(AssetStreamHandle handle, AssetStreamPriority priority) {}
+
+void AssetManager::CancelAssetStream(AssetStreamHandle handle) {}
+
+void AssetManager::RegisterAssetType(AssetType assetType, const char* typeName, AssetImporter* importer) {
+	assetTypeNames[static_cast<size_t>(assetType)] = typeName;
+	assetTypeImporters[static_cast<size_t>(assetType)] = importer;
+}
+
+void AssetManager::UnregisterAssetType(AssetType assetType) {
+	assetTypeNames[static_cast<size_t>(assetType)] = "";
+	assetTypeImporters[static_cast<size_t>(assetType)] = nullptr;
+}
@@ -0,0 +1,215 @@
+#include <EngineCore/EngineCore.hpp>
+#include <EngineCore/Logger.hpp>
+#include <EngineCore/Profiling.hpp>
+#include <EngineCore/Assets/AssetManager.hpp>
+#include <EngineCore/ECS/ComponentRegistrar.hpp>
+#include <EngineCore/Jobs/JobSystem.hpp>
+#include <EngineCore/Utils/MemoryAllocator.hpp>
+#include <EngineCore/WorldContext/WorldContextManager.hpp>
+
+/*
+ * Builds EngineCore for tests and benchmarks, in place of EngineCore.cpp, for code that reaches the engine
+ * through EngineCore::GetInstance(). It has a job system, a component registrar with no components
+ * registered, one active world context set, and an asset manager that reads files through the asset
+ * loader it's given (see HeadlessAssetManager.cpp). There are no windows, graphics, plugins or scenes.
+ *
+ * EarlyInitialize sets up the allocator, logger, job system and component registrar, and Initialize sets
+ * up the world context set and asset manager. Register the components under test in between.
+ */
+
+using namespace Grindstone;
+using namespace Grindstone::Memory;
+
+bool EngineCore::EarlyInitialize(EarlyCreateInfo& createInfo) {
+	isEditor = createInfo.isEditor;
+	projectPath = createInfo.projectPath;
+	binaryPath = projectPath / "bin";
+	assetsPath = projectPath / "compiledAssets";
+
+	if (!AllocatorCore::Initialize(256u)) {
+		return false;
+	}
+
+	Grindstone::HashedString::CreateHashMap();
+	firstFrameTime = std::chrono::steady_clock::now();
+	profiler = &Profiler::Manager::Get();
+	jobSystem = AllocatorCore::Allocate<Jobs::JobSystem>();
+	componentRegistrar = AllocatorCore::Allocate<ECS::ComponentRegistrar>();
+
+	Logger::Initialize(projectPath / "log" / "output.log", nullptr);
+	return true;
+}
+
+bool EngineCore::Initialize(LateCreateInfo& createInfo) {
+	worldContextManager = AllocatorCore::Allocate<Grindstone::WorldContextManager>();
+	WorldContextSet* worldContextSet = worldContextManager->Create("Headless");
+	worldContextManager->SetActiveWorldContextSet(worldContextSet);
+
+	assetManager = AllocatorCore::Allocate<Assets::AssetManager>(createInfo.assetLoader, jobSystem);
+	lastFrameTime = std::chrono::steady_clock::now();
+	return true;
+}
+
+EngineCore::~EngineCore() {
+	if (worldContextManager != nullptr) {
+		// Destroying a set calls the destroy functions of its components, so it goes before the registrar.
+		for (WorldContextSet* worldContextSet : *worldContextManager) {
+			AllocatorCore::Free(worldContextSet);
+		}
+
+		worldContextManager->ClearContextSets();
+	}
+
+	AllocatorCore::Free(worldContextManager);
+	AllocatorCore::Free(assetManager);
+	AllocatorCore::Free(componentRegistrar);
+	AllocatorCore::Free(jobSystem);
+	AllocatorCore::Free(Grindstone::HashedString::GetHashedStringMap());
+
+	AllocatorCore::CloseAllocator();
+	Logger::CloseLogger();
+}
+
+void EngineCore::InitializeScene(bool shouldLoadSceneFromDefaults, const char* scenePath) {}
+
+void EngineCore::ShowMainWindow() {}
+
+void EngineCore::Run() {}
+
+void EngineCore::RunEditorLoopIteration() {
+	RunLoopIteration();
+}
+
+void EngineCore::RunLoopIteration() {
+	jobSystem->RunMainThreadJobs();
+	assetManager->ProcessStreamedAssets();
+	CalculateDeltaTime();
+}
+
+void EngineCore::BeginFrame() {}
+
+void EngineCore::UpdateWindows() {}
+
+void EngineCore::RegisterGraphicsCore(GraphicsAPI::Core* newGraphicsCore) {
+	graphicsCore = newGraphicsCore;
+}
+
+void EngineCore::RegisterInputManager(Input::Interface* newInputManager) {
+	inputManager = newInputManager;
+}
+
+void EngineCore::SetRendererFactory(BaseRendererFactory* factory) {
+	rendererFactory = factory;
+}
+
+Input::Interface* EngineCore::GetInputManager() const {
+	return inputManager;
+}
+
+SceneManagement::SceneManager* EngineCore::GetSceneManager() const {
+	return sceneManager;
+}
+
+Plugins::IPluginManager* EngineCore::GetPluginManager() const {
+	return pluginManager;
+}
+
+Plugins::Interface* EngineCore::GetPluginInterface() const {
+	return pluginInterface;
+}
+
+ECS::SystemRegistrar* EngineCore::GetSystemRegistrar() const {
+	return systemRegistrar;
+}
+
+Events::Dispatcher* EngineCore::GetEventDispatcher() const {
+	return eventDispatcher;
+}
+
+ECS::ComponentRegistrar* EngineCore::GetComponentRegistrar() const {
+	return componentRegistrar;
+}
+
+GraphicsAPI::Core* EngineCore::GetGraphicsCore() const {
+	return graphicsCore;
+}
+
+Profiler::Manager* EngineCore::GetProfiler() const {
+	return profiler;
+}
+
+Jobs::JobSystem* EngineCore::GetJobSystem() const {
+	return jobSystem;
+}
+
+BaseRendererFactory* EngineCore::GetRendererFactory() const {
+	return rendererFactory;
+}
+
+RenderPassRegistry* EngineCore::GetRenderPassRegistry() const {
+	return renderpassRegistry;
+}
+
+WorldContextManager* EngineCore::GetWorldContextManager() const {
+	return worldContextManager;
+}
+
+std::filesystem::path EngineCore::GetProjectPath() const {
+	return projectPath;
+}
+
+std::filesystem::path EngineCore::GetBinaryPath() const {
+	return binaryPath;
+}
+
+std::filesystem::path EngineCore::GetEngineBinaryPath() const {
+	return engineBinaryPath;
+}
+
+std::filesystem::path EngineCore::GetAssetsPath() const {
+	return assetsPath;
+}
+
+std::filesystem::path EngineCore::GetEngineAssetsPath() const {
+	return engineAssetsPath;
+}
+
+std::filesystem::path EngineCore::GetAssetPath(std::string subPath) const {
+	return assetsPath / subPath;
+}
+
+entt::registry& EngineCore::GetEntityRegistry() {
+	return worldContextManager->GetActiveWorldContextSet()->GetEntityRegistry();
+}
+
+bool EngineCore::OnTryQuit(Grindstone::Events::BaseEvent* ev) {
+	shouldClose = true;
+	return false;
+}
+
+bool EngineCore::OnForceQuit(Grindstone::Events::BaseEvent* ev) {
+	shouldClose = true;
+	return false;
+}
+
+void EngineCore::CalculateDeltaTime() {
+	const auto now = std::chrono::steady_clock::now();
+	deltaTime = std::chrono::duration<double>(now - lastFrameTime).count();
+	currentTime = std::chrono::duration<double>(now - firstFrameTime).count();
+	lastFrameTime = now;
+}
+
+double EngineCore::GetTimeSinceLaunch() const {
+	return currentTime;
+}
+
+double EngineCore::GetDeltaTime() const {
+	return deltaTime;
+}
+
+void EngineCore::PushDeletion(std::function<void()> fn) {
+	// No frames are in flight, so nothing can still be using what's deleted.
+	fn();
+}
+
+void EngineCore::ForceDeleteAllDeferred() {}
@@ -0,0 +1,296 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Common/HashedString.hpp>
+#include <EngineCore/ECS/SystemRegistrar.hpp>
+#include <EngineCore/Jobs/JobSystem.hpp>
+#include <EngineCore/WorldContext/WorldContextSet.hpp>
+
+using namespace Grindstone;
+
+namespace {
+	#define TEST_COMPONENT(type, name) \
+		struct type { \
+			double value = 1.0; \
+			static Grindstone::ConstHashedString GetComponentHashString() { return Grindstone::ConstHashedString(name); } \
+		}
+
+	TEST_COMPONENT(VelocityComponent, "TestVelocity");
+	TEST_COMPONENT(PositionComponent, "TestPosition");
+	TEST_COMPONENT(HealthComponent, "TestHealth");
+	TEST_COMPONENT(ScoreComponent, "TestScore");
+
+	enum class ComponentSlot : size_t {
+		Velocity,
+		Position,
+		Health,
+		Score,
+		Count
+	};
+
+	// Records which systems touch which components, to catch conflicting systems running at the same time.
+	struct AccessTracker {
+		std::array<std::atomic<int32_t>, static_cast<size_t>(ComponentSlot::Count)> readers{};
+		std::array<std::atomic<int32_t>, static_cast<size_t>(ComponentSlot::Count)> writers{};
+		std::atomic<bool> hasConflict = false;
+		std::atomic<uint32_t> peakConcurrentSystems = 0;
+		std::atomic<uint32_t> concurrentSystems = 0;
+	};
+
+	AccessTracker* tracker = nullptr;
+
+	class ScopedAccess {
+	public:
+		ScopedAccess(std::initializer_list<ComponentSlot> reads, std::initializer_list<ComponentSlot> writes) : reads(reads), writes(writes) {
+			if (tracker == nullptr) {
+				return;
+			}
+
+			for (ComponentSlot slot : this->writes) {
+				if (tracker->writers[static_cast<size_t>(slot)].fetch_add(1) != 0 || tracker->readers[static_cast<size_t>(slot)].load() != 0) {
+					tracker->hasConflict = true;
+				}
+			}
+
+			for (ComponentSlot slot : this->reads) {
+				tracker->readers[static_cast<size_t>(slot)].fetch_add(1);
+				if (tracker->writers[static_cast<size_t>(slot)].load() != 0) {
+					tracker->hasConflict = true;
+				}
+			}
+
+			const uint32_t concurrentSystems = tracker->concurrentSystems.fetch_add(1) + 1;
+			uint32_t peak = tracker->peakConcurrentSystems.load();
+			while (concurrentSystems > peak && !tracker->peakConcurrentSystems.compare_exchange_weak(peak, concurrentSystems)) {}
+
+			// Widens the window in which a scheduling bug would let conflicting systems overlap.
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+
+		~ScopedAccess() {
+			if (tracker == nullptr) {
+				return;
+			}
+
+			tracker->concurrentSystems.fetch_sub(1);
+			for (ComponentSlot slot : writes) {
+				tracker->writers[static_cast<size_t>(slot)].fetch_sub(1);
+			}
+
+			for (ComponentSlot slot : reads) {
+				tracker->readers[static_cast<size_t>(slot)].fetch_sub(1);
+			}
+		}
+
+	private:
+		std::vector<ComponentSlot> reads;
+		std::vector<ComponentSlot> writes;
+	};
+
+	void ApplyDragSystem(WorldContextSet& worldContextSet) {
+		ScopedAccess access({}, { ComponentSlot::Velocity });
+		worldContextSet.GetEntityRegistry().view<VelocityComponent>().each([](VelocityComponent& velocity) {
+			velocity.value = velocity.value * 0.5 + 1.0;
+		});
+	}
+
+	void MoveSystem(WorldContextSet& worldContextSet) {
+		ScopedAccess access({ ComponentSlot::Velocity }, { ComponentSlot::Position });
+		worldContextSet.GetEntityRegistry().view<const VelocityComponent, PositionComponent>().each(
+			[](const VelocityComponent& velocity, PositionComponent& position) {
+				position.value += velocity.value;
+			}
+		);
+	}
+
+	void RegenerateSystem(WorldContextSet& worldContextSet) {
+		ScopedAccess access({}, { ComponentSlot::Health });
+		worldContextSet.GetEntityRegistry().view<HealthComponent>().each([](HealthComponent& health) {
+			health.value = health.value * 0.9 + 2.0;
+		});
+	}
+
+	void TallySystem(WorldContextSet& worldContextSet) {
+		ScopedAccess access({ ComponentSlot::Position, ComponentSlot::Health }, { ComponentSlot::Score });
+		worldContextSet.GetEntityRegistry().view<const PositionComponent, const HealthComponent, ScoreComponent>().each(
+			[](const PositionComponent& position, const HealthComponent& health, ScoreComponent& score) {
+				score.value = score.value * 0.25 + position.value * health.value;
+			}
+		);
+	}
+
+	// Declares no access, so it's exclusive and runs alone.
+	void WrapSystem(WorldContextSet& worldContextSet) {
+		ScopedAccess access({}, { ComponentSlot::Velocity, ComponentSlot::Position, ComponentSlot::Health, ComponentSlot::Score });
+		worldContextSet.GetEntityRegistry().view<PositionComponent, ScoreComponent>().each(
+			[](PositionComponent& position, ScoreComponent& score) {
+				position.value = std::fmod(position.value, 1000.0);
+				score.value = std::fmod(score.value, 100000.0);
+			}
+		);
+	}
+
+	// Registered first but in a later stage, so it has to run after the Update systems that use velocity.
+	void BounceSystem(WorldContextSet& worldContextSet) {
+		ScopedAccess access({ ComponentSlot::Position }, { ComponentSlot::Velocity });
+		worldContextSet.GetEntityRegistry().view<const PositionComponent, VelocityComponent>().each(
+			[](const PositionComponent& position, VelocityComponent& velocity) {
+				velocity.value -= position.value * 0.01;
+			}
+		);
+	}
+
+	struct TestSystem {
+		const char* name;
+		ECS::SystemFactory factory;
+		ECS::SystemComponentAccess access;
+	};
+
+	std::vector<TestSystem> GetTestSystems() {
+		return {
+			{ "Bounce", BounceSystem, ECS::SystemComponentAccess().Read<PositionComponent>().Write<VelocityComponent>().InStage(ECS::SystemStage::LateUpdate) },
+			{ "ApplyDrag", ApplyDragSystem, ECS::SystemComponentAccess().Write<VelocityComponent>() },
+			{ "Move", MoveSystem, ECS::SystemComponentAccess().Read<VelocityComponent>().Write<PositionComponent>() },
+			{ "Regenerate", RegenerateSystem, ECS::SystemComponentAccess().Write<HealthComponent>() },
+			{ "Tally", TallySystem, ECS::SystemComponentAccess().Read<PositionComponent, HealthComponent>().Write<ScoreComponent>() },
+			{ "Wrap", WrapSystem, ECS::SystemComponentAccess::Exclusive() },
+			{ "RegenerateAgain", RegenerateSystem, ECS::SystemComponentAccess().Write<HealthComponent>() },
+		};
+	}
+
+	// Destroying a WorldContextSet calls into the running engine's component registrar, which these tests
+	// don't have, so the sets are intentionally never destroyed.
+	WorldContextSet& CreatePopulatedWorldContextSet(size_t entityCount) {
+		WorldContextSet* worldContextSet = new WorldContextSet("SystemRegistrarTests");
+		entt::registry& registry = worldContextSet->GetEntityRegistry();
+		for (size_t i = 0; i < entityCount; ++i) {
+			const entt::entity entity = registry.create();
+			const double seed = static_cast<double>(i % 97);
+			registry.emplace<VelocityComponent>(entity, seed * 0.5);
+			registry.emplace<PositionComponent>(entity, seed);
+			// Leave some entities out of each view, so views differ in size.
+			if (i % 3 != 0) {
+				registry.emplace<HealthComponent>(entity, 100.0 - seed);
+			}
+
+			if (i % 5 != 0) {
+				registry.emplace<ScoreComponent>(entity, 0.0);
+			}
+		}
+
+		return *worldContextSet;
+	}
+
+	// Runs the systems one at a time, in stage order and then registration order.
+	void RunSerially(const std::vector<TestSystem>& systems, WorldContextSet& worldContextSet) {
+		for (ECS::SystemStage stage : { ECS::SystemStage::Update, ECS::SystemStage::LateUpdate, ECS::SystemStage::Render }) {
+			for (const TestSystem& system : systems) {
+				if (system.access.stage == stage) {
+					system.factory(worldContextSet);
+				}
+			}
+		}
+	}
+
+	template<typename ComponentType>
+	void ExpectSameComponents(WorldContextSet& expected, WorldContextSet& actual) {
+		entt::registry& expectedRegistry = expected.GetEntityRegistry();
+		entt::registry& actualRegistry = actual.GetEntityRegistry();
+		ASSERT_EQ(expectedRegistry.storage<ComponentType>().size(), actualRegistry.storage<ComponentType>().size());
+		for (auto [entity, component] : expectedRegistry.view<const ComponentType>().each()) {
+			// Both sets apply the same operations in the same order to each entity, so results match exactly.
+			ASSERT_EQ(component.value, actualRegistry.get<ComponentType>(entity).value);
+		}
+	}
+}
+
+class SystemRegistrarTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		tracker = &accessTracker;
+	}
+
+	void TearDown() override {
+		tracker = nullptr;
+	}
+
+	Jobs::JobSystem jobSystem{ 4 };
+	AccessTracker accessTracker;
+};
+
+TEST_F(SystemRegistrarTest, ParallelScheduleMatchesSerialExecution) {
+	const size_t entityCount = 4096;
+	const uint32_t frameCount = 20;
+	const std::vector<TestSystem> systems = GetTestSystems();
+
+	ECS::SystemRegistrar systemRegistrar(&jobSystem);
+	for (const TestSystem& system : systems) {
+		systemRegistrar.RegisterSystem(system.name, system.factory, system.access);
+	}
+
+	WorldContextSet& parallelSet = CreatePopulatedWorldContextSet(entityCount);
+	WorldContextSet& serialSet = CreatePopulatedWorldContextSet(entityCount);
+	for (uint32_t frame = 0; frame < frameCount; ++frame) {
+		systemRegistrar.Update(parallelSet);
+	}
+
+	tracker = nullptr;
+	for (uint32_t frame = 0; frame < frameCount; ++frame) {
+		RunSerially(systems, serialSet);
+	}
+
+	EXPECT_FALSE(accessTracker.hasConflict.load());
+	ExpectSameComponents<VelocityComponent>(serialSet, parallelSet);
+	ExpectSameComponents<PositionComponent>(serialSet, parallelSet);
+	ExpectSameComponents<HealthComponent>(serialSet, parallelSet);
+	ExpectSameComponents<ScoreComponent>(serialSet, parallelSet);
+}
+
+TEST_F(SystemRegistrarTest, IndependentSystemsRunConcurrently) {
+	ECS::SystemRegistrar systemRegistrar(&jobSystem);
+	systemRegistrar.RegisterSystem("ApplyDrag", ApplyDragSystem, ECS::SystemComponentAccess().Write<VelocityComponent>());
+	systemRegistrar.RegisterSystem("Regenerate", RegenerateSystem, ECS::SystemComponentAccess().Write<HealthComponent>());
+	systemRegistrar.RegisterSystem("Tally", TallySystem, ECS::SystemComponentAccess().Read<PositionComponent, HealthComponent>().Write<ScoreComponent>());
+
+	WorldContextSet& worldContextSet = CreatePopulatedWorldContextSet(64);
+	for (uint32_t frame = 0; frame < 50 && accessTracker.peakConcurrentSystems.load() < 2; ++frame) {
+		systemRegistrar.Update(worldContextSet);
+	}
+
+	EXPECT_FALSE(accessTracker.hasConflict.load());
+	EXPECT_GE(accessTracker.peakConcurrentSystems.load(), 2u);
+}
+
+TEST_F(SystemRegistrarTest, ScheduleIsRebuiltAfterUnregistering) {
+	const std::vector<TestSystem> systems = GetTestSystems();
+
+	ECS::SystemRegistrar systemRegistrar(&jobSystem);
+	for (const TestSystem& system : systems) {
+		systemRegistrar.RegisterSystem(system.name, system.factory, system.access);
+	}
+
+	WorldContextSet& parallelSet = CreatePopulatedWorldContextSet(512);
+	systemRegistrar.Update(parallelSet);
+	systemRegistrar.UnregisterSystem("Wrap");
+	systemRegistrar.Update(parallelSet);
+
+	tracker = nullptr;
+	std::vector<TestSystem> remainingSystems = systems;
+	WorldContextSet& serialSet = CreatePopulatedWorldContextSet(512);
+	RunSerially(remainingSystems, serialSet);
+	std::erase_if(remainingSystems, [](const TestSystem& system) { return std::string_view(system.name) == "Wrap"; });
+	RunSerially(remainingSystems, serialSet);
+
+	EXPECT_FALSE(accessTracker.hasConflict.load());
+	ExpectSameComponents<VelocityComponent>(serialSet, parallelSet);
+	ExpectSameComponents<PositionComponent>(serialSet, parallelSet);
+	ExpectSameComponents<HealthComponent>(serialSet, parallelSet);
+	ExpectSameComponents<ScoreComponent>(serialSet, parallelSet);
+}
@@ -0,0 +1,138 @@
+#include <chrono>
+#include <stdint.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#define VMA_IMPLEMENTATION
+#include <Grindstone.RHI.Vulkan/include/VulkanFormat.hpp>
+
+using namespace Grindstone::GraphicsAPI;
+
+// Creates its own instance and device without a window, so it runs on any device, including lavapipe.
+// The allocator is created like Vulkan::Core::CreateAllocator, and buffers like Vulkan::CreateBuffer.
+class VulkanBufferAllocationTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		VkApplicationInfo appInfo{};
+		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+		appInfo.pApplicationName = "Grindstone Tests";
+		appInfo.apiVersion = VK_API_VERSION_1_3;
+
+		VkInstanceCreateInfo instanceCreateInfo{};
+		instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+		instanceCreateInfo.pApplicationInfo = &appInfo;
+		if (vkCreateInstance(&instanceCreateInfo, nullptr, &instance) != VK_SUCCESS) {
+			instance = nullptr;
+			GTEST_SKIP() << "No Vulkan instance could be created.";
+		}
+
+		uint32_t physicalDeviceCount = 1;
+		if (vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, &physicalDevice) < VK_SUCCESS || physicalDeviceCount == 0) {
+			GTEST_SKIP() << "No Vulkan device is available.";
+		}
+
+		vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+
+		const float queuePriority = 1.0f;
+		VkDeviceQueueCreateInfo queueCreateInfo{};
+		queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+		queueCreateInfo.queueFamilyIndex = 0;
+		queueCreateInfo.queueCount = 1;
+		queueCreateInfo.pQueuePriorities = &queuePriority;
+
+		VkDeviceCreateInfo deviceCreateInfo{};
+		deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		deviceCreateInfo.queueCreateInfoCount = 1;
+		deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+		ASSERT_EQ(vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device), VK_SUCCESS);
+
+		VmaAllocatorCreateInfo allocatorInfo{};
+		allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_3;
+		allocatorInfo.physicalDevice = physicalDevice;
+		allocatorInfo.device = device;
+		allocatorInfo.instance = instance;
+		ASSERT_EQ(vmaCreateAllocator(&allocatorInfo, &allocator), VK_SUCCESS);
+	}
+
+	void TearDown() override {
+		if (allocator != nullptr) {
+			vmaDestroyAllocator(allocator);
+		}
+
+		if (device != nullptr) {
+			vkDestroyDevice(device, nullptr);
+		}
+
+		if (instance != nullptr) {
+			vkDestroyInstance(instance, nullptr);
+		}
+	}
+
+	bool CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, MemoryUsage memoryUsage, VkBuffer& buffer, VmaAllocation& allocation) {
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = usage;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		const VmaAllocationCreateInfo allocationCreateInfo = Vulkan::TranslateMemoryUsageToVma(memoryUsage, false);
+		return vmaCreateBuffer(allocator, &bufferInfo, &allocationCreateInfo, &buffer, &allocation, nullptr) == VK_SUCCESS;
+	}
+
+	VkInstance instance = nullptr;
+	VkPhysicalDevice physicalDevice = nullptr;
+	VkPhysicalDeviceProperties physicalDeviceProperties{};
+	VkDevice device = nullptr;
+	VmaAllocator allocator = nullptr;
+};
+
+TEST_F(VulkanBufferAllocationTest, HundredThousandSmallBuffersShareFewDeviceAllocations) {
+	constexpr uint32_t bufferCount = 100'000;
+	constexpr VkDeviceSize bufferSize = 256;
+
+	struct BufferAllocation {
+		VkBuffer buffer;
+		VmaAllocation allocation;
+	};
+
+	std::vector<BufferAllocation> buffers;
+	buffers.reserve(bufferCount);
+
+	// Half are per-frame uniform buffers written by the CPU, and half are storage buffers that live on the GPU.
+	const auto createStart = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < bufferCount; ++i) {
+		const bool isUniform = (i % 2) == 0;
+		BufferAllocation bufferAllocation{};
+		ASSERT_TRUE(CreateBuffer(
+			bufferSize,
+			isUniform ? VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT : VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			isUniform ? MemoryUsage::CPUToGPU : MemoryUsage::GPUOnly,
+			bufferAllocation.buffer,
+			bufferAllocation.allocation
+		)) << "Buffer " << i << " of " << bufferCount << " couldn't be created.";
+		buffers.push_back(bufferAllocation);
+	}
+	const auto createEnd = std::chrono::steady_clock::now();
+
+	VmaTotalStatistics statistics{};
+	vmaCalculateStatistics(allocator, &statistics);
+	const uint32_t deviceAllocationCount = statistics.total.statistics.blockCount;
+
+	EXPECT_EQ(statistics.total.statistics.allocationCount, bufferCount);
+	EXPECT_LT(deviceAllocationCount, physicalDeviceProperties.limits.maxMemoryAllocationCount);
+	// VMA's blocks are up to 256MB, so 25MB of buffers only needs a handful of device allocations per memory type.
+	EXPECT_LE(deviceAllocationCount, 64u);
+
+	const auto destroyStart = std::chrono::steady_clock::now();
+	for (const BufferAllocation& bufferAllocation : buffers) {
+		vmaDestroyBuffer(allocator, bufferAllocation.buffer, bufferAllocation.allocation);
+	}
+	const auto destroyEnd = std::chrono::steady_clock::now();
+
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+	RecordProperty("Device", physicalDeviceProperties.deviceName);
+	RecordProperty("DeviceAllocations", int(deviceAllocationCount));
+	RecordProperty("CreateMilliseconds", int(Milliseconds(createEnd - createStart).count()));
+	RecordProperty("DestroyMilliseconds", int(Milliseconds(destroyEnd - destroyStart).count()));
+}
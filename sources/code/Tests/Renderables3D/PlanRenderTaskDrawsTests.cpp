@@ -0,0 +1,123 @@
+#include <stdint.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Grindstone.Renderables.3D/include/PlanRenderTaskDraws.hpp>
+
+using namespace Grindstone::Renderer;
+
+namespace {
+	// Has the fields the planner reads from the renderers' task types. Pointers are only compared, never used.
+	struct TestRenderTask {
+		const void* pipeline;
+		const void* materialDescriptorSet;
+		const void* vertexArrayObject;
+		uint32_t indexCount;
+		uint32_t baseVertex;
+		uint32_t baseIndex;
+		bool isInstancingEnabled;
+	};
+
+	const void* MakeHandle(uintptr_t id) {
+		return reinterpret_cast<const void*>(id * 16);
+	}
+
+	TestRenderTask MakeTask(uintptr_t material, uintptr_t mesh, bool isInstancingEnabled = true) {
+		return TestRenderTask{ MakeHandle(1), MakeHandle(100 + material), MakeHandle(1000 + mesh), 36, 0, 0, isInstancingEnabled };
+	}
+
+	void ExpectDraw(const RenderTaskDraw& draw, uint32_t firstTaskIndex, uint32_t instanceCount, uint32_t firstInstance) {
+		EXPECT_EQ(draw.firstTaskIndex, firstTaskIndex);
+		EXPECT_EQ(draw.instanceCount, instanceCount);
+		EXPECT_EQ(draw.firstInstance, firstInstance);
+	}
+}
+
+TEST(PlanRenderTaskDrawsTest, EmptyListHasNoDraws) {
+	std::vector<TestRenderTask> tasks;
+	std::vector<RenderTaskDraw> draws;
+	EXPECT_EQ(PlanRenderTaskDraws(tasks, draws), 0u);
+	EXPECT_TRUE(draws.empty());
+}
+
+TEST(PlanRenderTaskDrawsTest, RunsOfTheSameSubmeshAreOneDraw) {
+	std::vector<TestRenderTask> tasks;
+	tasks.insert(tasks.end(), 5, MakeTask(0, 0));
+	tasks.insert(tasks.end(), 3, MakeTask(1, 0));
+	tasks.insert(tasks.end(), 2, MakeTask(1, 1));
+
+	std::vector<RenderTaskDraw> draws;
+	EXPECT_EQ(PlanRenderTaskDraws(tasks, draws), 10u);
+	ASSERT_EQ(draws.size(), 3u);
+	ExpectDraw(draws[0], 0, 5, 0);
+	ExpectDraw(draws[1], 5, 3, 5);
+	ExpectDraw(draws[2], 8, 2, 8);
+}
+
+TEST(PlanRenderTaskDrawsTest, SingleTasksAreOneInstanceDrawsInTheSharedRange) {
+	std::vector<TestRenderTask> tasks;
+	for (uintptr_t i = 0; i < 6; ++i) {
+		tasks.push_back(MakeTask(i % 2, 0));
+	}
+
+	std::vector<RenderTaskDraw> draws;
+	EXPECT_EQ(PlanRenderTaskDraws(tasks, draws), 6u);
+	ASSERT_EQ(draws.size(), 6u);
+	for (uint32_t i = 0; i < 6; ++i) {
+		ExpectDraw(draws[i], i, 1, i);
+	}
+}
+
+TEST(PlanRenderTaskDrawsTest, DisabledInstancingDrawsEveryTaskWithoutInstances) {
+	std::vector<TestRenderTask> tasks;
+	tasks.insert(tasks.end(), 4, MakeTask(0, 0, false));
+	tasks.insert(tasks.end(), 2, MakeTask(0, 0, true));
+
+	std::vector<RenderTaskDraw> draws;
+	EXPECT_EQ(PlanRenderTaskDraws(tasks, draws), 2u);
+	ASSERT_EQ(draws.size(), 5u);
+	for (uint32_t i = 0; i < 4; ++i) {
+		EXPECT_EQ(draws[i].firstTaskIndex, i);
+		EXPECT_EQ(draws[i].instanceCount, 1u);
+	}
+
+	ExpectDraw(draws[4], 4, 2, 0);
+}
+
+TEST(PlanRenderTaskDrawsTest, LargeRunsAreNotSplit) {
+	std::vector<TestRenderTask> tasks(5000, MakeTask(0, 0));
+
+	std::vector<RenderTaskDraw> draws;
+	EXPECT_EQ(PlanRenderTaskDraws(tasks, draws), 5000u);
+	ASSERT_EQ(draws.size(), 1u);
+	ExpectDraw(draws[0], 0, 5000, 0);
+}
+
+TEST(PlanRenderTaskDrawsTest, SortedSceneHasOneDrawPerSubmeshAndMaterial) {
+	const uintptr_t materialCount = 8;
+	const uintptr_t meshCount = 25;
+	const uint32_t instancesPerMesh = 40;
+
+	// Tasks arrive sorted, so each material and mesh pair is contiguous.
+	std::vector<TestRenderTask> tasks;
+	for (uintptr_t material = 0; material < materialCount; ++material) {
+		for (uintptr_t mesh = 0; mesh < meshCount; ++mesh) {
+			tasks.insert(tasks.end(), instancesPerMesh, MakeTask(material, mesh));
+		}
+	}
+
+	std::vector<RenderTaskDraw> draws;
+	const uint32_t instanceCount = PlanRenderTaskDraws(tasks, draws);
+	EXPECT_EQ(instanceCount, static_cast<uint32_t>(tasks.size()));
+	ASSERT_EQ(draws.size(), materialCount * meshCount);
+
+	// Instance ranges are packed, in draw order, with no gaps or overlaps.
+	uint32_t expectedFirstInstance = 0;
+	for (const RenderTaskDraw& draw : draws) {
+		EXPECT_EQ(draw.instanceCount, instancesPerMesh);
+		EXPECT_EQ(draw.firstInstance, expectedFirstInstance);
+		EXPECT_EQ(draw.firstTaskIndex, expectedFirstInstance);
+		expectedFirstInstance += draw.instanceCount;
+	}
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Grindstone.Renderer.Deferred/include/Passes/LightClusters.hpp>
+
+using namespace Grindstone::Renderer::LightClusters;
+
+namespace {
+	// A 16:9 view with a 45 degree vertical field of view.
+	constexpr float tanHalfFovY = 0.41421356f;
+	constexpr float tanHalfFovX = tanHalfFovY * 16.0f / 9.0f;
+	constexpr float nearDistance = 0.1f;
+	constexpr float farDistance = 1000.0f;
+
+	ClusterBounds GetBounds(Cluster cluster) {
+		return GetClusterBounds(cluster, tanHalfFovX, tanHalfFovY, nearDistance, farDistance);
+	}
+
+	Cluster GetClusterOfViewPosition(const glm::vec3& viewPosition) {
+		const float viewDistance = -viewPosition.z;
+		const float u = (viewPosition.x / viewDistance / tanHalfFovX + 1.0f) * 0.5f;
+		const float v = (viewPosition.y / viewDistance / tanHalfFovY + 1.0f) * 0.5f;
+		return GetCluster(u, v, viewDistance, nearDistance, farDistance);
+	}
+
+	// The most lights touching any one cluster, without the cap.
+	uint32_t GetMostLightsInACluster(const std::vector<LightSphere>& lights) {
+		uint32_t mostLights = 0;
+		for (uint32_t z = 0; z < gridSizeZ; ++z) {
+			for (uint32_t y = 0; y < gridSizeY; ++y) {
+				for (uint32_t x = 0; x < gridSizeX; ++x) {
+					const ClusterBounds bounds = GetBounds(Cluster{ x, y, z });
+					const uint32_t lightCount = uint32_t(std::count_if(
+						lights.begin(), lights.end(),
+						[&bounds](const LightSphere& light) {
+							return DoesSphereIntersectBounds(light, bounds);
+						}
+					));
+					mostLights = std::max(mostLights, lightCount);
+				}
+			}
+		}
+
+		return mostLights;
+	}
+
+	std::vector<LightSphere> MakeLightsAt(const glm::vec3& viewPosition, uint32_t count) {
+		return std::vector<LightSphere>(count, LightSphere{ viewPosition, 1.0f });
+	}
+}
+
+TEST(LightClustersTest, SlicesSpanTheDepthRange) {
+	EXPECT_FLOAT_EQ(GetSliceDistance(nearDistance, farDistance, 0), nearDistance);
+	EXPECT_NEAR(GetSliceDistance(nearDistance, farDistance, gridSizeZ), farDistance, farDistance * 1e-5f);
+
+	for (uint32_t slice = 0; slice < gridSizeZ; ++slice) {
+		EXPECT_LT(GetSliceDistance(nearDistance, farDistance, slice), GetSliceDistance(nearDistance, farDistance, slice + 1));
+	}
+}
+
+TEST(LightClustersTest, DepthsMapToTheSliceContainingThem) {
+	for (uint32_t slice = 0; slice < gridSizeZ; ++slice) {
+		const float sliceNear = GetSliceDistance(nearDistance, farDistance, slice);
+		const float sliceFar = GetSliceDistance(nearDistance, farDistance, slice + 1);
+		EXPECT_EQ(GetCluster(0.5f, 0.5f, (sliceNear + sliceFar) * 0.5f, nearDistance, farDistance).z, slice);
+	}
+
+	EXPECT_EQ(GetCluster(0.5f, 0.5f, 0.0f, nearDistance, farDistance).z, 0u);
+	EXPECT_EQ(GetCluster(0.5f, 0.5f, farDistance * 10.0f, nearDistance, farDistance).z, gridSizeZ - 1);
+
+	const Cluster outsideScreen = GetCluster(-0.5f, 1.5f, 1.0f, nearDistance, farDistance);
+	EXPECT_EQ(outsideScreen.x, 0u);
+	EXPECT_EQ(outsideScreen.y, gridSizeY - 1);
+}
+
+TEST(LightClustersTest, ClusterIndicesAreUniqueAndDense) {
+	std::vector<bool> isIndexUsed(clusterCount, false);
+	for (uint32_t z = 0; z < gridSizeZ; ++z) {
+		for (uint32_t y = 0; y < gridSizeY; ++y) {
+			for (uint32_t x = 0; x < gridSizeX; ++x) {
+				const uint32_t clusterIndex = GetClusterIndex(Cluster{ x, y, z });
+				ASSERT_LT(clusterIndex, clusterCount);
+				EXPECT_FALSE(isIndexUsed[clusterIndex]);
+				isIndexUsed[clusterIndex] = true;
+			}
+		}
+	}
+}
+
+TEST(LightClustersTest, PositionsAreInsideTheBoundsOfTheirCluster) {
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> screenDistribution(-0.99f, 0.99f);
+	std::uniform_real_distribution<float> depthDistribution(std::log(nearDistance), std::log(farDistance));
+
+	for (uint32_t i = 0; i < 10000; ++i) {
+		const float viewDistance = std::exp(depthDistribution(generator));
+		const glm::vec3 viewPosition(
+			screenDistribution(generator) * tanHalfFovX * viewDistance,
+			screenDistribution(generator) * tanHalfFovY * viewDistance,
+			-viewDistance
+		);
+
+		const Cluster cluster = GetClusterOfViewPosition(viewPosition);
+		const ClusterBounds bounds = GetBounds(cluster);
+		const float epsilon = viewDistance * 1e-4f;
+		for (int axis = 0; axis < 3; ++axis) {
+			ASSERT_GE(viewPosition[axis], bounds.min[axis] - epsilon) << "Position " << i << ", axis " << axis;
+			ASSERT_LE(viewPosition[axis], bounds.max[axis] + epsilon) << "Position " << i << ", axis " << axis;
+		}
+
+		// A light at a position must be assigned to the cluster holding it, even if it's tiny.
+		const std::vector<LightSphere> lights = { LightSphere{ viewPosition, epsilon } };
+		std::vector<uint32_t> lightIndices(maxLightsPerCluster);
+		ASSERT_EQ(AssignLights(bounds, lights, std::vector<LightSphere>{}, lightIndices.data()).pointLightCount, 1u);
+	}
+}
+
+TEST(LightClustersTest, LightsBehindTheCameraAreNotAssigned) {
+	const std::vector<LightSphere> lights = { LightSphere{ glm::vec3(0.0f, 0.0f, 5.0f), 1.0f } };
+	EXPECT_EQ(GetMostLightsInACluster(lights), 0u);
+}
+
+TEST(LightClustersTest, SpotLightsAreAssignedAfterPointLights) {
+	const glm::vec3 viewPosition(0.0f, 0.0f, -10.0f);
+	const ClusterBounds bounds = GetBounds(GetClusterOfViewPosition(viewPosition));
+	const std::vector<LightSphere> pointLights = MakeLightsAt(viewPosition, 3);
+	const std::vector<LightSphere> spotLights = MakeLightsAt(viewPosition, 2);
+
+	std::vector<uint32_t> lightIndices(maxLightsPerCluster, ~0u);
+	const ClusterLightCounts counts = AssignLights(bounds, pointLights, spotLights, lightIndices.data());
+	EXPECT_EQ(counts.pointLightCount, 3u);
+	EXPECT_EQ(counts.spotLightCount, 2u);
+	EXPECT_EQ(std::vector<uint32_t>(lightIndices.begin(), lightIndices.begin() + 6), (std::vector<uint32_t>{ 0, 1, 2, 0, 1, ~0u }));
+}
+
+TEST(LightClustersTest, OverflowingClustersKeepTheFirstLightsAndStayInTheirList) {
+	const glm::vec3 viewPosition(0.0f, 0.0f, -10.0f);
+	const ClusterBounds bounds = GetBounds(GetClusterOfViewPosition(viewPosition));
+	const std::vector<LightSphere> pointLights = MakeLightsAt(viewPosition, maxLightsPerCluster - 8);
+	const std::vector<LightSphere> spotLights = MakeLightsAt(viewPosition, 32);
+
+	// The entries after the cluster's list belong to the next cluster, and must not be written.
+	std::vector<uint32_t> lightIndices(maxLightsPerCluster + 1, ~0u);
+	const ClusterLightCounts counts = AssignLights(bounds, pointLights, spotLights, lightIndices.data());
+	EXPECT_EQ(counts.pointLightCount, maxLightsPerCluster - 8);
+	EXPECT_EQ(counts.spotLightCount, 8u);
+	EXPECT_EQ(lightIndices[maxLightsPerCluster - 1], 7u);
+	EXPECT_EQ(lightIndices[maxLightsPerCluster], ~0u);
+
+	// Once point lights fill the list, spot lights are dropped entirely.
+	const std::vector<LightSphere> manyPointLights = MakeLightsAt(viewPosition, maxLightsPerCluster + 1);
+	const ClusterLightCounts overflowCounts = AssignLights(bounds, manyPointLights, spotLights, lightIndices.data());
+	EXPECT_EQ(overflowCounts.pointLightCount, maxLightsPerCluster);
+	EXPECT_EQ(overflowCounts.spotLightCount, 0u);
+	EXPECT_EQ(lightIndices[maxLightsPerCluster], ~0u);
+}
+
+// Lights of a 5m radius spread over a 200m wide and deep area in front of the camera, like a lit street.
+// Distant clusters are large, so this is what sizes maxLightsPerCluster: 4096 lights put up to ~330 lights
+// in one cluster.
+TEST(LightClustersTest, ReferenceScenesFitInEveryCluster) {
+	for (uint32_t lightCount : { 16u, 256u, 4096u }) {
+		std::mt19937 generator(7);
+		std::uniform_real_distribution<float> xDistribution(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> yDistribution(-5.0f, 5.0f);
+		std::uniform_real_distribution<float> zDistribution(-200.0f, -1.0f);
+
+		std::vector<LightSphere> lights(lightCount);
+		for (LightSphere& light : lights) {
+			light = LightSphere{ glm::vec3(xDistribution(generator), yDistribution(generator), zDistribution(generator)), 5.0f };
+		}
+
+		const uint32_t mostLights = GetMostLightsInACluster(lights);
+		RecordProperty("MostLightsInACluster" + std::to_string(lightCount), int(mostLights));
+		EXPECT_LE(mostLights, maxLightsPerCluster) << lightCount << " lights";
+	}
+}
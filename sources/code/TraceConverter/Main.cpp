@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <EngineCore/ProfilingTraceFormat.hpp>
+
+using namespace Grindstone::Profiler;
+
+// Converts a binary trace written by the profiler into Chrome tracing JSON, which can be opened
+// in chrome://tracing or ui.perfetto.dev.
+
+struct ThreadEvent {
+	uint32_t threadIndex;
+	TraceEvent event;
+};
+
+static void WriteJsonString(std::ostream& outputStream, const std::string& value) {
+	outputStream << '"';
+	for (const char character : value) {
+		switch (character) {
+		case '"':
+			outputStream << "\\\"";
+			break;
+		case '\\':
+			outputStream << "\\\\";
+			break;
+		case '\n':
+			outputStream << "\\n";
+			break;
+		case '\t':
+			outputStream << "\\t";
+			break;
+		default:
+			if (static_cast<unsigned char>(character) < 0x20) {
+				outputStream << ' ';
+			}
+			else {
+				outputStream << character;
+			}
+			break;
+		}
+	}
+	outputStream << '"';
+}
+
+static bool ReadTrace(
+	const std::filesystem::path& inputPath,
+	uint64_t& ticksPerSecond,
+	std::unordered_map<uint32_t, std::string>& names,
+	std::vector<TraceThreadInfo>& threads,
+	std::vector<ThreadEvent>& events,
+	uint64_t& droppedEventCount
+) {
+	std::ifstream inputStream(inputPath, std::ios::binary);
+	if (!inputStream.is_open()) {
+		std::cerr << "Unable to open " << inputPath.string() << ".\n";
+		return false;
+	}
+
+	TraceFileHeader fileHeader;
+	inputStream.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+	if (!inputStream || fileHeader.magic != traceFileMagic) {
+		std::cerr << inputPath.string() << " is not a Grindstone trace.\n";
+		return false;
+	}
+
+	if (fileHeader.version != traceFileVersion) {
+		std::cerr << "Unsupported trace version " << fileHeader.version << ", expected " << traceFileVersion << ".\n";
+		return false;
+	}
+
+	ticksPerSecond = fileHeader.ticksPerSecond;
+
+	std::vector<char> chunkData;
+	TraceChunkHeader chunkHeader;
+	while (inputStream.read(reinterpret_cast<char*>(&chunkHeader), sizeof(chunkHeader))) {
+		chunkData.resize(chunkHeader.size);
+		if (!inputStream.read(chunkData.data(), chunkHeader.size)) {
+			// The engine may have closed without finishing the last chunk.
+			std::cerr << "Trace ends with a truncated chunk, ignoring it.\n";
+			break;
+		}
+
+		switch (chunkHeader.type) {
+		case TraceChunkType::Name: {
+			if (chunkHeader.size < sizeof(uint32_t)) {
+				break;
+			}
+
+			uint32_t nameId;
+			memcpy(&nameId, chunkData.data(), sizeof(nameId));
+			names[nameId] = std::string(chunkData.data() + sizeof(nameId), chunkHeader.size - sizeof(nameId));
+			break;
+		}
+		case TraceChunkType::Thread: {
+			if (chunkHeader.size < sizeof(TraceThreadInfo)) {
+				break;
+			}
+
+			TraceThreadInfo threadInfo;
+			memcpy(&threadInfo, chunkData.data(), sizeof(threadInfo));
+			threads.push_back(threadInfo);
+			break;
+		}
+		case TraceChunkType::Events: {
+			if (chunkHeader.size < sizeof(TraceEventsHeader)) {
+				break;
+			}
+
+			TraceEventsHeader eventsHeader;
+			memcpy(&eventsHeader, chunkData.data(), sizeof(eventsHeader));
+			droppedEventCount += eventsHeader.droppedEventCount;
+
+			const size_t eventCount = (chunkHeader.size - sizeof(TraceEventsHeader)) / sizeof(TraceEvent);
+			const char* eventData = chunkData.data() + sizeof(TraceEventsHeader);
+			for (size_t i = 0; i < eventCount; ++i) {
+				ThreadEvent threadEvent;
+				threadEvent.threadIndex = eventsHeader.threadIndex;
+				memcpy(&threadEvent.event, eventData + i * sizeof(TraceEvent), sizeof(TraceEvent));
+				events.push_back(threadEvent);
+			}
+			break;
+		}
+		default:
+			// Skip chunks added by newer versions of the format.
+			break;
+		}
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cerr << "Usage: TraceConverter <input.gtrace> [output.json]\n";
+		return 1;
+	}
+
+	const std::filesystem::path inputPath = argv[1];
+	std::filesystem::path outputPath = argc > 2
+		? std::filesystem::path(argv[2])
+		: std::filesystem::path(inputPath).replace_extension(".json");
+
+	uint64_t ticksPerSecond = 0;
+	uint64_t droppedEventCount = 0;
+	std::unordered_map<uint32_t, std::string> names;
+	std::vector<TraceThreadInfo> threads;
+	std::vector<ThreadEvent> events;
+	if (!ReadTrace(inputPath, ticksPerSecond, names, threads, events, droppedEventCount)) {
+		return 1;
+	}
+
+	if (ticksPerSecond == 0) {
+		std::cerr << "Trace has no clock frequency.\n";
+		return 1;
+	}
+
+	uint64_t firstTick = UINT64_MAX;
+	for (const ThreadEvent& threadEvent : events) {
+		firstTick = std::min(firstTick, threadEvent.event.startTicks);
+	}
+
+	std::ofstream outputStream(outputPath);
+	if (!outputStream.is_open()) {
+		std::cerr << "Unable to open " << outputPath.string() << " for writing.\n";
+		return 1;
+	}
+
+	const double microsecondsPerTick = 1000000.0 / static_cast<double>(ticksPerSecond);
+	outputStream.precision(3);
+	outputStream << std::fixed << "{\"otherData\":{},\"traceEvents\":[";
+
+	bool isFirstEvent = true;
+	for (const TraceThreadInfo& threadInfo : threads) {
+		outputStream << (isFirstEvent ? "" : ",")
+			<< "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadInfo.threadIndex
+			<< ",\"args\":{\"name\":\"Thread " << threadInfo.threadIndex << " (" << threadInfo.osThreadId << ")\"}}";
+		isFirstEvent = false;
+	}
+
+	for (const ThreadEvent& threadEvent : events) {
+		const TraceEvent& event = threadEvent.event;
+		auto nameIterator = names.find(event.nameId);
+		const std::string name = nameIterator != names.end()
+			? nameIterator->second
+			: "Unknown";
+
+		const double start = static_cast<double>(event.startTicks - firstTick) * microsecondsPerTick;
+		const double duration = static_cast<double>(event.endTicks - event.startTicks) * microsecondsPerTick;
+
+		outputStream << (isFirstEvent ? "" : ",")
+			<< "{\"cat\":\"" << (event.type == TraceEventType::Session ? "session" : "function")
+			<< "\",\"dur\":" << duration
+			<< ",\"name\":";
+		WriteJsonString(outputStream, name);
+		outputStream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << threadEvent.threadIndex
+			<< ",\"ts\":" << start << "}";
+		isFirstEvent = false;
+	}
+
+	outputStream << "]}";
+
+	std::cout << "Wrote " << events.size() << " events from " << threads.size() << " threads to " << outputPath.string() << ".\n";
+	if (droppedEventCount > 0) {
+		std::cout << droppedEventCount << " events were dropped while recording, because a thread's buffer was full.\n";
+	}
+
+	return 0;
+}